@@ -0,0 +1,387 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * E2 Node load generator. Emulates thousands of E2 Nodes in one process to
+ * size the nearRT-RIC. Every E2 Node is a complete E2 Agent (i.e., own SCTP
+ * association, SMs and event loop thread) that answers the subscriptions with
+ * synthetic MAC, RLC and PDCP reports of the configured number of UEs and
+ * bearers. Pair it with xapp_load_gen, which subscribes and measures.
+ *
+ * Set NEAR_RIC_IP = 127.0.0.1 in the config file to stay on the loopback and
+ * raise the open files limit of the nearRT-RIC (i.e., ulimit -n) as every E2
+ * Node holds one SCTP association.
+ */
+
+#include "../../../src/agent/e2_agent.h"
+#include "../../../src/util/alg_ds/alg/defer.h"
+#include "../../../src/util/time_now_us.h"
+#include "../../../test/sm/common/fill_ind_data.h"
+
+#include <assert.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// The event loop of an E2 Agent needs little stack, and there are thousands
+#define LOAD_GEN_STACK_SZ (256*1024)
+
+typedef struct{
+  uint32_t nodes;
+  uint32_t ues;
+  uint32_t bearers;
+  // E2 Nodes started per second
+  uint32_t ramp;
+  // 0 runs until SIGINT
+  uint32_t duration_s;
+} load_gen_args_t;
+
+static
+load_gen_args_t cfg = {.nodes = 100, .ues = 16, .bearers = 2, .ramp = 100, .duration_s = 0};
+
+// Indications generated, per SM
+static
+_Atomic uint64_t cnt_mac;
+
+static
+_Atomic uint64_t cnt_rlc;
+
+static
+_Atomic uint64_t cnt_pdcp;
+
+static
+_Atomic uint64_t cnt_other;
+
+static
+_Atomic bool stop_token;
+
+// Values change with every report and differ among UEs 
+static
+uint32_t val(int64_t t, uint32_t i, uint32_t mod)
+{
+  return (uint32_t)((t / 1000 + 7 * i) % mod);
+}
+
+static
+void fill_mac_load_gen(mac_ind_msg_t* msg)
+{
+  msg->tstamp = time_now_us();
+  msg->len_ue_stats = cfg.ues;
+  msg->ue_stats = calloc(cfg.ues, sizeof(mac_ue_stats_impl_t));
+  assert(msg->ue_stats != NULL && "Memory exhausted");
+
+  for(uint32_t i = 0; i < cfg.ues; ++i){
+    mac_ue_stats_impl_t* ue = &msg->ue_stats[i];
+    ue->rnti = 0x4601 + i;
+    ue->frame = val(msg->tstamp, i, 1024);
+    ue->slot = val(msg->tstamp, i, 20);
+    ue->dl_aggr_tbs = val(msg->tstamp, i, 1 << 30);
+    ue->ul_aggr_tbs = val(msg->tstamp, i, 1 << 28);
+    ue->dl_curr_tbs = val(msg->tstamp, i, 20000);
+    ue->ul_curr_tbs = val(msg->tstamp, i, 8000);
+    ue->dl_aggr_bytes_sdus = ue->dl_aggr_tbs - ue->dl_aggr_tbs / 16;
+    ue->ul_aggr_bytes_sdus = ue->ul_aggr_tbs - ue->ul_aggr_tbs / 16;
+    ue->dl_aggr_prb = val(msg->tstamp, i, 1 << 20);
+    ue->ul_aggr_prb = val(msg->tstamp, i, 1 << 19);
+    ue->dl_aggr_sdus = val(msg->tstamp, i, 1 << 18);
+    ue->ul_aggr_sdus = val(msg->tstamp, i, 1 << 17);
+    ue->pusch_snr = 20.0 + i % 10;
+    ue->pucch_snr = 15.0 + i % 10;
+    ue->wb_cqi = 7 + val(msg->tstamp, i, 8);
+    ue->dl_mcs1 = 20 + val(msg->tstamp, i, 8);
+    ue->ul_mcs1 = 16 + val(msg->tstamp, i, 8);
+    ue->phr = 10;
+    ue->bsr = val(msg->tstamp, i, 3000);
+    ue->dl_num_harq = 4;
+    ue->ul_num_harq = 4;
+  }
+}
+
+static
+void fill_rlc_load_gen(rlc_ind_msg_t* msg)
+{
+  msg->tstamp = time_now_us();
+  msg->len = cfg.ues * cfg.bearers;
+  msg->rb = calloc(msg->len, sizeof(rlc_radio_bearer_stats_t));
+  assert(msg->rb != NULL && "Memory exhausted");
+
+  for(uint32_t i = 0; i < msg->len; ++i){
+    rlc_radio_bearer_stats_t* rb = &msg->rb[i];
+    rb->rnti = 0x4601 + i / cfg.bearers;
+    rb->rbid = 1 + i % cfg.bearers;
+    rb->mode = 0;
+    rb->txpdu_pkts = val(msg->tstamp, i, 1 << 20);
+    rb->txpdu_bytes = rb->txpdu_pkts * 1400;
+    rb->rxpdu_pkts = val(msg->tstamp, i, 1 << 19);
+    rb->rxpdu_bytes = rb->rxpdu_pkts * 1400;
+    rb->txbuf_occ_bytes = val(msg->tstamp, i, 50000);
+    rb->txbuf_occ_pkts = rb->txbuf_occ_bytes / 1400;
+    rb->txpdu_wt_ms = val(msg->tstamp, i, 1 << 16);
+  }
+}
+
+static
+void fill_pdcp_load_gen(pdcp_ind_msg_t* msg)
+{
+  msg->tstamp = time_now_us();
+  msg->len = cfg.ues * cfg.bearers;
+  msg->rb = calloc(msg->len, sizeof(pdcp_radio_bearer_stats_t));
+  assert(msg->rb != NULL && "Memory exhausted");
+
+  for(uint32_t i = 0; i < msg->len; ++i){
+    pdcp_radio_bearer_stats_t* rb = &msg->rb[i];
+    rb->rnti = 0x4601 + i / cfg.bearers;
+    rb->rbid = 1 + i % cfg.bearers;
+    rb->mode = 0;
+    rb->txpdu_pkts = val(msg->tstamp, i, 1 << 20);
+    rb->txpdu_bytes = rb->txpdu_pkts * 1400;
+    rb->txpdu_sn = rb->txpdu_pkts % 4096;
+    rb->rxpdu_pkts = val(msg->tstamp, i, 1 << 19);
+    rb->rxpdu_bytes = rb->rxpdu_pkts * 1400;
+    rb->rxpdu_sn = rb->rxpdu_pkts % 4096;
+    rb->txsdu_pkts = rb->rxpdu_pkts;
+    rb->txsdu_bytes = rb->rxpdu_bytes - rb->rxpdu_pkts * 40;
+    rb->rxsdu_pkts = rb->txpdu_pkts;
+    rb->rxsdu_bytes = rb->txpdu_bytes - rb->txpdu_pkts * 40;
+  }
+}
+
+static
+void read_RAN(sm_ag_if_rd_t* data)
+{
+  assert(data != NULL);
+
+  if(data->type == MAC_STATS_V0){
+    fill_mac_load_gen(&data->mac_stats.msg);
+    atomic_fetch_add_explicit(&cnt_mac, 1, memory_order_relaxed);
+    return;
+  } else if(data->type == RLC_STATS_V0){
+    fill_rlc_load_gen(&data->rlc_stats.msg);
+    atomic_fetch_add_explicit(&cnt_rlc, 1, memory_order_relaxed);
+    return;
+  } else if(data->type == PDCP_STATS_V0){
+    fill_pdcp_load_gen(&data->pdcp_stats.msg);
+    atomic_fetch_add_explicit(&cnt_pdcp, 1, memory_order_relaxed);
+    return;
+  } 
+
+  // Canned data, as in the emulated agent
+  if(data->type == SLICE_STATS_V0){
+    fill_slice_ind_data(&data->slice_stats);
+  } else if(data->type == GTP_STATS_V0){
+    fill_gtp_ind_data(&data->gtp_stats);
+  } else if(data->type == KPM_STATS_V0){
+    fill_kpm_ind_data(&data->kpm_stats);
+  } else {
+    assert(0!=0 && "Invalid data type");
+  }
+  atomic_fetch_add_explicit(&cnt_other, 1, memory_order_relaxed);
+}
+
+static
+sm_ag_if_ans_t write_RAN(sm_ag_if_wr_t const* data)
+{
+  assert(data != NULL);
+
+  sm_ag_if_ans_t ans = {0};
+  if(data->type == MAC_CTRL_REQ_V0){
+    ans.type = MAC_AGENT_IF_CTRL_ANS_V0;
+    ans.mac.ans = MAC_CTRL_OUT_OK;
+  } else if(data->type == SLICE_CTRL_REQ_V0){
+    ans.type = SLICE_AGENT_IF_CTRL_ANS_V0;
+  } else if(data->type == TC_CTRL_REQ_V0){
+    ans.type = TC_AGENT_IF_CTRL_ANS_V0;
+  } else {
+    assert(0 != 0 && "Not supported function ");
+  }
+  return ans;
+}
+
+static
+void* start_node(void* ag)
+{
+  // Blocking...
+  e2_start_agent(ag);
+  return NULL;
+}
+
+static
+void sig_handler(int sig_num)
+{
+  (void)sig_num;
+  stop_token = true;
+}
+
+static
+void print_usage(char const* prog)
+{
+  printf("Usage: %s [options]\n", prog);
+  printf("  -n         : number of emulated E2 Nodes (default %u)\n", cfg.nodes);
+  printf("  -u         : UEs per E2 Node (default %u)\n", cfg.ues);
+  printf("  -b         : bearers per UE (default %u)\n", cfg.bearers);
+  printf("  -r         : E2 Nodes started per second (default %u)\n", cfg.ramp);
+  printf("  -d         : duration in s. 0 runs until SIGINT (default %u)\n", cfg.duration_s);
+  printf("  -c, -p     : config file and shared libs path, as in the E2 Agent\n");
+  printf("A MAC indication needs ~%zu bytes per UE and RLC/PDCP ones ~%zu/%zu per bearer. An E2AP message must stay below %d bytes\n",
+      sizeof(mac_ue_stats_impl_t), sizeof(rlc_radio_bearer_stats_t), sizeof(pdcp_radio_bearer_stats_t), 16384);
+}
+
+static
+uint32_t parse_u32(char const* str, char const* name, uint32_t min)
+{
+  char* end = NULL;
+  long const v = strtol(str, &end, 10);
+  if(*str == '\0' || *end != '\0' || v < min || v > UINT32_MAX){
+    printf("Error: invalid %s = %s\n", name, str);
+    exit(EXIT_FAILURE);
+  }
+  return v;
+}
+
+// Parses the load generator flags and returns the E2 Agent ones (i.e., -c and -p)
+static
+fr_args_t parse_args(int argc, char* argv[])
+{
+  char* fwd[5] = {argv[0]};
+  int len_fwd = 1;
+
+  int opt = '?';
+  while((opt = getopt(argc, argv, "hn:u:b:r:d:c:p:")) != -1) {
+    switch(opt){
+      case 'n': cfg.nodes = parse_u32(optarg, "number of E2 Nodes", 1); break;
+      case 'u': cfg.ues = parse_u32(optarg, "number of UEs", 1); break;
+      case 'b': cfg.bearers = parse_u32(optarg, "number of bearers", 1); break;
+      case 'r': cfg.ramp = parse_u32(optarg, "E2 Nodes per second", 1); break;
+      case 'd': cfg.duration_s = parse_u32(optarg, "duration", 0); break;
+      case 'c':
+      case 'p': {
+                  assert(len_fwd < 5);
+                  fwd[len_fwd++] = opt == 'c' ? "-c" : "-p";
+                  fwd[len_fwd++] = optarg;
+                  break;
+                }
+      case 'h': print_usage(argv[0]); exit(EXIT_SUCCESS);
+      default: print_usage(argv[0]); exit(EXIT_FAILURE);
+    }
+  }
+
+  // init_fr_args parses again with getopt
+  optind = 1;
+  return init_fr_args(len_fwd, fwd);
+}
+
+// Every E2 Node holds an SCTP association, an epoll, and one timer per subscription 
+static
+void raise_nofile_limit(void)
+{
+  struct rlimit rl = {0};
+  int rc = getrlimit(RLIMIT_NOFILE, &rl);
+  assert(rc == 0);
+  rl.rlim_cur = rl.rlim_max;
+  rc = setrlimit(RLIMIT_NOFILE, &rl);
+  assert(rc == 0);
+  if(rl.rlim_cur < 16 * cfg.nodes)
+    printf("[LOAD GEN]: Open files limit %lu may be too low for %u E2 Nodes\n", rl.rlim_cur, cfg.nodes);
+}
+
+static
+uint64_t sum_cnt(void)
+{
+  return cnt_mac + cnt_rlc + cnt_pdcp + cnt_other;
+}
+
+int main(int argc, char *argv[])
+{
+  fr_args_t const args = parse_args(argc, argv);
+
+  signal(SIGINT, sig_handler);
+  raise_nofile_limit();
+
+  char* server_ip_str = get_near_ric_ip(&args);
+  defer({ free(server_ip_str); });
+  const int e2ap_server_port = 36421;
+
+  printf("[LOAD GEN]: %u E2 Nodes with %u UEs and %u bearers per UE. nearRT-RIC IP Address = %s\n", cfg.nodes, cfg.ues, cfg.bearers, server_ip_str);
+
+  e2_agent_t** ag = calloc(cfg.nodes, sizeof(e2_agent_t*));
+  assert(ag != NULL && "Memory exhausted");
+  defer({ free(ag); });
+  pthread_t* thrd = calloc(cfg.nodes, sizeof(pthread_t));
+  assert(thrd != NULL && "Memory exhausted");
+  defer({ free(thrd); });
+
+  pthread_attr_t attr;
+  int rc = pthread_attr_init(&attr);
+  assert(rc == 0);
+  rc = pthread_attr_setstacksize(&attr, LOAD_GEN_STACK_SZ);
+  assert(rc == 0);
+
+  sm_io_ag_t const io = {.read = read_RAN, .write = write_RAN};
+
+  int64_t const t0 = time_now_us();
+  uint32_t started = 0;
+  for(; started < cfg.nodes && stop_token == false; ++started){
+    const plmn_t plmn = {.mcc = 505, .mnc = 1, .mnc_digit_len = 2};
+    global_e2_node_id_t const ge2ni = {.type = ngran_gNB, .plmn = plmn, .nb_id = started + 1, .cu_du_id = NULL};
+
+    ag[started] = e2_init_agent(server_ip_str, e2ap_server_port, ge2ni, io, &args);
+    rc = pthread_create(&thrd[started], &attr, start_node, ag[started]);
+    assert(rc == 0);
+
+    // Keep the rate of E2 Setup Requests
+    int64_t const next = t0 + (int64_t)(started + 1) * 1000000 / cfg.ramp;
+    int64_t const now = time_now_us();
+    if(next > now)
+      usleep(next - now);
+  }
+  pthread_attr_destroy(&attr);
+
+  printf("[LOAD GEN]: %u E2 Nodes started in %.3f s\n", started, (time_now_us() - t0) / 1000000.0);
+
+  // Indications generated per second
+  int64_t const t1 = time_now_us();
+  int64_t last_t = t1;
+  uint64_t last_cnt = sum_cnt();
+  while(stop_token == false && (cfg.duration_s == 0 || time_now_us() - t1 < (int64_t)cfg.duration_s * 1000000)){
+    sleep(1);
+    int64_t const now = time_now_us();
+    uint64_t const cnt = sum_cnt();
+    printf("[LOAD GEN]: %.0f ind/s (MAC %lu RLC %lu PDCP %lu other %lu total)\n", 
+        (cnt - last_cnt) * 1000000.0 / (now - last_t), cnt_mac, cnt_rlc, cnt_pdcp, cnt_other);
+    last_t = now;
+    last_cnt = cnt;
+  }
+
+  printf("[LOAD GEN]: %lu indications generated in %.3f s\n", sum_cnt(), (time_now_us() - t1) / 1000000.0);
+
+  for(uint32_t i = 0; i < started; ++i){
+    e2_free_agent(ag[i]);
+    rc = pthread_join(thrd[i], NULL);
+    assert(rc == 0);
+  }
+
+  return EXIT_SUCCESS;
+}
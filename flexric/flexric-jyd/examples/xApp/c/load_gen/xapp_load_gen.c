@@ -0,0 +1,352 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Measures the nearRT-RIC under the load of emu_load_gen. Subscribes to the
+ * MAC, RLC and PDCP SMs of every E2 Node at the given period and reports:
+ * - the subscription setup time
+ * - the indications per second that reach the xApp (i.e., RIC ingestion)
+ * - the latency from the E2 Node reading the RAN to the xApp callback. Both
+ *   sides share the clock as they run on the same machine
+ * - the round trip time of MAC control requests sent at a constant rate
+ */
+
+#include "../../../../src/xApp/e42_xapp_api.h"
+#include "../../../../src/sm/mac_sm/mac_sm_id.h"
+#include "../../../../src/sm/rlc_sm/rlc_sm_id.h"
+#include "../../../../src/sm/pdcp_sm/pdcp_sm_id.h"
+#include "../../../../src/util/alg_ds/alg/defer.h"
+#include "../../../../src/util/time_now_us.h"
+
+#include <assert.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct{
+  // Wait for this number of E2 Nodes
+  uint32_t nodes;
+  uint32_t period_ms;
+  uint32_t duration_s;
+  // MAC control requests per second. 0 disables them
+  uint32_t ctrl_rate;
+  uint32_t wait_s;
+} load_gen_args_t;
+
+static
+load_gen_args_t cfg = {.nodes = 1, .period_ms = 10, .duration_s = 10, .ctrl_rate = 10, .wait_s = 60};
+
+/////
+// Latency histogram. Exact below 128 us, and 64 buckets per power of two
+// above, i.e., < 1.6% relative error
+/////
+
+#define HIST_SUB_BITS 6
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_LEN ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+typedef struct{
+  uint64_t bucket[HIST_LEN];
+  uint64_t cnt;
+  uint64_t max;
+} lat_hist_t;
+
+static
+size_t hist_idx(uint64_t v)
+{
+  if(v < 2 * HIST_SUB)
+    return v;
+  int const e = 63 - __builtin_clzll(v);
+  return (e - HIST_SUB_BITS) * HIST_SUB + (v >> (e - HIST_SUB_BITS));
+}
+
+// Lowest value of the bucket
+static
+uint64_t hist_val(size_t idx)
+{
+  if(idx < 2 * HIST_SUB)
+    return idx;
+  int const e = idx / HIST_SUB + HIST_SUB_BITS - 1;
+  return (uint64_t)(idx % HIST_SUB + HIST_SUB) << (e - HIST_SUB_BITS);
+}
+
+static
+void add_hist(lat_hist_t* h, int64_t v)
+{
+  uint64_t const u = v < 0 ? 0 : v;
+  h->bucket[hist_idx(u)] += 1;
+  h->cnt += 1;
+  if(u > h->max)
+    h->max = u;
+}
+
+static
+uint64_t percentile_hist(lat_hist_t const* h, double p)
+{
+  assert(p > 0.0 && p <= 1.0);
+  if(h->cnt == 0)
+    return 0;
+
+  // Smallest rank that covers p of the samples 
+  uint64_t target = p * h->cnt;
+  if(target < p * h->cnt || target == 0)
+    target += 1;
+
+  uint64_t acc = 0;
+  for(size_t i = 0; i < HIST_LEN; ++i){
+    acc += h->bucket[i];
+    if(acc >= target)
+      return hist_val(i) < h->max ? hist_val(i) : h->max;
+  }
+  return h->max;
+}
+
+static
+void print_hist(char const* name, lat_hist_t const* h)
+{
+  printf("%-24s n = %-10lu p50 = %-8lu p90 = %-8lu p99 = %-8lu p99.9 = %-8lu max = %lu us\n", name, h->cnt, 
+      percentile_hist(h, 0.5), percentile_hist(h, 0.9), percentile_hist(h, 0.99), percentile_hist(h, 0.999), h->max);
+}
+
+/////
+// Indications
+/////
+
+typedef struct{
+  pthread_mutex_t mtx;
+  bool measuring;
+  lat_hist_t lat;
+  // Indications per SM 
+  uint64_t mac;
+  uint64_t rlc;
+  uint64_t pdcp;
+  // UE or bearer records 
+  uint64_t records;
+} ind_stats_t;
+
+static
+ind_stats_t stats = {.mtx = PTHREAD_MUTEX_INITIALIZER};
+
+static
+void sm_cb_load_gen(sm_ag_if_rd_t const* rd)
+{
+  assert(rd != NULL);
+
+  int64_t const now = time_now_us();
+
+  int64_t tstamp = 0;
+  uint64_t records = 0;
+  uint64_t* cnt = NULL;
+  if(rd->type == MAC_STATS_V0){
+    tstamp = rd->mac_stats.msg.tstamp;
+    records = rd->mac_stats.msg.len_ue_stats;
+    cnt = &stats.mac;
+  } else if(rd->type == RLC_STATS_V0){
+    tstamp = rd->rlc_stats.msg.tstamp;
+    records = rd->rlc_stats.msg.len;
+    cnt = &stats.rlc;
+  } else if(rd->type == PDCP_STATS_V0){
+    tstamp = rd->pdcp_stats.msg.tstamp;
+    records = rd->pdcp_stats.msg.len;
+    cnt = &stats.pdcp;
+  } else {
+    assert(0!=0 && "Unexpected SM");
+  }
+
+  pthread_mutex_lock(&stats.mtx);
+  if(stats.measuring){
+    add_hist(&stats.lat, now - tstamp);
+    *cnt += 1;
+    stats.records += records;
+  }
+  pthread_mutex_unlock(&stats.mtx);
+}
+
+/////
+// Arguments
+/////
+
+static
+void print_usage(char const* prog)
+{
+  printf("Usage: %s [options]\n", prog);
+  printf("  -n         : wait for this number of E2 Nodes (default %u)\n", cfg.nodes);
+  printf("  -m         : report period in ms (default %u)\n", cfg.period_ms);
+  printf("  -d         : measurement duration in s (default %u)\n", cfg.duration_s);
+  printf("  -r         : MAC control requests per second. 0 disables them (default %u)\n", cfg.ctrl_rate);
+  printf("  -w         : maximum wait for the E2 Nodes in s (default %u)\n", cfg.wait_s);
+  printf("  -c, -p     : config file and shared libs path, as in the xApps\n");
+}
+
+static
+uint32_t parse_u32(char const* str, char const* name, uint32_t min)
+{
+  char* end = NULL;
+  long const v = strtol(str, &end, 10);
+  if(*str == '\0' || *end != '\0' || v < min || v > UINT32_MAX){
+    printf("Error: invalid %s = %s\n", name, str);
+    exit(EXIT_FAILURE);
+  }
+  return v;
+}
+
+// Parses the load generator flags and returns the xApp ones (i.e., -c and -p)
+static
+fr_args_t parse_args(int argc, char* argv[])
+{
+  char* fwd[5] = {argv[0]};
+  int len_fwd = 1;
+
+  int opt = '?';
+  while((opt = getopt(argc, argv, "hn:m:d:r:w:c:p:")) != -1) {
+    switch(opt){
+      case 'n': cfg.nodes = parse_u32(optarg, "number of E2 Nodes", 1); break;
+      case 'm': cfg.period_ms = parse_u32(optarg, "period", 1); break;
+      case 'd': cfg.duration_s = parse_u32(optarg, "duration", 1); break;
+      case 'r': cfg.ctrl_rate = parse_u32(optarg, "control requests per second", 0); break;
+      case 'w': cfg.wait_s = parse_u32(optarg, "wait", 0); break;
+      case 'c':
+      case 'p': {
+                  assert(len_fwd < 5);
+                  fwd[len_fwd++] = opt == 'c' ? "-c" : "-p";
+                  fwd[len_fwd++] = optarg;
+                  break;
+                }
+      case 'h': print_usage(argv[0]); exit(EXIT_SUCCESS);
+      default: print_usage(argv[0]); exit(EXIT_FAILURE);
+    }
+  }
+
+  // init_fr_args parses again with getopt
+  optind = 1;
+  return init_fr_args(len_fwd, fwd);
+}
+
+static
+e2_node_arr_t wait_e2_nodes(void)
+{
+  int64_t const t0 = time_now_us();
+  while(true){
+    e2_node_arr_t nodes = e2_nodes_xapp_api();
+    if(nodes.len >= (int)cfg.nodes || time_now_us() - t0 >= (int64_t)cfg.wait_s * 1000000)
+      return nodes;
+    printf("[LOAD GEN]: %d of %u E2 Nodes connected\n", nodes.len, cfg.nodes);
+    free_e2_node_arr(&nodes);
+    sleep(1);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  fr_args_t const args = parse_args(argc, argv);
+
+  //Init the xApp
+  init_xapp_api(&args);
+  sleep(1);
+
+  e2_node_arr_t nodes = wait_e2_nodes();
+  defer({ free_e2_node_arr(&nodes); });
+
+  assert(nodes.len > 0 && "No E2 Node connected");
+  printf("[LOAD GEN]: Connected E2 nodes = %d\n", nodes.len);
+
+  // Subscriptions
+  uint16_t const sm_id[] = {SM_MAC_ID, SM_RLC_ID, SM_PDCP_ID};
+  size_t const len_sm = sizeof(sm_id) / sizeof(sm_id[0]);
+
+  sm_ans_xapp_t* handle = calloc(nodes.len * len_sm, sizeof(sm_ans_xapp_t));
+  assert(handle != NULL && "Memory exhausted");
+  defer({ free(handle); });
+
+  lat_hist_t* sub = calloc(1, sizeof(lat_hist_t));
+  assert(sub != NULL && "Memory exhausted");
+  defer({ free(sub); });
+
+  int64_t const t_sub = time_now_us();
+  for(int i = 0; i < nodes.len; ++i){
+    for(size_t j = 0; j < len_sm; ++j){
+      int64_t const t = time_now_us();
+      handle[i * len_sm + j] = report_sm_ev_xapp_api(&nodes.n[i].id, sm_id[j], cfg.period_ms, NULL, sm_cb_load_gen);
+      assert(handle[i * len_sm + j].success == true);
+      add_hist(sub, time_now_us() - t);
+    }
+  }
+  printf("[LOAD GEN]: %lu subscriptions in %.3f s\n", sub->cnt, (time_now_us() - t_sub) / 1000000.0);
+
+  // Measure
+  lat_hist_t* ctrl = calloc(1, sizeof(lat_hist_t));
+  assert(ctrl != NULL && "Memory exhausted");
+  defer({ free(ctrl); });
+
+  pthread_mutex_lock(&stats.mtx);
+  stats.measuring = true;
+  pthread_mutex_unlock(&stats.mtx);
+
+  int64_t const t0 = time_now_us();
+  int64_t const t_end = t0 + (int64_t)cfg.duration_s * 1000000;
+  if(cfg.ctrl_rate == 0){
+    sleep(cfg.duration_s);
+  } else {
+    sm_ag_if_wr_t wr = {.type = MAC_CTRL_REQ_V0};
+    wr.mac_ctrl.hdr.dummy = 0;
+    wr.mac_ctrl.msg.action = 42;
+
+    for(uint64_t n = 0; time_now_us() < t_end; ++n){
+      int64_t const t = time_now_us();
+      control_sm_xapp_api(&nodes.n[n % nodes.len].id, SM_MAC_ID, &wr);
+      add_hist(ctrl, time_now_us() - t);
+
+      int64_t const next = t0 + (int64_t)(n + 1) * 1000000 / cfg.ctrl_rate;
+      int64_t const now = time_now_us();
+      if(next > now)
+        usleep((next < t_end ? next : t_end) - now);
+    }
+  }
+
+  pthread_mutex_lock(&stats.mtx);
+  stats.measuring = false;
+  pthread_mutex_unlock(&stats.mtx);
+  double const elapsed = (time_now_us() - t0) / 1000000.0;
+
+  for(size_t i = 0; i < nodes.len * len_sm; ++i){
+    // Remove the handle previously returned
+    rm_report_sm_xapp_api(handle[i].u.handle);
+  }
+
+  // Report. The callbacks do not modify stats once measuring is false
+  uint64_t const ind = stats.mac + stats.rlc + stats.pdcp; 
+  printf("\n[LOAD GEN]: %d E2 Nodes, period %u ms, %.3f s\n", nodes.len, cfg.period_ms, elapsed);
+  printf("Indications              %.0f ind/s (MAC %lu RLC %lu PDCP %lu), %.0f UE/bearer records/s. Expected %.0f ind/s\n",
+      ind / elapsed, stats.mac, stats.rlc, stats.pdcp, stats.records / elapsed, 1000.0 * nodes.len * len_sm / cfg.period_ms);
+  print_hist("Subscription setup", sub);
+  print_hist("Indication latency", &stats.lat);
+  if(cfg.ctrl_rate > 0)
+    print_hist("Control round trip", ctrl);
+
+  //Stop the xApp
+  while(try_stop_xapp_api() == false)
+    usleep(1000);
+
+  printf("Test xApp run SUCCESSFULLY\n");
+}
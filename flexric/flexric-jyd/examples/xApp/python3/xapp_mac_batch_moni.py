@@ -0,0 +1,56 @@
+import xapp_sdk as ric
+import numpy as np
+import time
+
+####################
+#### MAC BATCH CALLBACK
+####################
+
+#  MACBatchCallback class is defined and derived from C++ class batch_cb
+class MACBatchCallback(ric.batch_cb):
+    # Define Python class 'constructor'
+    def __init__(self):
+        # Call C++ base class constructor
+        ric.batch_cb.__init__(self)
+    # Override C++ method: virtual void handle(swig_batch_t* b) = 0;
+    def handle(self, b):
+        # Structured array over the records, no copy. One record per UE and indication
+        ue = np.asarray(b.records())
+        if len(ue) > 0:
+            t_now = time.time_ns() / 1000.0
+            t_diff = t_now - ue['tstamp'][-1]
+            print('MAC batch records = ' + str(len(ue)) + ' dropped = ' + str(b.dropped) + ' diff = ' + str(t_diff))
+            # print('MAC rnti = ' + str(np.unique(ue['rnti'])) + ' mean dl_mcs1 = ' + str(ue['dl_mcs1'].mean()))
+
+####################
+####  GENERAL 
+####################
+
+ric.init()
+
+conn = ric.conn_e2_nodes()
+assert(len(conn) > 0)
+
+####################
+#### MAC INDICATION
+####################
+
+# Deliver the 1 ms MAC reports every 100 ms, with room for 8192 UE records per batch
+mac_cb = MACBatchCallback()
+mac_hndlr = []
+for i in range(0, len(conn)):
+    hndlr = ric.report_mac_sm_async(conn[i].id, ric.Interval_ms_1, mac_cb, 100, 8192)
+    mac_hndlr.append(hndlr)
+
+time.sleep(10)
+
+### End
+
+for i in range(0, len(mac_hndlr)):
+    ric.rm_report_sm_async(mac_hndlr[i])
+
+# Avoid deadlock. ToDo revise architecture 
+while ric.try_stop == 0:
+    time.sleep(1)
+
+print("Test finished")
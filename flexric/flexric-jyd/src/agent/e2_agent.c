@@ -99,6 +99,21 @@ ric_indication_t generate_indication(e2_agent_t* ag, sm_ind_data_t* data, ind_ev
   return ind;
 }
 
+static
+void free_indication_agent(ric_indication_t* ind, bool sm_owned)
+{
+  assert(ind != NULL);
+
+  if(sm_owned == true){
+    // The SM reuses these buffers for its next indication
+    ind->hdr.buf = NULL;
+    ind->msg.buf = NULL;
+    if(ind->call_process_id != NULL)
+      ind->call_process_id->buf = NULL;
+  }
+  e2ap_free_indication(ind);
+}
+
 
 static inline
 void free_fd(void* key, void* value)
@@ -152,6 +167,8 @@ void free_ind_event(void* key, void* value)
   (void)key;
 
   ind_event_t* ev = (ind_event_t* )value;
+  if(ev->sm_data != NULL)
+    ev->sm->proc.free_ev_data(ev->sm, ev->sm_data);
   free(ev);
 }
 
@@ -325,10 +342,22 @@ void e2_event_loop_agent(e2_agent_t* ag)
       case INDICATION_EVENT:
         {
           sm_agent_t* sm = e.i_ev->sm;
-          sm_ind_data_t data = sm->proc.on_indication(sm);
+          sm_ind_data_t data = e.i_ev->sm_data == NULL ? sm->proc.on_indication(sm)
+                                                       : sm->proc.on_indication_ev(sm, e.i_ev->sm_data);
+
+          // Event triggered subscription with no UE fulfilling the conditions
+          if(data.len_msg == 0){
+            assert(e.i_ev->sm_data != NULL && "Empty indication in a periodic subscription");
+            if(data.sm_owned == false){
+              free(data.ind_hdr);
+              free(data.call_process_id);
+            }
+            consume_fd(e.fd);
+            break;
+          }
 
           ric_indication_t ind = generate_indication(ag, &data, e.i_ev);
-          defer({ e2ap_free_indication(&ind); } );
+          defer({ free_indication_agent(&ind, data.sm_owned); } );
 
           byte_array_t ba = e2ap_enc_indication_ag(&ag->ap, &ind); 
           defer({ free_byte_array(ba); } );
@@ -445,12 +474,13 @@ void e2_free_agent(e2_agent_t* ag)
     usleep(1000);
   }
 
+  // Before the plugins, as the SMs own the state of the subscriptions
+  free_indication_event(ag);
+
   free_plugin_ag(&ag->plugin);
 
   free_pending_agent(ag);
 
-  free_indication_event(ag);
-
   free(ag);
 }
 
@@ -68,6 +68,7 @@ void e2ap_init_ep_agent(e2ap_ep_ag_t* ep, const char* addr, int port)
   assert(strlen(addr) < 16);
   assert(port > 0 && port < 65535);
   init_sctp_conn_client(ep, addr, port);
+  e2ap_ep_init_rx_pool(&ep->base, 16);
 }
 
 /*
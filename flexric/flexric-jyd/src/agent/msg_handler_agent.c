@@ -53,6 +53,25 @@ static
 void stop_ind_event(e2_agent_t* ag, ric_gen_id_t id)
 {
   assert(ag != NULL);
+
+  // The SM state of the subscription is released before the
+  // bi_map frees its copy of the indication event
+  void* it = assoc_front(&ag->ind_event.left);
+  void* end_it = assoc_end(&ag->ind_event.left);
+  while(it != end_it){
+    ind_event_t* ev = assoc_value(&ag->ind_event.left, it);
+    if(eq_ric_gen_id(&ev->ric_id, &id) == true){
+      if(ev->sm_data != NULL){
+        ev->sm->proc.free_ev_data(ev->sm, ev->sm_data);
+        ev->sm_data = NULL;
+      }
+      if(ev->sm->io.subscription != NULL)
+        ev->sm->io.subscription(ev->sm->ran_func_id, ev->ms, false);
+      break;
+    }
+    it = assoc_next(&ag->ind_event.left, it);
+  }
+
   ind_event_t tmp = {.ric_id = id, .sm = NULL, .action_id =0 };
   int* fd = bi_map_extract_right(&ag->ind_event, &tmp, sizeof(tmp) );
   assert(*fd > 0);
@@ -143,6 +162,7 @@ e2ap_msg_t e2ap_handle_subscription_request_agent(e2_agent_t* ag, const e2ap_msg
   uint16_t const ran_func_id = sr->ric_id.ran_func_id; 
   sm_agent_t* sm = sm_plugin_ag(&ag->plugin, ran_func_id);
   subscribe_timer_t t = sm->proc.on_subscription(sm, &data);
+  assert(t.data == NULL || (sm->proc.on_indication_ev != NULL && sm->proc.free_ev_data != NULL));
   int fd_timer = create_timer_ms_asio_agent(&ag->io, t.ms, t.ms); 
   //printf("fd_timer for subscription value created == %d\n", fd_timer);
 
@@ -151,8 +171,13 @@ e2ap_msg_t e2ap_handle_subscription_request_agent(e2_agent_t* ag, const e2ap_msg
   ev.action_id = sr->action[0].id;
   ev.ric_id = sr->ric_id;
   ev.sm = sm;
+  ev.ms = t.ms;
+  ev.sm_data = t.data;
   bi_map_insert(&ag->ind_event, &fd_timer, sizeof(fd_timer), &ev, sizeof(ev));
 
+  if(sm->io.subscription != NULL)
+    sm->io.subscription(ran_func_id, t.ms, true);
+
   printf("[E2-AGENT]: RIC_SUBSCRIPTION_REQUEST rx\n");
 
   uint8_t const ric_act_id = sr->action[0].id;
@@ -221,7 +246,7 @@ e2ap_msg_t e2ap_handle_control_request_agent(e2_agent_t* ag, const e2ap_msg_t* m
 
  
   ric_control_request_t const* ctrl_req = &msg->u_msgs.ric_ctrl_req;
-  assert(ctrl_req->ack_req != NULL && *ctrl_req->ack_req == RIC_CONTROL_REQUEST_ACK );
+  assert(ctrl_req->ack_req != NULL && (*ctrl_req->ack_req == RIC_CONTROL_REQUEST_ACK || *ctrl_req->ack_req == RIC_CONTROL_REQUEST_NO_ACK));
 
   sm_ctrl_req_data_t data = {.ctrl_hdr = ctrl_req->hdr.buf,
                           .len_hdr = ctrl_req->hdr.len,
@@ -235,6 +260,11 @@ e2ap_msg_t e2ap_handle_control_request_agent(e2_agent_t* ag, const e2ap_msg_t* m
   sm_ctrl_out_data_t ctrl_ans = sm->proc.on_control(sm, &data);
   defer({ free_sm_ctrl_out_data(&ctrl_ans); } );
 
+  // E.g., the keyframe requests of the RIC
+  if(*ctrl_req->ack_req == RIC_CONTROL_REQUEST_NO_ACK){
+    e2ap_msg_t ans = {.type = NONE_E2_MSG_TYPE};
+    return ans;
+  }
 
   byte_array_t* ba_ctrl_ans = ba_from_ctrl_out(&ctrl_ans);
 
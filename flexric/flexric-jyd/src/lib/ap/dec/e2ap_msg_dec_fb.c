@@ -379,21 +379,19 @@ e2ap_msg_t e2ap_dec_indication_fb(e2ap_E2Message_table_t e2mt)
   assert(e2ap_RicIndication_indicationType_is_present(fb_sdr));
   ind->type = e2ap_RicIndication_indicationType(fb_sdr);
 
+  // The header and the message borrow the received buffer. It is freed
+  // after the decoded message
+  ind->borrowed = true;
+
   assert(e2ap_RicIndication_header_is_present(fb_sdr));
   const uint8_t* hdr = e2ap_RicIndication_header(fb_sdr);
-  const size_t hdr_len = flatbuffers_uint8_vec_len(hdr);
-  ind->hdr.buf = malloc(hdr_len);
-  assert(ind->hdr.buf);
-  memcpy(ind->hdr.buf, hdr, hdr_len);
-  ind->hdr.len = hdr_len;
+  ind->hdr.buf = (uint8_t*)hdr;
+  ind->hdr.len = flatbuffers_uint8_vec_len(hdr);
 
   assert(e2ap_RicIndication_message_is_present(fb_sdr));
   const uint8_t* msg = e2ap_RicIndication_message(fb_sdr);
-  const size_t msg_len = flatbuffers_uint8_vec_len(msg);
-  ind->msg.buf = malloc(msg_len);
-  assert(ind->msg.buf);
-  memcpy(ind->msg.buf, msg, msg_len);
-  ind->msg.len = msg_len;
+  ind->msg.buf = (uint8_t*)msg;
+  ind->msg.len = flatbuffers_uint8_vec_len(msg);
 
   if (e2ap_RicIndication_callProcessId_is_present(fb_sdr)) {
     const uint8_t* cpi = e2ap_RicIndication_callProcessId(fb_sdr);
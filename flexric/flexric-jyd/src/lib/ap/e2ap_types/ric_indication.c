@@ -83,6 +83,7 @@ ric_indication_t mv_ric_indication(ric_indication_t* src)
   dst.hdr = src->hdr;
   dst.msg = src->msg;
   dst.call_process_id = src->call_process_id; // optional
+  dst.borrowed = src->borrowed;
 
   memset(src, 0, sizeof(ric_indication_t) );
 
@@ -24,6 +24,7 @@
 
 #include "common/ric_gen_id.h"
 #include "util/byte_array.h"
+#include <stdbool.h>
 #include <stdint.h> 
 
 typedef enum {
@@ -39,6 +40,7 @@ typedef struct ric_indication {
   byte_array_t hdr;
   byte_array_t msg;
   byte_array_t* call_process_id; // optional
+  bool borrowed; // hdr and msg point into the received buffer and are not freed
 } ric_indication_t;
 
 bool eq_ric_indication(const ric_indication_t* m0, const ric_indication_t* m1);
@@ -22,6 +22,8 @@
 
 #include "ric_subscription_request.h"
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 bool eq_ric_subscritption_request(const ric_subscription_request_t* m0, const ric_subscription_request_t* m1)
 {
@@ -49,6 +51,52 @@ bool eq_ric_subscritption_request(const ric_subscription_request_t* m0, const ri
   return true;
 }
 
+static
+ric_action_t cp_ric_action(ric_action_t const* src)
+{
+  assert(src != NULL);
+
+  ric_action_t dst = {.id = src->id, .type = src->type};
+
+  if(src->definition != NULL){
+    dst.definition = malloc(sizeof(byte_array_t));
+    assert(dst.definition != NULL && "Memory exhausted");
+    *dst.definition = copy_byte_array(*src->definition);
+  }
+
+  if(src->subseq_action != NULL){
+    dst.subseq_action = calloc(1, sizeof(ric_subsequent_action_t));
+    assert(dst.subseq_action != NULL && "Memory exhausted");
+    dst.subseq_action->type = src->subseq_action->type;
+    if(src->subseq_action->time_to_wait_ms != NULL){
+      dst.subseq_action->time_to_wait_ms = malloc(sizeof(uint32_t));
+      assert(dst.subseq_action->time_to_wait_ms != NULL && "Memory exhausted");
+      *dst.subseq_action->time_to_wait_ms = *src->subseq_action->time_to_wait_ms;
+    }
+  }
+
+  return dst;
+}
+
+ric_subscription_request_t cp_ric_subscription_request(ric_subscription_request_t const* src)
+{
+  assert(src != NULL);
+
+  ric_subscription_request_t dst = {.ric_id = src->ric_id,
+                                    .event_trigger = copy_byte_array(src->event_trigger),
+                                    .len_action = src->len_action};
+
+  if(dst.len_action > 0){
+    dst.action = calloc(dst.len_action, sizeof(ric_action_t));
+    assert(dst.action != NULL && "Memory exhausted");
+  }
+
+  for(size_t i = 0; i < dst.len_action; ++i)
+    dst.action[i] = cp_ric_action(&src->action[i]);
+
+  return dst;
+}
+
 ric_subscription_request_t mv_ric_subscription_request( ric_subscription_request_t* sr)
 {
   assert(sr != NULL);
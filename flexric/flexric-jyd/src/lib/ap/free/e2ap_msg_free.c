@@ -198,8 +198,10 @@ void e2ap_free_indication(ric_indication_t* ind)
     free(ind->sn);
   }
 
-  free_byte_array(ind->hdr); 
-  free_byte_array(ind->msg);
+  if(ind->borrowed == false){
+    free_byte_array(ind->hdr); 
+    free_byte_array(ind->msg);
+  }
   free_ba_if_not_null(ind->call_process_id);
 }
 
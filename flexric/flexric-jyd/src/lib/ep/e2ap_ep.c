@@ -19,6 +19,7 @@
  *      contact@openairinterface.org
  */
 
+#define _GNU_SOURCE // recvmmsg
 #include "e2ap_ep.h"
 #include "../../util/alg_ds/ds/lock_guard/lock_guard.h"
 
@@ -35,6 +36,22 @@ void e2ap_ep_free(e2ap_ep_t* ep)
   assert(ep != NULL);
   int rc = pthread_mutex_destroy(&ep->mtx);
   assert(rc == 0);
+
+  if(ep->rx_pool != NULL){
+    free_sctp_buf_pool(ep->rx_pool);
+    free(ep->rx_pool);
+    ep->rx_pool = NULL;
+  }
+}
+
+void e2ap_ep_init_rx_pool(e2ap_ep_t* ep, size_t cap)
+{
+  assert(ep != NULL);
+  assert(ep->rx_pool == NULL);
+
+  ep->rx_pool = malloc(sizeof(sctp_buf_pool_t));
+  assert(ep->rx_pool != NULL && "Memory exhausted");
+  init_sctp_buf_pool(ep->rx_pool, E2AP_RECV_BUF_SZ, cap);
 }
 
 void e2ap_send_sctp_msg(const e2ap_ep_t* ep, sctp_msg_t* msg)
@@ -154,37 +171,143 @@ union sctp_notification cp_sctp_notification(union sctp_notification const* src,
   return dst;
 }
 
+static
+uint8_t* alloc_recv_buf(e2ap_ep_t* ep)
+{
+  if(ep->rx_pool != NULL)
+    return get_sctp_buf_pool(ep->rx_pool);
+
+  uint8_t* buf = malloc(E2AP_RECV_BUF_SZ);
+  assert(buf != NULL && "Memory exhausted");
+  return buf;
+}
+
+static
+void release_recv_buf(e2ap_ep_t* ep, uint8_t* buf)
+{
+  if(ep->rx_pool != NULL)
+    put_sctp_buf_pool(ep->rx_pool, buf);
+  else
+    free(buf);
+}
+
+static
+void fill_recv_msg(e2ap_ep_t* ep, sctp_msg_t* from, int rc, int msg_flags)
+{
+  assert(rc > -1 && rc != 0 && rc < E2AP_RECV_BUF_SZ);
+
+  if(msg_flags & MSG_NOTIFICATION){
+    assert((msg_flags & MSG_EOR) && "Notification received but the buffer is not large enough");
+    uint8_t buf[2048] = {0};
+    memcpy(buf, from->ba.buf, 2048);
+    release_recv_buf(ep, from->ba.buf); 
+
+    from->type = SCTP_MSG_NOTIFICATION;
+    from->notif = cp_sctp_notification((union sctp_notification*) buf, rc); 
+    from->pool = NULL;
+  } else {
+    from->type = SCTP_MSG_PAYLOAD;
+    from->ba.len = rc; // set actually received number of bytes
+    from->pool = ep->rx_pool;
+  }
+}
+
 sctp_msg_t e2ap_recv_sctp_msg(e2ap_ep_t* ep)
 {
   assert(ep != NULL);
 
   sctp_msg_t from = {0}; 
 
-  from.ba.len = 16384;
-  from.ba.buf = malloc(16384);
-
-  assert(from.ba.buf != NULL && "Memory exhausted");
+  from.ba.len = E2AP_RECV_BUF_SZ;
+  from.ba.buf = alloc_recv_buf(ep);
 
   socklen_t len = sizeof(from.info.addr);
   int msg_flags = 0;
 
   lock_guard(&((e2ap_ep_t*)ep)->mtx);
   int const rc = sctp_recvmsg(ep->fd, from.ba.buf, from.ba.len, (struct sockaddr*)&from.info.addr, &len, &from.info.sri, &msg_flags);
-  assert(rc > -1 && rc != 0 && rc < (int)from.ba.len);
 
-  if(msg_flags & MSG_NOTIFICATION){
-    assert((msg_flags & MSG_EOR) && "Notification received but the buffer is not large enough");
-    uint8_t buf[2048] = {0};
-    memcpy(buf, from.ba.buf, 2048);
-    free(from.ba.buf); 
+  fill_recv_msg(ep, &from, rc, msg_flags);
 
-    from.type = SCTP_MSG_NOTIFICATION;
-    from.notif = cp_sctp_notification((union sctp_notification*) buf, rc); 
-  } else {
-    from.type = SCTP_MSG_PAYLOAD;
-    from.ba.len = rc; // set actually received number of bytes
+  return from;
+}
+
+#ifdef __linux__
+
+#define E2AP_RECV_BATCH 32
+
+static
+void copy_sndrcvinfo(struct msghdr const* hdr, struct sctp_sndrcvinfo* sri)
+{
+  for(struct cmsghdr* c = CMSG_FIRSTHDR(hdr); c != NULL; c = CMSG_NXTHDR((struct msghdr*)hdr, c)){
+    if(c->cmsg_level == IPPROTO_SCTP && c->cmsg_type == SCTP_SNDRCV){
+      memcpy(sri, CMSG_DATA(c), sizeof(*sri));
+      return;
+    }
   }
+}
 
-  return from;
+size_t e2ap_recv_sctp_msgs(e2ap_ep_t* ep, sctp_msg_t* msgs, size_t len)
+{
+  assert(ep != NULL);
+  assert(msgs != NULL);
+  assert(len > 0);
+
+  if(len > E2AP_RECV_BATCH)
+    len = E2AP_RECV_BATCH;
+
+  struct mmsghdr mmsg[E2AP_RECV_BATCH];
+  struct iovec iov[E2AP_RECV_BATCH];
+  uint8_t cmsg[E2AP_RECV_BATCH][CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))];
+
+  for(size_t i = 0; i < len; ++i){
+    memset(&msgs[i], 0, sizeof(sctp_msg_t));
+    msgs[i].ba.buf = alloc_recv_buf(ep);
+    msgs[i].ba.len = E2AP_RECV_BUF_SZ;
+
+    iov[i].iov_base = msgs[i].ba.buf;
+    iov[i].iov_len = E2AP_RECV_BUF_SZ;
+
+    memset(&mmsg[i], 0, sizeof(struct mmsghdr));
+    mmsg[i].msg_hdr.msg_name = &msgs[i].info.addr;
+    mmsg[i].msg_hdr.msg_namelen = sizeof(msgs[i].info.addr);
+    mmsg[i].msg_hdr.msg_iov = &iov[i];
+    mmsg[i].msg_hdr.msg_iovlen = 1;
+    mmsg[i].msg_hdr.msg_control = cmsg[i];
+    mmsg[i].msg_hdr.msg_controllen = sizeof(cmsg[i]);
+  }
+
+  int rc = 0;
+  {
+    lock_guard(&ep->mtx);
+    rc = recvmmsg(ep->fd, mmsg, len, MSG_DONTWAIT, NULL);
+  }
+  assert((rc > -1 || errno == EAGAIN || errno == EWOULDBLOCK) && "recvmmsg failed");
+  size_t const num = rc > 0 ? (size_t)rc : 0;
+
+  for(size_t i = 0; i < num; ++i){
+    copy_sndrcvinfo(&mmsg[i].msg_hdr, &msgs[i].info.sri);
+    fill_recv_msg(ep, &msgs[i], mmsg[i].msg_len, mmsg[i].msg_hdr.msg_flags);
+  }
+
+  for(size_t i = num; i < len; ++i)
+    release_recv_buf(ep, msgs[i].ba.buf);
+
+  return num;
 }
 
+#else
+
+size_t e2ap_recv_sctp_msgs(e2ap_ep_t* ep, sctp_msg_t* msgs, size_t len)
+{
+  assert(ep != NULL);
+  assert(msgs != NULL);
+  assert(len > 0);
+
+  // No batched reads. One message per readiness notification
+  msgs[0] = e2ap_recv_sctp_msg(ep);
+  return 1;
+}
+
+#endif
+
@@ -35,6 +35,10 @@
 
 #include "util/byte_array.h"
 #include "sctp_msg.h"
+#include "sctp_buf_pool.h"
+
+// Maximum size of a received SCTP message
+#define E2AP_RECV_BUF_SZ 16384
 
 
 typedef struct{
@@ -42,15 +46,23 @@ typedef struct{
   const int port;
   const int fd;
   pthread_mutex_t mtx;
+  sctp_buf_pool_t* rx_pool; // NULL: received messages are heap allocated
 } e2ap_ep_t;
 
 void e2ap_ep_init(e2ap_ep_t* ep);
 
 void e2ap_ep_free(e2ap_ep_t* ep);
 
+// Received messages borrow their buffer from a pool. free_sctp_msg gives
+// it back, so the ep must outlive every received message 
+void e2ap_ep_init_rx_pool(e2ap_ep_t* ep, size_t cap);
+
 void e2ap_send_sctp_msg(const e2ap_ep_t* ep, sctp_msg_t* msg);
 
 sctp_msg_t e2ap_recv_sctp_msg(e2ap_ep_t* ep);
 
+// Reads up to len messages without blocking. Returns the number read
+size_t e2ap_recv_sctp_msgs(e2ap_ep_t* ep, sctp_msg_t* msgs, size_t len);
+
 #endif
 
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#include "sctp_buf_pool.h"
+#include "../../util/alg_ds/ds/lock_guard/lock_guard.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+void init_sctp_buf_pool(sctp_buf_pool_t* p, size_t buf_sz, size_t cap)
+{
+  assert(p != NULL);
+  assert(buf_sz > 0);
+  assert(cap > 0);
+
+  int const rc = pthread_mutex_init(&p->mtx, NULL);
+  assert(rc == 0);
+
+  p->free_bufs = calloc(cap, sizeof(uint8_t*));
+  assert(p->free_bufs != NULL && "Memory exhausted");
+  p->len = 0;
+  p->cap = cap;
+  p->buf_sz = buf_sz;
+}
+
+void free_sctp_buf_pool(sctp_buf_pool_t* p)
+{
+  assert(p != NULL);
+
+  for(size_t i = 0; i < p->len; ++i)
+    free(p->free_bufs[i]);
+  free(p->free_bufs);
+
+  int const rc = pthread_mutex_destroy(&p->mtx);
+  assert(rc == 0);
+}
+
+uint8_t* get_sctp_buf_pool(sctp_buf_pool_t* p)
+{
+  assert(p != NULL);
+
+  {
+    lock_guard(&p->mtx);
+    if(p->len > 0){
+      p->len -= 1;
+      return p->free_bufs[p->len];
+    }
+  }
+
+  uint8_t* buf = malloc(p->buf_sz);
+  assert(buf != NULL && "Memory exhausted");
+  return buf;
+}
+
+void put_sctp_buf_pool(sctp_buf_pool_t* p, uint8_t* buf)
+{
+  assert(p != NULL);
+  assert(buf != NULL);
+
+  {
+    lock_guard(&p->mtx);
+    if(p->len < p->cap){
+      p->free_bufs[p->len] = buf;
+      p->len += 1;
+      return;
+    }
+  }
+
+  free(buf);
+}
+
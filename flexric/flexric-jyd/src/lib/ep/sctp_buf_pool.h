@@ -0,0 +1,53 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef SCTP_BUFFER_POOL_H
+#define SCTP_BUFFER_POOL_H
+
+/*
+ * Pool of fixed size receive buffers. Buffers released by any thread are
+ * handed out again to the receiving thread, so that in steady state no
+ * message is heap allocated.
+ */
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct sctp_buf_pool_s{
+  pthread_mutex_t mtx;
+  uint8_t** free_bufs;
+  size_t len;
+  size_t cap; // buffers kept. The rest are freed
+  size_t buf_sz;
+} sctp_buf_pool_t;
+
+void init_sctp_buf_pool(sctp_buf_pool_t* p, size_t buf_sz, size_t cap);
+
+void free_sctp_buf_pool(sctp_buf_pool_t* p);
+
+uint8_t* get_sctp_buf_pool(sctp_buf_pool_t* p);
+
+void put_sctp_buf_pool(sctp_buf_pool_t* p, uint8_t* buf);
+
+#endif
+
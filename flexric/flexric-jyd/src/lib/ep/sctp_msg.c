@@ -25,8 +25,13 @@ void free_sctp_msg(sctp_msg_t* rcv)
 {
   assert(rcv != NULL);
 
- if(rcv->type == SCTP_MSG_PAYLOAD)
-  free_byte_array(rcv->ba);
+ if(rcv->type != SCTP_MSG_PAYLOAD)
+   return;
+
+ if(rcv->pool != NULL)
+   put_sctp_buf_pool(rcv->pool, rcv->ba.buf);
+ else
+   free_byte_array(rcv->ba);
 }
 
 
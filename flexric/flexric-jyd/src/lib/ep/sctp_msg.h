@@ -35,6 +35,7 @@
 
 #include <stdbool.h>
 #include "util/byte_array.h"
+#include "sctp_buf_pool.h"
 
 typedef enum {
   SCTP_MSG_PAYLOAD,
@@ -57,6 +58,7 @@ typedef struct{
     byte_array_t ba;
     union sctp_notification notif;
   };
+  sctp_buf_pool_t* pool; // ba.buf is returned here if not NULL
 } sctp_msg_t;
 
 void free_sctp_msg(sctp_msg_t* rcv);
@@ -33,6 +33,10 @@ typedef struct
   ric_gen_id_t ric_id;
   sm_agent_t* sm;
   uint8_t action_id;
+  // Period of the subscription timer
+  uint32_t ms;
+  // Owned by the SM. See subscribe_timer_t.data
+  void* sm_data;
 } ind_event_t;
 
 int cmp_ind_event(void const* m0_v, void const* m1_v);
@@ -96,6 +96,9 @@ void e2ap_init_ep_ric(e2ap_ep_ric_t* ep, const char* addr, int port)
 
   init_map_e2_node_sad(&ep->e2_nodes);
 
+  // Received buffers travel to the worker shards and come back when freed
+  e2ap_ep_init_rx_pool(&ep->base, 1024);
+
   printf("[NEAR-RIC]: Initializing \n"); //server fd = %d\n", ep->base.fd);
 }
 
@@ -115,6 +118,14 @@ sctp_msg_t e2ap_recv_msg_ric(e2ap_ep_ric_t* ep)
   return rcv;
 }
 
+size_t e2ap_recv_msgs_ric(e2ap_ep_ric_t* ep, sctp_msg_t* msgs, size_t len)
+{
+  assert(ep != NULL);
+  assert(msgs != NULL);
+
+  return e2ap_recv_sctp_msgs(&ep->base, msgs, len);
+}
+
 void e2ap_send_bytes_ric(const e2ap_ep_ric_t* ep, global_e2_node_id_t const* id , byte_array_t ba)
 {
   assert(ba.buf && ba.len > 0);
@@ -153,3 +164,10 @@ global_e2_node_id_t* e2ap_rm_sock_addr_ric(e2ap_ep_ric_t* ep, sctp_info_t const*
   return rm_map_sad_e2_node(&ep->e2_nodes, s);
 }
 
+global_e2_node_id_t e2ap_find_e2_node_ric(e2ap_ep_ric_t* ep, sctp_info_t const* s)
+{
+  assert(ep != NULL);
+  assert(s != NULL);
+
+  return find_map_sad_e2_node(&ep->e2_nodes, s);
+}
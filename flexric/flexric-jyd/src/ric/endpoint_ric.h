@@ -42,6 +42,8 @@ void e2ap_free_ep_ric(e2ap_ep_ric_t* ep);
 
 sctp_msg_t e2ap_recv_msg_ric(e2ap_ep_ric_t* ep);
 
+size_t e2ap_recv_msgs_ric(e2ap_ep_ric_t* ep, sctp_msg_t* msgs, size_t len);
+
 void e2ap_send_bytes_ric(const e2ap_ep_ric_t* ep, global_e2_node_id_t const* id, byte_array_t ba);
 
 void e2ap_send_sctp_msg_ric(const e2ap_ep_ric_t* ep, sctp_msg_t* msg);
@@ -50,5 +52,7 @@ void e2ap_reg_sock_addr_ric(e2ap_ep_ric_t* ric, global_e2_node_id_t* id, sctp_in
 
 global_e2_node_id_t* e2ap_rm_sock_addr_ric(e2ap_ep_ric_t* ric, sctp_info_t const* s);
 
+global_e2_node_id_t e2ap_find_e2_node_ric(e2ap_ep_ric_t* ep, sctp_info_t const* s);
+
 #endif
 
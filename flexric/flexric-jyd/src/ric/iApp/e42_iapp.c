@@ -77,6 +77,8 @@ e42_iapp_t* init_e42_iapp(const char* addr, near_ric_if_t ric_if)
 
   init_map_ric_id(&iapp->map_ric_id);
 
+  init_map_shared_sub(&iapp->map_sub);
+
 
   iapp->xapp_id = 7;
 
@@ -226,6 +228,8 @@ void free_e42_iapp(e42_iapp_t* iapp)
 
   free_map_ric_id(&iapp->map_ric_id);
 
+  free_map_shared_sub(&iapp->map_sub);
+
   free(iapp);
 }
 
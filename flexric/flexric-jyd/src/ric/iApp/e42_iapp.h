@@ -39,6 +39,7 @@
 #include "e2ap_iapp.h"
 #include "endpoint_iapp.h"
 #include "map_ric_id.h"
+#include "map_shared_sub.h"
 
 #include <stdatomic.h>
 #include <stdbool.h>
@@ -60,8 +61,12 @@ typedef struct e42_iapp_s
   // Registered E2 Nodes 
   reg_e2_nodes_t e2_nodes;
 
+  // Control requests 
   map_ric_id_t map_ric_id;
 
+  // Subscriptions. Compatible ones share the E2 subscription
+  map_shared_sub_t map_sub;
+
   near_ric_if_t ric_if;
 
   atomic_bool stop_token;
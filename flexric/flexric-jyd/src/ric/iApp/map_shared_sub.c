@@ -0,0 +1,230 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "../../lib/ap/free/e2ap_msg_free.h"
+#include "../../util/alg_ds/alg/alg.h"
+#include "map_shared_sub.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+static inline
+int cmp_uint16(const void* m0_v, const void* m1_v)
+{
+  uint16_t* m0 = (uint16_t*)m0_v;
+  uint16_t* m1 = (uint16_t*)m1_v;
+  if(*m0 < *m1)
+    return -1;
+  else if(*m0 == * m1)
+    return 0;
+
+  return 1;
+}
+
+static inline
+bool eq_uint16(void const* m0, void const* m1)
+{
+  return *(uint16_t*)m0 == *(uint16_t*)m1;
+}
+
+static
+void free_shared_sub(shared_sub_t* s)
+{
+  assert(s != NULL);
+
+  free_global_e2_node_id(&s->e2_node_id);
+  e2ap_free_subscription_request(&s->sr);
+  seq_free(&s->xapps, NULL);
+  if(s->admitted)
+    e2ap_free_subscription_response(&s->resp);
+  free(s);
+}
+
+static
+void free_shared_sub_wrapper(void* key, void* value)
+{
+  assert(key != NULL);
+  assert(value != NULL);
+
+  (void)key;
+
+  free_shared_sub((shared_sub_t*)value);
+}
+
+void init_map_shared_sub(map_shared_sub_t* m)
+{
+  assert(m != NULL);
+
+  pthread_mutexattr_t *mtx_attr = NULL;
+#ifdef DEBUG
+  *mtx_attr = PTHREAD_MUTEX_ERRORCHECK; 
+#endif
+
+  int rc = pthread_mutex_init(&m->mtx, mtx_attr);
+  assert(rc == 0);
+
+  assoc_init(&m->tree, sizeof(uint16_t), cmp_uint16, free_shared_sub_wrapper);
+}
+
+void free_map_shared_sub(map_shared_sub_t* m)
+{
+  assert(m != NULL);
+
+  int rc = pthread_mutex_destroy(&m->mtx);
+  assert(rc == 0);
+
+  assoc_free(&m->tree);
+}
+
+shared_sub_t* add_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id, global_e2_node_id_t const* id, ric_subscription_request_t const* sr, xapp_ric_id_t const* x)
+{
+  assert(m != NULL);
+  assert(id != NULL);
+  assert(sr != NULL);
+  assert(x != NULL);
+  assert(find_map_shared_sub(m, ric_req_id) == NULL && "ric_req_id already in the map");
+
+  shared_sub_t* s = calloc(1, sizeof(shared_sub_t));
+  assert(s != NULL && "Memory exhausted");
+
+  s->ric_req_id = ric_req_id;
+  s->e2_node_id = cp_global_e2_node_id(id);
+  s->sr = cp_ric_subscription_request(sr);
+  seq_init(&s->xapps, sizeof(xapp_ric_id_t));
+  join_shared_sub(s, x);
+  // The first indication of the E2 Node is a keyframe
+  sync_shared_sub(s);
+
+  assoc_insert(&m->tree, &ric_req_id, sizeof(ric_req_id), s);
+  return s;
+}
+
+void rm_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id)
+{
+  assert(m != NULL);
+
+  shared_sub_t* s = assoc_extract(&m->tree, &ric_req_id);
+  assert(s != NULL && "Not found RIC Request ID");
+  free_shared_sub(s);
+}
+
+shared_sub_t* find_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id)
+{
+  assert(m != NULL);
+
+  void* it = assoc_front(&m->tree);
+  void* end = assoc_end(&m->tree);
+  it = find_if(&m->tree, it, end, &ric_req_id, eq_uint16);
+  if(it == end)
+    return NULL;
+
+  return assoc_value(&m->tree, it);
+}
+
+static
+bool compat_sub_req(ric_subscription_request_t const* m0, ric_subscription_request_t const* m1)
+{
+  if(m0->ric_id.ran_func_id != m1->ric_id.ran_func_id)
+    return false;
+
+  if(eq_byte_array(&m0->event_trigger, &m1->event_trigger) == false)
+    return false;
+
+  if(m0->len_action != m1->len_action)
+    return false;
+
+  for(size_t i = 0; i < m0->len_action; ++i){
+    if(eq_ric_action(&m0->action[i], &m1->action[i]) == false)
+      return false;
+  }
+
+  return true;
+}
+
+shared_sub_t* find_compat_map_shared_sub(map_shared_sub_t* m, global_e2_node_id_t const* id, ric_subscription_request_t const* sr)
+{
+  assert(m != NULL);
+  assert(id != NULL);
+  assert(sr != NULL);
+
+  void* it = assoc_front(&m->tree);
+  void* end = assoc_end(&m->tree);
+  while(it != end){
+    shared_sub_t* s = assoc_value(&m->tree, it);
+    // Being deleted at the E2 Node. A new E2 subscription is needed
+    if(s->deleting == false
+        && eq_global_e2_node_id(&s->e2_node_id, id) == true 
+        && compat_sub_req(&s->sr, sr) == true)
+      return s;
+    it = assoc_next(&m->tree, it);
+  }
+
+  return NULL;
+}
+
+shared_sub_t* find_xapp_map_shared_sub(map_shared_sub_t* m, xapp_ric_id_t const* x)
+{
+  assert(m != NULL);
+  assert(x != NULL);
+
+  void* it = assoc_front(&m->tree);
+  void* end = assoc_end(&m->tree);
+  while(it != end){
+    shared_sub_t* s = assoc_value(&m->tree, it);
+    void* x_it = find_if(&s->xapps, seq_front(&s->xapps), seq_end(&s->xapps), (void*)x, eq_xapp_ric_gen_id_wrapper);
+    if(x_it != seq_end(&s->xapps))
+      return s;
+    it = assoc_next(&m->tree, it);
+  }
+
+  return NULL;
+}
+
+void join_shared_sub(shared_sub_t* s, xapp_ric_id_t const* x)
+{
+  assert(s != NULL);
+  assert(x != NULL);
+  assert(s->deleting == false);
+
+  seq_push_back(&s->xapps, (void*)x, sizeof(xapp_ric_id_t));
+}
+
+size_t leave_shared_sub(shared_sub_t* s, xapp_ric_id_t const* x)
+{
+  assert(s != NULL);
+  assert(x != NULL);
+
+  void* end = seq_end(&s->xapps);
+  void* it = find_if(&s->xapps, seq_front(&s->xapps), end, (void*)x, eq_xapp_ric_gen_id_wrapper);
+  assert(it != end && "Not found xApp RIC ID");
+  if(seq_distance(&s->xapps, seq_front(&s->xapps), it) < (ptrdiff_t)s->len_synced)
+    s->len_synced -= 1;
+  seq_erase(&s->xapps, it, seq_next(&s->xapps, it));
+
+  return seq_size(&s->xapps);
+}
+
+void sync_shared_sub(shared_sub_t* s)
+{
+  assert(s != NULL);
+  s->len_synced = seq_size(&s->xapps);
+}
+
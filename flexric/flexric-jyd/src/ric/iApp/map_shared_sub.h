@@ -0,0 +1,100 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#ifndef MAP_SHARED_SUB_H
+#define MAP_SHARED_SUB_H 
+
+/*
+ * E2 subscriptions shared by several xApps. The xApps that subscribe to the
+ * same E2 Node with a compatible request (i.e., same RAN function, event
+ * trigger and actions) join the same E2 subscription, and every indication
+ * received is forwarded to all of them. The E2 subscription is deleted when
+ * the last xApp leaves. An xApp that joins a delta coded E2 subscription
+ * receives its indications from the next keyframe on, as it cannot decode the
+ * frames before.
+ * The functions do not lock. The caller must hold mtx.
+ */
+
+#include "../../lib/ap/e2ap_types/common/e2ap_global_node_id.h"
+#include "../../lib/ap/e2ap_types/ric_subscription_request.h"
+#include "../../lib/ap/e2ap_types/ric_subscription_response.h"
+#include "../../util/alg_ds/ds/assoc_container/assoc_generic.h"
+#include "../../util/alg_ds/ds/seq_container/seq_generic.h"
+
+#include "xapp_ric_id.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct{
+  // RIC request ID of the E2 subscription 
+  uint16_t ric_req_id;
+  global_e2_node_id_t e2_node_id;
+  // As sent to the E2 Node 
+  ric_subscription_request_t sr;
+
+  seq_arr_t xapps; // xapp_ric_id_t
+  // The first len_synced xApps receive the indications. The rest joined
+  // later and wait for a keyframe
+  size_t len_synced;
+
+  // RIC Subscription Response received. Copied to the xApps that join later
+  bool admitted;
+  ric_subscription_response_t resp;
+
+  // The last xApp left and the RIC Subscription Delete Request was sent
+  bool deleting;
+  xapp_ric_id_t del_xapp;
+} shared_sub_t;
+
+typedef struct{
+  assoc_rb_tree_t tree; // key: uint16_t ric_req_id | value: shared_sub_t* 
+  pthread_mutex_t mtx;
+} map_shared_sub_t;
+
+void init_map_shared_sub(map_shared_sub_t* m);
+
+void free_map_shared_sub(map_shared_sub_t* m);
+
+// New E2 subscription with ric_req_id, joined by x
+shared_sub_t* add_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id, global_e2_node_id_t const* id, ric_subscription_request_t const* sr, xapp_ric_id_t const* x);
+
+void rm_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id);
+
+// NULL if not found
+shared_sub_t* find_map_shared_sub(map_shared_sub_t* m, uint16_t ric_req_id);
+
+// E2 subscription that an xApp subscribing with sr to the E2 Node id can join. NULL if none
+shared_sub_t* find_compat_map_shared_sub(map_shared_sub_t* m, global_e2_node_id_t const* id, ric_subscription_request_t const* sr);
+
+// E2 subscription joined by x. NULL if none
+shared_sub_t* find_xapp_map_shared_sub(map_shared_sub_t* m, xapp_ric_id_t const* x);
+
+void join_shared_sub(shared_sub_t* s, xapp_ric_id_t const* x);
+
+// Returns the number of xApps left
+size_t leave_shared_sub(shared_sub_t* s, xapp_ric_id_t const* x);
+
+// The xApps waiting for a keyframe receive the indications from now on
+void sync_shared_sub(shared_sub_t* s);
+
+#endif
+
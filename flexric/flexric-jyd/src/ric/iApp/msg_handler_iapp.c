@@ -27,6 +27,7 @@ a* You may obtain a copy of the License at
 #include "lib/pending_events.h"
 #include "util/alg_ds/alg/alg.h"
 #include "util/compare.h"
+#include "util/delta_codec.h"
 #include "util/alg_ds/ds/lock_guard/lock_guard.h"
 #include "util/time_now_us.h"
 
@@ -81,60 +82,97 @@ void init_handle_msg_iapp(handle_msg_fp_iapp (*handle_msg)[31])
 
 }
 
-e2ap_msg_t e2ap_handle_subscription_response_iapp(e42_iapp_t* iapp, const e2ap_msg_t* msg)
+static
+void send_subscription_response_iapp(e42_iapp_t* iapp, ric_subscription_response_t const* src, xapp_ric_id_t const* x)
 {
   assert(iapp != NULL);
-  assert(msg != NULL);
-  assert(msg->type == RIC_SUBSCRIPTION_RESPONSE);
-
-  ric_subscription_response_t const* src = &msg->u_msgs.ric_sub_resp; 
-
-  xapp_ric_id_t x = find_xapp_map_ric_id(&iapp->map_ric_id, src->ric_id.ric_req_id);
-  assert(src->ric_id.ran_func_id == x.ric_id.ran_func_id);
-  assert(src->ric_id.ric_inst_id == x.ric_id.ric_inst_id);
+  assert(src != NULL);
+  assert(x != NULL);
+  assert(src->ric_id.ran_func_id == x->ric_id.ran_func_id);
 
   e2ap_msg_t ans = {.type = RIC_SUBSCRIPTION_RESPONSE};
   defer({ e2ap_msg_free_iapp(&iapp->ap, &ans);} );
   ric_subscription_response_t* dst = &ans.u_msgs.ric_sub_resp;
-  *dst = mv_ric_subscription_respponse(src);
-  dst->ric_id.ric_req_id = x.ric_id.ric_req_id;
+  *dst = cp_ric_subscription_respponse(src);
+  dst->ric_id = x->ric_id;
 
   sctp_msg_t sctp_msg = {0}; 
   defer({ free_sctp_msg(&sctp_msg); } );
-  sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x.xapp_id);
+  sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x->xapp_id);
   sctp_msg.ba = e2ap_msg_enc_iapp(&iapp->ap, &ans); 
        
   e2ap_send_sctp_msg_iapp(&iapp->ep, &sctp_msg);
-
-  e2ap_msg_t none = {.type = NONE_E2_MSG_TYPE};
-  return none;
 }
 
-e2ap_msg_t e2ap_handle_subscription_delete_response_iapp(e42_iapp_t* iapp, const e2ap_msg_t* msg)
+e2ap_msg_t e2ap_handle_subscription_response_iapp(e42_iapp_t* iapp, const e2ap_msg_t* msg)
 {
   assert(iapp != NULL);
   assert(msg != NULL);
-  assert(msg->type == RIC_SUBSCRIPTION_DELETE_RESPONSE );
+  assert(msg->type == RIC_SUBSCRIPTION_RESPONSE);
 
-  ric_subscription_delete_response_t const* src = &msg->u_msgs.ric_sub_del_resp; 
+  ric_subscription_response_t const* src = &msg->u_msgs.ric_sub_resp; 
 
-  xapp_ric_id_t x = find_xapp_map_ric_id(&iapp->map_ric_id, src->ric_id.ric_req_id);
-  assert(src->ric_id.ran_func_id == x.ric_id.ran_func_id);
-  assert(src->ric_id.ric_inst_id == x.ric_id.ric_inst_id);
+  lock_guard(&iapp->map_sub.mtx);
+
+  shared_sub_t* s = find_map_shared_sub(&iapp->map_sub, src->ric_id.ric_req_id);
+  assert(s != NULL && "Not found RIC Request ID");
+  assert(s->admitted == false);
+
+  // Kept for the xApps that join later
+  s->resp = cp_ric_subscription_respponse(src);
+  s->admitted = true;
+
+  void* it = seq_front(&s->xapps);
+  void* end = seq_end(&s->xapps);
+  while(it != end){
+    send_subscription_response_iapp(iapp, &s->resp, it);
+    it = seq_next(&s->xapps, it);
+  }
+
+  e2ap_msg_t none = {.type = NONE_E2_MSG_TYPE};
+  return none;
+}
+
+static
+void send_subscription_delete_response_iapp(e42_iapp_t* iapp, xapp_ric_id_t const* x)
+{
+  assert(iapp != NULL);
+  assert(x != NULL);
 
   e2ap_msg_t ans = {.type = RIC_SUBSCRIPTION_DELETE_RESPONSE };
   defer( { e2ap_msg_free_iapp(&iapp->ap, &ans); } );
   ric_subscription_delete_response_t* dst = &ans.u_msgs.ric_sub_del_resp;
-  dst->ric_id = x.ric_id;
+  dst->ric_id = x->ric_id;
 
   sctp_msg_t sctp_msg = {0};
   defer({ free_sctp_msg(&sctp_msg); } );
-  sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x.xapp_id);
+  sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x->xapp_id);
   sctp_msg.ba = e2ap_msg_enc_iapp(&iapp->ap, &ans); 
        
   e2ap_send_sctp_msg_iapp(&iapp->ep, &sctp_msg);
 
   printf("[iApp]: RIC_SUBSCRIPTION_DELETE_RESPONSE sent \n");
+}
+
+e2ap_msg_t e2ap_handle_subscription_delete_response_iapp(e42_iapp_t* iapp, const e2ap_msg_t* msg)
+{
+  assert(iapp != NULL);
+  assert(msg != NULL);
+  assert(msg->type == RIC_SUBSCRIPTION_DELETE_RESPONSE );
+
+  ric_subscription_delete_response_t const* src = &msg->u_msgs.ric_sub_del_resp; 
+
+  lock_guard(&iapp->map_sub.mtx);
+
+  shared_sub_t* s = find_map_shared_sub(&iapp->map_sub, src->ric_id.ric_req_id);
+  assert(s != NULL && "Not found RIC Request ID");
+  assert(s->deleting == true);
+  assert(src->ric_id.ran_func_id == s->del_xapp.ric_id.ran_func_id);
+
+  xapp_ric_id_t const x = s->del_xapp;
+  rm_map_shared_sub(&iapp->map_sub, src->ric_id.ric_req_id);
+
+  send_subscription_delete_response_iapp(iapp, &x);
 
   e2ap_msg_t none = {.type = NONE_E2_MSG_TYPE};
   return none;
@@ -212,6 +250,35 @@ e2ap_msg_t e2ap_handle_e42_setup_request_iapp(e42_iapp_t* iapp, const e2ap_msg_t
   return ans;
 }
 
+// Members of the E2 subscription that receive ind. Copied, so that encoding
+// and sending the indication does not hold map_sub.mtx
+static
+xapp_ric_id_t* cp_xapps_shared_sub(e42_iapp_t* iapp, ric_indication_t const* ind, size_t* len)
+{
+  assert(iapp != NULL);
+  assert(ind != NULL);
+  assert(len != NULL);
+
+  lock_guard(&iapp->map_sub.mtx);
+
+  shared_sub_t* s = find_map_shared_sub(&iapp->map_sub, ind->ric_id.ric_req_id);
+  assert(s != NULL && "Not found RIC Request ID");
+
+  // The xApps that joined a delta coded E2 subscription cannot decode the
+  // frames before the next keyframe
+  if(is_delta_frame(ind->msg.len, ind->msg.buf) == false || is_delta_keyframe(ind->msg.len, ind->msg.buf) == true)
+    sync_shared_sub(s);
+
+  *len = s->len_synced;
+  xapp_ric_id_t* xapps = calloc(*len, sizeof(xapp_ric_id_t));
+  assert((xapps != NULL || *len == 0) && "Memory exhausted");
+
+  for(size_t i = 0; i < *len; ++i)
+    xapps[i] = *(xapp_ric_id_t const*)seq_at(&s->xapps, i);
+
+  return xapps;
+}
+
 e2ap_msg_t e2ap_handle_ric_indication_iapp(e42_iapp_t* iapp, const e2ap_msg_t* msg)
 {
   assert(iapp != NULL);
@@ -220,23 +287,29 @@ e2ap_msg_t e2ap_handle_ric_indication_iapp(e42_iapp_t* iapp, const e2ap_msg_t* m
 
   ric_indication_t const* src = &msg->u_msgs.ric_ind;
 
-  xapp_ric_id_t x = find_xapp_map_ric_id(&iapp->map_ric_id, src->ric_id.ric_req_id);
-  assert(src->ric_id.ran_func_id == x.ric_id.ran_func_id);
-  assert(src->ric_id.ric_inst_id == x.ric_id.ric_inst_id);
+  size_t len = 0;
+  xapp_ric_id_t* xapps = cp_xapps_shared_sub(iapp, src, &len);
+  defer({ free(xapps); });
 
+  // The same indication is sent to every xApp of the E2 subscription.
+  // It borrows the buffers of src, which keeps their ownership
   e2ap_msg_t ans = {.type = RIC_INDICATION};
-  defer( { e2ap_msg_free_iapp(&iapp->ap, &ans); } );
   ric_indication_t* dst = &ans.u_msgs.ric_ind;
-  // Moving transfers ownership
-  *dst = mv_ric_indication((ric_indication_t*)src);
-  dst->ric_id.ric_req_id = x.ric_id.ric_req_id;
+  *dst = *src;
+  dst->borrowed = true;
 
-  sctp_msg_t sctp_msg = {0}; 
-  defer({ free_sctp_msg(&sctp_msg); } );
-  sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x.xapp_id);
-  sctp_msg.ba = e2ap_msg_enc_iapp(&iapp->ap, &ans); 
+  for(size_t i = 0; i < len; ++i){
+    xapp_ric_id_t const* x = &xapps[i];
+    assert(src->ric_id.ran_func_id == x->ric_id.ran_func_id);
+    dst->ric_id = x->ric_id;
 
-  e2ap_send_sctp_msg_iapp(&iapp->ep, &sctp_msg);
+    sctp_msg_t sctp_msg = {0}; 
+    sctp_msg.info = find_map_xapps_sad(&iapp->ep.xapps, x->xapp_id);
+    sctp_msg.ba = e2ap_msg_enc_iapp(&iapp->ap, &ans); 
+
+    e2ap_send_sctp_msg_iapp(&iapp->ep, &sctp_msg);
+    free_sctp_msg(&sctp_msg);
+  }
 
   e2ap_msg_t none = {.type = NONE_E2_MSG_TYPE};
   return none;
@@ -279,12 +352,25 @@ e2ap_msg_t e2ap_handle_e42_ric_subscription_delete_request_iapp(e42_iapp_t* iapp
                       .xapp_id = src->xapp_id 
                     };
 
-  e2_node_ric_req_t n = find_ric_req_map_ric_id(&iapp->map_ric_id, &x);
+  lock_guard(&iapp->map_sub.mtx);
+
+  shared_sub_t* s = find_xapp_map_shared_sub(&iapp->map_sub, &x);
+  assert(s != NULL && "Not found xApp RIC ID ");
+
+  // Other xApps still use the E2 subscription
+  if(leave_shared_sub(s, &x) > 0){
+    send_subscription_delete_response_iapp(iapp, &x);
+    e2ap_msg_t ans = {.type = NONE_E2_MSG_TYPE};
+    return ans;
+  }
+
+  s->deleting = true;
+  s->del_xapp = x;
 
   ric_subscription_delete_request_t dst = cp_ric_subscription_delete_request(&src->sdr);
-  dst.ric_id.ric_req_id = n.ric_req_id;
+  dst.ric_id.ric_req_id = s->ric_req_id;
 
-  fwd_ric_subscription_request_delete_gen(iapp->ric_if.type, &n.e2_node_id, &dst, notify_msg_iapp_api);
+  fwd_ric_subscription_request_delete_gen(iapp->ric_if.type, &s->e2_node_id, &dst, notify_msg_iapp_api);
 
   printf("[iApp]: RIC_SUBSCRIPTION_DELETE_REQUEST sent \n");
 
@@ -309,16 +395,24 @@ e2ap_msg_t e2ap_handle_e42_ric_subscription_request_iapp(e42_iapp_t* iapp, const
 
   printf("[iApp]: SUBSCRIPTION-REQUEST xapp_ric_id->ric_id.ran_func_id %d  \n", xapp_ric_id.ric_id.ran_func_id );
 
-  // I do not like the mtx here but there is a data race if not
-  lock_guard(&iapp->map_ric_id.mtx); 
+  // Held while forwarding, as the response may arrive before the E2 subscription is added
+  lock_guard(&iapp->map_sub.mtx); 
 
-  uint16_t const new_ric_id = fwd_ric_subscription_request_gen(iapp->ric_if.type, &e42_sr->id, &e42_sr->sr, notify_msg_iapp_api);
+  // Another xApp already receives the same report from the E2 Node
+  shared_sub_t* s = find_compat_map_shared_sub(&iapp->map_sub, &e42_sr->id, &e42_sr->sr);
+  if(s != NULL){
+    join_shared_sub(s, &xapp_ric_id);
+    printf("[iApp]: SUBSCRIPTION-REQUEST shares RIC request ID %d among %ld xApps\n", s->ric_req_id, seq_size(&s->xapps));
+    if(s->admitted)
+      send_subscription_response_iapp(iapp, &s->resp, &xapp_ric_id);
 
-  e2_node_ric_req_t n = { .ric_req_id =  new_ric_id,
-                          .e2_node_id = cp_global_e2_node_id(&e42_sr->id) }; 
+    e2ap_msg_t ans = {.type = NONE_E2_MSG_TYPE};
+    return ans; 
+  }
 
+  uint16_t const new_ric_id = fwd_ric_subscription_request_gen(iapp->ric_if.type, &e42_sr->id, &e42_sr->sr, notify_msg_iapp_api);
 
-  add_map_ric_id(&iapp->map_ric_id, &n, &xapp_ric_id);
+  add_map_shared_sub(&iapp->map_sub, new_ric_id, &e42_sr->id, &e42_sr->sr, &xapp_ric_id);
 
   e2ap_msg_t ans = {.type = NONE_E2_MSG_TYPE};
   return ans; 
@@ -19,22 +19,46 @@
  *      contact@openairinterface.org
  */
 
-
+#define _GNU_SOURCE // sendmmsg
 
 #include "influx.h"
 
 #include <assert.h>                                      // for assert
 #include <netinet/in.h>                                  // for sockaddr_in
 #include <pthread.h>                                     // for pthread_once
+#include <stdatomic.h>
 #include <stdint.h>                                      // for uint32_t
 #include <stdlib.h>                                      // for exit, EXIT_F...
 #include <string.h>                                      // for strlen, memset
 #include <stdio.h>
-#include <sys/socket.h>                                  // for sendto, MSG_...
+#include <sys/socket.h>                                  // for sendmmsg, sendto
 #include "ric/iApps/../../sm/mac_sm/ie/mac_data_ie.h"    // for mac_ind_msg_t
 #include "ric/iApps/../../sm/pdcp_sm/ie/pdcp_data_ie.h"  // for pdcp_ind_msg_t
 #include "ric/iApps/../../sm/rlc_sm/ie/rlc_data_ie.h"    // for rlc_ind_msg_t
-#include "string_parser.h"                               // for to_string_ma...
+#include "../../util/time_now_us.h"
+#include "num_fmt.h"
+#include "string_parser.h"                               // for to_string_sl...
+
+// Ethernet MTU minus the IPv4 and UDP headers
+#define INFLUX_DGRAM_SZ 1472
+
+// A single line longer than INFLUX_DGRAM_SZ is sent alone, straight from the
+// line buffer, up to this size
+#define INFLUX_LINE_MAX 4096
+
+// Datagrams sent with one sendmmsg
+#define INFLUX_MAX_DGRAMS 32
+
+// Lines are held at most this long when indications arrive faster
+#define INFLUX_FLUSH_US 1000
+
+typedef struct{
+  char buf[INFLUX_MAX_DGRAMS][INFLUX_DGRAM_SZ];
+  size_t len[INFLUX_MAX_DGRAMS];
+  size_t num;
+  int64_t first_us;
+  int64_t last_us;
+} influx_batch_t;
 
 static
 pthread_once_t init_socket = PTHREAD_ONCE_INIT;
@@ -48,10 +72,72 @@ struct sockaddr_in servaddr;
 static
 int const PORT = 8094;
 
+// Every thread delivering indications batches on its own
+static
+pthread_key_t batch_key;
+
+static
+atomic_size_t sent_dgrams;
+
+static
+atomic_size_t dropped_dgrams;
+
+static
+atomic_size_t dropped_lines;
+
+static
+void flush_batch(influx_batch_t* b)
+{
+  if(b->num == 0)
+    return;
+
+  struct mmsghdr msgs[INFLUX_MAX_DGRAMS];
+  struct iovec iov[INFLUX_MAX_DGRAMS];
+  memset(msgs, 0, sizeof(msgs));
+
+  for(size_t i = 0; i < b->num; ++i){
+    iov[i].iov_base = b->buf[i];
+    iov[i].iov_len = b->len[i];
+    msgs[i].msg_hdr.msg_name = &servaddr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(servaddr);
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  // Non-blocking socket. What is not sent now is counted and discarded
+  int const rc = sendmmsg(sockfd, msgs, b->num, 0);
+  size_t const sent = rc > 0 ? (size_t)rc : 0;
+  sent_dgrams += sent;
+  dropped_dgrams += b->num - sent;
+
+  b->num = 0;
+}
+
+// Keeps the order with the lines already batched
+static
+void send_long_line(influx_batch_t* b, char const* line, size_t len)
+{
+  flush_batch(b);
+
+  ssize_t const rc = sendto(sockfd, line, len, 0, (struct sockaddr const*)&servaddr, sizeof(servaddr));
+  if(rc == (ssize_t)len)
+    ++sent_dgrams;
+  else
+    ++dropped_dgrams;
+}
+
+static
+void free_batch(void* arg)
+{
+  influx_batch_t* b = (influx_batch_t*)arg;
+  flush_batch(b);
+  free(b);
+}
 
+static
 void init_udp_socket()
 {
-  if ( (sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0 ) {
+  if ( (sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0)) < 0 ) {
     assert(0!=0 && "Error creating the socket");
     exit(EXIT_FAILURE);
   }
@@ -62,179 +148,394 @@ void init_udp_socket()
   servaddr.sin_port = htons(PORT);
   servaddr.sin_addr.s_addr = INADDR_ANY;
 
+  int const rc = pthread_key_create(&batch_key, free_batch);
+  assert(rc == 0);
+}
+
+static
+influx_batch_t* thread_batch(void)
+{
+  influx_batch_t* b = pthread_getspecific(batch_key);
+  if(b == NULL){
+    b = calloc(1, sizeof(influx_batch_t));
+    assert(b != NULL && "Memory exhausted");
+    int const rc = pthread_setspecific(batch_key, b);
+    assert(rc == 0);
+  }
+  return b;
+}
+
+static
+void append_line(influx_batch_t* b, char const* line, size_t len)
+{
+  if(len == 0)
+    return;
+
+  if(len > INFLUX_LINE_MAX){
+    ++dropped_lines;
+    return;
+  }
+
+  if(len > INFLUX_DGRAM_SZ){
+    send_long_line(b, line, len);
+    return;
+  }
+
+  // Lines never span datagrams. A datagram is closed before it exceeds the MTU
+  if(b->num == 0 || b->len[b->num - 1] + len > INFLUX_DGRAM_SZ){
+    if(b->num == INFLUX_MAX_DGRAMS)
+      flush_batch(b);
+    if(b->num == 0)
+      b->first_us = time_now_us();
+    b->len[b->num] = 0;
+    b->num += 1;
+  }
+
+  size_t* dgram_len = &b->len[b->num - 1];
+  memcpy(b->buf[b->num - 1] + *dgram_len, line, len);
+  *dgram_len += len;
+}
+
+#define PUT_U(l, name, v) do { PUT_LIT(l, name "="); put_u64(l, v); } while(0)
+#define PUT_I(l, name, v) do { PUT_LIT(l, name "="); put_i64(l, v); } while(0)
+#define PUT_F(l, name, v) do { PUT_LIT(l, name "="); put_f64(l, v); } while(0)
+
+static
+size_t fmt_mac_ue(mac_ue_stats_impl_t const* s, int64_t tstamp, char* out, size_t out_len)
+{
+  line_t l = {.it = out, .end = out + out_len};
+
+  PUT_I(&l, "mac_stats: tstamp", tstamp);
+  PUT_U(&l, ",frame", s->frame);
+  PUT_U(&l, ",slot", s->slot);
+  PUT_U(&l, ",dl_aggr_tbs", s->dl_aggr_tbs);
+  PUT_U(&l, ",ul_aggr_tbs", s->ul_aggr_tbs);
+  PUT_U(&l, ",dl_aggr_bytes_sdus", s->dl_aggr_bytes_sdus);
+  PUT_U(&l, ",ul_aggr_bytes_sdus", s->ul_aggr_bytes_sdus);
+  PUT_U(&l, ",dl_curr_tbs", s->dl_curr_tbs);
+  PUT_U(&l, ",ul_curr_tbs", s->ul_curr_tbs);
+  PUT_U(&l, ",dl_sched_rb", s->dl_sched_rb);
+  PUT_U(&l, ",ul_sched_rb", s->ul_sched_rb);
+  PUT_F(&l, ",pusch_snr", s->pusch_snr);
+  PUT_F(&l, ",pucch_snr", s->pucch_snr);
+  PUT_U(&l, ",rnti", s->rnti);
+  PUT_U(&l, ",dl_aggr_prb", s->dl_aggr_prb);
+  PUT_U(&l, ",ul_aggr_prb", s->ul_aggr_prb);
+  PUT_U(&l, ",dl_aggr_sdus", s->dl_aggr_sdus);
+  PUT_U(&l, ",ul_aggr_sdus", s->ul_aggr_sdus);
+  PUT_U(&l, ",dl_aggr_retx_prb", s->dl_aggr_retx_prb);
+  PUT_U(&l, ",ul_aggr_retx_prb", s->ul_aggr_retx_prb);
+  PUT_U(&l, ",wb_cqi", s->wb_cqi);
+  PUT_U(&l, ",dl_mcs1", s->dl_mcs1);
+  PUT_U(&l, ",ul_mcs1", s->ul_mcs1);
+  PUT_U(&l, ",dl_mcs2", s->dl_mcs2);
+  PUT_U(&l, ",ul_mcs2", s->ul_mcs2);
+  PUT_I(&l, ",phr", s->phr);
+  PUT_U(&l, ",bsr", s->bsr);
+  PUT_F(&l, ",dl_bler", s->dl_bler);
+  PUT_F(&l, ",ul_bler", s->ul_bler);
+  PUT_U(&l, ",dl_num_harq", s->dl_num_harq);
+  PUT_U(&l, ",dl_harq[0]", s->dl_harq[0]);
+  PUT_U(&l, ",dl_harq[1]", s->dl_harq[1]);
+  PUT_U(&l, ",dl_harq[2]", s->dl_harq[2]);
+  PUT_U(&l, ",dl_harq[3]", s->dl_harq[3]);
+  PUT_U(&l, ",dlsch_errors", s->dl_harq[4]);
+  PUT_U(&l, ",ul_num_harq", s->ul_num_harq);
+  PUT_U(&l, ",ul_harq[0]", s->ul_harq[0]);
+  PUT_U(&l, ",ul_harq[1]", s->ul_harq[1]);
+  PUT_U(&l, ",ul_harq[2]", s->ul_harq[2]);
+  PUT_U(&l, ",ul_harq[3]", s->ul_harq[3]);
+  PUT_U(&l, ",ulsch_errors", s->ul_harq[4]);
+  PUT_LIT(&l, "\n");
+
+  // Truncated lines are not sent
+  return l.it == l.end ? 0 : (size_t)(l.it - out);
+}
+
+static
+size_t fmt_rlc_rb(rlc_radio_bearer_stats_t const* rlc, int64_t tstamp, char* out, size_t out_len)
+{
+  line_t l = {.it = out, .end = out + out_len};
+
+  PUT_I(&l, "rlc_stats: tstamp", tstamp);
+  PUT_U(&l, ",txpdu_pkts", rlc->txpdu_pkts);
+  PUT_U(&l, ",txpdu_bytes", rlc->txpdu_bytes);
+  PUT_U(&l, ",txpdu_wt_ms", rlc->txpdu_wt_ms);
+  PUT_U(&l, ",txpdu_dd_pkts", rlc->txpdu_dd_pkts);
+  PUT_U(&l, ",txpdu_dd_bytes", rlc->txpdu_dd_bytes);
+  PUT_U(&l, ",txpdu_retx_pkts", rlc->txpdu_retx_pkts);
+  PUT_U(&l, ",txpdu_retx_bytes", rlc->txpdu_retx_bytes);
+  PUT_U(&l, ",txpdu_segmented", rlc->txpdu_segmented);
+  PUT_U(&l, ",txpdu_status_pkts", rlc->txpdu_status_pkts);
+  PUT_U(&l, ",txpdu_status_bytes", rlc->txpdu_status_bytes);
+  PUT_U(&l, ",txbuf_occ_bytes", rlc->txbuf_occ_bytes);
+  PUT_U(&l, ",txbuf_occ_pkts", rlc->txbuf_occ_pkts);
+  PUT_U(&l, ",rxpdu_pkts", rlc->rxpdu_pkts);
+  PUT_U(&l, ",rxpdu_bytes", rlc->rxpdu_bytes);
+  PUT_U(&l, ",rxpdu_dup_pkts", rlc->rxpdu_dup_pkts);
+  PUT_U(&l, ",rxpdu_dup_bytes", rlc->rxpdu_dup_bytes);
+  PUT_U(&l, ",rxpdu_dd_pkts", rlc->rxpdu_dd_pkts);
+  PUT_U(&l, ",rxpdu_dd_bytes", rlc->rxpdu_dd_bytes);
+  PUT_U(&l, ",rxpdu_ow_pkts", rlc->rxpdu_ow_pkts);
+  PUT_U(&l, ",rxpdu_ow_bytes", rlc->rxpdu_ow_bytes);
+  PUT_U(&l, ",rxpdu_status_pkts", rlc->rxpdu_status_pkts);
+  PUT_U(&l, ",rxpdu_status_bytes", rlc->rxpdu_status_bytes);
+  PUT_U(&l, ",rxbuf_occ_bytes", rlc->rxbuf_occ_bytes);
+  PUT_U(&l, ",rxbuf_occ_pkts", rlc->rxbuf_occ_pkts);
+  PUT_U(&l, ",txsdu_pkts", rlc->txsdu_pkts);
+  PUT_U(&l, ",txsdu_bytes", rlc->txsdu_bytes);
+  PUT_U(&l, ",rxsdu_pkts", rlc->rxsdu_pkts);
+  PUT_U(&l, ",rxsdu_bytes", rlc->rxsdu_bytes);
+  PUT_U(&l, ",rxsdu_dd_pkts", rlc->rxsdu_dd_pkts);
+  PUT_U(&l, ",rxsdu_dd_bytes", rlc->rxsdu_dd_bytes);
+  PUT_U(&l, ",rnti", rlc->rnti);
+  PUT_U(&l, ",mode", rlc->mode);
+  PUT_U(&l, ",rbid", rlc->rbid);
+  PUT_LIT(&l, "\n");
+
+  return l.it == l.end ? 0 : (size_t)(l.it - out);
+}
+
+static
+size_t fmt_pdcp_rb(pdcp_radio_bearer_stats_t const* pdcp, int64_t tstamp, char* out, size_t out_len)
+{
+  line_t l = {.it = out, .end = out + out_len};
+
+  PUT_I(&l, "pdcp_stats: tstamp", tstamp);
+  PUT_U(&l, ",txpdu_pkts", pdcp->txpdu_pkts);
+  PUT_U(&l, ",txpdu_bytes", pdcp->txpdu_bytes);
+  PUT_U(&l, ",txpdu_sn", pdcp->txpdu_sn);
+  PUT_U(&l, ",rxpdu_pkts", pdcp->rxpdu_pkts);
+  PUT_U(&l, ",rxpdu_bytes", pdcp->rxpdu_bytes);
+  PUT_U(&l, ",rxpdu_sn", pdcp->rxpdu_sn);
+  PUT_U(&l, ",rxpdu_oo_pkts", pdcp->rxpdu_oo_pkts);
+  PUT_U(&l, ",rxpdu_oo_bytes", pdcp->rxpdu_oo_bytes);
+  PUT_U(&l, ",rxpdu_dd_pkts", pdcp->rxpdu_dd_pkts);
+  PUT_U(&l, ",rxpdu_dd_bytes", pdcp->rxpdu_dd_bytes);
+  PUT_U(&l, ",rxpdu_ro_count", pdcp->rxpdu_ro_count);
+  PUT_U(&l, ",txsdu_pkts", pdcp->txsdu_pkts);
+  PUT_U(&l, ",txsdu_bytes", pdcp->txsdu_bytes);
+  PUT_U(&l, ",rxsdu_pkts", pdcp->rxsdu_pkts);
+  PUT_U(&l, ",rxsdu_bytes", pdcp->rxsdu_bytes);
+  PUT_U(&l, ",rnti", pdcp->rnti);
+  PUT_U(&l, ",mode", pdcp->mode);
+  PUT_U(&l, ",rbid", pdcp->rbid);
+  PUT_LIT(&l, "\n");
+
+  return l.it == l.end ? 0 : (size_t)(l.it - out);
+}
+
+static
+size_t fmt_gtp_ngu(gtp_ngu_t_stats_t const* gtp, int64_t tstamp, char* out, size_t out_len)
+{
+  line_t l = {.it = out, .end = out + out_len};
+
+  PUT_I(&l, "gtp_stats: tstamp", tstamp);
+  PUT_U(&l, ",rnti", gtp->rnti);
+  PUT_U(&l, ",qfi", gtp->qfi);
+  PUT_U(&l, ",teidgnb", gtp->teidgnb);
+  PUT_U(&l, ",teidupf", gtp->teidupf);
+  PUT_LIT(&l, "\n");
+
+  return l.it == l.end ? 0 : (size_t)(l.it - out);
+}
+
+static
+void append_fmt(influx_batch_t* b, size_t len, char const* line)
+{
+  if(len == 0){
+    ++dropped_lines;
+    return;
+  }
+  append_line(b, line, len);
+}
+
+// The KPM record is built from several fragments, sent as one line
+static
+void append_kpm(influx_batch_t* b, kpm_ind_data_t const* kpm)
+{
+  char line[INFLUX_LINE_MAX];
+  size_t pos = 0;
+  char stats[1024] = {0};
+  int const max = 1024;
+
+#define APPEND_FRAG(s) do { size_t const n = strlen(s); \
+                            if(pos + n + 1 >= sizeof(line)) { ++dropped_lines; return; } \
+                            memcpy(line + pos, s, n); pos += n; } while(0)
+
+  for(size_t i = 0; i < kpm->msg.MeasData_len; i++){
+    adapter_MeasDataItem_t* curMeasData = &kpm->msg.MeasData[i];
+    
+    if (i == 0 && kpm->msg.granulPeriod){
+      int rc = snprintf(stats, max,  "kpm_stats: "
+                      "tstamp=%u"
+                      ",granulPeriod=%lu"
+                      ",kpm_MeasData"
+                      ",kpm->MeasData_len=%zu"
+                      , kpm->hdr.collectStartTime
+                      , *(kpm->msg.granulPeriod)
+                      , kpm->msg.MeasData_len
+                      );
+      assert(rc < (int)max && "Not enough space in the char array to write all the data");
+      APPEND_FRAG(stats);
+    }else if(i == 0 && kpm->msg.granulPeriod == NULL){
+      int rc = snprintf(stats, max,  "kpm_stats: "
+                      "tstamp=%u"
+                      ",granulPeriod="
+                      ",kpm_MeasData"
+                      ",kpm->MeasData_len=%zu"
+                      , kpm->hdr.collectStartTime
+                      , kpm->msg.MeasData_len
+                      );
+      assert(rc < (int)max && "Not enough space in the char array to write all the data");
+      APPEND_FRAG(stats);
+    }
+
+    int rc = snprintf(stats, max,
+                      ",kpm_measData[%zu]"
+                      ",MeasData->incompleteFlag=%ld"
+                      ",MeasData->measRecord_len=%zu"
+                      , i
+                      , curMeasData->incompleteFlag
+                      , curMeasData->measRecord_len
+                      );
+    assert(rc < (int)max && "Not enough space in the char array to write all the data");
+    APPEND_FRAG(stats);
+
+    for(size_t j = 0; j < curMeasData->measRecord_len; j++){
+      adapter_MeasRecord_t* curMeasRecord = &(curMeasData->measRecord[j]);
+      memset(stats, 0, sizeof(stats));
+      to_string_kpm_measRecord(curMeasRecord, j, stats, max);
+      APPEND_FRAG(stats);
+    }
+  }
+
+  for(size_t i = 0; i < kpm->msg.MeasInfo_len; i++){
+    MeasInfo_t* curMeasInfo = &kpm->msg.MeasInfo[i];
+    if (i == 0){
+      int rc = snprintf(stats, max,
+                      ",kpm_MeasInfo"
+                      ",kpm->MeasInfo_len=%zu",
+                      i
+                      );
+      assert(rc < (int)max && "Not enough space in the char array to write all the data");
+      APPEND_FRAG(stats);
+    }
+
+    if (curMeasInfo->meas_type == KPM_V2_MEASUREMENT_TYPE_ID){
+      int rc = snprintf(stats, max,
+                        ",MeasInfo[%zu]"
+                        ",measType=%d"
+                        ",measID=%ld"
+                        , i
+                        , curMeasInfo->meas_type
+                        , curMeasInfo->measID
+                        );
+      assert(rc < (int)max && "Not enough space in the char array to write all the data");
+      APPEND_FRAG(stats);
+    } else if (curMeasInfo->meas_type == KPM_V2_MEASUREMENT_TYPE_NAME){
+      int rc = snprintf(stats, max,
+                        ",MeasInfo[%zu]"
+                        ",measType=%d"
+                        ",measName->len=%zu"
+                        ",measName->buf=%s"
+                        , i
+                        , curMeasInfo->meas_type
+                        , curMeasInfo->measName.len
+                        , curMeasInfo->measName.buf
+                        );
+      assert(rc < (int)max && "Not enough space in the char array to write all the data");
+      APPEND_FRAG(stats);
+    }
+
+    for(size_t j = 0; j < curMeasInfo->labelInfo_len; ++j){
+      adapter_LabelInfoItem_t* curLabelInfo = &curMeasInfo->labelInfo[j];
+      memset(stats, 0, sizeof(stats));
+      to_string_kpm_labelInfo(curLabelInfo, j, stats, max);
+      APPEND_FRAG(stats);
+    }
+  }
+
+#undef APPEND_FRAG
+
+  line[pos++] = '\n';
+  append_line(b, line, pos);
 }
 
-void notify_influx_listener(sm_ag_if_rd_t const* data)
+void notify_influx_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data)
 {
   assert(data != NULL);
+  (void)id;
 
   assert(data->type == MAC_STATS_V0 || data->type == RLC_STATS_V0 || data->type == PDCP_STATS_V0 || data->type == SLICE_STATS_V0 || data->type == KPM_STATS_V0 || data->type == GTP_STATS_V0);
   pthread_once(&init_socket, init_udp_socket);
 
-//  printf("Influx db data called!!!\n");
+  influx_batch_t* b = thread_batch();
+  char line[INFLUX_LINE_MAX];
+
   if(data->type == MAC_STATS_V0){
     mac_ind_msg_t const* ind =  &data->mac_stats.msg;
 
     for(uint32_t i = 0; i < ind->len_ue_stats; ++i){
-      char stats[1024] = {0};
-      to_string_mac_ue_stats(&ind->ue_stats[i], ind->tstamp, stats, 1024);
-      int const rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-      assert(rc != -1);
+      size_t const len = fmt_mac_ue(&ind->ue_stats[i], ind->tstamp, line, sizeof(line));
+      append_fmt(b, len, line);
     }
   } else if (data->type == RLC_STATS_V0){
     rlc_ind_msg_t const* rlc = &data->rlc_stats.msg;
 
     for(uint32_t i = 0; i < rlc->len; ++i){
-
-      char stats[1024] = {0};
-      to_string_rlc_rb(&rlc->rb[i], rlc->tstamp, stats, 1024);
-
-     int const rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-     assert(rc != -1);
+      size_t const len = fmt_rlc_rb(&rlc->rb[i], rlc->tstamp, line, sizeof(line));
+      append_fmt(b, len, line);
     }
-
   } else if (data->type == PDCP_STATS_V0){
     pdcp_ind_msg_t const* pdcp = &data->pdcp_stats.msg;
 
     for(uint32_t i = 0; i < pdcp->len; ++i){
-      char stats[512] = {0};
-      pdcp_radio_bearer_stats_t* rb = &pdcp->rb[i];
-
-      to_string_pdcp_rb(rb, pdcp->tstamp, stats, 512);
-      int const rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-      assert(rc != -1);
+      size_t const len = fmt_pdcp_rb(&pdcp->rb[i], pdcp->tstamp, line, sizeof(line));
+      append_fmt(b, len, line);
     } 
   } else if(data->type == SLICE_STATS_V0){
     slice_ind_msg_t const* slice = &data->slice_stats.msg;
 
     char stats[2048] = {0};
-
     to_string_slice(slice, slice->tstamp, stats, 2048);
-    int const rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-    assert(rc != -1);
+    append_line(b, stats, strlen(stats));
   } else if (data->type == GTP_STATS_V0){
     gtp_ind_msg_t const* gtp = &data->gtp_stats.msg;
 
     for(uint32_t i = 0; i < gtp->len; ++i){
-      char stats[512] = {0};
-      gtp_ngu_t_stats_t* ngut = &gtp->ngut[i];
-
-      to_string_gtp_ngu(ngut, gtp->tstamp, stats, 512);
-      int const rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-      assert(rc != -1);
+      size_t const len = fmt_gtp_ngu(&gtp->ngut[i], gtp->tstamp, line, sizeof(line));
+      append_fmt(b, len, line);
     }
   } else if(data->type == KPM_STATS_V0){
-    kpm_ind_data_t const* kpm = &data->kpm_stats;
-    char stats[1024] = {0};
-    int max = 1024;
-
-    for(size_t i = 0; i < kpm->msg.MeasData_len; i++){
-      adapter_MeasDataItem_t* curMeasData = &kpm->msg.MeasData[i];
-      
-      if (i == 0 && kpm->msg.granulPeriod){
-        int rc = snprintf(stats, max,  "kpm_stats: "
-                        "tstamp=%u"
-                        ",granulPeriod=%lu"
-                        ",kpm_MeasData"
-                        ",kpm->MeasData_len=%zu"
-                        , kpm->hdr.collectStartTime
-                        , *(kpm->msg.granulPeriod)
-                        , kpm->msg.MeasData_len
-                        );
-        assert(rc < (int)max && "Not enough space in the char array to write all the data");
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }else if(i == 0 && kpm->msg.granulPeriod == NULL){
-        int rc = snprintf(stats, max,  "kpm_stats: "
-                        "tstamp=%u"
-                        ",granulPeriod="
-                        ",kpm_MeasData"
-                        ",kpm->MeasData_len=%zu"
-                        , kpm->hdr.collectStartTime
-                        , kpm->msg.MeasData_len
-                        );
-        assert(rc < (int)max && "Not enough space in the char array to write all the data");
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }
-
-      memset(stats, 0, sizeof(stats));
-      int rc = snprintf(stats, max,
-                        ",kpm_measData[%zu]"
-                        ",MeasData->incompleteFlag=%ld"
-                        ",MeasData->measRecord_len=%zu"
-                        , i
-                        , curMeasData->incompleteFlag
-                        , curMeasData->measRecord_len
-                        );
-      assert(rc < (int)max && "Not enough space in the char array to write all the data");
-      rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-      assert(rc != -1);
-
-      for(size_t j = 0; j < curMeasData->measRecord_len; j++){
-        adapter_MeasRecord_t* curMeasRecord = &(curMeasData->measRecord[j]);
-        memset(stats, 0, sizeof(stats));
-        to_string_kpm_measRecord(curMeasRecord, j, stats, max);
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }
-    }
-
-    for(size_t i = 0; i < kpm->msg.MeasInfo_len; i++){
-      MeasInfo_t* curMeasInfo = &kpm->msg.MeasInfo[i];
-      if (i == 0){
-        memset(stats, 0, sizeof(stats));
-        int rc = snprintf(stats, max,
-                        ",kpm_MeasInfo"
-                        ",kpm->MeasInfo_len=%zu",
-                        i
-                        );
-        assert(rc < (int)max && "Not enough space in the char array to write all the data");
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }
-
-      if (curMeasInfo->meas_type == KPM_V2_MEASUREMENT_TYPE_ID){
-        memset(stats, 0, sizeof(stats));
-        int rc = snprintf(stats, max,
-                          ",MeasInfo[%zu]"
-                          ",measType=%d"
-                          ",measID=%ld"
-                          , i
-                          , curMeasInfo->meas_type
-                          , curMeasInfo->measID
-                          );
-        assert(rc < (int)max && "Not enough space in the char array to write all the data");
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      } else if (curMeasInfo->meas_type == KPM_V2_MEASUREMENT_TYPE_NAME){
-        memset(stats, 0, sizeof(stats));
-        int rc = snprintf(stats, max,
-                          ",MeasInfo[%zu]"
-                          ",measType=%d"
-                          ",measName->len=%zu"
-                          ",measName->buf=%s"
-                          , i
-                          , curMeasInfo->meas_type
-                          , curMeasInfo->measName.len
-                          , curMeasInfo->measName.buf
-                          );
-        assert(rc < (int)max && "Not enough space in the char array to write all the data");
-        rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }
-
-      for(size_t j = 0; j < curMeasInfo->labelInfo_len; ++j){
-        adapter_LabelInfoItem_t* curLabelInfo = &curMeasInfo->labelInfo[j];
-        memset(stats, 0, sizeof(stats));
-        to_string_kpm_labelInfo(curLabelInfo, j, stats, max);
-        int rc = sendto(sockfd, stats, strlen(stats),  MSG_CONFIRM, (const struct sockaddr *) &servaddr, sizeof(servaddr));
-        assert(rc != -1);
-      }
-    }
+    append_kpm(b, &data->kpm_stats);
   } else {
     assert(0 != 0 || "invalid data type ");
   }
 
+  // Slow sources are sent at once. Fast sources are coalesced for at most
+  // INFLUX_FLUSH_US while indications keep arriving. The last window of a
+  // thread is sent by flush_influx_listener() once its queue drains
+  int64_t const now = time_now_us();
+  if(now - b->last_us >= INFLUX_FLUSH_US || now - b->first_us >= INFLUX_FLUSH_US)
+    flush_batch(b);
+  b->last_us = now;
+}
+
+void flush_influx_listener(void)
+{
+  pthread_once(&init_socket, init_udp_socket);
+
+  influx_batch_t* b = pthread_getspecific(batch_key);
+  if(b != NULL)
+    flush_batch(b);
+}
+
+influx_stats_t stats_influx_listener(void)
+{
+  influx_stats_t s = { .sent_dgrams = sent_dgrams,
+                       .dropped_dgrams = dropped_dgrams,
+                       .dropped_lines = dropped_lines};
+  return s;
 }
 
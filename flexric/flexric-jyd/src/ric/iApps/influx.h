@@ -23,9 +23,26 @@
 #ifndef INFLUX_LISTENER_H
 #define INFLUX_LISTENER_H
 
+#include "lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "sm/agent_if/read/sm_ag_if_rd.h"
 
-void notify_influx_listener(sm_ag_if_rd_t const* data);
+#include <stddef.h>
+
+typedef struct{
+  size_t sent_dgrams;
+  size_t dropped_dgrams; // Socket buffer full or send error
+  size_t dropped_lines; // Too long to fit in a datagram
+} influx_stats_t;
+
+// Lines of one or several indications are coalesced into MTU sized UDP
+// datagrams and sent with a single sendmmsg
+void notify_influx_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data);
+
+// Sends the lines batched by the calling thread. Called when the thread has no
+// more indications queued, so that they are not held until the next one
+void flush_influx_listener(void);
+
+influx_stats_t stats_influx_listener(void);
 
 #endif
 
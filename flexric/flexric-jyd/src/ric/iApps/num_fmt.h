@@ -0,0 +1,121 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef NUM_FMT_LISTENER_H
+#define NUM_FMT_LISTENER_H
+
+// Integer and float formatting without printf, shared by the iApp exporters.
+// Writing past the end saturates the cursor at end, so a truncated output is
+// detected with it == end
+
+#include <math.h>                                        // for isfinite
+#include <stdint.h>
+#include <stdio.h>                                       // for snprintf
+#include <string.h>                                      // for memcpy
+
+typedef struct{
+  char* it;
+  char* end;
+} line_t;
+
+static inline
+void put_str(line_t* l, char const* s, size_t len)
+{
+  if(l->it + len > l->end){
+    l->it = l->end;
+    return;
+  }
+  memcpy(l->it, s, len);
+  l->it += len;
+}
+
+#define PUT_LIT(l, s) put_str(l, s, sizeof(s) - 1)
+
+static inline
+void put_u64(line_t* l, uint64_t v)
+{
+  char tmp[20];
+  size_t n = 0;
+  do{
+    tmp[sizeof(tmp) - 1 - n] = '0' + (v % 10);
+    v /= 10;
+    ++n;
+  } while(v != 0);
+
+  put_str(l, tmp + sizeof(tmp) - n, n);
+}
+
+static inline
+void put_i64(line_t* l, int64_t v)
+{
+  if(v < 0){
+    PUT_LIT(l, "-");
+    put_u64(l, -(uint64_t)v);
+  } else {
+    put_u64(l, v);
+  }
+}
+
+// Fixed point with up to 6 decimals, trailing zeros removed
+static inline
+void put_f64(line_t* l, double v)
+{
+  if(isfinite(v) == false){
+    PUT_LIT(l, "0");
+    return;
+  }
+
+  if(v < 0){
+    PUT_LIT(l, "-");
+    v = -v;
+  }
+
+  if(v >= 1e18){
+    char tmp[32];
+    int const rc = snprintf(tmp, sizeof(tmp), "%g", v);
+    put_str(l, tmp, rc);
+    return;
+  }
+
+  uint64_t ip = (uint64_t)v;
+  uint64_t frac = (uint64_t)((v - ip) * 1e6 + 0.5);
+  if(frac >= 1000000){
+    ip += 1;
+    frac -= 1000000;
+  }
+
+  put_u64(l, ip);
+  if(frac == 0)
+    return;
+
+  char tmp[7] = ".000000";
+  for(int i = 6; i > 0; --i){
+    tmp[i] = '0' + (frac % 10);
+    frac /= 10;
+  }
+  size_t n = 7;
+  while(tmp[n - 1] == '0')
+    --n;
+  put_str(l, tmp, n);
+}
+
+#endif
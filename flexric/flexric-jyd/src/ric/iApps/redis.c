@@ -20,22 +20,801 @@
  */
 
 
+
 #include "redis.h"
 
+#include <arpa/inet.h>                                   // for inet_pton
 #include <assert.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>                                 // for TCP_NODELAY
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../../sm/mac_sm/ie/mac_data_ie.h"
+#include "../../sm/pdcp_sm/ie/pdcp_data_ie.h"
+#include "../../sm/rlc_sm/ie/rlc_data_ie.h"
+#include "../../util/alg_ds/ds/lock_guard/lock_guard.h"
+#include "../../util/time_now_us.h"
+#include "num_fmt.h"
+#include "string_parser.h"                               // for to_string_slice
+
+// Largest XADD command of one record
+#define REDIS_RECORD_MAX 4096
+
+#define REDIS_PREFIX_MAX 64
+
+#define REDIS_BACKOFF_MIN_US 50000
+#define REDIS_BACKOFF_MAX_US 2000000
+
+typedef enum{
+  REDIS_DISCONNECTED,
+  REDIS_CONNECTING,
+  REDIS_CONNECTED,
+} redis_state_e;
+
+typedef struct{
+  int fd;
+  redis_state_e state;
+  int64_t retry_us;
+  int64_t backoff_us;
+
+  // Pipelined RESP commands. [0, sent) is already written to the socket.
+  // cmd is the start of the command that contains sent
+  char* buf;
+  size_t cap;
+  size_t len;
+  size_t sent;
+  size_t cmd;
+  size_t num_cmds; // commands in the buffer not fully written
+
+  // Commands written and not yet answered in this connection
+  size_t awaiting;
+  bool line_start;
+} redis_conn_t;
+
+// One XADD under construction
+typedef struct{
+  char buf[REDIS_RECORD_MAX];
+  line_t l;
+  size_t args;
+} redis_record_t;
+
+// XADD arguments after the command name, up to the first field
+typedef struct{
+  char buf[256];
+  size_t len;
+} redis_stream_t;
+
+static
+pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+static
+pthread_mutex_t conf_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static
+char conf_ip[INET_ADDRSTRLEN] = "127.0.0.1";
+
+static
+char conf_prefix[REDIS_PREFIX_MAX] = "flexric";
+
+static
+redis_conf_t conf = { .ip = conf_ip, .port = 6379, .prefix = conf_prefix, .maxlen = 10000, .buf_sz = 1 << 22 };
+
+static
+bool conf_frozen = false;
+
+static
+struct sockaddr_in servaddr;
+
+// Every thread delivering indications owns a connection
+static
+pthread_key_t conn_key;
+
+static
+atomic_size_t queued_records;
+
+static
+atomic_size_t dropped_records;
+
+static
+atomic_size_t replies_ok;
+
+static
+atomic_size_t replies_err;
+
+static
+atomic_size_t connects;
+
+//////////
+// RESP encoding
+//////////
+
+static
+void put_bulk(line_t* l, char const* s, size_t len)
+{
+  PUT_LIT(l, "$");
+  put_u64(l, len);
+  PUT_LIT(l, "\r\n");
+  put_str(l, s, len);
+  PUT_LIT(l, "\r\n");
+}
+
+static
+void init_record(redis_record_t* r)
+{
+  r->l.it = r->buf;
+  r->l.end = r->buf + sizeof(r->buf);
+  r->args = 0;
+}
+
+static
+void add_field(redis_record_t* r, char const* name, size_t name_len, char const* val, size_t val_len)
+{
+  put_bulk(&r->l, name, name_len);
+  put_bulk(&r->l, val, val_len);
+  r->args += 2;
+}
+
+#define ADD_NUM(r, name, put, v) do { char tmp_[32]; line_t t_ = {.it = tmp_, .end = tmp_ + sizeof(tmp_)}; \
+                                      put(&t_, v); \
+                                      add_field(r, name, sizeof(name) - 1, tmp_, t_.it - tmp_); } while(0)
+
+#define ADD_U(r, name, v) ADD_NUM(r, name, put_u64, v)
+#define ADD_I(r, name, v) ADD_NUM(r, name, put_i64, v)
+#define ADD_F(r, name, v) ADD_NUM(r, name, put_f64, v)
+#define ADD_S(r, name, s) add_field(r, name, sizeof(name) - 1, s, strlen(s))
+
+// Length of the RESP array at p. Only parses what this file produces
+static
+size_t resp_cmd_len(char const* p)
+{
+  char* it = (char*)p;
+  assert(*it == '*');
+
+  size_t const args = strtoul(it + 1, &it, 10);
+  it += 2;
+  for(size_t i = 0; i < args; ++i){
+    assert(*it == '$');
+    size_t const len = strtoul(it + 1, &it, 10);
+    it += 2 + len + 2;
+  }
+  return it - p;
+}
+
+static
+void init_stream(redis_stream_t* s, global_e2_node_id_t const* id, char const* sm)
+{
+  char key[192];
+  line_t k = {.it = key, .end = key + sizeof(key)};
+  put_str(&k, conf.prefix, strlen(conf.prefix));
+  if(id != NULL){
+    PUT_LIT(&k, ":");
+    put_u64(&k, id->plmn.mcc);
+    PUT_LIT(&k, ":");
+    put_u64(&k, id->plmn.mnc);
+    PUT_LIT(&k, ":");
+    put_u64(&k, id->nb_id);
+    if(id->cu_du_id != NULL){
+      PUT_LIT(&k, ":");
+      put_u64(&k, *id->cu_du_id);
+    }
+  } else {
+    PUT_LIT(&k, ":unknown");
+  }
+  PUT_LIT(&k, ":");
+  put_str(&k, sm, strlen(sm));
+  assert(k.it != k.end && "Redis stream name too long");
+
+  char maxlen[24];
+  line_t m = {.it = maxlen, .end = maxlen + sizeof(maxlen)};
+  put_u64(&m, conf.maxlen);
+
+  line_t l = {.it = s->buf, .end = s->buf + sizeof(s->buf)};
+  put_bulk(&l, key, k.it - key);
+  PUT_LIT(&l, "$6\r\nMAXLEN\r\n$1\r\n~\r\n");
+  put_bulk(&l, maxlen, m.it - maxlen);
+  PUT_LIT(&l, "$1\r\n*\r\n");
+  assert(l.it != l.end);
+  s->len = l.it - s->buf;
+}
+
+//////////
+// Connection
+//////////
+
+static
+void free_conn(void* arg);
+
+static
+void init_redis(void)
+{
+  lock_guard(&conf_mtx);
+  conf_frozen = true;
+
+  memset(&servaddr, 0, sizeof(servaddr));
+  servaddr.sin_family = AF_INET;
+  servaddr.sin_port = htons(conf.port);
+  int rc = inet_pton(AF_INET, conf.ip, &servaddr.sin_addr);
+  assert(rc == 1 && "Invalid Redis IPv4 address");
+
+  rc = pthread_key_create(&conn_key, free_conn);
+  assert(rc == 0);
+}
+
+static
+void drop_partial_cmd(redis_conn_t* c);
+
+static
+void disconnect(redis_conn_t* c)
+{
+  if(c->fd >= 0)
+    close(c->fd);
+  c->fd = -1;
+  c->state = REDIS_DISCONNECTED;
+  c->awaiting = 0;
+  c->line_start = true;
+
+  drop_partial_cmd(c);
+
+  int64_t const now = time_now_us();
+  c->retry_us = now + c->backoff_us;
+  c->backoff_us *= 2;
+  if(c->backoff_us > REDIS_BACKOFF_MAX_US)
+    c->backoff_us = REDIS_BACKOFF_MAX_US;
+}
+
+static
+void start_connect(redis_conn_t* c)
+{
+  c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  assert(c->fd > -1 && "Error creating the socket");
+
+  int const one = 1;
+  setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  int const rc = connect(c->fd, (struct sockaddr*)&servaddr, sizeof(servaddr));
+  if(rc == 0){
+    c->state = REDIS_CONNECTED;
+  } else if(errno == EINPROGRESS){
+    c->state = REDIS_CONNECTING;
+  } else {
+    disconnect(c);
+    return;
+  }
+
+  if(c->state == REDIS_CONNECTED){
+    c->backoff_us = REDIS_BACKOFF_MIN_US;
+    ++connects;
+  }
+}
+
+static
+void check_connect(redis_conn_t* c)
+{
+  struct pollfd p = {.fd = c->fd, .events = POLLOUT};
+  if(poll(&p, 1, 0) != 1)
+    return;
+
+  int err = 0;
+  socklen_t len = sizeof(err);
+  int const rc = getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+  if(rc != 0 || err != 0){
+    disconnect(c);
+    return;
+  }
+
+  c->state = REDIS_CONNECTED;
+  c->backoff_us = REDIS_BACKOFF_MIN_US;
+  ++connects;
+}
+
+//////////
+// Output buffer
+//////////
+
+// Moves cmd to the start of the command containing sent
+static
+void advance_cmd(redis_conn_t* c)
+{
+  while(c->cmd < c->sent){
+    size_t const n = resp_cmd_len(c->buf + c->cmd);
+    if(c->cmd + n > c->sent)
+      break;
+    c->cmd += n;
+    c->num_cmds -= 1;
+    c->awaiting += 1;
+  }
+}
+
+static
+void compact(redis_conn_t* c)
+{
+  advance_cmd(c);
+  memmove(c->buf, c->buf + c->cmd, c->len - c->cmd);
+  c->len -= c->cmd;
+  c->sent -= c->cmd;
+  c->cmd = 0;
+}
+
+// A command cut by a lost connection cannot be resumed in a new one
+static
+void drop_partial_cmd(redis_conn_t* c)
+{
+  advance_cmd(c);
+
+  size_t end = c->cmd;
+  if(c->sent > c->cmd){
+    end += resp_cmd_len(c->buf + c->cmd);
+    c->num_cmds -= 1;
+    ++dropped_records;
+  }
+
+  memmove(c->buf, c->buf + end, c->len - end);
+  c->len -= end;
+  c->sent = 0;
+  c->cmd = 0;
+}
+
+static
+void append_record(redis_conn_t* c, redis_stream_t const* s, redis_record_t const* r)
+{
+  if(r->l.it == r->l.end){
+    ++dropped_records;
+    return;
+  }
+
+  char hdr[32];
+  line_t h = {.it = hdr, .end = hdr + sizeof(hdr)};
+  PUT_LIT(&h, "*");
+  put_u64(&h, 6 + r->args);
+  PUT_LIT(&h, "\r\n$4\r\nXADD\r\n");
+
+  size_t const hdr_len = h.it - hdr;
+  size_t const rec_len = r->l.it - r->buf;
+  size_t const len = hdr_len + s->len + rec_len;
+
+  if(c->len + len > c->cap && c->cmd > 0)
+    compact(c);
 
-void notify_redis_listener(sm_ag_if_rd_t const* data)
+  if(c->len + len > c->cap){
+    ++dropped_records;
+    return;
+  }
+
+  char* it = c->buf + c->len;
+  memcpy(it, hdr, hdr_len);
+  memcpy(it + hdr_len, s->buf, s->len);
+  memcpy(it + hdr_len + s->len, r->buf, rec_len);
+  c->len += len;
+  c->num_cmds += 1;
+  ++queued_records;
+}
+
+//////////
+// Socket I/O
+//////////
+
+// Replies are one line (+OK, -ERR, :n) or a bulk string header followed by
+// the entry id. Ids never start with a RESP type byte
+static
+void read_replies(redis_conn_t* c)
+{
+  // Replies only answer fully written commands
+  advance_cmd(c);
+
+  char tmp[4096];
+  for(;;){
+    ssize_t const rc = recv(c->fd, tmp, sizeof(tmp), MSG_DONTWAIT);
+    if(rc == 0){
+      disconnect(c);
+      return;
+    }
+    if(rc < 0){
+      if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        disconnect(c);
+      return;
+    }
+
+    for(ssize_t i = 0; i < rc; ++i){
+      if(c->line_start == true && (tmp[i] == '$' || tmp[i] == '+' || tmp[i] == ':' || tmp[i] == '-')){
+        if(tmp[i] == '-')
+          ++replies_err;
+        else
+          ++replies_ok;
+        if(c->awaiting > 0)
+          c->awaiting -= 1;
+      }
+      c->line_start = tmp[i] == '\n';
+    }
+  }
+}
+
+static
+void write_cmds(redis_conn_t* c)
+{
+  while(c->sent < c->len){
+    ssize_t const rc = send(c->fd, c->buf + c->sent, c->len - c->sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if(rc < 0){
+      if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        disconnect(c);
+      return;
+    }
+    c->sent += rc;
+  }
+
+  // Fast path: everything written, no need to walk the commands
+  c->awaiting += c->num_cmds;
+  c->num_cmds = 0;
+  c->len = 0;
+  c->sent = 0;
+  c->cmd = 0;
+}
+
+static
+void pump(redis_conn_t* c)
+{
+  if(c->state == REDIS_DISCONNECTED && time_now_us() >= c->retry_us)
+    start_connect(c);
+
+  if(c->state == REDIS_CONNECTING)
+    check_connect(c);
+
+  if(c->state == REDIS_CONNECTED)
+    read_replies(c);
+
+  if(c->state == REDIS_CONNECTED)
+    write_cmds(c);
+}
+
+static
+void free_conn(void* arg)
+{
+  redis_conn_t* c = (redis_conn_t*)arg;
+  if(c->state == REDIS_CONNECTED)
+    write_cmds(c);
+  if(c->fd >= 0)
+    close(c->fd);
+  free(c->buf);
+  free(c);
+}
+
+static
+redis_conn_t* thread_conn(void)
+{
+  redis_conn_t* c = pthread_getspecific(conn_key);
+  if(c == NULL){
+    c = calloc(1, sizeof(redis_conn_t));
+    assert(c != NULL && "Memory exhausted");
+    c->fd = -1;
+    c->state = REDIS_DISCONNECTED;
+    c->backoff_us = REDIS_BACKOFF_MIN_US;
+    c->line_start = true;
+    c->cap = conf.buf_sz;
+    c->buf = malloc(c->cap);
+    assert(c->buf != NULL && "Memory exhausted");
+    int const rc = pthread_setspecific(conn_key, c);
+    assert(rc == 0);
+  }
+  return c;
+}
+
+//////////
+// Records
+//////////
+
+static
+void add_mac_ue(redis_conn_t* c, redis_stream_t const* st, mac_ue_stats_impl_t const* s, int64_t tstamp)
+{
+  redis_record_t r;
+  init_record(&r);
+
+  ADD_I(&r, "tstamp", tstamp);
+  ADD_U(&r, "frame", s->frame);
+  ADD_U(&r, "slot", s->slot);
+  ADD_U(&r, "dl_aggr_tbs", s->dl_aggr_tbs);
+  ADD_U(&r, "ul_aggr_tbs", s->ul_aggr_tbs);
+  ADD_U(&r, "dl_aggr_bytes_sdus", s->dl_aggr_bytes_sdus);
+  ADD_U(&r, "ul_aggr_bytes_sdus", s->ul_aggr_bytes_sdus);
+  ADD_U(&r, "dl_curr_tbs", s->dl_curr_tbs);
+  ADD_U(&r, "ul_curr_tbs", s->ul_curr_tbs);
+  ADD_U(&r, "dl_sched_rb", s->dl_sched_rb);
+  ADD_U(&r, "ul_sched_rb", s->ul_sched_rb);
+  ADD_F(&r, "pusch_snr", s->pusch_snr);
+  ADD_F(&r, "pucch_snr", s->pucch_snr);
+  ADD_U(&r, "rnti", s->rnti);
+  ADD_U(&r, "dl_aggr_prb", s->dl_aggr_prb);
+  ADD_U(&r, "ul_aggr_prb", s->ul_aggr_prb);
+  ADD_U(&r, "dl_aggr_sdus", s->dl_aggr_sdus);
+  ADD_U(&r, "ul_aggr_sdus", s->ul_aggr_sdus);
+  ADD_U(&r, "dl_aggr_retx_prb", s->dl_aggr_retx_prb);
+  ADD_U(&r, "ul_aggr_retx_prb", s->ul_aggr_retx_prb);
+  ADD_U(&r, "wb_cqi", s->wb_cqi);
+  ADD_U(&r, "dl_mcs1", s->dl_mcs1);
+  ADD_U(&r, "ul_mcs1", s->ul_mcs1);
+  ADD_U(&r, "dl_mcs2", s->dl_mcs2);
+  ADD_U(&r, "ul_mcs2", s->ul_mcs2);
+  ADD_I(&r, "phr", s->phr);
+  ADD_U(&r, "bsr", s->bsr);
+  ADD_F(&r, "dl_bler", s->dl_bler);
+  ADD_F(&r, "ul_bler", s->ul_bler);
+  ADD_U(&r, "dl_num_harq", s->dl_num_harq);
+  ADD_U(&r, "dl_harq[0]", s->dl_harq[0]);
+  ADD_U(&r, "dl_harq[1]", s->dl_harq[1]);
+  ADD_U(&r, "dl_harq[2]", s->dl_harq[2]);
+  ADD_U(&r, "dl_harq[3]", s->dl_harq[3]);
+  ADD_U(&r, "dlsch_errors", s->dl_harq[4]);
+  ADD_U(&r, "ul_num_harq", s->ul_num_harq);
+  ADD_U(&r, "ul_harq[0]", s->ul_harq[0]);
+  ADD_U(&r, "ul_harq[1]", s->ul_harq[1]);
+  ADD_U(&r, "ul_harq[2]", s->ul_harq[2]);
+  ADD_U(&r, "ul_harq[3]", s->ul_harq[3]);
+  ADD_U(&r, "ulsch_errors", s->ul_harq[4]);
+
+  append_record(c, st, &r);
+}
+
+static
+void add_rlc_rb(redis_conn_t* c, redis_stream_t const* st, rlc_radio_bearer_stats_t const* rlc, int64_t tstamp)
+{
+  redis_record_t r;
+  init_record(&r);
+
+  ADD_I(&r, "tstamp", tstamp);
+  ADD_U(&r, "txpdu_pkts", rlc->txpdu_pkts);
+  ADD_U(&r, "txpdu_bytes", rlc->txpdu_bytes);
+  ADD_U(&r, "txpdu_wt_ms", rlc->txpdu_wt_ms);
+  ADD_U(&r, "txpdu_dd_pkts", rlc->txpdu_dd_pkts);
+  ADD_U(&r, "txpdu_dd_bytes", rlc->txpdu_dd_bytes);
+  ADD_U(&r, "txpdu_retx_pkts", rlc->txpdu_retx_pkts);
+  ADD_U(&r, "txpdu_retx_bytes", rlc->txpdu_retx_bytes);
+  ADD_U(&r, "txpdu_segmented", rlc->txpdu_segmented);
+  ADD_U(&r, "txpdu_status_pkts", rlc->txpdu_status_pkts);
+  ADD_U(&r, "txpdu_status_bytes", rlc->txpdu_status_bytes);
+  ADD_U(&r, "txbuf_occ_bytes", rlc->txbuf_occ_bytes);
+  ADD_U(&r, "txbuf_occ_pkts", rlc->txbuf_occ_pkts);
+  ADD_U(&r, "rxpdu_pkts", rlc->rxpdu_pkts);
+  ADD_U(&r, "rxpdu_bytes", rlc->rxpdu_bytes);
+  ADD_U(&r, "rxpdu_dup_pkts", rlc->rxpdu_dup_pkts);
+  ADD_U(&r, "rxpdu_dup_bytes", rlc->rxpdu_dup_bytes);
+  ADD_U(&r, "rxpdu_dd_pkts", rlc->rxpdu_dd_pkts);
+  ADD_U(&r, "rxpdu_dd_bytes", rlc->rxpdu_dd_bytes);
+  ADD_U(&r, "rxpdu_ow_pkts", rlc->rxpdu_ow_pkts);
+  ADD_U(&r, "rxpdu_ow_bytes", rlc->rxpdu_ow_bytes);
+  ADD_U(&r, "rxpdu_status_pkts", rlc->rxpdu_status_pkts);
+  ADD_U(&r, "rxpdu_status_bytes", rlc->rxpdu_status_bytes);
+  ADD_U(&r, "rxbuf_occ_bytes", rlc->rxbuf_occ_bytes);
+  ADD_U(&r, "rxbuf_occ_pkts", rlc->rxbuf_occ_pkts);
+  ADD_U(&r, "txsdu_pkts", rlc->txsdu_pkts);
+  ADD_U(&r, "txsdu_bytes", rlc->txsdu_bytes);
+  ADD_U(&r, "rxsdu_pkts", rlc->rxsdu_pkts);
+  ADD_U(&r, "rxsdu_bytes", rlc->rxsdu_bytes);
+  ADD_U(&r, "rxsdu_dd_pkts", rlc->rxsdu_dd_pkts);
+  ADD_U(&r, "rxsdu_dd_bytes", rlc->rxsdu_dd_bytes);
+  ADD_U(&r, "rnti", rlc->rnti);
+  ADD_U(&r, "mode", rlc->mode);
+  ADD_U(&r, "rbid", rlc->rbid);
+
+  append_record(c, st, &r);
+}
+
+static
+void add_pdcp_rb(redis_conn_t* c, redis_stream_t const* st, pdcp_radio_bearer_stats_t const* pdcp, int64_t tstamp)
+{
+  redis_record_t r;
+  init_record(&r);
+
+  ADD_I(&r, "tstamp", tstamp);
+  ADD_U(&r, "txpdu_pkts", pdcp->txpdu_pkts);
+  ADD_U(&r, "txpdu_bytes", pdcp->txpdu_bytes);
+  ADD_U(&r, "txpdu_sn", pdcp->txpdu_sn);
+  ADD_U(&r, "rxpdu_pkts", pdcp->rxpdu_pkts);
+  ADD_U(&r, "rxpdu_bytes", pdcp->rxpdu_bytes);
+  ADD_U(&r, "rxpdu_sn", pdcp->rxpdu_sn);
+  ADD_U(&r, "rxpdu_oo_pkts", pdcp->rxpdu_oo_pkts);
+  ADD_U(&r, "rxpdu_oo_bytes", pdcp->rxpdu_oo_bytes);
+  ADD_U(&r, "rxpdu_dd_pkts", pdcp->rxpdu_dd_pkts);
+  ADD_U(&r, "rxpdu_dd_bytes", pdcp->rxpdu_dd_bytes);
+  ADD_U(&r, "rxpdu_ro_count", pdcp->rxpdu_ro_count);
+  ADD_U(&r, "txsdu_pkts", pdcp->txsdu_pkts);
+  ADD_U(&r, "txsdu_bytes", pdcp->txsdu_bytes);
+  ADD_U(&r, "rxsdu_pkts", pdcp->rxsdu_pkts);
+  ADD_U(&r, "rxsdu_bytes", pdcp->rxsdu_bytes);
+  ADD_U(&r, "rnti", pdcp->rnti);
+  ADD_U(&r, "mode", pdcp->mode);
+  ADD_U(&r, "rbid", pdcp->rbid);
+
+  append_record(c, st, &r);
+}
+
+static
+void add_gtp_ngu(redis_conn_t* c, redis_stream_t const* st, gtp_ngu_t_stats_t const* gtp, int64_t tstamp)
+{
+  redis_record_t r;
+  init_record(&r);
+
+  ADD_I(&r, "tstamp", tstamp);
+  ADD_U(&r, "rnti", gtp->rnti);
+  ADD_U(&r, "qfi", gtp->qfi);
+  ADD_U(&r, "teidgnb", gtp->teidgnb);
+  ADD_U(&r, "teidupf", gtp->teidupf);
+
+  append_record(c, st, &r);
+}
+
+static
+void add_slice(redis_conn_t* c, redis_stream_t const* st, slice_ind_msg_t const* slice)
+{
+  redis_record_t r;
+  init_record(&r);
+
+  char stats[2048] = {0};
+  to_string_slice(slice, slice->tstamp, stats, sizeof(stats));
+
+  ADD_I(&r, "tstamp", slice->tstamp);
+  ADD_S(&r, "stats", stats);
+
+  append_record(c, st, &r);
+}
+
+// One entry per measurement data item
+static
+void add_kpm(redis_conn_t* c, redis_stream_t const* st, kpm_ind_data_t const* kpm)
+{
+  for(size_t i = 0; i < kpm->msg.MeasData_len; ++i){
+    adapter_MeasDataItem_t const* data = &kpm->msg.MeasData[i];
+
+    redis_record_t r;
+    init_record(&r);
+
+    ADD_U(&r, "tstamp", kpm->hdr.collectStartTime);
+    if(kpm->msg.granulPeriod != NULL)
+      ADD_U(&r, "granulPeriod", *kpm->msg.granulPeriod);
+    ADD_U(&r, "measData", i);
+    ADD_I(&r, "incompleteFlag", data->incompleteFlag);
+
+    for(size_t j = 0; j < data->measRecord_len; ++j){
+      adapter_MeasRecord_t const* rec = &data->measRecord[j];
+
+      // Named as the j-th MeasInfo, if present
+      char name[64];
+      line_t n = {.it = name, .end = name + sizeof(name)};
+      if(j < kpm->msg.MeasInfo_len && kpm->msg.MeasInfo[j].meas_type == KPM_V2_MEASUREMENT_TYPE_NAME){
+        byte_array_t const* s = &kpm->msg.MeasInfo[j].measName;
+        put_str(&n, (char const*)s->buf, s->len < sizeof(name) - 1 ? s->len : sizeof(name) - 1);
+      } else {
+        PUT_LIT(&n, "measRecord[");
+        put_u64(&n, j);
+        PUT_LIT(&n, "]");
+      }
+
+      char val[32];
+      line_t v = {.it = val, .end = val + sizeof(val)};
+      if(rec->type == MeasRecord_int)
+        put_u64(&v, rec->int_val);
+      else if(rec->type == MeasRecord_real)
+        put_f64(&v, rec->real_val);
+
+      add_field(&r, name, n.it - name, val, v.it - val);
+    }
+
+    append_record(c, st, &r);
+  }
+}
+
+//////////
+// Public API
+//////////
+
+redis_conf_t default_redis_conf(void)
+{
+  redis_conf_t c = { .ip = "127.0.0.1", .port = 6379, .prefix = "flexric", .maxlen = 10000, .buf_sz = 1 << 22 };
+  return c;
+}
+
+void conf_redis_listener(redis_conf_t const* c)
+{
+  assert(c != NULL);
+  assert(c->ip != NULL && c->prefix != NULL);
+  assert(c->buf_sz >= REDIS_RECORD_MAX + 256);
+
+  lock_guard(&conf_mtx);
+  if(conf_frozen == true)
+    return;
+
+  assert(strlen(c->ip) < sizeof(conf_ip));
+  assert(strlen(c->prefix) < sizeof(conf_prefix));
+  strcpy(conf_ip, c->ip);
+  strcpy(conf_prefix, c->prefix);
+
+  conf.port = c->port;
+  conf.maxlen = c->maxlen;
+  conf.buf_sz = c->buf_sz;
+}
+
+void notify_redis_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data)
 {
   assert(data != NULL);
   assert(data->type == MAC_STATS_V0 || data->type == RLC_STATS_V0 || data->type == PDCP_STATS_V0 || data->type == SLICE_STATS_V0 || data->type == KPM_STATS_V0 || data->type == GTP_STATS_V0); 
-  
-  /*
-  if(data->type == MAC_STATS_V0)
-    printf("REDIS data called from MAC stats!!\n");
-  else if (data->type == RLC_STATS_V0 )
-    printf("REDIS data called from RLC stats!!\n");
-  else
-    assert(0!=0 && "Invalid data path");
-    */
+  pthread_once(&init_once, init_redis);
+
+  redis_conn_t* c = thread_conn();
+  redis_stream_t st;
+
+  if(data->type == MAC_STATS_V0){
+    mac_ind_msg_t const* ind = &data->mac_stats.msg;
+    init_stream(&st, id, "mac");
+    for(uint32_t i = 0; i < ind->len_ue_stats; ++i)
+      add_mac_ue(c, &st, &ind->ue_stats[i], ind->tstamp);
+  } else if (data->type == RLC_STATS_V0){
+    rlc_ind_msg_t const* rlc = &data->rlc_stats.msg;
+    init_stream(&st, id, "rlc");
+    for(uint32_t i = 0; i < rlc->len; ++i)
+      add_rlc_rb(c, &st, &rlc->rb[i], rlc->tstamp);
+  } else if (data->type == PDCP_STATS_V0){
+    pdcp_ind_msg_t const* pdcp = &data->pdcp_stats.msg;
+    init_stream(&st, id, "pdcp");
+    for(uint32_t i = 0; i < pdcp->len; ++i)
+      add_pdcp_rb(c, &st, &pdcp->rb[i], pdcp->tstamp);
+  } else if(data->type == SLICE_STATS_V0){
+    init_stream(&st, id, "slice");
+    add_slice(c, &st, &data->slice_stats.msg);
+  } else if (data->type == GTP_STATS_V0){
+    gtp_ind_msg_t const* gtp = &data->gtp_stats.msg;
+    init_stream(&st, id, "gtp");
+    for(uint32_t i = 0; i < gtp->len; ++i)
+      add_gtp_ngu(c, &st, &gtp->ngut[i], gtp->tstamp);
+  } else if(data->type == KPM_STATS_V0){
+    init_stream(&st, id, "kpm");
+    add_kpm(c, &st, &data->kpm_stats);
+  } else {
+    assert(0 != 0 && "invalid data type ");
+  }
+
+  // All the records of the indication leave with one send
+  pump(c);
+}
+
+bool flush_redis_listener(int timeout_ms)
+{
+  pthread_once(&init_once, init_redis);
+  redis_conn_t* c = thread_conn();
+
+  int64_t const deadline = time_now_us() + (int64_t)timeout_ms * 1000;
+  for(;;){
+    pump(c);
+    if(c->len == 0 && c->awaiting == 0)
+      return true;
+
+    int64_t const now = time_now_us();
+    if(now >= deadline)
+      return false;
+
+    if(c->state == REDIS_DISCONNECTED){
+      int64_t const wait_us = c->retry_us < deadline ? c->retry_us - now : deadline - now;
+      if(wait_us > 0)
+        usleep(wait_us);
+      continue;
+    }
+
+    short const events = c->state == REDIS_CONNECTING || c->sent < c->len ? POLLOUT : POLLIN;
+    struct pollfd p = {.fd = c->fd, .events = events};
+    poll(&p, 1, (deadline - now + 999) / 1000);
+  }
+}
+
+redis_stats_t stats_redis_listener(void)
+{
+  redis_stats_t s = { .queued_records = queued_records,
+                      .dropped_records = dropped_records,
+                      .replies_ok = replies_ok,
+                      .replies_err = replies_err,
+                      .connects = connects};
+  return s;
 }
@@ -20,13 +20,56 @@
  */
 
 
+
 #ifndef REDIS_LISTENER_H
 #define REDIS_LISTENER_H
 
+/*
+ * Exports the indications to Redis streams, one stream per E2 Node and SM:
+ *   <prefix>:<mcc>:<mnc>:<nb_id>[:<cu_du_id>]:<sm>    e.g. flexric:505:1:3584:mac
+ * sm is one of mac, rlc, pdcp, slice, gtp or kpm. Every UE/radio bearer/tunnel
+ * record is one stream entry, whose fields are named as in the influx exporter.
+ *
+ * Every thread delivering indications owns a non-blocking TCP connection and
+ * pipelines its XADD commands. The commands are buffered while the connection
+ * is not writable, up to buf_sz bytes per thread; further records are dropped.
+ * The streams are trimmed with MAXLEN ~ maxlen. Replies are read and counted, 
+ * but nothing waits for them
+ */
+
+#include "lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "sm/agent_if/read/sm_ag_if_rd.h"
 
-void notify_redis_listener(sm_ag_if_rd_t const* data);
+#include <stdbool.h>
+#include <stddef.h>
 
-#endif
+typedef struct{
+  char const* ip;
+  int port;
+  char const* prefix;
+  size_t maxlen; // approximate number of entries kept per stream
+  size_t buf_sz; // bytes buffered per thread
+} redis_conf_t;
 
+typedef struct{
+  size_t queued_records;
+  size_t dropped_records; // buffer full or connection lost in the middle of a command
+  size_t replies_ok;
+  size_t replies_err;
+  size_t connects;
+} redis_stats_t;
 
+redis_conf_t default_redis_conf(void);
+
+// Only effective before the first indication
+void conf_redis_listener(redis_conf_t const* conf);
+
+void notify_redis_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data);
+
+// Waits until the records of the calling thread are written and answered.
+// Returns false on timeout
+bool flush_redis_listener(int timeout_ms);
+
+redis_stats_t stats_redis_listener(void);
+
+#endif
@@ -287,9 +287,10 @@ void print_kpm_stats(kpm_ind_data_t const* kpm)
   fputs("\n", fp);
 }
 
-void notify_stdout_listener(sm_ag_if_rd_t const* data)
+void notify_stdout_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data)
 {
   assert(data != NULL);
+  (void)id;
   if(data->type == MAC_STATS_V0)  
     print_mac_stats(&data->mac_stats.msg);
   else if (data->type == RLC_STATS_V0)
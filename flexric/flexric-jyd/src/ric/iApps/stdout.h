@@ -24,9 +24,10 @@
 #ifndef LISTENER_STDOUT_H
 #define LISTENER_STDOUT_H
 
+#include "lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "sm/agent_if/read/sm_ag_if_rd.h"
 
-void notify_stdout_listener(sm_ag_if_rd_t const* data);
+void notify_stdout_listener(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data);
 
 #endif
 
@@ -24,6 +24,7 @@
 #include "string_parser.h"
 #include "string.h"
 #include <assert.h>                                      // for assert
+#include <inttypes.h>                                    // for PRIu64
 #include <stdio.h>                                       // for snprintf
 #include "ric/iApps/../../sm/mac_sm/ie/mac_data_ie.h"    // for mac_ue_stats...
 #include "ric/iApps/../../sm/pdcp_sm/ie/pdcp_data_ie.h"  // for pdcp_radio_b...
@@ -404,6 +405,27 @@ void to_string_slice(slice_ind_msg_t const* slice, int64_t tstamp, char* out, si
     sz += strlen(temp);
   }
 
+  for(uint32_t i = 0; i < slice->len_slice_stats; ++i) {
+    fr_slice_stats_t const* st = &slice->slice_stats[i];
+
+    memset(temp, 0, sizeof(temp));
+    int rc = snprintf(temp, out_len,
+                      ",slice_stats[%u]"
+                      ",id=%u"
+                      ",dl_deadline_miss=%u"
+                      ",ul_deadline_miss=%u"
+                      ",ul_alloc_prbs=%" PRIu64,
+                      i,
+                      st->id,
+                      st->dl_deadline_miss,
+                      st->ul_deadline_miss,
+                      st->ul_alloc_prbs);
+    assert(rc < (int)max && "Not enough space in the char array to write all the data");
+
+    memcpy(out + sz, temp, strlen(temp));
+    sz += strlen(temp);
+  }
+
   char end[] = "\n";
   memcpy(out + sz, end, strlen(end));
   sz += strlen(end);
@@ -25,11 +25,13 @@
 #ifndef SUBSCRIPTION_RIC_H
 #define SUBSCRIPTION_RIC_H
 
+#include "../../lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "../../sm/agent_if/read/sm_ag_if_rd.h"
 
 typedef struct{
   char name[32];
-  void (*fp)(sm_ag_if_rd_t const* data);
+  // id is the E2 Node that sent the indication, NULL if unknown
+  void (*fp)(global_e2_node_id_t const* id, sm_ag_if_rd_t const* data);
 } subs_ric_t;
 
 
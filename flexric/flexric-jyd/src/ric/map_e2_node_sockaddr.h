@@ -57,5 +57,8 @@ sctp_info_t find_map_e2_node_sad(map_e2_node_sockaddr_t* m, global_e2_node_id_t
 
 sctp_info_t find_map_e2_node_sad(map_e2_node_sockaddr_t * m, global_e2_node_id_t const* id);
 
+// Deep copy. Free it with free_global_e2_node_id
+global_e2_node_id_t find_map_sad_e2_node(map_e2_node_sockaddr_t* m, sctp_info_t const* s);
+
 #endif
 
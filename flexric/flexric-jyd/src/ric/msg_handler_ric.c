@@ -228,7 +228,7 @@ e2ap_msg_t e2ap_msg_handle_ric(near_ric_t* ric, const e2ap_msg_t* msg)
 }
 
 static
-void publish_ind_msg(near_ric_t* ric,  uint16_t ran_func_id, sm_ag_if_rd_t* d)
+void publish_ind_msg(near_ric_t* ric, global_e2_node_id_t const* id, uint16_t ran_func_id, sm_ag_if_rd_t* d)
 {
 
   // find RIC request ID, pass the data to the assoc. SM
@@ -245,7 +245,7 @@ void publish_ind_msg(near_ric_t* ric,  uint16_t ran_func_id, sm_ag_if_rd_t* d)
     void* it_end = seq_end(arr);
     while(it != it_end){
       subs_ric_t* sub = (subs_ric_t*)it;
-      sub->fp(d);
+      sub->fp(id, d);
       it = seq_next(arr, it);
     }
     start_it = assoc_next(&ric->pub_sub, start_it);
@@ -253,8 +253,42 @@ void publish_ind_msg(near_ric_t* ric,  uint16_t ran_func_id, sm_ag_if_rd_t* d)
  
 }
 
+static
+void keyframe_req(near_ric_t* ric, global_e2_node_id_t const* id, sm_ric_t* sm, sm_ag_if_rd_e type)
+{
+  assert(ric != NULL);
+  assert(sm != NULL);
+
+  // Unknown E2 Node, e.g., indications injected through e2ap_handle_indication_ric
+  if(id == NULL)
+    return;
+
+  sm_ag_if_wr_t wr = {0};
+  if(type == MAC_STATS_V0){
+    wr.type = MAC_CTRL_REQ_V0;
+    wr.mac_ctrl.msg.action = MAC_CTRL_ACTION_KEYFRAME;
+  } else if(type == RLC_STATS_V0){
+    wr.type = RLC_CTRL_REQ_V0;
+    wr.rlc_ctrl.msg.action = RLC_CTRL_ACTION_KEYFRAME;
+  } else if(type == PDCP_STATS_V0){
+    wr.type = PDCP_CTRL_REQ_V0;
+    wr.pdcp_req_ctrl.msg.action = PDCP_CTRL_ACTION_KEYFRAME;
+  } else {
+    assert(0!=0 && "Only MAC, RLC and PDCP indications are delta coded");
+  }
+
+  control_no_ack_near_ric(ric, id, sm, &wr);
+  printf("[NEAR-RIC]: Delta coded indication without keyframe dropped. KEYFRAME requested to RAN_FUNC_ID %d\n", sm->ran_func_id);
+}
+
 // E2 -> RIC
  e2ap_msg_t e2ap_handle_indication_ric(near_ric_t* ric, const e2ap_msg_t* msg)
+{
+  return e2ap_handle_indication_e2_node_ric(ric, NULL, msg);
+}
+
+// E2 -> RIC
+ e2ap_msg_t e2ap_handle_indication_e2_node_ric(near_ric_t* ric, global_e2_node_id_t const* id, const e2ap_msg_t* msg)
 {
   assert(ric != NULL);
   assert(msg != NULL);
@@ -279,10 +313,17 @@ void publish_ind_msg(near_ric_t* ric,  uint16_t ran_func_id, sm_ag_if_rd_t* d)
   defer({ sm->alloc.free_ind_data(&d); } );
   assert(d.type == MAC_STATS_V0 || d.type == RLC_STATS_V0 || d.type == PDCP_STATS_V0 || d.type == SLICE_STATS_V0 || d.type == KPM_STATS_V0 || d.type == GTP_STATS_V0);
 
-  publish_ind_msg(ric, ran_func_id, &d);
+  if(data.keyframe_req == true)
+    keyframe_req(ric, id, sm, d.type);
+
+  // Nothing decoded, e.g., delta coded indication of a stream whose keyframe
+  // was lost. The xApps decode the indication on their own
+  if(data.dropped == false){
+    publish_ind_msg(ric, id, ran_func_id, &d);
 
-  if(d.type ==  MAC_STATS_V0 )
-    ((e2ap_msg_t*)msg)->tstamp = d.mac_stats.msg.tstamp;
+    if(d.type ==  MAC_STATS_V0 )
+      ((e2ap_msg_t*)msg)->tstamp = d.mac_stats.msg.tstamp;
+  }
 
   // Notify the iApp
 #ifndef TEST_AGENT_RIC  
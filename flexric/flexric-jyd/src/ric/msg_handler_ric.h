@@ -48,6 +48,9 @@ e2ap_msg_t e2ap_handle_subscription_delete_failure_ric(struct near_ric_s* ric, c
 // E2 -> RIC
 e2ap_msg_t e2ap_handle_indication_ric(struct near_ric_s* ric, const struct e2ap_msg_s* msg);
 
+// E2 -> RIC. The listeners receive the id of the E2 Node that sent the indication
+e2ap_msg_t e2ap_handle_indication_e2_node_ric(struct near_ric_s* ric, global_e2_node_id_t const* id, const struct e2ap_msg_s* msg);
+
 // E2 -> RIC
 e2ap_msg_t e2ap_handle_control_ack_ric(struct near_ric_s* ric, const struct e2ap_msg_s* msg);
 
@@ -48,8 +48,17 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 
 
+#define MAX_SHARDS_RIC 16
+#define SHARD_RING_CAP_RIC 1024
+
+typedef struct{
+  struct sockaddr_in addr; // must be the first member. See eq_sock_addr
+  size_t shard;
+} shard_route_ric_t;
+
 static inline
 void free_sm_ric(void* key, void* value)
 {
@@ -213,6 +222,88 @@ void init_pending_events(near_ric_t* ric)
   assert(rc == 0);
 }
 
+static
+void process_msg_shard_ric(void* ctx, sctp_msg_t* rcv)
+{
+  assert(ctx != NULL);
+  assert(rcv != NULL);
+
+  near_ric_t* ric = (near_ric_t*)ctx;
+
+  if(rcv->type == SCTP_MSG_NOTIFICATION){
+    notification_handle_ric(ric, rcv);
+    return;
+  }
+
+  assert(rcv->type == SCTP_MSG_PAYLOAD);
+
+  e2ap_msg_t msg = e2ap_msg_dec_ric(&ric->ap, rcv->ba); 
+  defer({e2ap_msg_free_ric(&ric->ap, &msg); } );
+
+  if(msg.type == E2_SETUP_REQUEST){
+    global_e2_node_id_t* id = &msg.u_msgs.e2_stp_req.id;
+    printf("Received message with id = %d, port = %d \n", id->nb_id, rcv->info.addr.sin_port);
+    e2ap_reg_sock_addr_ric(&ric->ep, id, &rcv->info);
+  }
+
+  if(msg.type == RIC_INDICATION){
+    // The shard owns the E2 Node, so it cannot be removed from the map meanwhile
+    global_e2_node_id_t id = e2ap_find_e2_node_ric(&ric->ep, &rcv->info);
+    defer({ free_global_e2_node_id(&id); } );
+    e2ap_handle_indication_e2_node_ric(ric, &id, &msg);
+    return;
+  }
+
+  e2ap_msg_t ans = e2ap_msg_handle_ric(ric, &msg);
+  defer({ e2ap_msg_free_ric(&ric->ap, &ans);} );
+
+  if(ans.type != NONE_E2_MSG_TYPE){
+
+    sctp_msg_t sctp_msg = { .info = rcv->info }; 
+
+    sctp_msg.ba = e2ap_msg_enc_ric(&ric->ap, &ans); 
+    defer({free_sctp_msg(&sctp_msg); } );
+
+    e2ap_send_sctp_msg_ric(&ric->ep, &sctp_msg);
+  }
+}
+
+// Nothing else is queued in the shard, so the batched lines are sent now
+static
+void drained_shard_ric(void* ctx)
+{
+  (void)ctx;
+  flush_influx_listener();
+}
+
+static inline
+void init_shards_ric(near_ric_t* ric, fr_args_t const* args)
+{
+  assert(ric != NULL);
+  assert(args != NULL);
+
+  // One core is left for the I/O thread
+  long const num_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t num_shards = get_conf_near_ric_shards(args);
+  if(num_shards == 0)
+    num_shards = num_cpu > 2 ? num_cpu - 1 : 1;
+  if(num_shards > MAX_SHARDS_RIC)
+    num_shards = MAX_SHARDS_RIC;
+
+  printf("[NEAR-RIC]: Number of worker shards = %zu\n", num_shards);
+
+  ric->num_shards = num_shards;
+  ric->shards = calloc(num_shards, sizeof(shard_ric_t));
+  assert(ric->shards != NULL && "Memory exhausted");
+
+  for(size_t i = 0; i < num_shards; ++i){
+    int const cpu = num_cpu > 1 ? (int)((i + 1) % num_cpu) : -1;
+    init_shard_ric(&ric->shards[i], SHARD_RING_CAP_RIC, cpu, process_msg_shard_ric, drained_shard_ric, ric);
+  }
+
+  seq_init(&ric->shard_route, sizeof(shard_route_ric_t));
+}
+
 near_ric_t* init_near_ric(fr_args_t const* args)
 {
   assert(args != NULL);
@@ -244,6 +335,8 @@ near_ric_t* init_near_ric(fr_args_t const* args)
 
   init_pending_events(ric);
 
+  init_shards_ric(ric, args);
+
   near_ric_if_t ric_if = {.type = ric};
   init_iapp_api(addr, ric_if);
 
@@ -292,6 +385,107 @@ bool eq_sock_addr(void const* m0_v, void const* m1_v)
   return true;
 }
 
+static
+uint64_t fnv1a(uint64_t h, void const* data, size_t len)
+{
+  uint8_t const* p = (uint8_t const*)data;
+  for(size_t i = 0; i < len; ++i){
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static
+size_t hash_e2_node_shard(global_e2_node_id_t const* id, size_t num_shards)
+{
+  assert(id != NULL);
+  assert(num_shards > 0);
+
+  uint64_t h = 0xcbf29ce484222325ULL;
+  h = fnv1a(h, &id->type, sizeof(id->type));
+  h = fnv1a(h, &id->plmn.mcc, sizeof(id->plmn.mcc));
+  h = fnv1a(h, &id->plmn.mnc, sizeof(id->plmn.mnc));
+  h = fnv1a(h, &id->plmn.mnc_digit_len, sizeof(id->plmn.mnc_digit_len));
+  h = fnv1a(h, &id->nb_id, sizeof(id->nb_id));
+  if(id->cu_du_id != NULL)
+    h = fnv1a(h, id->cu_du_id, sizeof(*id->cu_du_id));
+
+  return h % num_shards;
+}
+
+// Shard of an E2 Node. Only the I/O thread reads the SCTP address of a new
+// E2 Node, so all its messages follow the E2 Setup Request in the same shard
+static
+size_t route_msg_shard_ric(near_ric_t* ric, sctp_msg_t const* rcv)
+{
+  assert(ric != NULL);
+  assert(rcv != NULL);
+
+  void* it = seq_front(&ric->shard_route);
+  void* end = seq_end(&ric->shard_route);
+  it = find_if(&ric->shard_route, it, end, (struct sockaddr_in*)&rcv->info.addr, eq_sock_addr);
+  if(it != end)
+    return ((shard_route_ric_t*)it)->shard;
+
+  if(rcv->type != SCTP_MSG_PAYLOAD)
+    return 0;
+
+  // First message of an E2 Node. Only the E2 Setup Request carries its id
+  e2ap_msg_t msg = e2ap_msg_dec_ric(&ric->ap, rcv->ba); 
+  defer({e2ap_msg_free_ric(&ric->ap, &msg); } );
+
+  if(msg.type != E2_SETUP_REQUEST)
+    return 0;
+
+  shard_route_ric_t r = {.addr = rcv->info.addr, 
+                         .shard = hash_e2_node_shard(&msg.u_msgs.e2_stp_req.id, ric->num_shards) };
+  seq_push_back(&ric->shard_route, &r, sizeof(r));
+
+  return r.shard;
+}
+
+static
+void rm_route_shard_ric(near_ric_t* ric, sctp_msg_t const* rcv)
+{
+  assert(ric != NULL);
+  assert(rcv != NULL);
+
+  void* it = seq_front(&ric->shard_route);
+  void* end = seq_end(&ric->shard_route);
+  it = find_if(&ric->shard_route, it, end, (struct sockaddr_in*)&rcv->info.addr, eq_sock_addr);
+  if(it != end)
+    seq_erase(&ric->shard_route, it, seq_next(&ric->shard_route, it));
+}
+
+static
+void forward_msg_shard_ric(near_ric_t* ric, sctp_msg_t* msg)
+{
+  assert(ric != NULL);
+  assert(msg != NULL);
+
+  size_t const idx = route_msg_shard_ric(ric, msg);
+
+  // Shutdown notifications are processed after the queued messages of the E2 Node 
+  if(msg->type == SCTP_MSG_NOTIFICATION)
+    rm_route_shard_ric(ric, msg);
+
+  push_shard_ric(&ric->shards[idx], msg);
+}
+
+// Forward the messages already queued in the socket with one system call.
+// Only one batch, so that the timers are not starved
+static
+void recv_batch_shard_ric(near_ric_t* ric)
+{
+  assert(ric != NULL);
+
+  sctp_msg_t msgs[32];
+  size_t const num = e2ap_recv_msgs_ric(&ric->ep, msgs, 32);
+  for(size_t i = 0; i < num; ++i)
+    forward_msg_shard_ric(ric, &msgs[i]);
+}
+
 static inline
 bool addr_registered_or_first_msg(e2ap_msg_t* msg, seq_arr_t* arr, sctp_msg_t const* rcv)
 {
@@ -397,31 +591,10 @@ void e2_event_loop_ric(near_ric_t* ric)
     switch(e.type)
     {
       case SCTP_MSG_ARRIVED_EVENT:
+      case SCTP_CONNECTION_SHUTDOWN_EVENT: 
         {
-          defer({free_sctp_msg(&e.msg);});
-
-          e2ap_msg_t msg = e2ap_msg_dec_ric(&ric->ap, e.msg.ba); 
-          defer({e2ap_msg_free_ric(&ric->ap, &msg); } );
-
-          if(msg.type == E2_SETUP_REQUEST){
-            global_e2_node_id_t* id = &msg.u_msgs.e2_stp_req.id;
-            printf("Received message with id = %d, port = %d \n", id->nb_id, e.msg.info.addr.sin_port);
-            e2ap_reg_sock_addr_ric(&ric->ep, id, &e.msg.info);
-          }
-
-          e2ap_msg_t ans = e2ap_msg_handle_ric(ric, &msg);
-          defer({ e2ap_msg_free_ric(&ric->ap, &ans);} );
-
-          if(ans.type != NONE_E2_MSG_TYPE){
-
-            sctp_msg_t sctp_msg = { .info = e.msg.info }; 
-
-            sctp_msg.ba = e2ap_msg_enc_ric(&ric->ap, &ans); 
-            defer({free_sctp_msg(&sctp_msg); } );
-
-            e2ap_send_sctp_msg_ric(&ric->ep, &sctp_msg);
-          }
-
+          forward_msg_shard_ric(ric, &e.msg);
+          recv_batch_shard_ric(ric);
           break;
         }
       case PENDING_EVENT:
@@ -429,12 +602,6 @@ void e2_event_loop_ric(near_ric_t* ric)
           printf("Pending event timeout happened. Communication with E2 Node lost?\n");
           consume_fd(e.fd);
 
-          break;
-        }
-      case SCTP_CONNECTION_SHUTDOWN_EVENT: 
-        {
-          defer({free_sctp_msg(&e.msg);});
-          notification_handle_ric(ric, &e.msg);
           break;
         }
       case CHECK_STOP_TOKEN_EVENT:
@@ -473,6 +640,12 @@ void free_near_ric(near_ric_t* ric)
     sleep(1);
   }
 
+  // Drain the messages already forwarded to the shards
+  for(size_t i = 0; i < ric->num_shards; ++i)
+    free_shard_ric(&ric->shards[i]);
+  free(ric->shards);
+  seq_free(&ric->shard_route, NULL);
+
   e2ap_free_ep_ric(&ric->ep);
 
   free_plugin_ric(&ric->plugin); 
@@ -713,6 +886,23 @@ void control_service_near_ric(near_ric_t* ric, global_e2_node_id_t const* id, ui
   free_byte_array(ba_msg);
 }
 
+void control_no_ack_near_ric(near_ric_t* ric, global_e2_node_id_t const* id, sm_ric_t* sm, sm_ag_if_wr_t* wr)
+{
+  assert(ric != NULL);
+  assert(id != NULL);
+  assert(sm != NULL);
+  assert(wr != NULL);
+
+  ric_control_request_t ctrl_req = generate_control_request(ric, sm, wr);
+  *ctrl_req.ack_req = RIC_CONTROL_REQUEST_NO_ACK;
+
+  byte_array_t ba_msg = e2ap_enc_control_request_ric(&ric->ap, &ctrl_req); 
+  e2ap_send_bytes_ric(&ric->ep, id, ba_msg);
+
+  e2ap_free_control_request_ric(&ric->ap, &ctrl_req);
+  free_byte_array(ba_msg);
+}
+
 void load_sm_near_ric(near_ric_t* ric, const char* file_name)
 {
   assert(ric != NULL);
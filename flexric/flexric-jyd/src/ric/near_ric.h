@@ -33,6 +33,7 @@
 #include "sm/sm_ric.h"
 #include "plugin_ric.h"
 #include "map_e2_node_sockaddr.h"
+#include "shard_ric.h"
 
 //#include "../ric/iApp/iapp_if.h"
 
@@ -65,6 +66,12 @@ typedef struct near_ric_s
   bi_map_t pending; // left: fd, right: pending_event_ric_t   
   pthread_mutex_t pend_mtx;
 
+  // Worker shards. The I/O thread receives the SCTP messages and forwards
+  // them to the shard owning the E2 Node. Timers stay in the I/O thread
+  shard_ric_t* shards;
+  size_t num_shards;
+  seq_arr_t shard_route; // shard_route_ric_t. Only accessed by the I/O thread
+
   atomic_bool server_stopped;
   atomic_bool stop_token;
 } near_ric_t;
@@ -89,6 +96,10 @@ void rm_report_service_near_ric(near_ric_t* ric, global_e2_node_id_t const* id,
 
 void control_service_near_ric(near_ric_t* ric, global_e2_node_id_t const* id, uint16_t ran_func_id, const char* cmd);
 
+// Control originated in the RIC, e.g., a keyframe request. Not acknowledged by
+// the E2 Node, hence, no pending event is created
+void control_no_ack_near_ric(near_ric_t* ric, global_e2_node_id_t const* id, sm_ric_t* sm, sm_ag_if_wr_t* wr);
+
 
 // Plug-ins functions
 
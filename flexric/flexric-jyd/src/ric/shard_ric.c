@@ -0,0 +1,171 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include "shard_ric.h"
+
+#include <assert.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+
+static
+void wake_up(shard_ric_t* s)
+{
+  uint64_t const one = 1;
+  ssize_t const bytes = write(s->efd, &one, sizeof(one));
+  assert(bytes == sizeof(one));
+  (void)bytes;
+}
+
+static
+void wait_wake_up(shard_ric_t* s)
+{
+  uint64_t val = 0;
+  ssize_t const bytes = read(s->efd, &val, sizeof(val));
+  assert(bytes == sizeof(val));
+  (void)bytes;
+}
+
+static
+void* worker_thread(void* arg)
+{
+  shard_ric_t* s = (shard_ric_t*)arg;
+  size_t const mask = s->cap - 1;
+
+  if(s->cpu > -1){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(s->cpu, &set);
+    // Best effort. Containers may forbid the CPU
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+
+  while(true){
+    size_t const h = atomic_load_explicit(&s->head, memory_order_relaxed);
+    size_t const t = atomic_load_explicit(&s->tail, memory_order_acquire);
+
+    if(h != t){
+      sctp_msg_t* msg = &s->ring[h & mask];
+      s->process(s->ctx, msg);
+      free_sctp_msg(msg);
+      atomic_store_explicit(&s->head, h + 1, memory_order_release);
+      atomic_fetch_add_explicit(&s->processed, 1, memory_order_relaxed);
+      continue;
+    }
+
+    // Ring drained
+    if(s->drained != NULL)
+      s->drained(s->ctx);
+
+    if(s->stop_token == true)
+      break;
+
+    // Announce the sleep before re-checking the ring. The producer publishes
+    // the tail before reading the flag, so one of both sees the other
+    atomic_store(&s->sleeping, true);
+    if(atomic_load(&s->tail) == h && s->stop_token == false)
+      wait_wake_up(s);
+    atomic_store(&s->sleeping, false);
+  }
+
+  return NULL;
+}
+
+void init_shard_ric(shard_ric_t* s, size_t cap, int cpu, process_shard_ric_fp process, drained_shard_ric_fp drained, void* ctx)
+{
+  assert(s != NULL);
+  assert(cap > 0 && (cap & (cap - 1)) == 0 && "Capacity must be a power of two");
+  assert(process != NULL);
+
+  memset(s, 0, sizeof(shard_ric_t));
+
+  s->ring = calloc(cap, sizeof(sctp_msg_t));
+  assert(s->ring != NULL && "Memory exhausted");
+  s->cap = cap;
+
+  s->efd = eventfd(0, EFD_CLOEXEC);
+  assert(s->efd > -1);
+
+  atomic_init(&s->head, 0);
+  atomic_init(&s->tail, 0);
+  atomic_init(&s->sleeping, false);
+  atomic_init(&s->stop_token, false);
+  atomic_init(&s->processed, 0);
+
+  s->process = process;
+  s->drained = drained;
+  s->ctx = ctx;
+  s->cpu = cpu;
+
+  int const rc = pthread_create(&s->t, NULL, worker_thread, s);
+  assert(rc == 0);
+}
+
+void free_shard_ric(shard_ric_t* s)
+{
+  assert(s != NULL);
+
+  atomic_store(&s->stop_token, true);
+  wake_up(s);
+
+  int const rc = pthread_join(s->t, NULL);
+  assert(rc == 0);
+
+  // The worker drained the ring before stopping
+  assert(s->head == s->tail);
+
+  close(s->efd);
+  free(s->ring);
+}
+
+void push_shard_ric(shard_ric_t* s, sctp_msg_t* msg)
+{
+  assert(s != NULL);
+  assert(msg != NULL);
+
+  size_t const t = atomic_load_explicit(&s->tail, memory_order_relaxed);
+
+  // Backpressure. The I/O thread stops reading from the socket until the
+  // worker frees a slot
+  while(t - atomic_load_explicit(&s->head, memory_order_acquire) == s->cap){
+    if(atomic_load(&s->sleeping) == true)
+      wake_up(s);
+    sched_yield();
+  }
+
+  s->ring[t & (s->cap - 1)] = *msg;
+  atomic_store(&s->tail, t + 1);
+
+  if(atomic_load(&s->sleeping) == true)
+    wake_up(s);
+}
+
+size_t processed_shard_ric(shard_ric_t const* s)
+{
+  assert(s != NULL);
+  return atomic_load_explicit(&s->processed, memory_order_relaxed);
+}
+
@@ -0,0 +1,80 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef SHARD_NEAR_RIC_H
+#define SHARD_NEAR_RIC_H
+
+/*
+ * Worker shard of the nearRT-RIC event loop.
+ * The I/O thread owns the SCTP socket and hands every received message to
+ * the shard that owns its E2 Node, so that messages of one E2 Node are
+ * processed in arrival order while different E2 Nodes run in parallel.
+ * The handoff is a single producer / single consumer ring: the I/O thread
+ * is the only producer and the shard worker the only consumer.
+ */
+
+#include "lib/ep/sctp_msg.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*process_shard_ric_fp)(void* ctx, sctp_msg_t* msg);
+
+// Called by the worker every time its ring drains, before it sleeps
+typedef void (*drained_shard_ric_fp)(void* ctx);
+
+typedef struct{
+  pthread_t t;
+  int efd; // eventfd used to wake up the worker
+
+  // SPSC ring. cap is a power of two
+  sctp_msg_t* ring;
+  size_t cap;
+  _Alignas(64) _Atomic(size_t) head; // written by the consumer
+  _Alignas(64) _Atomic(size_t) tail; // written by the producer
+
+  atomic_bool sleeping;
+  atomic_bool stop_token;
+  atomic_size_t processed;
+
+  process_shard_ric_fp process;
+  drained_shard_ric_fp drained; // NULL if not needed
+  void* ctx;
+  int cpu;
+} shard_ric_t;
+
+// cpu < 0 does not pin the worker. drained may be NULL
+void init_shard_ric(shard_ric_t* s, size_t cap, int cpu, process_shard_ric_fp process, drained_shard_ric_fp drained, void* ctx);
+
+// Stops the worker after draining the ring
+void free_shard_ric(shard_ric_t* s);
+
+// Only called from the I/O thread. Takes ownership of msg
+void push_shard_ric(shard_ric_t* s, sctp_msg_t* msg);
+
+size_t processed_shard_ric(shard_ric_t const* s);
+
+#endif
+
@@ -25,6 +25,17 @@
 
 // Interface between the SM and the agent/server. 
 // The SM can call the functions here defined and implemented on the RAN/server to read data.
+//
+// MAC, RLC and PDCP stats: on entry, the array of the message (ue_stats or rb)
+// and its length hold the buffer of the previous indication and its capacity.
+// The RAN may fill it in place when it fits. Otherwise, it stores a newly
+// allocated array and must not free the lent one, which the SM releases.
+//
+// KPM stats: the reports are differences between samples of cumulative
+// counters, which the RAN keeps per subscription in ran_state. It is NULL at
+// the first read of a subscription, where the RAN may store a malloc()ed
+// state that the later reads update in place. The SM frees it when the
+// subscription is deleted.
 
 #include "../../mac_sm/ie/mac_data_ie.h"
 #include "../../rlc_sm/ie/rlc_data_ie.h"
@@ -28,6 +28,8 @@
 
 typedef struct{
   uint32_t ms;
+  // SM state of the subscription, e.g. of an event triggered one. NULL if none
+  void* data;
 } subscribe_timer_t;
 
 #endif
@@ -24,7 +24,9 @@
 #include "gtp_sm_id.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "enc/gtp_enc_generic.h"
 #include "dec/gtp_dec_generic.h"
@@ -53,18 +55,12 @@ sm_subs_data_t on_subscription_gtp_sm_ric(sm_ric_t const* sm_ric, const char* cm
  
   gtp_event_trigger_t ev = {0};
 
-  const int max_str_sz = 10;
-  if(strncmp(cmd, "1_ms", max_str_sz) == 0 ){
-    ev.ms = 1;
-  } else if (strncmp(cmd, "2_ms", max_str_sz) == 0 ) {
-    ev.ms = 2;
-  } else if (strncmp(cmd, "5_ms", max_str_sz) == 0 ) {
-    ev.ms = 5;
-  } else if (strncmp(cmd, "10_ms", max_str_sz) == 0 ) {
-    ev.ms = 10;
-  } else {
-    assert(0 != 0 && "Invalid input");
-  }
+  // "<period>_ms" e.g., "10_ms" or "60000_ms"
+  char* end = NULL;
+  unsigned long const ms = strtoul(cmd, &end, 10);
+  assert(end != cmd && strcmp(end, "_ms") == 0 && "Invalid input");
+  assert(ms > 0 && ms <= UINT32_MAX && "Invalid period");
+  ev.ms = ms;
   const byte_array_t ba = gtp_enc_event_trigger(&sm->enc, &ev); 
 
   sm_subs_data_t data = {0}; 
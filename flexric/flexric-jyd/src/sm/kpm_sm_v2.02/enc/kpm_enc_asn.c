@@ -352,6 +352,14 @@ byte_array_t kpm_enc_ind_msg_asn(kpm_ind_msg_t const* ind_msg)
   byte_array_t  ba = {.buf = malloc(2048), .len = 2048};
   const enum asn_transfer_syntax syntax = ATS_ALIGNED_BASIC_PER;
   asn_enc_rval_t er = asn_encode_to_buffer(NULL, syntax, &asn_DEF_E2SM_KPM_IndicationMessage, pdu, ba.buf, ba.len);
+  // Reports of many UEs do not fit. The encoder returns the size needed
+  if(er.encoded > -1 && (size_t)er.encoded > ba.len){
+    free(ba.buf);
+    ba.len = er.encoded;
+    ba.buf = malloc(ba.len);
+    assert(ba.buf != NULL && "Memory exhausted");
+    er = asn_encode_to_buffer(NULL, syntax, &asn_DEF_E2SM_KPM_IndicationMessage, pdu, ba.buf, ba.len);
+  }
   assert(er.encoded > -1 && (size_t)er.encoded <= ba.len);
   ba.len = er.encoded;
 
@@ -50,6 +50,12 @@ typedef struct{
 #endif
 } sm_kpm_agent_t;
 
+// Per subscription state. The RAN keeps in it the previous sample of the
+// counters the reports are computed from
+typedef struct{
+  void* ran_state;
+} kpm_ev_state_t;
+
 // O-RAN.WG3.E2SM-KPM-v02.02, $8.2.1.1.1
 static
 subscribe_timer_t on_subscription_kpm_sm_ag(sm_agent_t* sm_agent, const sm_subs_data_t* data)
@@ -61,7 +67,10 @@ subscribe_timer_t on_subscription_kpm_sm_ag(sm_agent_t* sm_agent, const sm_subs_
  
   kpm_event_trigger_t ev = kpm_dec_event_trigger(&sm->enc, data->len_et, data->event_trigger);
 
-  subscribe_timer_t timer = {.ms = ev.ms};
+  kpm_ev_state_t* st = calloc(1, sizeof(kpm_ev_state_t));
+  assert(st != NULL && "Memory exhausted");
+
+  subscribe_timer_t timer = {.ms = ev.ms, .data = st};
 
 // XXX: Leaving 'acd' doing nothing for the moment. We need to fix the logic upper layer and change 
 // the signature of this function
@@ -74,19 +83,26 @@ subscribe_timer_t on_subscription_kpm_sm_ag(sm_agent_t* sm_agent, const sm_subs_
 }
 
 // O-RAN.WG3.E2SM-KPM-v02.02, $8.2.1.3
-static sm_ind_data_t on_indication_kpm_sm_ag(sm_agent_t* sm_agent)
+static
+sm_ind_data_t fill_ind_kpm_sm_ag(sm_kpm_agent_t* sm, kpm_ev_state_t* st)
 {
-  assert(sm_agent != NULL);
-  sm_kpm_agent_t* sm = (sm_kpm_agent_t*)sm_agent;
+  assert(sm != NULL);
 
   sm_ind_data_t ret = {0};
 
   // Fill Indication Message  and Header
   sm_ag_if_rd_t rd_if = {0};
   rd_if.type = KPM_STATS_V0;
+  rd_if.kpm_stats.ran_state = st != NULL ? st->ran_state : NULL;
   sm->base.io.read(&rd_if); 
 
   kpm_ind_data_t* ind = &rd_if.kpm_stats;
+  // Without subscription, every read is the first one
+  if(st != NULL)
+    st->ran_state = ind->ran_state;
+  else
+    free(ind->ran_state);
+
   defer({ free_kpm_ind_hdr(&ind->hdr) ;});
   defer({ free_kpm_ind_msg(&ind->msg) ;});
 
@@ -105,6 +121,32 @@ static sm_ind_data_t on_indication_kpm_sm_ag(sm_agent_t* sm_agent)
   return ret;
 }
 
+static
+sm_ind_data_t on_indication_kpm_sm_ag(sm_agent_t* sm_agent)
+{
+  assert(sm_agent != NULL);
+  return fill_ind_kpm_sm_ag((sm_kpm_agent_t*)sm_agent, NULL);
+}
+
+static
+sm_ind_data_t on_indication_ev_kpm_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+  return fill_ind_kpm_sm_ag((sm_kpm_agent_t*)sm_agent, ev_data);
+}
+
+static
+void free_ev_data_kpm_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+
+  kpm_ev_state_t* st = (kpm_ev_state_t*)ev_data;
+  free(st->ran_state);
+  free(st);
+}
+
 static
 sm_e2_setup_t on_e2_setup_kpm_sm_ag(sm_agent_t* sm_agent)
 {
@@ -179,6 +221,8 @@ sm_agent_t *make_kpm_sm_agent(sm_io_ag_t io)
   // O-RAN E2SM 5 Procedures
   sm->base.proc.on_subscription       = on_subscription_kpm_sm_ag;
   sm->base.proc.on_indication         = on_indication_kpm_sm_ag;
+  sm->base.proc.on_indication_ev      = on_indication_ev_kpm_sm_ag;
+  sm->base.proc.free_ev_data          = free_ev_data_kpm_sm_ag;
   sm->base.proc.on_control            = NULL;
   sm->base.proc.on_ric_service_update = on_ric_service_update_kpm_sm_ag;
   sm->base.proc.on_e2_setup           = on_e2_setup_kpm_sm_ag;
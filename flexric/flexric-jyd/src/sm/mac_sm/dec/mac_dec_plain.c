@@ -29,8 +29,28 @@
 
 mac_event_trigger_t mac_dec_event_trigger_plain(size_t len, uint8_t const ev_tr[len])
 {
+  assert(len >= sizeof(uint32_t));
+
   mac_event_trigger_t ev = {0};
   memcpy(&ev.ms, ev_tr, sizeof(ev.ms));
+  if(len == sizeof(ev.ms))
+    return ev;
+
+  uint8_t const* it = ev_tr + sizeof(ev.ms);
+  memcpy(&ev.len_cond, it, sizeof(ev.len_cond));
+  it += sizeof(ev.len_cond);
+  memcpy(&ev.delta_kf, it, sizeof(ev.delta_kf));
+  it += sizeof(ev.delta_kf);
+
+  assert(ev.len_cond <= MAC_EV_MAX_COND);
+  assert(len == sizeof(ev.ms) + sizeof(ev.len_cond) + sizeof(ev.delta_kf) + ev.len_cond * sizeof(mac_ev_cond_t));
+
+  if(ev.len_cond > 0){
+    ev.cond = calloc(ev.len_cond, sizeof(mac_ev_cond_t));
+    assert(ev.cond != NULL && "Memory exhausted");
+    memcpy(ev.cond, it, ev.len_cond * sizeof(mac_ev_cond_t));
+  }
+
   return ev;
 }
 
@@ -50,6 +70,22 @@ mac_ind_hdr_t mac_dec_ind_hdr_plain(size_t len, uint8_t const ind_hdr[len])
   return ret;
 }
 
+delta_dec_e mac_dec_ind_msg_delta_plain(delta_dec_t* dec, size_t len, uint8_t const ind_msg[len], mac_ind_msg_t* out)
+{
+  assert(dec != NULL);
+  assert(out != NULL);
+  assert(dec->elm_sz == sizeof(mac_ue_stats_impl_t));
+
+  mac_ind_msg_t ret = {0};
+  void* elm = NULL;
+  delta_dec_e const rc = delta_dec_frame(dec, len, ind_msg, &elm, &ret.len_ue_stats, &ret.tstamp);
+  if(rc == DELTA_DEC_OK){
+    ret.ue_stats = elm;
+    *out = ret;
+  }
+  return rc;
+}
+
 mac_ind_msg_t mac_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len])
 {
 //  assert(len == sizeof(mac_ind_msg_t)); 
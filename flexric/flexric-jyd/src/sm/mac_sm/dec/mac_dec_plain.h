@@ -26,6 +26,7 @@
 
 #include <stddef.h>
 #include "../ie/mac_data_ie.h"
+#include "../../../util/delta_codec.h"
 
 
 mac_event_trigger_t mac_dec_event_trigger_plain(size_t len, uint8_t const ev_tr[len]);
@@ -34,7 +35,11 @@ mac_action_def_t mac_dec_action_def_plain(size_t len, uint8_t const action_def[l
 
 mac_ind_hdr_t mac_dec_ind_hdr_plain(size_t len, uint8_t const ind_hdr[len]); 
 
-mac_ind_msg_t mac_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len]); 
+mac_ind_msg_t mac_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len]);
+
+// Rebuilds the full message from a delta coded one. is_delta_frame() tells them apart.
+// out is only written if DELTA_DEC_OK is returned
+delta_dec_e mac_dec_ind_msg_delta_plain(delta_dec_t* dec, size_t len, uint8_t const ind_msg[len], mac_ind_msg_t* out); 
 
 mac_call_proc_id_t mac_dec_call_proc_id_plain(size_t len, uint8_t const call_proc_id[len]);
 
@@ -32,11 +32,30 @@ byte_array_t mac_enc_event_trigger_plain(mac_event_trigger_t const* event_trigge
   assert(event_trigger != NULL);
   byte_array_t  ba = {0};
  
+  assert(event_trigger->len_cond <= MAC_EV_MAX_COND);
+
+  // Plain periodic triggers keep the legacy layout i.e., only the period
+  size_t const len_cond = event_trigger->len_cond * sizeof(mac_ev_cond_t);
+  bool const ext = len_cond > 0 || event_trigger->delta_kf > 0;
   ba.len = sizeof(event_trigger->ms);
+  if(ext == true)
+    ba.len += sizeof(event_trigger->len_cond) + sizeof(event_trigger->delta_kf) + len_cond;
+
   ba.buf = malloc(ba.len);
   assert(ba.buf != NULL && "Memory exhausted");
 
-  memcpy(ba.buf, &event_trigger->ms, ba.len);
+  uint8_t* it = ba.buf;
+  memcpy(it, &event_trigger->ms, sizeof(event_trigger->ms));
+  it += sizeof(event_trigger->ms);
+
+  if(ext == true){
+    memcpy(it, &event_trigger->len_cond, sizeof(event_trigger->len_cond));
+    it += sizeof(event_trigger->len_cond);
+    memcpy(it, &event_trigger->delta_kf, sizeof(event_trigger->delta_kf));
+    it += sizeof(event_trigger->delta_kf);
+    if(len_cond > 0)
+      memcpy(it, event_trigger->cond, len_cond);
+  }
 
   return ba;
 }
@@ -64,31 +83,54 @@ byte_array_t mac_enc_ind_hdr_plain(mac_ind_hdr_t const* ind_hdr)
   return ba;
 }
 
-byte_array_t mac_enc_ind_msg_plain(mac_ind_msg_t const* ind_msg)
+void mac_enc_ind_msg_reuse_plain(mac_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap)
 {
   assert(ind_msg != NULL);
+  assert(ba != NULL);
+  assert(cap != NULL);
 
-  byte_array_t ba = {0};
-  const uint32_t len = sizeof(ind_msg->len_ue_stats) 
-                      + sizeof(mac_ue_stats_impl_t) * ind_msg->len_ue_stats
-                      + sizeof(ind_msg->tstamp); 
-  ba.buf = calloc(1, len); 
-  assert(ba.buf != NULL);
+  size_t const sz = sizeof(ind_msg->len_ue_stats) 
+                  + sizeof(ind_msg->ue_stats[0]) * ind_msg->len_ue_stats
+                  + sizeof(ind_msg->tstamp); 
+  reserve_byte_array(ba, cap, sz);
 
-  memcpy(ba.buf, &ind_msg->len_ue_stats, sizeof(ind_msg->len_ue_stats));
-  void* ptr = ba.buf + sizeof(ind_msg->len_ue_stats);
+  memcpy(ba->buf, &ind_msg->len_ue_stats, sizeof(ind_msg->len_ue_stats));
+  void* it = ba->buf + sizeof(ind_msg->len_ue_stats);
 
   for(uint32_t i = 0; i < ind_msg->len_ue_stats; ++i){
-    memcpy(ptr, &ind_msg->ue_stats[i], sizeof(ind_msg->ue_stats[0])); 
-    ptr += sizeof(ind_msg->ue_stats[0]);
+    memcpy(it, &ind_msg->ue_stats[i], sizeof(ind_msg->ue_stats[0])); 
+    it += sizeof(ind_msg->ue_stats[0]);
   }
 
-  memcpy(ptr, &ind_msg->tstamp, sizeof(ind_msg->tstamp));
-  ptr += sizeof(ind_msg->tstamp);
+  memcpy(it, &ind_msg->tstamp, sizeof(ind_msg->tstamp));
+  it += sizeof(ind_msg->tstamp);
+
+  assert(it == ba->buf + sz && "Mismatch of data layout");
+}
+
+uint64_t mac_delta_key_plain(void const* elm)
+{
+  assert(elm != NULL);
+  mac_ue_stats_impl_t const* ue = (mac_ue_stats_impl_t const*)elm;
+  return ue->rnti;
+}
+
+void mac_enc_ind_msg_delta_plain(delta_enc_t* enc, mac_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap)
+{
+  assert(enc != NULL);
+  assert(ind_msg != NULL);
+  assert(enc->ref.elm_sz == sizeof(mac_ue_stats_impl_t));
+
+  delta_enc_frame(enc, ind_msg->ue_stats, ind_msg->len_ue_stats, ind_msg->tstamp, ba, cap);
+}
 
-  assert(ptr == ba.buf + len && "Data layout mismacth");
+byte_array_t mac_enc_ind_msg_plain(mac_ind_msg_t const* ind_msg)
+{
+  assert(ind_msg != NULL);
 
-  ba.len = len;
+  byte_array_t ba = {0};
+  size_t cap = 0;
+  mac_enc_ind_msg_reuse_plain(ind_msg, &ba, &cap);
   return ba;
 }
 
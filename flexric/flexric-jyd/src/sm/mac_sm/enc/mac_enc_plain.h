@@ -25,6 +25,7 @@
 #define MAC_ENCRYPTION_PLAIN_H 
 
 #include "../../../util/byte_array.h"
+#include "../../../util/delta_codec.h"
 #include "../ie/mac_data_ie.h"
 
 
@@ -43,6 +44,15 @@ byte_array_t mac_enc_ind_hdr_plain(mac_ind_hdr_t const*);
 
 byte_array_t mac_enc_ind_msg_plain(mac_ind_msg_t const*); 
 
+// Same encoding as mac_enc_ind_msg_plain, written into ba, whose memory (capacity *cap) is reused across calls
+void mac_enc_ind_msg_reuse_plain(mac_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap);
+
+// Delta coded against the previous message of the stream enc. See util/delta_codec.h
+void mac_enc_ind_msg_delta_plain(delta_enc_t* enc, mac_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap);
+
+// Identifies a UE across delta coded messages
+uint64_t mac_delta_key_plain(void const* elm);
+
 byte_array_t mac_enc_call_proc_id_plain(mac_call_proc_id_t const*); 
 
 byte_array_t mac_enc_ctrl_hdr_plain(mac_ctrl_hdr_t const*); 
@@ -35,15 +35,21 @@
 void free_mac_event_trigger(mac_event_trigger_t* src)
 {
   assert(src != NULL);
-  assert(0!=0 && "Not implemented" ); 
+  free(src->cond);
+  src->cond = NULL;
+  src->len_cond = 0;
 }
 
 mac_event_trigger_t cp_mac_event_trigger( mac_event_trigger_t* src)
 {
   assert(src != NULL);
-  assert(0!=0 && "Not implemented" ); 
 
-  mac_event_trigger_t et = {0};
+  mac_event_trigger_t et = {.ms = src->ms, .delta_kf = src->delta_kf, .len_cond = src->len_cond};
+  if(src->len_cond > 0){
+    et.cond = calloc(src->len_cond, sizeof(mac_ev_cond_t));
+    assert(et.cond != NULL && "Memory exhausted");
+    memcpy(et.cond, src->cond, src->len_cond * sizeof(mac_ev_cond_t));
+  }
   return et;
 }
 
@@ -52,12 +58,19 @@ bool eq_mac_event_trigger(mac_event_trigger_t* m0, mac_event_trigger_t* m1)
   assert(m0 != NULL);
   assert(m1 != NULL);
 
-  assert(0!=0 && "Not implemented" ); 
+  if(m0->ms != m1->ms || m0->delta_kf != m1->delta_kf || m0->len_cond != m1->len_cond)
+    return false;
+
+  for(uint32_t i = 0; i < m0->len_cond; ++i){
+    if(m0->cond[i].metric != m1->cond[i].metric
+        || m0->cond[i].type != m1->cond[i].type
+        || m0->cond[i].value != m1->cond[i].value)
+      return false;
+  }
 
   return true;
 }
 
-
 //////////////////////////////////////
 // RIC Action Definition 
 /////////////////////////////////////
@@ -185,6 +198,83 @@ mac_ue_stats_impl_t cp_mac_ue_stats_impl(mac_ue_stats_impl_t const* src)
   return dst;
 }
 
+
+static
+char const* mac_ev_metric_names[MAC_EV_METRIC_END] = {
+  [MAC_EV_METRIC_DL_AGGR_TBS] = "dl_aggr_tbs",
+  [MAC_EV_METRIC_UL_AGGR_TBS] = "ul_aggr_tbs",
+  [MAC_EV_METRIC_DL_CURR_TBS] = "dl_curr_tbs",
+  [MAC_EV_METRIC_UL_CURR_TBS] = "ul_curr_tbs",
+  [MAC_EV_METRIC_DL_SCHED_RB] = "dl_sched_rb",
+  [MAC_EV_METRIC_UL_SCHED_RB] = "ul_sched_rb",
+  [MAC_EV_METRIC_PUSCH_SNR] = "pusch_snr",
+  [MAC_EV_METRIC_PUCCH_SNR] = "pucch_snr",
+  [MAC_EV_METRIC_UL_RSSI] = "ul_rssi",
+  [MAC_EV_METRIC_DL_BLER] = "dl_bler",
+  [MAC_EV_METRIC_UL_BLER] = "ul_bler",
+  [MAC_EV_METRIC_DL_AGGR_PRB] = "dl_aggr_prb",
+  [MAC_EV_METRIC_UL_AGGR_PRB] = "ul_aggr_prb",
+  [MAC_EV_METRIC_BSR] = "bsr",
+  [MAC_EV_METRIC_WB_CQI] = "wb_cqi",
+  [MAC_EV_METRIC_DL_MCS1] = "dl_mcs1",
+  [MAC_EV_METRIC_UL_MCS1] = "ul_mcs1",
+  [MAC_EV_METRIC_PHR] = "phr",
+};
+
+char const* mac_ev_metric_name(mac_ev_metric_e m)
+{
+  if(m >= MAC_EV_METRIC_END)
+    return NULL;
+  return mac_ev_metric_names[m];
+}
+
+double mac_ev_metric(mac_ue_stats_impl_t const* ue, mac_ev_metric_e m)
+{
+  assert(ue != NULL);
+
+  switch(m){
+    case MAC_EV_METRIC_DL_AGGR_TBS:
+      return ue->dl_aggr_tbs;
+    case MAC_EV_METRIC_UL_AGGR_TBS:
+      return ue->ul_aggr_tbs;
+    case MAC_EV_METRIC_DL_CURR_TBS:
+      return ue->dl_curr_tbs;
+    case MAC_EV_METRIC_UL_CURR_TBS:
+      return ue->ul_curr_tbs;
+    case MAC_EV_METRIC_DL_SCHED_RB:
+      return ue->dl_sched_rb;
+    case MAC_EV_METRIC_UL_SCHED_RB:
+      return ue->ul_sched_rb;
+    case MAC_EV_METRIC_PUSCH_SNR:
+      return ue->pusch_snr;
+    case MAC_EV_METRIC_PUCCH_SNR:
+      return ue->pucch_snr;
+    case MAC_EV_METRIC_UL_RSSI:
+      return ue->ul_rssi;
+    case MAC_EV_METRIC_DL_BLER:
+      return ue->dl_bler;
+    case MAC_EV_METRIC_UL_BLER:
+      return ue->ul_bler;
+    case MAC_EV_METRIC_DL_AGGR_PRB:
+      return ue->dl_aggr_prb;
+    case MAC_EV_METRIC_UL_AGGR_PRB:
+      return ue->ul_aggr_prb;
+    case MAC_EV_METRIC_BSR:
+      return ue->bsr;
+    case MAC_EV_METRIC_WB_CQI:
+      return ue->wb_cqi;
+    case MAC_EV_METRIC_DL_MCS1:
+      return ue->dl_mcs1;
+    case MAC_EV_METRIC_UL_MCS1:
+      return ue->ul_mcs1;
+    case MAC_EV_METRIC_PHR:
+      return ue->phr;
+    default:
+      assert(0!=0 && "Unknown metric");
+  }
+  return 0;
+}
+
 mac_ind_msg_t cp_mac_ind_msg( mac_ind_msg_t const* src)
 {
   assert(src != NULL);
@@ -39,8 +39,58 @@ extern "C" {
 // RIC Event Trigger Definition
 /////////////////////////////////////
 
+// Per UE conditions of an event triggered report
+typedef enum{
+  MAC_EV_METRIC_DL_AGGR_TBS,
+  MAC_EV_METRIC_UL_AGGR_TBS,
+  MAC_EV_METRIC_DL_CURR_TBS,
+  MAC_EV_METRIC_UL_CURR_TBS,
+  MAC_EV_METRIC_DL_SCHED_RB,
+  MAC_EV_METRIC_UL_SCHED_RB,
+  MAC_EV_METRIC_PUSCH_SNR,
+  MAC_EV_METRIC_PUCCH_SNR,
+  MAC_EV_METRIC_UL_RSSI,
+  MAC_EV_METRIC_DL_BLER,
+  MAC_EV_METRIC_UL_BLER,
+  MAC_EV_METRIC_DL_AGGR_PRB,
+  MAC_EV_METRIC_UL_AGGR_PRB,
+  MAC_EV_METRIC_BSR,
+  MAC_EV_METRIC_WB_CQI,
+  MAC_EV_METRIC_DL_MCS1,
+  MAC_EV_METRIC_UL_MCS1,
+  MAC_EV_METRIC_PHR,
+
+  MAC_EV_METRIC_END
+} mac_ev_metric_e;
+
+typedef enum{
+  MAC_EV_COND_ABOVE, // the metric rises above value
+  MAC_EV_COND_BELOW, // the metric falls below value
+  MAC_EV_COND_DELTA, // the metric moved more than value since the UE was last reported
+
+  MAC_EV_COND_END
+} mac_ev_cond_e;
+
+typedef struct{
+  mac_ev_metric_e metric;
+  mac_ev_cond_e type;
+  double value;
+} mac_ev_cond_t;
+
+#define MAC_EV_MAX_COND 8
+
 typedef struct {
+  // Report period in ms
   uint32_t ms;
+
+  // 0: every report carries all the UEs. Otherwise, reports are delta coded
+  // against the previous one, with a keyframe every delta_kf reports
+  uint32_t delta_kf;
+
+  // Optional. If present, a UE is only reported in the periods in which any
+  // of the conditions holds, and periods without such UE are not reported
+  uint32_t len_cond;
+  mac_ev_cond_t* cond;
 } mac_event_trigger_t;
 
 void free_mac_event_trigger(mac_event_trigger_t* src); 
@@ -133,6 +183,12 @@ typedef struct
 
 mac_ue_stats_impl_t cp_mac_ue_stats_impl(mac_ue_stats_impl_t const* src);
 
+// Value of the metric of an event trigger condition
+double mac_ev_metric(mac_ue_stats_impl_t const* ue, mac_ev_metric_e m);
+
+// Name of the metric, i.e. the member of mac_ue_stats_impl_t. NULL if unknown
+char const* mac_ev_metric_name(mac_ev_metric_e m);
+
 typedef struct {
   uint32_t len_ue_stats;
   mac_ue_stats_impl_t* ue_stats;
@@ -178,6 +234,10 @@ bool eq_mac_ctrl_hdr(mac_ctrl_hdr_t* m0, mac_ctrl_hdr_t* m1);
 // RIC Control Message 
 /////////////////////////////////////
 
+// Sent by the RIC when it cannot decode a delta coded indication. The next
+// delta coded indication of every subscription is a keyframe
+#define MAC_CTRL_ACTION_KEYFRAME 43
+
 typedef struct {
   uint32_t action;
 } mac_ctrl_msg_t;
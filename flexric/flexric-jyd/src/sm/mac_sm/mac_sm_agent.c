@@ -28,6 +28,8 @@
 #include "../../util/alg_ds/alg/defer.h"
 
 #include <assert.h>
+#include <math.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -45,8 +47,123 @@ typedef struct{
   static_assert(false, "No encryptioin type selected");
 #endif
 
+  // Kept across indications, so that the periodic path does not
+  // allocate once the buffers reached the size of the RAN state
+  byte_array_t ind_hdr;
+  byte_array_t ind_msg;
+  size_t cap_ind_msg;
+  mac_ue_stats_impl_t* ue_stats;
+  uint32_t cap_ue_stats;
+
+  // Keyframe requests received from the RIC. Read by the indications of the
+  // delta coded subscriptions, written by the control
+  atomic_uint kf_req;
+
 } sm_mac_agent_t;
 
+// Per UE state of an event triggered subscription. ref holds, per condition,
+// the last sample for crossing conditions and the last reported value for
+// delta conditions
+typedef struct{
+  uint32_t rnti;
+  double ref[MAC_EV_MAX_COND];
+} mac_ev_ue_t;
+
+typedef struct{
+  mac_event_trigger_t et;
+
+  // Used if et.delta_kf > 0
+  delta_enc_t delta;
+
+  // Sorted by rnti. Double buffered, swapped at every evaluation
+  mac_ev_ue_t* ue;
+  uint32_t len_ue;
+  mac_ev_ue_t* nxt;
+  uint32_t cap_ue;
+} mac_ev_state_t;
+
+static
+int cmp_mac_ev_ue(void const* m0_v, void const* m1_v)
+{
+  mac_ev_ue_t const* m0 = (mac_ev_ue_t const*)m0_v;
+  mac_ev_ue_t const* m1 = (mac_ev_ue_t const*)m1_v;
+  return (m0->rnti > m1->rnti) - (m0->rnti < m1->rnti);
+}
+
+static
+bool cond_fulfilled(mac_ev_cond_t const* c, double ref, double cur)
+{
+  switch(c->type){
+    case MAC_EV_COND_ABOVE:
+      return ref <= c->value && cur > c->value;
+    case MAC_EV_COND_BELOW:
+      return ref >= c->value && cur < c->value;
+    case MAC_EV_COND_DELTA:
+      return fabs(cur - ref) > c->value;
+    default:
+      assert(0!=0 && "Unknown condition");
+  }
+  return false;
+}
+
+// Keeps, in place, the UEs that are new or fulfill any condition and
+// updates the per UE state. UEs not present in the report are forgotten
+static
+void filter_ue_stats(mac_ev_state_t* st, mac_ind_msg_t* msg)
+{
+  assert(st != NULL);
+  assert(msg != NULL);
+
+  if(msg->len_ue_stats > st->cap_ue){
+    st->cap_ue = msg->len_ue_stats;
+    free(st->nxt);
+    st->nxt = calloc(st->cap_ue, sizeof(mac_ev_ue_t));
+    assert(st->nxt != NULL && "Memory exhausted");
+    mac_ev_ue_t* ue = realloc(st->ue, st->cap_ue * sizeof(mac_ev_ue_t));
+    assert(ue != NULL && "Memory exhausted");
+    st->ue = ue;
+  }
+
+  uint32_t const len_cond = st->et.len_cond;
+  uint32_t len = 0;
+  for(uint32_t i = 0; i < msg->len_ue_stats; ++i){
+    mac_ue_stats_impl_t const* ue = &msg->ue_stats[i];
+    mac_ev_ue_t key = {.rnti = ue->rnti};
+    mac_ev_ue_t const* prev = bsearch(&key, st->ue, st->len_ue, sizeof(mac_ev_ue_t), cmp_mac_ev_ue);
+
+    mac_ev_ue_t* dst = &st->nxt[i];
+    dst->rnti = ue->rnti;
+
+    bool report = prev == NULL;
+    for(uint32_t j = 0; j < len_cond; ++j){
+      dst->ref[j] = mac_ev_metric(ue, st->et.cond[j].metric);
+      if(report == false)
+        report = cond_fulfilled(&st->et.cond[j], prev->ref[j], dst->ref[j]);
+    }
+
+    if(report == true){
+      if(len != i)
+        msg->ue_stats[len] = *ue;
+      ++len;
+    } else {
+      // Not reported. Deltas are measured against the last reported value
+      for(uint32_t j = 0; j < len_cond; ++j){
+        if(st->et.cond[j].type == MAC_EV_COND_DELTA)
+          dst->ref[j] = prev->ref[j];
+      }
+    }
+  }
+
+  qsort(st->nxt, msg->len_ue_stats, sizeof(mac_ev_ue_t), cmp_mac_ev_ue);
+
+  mac_ev_ue_t* tmp = st->ue;
+  st->ue = st->nxt;
+  st->nxt = tmp;
+  st->len_ue = msg->len_ue_stats;
+
+  msg->len_ue_stats = len;
+}
+
 
 // Function pointers provided by the RAN for the 
 // 5 procedures, 
@@ -64,6 +181,20 @@ subscribe_timer_t  on_subscription_mac_sm_ag(sm_agent_t* sm_agent, const sm_subs
   mac_event_trigger_t ev = mac_dec_event_trigger(&sm->enc, data->len_et, data->event_trigger);
 
   subscribe_timer_t timer = {.ms = ev.ms };
+  if(ev.len_cond == 0 && ev.delta_kf == 0)
+    return timer;
+
+  mac_ev_state_t* st = calloc(1, sizeof(mac_ev_state_t));
+  assert(st != NULL && "Memory exhausted");
+  st->et = ev;
+  if(ev.delta_kf > 0){
+#ifdef PLAIN
+    init_delta_enc(&st->delta, sizeof(mac_ue_stats_impl_t), ev.delta_kf, mac_delta_key_plain);
+#else
+    assert(0!=0 && "Delta coded reports only supported by the plain encoding");
+#endif
+  }
+  timer.data = st;
   return timer;
 //  const sm_wr_if_t wr = {.type = SUBSCRIBE_TIMER, .sub_timer = timer };
 
@@ -73,40 +204,55 @@ subscribe_timer_t  on_subscription_mac_sm_ag(sm_agent_t* sm_agent, const sm_subs
 }
 
 static
-sm_ind_data_t on_indication_mac_sm_ag(sm_agent_t* sm_agent)
+sm_ind_data_t fill_ind_mac_sm_ag(sm_mac_agent_t* sm, mac_ev_state_t* st)
 {
-  //printf("on_indication called \n");
-
-  assert(sm_agent != NULL);
-  sm_mac_agent_t* sm = (sm_mac_agent_t*)sm_agent;
+  assert(sm != NULL);
 
   sm_ind_data_t ret = {0};
+  ret.sm_owned = true;
 
-  // Fill Indication Header
-  mac_ind_hdr_t hdr = {.dummy = 0 };
-  byte_array_t ba_hdr = mac_enc_ind_hdr(&sm->enc, &hdr );
-  ret.ind_hdr = ba_hdr.buf;
-  ret.len_hdr = ba_hdr.len;
+  // Fill Indication Header. Constant, encoded once at creation
+  ret.ind_hdr = sm->ind_hdr.buf;
+  ret.len_hdr = sm->ind_hdr.len;
 
   // Fill Indication Message 
-  
   sm_ag_if_rd_t rd_if = {0};
-
   rd_if.type = MAC_STATS_V0;
-  // This may allocate memory by the RAN
+
+  // Lend the array of the previous indication to the RAN, which fills it in
+  // place if its capacity suffices. Otherwise, the RAN allocates a new one
+  mac_ind_data_t* ind = &rd_if.mac_stats;
+  ind->msg.ue_stats = sm->ue_stats;
+  ind->msg.len_ue_stats = sm->cap_ue_stats;
   sm->base.io.read(&rd_if);
-  // Liberate the memory if previously allocated by the RAN. It sucks
-//  defer({ free_sm_rd_if(&rd_if); }; );
-    mac_ind_data_t* ind = &rd_if.mac_stats;
+
   defer({ free_mac_ind_hdr(&ind->hdr) ;});
-  defer({ free_mac_ind_msg(&ind->msg) ;});
   defer({ free_mac_call_proc_id(ind->proc_id);});
-
-
-  byte_array_t ba = mac_enc_ind_msg(&sm->enc, &rd_if.mac_stats.msg);
-
-  ret.ind_msg = ba.buf;
-  ret.len_msg = ba.len;
+  if(ind->msg.ue_stats != sm->ue_stats){
+    free(sm->ue_stats);
+    sm->ue_stats = ind->msg.ue_stats;
+    sm->cap_ue_stats = ind->msg.len_ue_stats;
+  }
+
+  if(st != NULL && st->et.len_cond > 0){
+    filter_ue_stats(st, &ind->msg);
+    // Nothing to report. Not even encoded
+    if(ind->msg.len_ue_stats == 0)
+      return ret;
+  }
+
+#ifdef PLAIN
+  if(st != NULL && st->et.delta_kf > 0){
+    req_keyframe_delta_enc(&st->delta, atomic_load(&sm->kf_req));
+    mac_enc_ind_msg_delta_plain(&st->delta, &ind->msg, &sm->ind_msg, &sm->cap_ind_msg);
+  } else
+    mac_enc_ind_msg_reuse_plain(&ind->msg, &sm->ind_msg, &sm->cap_ind_msg);
+#else
+  free_byte_array(sm->ind_msg);
+  sm->ind_msg = mac_enc_ind_msg(&sm->enc, &ind->msg);
+#endif
+  ret.ind_msg = sm->ind_msg.buf;
+  ret.len_msg = sm->ind_msg.len;
 
   // Fill the optional Call Process ID
   ret.call_process_id = NULL;
@@ -115,6 +261,37 @@ sm_ind_data_t on_indication_mac_sm_ag(sm_agent_t* sm_agent)
   return ret;
 }
 
+static
+sm_ind_data_t on_indication_mac_sm_ag(sm_agent_t* sm_agent)
+{
+  //printf("on_indication called \n");
+  assert(sm_agent != NULL);
+  return fill_ind_mac_sm_ag((sm_mac_agent_t*)sm_agent, NULL);
+}
+
+static
+sm_ind_data_t on_indication_ev_mac_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+  return fill_ind_mac_sm_ag((sm_mac_agent_t*)sm_agent, ev_data);
+}
+
+static
+void free_ev_data_mac_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+
+  mac_ev_state_t* st = (mac_ev_state_t*)ev_data;
+  if(st->et.delta_kf > 0)
+    free_delta_enc(&st->delta);
+  free_mac_event_trigger(&st->et);
+  free(st->ue);
+  free(st->nxt);
+  free(st);
+}
+
 static
  sm_ctrl_out_data_t on_control_mac_sm_ag(sm_agent_t* sm_agent, sm_ctrl_req_data_t const* data)
 {
@@ -126,7 +303,14 @@ static
   assert(hdr.dummy == 0 && "Only dummy == 0 supported ");
 
   mac_ctrl_msg_t msg = mac_dec_ctrl_msg(&sm->enc, data->len_msg, data->ctrl_msg);
-  assert(msg.action == 42 && "Only action number 42 supported");
+  assert((msg.action == 42 || msg.action == MAC_CTRL_ACTION_KEYFRAME) && "Only action numbers 42 and 43 supported");
+
+  if(msg.action == MAC_CTRL_ACTION_KEYFRAME){
+    // Served by the delta encoders. The RAN is not involved
+    atomic_fetch_add(&sm->kf_req, 1);
+    sm_ctrl_out_data_t ret = {0};
+    return ret;
+  }
 
   sm_ag_if_wr_t wr = {.type = MAC_CTRL_REQ_V0 };
   wr.mac_ctrl.hdr.dummy = 0;
@@ -174,6 +358,9 @@ void free_mac_sm_ag(sm_agent_t* sm_agent)
 {
   assert(sm_agent != NULL);
   sm_mac_agent_t* sm = (sm_mac_agent_t*)sm_agent;
+  free_byte_array(sm->ind_hdr);
+  free_byte_array(sm->ind_msg);
+  free(sm->ue_stats);
   free(sm);
 }
 
@@ -182,6 +369,7 @@ sm_agent_t* make_mac_sm_agent(sm_io_ag_t io)
 {
   sm_mac_agent_t* sm = calloc(1, sizeof(sm_mac_agent_t));
   assert(sm != NULL && "Memory exhausted!!!");
+  atomic_init(&sm->kf_req, 0);
 
 
   sm->base.io = io;
@@ -189,11 +377,16 @@ sm_agent_t* make_mac_sm_agent(sm_io_ag_t io)
 
   sm->base.proc.on_subscription = on_subscription_mac_sm_ag;
   sm->base.proc.on_indication = on_indication_mac_sm_ag;
+  sm->base.proc.on_indication_ev = on_indication_ev_mac_sm_ag;
+  sm->base.proc.free_ev_data = free_ev_data_mac_sm_ag;
   sm->base.proc.on_control = on_control_mac_sm_ag;
   sm->base.proc.on_ric_service_update = on_ric_service_update_mac_sm_ag;
   sm->base.proc.on_e2_setup = on_e2_setup_mac_sm_ag;
   sm->base.handle = NULL;
 
+  mac_ind_hdr_t hdr = {.dummy = 0 };
+  sm->ind_hdr = mac_enc_ind_hdr(&sm->enc, &hdr);
+
   *(uint16_t*)(&sm->base.ran_func_id) = SM_MAC_ID; 
   assert(strlen( SM_MAC_STR ) < sizeof(sm->base.ran_func_name));
   memcpy(sm->base.ran_func_name, SM_MAC_STR, strlen(SM_MAC_STR));
@@ -25,7 +25,9 @@
 #include "mac_sm_id.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "enc/mac_enc_generic.h"
 #include "dec/mac_dec_generic.h"
@@ -39,12 +41,75 @@ typedef struct{
   mac_enc_fb_t enc;
 #elif PLAIN
   mac_enc_plain_t enc;
+  // Full messages of the delta coded streams
+  delta_dec_t delta;
 #else
   static_assert(false, "No encryption type selected");
 #endif
 } sm_mac_ric_t;
 
 
+static
+mac_ev_metric_e parse_mac_ev_metric(const char* str, size_t len)
+{
+  for(int i = 0; i < MAC_EV_METRIC_END; ++i){
+    char const* name = mac_ev_metric_name(i);
+    if(strlen(name) == len && strncmp(str, name, len) == 0)
+      return i;
+  }
+  assert(0 != 0 && "Unknown MAC metric in event trigger");
+  return MAC_EV_METRIC_END;
+}
+
+// Subscription command syntax:
+// "<period>_ms[,delta=<keyframe period>][,<metric><op><value>]*" where op is
+// '>' (crosses above), '<' (crosses below) or '~' (changed by more than value
+// since last report) e.g., "10_ms", "1000_ms,wb_cqi<7,dl_bler~0.05" or
+// "10_ms,delta=100"
+static
+mac_event_trigger_t parse_mac_event_trigger(const char* cmd)
+{
+  mac_event_trigger_t ev = {0};
+
+  char* end = NULL;
+  unsigned long const ms = strtoul(cmd, &end, 10);
+  assert(end != cmd && strncmp(end, "_ms", 3) == 0 && "Invalid input");
+  assert(ms > 0 && ms <= UINT32_MAX && "Invalid period");
+  ev.ms = ms;
+
+  char const* it = end + 3;
+  if(strncmp(it, ",delta=", 7) == 0){
+    it += 7;
+    unsigned long const kf = strtoul(it, &end, 10);
+    assert(end != it && kf > 0 && kf <= UINT32_MAX && "Invalid keyframe period");
+    ev.delta_kf = kf;
+    it = end;
+  }
+
+  while(*it == ','){
+    ++it;
+    char const* op = strpbrk(it, "<>~");
+    assert(op != NULL && "Invalid condition. Expected <metric><op><value>");
+    assert(ev.len_cond < MAC_EV_MAX_COND && "Too many conditions");
+
+    mac_ev_cond_t* c = realloc(ev.cond, (ev.len_cond + 1) * sizeof(mac_ev_cond_t));
+    assert(c != NULL && "Memory exhausted");
+    ev.cond = c;
+
+    mac_ev_cond_t* dst = &ev.cond[ev.len_cond];
+    dst->metric = parse_mac_ev_metric(it, op - it);
+    dst->type = *op == '>' ? MAC_EV_COND_ABOVE : *op == '<' ? MAC_EV_COND_BELOW : MAC_EV_COND_DELTA;
+    dst->value = strtod(op + 1, &end);
+    assert(end != op + 1 && "Invalid condition value");
+    ++ev.len_cond;
+
+    it = end;
+  }
+  assert(*it == '\0' && "Invalid input");
+
+  return ev;
+}
+
 static
 sm_subs_data_t on_subscription_mac_sm_ric(sm_ric_t const* sm_ric, const char* cmd)
 {
@@ -52,21 +117,9 @@ sm_subs_data_t on_subscription_mac_sm_ric(sm_ric_t const* sm_ric, const char* cm
   assert(cmd != NULL); 
   sm_mac_ric_t* sm = (sm_mac_ric_t*)sm_ric;  
  
-  mac_event_trigger_t ev = {0};
-
-  const int max_str_sz = 10;
-  if(strncmp(cmd, "1_ms", max_str_sz) == 0 ){
-    ev.ms = 1;
-  } else if (strncmp(cmd, "2_ms", max_str_sz) == 0 ) {
-    ev.ms = 2;
-  } else if (strncmp(cmd, "5_ms", max_str_sz) == 0 ) {
-    ev.ms = 5;
-  } else if (strncmp(cmd, "10_ms", max_str_sz) == 0 ) {
-    ev.ms = 10;
-  } else {
-    assert(0 != 0 && "Invalid input");
-  }
+  mac_event_trigger_t ev = parse_mac_event_trigger(cmd);
   const byte_array_t ba = mac_enc_event_trigger(&sm->enc, &ev); 
+  free_mac_event_trigger(&ev);
 
   sm_subs_data_t data = {0}; 
   
@@ -89,6 +142,13 @@ sm_ag_if_rd_t on_indication_mac_sm_ric(sm_ric_t const* sm_ric, sm_ind_data_t* da
   sm_mac_ric_t* sm = (sm_mac_ric_t*)sm_ric;  
 
   sm_ag_if_rd_t rd_if = {.type =  MAC_STATS_V0};
+#ifdef PLAIN
+  if(is_delta_frame(data->len_msg, data->ind_msg) == true){
+    delta_dec_e const rc = mac_dec_ind_msg_delta_plain(&sm->delta, data->len_msg, data->ind_msg, &rd_if.mac_stats.msg);
+    data->dropped = rc != DELTA_DEC_OK;
+    data->keyframe_req = rc == DELTA_DEC_KEYFRAME_REQ;
+  } else
+#endif
   rd_if.mac_stats.msg = mac_dec_ind_msg(&sm->enc, data->len_msg, data->ind_msg);
 
   return rd_if;
@@ -102,7 +162,7 @@ sm_ctrl_req_data_t ric_on_control_req_mac_sm_ric(sm_ric_t const* sm_ric, const s
   assert(data->type == MAC_CTRL_REQ_V0 );
   mac_ctrl_req_data_t const* req = &data->mac_ctrl;
   assert(req->hdr.dummy == 0);
-  assert(req->msg.action == 42);
+  assert(req->msg.action == 42 || req->msg.action == MAC_CTRL_ACTION_KEYFRAME);
 
   sm_mac_ric_t* sm = (sm_mac_ric_t*)sm_ric;  
 
@@ -159,6 +219,9 @@ void free_mac_sm_ric(sm_ric_t* sm_ric)
 {
   assert(sm_ric != NULL);
   sm_mac_ric_t* sm = (sm_mac_ric_t*)sm_ric;
+#ifdef PLAIN
+  free_delta_dec(&sm->delta);
+#endif
   free(sm);
 }
 
@@ -223,6 +286,10 @@ sm_ric_t* make_mac_sm_ric(void /* sm_io_ric_t io */)
   sm_mac_ric_t* sm = calloc(1, sizeof(sm_mac_ric_t));
   assert(sm != NULL && "Memory exhausted");
 
+#ifdef PLAIN
+  init_delta_dec(&sm->delta, sizeof(mac_ue_stats_impl_t));
+#endif
+
   *((uint16_t*)&sm->base.ran_func_id) = SM_MAC_ID; 
 
   sm->base.free_sm = free_mac_sm_ric;
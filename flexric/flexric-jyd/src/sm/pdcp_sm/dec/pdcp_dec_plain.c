@@ -29,8 +29,12 @@
 
 pdcp_event_trigger_t pdcp_dec_event_trigger_plain(size_t len, uint8_t const ev_tr[len])
 {
+  assert(len == sizeof(uint32_t) || len == 2*sizeof(uint32_t));
+
   pdcp_event_trigger_t ev = {0};
   memcpy(&ev.ms, ev_tr, sizeof(ev.ms));
+  if(len > sizeof(ev.ms))
+    memcpy(&ev.delta_kf, ev_tr + sizeof(ev.ms), sizeof(ev.delta_kf));
   return ev;
 }
 
@@ -50,6 +54,22 @@ pdcp_ind_hdr_t pdcp_dec_ind_hdr_plain(size_t len, uint8_t const ind_hdr[len])
   return ret;
 }
 
+delta_dec_e pdcp_dec_ind_msg_delta_plain(delta_dec_t* dec, size_t len, uint8_t const ind_msg[len], pdcp_ind_msg_t* out)
+{
+  assert(dec != NULL);
+  assert(out != NULL);
+  assert(dec->elm_sz == sizeof(pdcp_radio_bearer_stats_t));
+
+  pdcp_ind_msg_t ret = {0};
+  void* elm = NULL;
+  delta_dec_e const rc = delta_dec_frame(dec, len, ind_msg, &elm, &ret.len, &ret.tstamp);
+  if(rc == DELTA_DEC_OK){
+    ret.rb = elm;
+    *out = ret;
+  }
+  return rc;
+}
+
 pdcp_ind_msg_t pdcp_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len])
 {
   assert(len >= sizeof(uint32_t) + sizeof(int64_t));
@@ -33,11 +33,16 @@ byte_array_t pdcp_enc_event_trigger_plain(pdcp_event_trigger_t const* event_trig
   assert(event_trigger != NULL);
   byte_array_t  ba = {0};
  
+  // Full reports keep the legacy layout i.e., only the period
   ba.len = sizeof(event_trigger->ms);
+  if(event_trigger->delta_kf > 0)
+    ba.len += sizeof(event_trigger->delta_kf);
   ba.buf = malloc(ba.len);
   assert(ba.buf != NULL && "Memory exhausted");
 
-  memcpy(ba.buf, &event_trigger->ms, ba.len);
+  memcpy(ba.buf, &event_trigger->ms, sizeof(event_trigger->ms));
+  if(event_trigger->delta_kf > 0)
+    memcpy(ba.buf + sizeof(event_trigger->ms), &event_trigger->delta_kf, sizeof(event_trigger->delta_kf));
 
   return ba;
 }
@@ -65,36 +70,54 @@ byte_array_t pdcp_enc_ind_hdr_plain(pdcp_ind_hdr_t const* ind_hdr)
   return ba;
 }
 
-byte_array_t pdcp_enc_ind_msg_plain(pdcp_ind_msg_t const* ind_msg)
+void pdcp_enc_ind_msg_reuse_plain(pdcp_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap)
 {
   assert(ind_msg != NULL);
+  assert(ba != NULL);
+  assert(cap != NULL);
 
-  byte_array_t ba = {0};
-
-  size_t const sz = sizeof(ind_msg->len) + 
-                    sizeof(ind_msg->tstamp) +
-//                    sizeof(ind_msg->slot) +
-                    sizeof(pdcp_radio_bearer_stats_t )*ind_msg->len;
-
-  ba.buf = malloc(sz);
-  assert(ba.buf != NULL && "Memory exhausted");
-
-  memcpy(ba.buf, &ind_msg->len, sizeof(ind_msg->len) );
+  size_t const sz = sizeof(ind_msg->len) 
+                  + sizeof(ind_msg->rb[0]) * ind_msg->len
+                  + sizeof(ind_msg->tstamp); 
+  reserve_byte_array(ba, cap, sz);
 
-  void* it = ba.buf + sizeof(ind_msg->len);
+  memcpy(ba->buf, &ind_msg->len, sizeof(ind_msg->len));
+  void* it = ba->buf + sizeof(ind_msg->len);
 
-  for(uint32_t i = 0 ; i < ind_msg->len; ++i){
-    memcpy(it, &ind_msg->rb[i], sizeof(pdcp_radio_bearer_stats_t));
-    it += sizeof(pdcp_radio_bearer_stats_t);
+  for(uint32_t i = 0; i < ind_msg->len; ++i){
+    memcpy(it, &ind_msg->rb[i], sizeof(ind_msg->rb[0])); 
+    it += sizeof(ind_msg->rb[0]);
   }
 
   memcpy(it, &ind_msg->tstamp, sizeof(ind_msg->tstamp));
   it += sizeof(ind_msg->tstamp);
-//  memcpy(it, &ind_msg->slot, sizeof(ind_msg->slot));
-//  it += sizeof(ind_msg->slot);
-  assert(it == ba.buf + sz && "Mismatch of data layout" );
 
-  ba.len = sz;
+  assert(it == ba->buf + sz && "Mismatch of data layout");
+}
+
+uint64_t pdcp_delta_key_plain(void const* elm)
+{
+  assert(elm != NULL);
+  pdcp_radio_bearer_stats_t const* rb = (pdcp_radio_bearer_stats_t const*)elm;
+  return (uint64_t)rb->rnti << 8 | rb->rbid;
+}
+
+void pdcp_enc_ind_msg_delta_plain(delta_enc_t* enc, pdcp_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap)
+{
+  assert(enc != NULL);
+  assert(ind_msg != NULL);
+  assert(enc->ref.elm_sz == sizeof(pdcp_radio_bearer_stats_t));
+
+  delta_enc_frame(enc, ind_msg->rb, ind_msg->len, ind_msg->tstamp, ba, cap);
+}
+
+byte_array_t pdcp_enc_ind_msg_plain(pdcp_ind_msg_t const* ind_msg)
+{
+  assert(ind_msg != NULL);
+
+  byte_array_t ba = {0};
+  size_t cap = 0;
+  pdcp_enc_ind_msg_reuse_plain(ind_msg, &ba, &cap);
   return ba;
 }
 
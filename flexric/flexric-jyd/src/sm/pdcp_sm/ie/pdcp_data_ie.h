@@ -43,6 +43,9 @@ extern "C" {
 
 typedef struct {
   uint32_t ms;
+  // 0: every report carries all the bearers. Otherwise, reports are delta
+  // coded against the previous one, with a keyframe every delta_kf reports
+  uint32_t delta_kf;
 } pdcp_event_trigger_t;
 
 void free_pdcp_event_trigger(pdcp_event_trigger_t* src); 
@@ -153,6 +156,10 @@ bool eq_pdcp_ctrl_hdr(pdcp_ctrl_hdr_t* m0, pdcp_ctrl_hdr_t* m1);
 // RIC Control Message 
 /////////////////////////////////////
 
+// Sent by the RIC when it cannot decode a delta coded indication. The next
+// delta coded indication of every subscription is a keyframe
+#define PDCP_CTRL_ACTION_KEYFRAME 43
+
 typedef struct {
   uint32_t action;
 } pdcp_ctrl_msg_t;
@@ -44,8 +44,12 @@ size_t next_pow2(size_t x)
 
 rlc_event_trigger_t rlc_dec_event_trigger_plain(size_t len, uint8_t const ev_tr[len])
 {
+  assert(len == sizeof(uint32_t) || len == 2*sizeof(uint32_t));
+
   rlc_event_trigger_t ev = {0};
   memcpy(&ev.ms, ev_tr, sizeof(ev.ms));
+  if(len > sizeof(ev.ms))
+    memcpy(&ev.delta_kf, ev_tr + sizeof(ev.ms), sizeof(ev.delta_kf));
   return ev;
 }
 
@@ -65,6 +69,22 @@ rlc_ind_hdr_t rlc_dec_ind_hdr_plain(size_t len, uint8_t const ind_hdr[len])
   return ret;
 }
 
+delta_dec_e rlc_dec_ind_msg_delta_plain(delta_dec_t* dec, size_t len, uint8_t const ind_msg[len], rlc_ind_msg_t* out)
+{
+  assert(dec != NULL);
+  assert(out != NULL);
+  assert(dec->elm_sz == sizeof(rlc_radio_bearer_stats_t));
+
+  rlc_ind_msg_t ret = {0};
+  void* elm = NULL;
+  delta_dec_e const rc = delta_dec_frame(dec, len, ind_msg, &elm, &ret.len, &ret.tstamp);
+  if(rc == DELTA_DEC_OK){
+    ret.rb = elm;
+    *out = ret;
+  }
+  return rc;
+}
+
 rlc_ind_msg_t rlc_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len])
 {
   assert(next_pow2(len) >= sizeof(rlc_ind_msg_t) - sizeof(rlc_radio_bearer_stats_t*) && "Less bytes than the case where there are not active Radio bearers! Next pow2 trick used for aligned struct");
@@ -25,6 +25,7 @@
 
 #include <stddef.h>
 #include "../ie/rlc_data_ie.h"
+#include "../../../util/delta_codec.h"
 
 
 rlc_event_trigger_t rlc_dec_event_trigger_plain(size_t len, uint8_t const ev_tr[len]);
@@ -33,7 +34,11 @@ rlc_action_def_t rlc_dec_action_def_plain(size_t len, uint8_t const action_def[l
 
 rlc_ind_hdr_t rlc_dec_ind_hdr_plain(size_t len, uint8_t const ind_hdr[len]); 
 
-rlc_ind_msg_t rlc_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len]); 
+rlc_ind_msg_t rlc_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len]);
+
+// Rebuilds the full message from a delta coded one. is_delta_frame() tells them apart.
+// out is only written if DELTA_DEC_OK is returned
+delta_dec_e rlc_dec_ind_msg_delta_plain(delta_dec_t* dec, size_t len, uint8_t const ind_msg[len], rlc_ind_msg_t* out); 
 
 rlc_call_proc_id_t rlc_dec_call_proc_id_plain(size_t len, uint8_t const call_proc_id[len]);
 
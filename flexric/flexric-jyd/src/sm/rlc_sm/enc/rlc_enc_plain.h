@@ -25,6 +25,7 @@
 #define RLC_ENCRYPTION_PLAIN_H 
 
 #include "../../../util/byte_array.h"
+#include "../../../util/delta_codec.h"
 #include "../ie/rlc_data_ie.h"
 
 
@@ -43,6 +44,15 @@ byte_array_t rlc_enc_ind_hdr_plain(rlc_ind_hdr_t const*);
 
 byte_array_t rlc_enc_ind_msg_plain(rlc_ind_msg_t const*); 
 
+// Same encoding as rlc_enc_ind_msg_plain, written into ba, whose memory (capacity *cap) is reused across calls
+void rlc_enc_ind_msg_reuse_plain(rlc_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap);
+
+// Delta coded against the previous message of the stream enc. See util/delta_codec.h
+void rlc_enc_ind_msg_delta_plain(delta_enc_t* enc, rlc_ind_msg_t const* ind_msg, byte_array_t* ba, size_t* cap);
+
+// Identifies a bearer across delta coded messages
+uint64_t rlc_delta_key_plain(void const* elm);
+
 byte_array_t rlc_enc_call_proc_id_plain(rlc_call_proc_id_t const*); 
 
 byte_array_t rlc_enc_ctrl_hdr_plain(rlc_ctrl_hdr_t const*); 
@@ -39,6 +39,9 @@ extern "C" {
 
 typedef struct {
   uint32_t ms;
+  // 0: every report carries all the bearers. Otherwise, reports are delta
+  // coded against the previous one, with a keyframe every delta_kf reports
+  uint32_t delta_kf;
 } rlc_event_trigger_t;
 
 void free_rlc_event_trigger(rlc_event_trigger_t* src); 
@@ -192,6 +195,10 @@ bool eq_rlc_ctrl_hdr(rlc_ctrl_hdr_t* m0, rlc_ctrl_hdr_t* m1);
 /////////////////////////////////////
 
 
+// Sent by the RIC when it cannot decode a delta coded indication. The next
+// delta coded indication of every subscription is a keyframe
+#define RLC_CTRL_ACTION_KEYFRAME 43
+
 typedef struct {
   uint32_t action;
 } rlc_ctrl_msg_t;
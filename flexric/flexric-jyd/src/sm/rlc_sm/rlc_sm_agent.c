@@ -28,6 +28,7 @@
 
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -45,6 +46,18 @@ typedef struct{
   static_assert(false, "No encryption type selected");
 #endif
 
+  // Kept across indications, so that the periodic path does not
+  // allocate once the buffers reached the size of the RAN state
+  byte_array_t ind_hdr;
+  byte_array_t ind_msg;
+  size_t cap_ind_msg;
+  rlc_radio_bearer_stats_t* rb;
+  uint32_t cap_rb;
+
+  // Keyframe requests received from the RIC. Read by the indications of the
+  // delta coded subscriptions, written by the control
+  atomic_uint kf_req;
+
 } sm_rlc_agent_t;
 
 
@@ -64,39 +77,62 @@ subscribe_timer_t  on_subscription_rlc_sm_ag(sm_agent_t* sm_agent, const sm_subs
   rlc_event_trigger_t ev = rlc_dec_event_trigger(&sm->enc, data->len_et, data->event_trigger);
 
   subscribe_timer_t timer = {.ms = ev.ms };
+  if(ev.delta_kf > 0){
+#ifdef PLAIN
+    delta_enc_t* delta = calloc(1, sizeof(delta_enc_t));
+    assert(delta != NULL && "Memory exhausted");
+    init_delta_enc(delta, sizeof(rlc_radio_bearer_stats_t), ev.delta_kf, rlc_delta_key_plain);
+    timer.data = delta;
+#else
+    assert(0!=0 && "Delta coded reports only supported by the plain encoding");
+#endif
+  }
   return timer;
 }
 
 static
-sm_ind_data_t on_indication_rlc_sm_ag(sm_agent_t* sm_agent)
+sm_ind_data_t fill_ind_rlc_sm_ag(sm_rlc_agent_t* sm, delta_enc_t* delta)
 {
-//  printf("on_indication RLC called \n");
-
-  assert(sm_agent != NULL);
-  sm_rlc_agent_t* sm = (sm_rlc_agent_t*)sm_agent;
+  assert(sm != NULL);
 
   sm_ind_data_t ret = {0};
+  ret.sm_owned = true;
 
-  // Fill Indication Header
-  rlc_ind_hdr_t hdr = {.dummy = 0 };
-  byte_array_t ba_hdr = rlc_enc_ind_hdr(&sm->enc, &hdr );
-  ret.ind_hdr = ba_hdr.buf;
-  ret.len_hdr = ba_hdr.len;
+  // Fill Indication Header. Constant, encoded once at creation
+  ret.ind_hdr = sm->ind_hdr.buf;
+  ret.len_hdr = sm->ind_hdr.len;
 
   // Fill Indication Message 
   sm_ag_if_rd_t rd_if = {0};
   rd_if.type = RLC_STATS_V0;
-  sm->base.io.read(&rd_if);
 
-  // Liberate the memory if previously allocated by the RAN. It sucks
+  // Lend the array of the previous indication to the RAN, which fills it in
+  // place if its capacity suffices. Otherwise, the RAN allocates a new one
   rlc_ind_data_t* ind = &rd_if.rlc_stats;
+  ind->msg.rb = sm->rb;
+  ind->msg.len = sm->cap_rb;
+  sm->base.io.read(&rd_if);
+
   defer({ free_rlc_ind_hdr(&ind->hdr) ;});
-  defer({ free_rlc_ind_msg(&ind->msg) ;});
   defer({ free_rlc_call_proc_id(ind->proc_id);});
-
-  byte_array_t ba = rlc_enc_ind_msg(&sm->enc, &rd_if.rlc_stats.msg);
-  ret.ind_msg = ba.buf;
-  ret.len_msg = ba.len;
+  if(ind->msg.rb != sm->rb){
+    free(sm->rb);
+    sm->rb = ind->msg.rb;
+    sm->cap_rb = ind->msg.len;
+  }
+
+#ifdef PLAIN
+  if(delta != NULL){
+    req_keyframe_delta_enc(delta, atomic_load(&sm->kf_req));
+    rlc_enc_ind_msg_delta_plain(delta, &ind->msg, &sm->ind_msg, &sm->cap_ind_msg);
+  } else
+    rlc_enc_ind_msg_reuse_plain(&ind->msg, &sm->ind_msg, &sm->cap_ind_msg);
+#else
+  free_byte_array(sm->ind_msg);
+  sm->ind_msg = rlc_enc_ind_msg(&sm->enc, &ind->msg);
+#endif
+  ret.ind_msg = sm->ind_msg.buf;
+  ret.len_msg = sm->ind_msg.len;
 
   // Fill Call Process ID
   ret.call_process_id = NULL;
@@ -105,6 +141,30 @@ sm_ind_data_t on_indication_rlc_sm_ag(sm_agent_t* sm_agent)
   return ret;
 }
 
+static
+sm_ind_data_t on_indication_rlc_sm_ag(sm_agent_t* sm_agent)
+{
+  assert(sm_agent != NULL);
+  return fill_ind_rlc_sm_ag((sm_rlc_agent_t*)sm_agent, NULL);
+}
+
+static
+sm_ind_data_t on_indication_ev_rlc_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+  return fill_ind_rlc_sm_ag((sm_rlc_agent_t*)sm_agent, ev_data);
+}
+
+static
+void free_ev_data_rlc_sm_ag(sm_agent_t* sm_agent, void* ev_data)
+{
+  assert(sm_agent != NULL);
+  assert(ev_data != NULL);
+  free_delta_enc(ev_data);
+  free(ev_data);
+}
+
 static
  sm_ctrl_out_data_t on_control_rlc_sm_ag(sm_agent_t* sm_agent, sm_ctrl_req_data_t const* data)
 {
@@ -116,7 +176,14 @@ static
   assert(hdr.dummy == 0 && "Only dummy == 0 supported ");
 
   rlc_ctrl_msg_t msg = rlc_dec_ctrl_msg(&sm->enc, data->len_msg, data->ctrl_msg);
-  assert(msg.action == 42 && "Only action number 42 supported");
+  assert((msg.action == 42 || msg.action == RLC_CTRL_ACTION_KEYFRAME) && "Only action numbers 42 and 43 supported");
+
+  if(msg.action == RLC_CTRL_ACTION_KEYFRAME){
+    // Served by the delta encoders. The RAN is not involved
+    atomic_fetch_add(&sm->kf_req, 1);
+    sm_ctrl_out_data_t ret = {0};
+    return ret;
+  }
 
   sm_ag_if_wr_t wr = {.type = RLC_CTRL_REQ_V0 };
   wr.rlc_ctrl.hdr.dummy = 0; 
@@ -165,6 +232,9 @@ void free_rlc_sm_ag(sm_agent_t* sm_agent)
 {
   assert(sm_agent != NULL);
   sm_rlc_agent_t* sm = (sm_rlc_agent_t*)sm_agent;
+  free_byte_array(sm->ind_hdr);
+  free_byte_array(sm->ind_msg);
+  free(sm->rb);
   free(sm);
 }
 
@@ -173,6 +243,7 @@ sm_agent_t* make_rlc_sm_agent(sm_io_ag_t io)
 {
   sm_rlc_agent_t* sm = calloc(1, sizeof(sm_rlc_agent_t));
   assert(sm != NULL && "Memory exhausted!!!");
+  atomic_init(&sm->kf_req, 0);
 
   *(uint16_t*)(&sm->base.ran_func_id) = SM_RLC_ID; 
 
@@ -181,11 +252,16 @@ sm_agent_t* make_rlc_sm_agent(sm_io_ag_t io)
 
   sm->base.proc.on_subscription = on_subscription_rlc_sm_ag;
   sm->base.proc.on_indication = on_indication_rlc_sm_ag;
+  sm->base.proc.on_indication_ev = on_indication_ev_rlc_sm_ag;
+  sm->base.proc.free_ev_data = free_ev_data_rlc_sm_ag;
   sm->base.proc.on_control = on_control_rlc_sm_ag;
   sm->base.proc.on_ric_service_update = on_ric_service_update_rlc_sm_ag;
   sm->base.proc.on_e2_setup = on_e2_setup_rlc_sm_ag;
   sm->base.handle = NULL;
 
+  rlc_ind_hdr_t hdr = {.dummy = 0 };
+  sm->ind_hdr = rlc_enc_ind_hdr(&sm->enc, &hdr);
+
   assert(strlen(SM_RLC_STR) < sizeof( sm->base.ran_func_name) );
   memcpy(sm->base.ran_func_name, SM_RLC_STR, strlen(SM_RLC_STR)); 
 
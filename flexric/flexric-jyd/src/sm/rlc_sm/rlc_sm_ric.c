@@ -24,7 +24,9 @@
 #include "rlc_sm_id.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "enc/rlc_enc_generic.h"
 #include "dec/rlc_dec_generic.h"
@@ -38,6 +40,8 @@ typedef struct{
   rlc_enc_fb_t enc;
 #elif PLAIN
   rlc_enc_plain_t enc;
+  // Full messages of the delta coded streams
+  delta_dec_t delta;
 #else
   static_assert(false, "No encryption type selected");
 #endif
@@ -53,18 +57,21 @@ sm_subs_data_t on_subscription_rlc_sm_ric(sm_ric_t const* sm_ric, const char* cm
  
   rlc_event_trigger_t ev = {0};
 
-  const int max_str_sz = 10;
-  if(strncmp(cmd, "1_ms", max_str_sz) == 0 ){
-    ev.ms = 1;
-  } else if (strncmp(cmd, "2_ms", max_str_sz) == 0 ) {
-    ev.ms = 2;
-  } else if (strncmp(cmd, "5_ms", max_str_sz) == 0 ) {
-    ev.ms = 5;
-  } else if (strncmp(cmd, "10_ms", max_str_sz) == 0 ) {
-    ev.ms = 10;
-  } else {
-    assert(0 != 0 && "Invalid input");
+  // "<period>_ms[,delta=<keyframe period>]" e.g., "10_ms" or "10_ms,delta=100"
+  char* end = NULL;
+  unsigned long const ms = strtoul(cmd, &end, 10);
+  assert(end != cmd && strncmp(end, "_ms", 3) == 0 && "Invalid input");
+  assert(ms > 0 && ms <= UINT32_MAX && "Invalid period");
+  ev.ms = ms;
+
+  end += 3;
+  if(strncmp(end, ",delta=", 7) == 0){
+    char const* it = end + 7;
+    unsigned long const kf = strtoul(it, &end, 10);
+    assert(end != it && kf > 0 && kf <= UINT32_MAX && "Invalid keyframe period");
+    ev.delta_kf = kf;
   }
+  assert(*end == '\0' && "Invalid input");
   const byte_array_t ba = rlc_enc_event_trigger(&sm->enc, &ev); 
 
   sm_subs_data_t data = {0}; 
@@ -89,6 +96,13 @@ sm_ag_if_rd_t on_indication_rlc_sm_ric(sm_ric_t const* sm_ric, sm_ind_data_t* da
 
   sm_ag_if_rd_t rd_if = {.type = RLC_STATS_V0};
 
+#ifdef PLAIN
+  if(is_delta_frame(data->len_msg, data->ind_msg) == true){
+    delta_dec_e const rc = rlc_dec_ind_msg_delta_plain(&sm->delta, data->len_msg, data->ind_msg, &rd_if.rlc_stats.msg);
+    data->dropped = rc != DELTA_DEC_OK;
+    data->keyframe_req = rc == DELTA_DEC_KEYFRAME_REQ;
+  } else
+#endif
   rd_if.rlc_stats.msg = rlc_dec_ind_msg(&sm->enc, data->len_msg, data->ind_msg);
   rd_if.rlc_stats.hdr = rlc_dec_ind_hdr(&sm->enc, data->len_hdr, data->ind_hdr);
 
@@ -110,7 +124,7 @@ static
   assert(data->type == RLC_CTRL_REQ_V0);
   rlc_ctrl_req_data_t const* req = &data->rlc_ctrl;
   assert(req->hdr.dummy == 0);
-  assert(req->msg.action == 42);
+  assert(req->msg.action == 42 || req->msg.action == RLC_CTRL_ACTION_KEYFRAME);
 
   sm_rlc_ric_t* sm = (sm_rlc_ric_t*)sm_ric;  
 
@@ -167,6 +181,9 @@ void free_rlc_sm_ric(sm_ric_t* sm_ric)
 {
   assert(sm_ric != NULL);
   sm_rlc_ric_t* sm = (sm_rlc_ric_t*)sm_ric;
+#ifdef PLAIN
+  free_delta_dec(&sm->delta);
+#endif
   free(sm);
 }
 
@@ -226,6 +243,10 @@ sm_ric_t* make_rlc_sm_ric(void /* sm_io_ric_t io */)
   sm_rlc_ric_t* sm = calloc(1,sizeof(sm_rlc_ric_t));
   assert(sm != NULL && "Memory exhausted");
 
+#ifdef PLAIN
+  init_delta_dec(&sm->delta, sizeof(rlc_radio_bearer_stats_t));
+#endif
+
   *((uint16_t*)&sm->base.ran_func_id) = SM_RLC_ID; 
 
   sm->base.free_sm = free_rlc_sm_ric;
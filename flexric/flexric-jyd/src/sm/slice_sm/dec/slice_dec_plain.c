@@ -376,7 +376,43 @@ size_t fill_ue_slice_conf(ue_slice_conf_t* slc, uint8_t const* it)
   return sz;
 }
 
+static inline
+size_t fill_slice_stats(slice_ind_msg_t* ind, uint8_t const* it)
+{
+  assert(it != NULL);
+  assert(ind != NULL);
+
+  memcpy(&ind->len_slice_stats, it, sizeof(ind->len_slice_stats));
+  it += sizeof(ind->len_slice_stats);
+  size_t sz = sizeof(ind->len_slice_stats);
+
+  if(ind->len_slice_stats > 0){
+    ind->slice_stats = calloc(ind->len_slice_stats, sizeof(fr_slice_stats_t));
+    assert(ind->slice_stats != NULL && "memory exhausted");
+  }
+
+  for(size_t i = 0; i < ind->len_slice_stats; ++i){
+    fr_slice_stats_t* st = &ind->slice_stats[i];
+
+    memcpy(&st->id, it, sizeof(st->id));
+    it += sizeof(st->id);
+    sz += sizeof(st->id);
 
+    memcpy(&st->dl_deadline_miss, it, sizeof(st->dl_deadline_miss));
+    it += sizeof(st->dl_deadline_miss);
+    sz += sizeof(st->dl_deadline_miss);
+
+    memcpy(&st->ul_deadline_miss, it, sizeof(st->ul_deadline_miss));
+    it += sizeof(st->ul_deadline_miss);
+    sz += sizeof(st->ul_deadline_miss);
+
+    memcpy(&st->ul_alloc_prbs, it, sizeof(st->ul_alloc_prbs));
+    it += sizeof(st->ul_alloc_prbs);
+    sz += sizeof(st->ul_alloc_prbs);
+  }
+
+  return sz;
+}
 
 slice_ind_msg_t slice_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len])
 {
@@ -392,6 +428,9 @@ slice_ind_msg_t slice_dec_ind_msg_plain(size_t len, uint8_t const ind_msg[len])
   sz = fill_ue_slice_conf(&ind.ue_slice_conf, it);
   it += sz;
 
+  sz = fill_slice_stats(&ind, it);
+  it += sz;
+
   memcpy(&ind.tstamp, it, sizeof(ind.tstamp));
   it += sizeof(ind.tstamp);
 
@@ -185,6 +185,20 @@ size_t cal_ue_slice_conf(ue_slice_conf_t const* slc)
   return sz;
 }
 
+static
+size_t cal_slice_stats(slice_ind_msg_t const* ind_msg)
+{
+  assert(ind_msg != NULL);
+
+  size_t sz = sizeof(ind_msg->len_slice_stats);
+  for(size_t i = 0; i < ind_msg->len_slice_stats; ++i){
+    fr_slice_stats_t const* st = &ind_msg->slice_stats[i];
+    sz += sizeof(st->id) + sizeof(st->dl_deadline_miss) + sizeof(st->ul_deadline_miss) + sizeof(st->ul_alloc_prbs);
+  }
+
+  return sz;
+}
+
 static
 size_t cal_ind_msg_payload(slice_ind_msg_t const* ind_msg)
 {
@@ -192,9 +206,10 @@ size_t cal_ind_msg_payload(slice_ind_msg_t const* ind_msg)
 
   size_t sz_conf = cal_slice_conf(&ind_msg->slice_conf);
   size_t sz_ues = cal_ue_slice_conf(&ind_msg->ue_slice_conf);
+  size_t sz_stats = cal_slice_stats(ind_msg);
   size_t sz_tstamp = sizeof(int64_t);
 
-  return sz_conf + sz_ues + sz_tstamp;
+  return sz_conf + sz_ues + sz_stats + sz_tstamp;
 }
 
 static
@@ -339,10 +354,7 @@ size_t fill_edf(uint8_t* it, edf_slice_t* edf)
   it += sizeof(edf->len_over);
   sz += sizeof(edf->len_over);
 
-  if(edf->len_over > 0){
-    edf->over = calloc(edf->len_over, sizeof(uint32_t));
-    assert(edf->over != NULL && "Memory exhausted");
-  }
+  assert(edf->len_over == 0 || edf->over != NULL);
 
   for(size_t i = 0; i < edf->len_over; ++i){
     memcpy(it, &edf->over[i], sizeof(uint32_t));
@@ -493,6 +505,38 @@ size_t fill_ue_slice_conf(uint8_t* it, ue_slice_conf_t const* slc)
   return sz;
 }
 
+static inline
+size_t fill_slice_stats(uint8_t* it, slice_ind_msg_t const* ind_msg)
+{
+  assert(it != NULL);
+  assert(ind_msg != NULL);
+
+  memcpy(it, &ind_msg->len_slice_stats, sizeof(ind_msg->len_slice_stats));
+  it += sizeof(ind_msg->len_slice_stats);
+  size_t sz = sizeof(ind_msg->len_slice_stats);
+
+  for(size_t i = 0; i < ind_msg->len_slice_stats; ++i){
+    fr_slice_stats_t const* st = &ind_msg->slice_stats[i];
+
+    memcpy(it, &st->id, sizeof(st->id));
+    it += sizeof(st->id);
+    sz += sizeof(st->id);
+
+    memcpy(it, &st->dl_deadline_miss, sizeof(st->dl_deadline_miss));
+    it += sizeof(st->dl_deadline_miss);
+    sz += sizeof(st->dl_deadline_miss);
+
+    memcpy(it, &st->ul_deadline_miss, sizeof(st->ul_deadline_miss));
+    it += sizeof(st->ul_deadline_miss);
+    sz += sizeof(st->ul_deadline_miss);
+
+    memcpy(it, &st->ul_alloc_prbs, sizeof(st->ul_alloc_prbs));
+    it += sizeof(st->ul_alloc_prbs);
+    sz += sizeof(st->ul_alloc_prbs);
+  }
+
+  return sz;
+}
 
 byte_array_t slice_enc_ind_msg_plain(slice_ind_msg_t const* ind_msg)
 {
@@ -510,8 +554,10 @@ byte_array_t slice_enc_ind_msg_plain(slice_ind_msg_t const* ind_msg)
   size_t pos1 = fill_slice_conf(it, &ind_msg->slice_conf); 
   it += pos1;
   size_t pos2 = fill_ue_slice_conf(it, &ind_msg->ue_slice_conf);
-
   it += pos2;
+  size_t pos3 = fill_slice_stats(it, ind_msg);
+  it += pos3;
+
   // tstamp
   memcpy(it, &ind_msg->tstamp, sizeof(ind_msg->tstamp));
   it += sizeof(ind_msg->tstamp);
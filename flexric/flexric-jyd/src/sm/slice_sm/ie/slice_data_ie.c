@@ -145,6 +145,10 @@ void free_slice_ind_msg(slice_ind_msg_t* msg)
   assert(msg != NULL);
   free_slice_conf(&msg->slice_conf);
   free_ue_slice_conf(&msg->ue_slice_conf);
+  if(msg->len_slice_stats > 0){
+    assert(msg->slice_stats != NULL);
+    free(msg->slice_stats);
+  }
 }
 
 static
@@ -316,6 +320,9 @@ bool eq_edf_slice(edf_slice_t const* m0, edf_slice_t const* m1)
   assert(m0 != NULL);
   assert(m1 != NULL);
 
+  if(m0->len_over != m1->len_over)
+    return false;
+
   for(size_t i = 0; i < m0->len_over; ++i){
     if(m0->over[i] != m1->over[i])
       return false;
@@ -435,6 +442,25 @@ bool eq_ue_slice_conf(ue_slice_conf_t const* m0, ue_slice_conf_t const* m1)
   return true;
 }
 
+static
+bool eq_slice_stats(slice_ind_msg_t const* m0, slice_ind_msg_t const* m1)
+{
+  assert(m0 != NULL);
+  assert(m1 != NULL);
+
+  if(m0->len_slice_stats != m1->len_slice_stats)
+    return false;
+
+  for(size_t i = 0; i < m0->len_slice_stats; ++i){
+    if(m0->slice_stats[i].id != m1->slice_stats[i].id
+        || m0->slice_stats[i].dl_deadline_miss != m1->slice_stats[i].dl_deadline_miss
+        || m0->slice_stats[i].ul_deadline_miss != m1->slice_stats[i].ul_deadline_miss
+        || m0->slice_stats[i].ul_alloc_prbs != m1->slice_stats[i].ul_alloc_prbs)
+      return false;
+  }
+
+  return true;
+}
 
 bool eq_slice_ind_msg(slice_ind_msg_t const* m0, slice_ind_msg_t const* m1)
 {
@@ -443,6 +469,7 @@ bool eq_slice_ind_msg(slice_ind_msg_t const* m0, slice_ind_msg_t const* m1)
 
   return eq_slice_conf(&m0->slice_conf, &m1->slice_conf) 
          && eq_ue_slice_conf(&m0->ue_slice_conf, &m1->ue_slice_conf)
+         && eq_slice_stats(m0, m1)
          && m0->tstamp == m1->tstamp;
 }
 
@@ -502,6 +529,10 @@ slice_params_t cp_slice_params(slice_params_t const* src)
       dst.u.edf.guaranteed_prbs = src->u.edf.guaranteed_prbs;
       dst.u.edf.max_replenish = src->u.edf.max_replenish;
       dst.u.edf.len_over = src->u.edf.len_over;
+      if(src->u.edf.len_over > 0){
+        dst.u.edf.over = calloc(src->u.edf.len_over, sizeof(uint32_t));
+        assert(dst.u.edf.over != NULL && "memory exhausted");
+      }
       for(size_t i = 0; i < src->u.edf.len_over; ++i)
         dst.u.edf.over[i] = src->u.edf.over[i];
   } else {
@@ -620,6 +651,14 @@ slice_ind_msg_t cp_slice_ind_msg(slice_ind_msg_t const* src)
 
   out.slice_conf = cp_slice_conf(&src->slice_conf);
   out.ue_slice_conf = cp_ue_slice_conf(&src->ue_slice_conf);
+
+  out.len_slice_stats = src->len_slice_stats;
+  if(src->len_slice_stats > 0){
+    out.slice_stats = calloc(src->len_slice_stats, sizeof(fr_slice_stats_t));
+    assert(out.slice_stats != NULL && "memory exhausted");
+    memcpy(out.slice_stats, src->slice_stats, src->len_slice_stats*sizeof(fr_slice_stats_t));
+  }
+
   out.tstamp = src->tstamp;
 
   assert(eq_slice_ind_msg(src, &out) );
@@ -316,9 +316,23 @@ typedef struct{
 } ue_slice_conf_t;
 
 
+// Per-slice runtime counters. Deadline misses are only meaningful for
+// deadline-aware algorithms (EDF, SCN19) and remain 0 otherwise.
+// DL and UL slices with the same id share the same entry.
+typedef struct{
+  uint32_t id;
+  uint32_t dl_deadline_miss;
+  uint32_t ul_deadline_miss;
+  uint64_t ul_alloc_prbs; // PUSCH PRBs allocated to the slice since it was created
+} fr_slice_stats_t;
+
 typedef struct {
   slice_conf_t slice_conf;
   ue_slice_conf_t ue_slice_conf;
+
+  uint32_t len_slice_stats;
+  fr_slice_stats_t* slice_stats;
+
   int64_t tstamp;
 } slice_ind_msg_t;
 
@@ -39,6 +39,12 @@ typedef struct{
 
   sm_ind_data_t (*on_indication)(sm_agent_t* sm);
 
+  // Optional. Event triggered subscriptions i.e., subscribe_timer_t.data != NULL.
+  // An indication with len_msg == 0 is not sent
+  sm_ind_data_t (*on_indication_ev)(sm_agent_t* sm, void* ev_data);
+
+  void (*free_ev_data)(sm_agent_t* sm, void* ev_data);
+
   sm_ctrl_out_data_t (*on_control)(sm_agent_t* sm, sm_ctrl_req_data_t const* data);
 
   sm_e2_setup_t (*on_e2_setup)(sm_agent_t* sm);
@@ -26,6 +26,9 @@
 #include "agent_if/write/sm_ag_if_wr.h"
 #include "agent_if/ans/sm_ag_if_ans.h"
 
+#include <stdbool.h>
+#include <stdint.h>
+
 // The SM agent uses this two functions to communicate with the RAN and with the server.
 typedef struct{
 
@@ -33,6 +36,11 @@ typedef struct{
 
   sm_ag_if_ans_t (*write)(sm_ag_if_wr_t const* data);
 
+  // Optional. Called by the agent when a subscription to the SM with
+  // ran_func_id starts (active == true) and when it is deleted, with the
+  // period of its timer. Lets the RAN gather only the data that is read
+  void (*subscription)(uint16_t ran_func_id, uint32_t ms, bool active);
+
 } sm_io_ag_t;
 
 #endif
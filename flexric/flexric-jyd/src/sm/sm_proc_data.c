@@ -45,6 +45,9 @@ void free_sm_ind_data(sm_ind_data_t* data)
 {
   assert(data != NULL);
 
+  if(data->sm_owned == true)
+    return;
+
   if(data->ind_hdr != NULL){
     assert(data->len_hdr != 0);
     free(data->ind_hdr);
@@ -22,6 +22,7 @@
 #ifndef SM_PROCEDURES_DATA_H
 #define SM_PROCEDURES_DATA_H 
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -52,6 +53,16 @@ typedef struct{
 
   uint8_t* call_process_id;
   size_t len_cpid;
+
+  // The buffers belong to the SM, which reuses them for its next
+  // indication. Consumers must copy what they keep and not free them
+  bool sm_owned;
+
+  // Written by the RIC SM. The message could not be decoded (i.e., a delta
+  // coded frame of a stream without keyframe) and the returned data is empty
+  bool dropped;
+  // Written by the RIC SM. The E2 Node should be asked for a keyframe
+  bool keyframe_req;
    
 } sm_ind_data_t;
 
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2022 Mikel Irazabal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+ * Throughput of the MPSC queue against the mutex based tsq_t, with several
+ * producers and one consumer popping in batches.
+ * Usage: bench_mpsc_queue [producers] [elements per producer]
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpsc_queue.h"
+#include "../ts_queue/ts_queue.h"
+
+#define BATCH 64
+
+typedef struct{
+  uint64_t n;
+  uint8_t payload[144]; // Roughly an xApp DB element
+} val_t;
+
+typedef struct{
+  mpsc_queue_t* mpsc;
+  tsq_t* tsq;
+  size_t elm;
+} producer_arg_t;
+
+static
+int64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static
+void* producer_mpsc(void* arg)
+{
+  producer_arg_t* a = (producer_arg_t*)arg;
+  val_t v = {0};
+  for(size_t i = 0; i < a->elm; ++i){
+    v.n = i;
+    while(push_mpsc(a->mpsc, &v) == false)
+      sched_yield();
+  }
+  return NULL;
+}
+
+static
+void* producer_tsq(void* arg)
+{
+  producer_arg_t* a = (producer_arg_t*)arg;
+  val_t v = {0};
+  for(size_t i = 0; i < a->elm; ++i){
+    v.n = i;
+    push_tsq(a->tsq, &v, sizeof(v));
+  }
+  return NULL;
+}
+
+static
+double run(size_t producers, size_t elm, bool mpsc)
+{
+  mpsc_queue_t q_mpsc = {0};
+  tsq_t q_tsq = {0};
+  if(mpsc)
+    init_mpsc(&q_mpsc, 16384, sizeof(val_t));
+  else
+    init_tsq(&q_tsq, sizeof(val_t));
+
+  pthread_t* t = calloc(producers, sizeof(pthread_t));
+  assert(t != NULL);
+  producer_arg_t a = {.mpsc = &q_mpsc, .tsq = &q_tsq, .elm = elm};
+
+  int64_t const start = now_ns();
+  for(size_t i = 0; i < producers; ++i){
+    int const rc = pthread_create(&t[i], NULL, mpsc ? producer_mpsc : producer_tsq, &a);
+    assert(rc == 0);
+  }
+
+  val_t batch[BATCH];
+  size_t const total = producers * elm;
+  size_t popped = 0;
+  while(popped < total){
+    popped += mpsc ? wait_pop_n_mpsc(&q_mpsc, batch, BATCH, 10)
+                   : pop_n_tsq(&q_tsq, batch, BATCH, 10);
+  }
+  int64_t const elapsed = now_ns() - start;
+
+  for(size_t i = 0; i < producers; ++i)
+    pthread_join(t[i], NULL);
+  free(t);
+
+  if(mpsc){
+    free_mpsc(&q_mpsc, NULL);
+  } else {
+    // free_tsq waits for a consumer to acknowledge the stop
+    q_tsq.stopped = true;
+    free_tsq(&q_tsq, NULL);
+  }
+
+  return (double)total * 1000.0 / elapsed; // Millions of elements per second
+}
+
+int main(int argc, char* argv[])
+{
+  size_t const producers = argc > 1 ? strtoul(argv[1], NULL, 10) : 4;
+  size_t const elm = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+  assert(producers > 0 && elm > 0);
+
+  printf("%zu producers, %zu elements each, batch %d\n", producers, elm, BATCH);
+  printf("tsq_t        : %8.2f Melem/s\n", run(producers, elm, false));
+  printf("mpsc_queue_t : %8.2f Melem/s\n", run(producers, elm, true));
+
+  return 0;
+}
+
@@ -0,0 +1,228 @@
+/*
+MIT License
+
+Copyright (c) 2022 Mikel Irazabal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "mpsc_queue.h"
+
+typedef struct{
+  _Atomic(size_t) seq;
+} cell_hdr_t;
+
+static
+size_t next_pow_2(size_t v)
+{
+  size_t p = 1;
+  while(p < v)
+    p <<= 1;
+  return p;
+}
+
+static inline
+cell_hdr_t* cell_at(mpsc_queue_t* q, size_t pos)
+{
+  return (cell_hdr_t*)(q->cells + (pos & (q->cap - 1))*q->cell_sz);
+}
+
+static inline
+void* cell_data(cell_hdr_t* c)
+{
+  return (uint8_t*)c + sizeof(cell_hdr_t);
+}
+
+void init_mpsc(mpsc_queue_t* q, size_t cap, size_t elm_sz)
+{
+  assert(q != NULL);
+  assert(cap > 1);
+  assert(elm_sz > 0);
+
+  q->cap = next_pow_2(cap);
+  q->elm_sz = elm_sz;
+  q->cell_sz = (sizeof(cell_hdr_t) + elm_sz + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+
+  q->cells = calloc(q->cap, q->cell_sz);
+  assert(q->cells != NULL && "Memory exhausted");
+
+  for(size_t i = 0; i < q->cap; ++i)
+    atomic_init(&cell_at(q, i)->seq, i);
+
+  q->efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  assert(q->efd > -1);
+
+  atomic_init(&q->tail, 0);
+  atomic_init(&q->head, 0);
+  atomic_init(&q->sleeping, false);
+  atomic_init(&q->stop_token, false);
+}
+
+void free_mpsc(mpsc_queue_t* q, void (*f)(void*))
+{
+  assert(q != NULL);
+
+  if(f != NULL){
+    uint8_t* tmp = malloc(q->elm_sz);
+    assert(tmp != NULL && "Memory exhausted");
+    while(pop_n_mpsc(q, tmp, 1) == 1)
+      f(tmp);
+    free(tmp);
+  }
+
+  int const rc = close(q->efd);
+  assert(rc == 0);
+
+  free(q->cells);
+}
+
+static
+void wake_consumer(mpsc_queue_t* q)
+{
+  // Pairs with the fence in wait_pop_n_mpsc. Either the consumer sees the
+  // new element while re-checking, or we see it sleeping
+  atomic_thread_fence(memory_order_seq_cst);
+  if(atomic_load_explicit(&q->sleeping, memory_order_relaxed) == false)
+    return;
+
+  if(atomic_exchange(&q->sleeping, false) == true){
+    uint64_t const one = 1;
+    ssize_t const rc = write(q->efd, &one, sizeof(one));
+    assert(rc == sizeof(one) || errno == EAGAIN);
+  }
+}
+
+bool push_mpsc(mpsc_queue_t* q, void const* val)
+{
+  assert(q != NULL);
+  assert(val != NULL);
+
+  cell_hdr_t* c = NULL;
+  size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  while(true){
+    c = cell_at(q, pos);
+    size_t const seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    intptr_t const dif = (intptr_t)seq - (intptr_t)pos;
+    if(dif == 0){
+      if(atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+        break;
+    } else if(dif < 0){
+      return false; // Full
+    } else {
+      pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    }
+  }
+
+  memcpy(cell_data(c), val, q->elm_sz);
+  atomic_store_explicit(&c->seq, pos + 1, memory_order_release);
+
+  wake_consumer(q);
+  return true;
+}
+
+size_t pop_n_mpsc(mpsc_queue_t* q, void* out, size_t max)
+{
+  assert(q != NULL);
+  assert(out != NULL);
+
+  size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  size_t n = 0;
+  while(n < max){
+    cell_hdr_t* c = cell_at(q, head);
+    size_t const seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+    if(seq != head + 1)
+      break; // Empty or the producer did not publish it yet
+
+    memcpy((uint8_t*)out + n*q->elm_sz, cell_data(c), q->elm_sz);
+    atomic_store_explicit(&c->seq, head + q->cap, memory_order_release);
+    ++head;
+    ++n;
+  }
+
+  atomic_store_explicit(&q->head, head, memory_order_relaxed);
+  return n;
+}
+
+size_t wait_pop_n_mpsc(mpsc_queue_t* q, void* out, size_t max, int timeout_ms)
+{
+  assert(q != NULL);
+
+  size_t n = pop_n_mpsc(q, out, max);
+  if(n > 0 || atomic_load(&q->stop_token) == true)
+    return n;
+
+  atomic_store(&q->sleeping, true);
+  atomic_thread_fence(memory_order_seq_cst);
+
+  n = pop_n_mpsc(q, out, max);
+  if(n > 0 || atomic_load(&q->stop_token) == true){
+    atomic_store(&q->sleeping, false);
+    return n;
+  }
+
+  struct pollfd pfd = {.fd = q->efd, .events = POLLIN};
+  int rc = poll(&pfd, 1, timeout_ms);
+  assert(rc > -1 || errno == EINTR);
+  atomic_store(&q->sleeping, false);
+
+  if(rc > 0){
+    uint64_t cnt = 0;
+    ssize_t const r = read(q->efd, &cnt, sizeof(cnt));
+    assert(r == sizeof(cnt) || errno == EAGAIN);
+  }
+
+  return pop_n_mpsc(q, out, max);
+}
+
+void stop_mpsc(mpsc_queue_t* q)
+{
+  assert(q != NULL);
+
+  atomic_store(&q->stop_token, true);
+
+  uint64_t const one = 1;
+  ssize_t const rc = write(q->efd, &one, sizeof(one));
+  assert(rc == sizeof(one) || errno == EAGAIN);
+}
+
+bool stopped_mpsc(mpsc_queue_t* q)
+{
+  assert(q != NULL);
+  return atomic_load(&q->stop_token);
+}
+
+size_t size_mpsc(mpsc_queue_t* q)
+{
+  assert(q != NULL);
+
+  size_t const head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  size_t const tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  return tail > head ? tail - head : 0;
+}
+
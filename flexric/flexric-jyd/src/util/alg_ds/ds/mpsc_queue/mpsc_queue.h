@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2022 Mikel Irazabal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+/*
+ * Bounded lock-free Multi Producer Single Consumer queue. 
+ * Inspired by Dmitry Vyukov's bounded MPMC queue. Every cell carries a
+ * sequence number, so producers only contend on one CAS of the tail and
+ * the consumer never takes a lock. The consumer sleeps on an eventfd that
+ * producers only signal when it announced that it is going to sleep.
+ */
+
+#ifndef MPSC_QUEUE_MIR_H
+#define MPSC_QUEUE_MIR_H 
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct{
+  uint8_t* cells;
+  size_t cap; // Power of 2
+  size_t elm_sz;
+  size_t cell_sz;
+  int efd;
+
+  _Alignas(64) _Atomic(size_t) tail;
+  _Alignas(64) _Atomic(size_t) head;
+  _Alignas(64) atomic_bool sleeping;
+  atomic_bool stop_token;
+} mpsc_queue_t;
+
+// cap is rounded up to the next power of 2
+void init_mpsc(mpsc_queue_t* q, size_t cap, size_t elm_sz);
+
+// The consumer must have stopped. f is called for the elements left, if not NULL
+void free_mpsc(mpsc_queue_t* q, void (*f)(void*));
+
+// Copies elm_sz bytes of val. Returns false if the queue is full
+bool push_mpsc(mpsc_queue_t* q, void const* val);
+
+// Consumer only. Move at most max elements into out without blocking
+size_t pop_n_mpsc(mpsc_queue_t* q, void* out, size_t max);
+
+// Consumer only. Wait up to timeout_ms (-1 forever) for at least one element
+// and move at most max elements into out. Returns 0 on timeout or if the
+// queue was stopped and is empty
+size_t wait_pop_n_mpsc(mpsc_queue_t* q, void* out, size_t max, int timeout_ms);
+
+// Wake up the consumer. Elements already pushed can still be popped
+void stop_mpsc(mpsc_queue_t* q);
+
+bool stopped_mpsc(mpsc_queue_t* q);
+
+// Approximate, as producers may be running concurrently
+size_t size_mpsc(mpsc_queue_t* q);
+
+#endif
+
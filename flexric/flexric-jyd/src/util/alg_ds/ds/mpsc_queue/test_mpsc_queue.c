@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2022 Mikel Irazabal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mpsc_queue.h"
+
+#define NUM_PRODUCERS 4
+#define ELM_PER_PRODUCER 100000
+
+typedef struct{
+  uint32_t producer;
+  uint32_t n;
+  uint8_t payload[48];
+} val_t;
+
+static
+mpsc_queue_t q;
+
+static
+void* producer_thread(void* arg)
+{
+  uint32_t const id = *(uint32_t*)arg;
+
+  for(uint32_t i = 0; i < ELM_PER_PRODUCER; ++i){
+    val_t v = {.producer = id, .n = i};
+    while(push_mpsc(&q, &v) == false)
+      sched_yield();
+  }
+
+  return NULL;
+}
+
+static
+void test_full(void)
+{
+  mpsc_queue_t f = {0};
+  init_mpsc(&f, 5, sizeof(uint64_t));
+  assert(f.cap == 8);
+
+  for(uint64_t i = 0; i < 8; ++i)
+    assert(push_mpsc(&f, &i) == true);
+
+  uint64_t v = 0;
+  assert(push_mpsc(&f, &v) == false);
+  assert(size_mpsc(&f) == 8);
+
+  uint64_t out[4] = {0};
+  assert(pop_n_mpsc(&f, out, 4) == 4);
+  for(uint64_t i = 0; i < 4; ++i)
+    assert(out[i] == i);
+
+  // Timeout on a non-empty queue returns at once
+  assert(wait_pop_n_mpsc(&f, out, 1, 1000) == 1 && out[0] == 4);
+
+  free_mpsc(&f, NULL);
+}
+
+static
+size_t freed;
+
+static
+void count_free(void* it)
+{
+  assert(it != NULL);
+  ++freed;
+}
+
+int main()
+{
+  test_full();
+
+  init_mpsc(&q, 1024, sizeof(val_t));
+
+  // Empty queue times out
+  val_t batch[64];
+  assert(wait_pop_n_mpsc(&q, batch, 64, 1) == 0);
+
+  pthread_t t[NUM_PRODUCERS];
+  uint32_t ids[NUM_PRODUCERS];
+  for(uint32_t i = 0; i < NUM_PRODUCERS; ++i){
+    ids[i] = i;
+    int const rc = pthread_create(&t[i], NULL, producer_thread, &ids[i]);
+    assert(rc == 0);
+  }
+
+  // Elements of one producer keep their order
+  uint32_t next[NUM_PRODUCERS] = {0};
+  size_t total = 0;
+  while(total < NUM_PRODUCERS * ELM_PER_PRODUCER){
+    size_t const n = wait_pop_n_mpsc(&q, batch, 64, -1);
+    for(size_t i = 0; i < n; ++i){
+      assert(batch[i].producer < NUM_PRODUCERS);
+      assert(batch[i].n == next[batch[i].producer]);
+      next[batch[i].producer] += 1;
+    }
+    total += n;
+  }
+
+  for(uint32_t i = 0; i < NUM_PRODUCERS; ++i)
+    pthread_join(t[i], NULL);
+
+  // Stop wakes up the consumer and leaves the elements in the queue
+  val_t v = {0};
+  assert(push_mpsc(&q, &v) == true);
+  stop_mpsc(&q);
+  assert(stopped_mpsc(&q) == true);
+  assert(size_mpsc(&q) == 1);
+
+  free_mpsc(&q, count_free);
+  assert(freed == 1);
+
+  printf("MPSC queue test passed\n");
+  return 0;
+}
+
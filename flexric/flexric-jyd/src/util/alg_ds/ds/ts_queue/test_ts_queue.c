@@ -80,6 +80,61 @@ void free_value(void* it)
   free(v);
 }
 
+static
+size_t batch_popped;
+
+static
+void* batch_worker_thread(void* arg)
+{
+  tsq_t* q = (tsq_t*)arg;
+  val_t* batch = calloc(64, sizeof(val_t));
+  assert(batch != NULL);
+
+  uint32_t expected = 0;
+  while(true){
+    size_t const n = pop_n_tsq(q, batch, 64, 10);
+    if(n == 0 && q->stop_token == true)
+      break;
+
+    assert(n <= 64);
+    for(size_t i = 0; i < n; ++i){
+      assert(batch[i].n == expected);
+      ++expected;
+    }
+    batch_popped += n;
+  }
+
+  free(batch);
+  return NULL;
+}
+
+static
+void test_pop_n(void)
+{
+  tsq_t q = {0};
+  init_tsq(&q, sizeof(val_t));
+
+  // Timeout on an empty queue
+  val_t v = {0};
+  assert(pop_n_tsq(&q, &v, 1, 1) == 0);
+
+  int rc = pthread_create(&t, NULL, batch_worker_thread, &q);
+  assert(rc == 0);
+
+  for(uint32_t i = 0; i < 8192; ++i){
+    val_t v = {.n = i};
+    push_tsq(&q, &v, sizeof(val_t));
+  }
+
+  while(size_tsq(&q) > 0)
+    usleep(1000);
+
+  free_tsq(&q, free_value);
+  pthread_join(t, NULL);
+
+  assert(batch_popped == 8192);
+}
+
 int main()
 {
   tsq_t q = {0};
@@ -100,6 +155,8 @@ int main()
   free_tsq(&q, free_value );
   pthread_join(t, NULL);
 
+  test_pop_n();
+
   return 0;
 }
 
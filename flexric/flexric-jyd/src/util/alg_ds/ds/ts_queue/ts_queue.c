@@ -25,6 +25,9 @@ SOFTWARE.
 
 
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "../lock_guard/lock_guard.h"
@@ -180,6 +183,56 @@ void* pop_tsq_100(tsq_t* q, void* (*f)(void*) )
   return elm;
 }
 
+size_t pop_n_tsq(tsq_t* q, void* out, size_t max, int timeout_ms)
+{
+  assert(q != NULL);
+  assert(out != NULL);
+  assert(max > 0);
+  assert(timeout_ms >= 0);
+
+  struct timespec deadline = {0};
+  int rc = clock_gettime(CLOCK_REALTIME, &deadline);
+  assert(rc == 0);
+  deadline.tv_sec += timeout_ms / 1000;
+  deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+  if(deadline.tv_nsec >= 1000000000L){
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&q->mtx);
+
+  rc = 0;
+  while(seq_size(&q->r) == 0 && rc == 0 && q->stop_token == false) {
+    rc = pthread_cond_timedwait(&q->cv, &q->mtx, &deadline);
+  }
+
+  if(q->stop_token == true){
+    pthread_mutex_unlock(&q->mtx);
+    q->stopped = true;
+    return 0;
+  }
+
+  assert(rc == 0 || rc == ETIMEDOUT);
+
+  size_t const elt_size = q->r.elt_size;
+  void* it = seq_ring_front(&q->r);
+  void* next = it;
+  size_t n = 0;
+  while(n < max && next != seq_end(&q->r)){
+    memcpy((uint8_t*)out + n*elt_size, next, elt_size);
+    next = seq_next(&q->r, next);
+    ++n;
+  }
+
+  if(n > 0)
+    seq_erase(&q->r, it, next);
+
+  pthread_mutex_unlock(&q->mtx);
+
+  return n;
+}
+
 size_t size_tsq(tsq_t* q)
 {
   assert(q != NULL);
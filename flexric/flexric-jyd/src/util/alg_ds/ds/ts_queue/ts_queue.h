@@ -58,6 +58,11 @@ void* pop_tsq_10(tsq_t* q, void* (*f)(void*) );
 
 void* pop_tsq_100(tsq_t* q, void* (*f)(void*) );
 
+// Wait up to timeout_ms for at least one element and move at most max
+// elements into out. Returns the number of elements moved, 0 on timeout
+// or if the queue was stopped
+size_t pop_n_tsq(tsq_t* q, void* out, size_t max, int timeout_ms);
+
 size_t size_tsq(tsq_t* q);
 
 #endif
@@ -41,6 +41,21 @@ void free_byte_array(byte_array_t ba)
   free(ba.buf);
 }
 
+void reserve_byte_array(byte_array_t* ba, size_t* cap, size_t len)
+{
+  assert(ba != NULL);
+  assert(cap != NULL);
+
+  if(len > *cap){
+    size_t const new_cap = len > 2*(*cap) ? len : 2*(*cap);
+    free(ba->buf);
+    ba->buf = malloc(new_cap);
+    assert(ba->buf != NULL && "Memory exhausted");
+    *cap = new_cap;
+  }
+  ba->len = len;
+}
+
 bool eq_byte_array(const byte_array_t* m0, const byte_array_t* m1)
 {
   if(m0 == m1)
@@ -58,6 +58,10 @@ byte_array_t copy_byte_array(byte_array_t src);
 
 void free_byte_array(byte_array_t ba);
 
+/* make ba hold len bytes, reusing its memory of capacity *cap when large enough. Otherwise, the buffer grows
+ * (at least doubling) and its content is lost. Lets periodic producers encode without allocating in the steady state */
+void reserve_byte_array(byte_array_t* ba, size_t* cap, size_t len);
+
 bool eq_byte_array(const byte_array_t* m0, const byte_array_t* m1);
 
 #endif
@@ -505,3 +505,40 @@ char* get_conf_db_name(fr_args_t const* args)
 
   return strdup(db_name);
 }
+
+int get_conf_near_ric_shards(fr_args_t const* args)
+{
+  char* line = NULL;
+  defer({free(line);});
+  size_t len = 0;
+  ssize_t read;
+
+  FILE * fp = fopen(args->conf_file, "r");
+
+  if (fp == NULL){
+    printf("%s not found. Did you forget to sudo make install?\n", args->conf_file);
+    exit(EXIT_FAILURE);
+  }
+
+  defer({fclose(fp); } );
+
+  int num_shards = 0;
+  while ((read = getline(&line, &len, fp)) != -1) {
+    const char* needle = "NUM_SHARDS =";
+    char* ans = strstr(line, needle);
+    if(ans != NULL){
+      ans += strlen(needle);
+      ans = ltrim(ans);
+      ans = rtrim(ans);
+      num_shards = atoi(ans);
+      break;
+    }
+  }
+
+  if(num_shards < 0){
+    printf("Number of shards invalid = %d Check the config file\n", num_shards);
+    exit(EXIT_FAILURE);
+  }
+
+  return num_shards;
+}
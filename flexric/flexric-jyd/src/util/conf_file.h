@@ -16,5 +16,8 @@ char* get_conf_db_dir(fr_args_t const*);
 
 char* get_conf_db_name(fr_args_t const*);
 
+// Number of nearRT-RIC worker shards. 0 if not configured
+int get_conf_near_ric_shards(fr_args_t const*);
+
 #endif
 
@@ -0,0 +1,492 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+
+#include "delta_codec.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Worst case of a varint coded uint64_t
+#define MAX_VARINT_SZ 10
+
+static
+uint8_t* put_varint(uint8_t* it, uint64_t v)
+{
+  while(v >= 0x80){
+    *it++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *it++ = (uint8_t)v;
+  return it;
+}
+
+static
+uint8_t const* get_varint(uint8_t const* it, uint8_t const* end, uint64_t* v)
+{
+  *v = 0;
+  for(int shift = 0; shift < 64; shift += 7){
+    assert(it < end && "Truncated delta frame");
+    uint8_t const b = *it++;
+    *v |= (uint64_t)(b & 0x7F) << shift;
+    if((b & 0x80) == 0)
+      return it;
+  }
+  assert(0!=0 && "Malformed varint");
+  return it;
+}
+
+static inline
+uint32_t zigzag(int32_t v)
+{
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline
+int32_t unzigzag(uint32_t v)
+{
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static
+int cmp_delta_idx(void const* m0_v, void const* m1_v)
+{
+  delta_idx_t const* m0 = (delta_idx_t const*)m0_v;
+  delta_idx_t const* m1 = (delta_idx_t const*)m1_v;
+  return (m0->key > m1->key) - (m0->key < m1->key);
+}
+
+static
+void init_delta_ref(delta_ref_t* ref, size_t elm_sz)
+{
+  assert(ref != NULL);
+  assert(elm_sz > 0 && elm_sz % sizeof(uint32_t) == 0 && "Records must be a multiple of 32 bits");
+  memset(ref, 0, sizeof(delta_ref_t));
+  ref->elm_sz = elm_sz;
+}
+
+static
+void free_delta_ref(delta_ref_t* ref)
+{
+  assert(ref != NULL);
+  free(ref->elm);
+  free(ref->idx);
+  free(ref->nxt_elm);
+  free(ref->nxt_idx);
+}
+
+static
+void reserve_delta_ref(delta_ref_t* ref, uint32_t len)
+{
+  if(len <= ref->cap)
+    return;
+
+  uint32_t const cap = len > 2*ref->cap ? len : 2*ref->cap;
+
+  // The current reference is preserved
+  uint8_t* elm = realloc(ref->elm, cap*ref->elm_sz);
+  delta_idx_t* idx = realloc(ref->idx, cap*sizeof(delta_idx_t));
+  assert(elm != NULL && idx != NULL && "Memory exhausted");
+  ref->elm = elm;
+  ref->idx = idx;
+
+  free(ref->nxt_elm);
+  free(ref->nxt_idx);
+  ref->nxt_elm = malloc(cap*ref->elm_sz);
+  ref->nxt_idx = malloc(cap*sizeof(delta_idx_t));
+  assert(ref->nxt_elm != NULL && ref->nxt_idx != NULL && "Memory exhausted");
+
+  ref->cap = cap;
+}
+
+static
+uint8_t const* find_delta_ref(delta_ref_t const* ref, uint64_t key)
+{
+  if(ref->len == 0)
+    return NULL;
+
+  delta_idx_t const k = {.key = key};
+  delta_idx_t const* it = bsearch(&k, ref->idx, ref->len, sizeof(delta_idx_t), cmp_delta_idx);
+  return it == NULL ? NULL : ref->elm + it->pos*ref->elm_sz;
+}
+
+// The len records written in nxt become the reference. With duplicated keys,
+// the match would depend on the sort, so the reference is dropped and the
+// next frame is coded against zero on both ends
+static
+void commit_delta_ref(delta_ref_t* ref, uint32_t len)
+{
+  if(len > 1)
+    qsort(ref->nxt_idx, len, sizeof(delta_idx_t), cmp_delta_idx);
+
+  uint8_t* elm = ref->elm;
+  ref->elm = ref->nxt_elm;
+  ref->nxt_elm = elm;
+
+  delta_idx_t* idx = ref->idx;
+  ref->idx = ref->nxt_idx;
+  ref->nxt_idx = idx;
+
+  ref->len = len;
+  for(uint32_t i = 1; i < len; ++i){
+    if(ref->idx[i-1].key == ref->idx[i].key){
+      ref->len = 0;
+      break;
+    }
+  }
+}
+
+void init_delta_enc(delta_enc_t* enc, size_t elm_sz, uint32_t keyframe, uint64_t (*key)(void const* elm))
+{
+  assert(enc != NULL);
+  assert(keyframe > 0);
+  assert(key != NULL);
+
+  init_delta_ref(&enc->ref, elm_sz);
+  enc->key = key;
+  enc->keyframe = keyframe;
+  enc->cnt = 0;
+  enc->kf_req = 0;
+
+  // Only needs to be unique among the streams that reach a decoder
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  enc->stream = ((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec) * 0x9E3779B97F4A7C15ULL ^ (uintptr_t)enc;
+}
+
+void free_delta_enc(delta_enc_t* enc)
+{
+  assert(enc != NULL);
+  free_delta_ref(&enc->ref);
+}
+
+void req_keyframe_delta_enc(delta_enc_t* enc, uint32_t kf_req)
+{
+  assert(enc != NULL);
+  if(enc->kf_req == kf_req)
+    return;
+
+  enc->kf_req = kf_req;
+  enc->cnt = 0;
+}
+
+void delta_enc_frame(delta_enc_t* enc, void const* elm, uint32_t len, int64_t tstamp, byte_array_t* ba, size_t* cap)
+{
+  assert(enc != NULL);
+  assert(elm != NULL || len == 0);
+  assert(ba != NULL);
+  assert(cap != NULL);
+
+  delta_ref_t* ref = &enc->ref;
+  size_t const num_words = ref->elm_sz / sizeof(uint32_t);
+  reserve_delta_ref(ref, len);
+
+  size_t const max_sz = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t) + sizeof(int64_t) + MAX_VARINT_SZ
+                      + len * (2*MAX_VARINT_SZ + num_words*2*5);
+  reserve_byte_array(ba, cap, max_sz);
+
+  bool const keyframe = enc->cnt % enc->keyframe == 0;
+  enc->cnt += 1;
+
+  uint8_t* it = ba->buf;
+  uint32_t const marker = DELTA_FRAME_MARKER;
+  memcpy(it, &marker, sizeof(marker));
+  it += sizeof(marker);
+  memcpy(it, &enc->stream, sizeof(enc->stream));
+  it += sizeof(enc->stream);
+  *it++ = keyframe;
+  memcpy(it, &tstamp, sizeof(tstamp));
+  it += sizeof(tstamp);
+  it = put_varint(it, len);
+
+  for(uint32_t i = 0; i < len; ++i){
+    uint8_t const* cur = (uint8_t const*)elm + i*ref->elm_sz;
+    uint64_t const key = enc->key(cur);
+    uint8_t const* prev = keyframe ? NULL : find_delta_ref(ref, key);
+
+    it = put_varint(it, key);
+
+    // Number of changed words, patched once known. Fits in one byte for
+    // records up to 508 bytes
+    uint32_t changed = 0;
+    uint8_t* it_changed = it;
+    it += num_words < 0x80 ? 1 : MAX_VARINT_SZ;
+
+    size_t last = 0;
+    for(size_t w = 0; w < num_words; ++w){
+      uint32_t c;
+      uint32_t p = 0;
+      memcpy(&c, cur + w*sizeof(uint32_t), sizeof(c));
+      if(prev != NULL)
+        memcpy(&p, prev + w*sizeof(uint32_t), sizeof(p));
+      if(c == p)
+        continue;
+
+      it = put_varint(it, w - last);
+      it = put_varint(it, zigzag((int32_t)(c - p)));
+      last = w;
+      ++changed;
+    }
+
+    if(num_words < 0x80){
+      *it_changed = changed;
+    } else {
+      // Padded varint of fixed size
+      for(int j = 0; j < MAX_VARINT_SZ - 1; ++j){
+        it_changed[j] = (changed & 0x7F) | 0x80;
+        changed >>= 7;
+      }
+      it_changed[MAX_VARINT_SZ - 1] = 0;
+    }
+
+    memcpy(ref->nxt_elm + i*ref->elm_sz, cur, ref->elm_sz);
+    ref->nxt_idx[i] = (delta_idx_t){.key = key, .pos = i};
+  }
+
+  commit_delta_ref(ref, len);
+
+  ba->len = it - ba->buf;
+  assert(ba->len <= max_sz);
+}
+
+void init_delta_dec(delta_dec_t* dec, size_t elm_sz)
+{
+  assert(dec != NULL);
+  memset(dec, 0, sizeof(delta_dec_t));
+  dec->elm_sz = elm_sz;
+  atomic_init(&dec->dropped, 0);
+  int const rc = pthread_mutex_init(&dec->mtx, NULL);
+  assert(rc == 0);
+}
+
+static
+void free_delta_stream(delta_stream_t* s)
+{
+  int const rc = pthread_mutex_destroy(&s->mtx);
+  assert(rc == 0);
+  free_delta_ref(&s->ref);
+  free(s);
+}
+
+void free_delta_dec(delta_dec_t* dec)
+{
+  assert(dec != NULL);
+  for(uint32_t i = 0; i < dec->len; ++i)
+    free_delta_stream(dec->stream[i]);
+  free(dec->stream);
+  int const rc = pthread_mutex_destroy(&dec->mtx);
+  assert(rc == 0);
+}
+
+bool is_delta_frame(size_t len, uint8_t const buf[len])
+{
+  uint32_t marker = 0;
+  if(len < sizeof(marker))
+    return false;
+  memcpy(&marker, buf, sizeof(marker));
+  return marker == DELTA_FRAME_MARKER;
+}
+
+bool is_delta_keyframe(size_t len, uint8_t const buf[len])
+{
+  size_t const pos = sizeof(uint32_t) + sizeof(uint64_t);
+  return is_delta_frame(len, buf) == true && len > pos && buf[pos] != 0;
+}
+
+static
+int64_t now_s(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec;
+}
+
+// Position of stream in the sorted dec->stream, or where it would be inserted
+static
+uint32_t lower_bound_delta_stream(delta_dec_t const* dec, uint64_t stream)
+{
+  uint32_t lo = 0;
+  uint32_t hi = dec->len;
+  while(lo < hi){
+    uint32_t const mid = lo + (hi - lo) / 2;
+    if(dec->stream[mid]->stream < stream)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// Forgets the streams not used for DELTA_DEC_IDLE_S, e.g., of deleted
+// subscriptions. Called with dec->mtx held
+static
+void rm_idle_delta_stream(delta_dec_t* dec, int64_t now)
+{
+  uint32_t len = 0;
+  for(uint32_t i = 0; i < dec->len; ++i){
+    delta_stream_t* s = dec->stream[i];
+    if(now - s->last_use_s > DELTA_DEC_IDLE_S){
+      // Waits for a frame being decoded
+      pthread_mutex_lock(&s->mtx);
+      pthread_mutex_unlock(&s->mtx);
+      free_delta_stream(s);
+      continue;
+    }
+    dec->stream[len++] = s;
+  }
+  dec->len = len;
+}
+
+// Returns the stream locked. Locking it before releasing dec->mtx keeps it
+// alive, as rm_idle_delta_stream() also locks it with dec->mtx held
+static
+delta_stream_t* find_delta_stream(delta_dec_t* dec, uint64_t stream)
+{
+  int64_t const now = now_s();
+
+  pthread_mutex_lock(&dec->mtx);
+
+  uint32_t pos = lower_bound_delta_stream(dec, stream);
+  if(pos == dec->len || dec->stream[pos]->stream != stream){
+    rm_idle_delta_stream(dec, now);
+    pos = lower_bound_delta_stream(dec, stream);
+
+    if(dec->len == dec->cap){
+      dec->cap = dec->cap == 0 ? 16 : 2 * dec->cap;
+      delta_stream_t** arr = realloc(dec->stream, dec->cap * sizeof(delta_stream_t*));
+      assert(arr != NULL && "Memory exhausted");
+      dec->stream = arr;
+    }
+
+    delta_stream_t* s = calloc(1, sizeof(delta_stream_t));
+    assert(s != NULL && "Memory exhausted");
+    s->stream = stream;
+    int const rc = pthread_mutex_init(&s->mtx, NULL);
+    assert(rc == 0);
+    init_delta_ref(&s->ref, dec->elm_sz);
+
+    memmove(&dec->stream[pos + 1], &dec->stream[pos], (dec->len - pos) * sizeof(delta_stream_t*));
+    dec->stream[pos] = s;
+    dec->len += 1;
+  }
+
+  delta_stream_t* s = dec->stream[pos];
+  s->last_use_s = now;
+  pthread_mutex_lock(&s->mtx);
+
+  pthread_mutex_unlock(&dec->mtx);
+  return s;
+}
+
+delta_dec_e delta_dec_frame(delta_dec_t* dec, size_t len, uint8_t const buf[len], void** elm, uint32_t* len_elm, int64_t* tstamp)
+{
+  assert(dec != NULL);
+  assert(elm != NULL);
+  assert(len_elm != NULL);
+  assert(tstamp != NULL);
+  assert(is_delta_frame(len, buf) == true);
+
+  size_t const hdr_sz = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t) + sizeof(int64_t);
+  assert(len > hdr_sz && "Truncated delta frame");
+
+  uint8_t const* it = buf + sizeof(uint32_t);
+  uint8_t const* end = buf + len;
+
+  uint64_t stream = 0;
+  memcpy(&stream, it, sizeof(stream));
+  it += sizeof(stream);
+  bool const keyframe = *it++;
+  memcpy(tstamp, it, sizeof(*tstamp));
+  it += sizeof(*tstamp);
+
+  uint64_t num = 0;
+  it = get_varint(it, end, &num);
+  assert(num <= len && "Malformed delta frame");
+
+  *elm = NULL;
+  *len_elm = 0;
+
+  delta_stream_t* s = find_delta_stream(dec, stream);
+
+  if(keyframe == true){
+    s->synced = true;
+    s->dropped = 0;
+  } else if(s->synced == false){
+    atomic_fetch_add_explicit(&dec->dropped, 1, memory_order_relaxed);
+    bool const req = s->dropped % DELTA_DEC_KEYFRAME_REQ_PERIOD == 0;
+    s->dropped += 1;
+    pthread_mutex_unlock(&s->mtx);
+    return req ? DELTA_DEC_KEYFRAME_REQ : DELTA_DEC_DROPPED;
+  }
+
+  delta_ref_t* ref = &s->ref;
+  size_t const num_words = ref->elm_sz / sizeof(uint32_t);
+  reserve_delta_ref(ref, num);
+
+  for(uint32_t i = 0; i < num; ++i){
+    uint64_t key = 0;
+    it = get_varint(it, end, &key);
+
+    uint8_t* cur = ref->nxt_elm + i*ref->elm_sz;
+    uint8_t const* prev = keyframe ? NULL : find_delta_ref(ref, key);
+    if(prev != NULL)
+      memcpy(cur, prev, ref->elm_sz);
+    else
+      memset(cur, 0, ref->elm_sz);
+
+    uint64_t changed = 0;
+    it = get_varint(it, end, &changed);
+    assert(changed <= num_words && "Malformed delta frame");
+
+    uint64_t w = 0;
+    for(uint64_t j = 0; j < changed; ++j){
+      uint64_t gap = 0;
+      uint64_t delta = 0;
+      it = get_varint(it, end, &gap);
+      it = get_varint(it, end, &delta);
+      w += gap;
+      assert(w < num_words && "Malformed delta frame");
+
+      uint32_t c;
+      memcpy(&c, cur + w*sizeof(uint32_t), sizeof(c));
+      c += (uint32_t)unzigzag((uint32_t)delta);
+      memcpy(cur + w*sizeof(uint32_t), &c, sizeof(c));
+    }
+
+    ref->nxt_idx[i] = (delta_idx_t){.key = key, .pos = i};
+  }
+  assert(it == end && "Trailing bytes in delta frame");
+
+  if(num > 0){
+    *elm = malloc(num*ref->elm_sz);
+    assert(*elm != NULL && "Memory exhausted");
+    memcpy(*elm, ref->nxt_elm, num*ref->elm_sz);
+  }
+  *len_elm = num;
+
+  commit_delta_ref(ref, num);
+
+  pthread_mutex_unlock(&s->mtx);
+  return DELTA_DEC_OK;
+}
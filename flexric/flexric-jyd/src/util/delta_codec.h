@@ -0,0 +1,147 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+
+#ifndef DELTA_CODEC_H
+#define DELTA_CODEC_H
+
+/*
+ * Delta coding of arrays of fixed size records (e.g., per UE or per bearer
+ * statistics) identified by a key. Per record, a frame carries the key and
+ * the 32 bit words that changed since the previous frame of the same stream,
+ * as zigzag varint coded differences. Records missing from a frame were
+ * removed. Keyframes are coded against zero and reset the reference.
+ *
+ * Frame layout:
+ * uint32_t DELTA_FRAME_MARKER | uint64_t stream | uint8_t keyframe | int64_t tstamp |
+ * varint len | len x ( varint key | varint num_words | num_words x (varint word_gap | varint delta) )
+ *
+ * The marker can not be the first word of a plain encoded indication message,
+ * which starts with the number of records.
+ *
+ * A decoder serves the streams of any number of encoders (e.g., E2 Nodes and
+ * subscriptions) and may be shared among threads. A delta frame of a stream
+ * that the decoder does not know (i.e., forgotten or its keyframe lost) is
+ * dropped until the next keyframe, and the caller is told to ask for one.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "byte_array.h"
+
+#define DELTA_FRAME_MARKER UINT32_MAX
+
+// Streams not decoded for this time are forgotten
+#define DELTA_DEC_IDLE_S 60
+
+// Dropped frames of a stream between two keyframe requests
+#define DELTA_DEC_KEYFRAME_REQ_PERIOD 64
+
+typedef struct{
+  uint64_t key;
+  uint32_t pos;
+} delta_idx_t;
+
+// Records of the last frame. Double buffered, swapped at every frame
+typedef struct{
+  size_t elm_sz;
+  uint32_t cap;
+
+  uint8_t* elm;
+  delta_idx_t* idx; // sorted by key
+  uint32_t len;
+
+  uint8_t* nxt_elm;
+  delta_idx_t* nxt_idx;
+} delta_ref_t;
+
+typedef struct{
+  delta_ref_t ref;
+  uint64_t (*key)(void const* elm);
+
+  uint64_t stream;
+  // A keyframe every 'keyframe' frames
+  uint32_t keyframe;
+  uint32_t cnt;
+  // Last keyframe request served
+  uint32_t kf_req;
+} delta_enc_t;
+
+typedef struct{
+  uint64_t stream;
+  // Guarded by the decoder mtx
+  int64_t last_use_s;
+  // Serializes the frames of the stream
+  pthread_mutex_t mtx;
+  // False until the first keyframe
+  bool synced;
+  uint32_t dropped;
+  delta_ref_t ref;
+} delta_stream_t;
+
+typedef struct{
+  size_t elm_sz;
+  pthread_mutex_t mtx;
+  delta_stream_t** stream; // sorted by stream
+  uint32_t len;
+  uint32_t cap;
+  // Delta frames dropped as their stream was unknown
+  atomic_uint_fast64_t dropped;
+} delta_dec_t;
+
+typedef enum{
+  DELTA_DEC_OK,
+  // Delta frame of an unknown stream. Nothing decoded
+  DELTA_DEC_DROPPED,
+  // As DELTA_DEC_DROPPED, and the encoder should be asked for a keyframe
+  DELTA_DEC_KEYFRAME_REQ,
+} delta_dec_e;
+
+void init_delta_enc(delta_enc_t* enc, size_t elm_sz, uint32_t keyframe, uint64_t (*key)(void const* elm));
+
+void free_delta_enc(delta_enc_t* enc);
+
+// Next frame is a keyframe if kf_req differs from the last request served.
+// Lets an owner of many encoders serve a request with a counter
+void req_keyframe_delta_enc(delta_enc_t* enc, uint32_t kf_req);
+
+// Encode the len records of elm in ba, reusing its memory of capacity *cap
+void delta_enc_frame(delta_enc_t* enc, void const* elm, uint32_t len, int64_t tstamp, byte_array_t* ba, size_t* cap);
+
+void init_delta_dec(delta_dec_t* dec, size_t elm_sz);
+
+void free_delta_dec(delta_dec_t* dec);
+
+bool is_delta_frame(size_t len, uint8_t const buf[len]);
+
+// Delta coded frame decodable without the previous frames of its stream
+bool is_delta_keyframe(size_t len, uint8_t const buf[len]);
+
+// Writes the len_elm records of the frame in elm. Ownership transferred to the
+// caller. Thread safe
+delta_dec_e delta_dec_frame(delta_dec_t* dec, size_t len, uint8_t const buf[len], void** elm, uint32_t* len_elm, int64_t* tstamp);
+
+#endif
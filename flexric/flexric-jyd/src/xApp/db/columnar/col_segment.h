@@ -0,0 +1,94 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef COLUMNAR_SEGMENT_XAPP_H
+#define COLUMNAR_SEGMENT_XAPP_H
+
+/*
+ * On-disk layout of a columnar segment. A segment stores the rows of one SM
+ * for one time partition. Every column is a contiguous, 64 bytes aligned
+ * array of capacity elements, so that a scan over one column is a
+ * sequential memory read once the file is mmaped.
+ *
+ * | col_seg_hdr_t | col_desc_t[num_cols] | col 0 | col 1 | ... |
+ *
+ * Only the first rows elements of every column are valid. The writer
+ * publishes rows after the column values were written, so a concurrent
+ * reader always observes complete rows.
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define COL_SEG_MAGIC 0x31304c4f43524646 // "FFRCOL01"
+#define COL_SEG_VERSION 1
+#define COL_SEG_ALIGN 64
+#define COL_NAME_LEN 32
+
+typedef enum{
+  COL_SM_MAC_UE,
+  COL_SM_RLC_BEARER,
+  COL_SM_PDCP_BEARER,
+
+  COL_SM_END
+} col_sm_e;
+
+typedef enum{
+  COL_TYPE_U8,
+  COL_TYPE_I8,
+  COL_TYPE_U16,
+  COL_TYPE_I16,
+  COL_TYPE_U32,
+  COL_TYPE_I32,
+  COL_TYPE_U64,
+  COL_TYPE_I64,
+  COL_TYPE_F32,
+  COL_TYPE_F64,
+
+  COL_TYPE_END
+} col_type_e;
+
+typedef struct{
+  char name[COL_NAME_LEN];
+  uint32_t type; // col_type_e
+  uint32_t width;
+  uint64_t offset; // From the beginning of the file
+} col_desc_t;
+
+typedef struct{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t sm; // col_sm_e
+  uint32_t num_cols;
+  uint32_t pad;
+  uint64_t capacity;
+  _Atomic(uint64_t) rows;
+  int64_t t_first;
+  int64_t t_last;
+  col_desc_t cols[];
+} col_seg_hdr_t;
+
+// File prefix of the segments of a SM i.e., <dir>/<prefix>_<partition>_<seq>.col
+char const* name_col_sm(col_sm_e sm);
+
+#endif
+
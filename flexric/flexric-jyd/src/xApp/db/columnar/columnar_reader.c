@@ -0,0 +1,210 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#include "columnar_reader.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+char const* name_col_sm(col_sm_e sm)
+{
+  assert(sm < COL_SM_END);
+
+  static char const* names[COL_SM_END] = {"mac_ue", "rlc_bearer", "pdcp_bearer"};
+  return names[sm];
+}
+
+static
+bool valid_hdr(col_seg_hdr_t const* hdr, size_t sz)
+{
+  if(sz < sizeof(col_seg_hdr_t))
+    return false;
+
+  if(hdr->magic != COL_SEG_MAGIC || hdr->version != COL_SEG_VERSION || hdr->sm >= COL_SM_END)
+    return false;
+
+  if(sizeof(col_seg_hdr_t) + hdr->num_cols*sizeof(col_desc_t) > sz)
+    return false;
+
+  for(uint32_t i = 0; i < hdr->num_cols; ++i){
+    col_desc_t const* d = &hdr->cols[i];
+    if(d->type >= COL_TYPE_END || d->offset + d->width*hdr->capacity > sz)
+      return false;
+  }
+
+  return true;
+}
+
+bool open_col_seg(char const* path, col_seg_t* seg)
+{
+  assert(path != NULL);
+  assert(seg != NULL);
+
+  memset(seg, 0, sizeof(col_seg_t));
+
+  seg->fd = open(path, O_RDONLY);
+  if(seg->fd < 0)
+    return false;
+
+  struct stat st = {0};
+  if(fstat(seg->fd, &st) != 0 || st.st_size == 0){
+    close(seg->fd);
+    return false;
+  }
+
+  seg->sz = st.st_size;
+  void* base = mmap(NULL, seg->sz, PROT_READ, MAP_SHARED, seg->fd, 0);
+  if(base == MAP_FAILED){
+    close(seg->fd);
+    return false;
+  }
+  seg->base = base;
+  seg->hdr = base;
+
+  if(valid_hdr(seg->hdr, seg->sz) == false){
+    close_col_seg(seg);
+    return false;
+  }
+
+  // Column scans dominate the access pattern
+  madvise(base, seg->sz, MADV_SEQUENTIAL);
+
+  return true;
+}
+
+void close_col_seg(col_seg_t* seg)
+{
+  assert(seg != NULL);
+
+  if(seg->base != NULL)
+    munmap((void*)seg->base, seg->sz);
+
+  if(seg->fd > -1)
+    close(seg->fd);
+
+  memset(seg, 0, sizeof(col_seg_t));
+  seg->fd = -1;
+}
+
+size_t rows_col_seg(col_seg_t const* seg)
+{
+  assert(seg != NULL);
+  // Pairs with the release store of the writer
+  return atomic_load_explicit(&((col_seg_hdr_t*)seg->hdr)->rows, memory_order_acquire);
+}
+
+int find_col_seg(col_seg_t const* seg, char const* name)
+{
+  assert(seg != NULL);
+  assert(name != NULL);
+
+  for(uint32_t i = 0; i < seg->hdr->num_cols; ++i){
+    if(strncmp(seg->hdr->cols[i].name, name, COL_NAME_LEN) == 0)
+      return i;
+  }
+  return -1;
+}
+
+col_desc_t const* desc_col_seg(col_seg_t const* seg, int col)
+{
+  assert(seg != NULL);
+  assert(col > -1 && (uint32_t)col < seg->hdr->num_cols);
+
+  return &seg->hdr->cols[col];
+}
+
+void const* data_col_seg(col_seg_t const* seg, int col)
+{
+  col_desc_t const* d = desc_col_seg(seg, col);
+  return seg->base + d->offset;
+}
+
+double f64_col_seg(col_seg_t const* seg, int col, size_t row)
+{
+  col_desc_t const* d = desc_col_seg(seg, col);
+  assert(row < seg->hdr->capacity);
+
+  void const* it = seg->base + d->offset + row*d->width;
+  switch(d->type){
+    case COL_TYPE_U8: return *(uint8_t const*)it;
+    case COL_TYPE_I8: return *(int8_t const*)it;
+    case COL_TYPE_U16: return *(uint16_t const*)it;
+    case COL_TYPE_I16: return *(int16_t const*)it;
+    case COL_TYPE_U32: return *(uint32_t const*)it;
+    case COL_TYPE_I32: return *(int32_t const*)it;
+    case COL_TYPE_U64: return *(uint64_t const*)it;
+    case COL_TYPE_I64: return *(int64_t const*)it;
+    case COL_TYPE_F32: return *(float const*)it;
+    case COL_TYPE_F64: return *(double const*)it;
+    default: assert(0!=0 && "Unknown column type");
+  }
+  return 0.0;
+}
+
+size_t scan_col_seg(char const* dir, col_sm_e sm, int64_t t_start, int64_t t_end, col_seg_fp f, void* ctx)
+{
+  assert(dir != NULL);
+  assert(sm < COL_SM_END);
+  assert(f != NULL);
+
+  DIR* d = opendir(dir);
+  if(d == NULL)
+    return 0;
+
+  char prefix[64];
+  int const len = snprintf(prefix, sizeof(prefix), "%s_", name_col_sm(sm));
+  assert(len < (int)sizeof(prefix));
+
+  size_t visited = 0;
+  struct dirent* e = NULL;
+  while((e = readdir(d)) != NULL){
+    size_t const name_len = strlen(e->d_name);
+    if(strncmp(e->d_name, prefix, len) != 0 || name_len < 4 || strcmp(e->d_name + name_len - 4, ".col") != 0)
+      continue;
+
+    char path[512];
+    int const rc = snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+    if(rc >= (int)sizeof(path))
+      continue;
+
+    col_seg_t seg = {0};
+    if(open_col_seg(path, &seg) == false)
+      continue;
+
+    if(seg.hdr->t_last >= t_start && seg.hdr->t_first <= t_end){
+      f(&seg, ctx);
+      ++visited;
+    }
+
+    close_col_seg(&seg);
+  }
+
+  closedir(d);
+  return visited;
+}
+
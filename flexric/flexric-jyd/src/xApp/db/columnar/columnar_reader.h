@@ -0,0 +1,69 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef COLUMNAR_READER_XAPP_H
+#define COLUMNAR_READER_XAPP_H
+
+/*
+ * Read-only access to the segments written by the columnar xApp DB.
+ * Columns are returned as pointers into the mmaped file, no copy involved.
+ */
+
+#include "col_segment.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct{
+  int fd;
+  uint8_t const* base;
+  size_t sz;
+  col_seg_hdr_t const* hdr;
+} col_seg_t;
+
+bool open_col_seg(char const* path, col_seg_t* seg);
+
+void close_col_seg(col_seg_t* seg);
+
+// Number of complete rows. May grow while the writer is active
+size_t rows_col_seg(col_seg_t const* seg);
+
+// Index of the column or -1 if not present
+int find_col_seg(col_seg_t const* seg, char const* name);
+
+col_desc_t const* desc_col_seg(col_seg_t const* seg, int col);
+
+// Contiguous array of rows_col_seg() elements of the type in desc_col_seg()
+void const* data_col_seg(col_seg_t const* seg, int col);
+
+// Value of a numeric column widened to double
+double f64_col_seg(col_seg_t const* seg, int col, size_t row);
+
+typedef void (*col_seg_fp)(col_seg_t const* seg, void* ctx);
+
+// Call f for every segment of sm in dir with rows in [t_start, t_end].
+// Returns the number of segments visited
+size_t scan_col_seg(char const* dir, col_sm_e sm, int64_t t_start, int64_t t_end, col_seg_fp f, void* ctx);
+
+#endif
+
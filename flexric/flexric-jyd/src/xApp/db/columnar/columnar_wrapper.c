@@ -0,0 +1,407 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#include "columnar_wrapper.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Columns shared by all the SMs
+typedef struct{
+  int64_t tstamp;
+  uint32_t ngran_node;
+  uint16_t mcc;
+  uint16_t mnc;
+  uint8_t mnc_digit_len;
+  uint32_t nb_id;
+  uint64_t cu_du_id; // UINT64_MAX if absent
+} col_e2_node_t;
+
+typedef struct{
+  char const* name;
+  col_type_e type;
+  uint32_t width;
+  size_t src_off;
+} col_schema_t;
+
+#define COL_TYPE(x) _Generic((x), uint8_t: COL_TYPE_U8, int8_t: COL_TYPE_I8, \
+                                  uint16_t: COL_TYPE_U16, int16_t: COL_TYPE_I16, \
+                                  uint32_t: COL_TYPE_U32, int32_t: COL_TYPE_I32, \
+                                  uint64_t: COL_TYPE_U64, int64_t: COL_TYPE_I64, \
+                                  float: COL_TYPE_F32, double: COL_TYPE_F64)
+
+#define COL_FIELD_N(S, f, n) { .name = n, .type = COL_TYPE(((S*)0)->f), .width = sizeof(((S*)0)->f), .src_off = offsetof(S, f) }
+
+#define COL_FIELD(S, f) COL_FIELD_N(S, f, #f)
+
+static
+const col_schema_t e2_node_cols[] = {
+  COL_FIELD(col_e2_node_t, tstamp),
+  COL_FIELD(col_e2_node_t, ngran_node),
+  COL_FIELD(col_e2_node_t, mcc),
+  COL_FIELD(col_e2_node_t, mnc),
+  COL_FIELD(col_e2_node_t, mnc_digit_len),
+  COL_FIELD(col_e2_node_t, nb_id),
+  COL_FIELD(col_e2_node_t, cu_du_id),
+};
+
+static
+const col_schema_t mac_ue_cols[] = {
+  COL_FIELD(mac_ue_stats_impl_t, frame),
+  COL_FIELD(mac_ue_stats_impl_t, slot),
+  COL_FIELD(mac_ue_stats_impl_t, dl_aggr_tbs),
+  COL_FIELD(mac_ue_stats_impl_t, ul_aggr_tbs),
+  COL_FIELD(mac_ue_stats_impl_t, dl_aggr_bytes_sdus),
+  COL_FIELD(mac_ue_stats_impl_t, ul_aggr_bytes_sdus),
+  COL_FIELD(mac_ue_stats_impl_t, dl_curr_tbs),
+  COL_FIELD(mac_ue_stats_impl_t, ul_curr_tbs),
+  COL_FIELD(mac_ue_stats_impl_t, dl_sched_rb),
+  COL_FIELD(mac_ue_stats_impl_t, ul_sched_rb),
+  COL_FIELD(mac_ue_stats_impl_t, pusch_snr),
+  COL_FIELD(mac_ue_stats_impl_t, pucch_snr),
+  COL_FIELD(mac_ue_stats_impl_t, ul_rssi),
+  COL_FIELD(mac_ue_stats_impl_t, rnti),
+  COL_FIELD(mac_ue_stats_impl_t, dl_aggr_prb),
+  COL_FIELD(mac_ue_stats_impl_t, ul_aggr_prb),
+  COL_FIELD(mac_ue_stats_impl_t, dl_aggr_sdus),
+  COL_FIELD(mac_ue_stats_impl_t, ul_aggr_sdus),
+  COL_FIELD(mac_ue_stats_impl_t, dl_aggr_retx_prb),
+  COL_FIELD(mac_ue_stats_impl_t, ul_aggr_retx_prb),
+  COL_FIELD(mac_ue_stats_impl_t, wb_cqi),
+  COL_FIELD(mac_ue_stats_impl_t, dl_mcs1),
+  COL_FIELD(mac_ue_stats_impl_t, ul_mcs1),
+  COL_FIELD(mac_ue_stats_impl_t, dl_mcs2),
+  COL_FIELD(mac_ue_stats_impl_t, ul_mcs2),
+  COL_FIELD(mac_ue_stats_impl_t, phr),
+  COL_FIELD(mac_ue_stats_impl_t, bsr),
+  COL_FIELD(mac_ue_stats_impl_t, dl_bler),
+  COL_FIELD(mac_ue_stats_impl_t, ul_bler),
+  COL_FIELD(mac_ue_stats_impl_t, dl_num_harq),
+  COL_FIELD_N(mac_ue_stats_impl_t, dl_harq[0], "dl_harq_0"),
+  COL_FIELD_N(mac_ue_stats_impl_t, dl_harq[1], "dl_harq_1"),
+  COL_FIELD_N(mac_ue_stats_impl_t, dl_harq[2], "dl_harq_2"),
+  COL_FIELD_N(mac_ue_stats_impl_t, dl_harq[3], "dl_harq_3"),
+  COL_FIELD_N(mac_ue_stats_impl_t, dl_harq[4], "dlsch_errors"),
+  COL_FIELD(mac_ue_stats_impl_t, ul_num_harq),
+  COL_FIELD_N(mac_ue_stats_impl_t, ul_harq[0], "ul_harq_0"),
+  COL_FIELD_N(mac_ue_stats_impl_t, ul_harq[1], "ul_harq_1"),
+  COL_FIELD_N(mac_ue_stats_impl_t, ul_harq[2], "ul_harq_2"),
+  COL_FIELD_N(mac_ue_stats_impl_t, ul_harq[3], "ul_harq_3"),
+  COL_FIELD_N(mac_ue_stats_impl_t, ul_harq[4], "ulsch_errors"),
+};
+
+static
+const col_schema_t rlc_bearer_cols[] = {
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_wt_ms),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_dd_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_dd_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_retx_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_retx_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_segmented),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_status_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txpdu_status_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, txbuf_occ_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, txbuf_occ_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_dup_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_dup_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_dd_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_dd_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_ow_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_ow_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_status_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxpdu_status_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxbuf_occ_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxbuf_occ_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txsdu_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, txsdu_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxsdu_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxsdu_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxsdu_dd_pkts),
+  COL_FIELD(rlc_radio_bearer_stats_t, rxsdu_dd_bytes),
+  COL_FIELD(rlc_radio_bearer_stats_t, rnti),
+  COL_FIELD(rlc_radio_bearer_stats_t, mode),
+  COL_FIELD(rlc_radio_bearer_stats_t, rbid),
+};
+
+static
+const col_schema_t pdcp_bearer_cols[] = {
+  COL_FIELD(pdcp_radio_bearer_stats_t, txpdu_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, txpdu_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, txpdu_sn),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_sn),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_oo_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_oo_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_dd_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_dd_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxpdu_ro_count),
+  COL_FIELD(pdcp_radio_bearer_stats_t, txsdu_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, txsdu_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxsdu_pkts),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rxsdu_bytes),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rnti),
+  COL_FIELD(pdcp_radio_bearer_stats_t, mode),
+  COL_FIELD(pdcp_radio_bearer_stats_t, rbid),
+};
+
+#define ARR_LEN(x) (sizeof(x)/sizeof(x[0]))
+
+static
+const col_schema_t* sm_cols[COL_SM_END] = {mac_ue_cols, rlc_bearer_cols, pdcp_bearer_cols};
+
+static
+const size_t sm_num_cols[COL_SM_END] = {ARR_LEN(mac_ue_cols), ARR_LEN(rlc_bearer_cols), ARR_LEN(pdcp_bearer_cols)};
+
+static
+size_t align_col(size_t sz)
+{
+  return (sz + COL_SEG_ALIGN - 1) & ~((size_t)COL_SEG_ALIGN - 1);
+}
+
+static
+void fill_desc(col_desc_t* d, col_schema_t const* s, size_t* off, size_t cap)
+{
+  assert(strlen(s->name) < COL_NAME_LEN);
+  strncpy(d->name, s->name, COL_NAME_LEN - 1);
+  d->type = s->type;
+  d->width = s->width;
+  d->offset = *off;
+  *off += align_col(s->width * cap);
+}
+
+static
+void open_seg(db_columnar_t* db, col_sm_e sm, int64_t tstamp)
+{
+  col_writer_t* w = &db->w[sm];
+  assert(w->base == NULL);
+
+  int64_t const part_start = tstamp - (tstamp % db->part_us);
+  if(part_start != w->part_start)
+    w->seq = 0;
+  w->part_start = part_start;
+
+  size_t const e2_cols = ARR_LEN(e2_node_cols);
+  size_t const num_cols = e2_cols + sm_num_cols[sm];
+  size_t off = align_col(sizeof(col_seg_hdr_t) + num_cols*sizeof(col_desc_t));
+
+  col_desc_t* desc = calloc(num_cols, sizeof(col_desc_t));
+  assert(desc != NULL && "Memory exhausted");
+  for(size_t i = 0; i < e2_cols; ++i)
+    fill_desc(&desc[i], &e2_node_cols[i], &off, db->seg_rows);
+  for(size_t i = 0; i < sm_num_cols[sm]; ++i)
+    fill_desc(&desc[e2_cols + i], &sm_cols[sm][i], &off, db->seg_rows);
+
+  // Never reopen an existing segment. It may come from a previous run, or from an earlier visit to this partition
+  // when timestamps go back, so skip to the next free sequence number instead of truncating it
+  char path[512];
+  int rc = 0;
+  do {
+    rc = snprintf(path, sizeof(path), "%s/%s_%ld_%u.col", db->dir, name_col_sm(sm), part_start, w->seq);
+    assert(rc < (int)sizeof(path) && "Path too long");
+    w->seq += 1;
+    w->fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+  } while(w->fd == -1 && errno == EEXIST);
+  assert(w->fd > -1 && "Error while creating the columnar segment");
+
+  // Sparse file. Pages are only allocated when rows are written
+  rc = ftruncate(w->fd, off);
+  assert(rc == 0);
+
+  w->map_sz = off;
+  w->base = mmap(NULL, w->map_sz, PROT_READ | PROT_WRITE, MAP_SHARED, w->fd, 0);
+  assert(w->base != MAP_FAILED && "Error while mapping the columnar segment");
+
+  w->hdr = (col_seg_hdr_t*)w->base;
+  w->hdr->magic = COL_SEG_MAGIC;
+  w->hdr->version = COL_SEG_VERSION;
+  w->hdr->sm = sm;
+  w->hdr->num_cols = num_cols;
+  w->hdr->capacity = db->seg_rows;
+  w->hdr->t_first = tstamp;
+  w->hdr->t_last = tstamp;
+  memcpy(w->hdr->cols, desc, num_cols*sizeof(col_desc_t));
+  atomic_store_explicit(&w->hdr->rows, 0, memory_order_release);
+
+  free(desc);
+}
+
+static
+void close_seg(col_writer_t* w)
+{
+  if(w->base == NULL)
+    return;
+
+  int rc = msync(w->base, w->map_sz, MS_SYNC);
+  assert(rc == 0);
+
+  rc = munmap(w->base, w->map_sz);
+  assert(rc == 0);
+
+  rc = close(w->fd);
+  assert(rc == 0);
+
+  w->base = NULL;
+  w->hdr = NULL;
+  w->fd = -1;
+}
+
+// Returns the writer with space for len more rows of the partition of tstamp
+static
+col_writer_t* writer_for(db_columnar_t* db, col_sm_e sm, int64_t tstamp, size_t len)
+{
+  assert(len <= db->seg_rows);
+
+  col_writer_t* w = &db->w[sm];
+  if(w->base != NULL){
+    uint64_t const rows = atomic_load_explicit(&w->hdr->rows, memory_order_relaxed);
+    bool const same_part = tstamp >= w->part_start && tstamp < w->part_start + db->part_us;
+    if(same_part && rows + len <= w->hdr->capacity)
+      return w;
+
+    close_seg(w);
+  }
+
+  open_seg(db, sm, tstamp);
+  return w;
+}
+
+static
+void write_row(col_writer_t* w, size_t row, col_e2_node_t const* node, void const* stats, col_sm_e sm)
+{
+  col_desc_t const* d = w->hdr->cols;
+
+  size_t const e2_cols = ARR_LEN(e2_node_cols);
+  for(size_t i = 0; i < e2_cols; ++i){
+    uint8_t const* src = (uint8_t const*)node + e2_node_cols[i].src_off;
+    memcpy(w->base + d[i].offset + row*d[i].width, src, d[i].width);
+  }
+
+  col_schema_t const* s = sm_cols[sm];
+  for(size_t i = 0; i < sm_num_cols[sm]; ++i){
+    col_desc_t const* di = &d[e2_cols + i];
+    uint8_t const* src = (uint8_t const*)stats + s[i].src_off;
+    memcpy(w->base + di->offset + row*di->width, src, di->width);
+  }
+}
+
+static
+void append_rows(db_columnar_t* db, col_sm_e sm, global_e2_node_id_t const* id, int64_t tstamp, void const* stats, size_t stats_sz, size_t len)
+{
+  if(len == 0)
+    return;
+
+  col_e2_node_t const node = { .tstamp = tstamp,
+                               .ngran_node = id->type,
+                               .mcc = id->plmn.mcc,
+                               .mnc = id->plmn.mnc,
+                               .mnc_digit_len = id->plmn.mnc_digit_len,
+                               .nb_id = id->nb_id,
+                               .cu_du_id = id->cu_du_id != NULL ? *id->cu_du_id : UINT64_MAX };
+
+  col_writer_t* w = writer_for(db, sm, tstamp, len);
+
+  uint64_t const rows = atomic_load_explicit(&w->hdr->rows, memory_order_relaxed);
+  for(size_t i = 0; i < len; ++i)
+    write_row(w, rows + i, &node, (uint8_t const*)stats + i*stats_sz, sm);
+
+  if(tstamp < w->hdr->t_first)
+    w->hdr->t_first = tstamp;
+  if(tstamp > w->hdr->t_last)
+    w->hdr->t_last = tstamp;
+
+  // Publish the rows once all their columns are written
+  atomic_store_explicit(&w->hdr->rows, rows + len, memory_order_release);
+}
+
+void init_db_columnar(db_columnar_t* db, char const* dir)
+{
+  assert(db != NULL);
+  assert(dir != NULL);
+  assert(strlen(dir) < sizeof(db->dir));
+
+  memset(db, 0, sizeof(db_columnar_t));
+  strncpy(db->dir, dir, sizeof(db->dir) - 1);
+  db->seg_rows = DB_COLUMNAR_SEG_ROWS;
+  db->part_us = DB_COLUMNAR_PARTITION_US;
+
+  for(size_t i = 0; i < COL_SM_END; ++i){
+    db->w[i].fd = -1;
+    db->w[i].part_start = INT64_MIN;
+  }
+
+  int const rc = mkdir(dir, 0755);
+  assert((rc == 0 || errno == EEXIST) && "Error while creating the columnar DB directory");
+}
+
+void close_db_columnar(db_columnar_t* db)
+{
+  assert(db != NULL);
+
+  for(size_t i = 0; i < COL_SM_END; ++i)
+    close_seg(&db->w[i]);
+}
+
+void flush_db_columnar(db_columnar_t* db)
+{
+  assert(db != NULL);
+
+  for(size_t i = 0; i < COL_SM_END; ++i){
+    col_writer_t* w = &db->w[i];
+    if(w->base == NULL)
+      continue;
+
+    int const rc = msync(w->base, w->map_sz, MS_ASYNC);
+    assert(rc == 0);
+  }
+}
+
+void write_db_columnar(db_columnar_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd)
+{
+  assert(db != NULL);
+  assert(id != NULL);
+  assert(rd != NULL);
+
+  if(rd->type == MAC_STATS_V0){
+    mac_ind_msg_t const* msg = &rd->mac_stats.msg;
+    append_rows(db, COL_SM_MAC_UE, id, msg->tstamp, msg->ue_stats, sizeof(mac_ue_stats_impl_t), msg->len_ue_stats);
+  } else if(rd->type == RLC_STATS_V0){
+    rlc_ind_msg_t const* msg = &rd->rlc_stats.msg;
+    append_rows(db, COL_SM_RLC_BEARER, id, msg->tstamp, msg->rb, sizeof(rlc_radio_bearer_stats_t), msg->len);
+  } else if(rd->type == PDCP_STATS_V0){
+    pdcp_ind_msg_t const* msg = &rd->pdcp_stats.msg;
+    append_rows(db, COL_SM_PDCP_BEARER, id, msg->tstamp, msg->rb, sizeof(pdcp_radio_bearer_stats_t), msg->len);
+  }
+}
+
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#ifndef COLUMNAR_WRAPPER_XAPP_H
+#define COLUMNAR_WRAPPER_XAPP_H
+
+#include "../../../sm/agent_if/read/sm_ag_if_rd.h"
+#include "../../../lib/ap/e2ap_types/common/e2ap_global_node_id.h"
+
+#include "col_segment.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Rows per segment. Files are created sparse, so unused rows cost no disk
+#define DB_COLUMNAR_SEG_ROWS (1 << 20)
+
+// Length of a time partition. A new segment starts when an indication
+// timestamp (us) falls outside the partition of the current segment
+#define DB_COLUMNAR_PARTITION_US (3600LL * 1000000LL)
+
+typedef struct{
+  int fd;
+  uint8_t* base;
+  size_t map_sz;
+  col_seg_hdr_t* hdr;
+  int64_t part_start;
+  uint32_t seq;
+} col_writer_t;
+
+typedef struct{
+  char dir[256];
+  size_t seg_rows;
+  int64_t part_us;
+  col_writer_t w[COL_SM_END];
+} db_columnar_t;
+
+// The filename is used as the directory holding the segments
+void init_db_columnar(db_columnar_t* db, char const* dir);
+
+void close_db_columnar(db_columnar_t* db);
+
+// Only MAC, RLC and PDCP indications have a fixed schema. Other SMs are ignored
+void write_db_columnar(db_columnar_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd);
+
+// Schedule the written rows for write back
+void flush_db_columnar(db_columnar_t* db);
+
+#endif
+
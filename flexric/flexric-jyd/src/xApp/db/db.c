@@ -33,93 +33,37 @@ typedef struct{
   sm_ag_if_rd_t rd;
 } e2_node_ag_if_t;
 
-static
-e2_node_ag_if_t static_e2_node_ag_if; 
-
-static
-e2_node_ag_if_t static_e2_node_ag_if_10[10]; 
-
-static
-e2_node_ag_if_t static_e2_node_ag_if_100[100]; 
-
-
-
-static
-void* create_val(void* it)
-{
-  if(it == NULL)
-    return NULL;
-
-  memcpy(&static_e2_node_ag_if, it, sizeof(e2_node_ag_if_t));
-
-  return &static_e2_node_ag_if;
-}
-
-static 
-int val_10 = 0;
-
-static
-void* create_val_10(void* it)
-{
-  if(it == NULL)
-    return NULL;
-
-  memcpy(&static_e2_node_ag_if_10[val_10], it, sizeof(e2_node_ag_if_t));
-
-  ++val_10;
-  assert(val_10 < 11);
-  return &static_e2_node_ag_if_10;
-}
-
-static 
-int val_100 = 0;
-
-static
-void* create_val_100(void* it)
-{
-  if(it == NULL)
-    return NULL;
-
-  memcpy(&static_e2_node_ag_if_100[val_100], it, sizeof(e2_node_ag_if_t));
-
-  ++val_100;
-  assert(val_100 < 101);
-  return &static_e2_node_ag_if_100;
-}
-
-
 static
 void* worker_thread(void* arg)
 {
   db_xapp_t* db = (db_xapp_t*)arg;
 
-  while(true){
-    e2_node_ag_if_t* data = NULL; 
-    size_t sz = size_tsq(&db->q);
-    //printf("Current size of the db = %ld \n", sz);
-    if(sz > 100){
-      sz = 100;
-      val_100 = 0;
-      data = pop_tsq_100(&db->q, create_val_100); 
-    } else if(sz > 10){
-      sz = 10;
-      val_10 = 0;
-      data = pop_tsq_10(&db->q, create_val_10); 
-    } else{
-      sz = 1;
-      data = wait_and_pop_tsq(&db->q, create_val);
-    }
+  e2_node_ag_if_t* data = calloc(DB_XAPP_BATCH, sizeof(e2_node_ag_if_t));
+  assert(data != NULL && "Memory exhausted");
 
-    if(data == NULL)
+  while(true){
+    // Wake up at least once per commit period, so that a trickle of
+    // indications does not stay in an open transaction
+    size_t const sz = wait_pop_n_mpsc(&db->q, data, DB_XAPP_BATCH, DB_XAPP_FLUSH_MS);
+    if(sz == 0){
+      // The queue is drained before stopping
+      if(stopped_mpsc(&db->q) == true)
         break;
 
+      flush_db_gen(&db->handler);
+      continue;
+    }
+
     for(size_t i = 0; i < sz; ++i){
-      write_db_gen(db->handler, &data[i].id, &data[i].rd);
+      write_db_gen(&db->handler, &data[i].id, &data[i].rd);
       free_global_e2_node_id(&data[i].id);
       free_sm_ag_if_rd(&data[i].rd);
     }
+    atomic_fetch_add_explicit(&db->written, sz, memory_order_relaxed);
   }
-  db->q.stopped = true;
+
+  flush_db_gen(&db->handler);
+  free(data);
 
   return NULL;
 }
@@ -131,7 +75,12 @@ void init_db_xapp(db_xapp_t* db, char const* db_filename)
 
   init_db_gen(&db->handler, db_filename);
 
-  init_tsq(&db->q, sizeof(e2_node_ag_if_t));
+  init_mpsc(&db->q, DB_XAPP_QUEUE_CAP, sizeof(e2_node_ag_if_t));
+
+  db->pushed = 0;
+  db->dropped = 0;
+  db->written = 0;
+  db->max_queue_len = 0;
 
   int rc = pthread_create(&db->p, NULL, worker_thread, db);
   assert(rc == 0);
@@ -152,9 +101,10 @@ void close_db_xapp(db_xapp_t* db)
 {
   assert(db != NULL);
   
-  free_tsq(&db->q, free_e2_node_ag_if_wrapper);
+  stop_mpsc(&db->q);
   pthread_join(db->p, NULL);
-  close_db_gen(db->handler);  
+  free_mpsc(&db->q, free_e2_node_ag_if_wrapper);
+  close_db_gen(&db->handler);
 }
 
 void write_db_xapp(db_xapp_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd)
@@ -166,6 +116,32 @@ void write_db_xapp(db_xapp_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t c
   e2_node_ag_if_t d = { .rd = cp_sm_ag_if_rd(rd) ,
                         .id = cp_global_e2_node_id(id) };
 
-  push_tsq(&db->q, &d, sizeof(d) );
+  if(push_mpsc(&db->q, &d) == false){
+    free_e2_node_ag_if_wrapper(&d);
+    // Warn once per 4096 dropped indications
+    size_t const dropped = atomic_fetch_add_explicit(&db->dropped, 1, memory_order_relaxed) + 1;
+    if(((dropped - 1) & 4095) == 0)
+      printf("[xApp DB]: Queue full (%zu elements). Dropping indications, %zu dropped so far\n", db->q.cap, dropped);
+    return;
+  }
+
+  // Several producers may race to raise the maximum
+  size_t const len = size_mpsc(&db->q);
+  size_t max = atomic_load_explicit(&db->max_queue_len, memory_order_relaxed);
+  while(len > max && !atomic_compare_exchange_weak_explicit(&db->max_queue_len, &max, len, memory_order_relaxed, memory_order_relaxed))
+    ;
+
+  atomic_fetch_add_explicit(&db->pushed, 1, memory_order_relaxed);
+}
+
+db_xapp_stats_t stats_db_xapp(db_xapp_t const* db)
+{
+  assert(db != NULL);
+
+  db_xapp_stats_t s = { .pushed = db->pushed,
+                        .dropped = db->dropped,
+                        .written = db->written,
+                        .max_queue_len = db->max_queue_len };
+  return s;
 }
 
@@ -24,24 +24,52 @@
 
 #include "../../lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "../../sm/agent_if/read/sm_ag_if_rd.h"
-#include "../../util/alg_ds/ds/ts_queue/ts_queue.h"
+#include "../../util/alg_ds/ds/mpsc_queue/mpsc_queue.h"
 
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
 
 #ifdef SQLITE3_XAPP
-  #include "sqlite3/sqlite3.h"
+  #include "sqlite3/sqlite3_wrapper.h"
+#elif defined(COLUMNAR_XAPP)
+  #include "columnar/columnar_wrapper.h"
 #endif
 
+// Indications are dropped once the queue is full, so that a slow disk
+// never stalls the xApp receive path
+#define DB_XAPP_QUEUE_CAP 65536
+
+// Maximum number of indications written per worker wake-up
+#define DB_XAPP_BATCH 256
+
+// The worker flushes the backend after this long without indications
+#define DB_XAPP_FLUSH_MS 100
+
+typedef struct{
+  size_t pushed;
+  size_t dropped;
+  size_t written;
+  size_t max_queue_len;
+} db_xapp_stats_t;
+
 typedef struct{
 
 #ifdef SQLITE3_XAPP
-  sqlite3* handler;
+  db_sqlite3_t handler;
+#elif defined(COLUMNAR_XAPP)
+  db_columnar_t handler;
 #else
   static_assert(0!=0, "Unknown DB selected for the xApp"); 
 #endif
 
   pthread_t p;
-  tsq_t q;
+  mpsc_queue_t q;
+
+  atomic_size_t pushed;
+  atomic_size_t dropped;
+  atomic_size_t written;
+  atomic_size_t max_queue_len;
 } db_xapp_t;
 
 void init_db_xapp(db_xapp_t* db, char const* db_filename);
@@ -50,5 +78,7 @@ void close_db_xapp(db_xapp_t* db);
 
 void write_db_xapp(db_xapp_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd);
 
+db_xapp_stats_t stats_db_xapp(db_xapp_t const* db);
+
 #endif
 
@@ -25,21 +25,30 @@
 
 
 #include "sqlite3/sqlite3_wrapper.h"
+#include "columnar/columnar_wrapper.h"
 
 
 
 #define init_db_gen(T,U) _Generic ((T), \
-                                    sqlite3*:  init_db_sqlite3, \
+                                    db_sqlite3_t*:  init_db_sqlite3, \
+                                    db_columnar_t*: init_db_columnar, \
                                     default:   init_db_sqlite3) (T,U)
 
 #define close_db_gen(T) _Generic ((T),\
-                                    sqlite3*: close_db_sqlite3, \
+                                    db_sqlite3_t*: close_db_sqlite3, \
+                                    db_columnar_t*: close_db_columnar, \
                                     default:  close_db_sqlite3) (T)
 
 
 #define write_db_gen(T,U,V) _Generic ((T),\
-                                    sqlite3*:   write_db_sqlite3, \
+                                    db_sqlite3_t*:   write_db_sqlite3, \
+                                    db_columnar_t*:  write_db_columnar, \
                                     default:    write_db_sqlite3) (T,U,V)
 
+#define flush_db_gen(T) _Generic ((T),\
+                                    db_sqlite3_t*: flush_db_sqlite3, \
+                                    db_columnar_t*: flush_db_columnar, \
+                                    default:       flush_db_sqlite3) (T)
+
 #endif
 
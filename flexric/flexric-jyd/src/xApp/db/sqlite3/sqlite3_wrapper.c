@@ -310,811 +310,418 @@ void create_kpm_table(sqlite3* db)
 }
 
 static
-void insert_db(sqlite3* db, char const* sql)
+void exec_db(sqlite3* db, char const* sql)
 {
   assert(db != NULL);
   assert(sql != NULL);
 
   char* err_msg = NULL;
   int rc = sqlite3_exec(db, sql, 0, 0, &err_msg);
-  assert(rc == SQLITE_OK && "Error while inserting into the DB. Check the err_msg string for further info");
+  assert(rc == SQLITE_OK && "Error while executing the SQL statement. Check the err_msg string for further info");
 }
 
+static
+sqlite3_stmt* prepare_stmt(sqlite3* db, char const* sql)
+{
+  assert(db != NULL);
+  assert(sql != NULL);
+
+  sqlite3_stmt* stmt = NULL;
+  int const rc = sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL);
+  assert(rc == SQLITE_OK && "Error while preparing the SQL statement");
+  return stmt;
+}
 
 static
-int to_sql_string_mac_ue(global_e2_node_id_t const* id, mac_ue_stats_impl_t* stats, int64_t tstamp, char* out, size_t out_len)
+void step_stmt(sqlite3_stmt* stmt)
 {
-  assert(stats != NULL);       
-  assert(out != NULL);
-  const size_t max = 1024;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
+  assert(stmt != NULL);
 
-  int rc = snprintf(out, max, 
-      "INSERT INTO MAC_UE VALUES("
-      "%ld,"//tstamp
-      "%d," //ngran_node  
-      "%d," //mcc
-      "%d," //mnc
-      "%d," //mnc_digit_len   
-      "%d," //nb_id 
-      "'%s'," //cu_du_id
-      "%d," //frame
-      "%d," //slot
-      "%lu,"//dl_aggr_tbs     
-      "%lu,"//ul_aggr_tbs     
-      "%lu," //dl_aggr_bytes_sdus   
-      "%lu,"//ul_aggr_bytes_sdus       
-      "%lu," //dl_curr_tbs
-      "%lu," //ul_curr_tbs
-      "%lu," //dl_sched_rb
-      "%lu," //ul_sched_rb
-      "%g,"// pusch_snr        
-      "%g,"//  pucch_snr      
-      "%u,"// rnti            
-      "%u,"//dl_aggr_prb      
-      "%u,"//  ul_aggr_prb    
-      "%u,"//  dl_aggr_sdus   
-      "%u,"//  ul_aggr_sdus   
-      "%u,"// dl_aggr_retx_prb
-      "%u,"// ul_aggr_retx_prb
-      "%u,"// wb_cqi
-      "%u,"// dl_mcs1
-      "%u,"// ul_mcs1
-      "%u,"// dl_mcs2         
-      "%u,"// ul_mcs2         
-      "%d,"// phr
-      "%u,"// bsr
-      "%f," // dl_bler
-      "%f," // ul_bler
-      "%d," // dl_num_harq
-      "%u," // dl_harq[0]
-      "%u," // dl_harq[1]
-      "%u," // dl_harq[2]
-      "%u," // dl_harq[3]
-      "%u," // dlsch_errors
-      "%d," // ul_num_harq
-      "%u," // ul_harq[0]
-      "%u," // ul_harq[1]
-      "%u," // ul_harq[2]
-      "%u," // ul_harq[3]
-      "%u" // ulsch_errors
-      ");"
-      ,tstamp                
-      ,id->type
-      ,id->plmn.mcc
-      ,id->plmn.mnc
-      ,id->plmn.mnc_digit_len
-      ,id->nb_id 
-      ,id->cu_du_id ? c_cu_du_id : c_null
-      ,stats->frame
-      ,stats->slot
-      ,stats->dl_aggr_tbs    
-      ,stats->ul_aggr_tbs    
-      ,stats->dl_aggr_bytes_sdus      
-      ,stats->ul_aggr_bytes_sdus      
-      ,stats->dl_curr_tbs
-      ,stats->ul_curr_tbs
-      ,stats->dl_sched_rb
-      ,stats->ul_sched_rb
-      ,stats->pusch_snr      
-      ,stats->pucch_snr      
-      ,stats->rnti 
-      ,stats->dl_aggr_prb    
-      ,stats->ul_aggr_prb    
-      ,stats->dl_aggr_sdus   
-      ,stats->ul_aggr_sdus   
-      ,stats->dl_aggr_retx_prb        
-      ,stats->ul_aggr_retx_prb
-      ,stats->wb_cqi         
-      ,stats->dl_mcs1        
-      ,stats->ul_mcs1        
-      ,stats->dl_mcs2        
-      ,stats->ul_mcs2        
-      ,stats->phr            
-      ,stats->bsr
-      ,stats->dl_bler
-      ,stats->ul_bler
-      ,stats->dl_num_harq
-      ,stats->dl_harq[0]
-      ,stats->dl_harq[1]
-      ,stats->dl_harq[2]
-      ,stats->dl_harq[3]
-      ,stats->dl_harq[4]
-      ,stats->ul_num_harq
-      ,stats->ul_harq[0]
-      ,stats->ul_harq[1]
-      ,stats->ul_harq[2]
-      ,stats->ul_harq[3]
-      ,stats->ul_harq[4]
-      );
-  assert(rc < (int)max && "Not enough space in the char array to write all the data");
-  return rc;
+  int const rc = sqlite3_step(stmt);
+  assert(rc == SQLITE_DONE && "Error while inserting into the DB");
+  sqlite3_reset(stmt);
 }
 
+static
+void bind_int64(sqlite3_stmt* stmt, int* col, int64_t val)
+{
+  int const rc = sqlite3_bind_int64(stmt, ++*col, val);
+  assert(rc == SQLITE_OK);
+}
 
 static
-int to_sql_string_rlc_rb(global_e2_node_id_t const* id,rlc_radio_bearer_stats_t* rlc, int64_t tstamp, char* out, size_t out_len)
+void bind_double(sqlite3_stmt* stmt, int* col, double val)
 {
-  assert(rlc != NULL);
-  assert(out != NULL);
-  const size_t max = 1024;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
+  int const rc = sqlite3_bind_double(stmt, ++*col, val);
+  assert(rc == SQLITE_OK);
+}
 
-  int const rc = snprintf(out, max,
-        "INSERT INTO RLC_bearer VALUES("
-        "%ld,"// tstamp
-        "%d," //ngran_node  
-        "%d," //mcc
-        "%d," //mnc
-        "%d," //mnc_digit_len   
-        "%d," //nb_id 
-        "'%s'," //cu_du_id
-        "%u," //rlc->txpdu_pkts
-        "%u," //rlc->txpdu_bytes
-        "%u," //rlc->txpdu_wt_ms 
-        "%u," //rlc->txpdu_dd_pkts
-        "%u," //rlc->txpdu_dd_bytes 
-        "%u," //rlc->txpdu_retx_pkts
-        "%u," //rlc->txpdu_retx_bytes
-        "%u," //rlc->txpdu_segmented
-        "%u," //rlc->txpdu_status_pkts
-        "%u," //rlc->txpdu_status_bytes
-        "%u," //rlc->txbuf_occ_bytes
-        "%u," //rlc->txbuf_occ_pkts
-        "%u," //rlc->rxpdu_pkts
-        "%u," //rlc->rxpdu_bytes
-        "%u," //rlc->rxpdu_dup_pkts
-        "%u," //rlc->rxpdu_dup_bytes
-        "%u," //rlc->rxpdu_dd_pkts
-        "%u," //rlc->rxpdu_dd_bytes
-        "%u," //rlc->rxpdu_ow_pkts
-        "%u," //rlc->rxpdu_ow_bytes
-        "%u," //rlc->rxpdu_status_pkts
-        "%u," //rlc->rxpdu_status_bytes
-        "%u," //rlc->rxbuf_occ_bytes
-        "%u," //rlc->rxbuf_occ_pkts
-        "%u," //rlc->txsdu_pkts
-        "%u," //rlc->txsdu_bytes
-        "%u," //rlc->rxsdu_pkts
-        "%u," //rlc->rxsdu_bytes
-        "%u," //rlc->rxsdu_dd_pkts
-        "%u," //rlc->rxsdu_dd_bytes
-        "%u," //rlc->rnti
-        "%u,"  //rlc->mode
-        "%u"  //rlc->rbid 
-        ");"
-        , tstamp
-        , id->type
-        , id->plmn.mcc
-        , id->plmn.mnc
-        , id->plmn.mnc_digit_len
-        , id->nb_id 
-        , id->cu_du_id ? c_cu_du_id : c_null
-        , rlc->txpdu_pkts
-        , rlc->txpdu_bytes
-        , rlc->txpdu_wt_ms
-        , rlc->txpdu_dd_pkts
-        , rlc->txpdu_dd_bytes
-        , rlc->txpdu_retx_pkts
-        , rlc->txpdu_retx_bytes
-        , rlc->txpdu_segmented
-        , rlc->txpdu_status_pkts
-        , rlc->txpdu_status_bytes
-        , rlc->txbuf_occ_bytes
-        , rlc->txbuf_occ_pkts
-        , rlc->rxpdu_pkts
-        , rlc->rxpdu_bytes
-        , rlc->rxpdu_dup_pkts
-        , rlc->rxpdu_dup_bytes
-        , rlc->rxpdu_dd_pkts
-        , rlc->rxpdu_dd_bytes
-        , rlc->rxpdu_ow_pkts
-        , rlc->rxpdu_ow_bytes
-        , rlc->rxpdu_status_pkts
-        , rlc->rxpdu_status_bytes
-        , rlc->rxbuf_occ_bytes
-        , rlc->rxbuf_occ_pkts
-        , rlc->txsdu_pkts
-        , rlc->txsdu_bytes
-        , rlc->rxsdu_pkts
-        , rlc->rxsdu_bytes
-        , rlc->rxsdu_dd_pkts
-        , rlc->rxsdu_dd_bytes
-        , rlc->rnti
-        , rlc->mode
-        , rlc->rbid
-        );
-  assert(rc < (int)max && "Not enough space in the char array to write all the data");
-  return rc;
+// The text must outlive the sqlite3_step call
+static
+void bind_text(sqlite3_stmt* stmt, int* col, char const* txt, size_t len)
+{
+  int const rc = txt == NULL ? sqlite3_bind_null(stmt, ++*col)
+                             : sqlite3_bind_text(stmt, ++*col, txt, len, SQLITE_STATIC);
+  assert(rc == SQLITE_OK);
 }
 
+static
+void bind_null(sqlite3_stmt* stmt, int* col)
+{
+  int const rc = sqlite3_bind_null(stmt, ++*col);
+  assert(rc == SQLITE_OK);
+}
 
+// tstamp, ngran_node, mcc, mnc, mnc_digit_len, nb_id and cu_du_id columns
 static
-int to_sql_string_pdcp_rb(global_e2_node_id_t const* id, pdcp_radio_bearer_stats_t* pdcp, int64_t tstamp, char* out, size_t out_len)
-{                              
-  assert(pdcp != NULL);        
-  assert(out != NULL);
-  const size_t max = 512;      
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
+void bind_e2_node(sqlite3_stmt* stmt, int* col, global_e2_node_id_t const* id, int64_t tstamp)
+{
+  assert(id != NULL);
+
+  bind_int64(stmt, col, tstamp);
+  bind_int64(stmt, col, id->type);
+  bind_int64(stmt, col, id->plmn.mcc);
+  bind_int64(stmt, col, id->plmn.mnc);
+  bind_int64(stmt, col, id->plmn.mnc_digit_len);
+  bind_int64(stmt, col, id->nb_id);
+
+  if(id->cu_du_id != NULL){
+    char c_cu_du_id[26];
+    int const rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
+    assert(rc < 26 && "Not enough space in the char array to write all the data");
+    int const rc_2 = sqlite3_bind_text(stmt, ++*col, c_cu_du_id, rc, SQLITE_TRANSIENT);
+    assert(rc_2 == SQLITE_OK);
+  } else {
+    bind_null(stmt, col);
   }
+}
+
+static
+void insert_mac_ue(sqlite3_stmt* stmt, global_e2_node_id_t const* id, mac_ue_stats_impl_t const* stats, int64_t tstamp)
+{
+  assert(stats != NULL);
+
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, stats->frame);
+  bind_int64(stmt, &col, stats->slot);
+  bind_int64(stmt, &col, stats->dl_aggr_tbs);
+  bind_int64(stmt, &col, stats->ul_aggr_tbs);
+  bind_int64(stmt, &col, stats->dl_aggr_bytes_sdus);
+  bind_int64(stmt, &col, stats->ul_aggr_bytes_sdus);
+  bind_int64(stmt, &col, stats->dl_curr_tbs);
+  bind_int64(stmt, &col, stats->ul_curr_tbs);
+  bind_int64(stmt, &col, stats->dl_sched_rb);
+  bind_int64(stmt, &col, stats->ul_sched_rb);
+  bind_double(stmt, &col, stats->pusch_snr);
+  bind_double(stmt, &col, stats->pucch_snr);
+  bind_int64(stmt, &col, stats->rnti);
+  bind_int64(stmt, &col, stats->dl_aggr_prb);
+  bind_int64(stmt, &col, stats->ul_aggr_prb);
+  bind_int64(stmt, &col, stats->dl_aggr_sdus);
+  bind_int64(stmt, &col, stats->ul_aggr_sdus);
+  bind_int64(stmt, &col, stats->dl_aggr_retx_prb);
+  bind_int64(stmt, &col, stats->ul_aggr_retx_prb);
+  bind_int64(stmt, &col, stats->wb_cqi);
+  bind_int64(stmt, &col, stats->dl_mcs1);
+  bind_int64(stmt, &col, stats->ul_mcs1);
+  bind_int64(stmt, &col, stats->dl_mcs2);
+  bind_int64(stmt, &col, stats->ul_mcs2);
+  bind_int64(stmt, &col, stats->phr);
+  bind_int64(stmt, &col, stats->bsr);
+  bind_double(stmt, &col, stats->dl_bler);
+  bind_double(stmt, &col, stats->ul_bler);
+  bind_int64(stmt, &col, stats->dl_num_harq);
+  bind_int64(stmt, &col, stats->dl_harq[0]);
+  bind_int64(stmt, &col, stats->dl_harq[1]);
+  bind_int64(stmt, &col, stats->dl_harq[2]);
+  bind_int64(stmt, &col, stats->dl_harq[3]);
+  bind_int64(stmt, &col, stats->dl_harq[4]); // dlsch_errors
+  bind_int64(stmt, &col, stats->ul_num_harq);
+  bind_int64(stmt, &col, stats->ul_harq[0]);
+  bind_int64(stmt, &col, stats->ul_harq[1]);
+  bind_int64(stmt, &col, stats->ul_harq[2]);
+  bind_int64(stmt, &col, stats->ul_harq[3]);
+  bind_int64(stmt, &col, stats->ul_harq[4]); // ulsch_errors
+  assert(col == 47);
+
+  step_stmt(stmt);
+}
 
-  int rc = snprintf(out, out_len, 
-      "INSERT INTO PDCP_bearer VALUES("
-        "%ld," //tstamp         
-        "%d," //ngran_node  
-        "%d," //mcc
-        "%d," //mnc
-        "%d," //mnc_digit_len   
-        "%d," //nb_id 
-        "'%s'," //cu_du_id
-        "%u," //txpdu_pkts       
-        "%u," //txpdu_bytes     
-        "%u," // txpdu_sn   
-        "%u," //rxpdu_pkts      
-        "%u," //rxpdu_bytes     
-        "%u,"     //rxpdu_sn    
-        "%u," //rxpdu_oo_pkts   
-        "%u," //rxpdu_oo_bytes  
-        "%u,"   //rxpdu_dd_pkts 
-        "%u,"  //rxpdu_dd_bytes 
-        "%u," //rxpdu_ro_count  
-        "%u,"//txsdu_pkts
-        "%u," //txsdu_bytes     
-        "%u,"//rxsdu_pkts
-        "%u," //rxsdu_bytes     
-        "%u," //rnti            
-        "%u," //mode            
-        "%u" //rbid
-        ");"
-        , tstamp               
-        , id->type
-        , id->plmn.mcc
-        , id->plmn.mnc
-        , id->plmn.mnc_digit_len
-        , id->nb_id 
-        , id->cu_du_id ? c_cu_du_id : c_null
-        , pdcp->txpdu_pkts     
-        , pdcp->txpdu_bytes    
-        , pdcp->txpdu_sn       
-        , pdcp->rxpdu_pkts     
-        , pdcp->rxpdu_bytes    
-        , pdcp->rxpdu_sn       
-        , pdcp->rxpdu_oo_pkts  
-        , pdcp->rxpdu_oo_bytes 
-        , pdcp->rxpdu_dd_pkts  
-        , pdcp->rxpdu_dd_bytes 
-        , pdcp->rxpdu_ro_count 
-        , pdcp->txsdu_pkts     
-        , pdcp->txsdu_bytes    
-        , pdcp->rxsdu_pkts     
-        , pdcp->rxsdu_bytes    
-        , pdcp->rnti           
-        , pdcp->mode           
-        , pdcp->rbid           
-        );                     
-  assert(rc < (int)max && "Not enough space in the char array to write all the data");
-  return rc;
+static
+void insert_rlc_rb(sqlite3_stmt* stmt, global_e2_node_id_t const* id, rlc_radio_bearer_stats_t const* rlc, int64_t tstamp)
+{
+  assert(rlc != NULL);
+
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, rlc->txpdu_pkts);
+  bind_int64(stmt, &col, rlc->txpdu_bytes);
+  bind_int64(stmt, &col, rlc->txpdu_wt_ms);
+  bind_int64(stmt, &col, rlc->txpdu_dd_pkts);
+  bind_int64(stmt, &col, rlc->txpdu_dd_bytes);
+  bind_int64(stmt, &col, rlc->txpdu_retx_pkts);
+  bind_int64(stmt, &col, rlc->txpdu_retx_bytes);
+  bind_int64(stmt, &col, rlc->txpdu_segmented);
+  bind_int64(stmt, &col, rlc->txpdu_status_pkts);
+  bind_int64(stmt, &col, rlc->txpdu_status_bytes);
+  bind_int64(stmt, &col, rlc->txbuf_occ_bytes);
+  bind_int64(stmt, &col, rlc->txbuf_occ_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_bytes);
+  bind_int64(stmt, &col, rlc->rxpdu_dup_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_dup_bytes);
+  bind_int64(stmt, &col, rlc->rxpdu_dd_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_dd_bytes);
+  bind_int64(stmt, &col, rlc->rxpdu_ow_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_ow_bytes);
+  bind_int64(stmt, &col, rlc->rxpdu_status_pkts);
+  bind_int64(stmt, &col, rlc->rxpdu_status_bytes);
+  bind_int64(stmt, &col, rlc->rxbuf_occ_bytes);
+  bind_int64(stmt, &col, rlc->rxbuf_occ_pkts);
+  bind_int64(stmt, &col, rlc->txsdu_pkts);
+  bind_int64(stmt, &col, rlc->txsdu_bytes);
+  bind_int64(stmt, &col, rlc->rxsdu_pkts);
+  bind_int64(stmt, &col, rlc->rxsdu_bytes);
+  bind_int64(stmt, &col, rlc->rxsdu_dd_pkts);
+  bind_int64(stmt, &col, rlc->rxsdu_dd_bytes);
+  bind_int64(stmt, &col, rlc->rnti);
+  bind_int64(stmt, &col, rlc->mode);
+  bind_int64(stmt, &col, rlc->rbid);
+  assert(col == 40);
+
+  step_stmt(stmt);
+}
+
+static
+void insert_pdcp_rb(sqlite3_stmt* stmt, global_e2_node_id_t const* id, pdcp_radio_bearer_stats_t const* pdcp, int64_t tstamp)
+{
+  assert(pdcp != NULL);
+
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, pdcp->txpdu_pkts);
+  bind_int64(stmt, &col, pdcp->txpdu_bytes);
+  bind_int64(stmt, &col, pdcp->txpdu_sn);
+  bind_int64(stmt, &col, pdcp->rxpdu_pkts);
+  bind_int64(stmt, &col, pdcp->rxpdu_bytes);
+  bind_int64(stmt, &col, pdcp->rxpdu_sn);
+  bind_int64(stmt, &col, pdcp->rxpdu_oo_pkts);
+  bind_int64(stmt, &col, pdcp->rxpdu_oo_bytes);
+  bind_int64(stmt, &col, pdcp->rxpdu_dd_pkts);
+  bind_int64(stmt, &col, pdcp->rxpdu_dd_bytes);
+  bind_int64(stmt, &col, pdcp->rxpdu_ro_count);
+  bind_int64(stmt, &col, pdcp->txsdu_pkts);
+  bind_int64(stmt, &col, pdcp->txsdu_bytes);
+  bind_int64(stmt, &col, pdcp->rxsdu_pkts);
+  bind_int64(stmt, &col, pdcp->rxsdu_bytes);
+  bind_int64(stmt, &col, pdcp->rnti);
+  bind_int64(stmt, &col, pdcp->mode);
+  bind_int64(stmt, &col, pdcp->rbid);
+  assert(col == 25);
+
+  step_stmt(stmt);
 }
 
 static
-int to_sql_string_ue_slice_rb(global_e2_node_id_t const* id, ue_slice_conf_t const* ues, ue_slice_assoc_t const* u, int64_t tstamp, char* out, size_t out_len)
+void insert_ue_slice(sqlite3_stmt* stmt, global_e2_node_id_t const* id, ue_slice_conf_t const* ues, ue_slice_assoc_t const* u, int64_t tstamp)
 {
   assert(ues != NULL);
-  assert(out != NULL);
-  const size_t max = 512;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
 
-  int rc = 0;
-  if (u == NULL) {
-    rc = snprintf(out, out_len,
-                  "INSERT INTO UE_SLICE VALUES("
-                  "%ld,"   // tstamp
-                  "%d,"    // ngran_node
-                  "%d,"    // mcc
-                  "%d,"    // mnc
-                  "%d,"    // mnc_digit_len
-                  "%d,"    // nb_id
-                  "'%s',"  // cu_du_id
-                  "%d,"    // dl->len_ue_slices
-                  "%d,"    // ues[i]->rnti
-                  "%d"     // ues[i]->dl_id
-                  ");"
-                  , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                  , id->cu_du_id ? c_cu_du_id : c_null
-                  , ues->len_ue_slice, -1, -1);
-    assert(rc < (int)max && "Not enough space in the char array to write all the data");
-    return rc;
-  }
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, ues->len_ue_slice);
+  bind_int64(stmt, &col, u == NULL ? -1 : u->rnti);
+  bind_int64(stmt, &col, u == NULL ? -1 : (int64_t)u->dl_id);
+  assert(col == 10);
 
-  rc = snprintf(out, out_len,
-                "INSERT INTO UE_SLICE VALUES("
-                "%ld,"   // tstamp
-                "%d,"    // ngran_node
-                "%d,"    // mcc
-                "%d,"    // mnc
-                "%d,"    // mnc_digit_len
-                "%d,"    // nb_id
-                "'%s',"  // cu_du_id
-                "%d,"    // dl->len_ue_slices
-                "%d,"    // ues[i]->rnti
-                "%d"     // ues[i]->dl_id
-                ");"
-                , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                , id->cu_du_id ? c_cu_du_id : c_null
-                , ues->len_ue_slice, u->rnti, u->dl_id);
-  assert(rc < (int)max && "Not enough space in the char array to write all the data");
-  return rc;
+  step_stmt(stmt);
 }
 
 static
-int to_sql_string_slice_rb(global_e2_node_id_t const* id, ul_dl_slice_conf_t const* slices, fr_slice_t const* s, int64_t tstamp, char* out, size_t out_len)
+void insert_slice(sqlite3_stmt* stmt, global_e2_node_id_t const* id, ul_dl_slice_conf_t const* slices, fr_slice_t const* s, int64_t tstamp)
 {
   assert(slices != NULL);
-  assert(out != NULL);
-  const size_t max = 1024;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char sched_name[50];
-  sched_name[0] = '\0';
-  strncat(sched_name, slices->sched_name, slices->len_sched_name);
-
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
 
-  int rc = 0;
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+
   if (s == NULL) {
-    rc = snprintf(out, out_len,
-                  "INSERT INTO SLICE VALUES("
-                  "%ld,"   // tstamp
-                  "%d,"    // ngran_node
-                  "%d,"    // mcc
-                  "%d,"    // mnc
-                  "%d,"    // mnc_digit_len
-                  "%d,"    // nb_id
-                  "'%s',"  // cu_du_id
-                  "%d,"    // dl->len_slices
-                  "'%s',"  // dl->sched_name
-                  "%u,"    // dl->slice[i].id
-                  "'%s',"  // dl->slice[i].label
-                  "'%s',"  // dl->slice[i]->params.type
-                  "'%s',"  // dl->slice[i]->params.u.nvs.conf
-                  "'%s',"  // dl->slice[i].sched
-                  "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u1.mbps_required/nvs.u.capacity.u.pct_reserved/edf.deadline
-                  "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u2.mbps_reference/edf.guaranteed_prbs
-                  "%.2f"  // dl->slice[i]->params.u.edf.max_replenish
-                  ");"
-                  , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                  , id->cu_du_id ? c_cu_du_id : c_null
-                  , 0, sched_name, 0, c_null, c_null, c_null, c_null, 0.00, 0.00, 0.00);
-    assert(rc < (int)max && "Not enough space in the char array to write all the data");
-    return rc;
+    bind_int64(stmt, &col, 0); // len_slices
+    bind_text(stmt, &col, slices->sched_name, slices->len_sched_name);
+    bind_int64(stmt, &col, 0); // id
+    bind_null(stmt, &col); // label
+    bind_null(stmt, &col); // type
+    bind_null(stmt, &col); // type_conf
+    bind_null(stmt, &col); // sched
+    bind_double(stmt, &col, 0.0);
+    bind_double(stmt, &col, 0.0);
+    bind_double(stmt, &col, 0.0);
+    assert(col == 17);
+    step_stmt(stmt);
+    return;
   }
 
-  char label[50];
-  label[0] = '\0';
-  strncat(label, s->label, s->len_label);
-  char params_type[10];
-  params_type[0] = '\0';
-  char params_type_conf[10];
-  params_type_conf[0] = '\0';
-  char sched[50];
-  sched[0] = '\0';
-  strncat(sched, s->sched, s->len_sched);
+  bind_int64(stmt, &col, slices->len_slices);
+  bind_null(stmt, &col); // sched_name
+  bind_int64(stmt, &col, s->id);
+  bind_text(stmt, &col, s->label, s->len_label);
+
+  // type, type_conf and the type_param0-2 columns
   if (s->params.type == SLICE_ALG_SM_V0_STATIC) {
-    strcat(params_type, "STATIC");
-    rc = snprintf(out, out_len,
-                  "INSERT INTO SLICE VALUES("
-                  "%ld,"   // tstamp
-                  "%d,"    // ngran_node
-                  "%d,"    // mcc
-                  "%d,"    // mnc
-                  "%d,"    // mnc_digit_len
-                  "%d,"    // nb_id
-                  "'%s',"  // cu_du_id
-                  "%d,"    // dl->len_slices
-                  "'%s',"  // dl->sched_name
-                  "%u,"    // dl->slice[i].id
-                  "'%s',"  // dl->slice[i].label
-                  "'%s',"  // dl->slice[i]->params.type
-                  "'%s',"  // dl->slice[i]->params.u.nvs.conf
-                  "'%s',"  // dl->slice[i].sched
-                  "%d,"    // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u1.mbps_required/nvs.u.capacity.u.pct_reserved/edf.deadline
-                  "%d,"    // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u2.mbps_reference/edf.guaranteed_prbs
-                  "%.2f"  // dl->slice[i]->params.u.edf.max_replenish
-                  ");"
-                  , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                  , id->cu_du_id ? c_cu_du_id : c_null
-                  , slices->len_slices, c_null
-                  , s->id, label, params_type, c_null, sched
-                  , s->params.u.sta.pos_low, s->params.u.sta.pos_high, 0.00);
-  } else if (s->params.type == SLICE_ALG_SM_V0_NVS) {
-    strcat(params_type, "NVS");
-    if (s->params.u.nvs.conf == SLICE_SM_NVS_V0_RATE) {
-      strcat(params_type_conf, "RATE");
-      rc = snprintf(out, out_len,
-                    "INSERT INTO SLICE VALUES("
-                    "%ld,"   // tstamp
-                    "%d,"    // ngran_node
-                    "%d,"    // mcc
-                    "%d,"    // mnc
-                    "%d,"    // mnc_digit_len
-                    "%d,"    // nb_id
-                    "'%s',"  // cu_du_id
-                    "%d,"    // dl->len_slices
-                    "'%s',"  // dl->sched_name
-                    "%u,"    // dl->slice[i].id
-                    "'%s',"  // dl->slice[i].label
-                    "'%s',"  // dl->slice[i]->params.type
-                    "'%s',"  // dl->slice[i]->params.u.nvs.conf
-                    "'%s',"  // dl->slice[i].sched
-                    "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u1.mbps_required/nvs.u.capacity.u.pct_reserved/edf.deadline
-                    "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u2.mbps_reference/edf.guaranteed_prbs
-                    "%.2f"  // dl->slice[i]->params.u.edf.max_replenish
-                    ");"
-                    , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                    , id->cu_du_id ? c_cu_du_id : c_null
-                    , slices->len_slices, c_null
-                    , s->id, label, params_type, params_type_conf, sched
-                    , s->params.u.nvs.u.rate.u1.mbps_required, s->params.u.nvs.u.rate.u2.mbps_reference, 0.00);
-      } else if (s->params.u.nvs.conf == SLICE_SM_NVS_V0_CAPACITY) {
-        strcat(params_type_conf, "CAPACITY");
-        rc = snprintf(out, out_len,
-                      "INSERT INTO SLICE VALUES("
-                      "%ld,"   // tstamp
-                      "%d,"    // ngran_node
-                      "%d,"    // mcc
-                      "%d,"    // mnc
-                      "%d,"    // mnc_digit_len
-                      "%d,"    // nb_id
-                      "'%s',"  // cu_du_id
-                      "%d,"    // dl->len_slices
-                      "'%s',"  // dl->sched_name
-                      "%u,"    // dl->slice[i].id
-                      "'%s',"  // dl->slice[i].label
-                      "'%s',"  // dl->slice[i]->params.type
-                      "'%s',"  // dl->slice[i]->params.u.nvs.conf
-                      "'%s',"  // dl->slice[i].sched
-                      "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u1.mbps_required/nvs.u.capacity.u.pct_reserved/edf.deadline
-                      "%.2f,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u2.mbps_reference/edf.guaranteed_prbs
-                      "%.2f"  // dl->slice[i]->params.u.edf.max_replenish
-                      ");"
-                      , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                      , id->cu_du_id ? c_cu_du_id : c_null
-                      , slices->len_slices, c_null
-                      , s->id, label, params_type, params_type_conf, sched
-                      , s->params.u.nvs.u.capacity.u.pct_reserved, 0.00, 0.00);
-      }
+    bind_text(stmt, &col, "STATIC", 6);
+    bind_null(stmt, &col);
+    bind_text(stmt, &col, s->sched, s->len_sched);
+    bind_double(stmt, &col, s->params.u.sta.pos_low);
+    bind_double(stmt, &col, s->params.u.sta.pos_high);
+    bind_double(stmt, &col, 0.0);
+  } else if (s->params.type == SLICE_ALG_SM_V0_NVS && s->params.u.nvs.conf == SLICE_SM_NVS_V0_RATE) {
+    bind_text(stmt, &col, "NVS", 3);
+    bind_text(stmt, &col, "RATE", 4);
+    bind_text(stmt, &col, s->sched, s->len_sched);
+    bind_double(stmt, &col, s->params.u.nvs.u.rate.u1.mbps_required);
+    bind_double(stmt, &col, s->params.u.nvs.u.rate.u2.mbps_reference);
+    bind_double(stmt, &col, 0.0);
+  } else if (s->params.type == SLICE_ALG_SM_V0_NVS && s->params.u.nvs.conf == SLICE_SM_NVS_V0_CAPACITY) {
+    bind_text(stmt, &col, "NVS", 3);
+    bind_text(stmt, &col, "CAPACITY", 8);
+    bind_text(stmt, &col, s->sched, s->len_sched);
+    bind_double(stmt, &col, s->params.u.nvs.u.capacity.u.pct_reserved);
+    bind_double(stmt, &col, 0.0);
+    bind_double(stmt, &col, 0.0);
   } else if (s->params.type == SLICE_ALG_SM_V0_EDF) {
-    strcat(params_type, "EDF");
-    rc = snprintf(out, out_len,
-                  "INSERT INTO SLICE VALUES("
-                  "%ld,"   // tstamp
-                  "%d,"    // ngran_node
-                  "%d,"    // mcc
-                  "%d,"    // mnc
-                  "%d,"    // mnc_digit_len
-                  "%d,"    // nb_id
-                  "'%s',"  // cu_du_id
-                  "%d,"    // dl->len_slices
-                  "'%s',"  // dl->sched_name
-                  "%u,"    // dl->slice[i].id
-                  "'%s',"  // dl->slice[i].label
-                  "'%s',"  // dl->slice[i]->params.type
-                  "'%s',"  // dl->slice[i]->params.u.nvs.conf
-                  "'%s',"  // dl->slice[i].sched
-                  "%d,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u1.mbps_required/nvs.u.capacity.u.pct_reserved/edf.deadline
-                  "%d,"  // dl->slice[i]->params.u.sta.pos_high/nvs.u.rate.u2.mbps_reference/edf.guaranteed_prbs
-                  "%d"  // dl->slice[i]->params.u.edf.max_replenish
-                  ");"
-                  , tstamp, id->type, id->plmn.mcc, id->plmn.mnc, id->plmn.mnc_digit_len, id->nb_id
-                  , id->cu_du_id ? c_cu_du_id : c_null
-                  , slices->len_slices, c_null
-                  , s->id, label, params_type, c_null, sched
-                  , s->params.u.edf.deadline
-                  , s->params.u.edf.guaranteed_prbs
-                  , s->params.u.edf.max_replenish);
+    bind_text(stmt, &col, "EDF", 3);
+    bind_null(stmt, &col);
+    bind_text(stmt, &col, s->sched, s->len_sched);
+    bind_double(stmt, &col, s->params.u.edf.deadline);
+    bind_double(stmt, &col, s->params.u.edf.guaranteed_prbs);
+    bind_double(stmt, &col, s->params.u.edf.max_replenish);
+  } else {
+    assert(0!=0 && "Unknown slice algorithm");
   }
-  assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  return rc;
+  assert(col == 17);
+
+  step_stmt(stmt);
 }
 
 static
-int to_sql_string_gtp_NGUT(global_e2_node_id_t const* id,gtp_ngu_t_stats_t* gtp, int64_t tstamp, char* out, size_t out_len)
+void insert_gtp_ngut(sqlite3_stmt* stmt, global_e2_node_id_t const* id, gtp_ngu_t_stats_t const* gtp, int64_t tstamp)
 {
   assert(gtp != NULL);
-  assert(out != NULL);
-  const size_t max = 1024;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
 
-  int const rc = snprintf(out, max,
-        "INSERT INTO GTP_NGUT VALUES("
-        "%ld," //tstamp         
-        "%d," //ngran_node  
-        "%d," //mcc
-        "%d," //mnc
-        "%d," //mnc_digit_len   
-        "%d," //nb_id 
-        "'%s'," //cu_du_id
-        "%u," //teidgnb    
-        "%u," //rnti
-        "%u," // qfi   
-        "%u" //teidupf
-        ");"
-        , tstamp               
-        , id->type
-        , id->plmn.mcc
-        , id->plmn.mnc
-        , id->plmn.mnc_digit_len
-        , id->nb_id 
-        , id->cu_du_id ? c_cu_du_id : c_null
-        , gtp->teidgnb
-        , gtp->rnti   
-        , gtp->qfi    
-        , gtp->teidupf    
-        );      
-  assert(rc < (int)max && "Not enough space in the char array to write all the data");
-  return rc;
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, gtp->teidgnb);
+  bind_int64(stmt, &col, gtp->rnti);
+  bind_int64(stmt, &col, gtp->qfi);
+  bind_int64(stmt, &col, gtp->teidupf);
+  assert(col == 11);
+
+  step_stmt(stmt);
 }
 
 static
-void to_sql_string_kpm_measRecord(global_e2_node_id_t const* id,  
-                                 adapter_MeasDataItem_t* kpm_measData, 
-                                 adapter_MeasRecord_t* kpm_measRecord, 
-                                 adapter_TimeStamp_t tstamp, 
-                                 char* out, 
-                                 size_t out_len)
+void insert_kpm_meas_record(sqlite3_stmt* stmt, global_e2_node_id_t const* id, adapter_MeasDataItem_t const* kpm_measData, adapter_MeasRecord_t const* kpm_measRecord, adapter_TimeStamp_t tstamp)
 {
   assert(kpm_measData != NULL);
-  assert(out != NULL);
-  const size_t max = 512;
-  assert(out_len >= max);
-
-  char* c_null = NULL;
-  char c_cu_du_id[26];
-  if (id->cu_du_id) {
-    int rc = snprintf(c_cu_du_id, 26, "%lu", *id->cu_du_id);
-    assert(rc < (int) max && "Not enough space in the char array to write all the data");
-  }
+
+  int col = 0;
+  bind_e2_node(stmt, &col, id, tstamp);
+  bind_int64(stmt, &col, kpm_measData->incompleteFlag);
 
   if (kpm_measRecord == NULL){
-    int const rc = snprintf(out, max,
-        "INSERT INTO KPM_MeasRecord VALUES("
-        "%u,"// tstamp
-        "%d," //ngran_node  
-        "%d," //mcc
-        "%d," //mnc
-        "%d," //mnc_digit_len   
-        "%d," //nb_id 
-        "'%s'," //cu_du_id
-        "%ld,"  //kpm_measData->incompleteFlag
-        "NULL"  //kpm_measRecord->int_val
-        ");" 
-        , tstamp
-        , id->type
-        , id->plmn.mcc
-        , id->plmn.mnc
-        , id->plmn.mnc_digit_len
-        , id->nb_id
-        , id->cu_du_id ? c_cu_du_id : c_null
-        , kpm_measData->incompleteFlag
-        // , granulPeriod
-        );
-    assert(rc < (int)max && "Not enough space in the char array to write all the data");
-    return ;
+    bind_null(stmt, &col);
+  } else if(kpm_measRecord->type == MeasRecord_int){
+    bind_int64(stmt, &col, kpm_measRecord->int_val);
+  } else if (kpm_measRecord->type == MeasRecord_real){
+    bind_double(stmt, &col, kpm_measRecord->real_val);
+  } else if (kpm_measRecord->type == MeasRecord_noval){
+    bind_int64(stmt, &col, -1);
   } else {
-    if(kpm_measRecord->type == MeasRecord_int){
-      int const rc = snprintf(out, max,
-          "INSERT INTO KPM_MeasRecord VALUES("
-          "%u,"// tstamp
-          "%d," //ngran_node  
-          "%d," //mcc
-          "%d," //mnc
-          "%d," //mnc_digit_len   
-          "%d," //nb_id
-          "'%s'," //cu_du_id
-          "%ld,"  //kpm_measData->incompleteFlag
-          "%ld"  //kpm_measRecord->int_val
-          ");" 
-          , tstamp
-          , id->type
-          , id->plmn.mcc
-          , id->plmn.mnc
-          , id->plmn.mnc_digit_len
-          , id->nb_id
-          , id->cu_du_id ? c_cu_du_id : c_null
-          , kpm_measData->incompleteFlag
-          , kpm_measRecord->int_val
-          );
-      assert(rc < (int)max && "Not enough space in the char array to write all the data");
-      return;
-    }else if (kpm_measRecord->type == MeasRecord_real){
-      int const rc = snprintf(out, max,
-          "INSERT INTO KPM_MeasRecord VALUES("
-          "%u,"// tstamp
-          "%d," //ngran_node  
-          "%d," //mcc
-          "%d," //mnc
-          "%d," //mnc_digit_len   
-          "%d," //nb_id 
-          "'%s'," //cu_du_id
-          "%ld,"  //kpm_measData->incompleteFlag
-          "%f"  //kpm_measRecord->real_val
-          ");" 
-          , tstamp
-          , id->type
-          , id->plmn.mcc
-          , id->plmn.mnc
-          , id->plmn.mnc_digit_len
-          , id->nb_id
-          , id->cu_du_id ? c_cu_du_id : c_null
-          , kpm_measData->incompleteFlag
-          , kpm_measRecord->real_val
-          );
-      assert(rc < (int)max && "Not enough space in the char array to write all the data");
-      return;
-    }else if (kpm_measRecord->type == MeasRecord_noval){
-      int const rc = snprintf(out, max,
-          "INSERT INTO KPM_MeasRecord VALUES("
-          "%u,"// tstamp
-          "%d," //ngran_node  
-          "%d," //mcc
-          "%d," //mnc
-          "%d," //mnc_digit_len   
-          "%d," //nb_id 
-          "'%s'," //cu_du_id
-          "%ld,"  //kpm_measData->incompleteFlag
-          "-1"  //kpm_measRecord->noVal
-          ");" 
-          , tstamp
-          , id->type
-          , id->plmn.mcc
-          , id->plmn.mnc
-          , id->plmn.mnc_digit_len
-          , id->nb_id
-          , id->cu_du_id ? c_cu_du_id : c_null
-          , kpm_measData->incompleteFlag
-          );
-      assert(rc < (int)max && "Not enough space in the char array to write all the data");
-      return;
-    }
+    assert(0!=0 && "Bad input data. Nothing for SQL to be created");
   }
-  assert(0!=0 && "Bad input data. Nothing for SQL to be created");
+  assert(col == 9);
+
+  step_stmt(stmt);
 }
 
 static
-void write_mac_stats(sqlite3* db, global_e2_node_id_t const* id, mac_ind_data_t const* ind )
+void write_mac_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, mac_ind_data_t const* ind )
 {
   assert(db != NULL);
   assert(ind != NULL);
 
   mac_ind_msg_t const* ind_msg_mac = &ind->msg; 
 
-  char buffer[2048] = {0};
-  int pos = 0;
-
   for(size_t i = 0; i < ind_msg_mac->len_ue_stats; ++i){
-    pos += to_sql_string_mac_ue(id, &ind_msg_mac->ue_stats[i], ind_msg_mac->tstamp, buffer + pos, 2048 - pos);
+    insert_mac_ue(db->mac_ue, id, &ind_msg_mac->ue_stats[i], ind_msg_mac->tstamp);
   }
-
-  insert_db(db, buffer);
+  db->tx_rows += ind_msg_mac->len_ue_stats;
 }
 
 static
-void write_rlc_stats(sqlite3* db, global_e2_node_id_t const* id, rlc_ind_data_t const* ind)
+void write_rlc_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, rlc_ind_data_t const* ind)
 {
   assert(db != NULL);
   assert(ind != NULL);
 
   rlc_ind_msg_t const* ind_msg_rlc = &ind->msg; 
 
-  char buffer[2048] = {0};
-  int pos = 0;
-
   for(size_t i = 0; i < ind_msg_rlc->len; ++i){
-    pos += to_sql_string_rlc_rb(id, &ind_msg_rlc->rb[i], ind_msg_rlc->tstamp, buffer + pos, 2048 - pos);
+    insert_rlc_rb(db->rlc_bearer, id, &ind_msg_rlc->rb[i], ind_msg_rlc->tstamp);
   }
-
-  insert_db(db, buffer);
-
+  db->tx_rows += ind_msg_rlc->len;
 }
 
 static
-void write_pdcp_stats(sqlite3* db, global_e2_node_id_t const* id, pdcp_ind_data_t const* ind)
+void write_pdcp_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, pdcp_ind_data_t const* ind)
 {
   assert(db != NULL);
   assert(ind != NULL);
 
   pdcp_ind_msg_t const* ind_msg_pdcp = &ind->msg; 
 
-  char buffer[2048] = {0};
-  int pos = 0;
-
   for(size_t i = 0; i < ind_msg_pdcp->len; ++i){
-    pos += to_sql_string_pdcp_rb(id, &ind_msg_pdcp->rb[i], ind_msg_pdcp->tstamp, buffer + pos, 2048 - pos);
+    insert_pdcp_rb(db->pdcp_bearer, id, &ind_msg_pdcp->rb[i], ind_msg_pdcp->tstamp);
   }
-
-  insert_db(db, buffer);
+  db->tx_rows += ind_msg_pdcp->len;
 }
 
 static
-void write_slice_conf_stats(sqlite3* db, global_e2_node_id_t const* id, int64_t tstamp, slice_conf_t const* slice_conf)
+void write_slice_conf_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, int64_t tstamp, slice_conf_t const* slice_conf)
 {
-  char buffer[4096] = {0};
-  int pos = 0;
-
   ul_dl_slice_conf_t const* dlslices = &slice_conf->dl;
   if (dlslices->len_slices > 0) {
     for(size_t i = 0; i < dlslices->len_slices; ++i) {
       fr_slice_t const* s = &dlslices->slices[i];
-      pos += to_sql_string_slice_rb(id, dlslices, s, tstamp, buffer + pos, 4096 - pos);
+      insert_slice(db->slice, id, dlslices, s, tstamp);
     }
+    db->tx_rows += dlslices->len_slices;
   } else {
-    pos += to_sql_string_slice_rb(id, dlslices, NULL, tstamp, buffer + pos, 4096 - pos);
+    insert_slice(db->slice, id, dlslices, NULL, tstamp);
+    db->tx_rows += 1;
   }
 
   // TODO: Process uplink slice stats
-
-  insert_db(db, buffer);
 }
 
 static
-void write_ue_slice_conf_stats(sqlite3* db, global_e2_node_id_t const* id, int64_t tstamp, ue_slice_conf_t const* ue_slice_conf)
+void write_ue_slice_conf_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, int64_t tstamp, ue_slice_conf_t const* ue_slice_conf)
 {
-  char buffer[4096] = {0};
-  int pos = 0;
-
   if (ue_slice_conf->len_ue_slice > 0) {
     for(uint32_t j = 0; j < ue_slice_conf->len_ue_slice; ++j) {
       ue_slice_assoc_t *u = &ue_slice_conf->ues[j];
-      pos += to_sql_string_ue_slice_rb(id, ue_slice_conf, u, tstamp, buffer + pos, 2048 - pos);
+      insert_ue_slice(db->ue_slice, id, ue_slice_conf, u, tstamp);
     }
+    db->tx_rows += ue_slice_conf->len_ue_slice;
   } else {
-    pos += to_sql_string_ue_slice_rb(id, ue_slice_conf, NULL, tstamp, buffer + pos, 2048 - pos);
+    insert_ue_slice(db->ue_slice, id, ue_slice_conf, NULL, tstamp);
+    db->tx_rows += 1;
   }
-
-  insert_db(db, buffer);
 }
 
 static
-void write_slice_stats(sqlite3* db, global_e2_node_id_t const* id, slice_ind_data_t const* ind)
+void write_slice_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, slice_ind_data_t const* ind)
 {
   assert(db != NULL);
   assert(ind != NULL);
@@ -1127,23 +734,21 @@ void write_slice_stats(sqlite3* db, global_e2_node_id_t const* id, slice_ind_dat
 }
 
 static
-void write_gtp_stats(sqlite3* db, global_e2_node_id_t const* id, gtp_ind_data_t const* ind)
+void write_gtp_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, gtp_ind_data_t const* ind)
 {
   assert(db != NULL);
   assert(ind != NULL);
 
   gtp_ind_msg_t const* ind_msg_gtp = &ind->msg; 
 
-  char buffer[2048] = {0};
-  int pos = 0;
   for(size_t i = 0; i < ind_msg_gtp->len; ++i){
-    pos += to_sql_string_gtp_NGUT(id, &ind_msg_gtp->ngut[i], ind_msg_gtp->tstamp, buffer + pos, 2048 - pos);
+    insert_gtp_ngut(db->gtp_ngut, id, &ind_msg_gtp->ngut[i], ind_msg_gtp->tstamp);
   }
-
-  insert_db(db, buffer);
+  db->tx_rows += ind_msg_gtp->len;
 }
 
-void write_kpm_stats(sqlite3* db, global_e2_node_id_t const* id, kpm_ind_data_t const* ind)
+static
+void write_kpm_stats(db_sqlite3_t* db, global_e2_node_id_t const* id, kpm_ind_data_t const* ind)
 {
   // TODO: Add granulPeriod into database
   // TODO: Add MeasInfo and LabelInfo into database
@@ -1152,90 +757,142 @@ void write_kpm_stats(sqlite3* db, global_e2_node_id_t const* id, kpm_ind_data_t
   assert(ind != NULL);
 
   kpm_ind_msg_t const* ind_msg_kpm = &ind->msg;
-  char buffer[512] = {0};
-
 
   for(size_t i = 0; i < ind_msg_kpm->MeasData_len; i++){
     adapter_MeasDataItem_t* curMeasData = &ind_msg_kpm->MeasData[i];
     if (curMeasData->measRecord_len > 0){
       for (size_t j = 0; j < curMeasData->measRecord_len; j++){
         adapter_MeasRecord_t* curMeasRecord = &curMeasData->measRecord[j];
-        memset(buffer, 0, sizeof(buffer));
-        to_sql_string_kpm_measRecord(id, curMeasData, curMeasRecord, ind->hdr.collectStartTime, 
-                                     buffer, 512);
-        insert_db(db, buffer);
+        insert_kpm_meas_record(db->kpm_meas_record, id, curMeasData, curMeasRecord, ind->hdr.collectStartTime);
       }
+      db->tx_rows += curMeasData->measRecord_len;
     } else {
-      memset(buffer, 0, sizeof(buffer));
-      to_sql_string_kpm_measRecord(id, curMeasData, NULL, ind->hdr.collectStartTime, 
-                                   buffer, 512);
-      insert_db(db, buffer);
+      insert_kpm_meas_record(db->kpm_meas_record, id, curMeasData, NULL, ind->hdr.collectStartTime);
+      db->tx_rows += 1;
     }
   }
 }
 
-void init_db_sqlite3(sqlite3** db, char const* db_filename)
+static
+void prepare_insert_stmts(db_sqlite3_t* db)
+{
+  assert(db != NULL);
+
+  db->mac_ue = prepare_stmt(db->handler, "INSERT INTO MAC_UE VALUES("
+                                         "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,"
+                                         "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+
+  db->rlc_bearer = prepare_stmt(db->handler, "INSERT INTO RLC_bearer VALUES("
+                                             "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,"
+                                             "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+
+  db->pdcp_bearer = prepare_stmt(db->handler, "INSERT INTO PDCP_bearer VALUES("
+                                              "?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+
+  db->slice = prepare_stmt(db->handler, "INSERT INTO SLICE VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);");
+
+  db->ue_slice = prepare_stmt(db->handler, "INSERT INTO UE_SLICE VALUES(?,?,?,?,?,?,?,?,?,?);");
+
+  db->gtp_ngut = prepare_stmt(db->handler, "INSERT INTO GTP_NGUT VALUES(?,?,?,?,?,?,?,?,?,?,?);");
+
+  db->kpm_meas_record = prepare_stmt(db->handler, "INSERT INTO KPM_MeasRecord VALUES(?,?,?,?,?,?,?,?,?);");
+
+  db->begin = prepare_stmt(db->handler, "BEGIN;");
+  db->commit = prepare_stmt(db->handler, "COMMIT;");
+}
+
+void init_db_sqlite3(db_sqlite3_t* db, char const* db_filename)
 {
   assert(db != NULL);
   assert(db_filename != NULL);
 
-  int const rc = sqlite3_open(db_filename, db);
+  memset(db, 0, sizeof(db_sqlite3_t));
+
+  int const rc = sqlite3_open(db_filename, &db->handler);
   assert(rc != SQLITE_CANTOPEN && "SQLITE3 cannot open the directory. Does it already exist?");
   assert(rc == SQLITE_OK && "Error while creating the DB at /tmp/db_xapp");
 
 
   // Optimizations. Write Ahead Logging
   char* err_msg = NULL;
-  int const rc_2 = sqlite3_exec(*db, "pragma journal_mode=wal" , 0, 0, &err_msg);
+  int const rc_2 = sqlite3_exec(db->handler, "pragma journal_mode=wal" , 0, 0, &err_msg);
   assert(rc_2 == SQLITE_OK && "Error while setting the wal mode in sqlite3");
 
-  int const rc_3 = sqlite3_exec(*db, "pragma synchronous=normal" , 0, 0, &err_msg);
+  int const rc_3 = sqlite3_exec(db->handler, "pragma synchronous=normal" , 0, 0, &err_msg);
   assert(rc_3 == SQLITE_OK && "Error while setting the syncronous mode to normal");
 
 
   //////
   // MAC
   //////
-  create_mac_ue_table(*db);
+  create_mac_ue_table(db->handler);
 
   //////
   // RLC
   //////
-  create_rlc_bearer_table(*db);
+  create_rlc_bearer_table(db->handler);
 
   //////
   // PDCP
   //////
-  create_pdcp_bearer_table(*db);
+  create_pdcp_bearer_table(db->handler);
 
   //////
   // SLICE
   //////
-  create_slice_table(*db);
-  create_ue_slice_table(*db);
+  create_slice_table(db->handler);
+  create_ue_slice_table(db->handler);
 
   ////
   // GTP
   ////
-  create_gtp_table(*db);
+  create_gtp_table(db->handler);
   // KPM
   ////
-  create_kpm_table(*db);
+  create_kpm_table(db->handler);
+
+  prepare_insert_stmts(db);
+}
+
+void flush_db_sqlite3(db_sqlite3_t* db)
+{
+  assert(db != NULL);
+
+  if(db->tx_start == 0)
+    return;
+
+  step_stmt(db->commit);
+  db->tx_start = 0;
+  db->tx_rows = 0;
 }
 
-void close_db_sqlite3(sqlite3* db)
+void close_db_sqlite3(db_sqlite3_t* db)
 {
   assert(db != NULL);
-  int const rc = sqlite3_close(db);
+
+  flush_db_sqlite3(db);
+
+  sqlite3_stmt* stmts[] = {db->mac_ue, db->rlc_bearer, db->pdcp_bearer, db->slice, db->ue_slice,
+                           db->gtp_ngut, db->kpm_meas_record, db->begin, db->commit};
+  for(size_t i = 0; i < sizeof(stmts)/sizeof(stmts[0]); ++i)
+    sqlite3_finalize(stmts[i]);
+
+  int const rc = sqlite3_close(db->handler);
   assert(rc == SQLITE_OK && "Error while closing the DB");
 }
 
-void write_db_sqlite3(sqlite3* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd)
+void write_db_sqlite3(db_sqlite3_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd)
 {
   assert(db != NULL);
   assert(rd != NULL);
   assert(rd->type == MAC_STATS_V0 || rd->type == RLC_STATS_V0|| rd->type == PDCP_STATS_V0 || rd->type == SLICE_STATS_V0 ||rd->type ==KPM_STATS_V0 ||rd->type == GTP_STATS_V0);
 
+  // Rows are grouped in transactions. One fsync-free WAL append per commit
+  if(db->tx_start == 0){
+    step_stmt(db->begin);
+    db->tx_start = time_now_us();
+  }
+
   if(rd->type == MAC_STATS_V0){
     write_mac_stats(db, id, &rd->mac_stats);
   } else if(rd->type == RLC_STATS_V0 ){
@@ -1251,5 +908,8 @@ void write_db_sqlite3(sqlite3* db, global_e2_node_id_t const* id, sm_ag_if_rd_t
   } else {
     assert(0!=0 && "Unknown statistics type received ");
   }
+
+  if(db->tx_rows >= DB_SQLITE3_TX_ROWS || time_now_us() - db->tx_start >= DB_SQLITE3_TX_MS * 1000)
+    flush_db_sqlite3(db);
 }
 
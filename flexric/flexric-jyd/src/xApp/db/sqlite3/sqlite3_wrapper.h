@@ -28,11 +28,41 @@
 
 #include "sqlite3.h"
 
-void init_db_sqlite3(sqlite3** db, char const* db_filename);
+#include <stddef.h>
+#include <stdint.h>
 
-void close_db_sqlite3(sqlite3* db);
+// Rows are appended inside a transaction that is committed once
+// DB_SQLITE3_TX_ROWS rows were inserted or DB_SQLITE3_TX_MS elapsed
+#define DB_SQLITE3_TX_ROWS 4096
+#define DB_SQLITE3_TX_MS 100
 
-void write_db_sqlite3(sqlite3* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd);
+typedef struct{
+  sqlite3* handler;
+
+  // Prepared once, reset after every row
+  sqlite3_stmt* mac_ue;
+  sqlite3_stmt* rlc_bearer;
+  sqlite3_stmt* pdcp_bearer;
+  sqlite3_stmt* slice;
+  sqlite3_stmt* ue_slice;
+  sqlite3_stmt* gtp_ngut;
+  sqlite3_stmt* kpm_meas_record;
+  sqlite3_stmt* begin;
+  sqlite3_stmt* commit;
+
+  // Open transaction. tx_start == 0 if none
+  size_t tx_rows;
+  int64_t tx_start;
+} db_sqlite3_t;
+
+void init_db_sqlite3(db_sqlite3_t* db, char const* db_filename);
+
+void close_db_sqlite3(db_sqlite3_t* db);
+
+void write_db_sqlite3(db_sqlite3_t* db, global_e2_node_id_t const* id, sm_ag_if_rd_t const* rd);
+
+// Commit the open transaction, if any
+void flush_db_sqlite3(db_sqlite3_t* db);
 
 #endif
 
@@ -317,25 +317,13 @@ e2_node_arr_t e2_nodes_xapp(e42_xapp_t* xapp)
 }
 
 static
-void send_subscription_request(e42_xapp_t* xapp, global_e2_node_id_t* id, ric_gen_id_t ric_id, inter_xapp_e i)
+void send_subscription_request(e42_xapp_t* xapp, global_e2_node_id_t* id, ric_gen_id_t ric_id, const char* cmd)
 {
   assert(xapp != NULL);
   assert(id != NULL);
+  assert(cmd != NULL);
   assert(xapp->handle_msg[E42_RIC_SUBSCRIPTION_REQUEST]!= NULL);
 
-  char* cmd = NULL;
-  if(i == ms_1 ){
-    cmd = "1_ms";
-  } else if(i == ms_2){
-    cmd = "2_ms";
-  } else if(i == ms_5 ){
-    cmd = "5_ms";
-  } else if(i == ms_10){
-    cmd = "10_ms";
-  } else {
-    assert(0!=0 && "Unsupported interval type. Check the SM on_subscription for details");
-  }
-
   sm_ric_t* sm = sm_plugin_ric(&xapp->plugin_ric, ric_id.ran_func_id);
 
   ric_subscription_request_t sr = generate_subscription_request( ric_id, sm, cmd);
@@ -391,11 +379,33 @@ sm_ans_xapp_t report_sm_sync_xapp(e42_xapp_t* xapp, global_e2_node_id_t* id, uin
   assert(xapp != NULL);
   assert(id != NULL);
 
+  char* cmd = NULL;
+  if(i == ms_1 ){
+    cmd = "1_ms";
+  } else if(i == ms_2){
+    cmd = "2_ms";
+  } else if(i == ms_5 ){
+    cmd = "5_ms";
+  } else if(i == ms_10){
+    cmd = "10_ms";
+  } else {
+    assert(0!=0 && "Unsupported interval type. Check the SM on_subscription for details");
+  }
+
+  return report_sm_cmd_sync_xapp(xapp, id, ran_func_id, cmd, cb);
+}
+
+sm_ans_xapp_t report_sm_cmd_sync_xapp(e42_xapp_t* xapp, global_e2_node_id_t* id, uint16_t ran_func_id, const char* cmd, sm_cb cb)
+{
+  assert(xapp != NULL);
+  assert(id != NULL);
+  assert(cmd != NULL);
+
   // Generate and registry the ric_req_id
   ric_gen_id_t ric_id = generate_ric_gen_id(xapp, RIC_SUBSCRIPTION_PROCEDURE_ACTIVE ,ran_func_id, id, cb);
 
   // Send message 
-  send_subscription_request(xapp, id, ric_id , i);
+  send_subscription_request(xapp, id, ric_id, cmd);
 
   // Wait for the answer (it will arrive in the event loop)
   cond_wait_sync_ui(&xapp->sync, xapp->sync.wait_ms);
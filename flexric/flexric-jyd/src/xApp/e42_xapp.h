@@ -104,6 +104,9 @@ size_t not_dispatch_msg(e42_xapp_t* xapp);
 // We wait for the message to come back and avoid asyncronous programming
 sm_ans_xapp_t report_sm_sync_xapp(e42_xapp_t* xapp, global_e2_node_id_t* id, uint16_t ran_func_id, inter_xapp_e i, sm_cb cb);
 
+// As report_sm_sync_xapp, with the SM subscription command e.g., "100_ms"
+sm_ans_xapp_t report_sm_cmd_sync_xapp(e42_xapp_t* xapp, global_e2_node_id_t* id, uint16_t ran_func_id, const char* cmd, sm_cb cb);
+
 // We wait for the message to come back and avoid asyncronous programming
 void rm_report_sm_sync_xapp(e42_xapp_t* xapp, int handle);
 
@@ -26,11 +26,15 @@
 #include "../lib/ap/e2ap_types/common/e2ap_global_node_id.h"
 #include "../util/alg_ds/alg/defer.h"
 #include "../util/alg_ds/alg/alg.h"
+#include "../sm/mac_sm/mac_sm_id.h"
+#include "../sm/pdcp_sm/pdcp_sm_id.h"
+#include "../sm/rlc_sm/rlc_sm_id.h"
 #include "../sm/slice_sm/slice_sm_id.h"
 #include "../sm/tc_sm/tc_sm_id.h"
 
 #include <signal.h>
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -154,6 +158,37 @@ sm_ans_xapp_t report_sm_xapp_api(global_e2_node_id_t* id, uint32_t sm_id, inter_
   return report_sm_sync_xapp(xapp, id, sm_id, i, handler);
 }
 
+static inline
+bool valid_ev_cond(uint32_t sm_id, const char* cond)
+{
+  if(cond == NULL || cond[0] == '\0' || sm_id == SM_MAC_ID)
+    return true;
+
+  // Only delta coding for the RLC and PDCP SMs
+  assert((sm_id == SM_RLC_ID || sm_id == SM_PDCP_ID) && "Conditions only supported by the MAC SM");
+  assert(strncmp(cond, "delta=", 6) == 0 && strchr(cond, ',') == NULL && "Conditions only supported by the MAC SM");
+  return true;
+}
+
+sm_ans_xapp_t report_sm_ev_xapp_api(global_e2_node_id_t* id, uint32_t sm_id, uint32_t period_ms, const char* cond, sm_cb handler)
+{
+  assert(xapp != NULL);
+  assert(id != NULL);
+  assert(sm_id > 0);
+  assert(period_ms > 0);
+  assert(valid_ev_cond(sm_id, cond) == true);
+
+  assert(valid_global_e2_node(id, &xapp->e2_nodes) == true);
+  assert(valid_sm_id(id, sm_id)  == true);
+
+  char cmd[256] = {0};
+  int const rc = cond == NULL || cond[0] == '\0' ? snprintf(cmd, sizeof(cmd), "%u_ms", period_ms)
+                                                  : snprintf(cmd, sizeof(cmd), "%u_ms,%s", period_ms, cond);
+  assert(rc > 0 && rc < (int)sizeof(cmd) && "Subscription command too long");
+
+  return report_sm_cmd_sync_xapp(xapp, id, sm_id, cmd, handler);
+}
+
 // remove the handle previously returned
 void rm_report_sm_xapp_api(int const handle)
 {
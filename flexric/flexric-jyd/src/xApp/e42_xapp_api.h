@@ -68,6 +68,14 @@ typedef enum{
 // returns a handle
 sm_ans_xapp_t report_sm_xapp_api (global_e2_node_id_t* id, uint32_t sm_id, inter_xapp_e i, sm_cb handler);
 
+// Any period in ms and, optionally, a comma separated list of conditions
+// evaluated at the E2 node, e.g., "wb_cqi<7,dl_bler~0.05". Only the UEs that
+// appeared or fulfill a condition are reported. Conditions: MAC SM only
+// A leading "delta=<N>" asks for delta coded reports with a keyframe every N
+// reports (MAC, RLC and PDCP SMs) e.g., "delta=100,wb_cqi<7"
+// returns a handle
+sm_ans_xapp_t report_sm_ev_xapp_api(global_e2_node_id_t* id, uint32_t sm_id, uint32_t period_ms, const char* cond, sm_cb handler);
+
 // Remove the handle previously returned
 void rm_report_sm_xapp_api(int const handle);
 
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <sched.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -6,40 +7,29 @@
 
 #include "msg_dispatcher_xapp.h"
 
-
-
-static
-msg_dispatch_t static_msg; 
-
-static
-void* create_val(void* it)
-{
-  if(it == NULL)
-    return NULL;
-
- // msg_dispatch_t* msg = calloc(1, sizeof( msg_dispatch_t )); 
-//  assert(msg != NULL && "Memory exhausted");
-
-  memcpy(&static_msg, it, sizeof(msg_dispatch_t ) );
-  
-  return &static_msg;
-}
-
+#define MSG_DISPATCHER_BATCH 32
 
 static
 void* worker_thread(void* arg)
 {
-  tsq_t* q = (tsq_t*)arg;
+  mpsc_queue_t* q = (mpsc_queue_t*)arg;
+
+  msg_dispatch_t msg[MSG_DISPATCHER_BATCH];
 
   while(true){
-    msg_dispatch_t* msg = wait_and_pop_tsq(q,  create_val);
-    if(msg == NULL)
+    size_t const sz = wait_pop_n_mpsc(q, msg, MSG_DISPATCHER_BATCH, -1);
+    // Pending callbacks are discarded once stopped
+    if(stopped_mpsc(q) == true){
+      for(size_t i = 0; i < sz; ++i)
+        free_sm_ag_if_rd(&msg[i].rd);
       break;
+    }
 
-    msg->sm_cb(&msg->rd);
-    free_sm_ag_if_rd(&msg->rd);
+    for(size_t i = 0; i < sz; ++i){
+      msg[i].sm_cb(&msg[i].rd);
+      free_sm_ag_if_rd(&msg[i].rd);
+    }
   }
-  q->stopped = true;
 
   return NULL;
 }
@@ -49,18 +39,28 @@ void init_msg_dispatcher( msg_dispatcher_xapp_t* d)
 {
   assert(d != NULL);
 
-  init_tsq(&d->q, sizeof(msg_dispatch_t));
+  init_mpsc(&d->q, MSG_DISPATCHER_CAP, sizeof(msg_dispatch_t));
   int rc = pthread_create(&d->p, NULL, worker_thread, &d->q);
   assert(rc == 0);
 }
 
+static
+void free_msg_dispatch(void* it)
+{
+  assert(it != NULL);
+
+  msg_dispatch_t* msg = (msg_dispatch_t*)it;
+  free_sm_ag_if_rd(&msg->rd);
+}
+
 void free_msg_dispatcher(msg_dispatcher_xapp_t* d)
 {
   assert(d != NULL);
 
-  free_tsq(&d->q, NULL);
+  stop_mpsc(&d->q);
   int rc = pthread_join(d->p, NULL);
   assert(rc == 0);
+  free_mpsc(&d->q, free_msg_dispatch);
 }
 
 void send_msg_dispatcher( msg_dispatcher_xapp_t* d, msg_dispatch_t* msg )
@@ -68,13 +68,14 @@ void send_msg_dispatcher( msg_dispatcher_xapp_t* d, msg_dispatch_t* msg )
   assert(d != NULL);
   assert(msg != NULL);
 
-  push_tsq(&d->q, msg, sizeof(msg_dispatch_t));
+  // Callbacks are never dropped. Wait for the worker if it lags behind
+  while(push_mpsc(&d->q, msg) == false)
+    sched_yield();
 }
 
 size_t size_msg_dispatcher(msg_dispatcher_xapp_t* d)
 {
   assert(d != NULL);
 
-  return size_tsq(&d->q);
+  return size_mpsc(&d->q);
 }
-
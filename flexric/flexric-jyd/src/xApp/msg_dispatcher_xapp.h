@@ -25,15 +25,17 @@
 #define MESSAGE_DISPATCHER_XAPP_H 
 
 
-#include "../util/alg_ds/ds/ts_queue/ts_queue.h"
+#include "../util/alg_ds/ds/mpsc_queue/mpsc_queue.h"
 #include "../sm/agent_if/read/sm_ag_if_rd.h"
 
 #include <pthread.h>
 
+// Maximum number of callbacks waiting for the worker
+#define MSG_DISPATCHER_CAP 16384
 
 typedef struct{
   pthread_t p;
-  tsq_t q;
+  mpsc_queue_t q;
 } msg_dispatcher_xapp_t;
 
 typedef struct{
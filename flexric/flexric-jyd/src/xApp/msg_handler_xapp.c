@@ -254,6 +254,14 @@ sm_ind_data_t ind_sm_payload(ric_indication_t const* src)
   msg_disp.rd = sm->proc.on_indication(sm,&ind_data);
   assert(msg_disp.rd.type == MAC_STATS_V0 || msg_disp.rd.type == RLC_STATS_V0 || msg_disp.rd.type == PDCP_STATS_V0 || msg_disp.rd.type == SLICE_STATS_V0 || msg_disp.rd.type == KPM_STATS_V0 || msg_disp.rd.type == GTP_STATS_V0);
   
+  // Delta coded indication of a stream joined after its keyframe. Decodable
+  // from the next keyframe, which the nearRT-RIC requests if it also missed it
+  if(ind_data.dropped == true){
+    free_sm_ag_if_rd(&msg_disp.rd);
+    e2ap_msg_t ret = {.type = NONE_E2_MSG_TYPE };
+    return ret;
+  }
+
   act_proc_ans_t ans = find_act_proc(&xapp->act_proc, src->ric_id.ric_req_id);
 
   if(ans.ok == false){
@@ -25,6 +25,17 @@
 #include <unistd.h>
 #include <iostream>
 
+#ifdef XAPP_LANG_PYTHON
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#endif
+
 static
 bool initialized = false;
 
@@ -134,6 +145,19 @@ int report_mac_sm(global_e2_node_id_t* id, Interval inter_arg, mac_cb* handler)
 }
 
 
+int report_mac_sm_ev(global_e2_node_id_t* id, uint32_t period_ms, std::string const& cond, mac_cb* handler)
+{
+  assert(id != NULL);
+  assert(handler != NULL);
+
+  hndlr_mac_cb = handler;
+
+  sm_ans_xapp_t ans = report_sm_ev_xapp_api(id, SM_MAC_ID, period_ms, cond.c_str(), sm_cb_mac);
+  assert(ans.success == true); 
+  return ans.u.handle;
+}
+
+
 void rm_report_mac_sm(int handle)
 {
 
@@ -555,3 +579,399 @@ void rm_report_gtp_sm(int handler)
 #endif
 
 }
+
+#ifdef XAPP_LANG_PYTHON
+
+//////////////////////////////////////
+// Async batched delivery
+/////////////////////////////////////
+
+namespace {
+
+template<typename T>
+struct async_rec_t{
+  int64_t tstamp;
+  T s;
+};
+
+struct rec_field_t{
+  char const* name;
+  char const* code;
+  size_t off;
+  size_t sz;
+};
+
+#define REC_FIELD(T, code, f) rec_field_t{#f, code, offsetof(async_rec_t<T>, s) + offsetof(T, f), sizeof(T::f)}
+
+// PEP 3118 struct format with standard sizes and explicit padding, so that
+// the consumer does not need to know the C alignment rules
+std::string rec_format(std::vector<rec_field_t> const& fields, size_t itemsize)
+{
+  std::string fmt = "T{=q:tstamp:";
+  size_t cur = sizeof(int64_t);
+  for(auto const& f : fields){
+    assert(f.off >= cur);
+    if(f.off > cur)
+      fmt += std::to_string(f.off - cur) + "x";
+    fmt += std::string(f.code) + ":" + f.name + ":";
+    cur = f.off + f.sz;
+  }
+  if(itemsize > cur)
+    fmt += std::to_string(itemsize - cur) + "x";
+  return fmt + "}";
+}
+
+std::vector<rec_field_t> mac_fields()
+{
+  using T = mac_ue_stats_impl_t;
+  return { REC_FIELD(T, "Q", dl_aggr_tbs), REC_FIELD(T, "Q", ul_aggr_tbs), REC_FIELD(T, "Q", dl_aggr_bytes_sdus),
+           REC_FIELD(T, "Q", ul_aggr_bytes_sdus), REC_FIELD(T, "Q", dl_curr_tbs), REC_FIELD(T, "Q", ul_curr_tbs),
+           REC_FIELD(T, "Q", dl_sched_rb), REC_FIELD(T, "Q", ul_sched_rb), REC_FIELD(T, "f", pusch_snr),
+           REC_FIELD(T, "f", pucch_snr), REC_FIELD(T, "f", ul_rssi), REC_FIELD(T, "f", dl_bler),
+           REC_FIELD(T, "f", ul_bler), REC_FIELD(T, "(5)I", dl_harq), REC_FIELD(T, "(5)I", ul_harq),
+           REC_FIELD(T, "I", dl_num_harq), REC_FIELD(T, "I", ul_num_harq), REC_FIELD(T, "I", rnti),
+           REC_FIELD(T, "I", dl_aggr_prb), REC_FIELD(T, "I", ul_aggr_prb), REC_FIELD(T, "I", dl_aggr_sdus),
+           REC_FIELD(T, "I", ul_aggr_sdus), REC_FIELD(T, "I", dl_aggr_retx_prb), REC_FIELD(T, "I", ul_aggr_retx_prb),
+           REC_FIELD(T, "I", bsr), REC_FIELD(T, "H", frame), REC_FIELD(T, "H", slot), REC_FIELD(T, "B", wb_cqi),
+           REC_FIELD(T, "B", dl_mcs1), REC_FIELD(T, "B", ul_mcs1), REC_FIELD(T, "B", dl_mcs2),
+           REC_FIELD(T, "B", ul_mcs2), REC_FIELD(T, "b", phr) };
+}
+
+std::vector<rec_field_t> rlc_fields()
+{
+  using T = rlc_radio_bearer_stats_t;
+  return { REC_FIELD(T, "I", txpdu_pkts), REC_FIELD(T, "I", txpdu_bytes), REC_FIELD(T, "I", txpdu_wt_ms),
+           REC_FIELD(T, "I", txpdu_dd_pkts), REC_FIELD(T, "I", txpdu_dd_bytes), REC_FIELD(T, "I", txpdu_retx_pkts),
+           REC_FIELD(T, "I", txpdu_retx_bytes), REC_FIELD(T, "I", txpdu_segmented),
+           REC_FIELD(T, "I", txpdu_status_pkts), REC_FIELD(T, "I", txpdu_status_bytes),
+           REC_FIELD(T, "I", txbuf_occ_bytes), REC_FIELD(T, "I", txbuf_occ_pkts), REC_FIELD(T, "I", rxpdu_pkts),
+           REC_FIELD(T, "I", rxpdu_bytes), REC_FIELD(T, "I", rxpdu_dup_pkts), REC_FIELD(T, "I", rxpdu_dup_bytes),
+           REC_FIELD(T, "I", rxpdu_dd_pkts), REC_FIELD(T, "I", rxpdu_dd_bytes), REC_FIELD(T, "I", rxpdu_ow_pkts),
+           REC_FIELD(T, "I", rxpdu_ow_bytes), REC_FIELD(T, "I", rxpdu_status_pkts),
+           REC_FIELD(T, "I", rxpdu_status_bytes), REC_FIELD(T, "I", rxbuf_occ_bytes),
+           REC_FIELD(T, "I", rxbuf_occ_pkts), REC_FIELD(T, "I", txsdu_pkts), REC_FIELD(T, "I", txsdu_bytes),
+           REC_FIELD(T, "I", rxsdu_pkts), REC_FIELD(T, "I", rxsdu_bytes), REC_FIELD(T, "I", rxsdu_dd_pkts),
+           REC_FIELD(T, "I", rxsdu_dd_bytes), REC_FIELD(T, "I", rnti), REC_FIELD(T, "B", mode),
+           REC_FIELD(T, "B", rbid) };
+}
+
+std::vector<rec_field_t> pdcp_fields()
+{
+  using T = pdcp_radio_bearer_stats_t;
+  return { REC_FIELD(T, "I", txpdu_pkts), REC_FIELD(T, "I", txpdu_bytes), REC_FIELD(T, "I", txpdu_sn),
+           REC_FIELD(T, "I", rxpdu_pkts), REC_FIELD(T, "I", rxpdu_bytes), REC_FIELD(T, "I", rxpdu_sn),
+           REC_FIELD(T, "I", rxpdu_oo_pkts), REC_FIELD(T, "I", rxpdu_oo_bytes), REC_FIELD(T, "I", rxpdu_dd_pkts),
+           REC_FIELD(T, "I", rxpdu_dd_bytes), REC_FIELD(T, "I", rxpdu_ro_count), REC_FIELD(T, "I", txsdu_pkts),
+           REC_FIELD(T, "I", txsdu_bytes), REC_FIELD(T, "I", rxsdu_pkts), REC_FIELD(T, "I", rxsdu_bytes),
+           REC_FIELD(T, "I", rnti), REC_FIELD(T, "B", mode), REC_FIELD(T, "B", rbid) };
+}
+
+std::vector<rec_field_t> gtp_fields()
+{
+  using T = gtp_ngu_t_stats_t;
+  return { REC_FIELD(T, "I", rnti), REC_FIELD(T, "I", teidgnb), REC_FIELD(T, "B", qfi),
+           REC_FIELD(T, "B", teidupf) };
+}
+
+// Python object that owns the records of a delivered batch and exports them
+// through the buffer protocol, so views outlive the handle() call safely
+struct batch_buf_t{
+  PyObject_HEAD
+  uint8_t* data;
+  char const* format;
+  Py_ssize_t shape[1];
+  Py_ssize_t strides[1];
+};
+
+int batch_buf_getbuffer(PyObject* self, Py_buffer* view, int flags)
+{
+  batch_buf_t* b = (batch_buf_t*)self;
+  if(flags & PyBUF_WRITABLE){
+    PyErr_SetString(PyExc_BufferError, "xApp batch records are read-only");
+    view->obj = NULL;
+    return -1;
+  }
+
+  view->buf = b->data;
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = b->shape[0] * b->strides[0];
+  view->itemsize = b->strides[0];
+  view->readonly = 1;
+  view->ndim = 1;
+  view->format = (flags & PyBUF_FORMAT) ? (char*)b->format : NULL;
+  view->shape = (flags & PyBUF_ND) ? b->shape : NULL;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? b->strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  return 0;
+}
+
+void batch_buf_dealloc(PyObject* self)
+{
+  free(((batch_buf_t*)self)->data);
+  Py_TYPE(self)->tp_free(self);
+}
+
+PyBufferProcs batch_buf_procs = {batch_buf_getbuffer, NULL};
+
+PyTypeObject* batch_buf_type()
+{
+  static PyTypeObject type;
+  static bool ready = false;
+  if(ready == false){
+    type.tp_name = "xapp_sdk.batch_buffer";
+    type.tp_basicsize = sizeof(batch_buf_t);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_dealloc = batch_buf_dealloc;
+    type.tp_as_buffer = &batch_buf_procs;
+    type.tp_new = NULL;
+    int const rc = PyType_Ready(&type);
+    assert(rc == 0);
+    (void)rc;
+    ready = true;
+  }
+  return &type;
+}
+
+// Per SM state. The network thread appends records to buf under mtx, the
+// dispatcher swaps buf for a fresh one every batch_ms and hands the full one
+// over to Python, so the network thread never waits for the GIL
+struct async_sm_t{
+  std::mutex mtx;
+  uint8_t* buf = NULL;
+  uint32_t len = 0;
+  uint64_t dropped = 0;
+
+  uint32_t capacity = 0;
+  uint32_t itemsize = 0;
+  std::string format;
+  batch_cb* handler = NULL;
+  uint32_t batch_ms = 0;
+
+  std::thread dispatcher;
+  std::condition_variable cv;
+  bool stop = false;
+  int refs = 0;
+};
+
+async_sm_t async_mac;
+async_sm_t async_rlc;
+async_sm_t async_pdcp;
+async_sm_t async_gtp;
+
+std::map<int, async_sm_t*> async_handles;
+
+template<typename T>
+void async_push(async_sm_t* st, int64_t tstamp, T const* src, uint32_t n)
+{
+  std::lock_guard<std::mutex> lock(st->mtx);
+  if(st->buf == NULL)
+    return;
+
+  uint32_t const avail = st->capacity - st->len;
+  uint32_t const cp = n < avail ? n : avail;
+  async_rec_t<T>* dst = (async_rec_t<T>*)st->buf + st->len;
+  for(uint32_t i = 0; i < cp; ++i){
+    dst[i].tstamp = tstamp;
+    memcpy(&dst[i].s, &src[i], sizeof(T));
+  }
+  st->len += cp;
+  st->dropped += n - cp;
+}
+
+void async_deliver(async_sm_t* st, uint8_t* data, uint32_t len, uint64_t dropped)
+{
+  PyGILState_STATE gstate = PyGILState_Ensure();
+
+  batch_buf_t* b = PyObject_New(batch_buf_t, batch_buf_type());
+  assert(b != NULL && "Memory exhausted");
+  b->data = data;
+  b->format = st->format.c_str();
+  b->shape[0] = len;
+  b->strides[0] = st->itemsize;
+
+  swig_batch_t batch;
+  batch.len = len;
+  batch.itemsize = st->itemsize;
+  batch.dropped = dropped;
+  batch.format = st->format;
+  batch.buf = (PyObject*)b;
+
+  st->handler->handle(&batch);
+
+  Py_DECREF(b);
+  PyGILState_Release(gstate);
+}
+
+void async_dispatch(async_sm_t* st)
+{
+  size_t const sz = (size_t)st->capacity * st->itemsize;
+  bool stop = false;
+  while(stop == false){
+    uint8_t* fresh = (uint8_t*)malloc(sz);
+    assert(fresh != NULL && "Memory exhausted");
+
+    uint8_t* full = NULL;
+    uint32_t len = 0;
+    uint64_t dropped = 0;
+    {
+      std::unique_lock<std::mutex> lock(st->mtx);
+      st->cv.wait_for(lock, std::chrono::milliseconds(st->batch_ms), [st]{ return st->stop; });
+      stop = st->stop;
+      if(st->len > 0 || st->dropped > 0){
+        full = st->buf;
+        len = st->len;
+        dropped = st->dropped;
+        st->buf = stop ? NULL : fresh;
+        st->len = 0;
+        st->dropped = 0;
+      }
+    }
+
+    if(full == NULL){
+      free(fresh);
+      continue;
+    }
+    if(stop)
+      free(fresh);
+    async_deliver(st, full, len, dropped);
+  }
+
+  std::lock_guard<std::mutex> lock(st->mtx);
+  free(st->buf);
+  st->buf = NULL;
+}
+
+int report_sm_async(async_sm_t* st, global_e2_node_id_t* id, int sm_id, Interval inter_arg, batch_cb* handler,
+                    uint32_t batch_ms, uint32_t capacity, std::vector<rec_field_t> const& fields, size_t itemsize,
+                    void (*cb)(sm_ag_if_rd_t const*))
+{
+  assert(id != NULL);
+  assert(handler != NULL);
+  assert(batch_ms > 0);
+  assert(capacity > 0);
+
+  if(st->refs == 0){
+    st->capacity = capacity;
+    st->itemsize = itemsize;
+    st->format = rec_format(fields, itemsize);
+    st->handler = handler;
+    st->batch_ms = batch_ms;
+    st->stop = false;
+    st->len = 0;
+    st->dropped = 0;
+    st->buf = (uint8_t*)malloc((size_t)capacity * itemsize);
+    assert(st->buf != NULL && "Memory exhausted");
+    batch_buf_type();
+    st->dispatcher = std::thread(async_dispatch, st);
+  }
+  assert(st->handler == handler && "One async handler per SM");
+  st->refs += 1;
+
+  inter_xapp_e i;
+  if(inter_arg == Interval::ms_1 ){
+    i = ms_1;
+  } else if (inter_arg == Interval::ms_2) {
+    i = ms_2;
+  } else if(inter_arg == Interval::ms_5) {
+    i = ms_5;
+  } else if(inter_arg == Interval::ms_10) {
+    i = ms_10;
+  } else {
+    assert(0 != 0 && "Unknown type");
+  }
+
+  sm_ans_xapp_t ans = report_sm_xapp_api(id, sm_id, i, cb);
+  assert(ans.success == true);
+  async_handles[ans.u.handle] = st;
+  return ans.u.handle;
+}
+
+void sm_cb_mac_async(sm_ag_if_rd_t const* rd)
+{
+  assert(rd != NULL);
+  assert(rd->type == MAC_STATS_V0);
+  mac_ind_msg_t const* msg = &rd->mac_stats.msg;
+  async_push(&async_mac, msg->tstamp, msg->ue_stats, msg->len_ue_stats);
+}
+
+void sm_cb_rlc_async(sm_ag_if_rd_t const* rd)
+{
+  assert(rd != NULL);
+  assert(rd->type == RLC_STATS_V0);
+  rlc_ind_msg_t const* msg = &rd->rlc_stats.msg;
+  async_push(&async_rlc, msg->tstamp, msg->rb, msg->len);
+}
+
+void sm_cb_pdcp_async(sm_ag_if_rd_t const* rd)
+{
+  assert(rd != NULL);
+  assert(rd->type == PDCP_STATS_V0);
+  pdcp_ind_msg_t const* msg = &rd->pdcp_stats.msg;
+  async_push(&async_pdcp, msg->tstamp, msg->rb, msg->len);
+}
+
+void sm_cb_gtp_async(sm_ag_if_rd_t const* rd)
+{
+  assert(rd != NULL);
+  assert(rd->type == GTP_STATS_V0);
+  gtp_ind_msg_t const* msg = &rd->gtp_stats.msg;
+  async_push(&async_gtp, msg->tstamp, msg->ngut, msg->len);
+}
+
+}
+
+PyObject* swig_batch_t::records()
+{
+  return PyMemoryView_FromObject(buf);
+}
+
+int report_mac_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity)
+{
+  return report_sm_async(&async_mac, id, SM_MAC_ID, inter, handler, batch_ms, capacity, mac_fields(),
+                         sizeof(async_rec_t<mac_ue_stats_impl_t>), sm_cb_mac_async);
+}
+
+int report_rlc_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity)
+{
+  return report_sm_async(&async_rlc, id, SM_RLC_ID, inter, handler, batch_ms, capacity, rlc_fields(),
+                         sizeof(async_rec_t<rlc_radio_bearer_stats_t>), sm_cb_rlc_async);
+}
+
+int report_pdcp_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity)
+{
+  return report_sm_async(&async_pdcp, id, SM_PDCP_ID, inter, handler, batch_ms, capacity, pdcp_fields(),
+                         sizeof(async_rec_t<pdcp_radio_bearer_stats_t>), sm_cb_pdcp_async);
+}
+
+int report_gtp_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity)
+{
+  return report_sm_async(&async_gtp, id, SM_GTP_ID, inter, handler, batch_ms, capacity, gtp_fields(),
+                         sizeof(async_rec_t<gtp_ngu_t_stats_t>), sm_cb_gtp_async);
+}
+
+void rm_report_sm_async(int handle)
+{
+  auto it = async_handles.find(handle);
+  assert(it != async_handles.end() && "Unknown async handle");
+  async_sm_t* st = it->second;
+  async_handles.erase(it);
+
+  // The dispatcher needs the GIL to deliver the last batch
+  Py_BEGIN_ALLOW_THREADS
+  rm_report_sm_xapp_api(handle);
+
+  st->refs -= 1;
+  if(st->refs == 0){
+    {
+      std::lock_guard<std::mutex> lock(st->mtx);
+      st->stop = true;
+    }
+    st->cv.notify_one();
+    st->dispatcher.join();
+  }
+  Py_END_ALLOW_THREADS
+}
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef SWIG_WRAPPER_H
 #define SWIG_WRAPPER_H 
 
+#ifdef XAPP_LANG_PYTHON
+#include "Python.h"
+#endif
+
 #include <string>
 #include <memory>
 #include <vector>
@@ -54,6 +58,10 @@ struct mac_cb {
 
 int report_mac_sm(global_e2_node_id_t* id, Interval inter, mac_cb* handler);
 
+// Any period and, optionally, conditions evaluated at the E2 node
+// e.g., report_mac_sm_ev(id, 1000, "wb_cqi<7,dl_bler~0.05", handler)
+int report_mac_sm_ev(global_e2_node_id_t* id, uint32_t period_ms, std::string const& cond, mac_cb* handler);
+
 void rm_report_mac_sm(int);
 
 //////////////////////////////////////
@@ -161,5 +169,50 @@ int report_gtp_sm(global_e2_node_id_t* id, Interval inter, gtp_cb* handler);
 
 void rm_report_gtp_sm(int);
 
+#if defined(SWIGPYTHON) || defined(XAPP_LANG_PYTHON)
+
+//////////////////////////////////////
+// Async batched delivery
+/////////////////////////////////////
+
+// The indications are copied as flat records into a bounded buffer on the
+// xApp network thread, and a dispatcher thread hands them over to Python every
+// batch_ms, taking the GIL once per batch. Every record is the SM stats struct
+// (mac_ue_stats_impl_t, rlc_radio_bearer_stats_t, pdcp_radio_bearer_stats_t or
+// gtp_ngu_t_stats_t) prefixed by the tstamp of its indication.
+
+struct swig_batch_t{
+  uint32_t len;       // number of records
+  uint32_t itemsize;  // bytes per record
+  uint64_t dropped;   // records lost since the previous batch, as the buffer was full
+  std::string format; // PEP 3118 format of a record
+
+  // Read-only buffer over the records, without copy. numpy.asarray(b.records())
+  // gives a structured array with one field per member and the tstamp
+  PyObject* records();
+
+#ifndef SWIG
+  PyObject* buf;
+#endif
+};
+
+struct batch_cb {
+    virtual void handle(swig_batch_t* b) = 0;
+    virtual ~batch_cb() {}
+};
+
+// One async handler per SM. Records beyond capacity are dropped until the next batch
+int report_mac_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity);
+
+int report_rlc_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity);
+
+int report_pdcp_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity);
+
+int report_gtp_sm_async(global_e2_node_id_t* id, Interval inter, batch_cb* handler, uint32_t batch_ms, uint32_t capacity);
+
+void rm_report_sm_async(int handle);
+
+#endif
+
 #endif
 
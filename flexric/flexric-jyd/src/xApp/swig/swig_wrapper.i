@@ -83,6 +83,7 @@
 %feature("director") pdcp_cb;
 %feature("director") slice_cb;
 %feature("director") gtp_cb;
+%feature("director") batch_cb;
 
 namespace std {
   %template(IntVector) vector<int>;
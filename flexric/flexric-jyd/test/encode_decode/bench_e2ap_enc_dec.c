@@ -0,0 +1,159 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*
+ * Cost of the E2AP RIC Indication wrapping a service model message, swept
+ * over the number of UEs and bearers per UE. The payload has the size of a
+ * plain encoded RLC indication message of that many bearers. Per point, bytes
+ * on the wire, nanoseconds and heap allocations per message are printed as
+ * CSV with the same columns as bench_sm_enc_dec, so that both outputs can be
+ * concatenated. The E2AP encoding is the one selected at build time.
+ * Points whose message would not fit in the receive buffer of the endpoint
+ * are skipped, as the peer could not read them.
+ *
+ * Link with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc to count allocations.
+ * Usage: bench_e2ap_enc_dec [messages per point]
+ */
+
+#include "../sm/common/alloc_count.h"
+#include "../../src/lib/ap/e2ap_ap.h"
+#include "../../src/lib/ap/enc/e2ap_msg_enc_generic.h"
+#include "../../src/lib/ap/dec/e2ap_msg_dec_generic.h"
+#include "../../src/lib/ap/free/e2ap_msg_free.h"
+#include "../../src/lib/ep/e2ap_ep.h"
+#include "../../src/sm/rlc_sm/ie/rlc_data_ie.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef ASN
+#define E2AP_ENC_NAME "asn"
+#elif FLATBUFFERS
+#define E2AP_ENC_NAME "fb"
+#endif
+
+// Room for the E2AP fields around the payload
+#define E2AP_IND_OVERHEAD 256
+
+static
+uint32_t const num_ues[] = {1, 4, 16, 64, 256};
+
+static
+uint32_t const num_bearers[] = {1, 2, 4, 8};
+
+static
+int64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static
+byte_array_t gen_payload(size_t len)
+{
+  byte_array_t ba = {.len = len};
+  ba.buf = malloc(len);
+  assert(ba.buf != NULL && "Memory exhausted");
+  for(size_t i = 0; i < len; ++i)
+    ba.buf[i] = i * 31;
+  return ba;
+}
+
+static
+void bench_point(e2ap_ap_t* ap, uint32_t ues, uint32_t bearers, uint32_t msgs)
+{
+  size_t const len_msg = sizeof(uint32_t) + sizeof(int64_t) + ues * bearers * sizeof(rlc_radio_bearer_stats_t);
+  if(len_msg + E2AP_IND_OVERHEAD > E2AP_RECV_BUF_SZ){
+    fprintf(stderr, "Skipping %u UEs with %u bearers: a %zu bytes payload does not fit in an E2AP message\n", ues, bearers, len_msg);
+    return;
+  }
+
+  ric_indication_t ind = {
+    .ric_id = {.ric_req_id = 1, .ric_inst_id = 0, .ran_func_id = 143},
+    .action_id = 0,
+    .type = RIC_IND_REPORT,
+    .hdr = gen_payload(sizeof(int64_t)),
+    .msg = gen_payload(len_msg),
+  };
+
+  uint64_t bytes = 0;
+  uint64_t enc_allocs = 0;
+  uint64_t dec_allocs = 0;
+  int64_t enc_ns = 0;
+  int64_t dec_ns = 0;
+
+  for(uint32_t n = 0; n < msgs; ++n){
+    memcpy(ind.hdr.buf, &n, sizeof(n));
+
+    uint64_t const a0 = alloc_count();
+    int64_t const t0 = now_ns();
+    byte_array_t ba = e2ap_enc_indication_gen(&ap->type, &ind);
+    int64_t const t1 = now_ns();
+    uint64_t const a1 = alloc_count();
+    e2ap_msg_t msg = e2ap_msg_dec_gen(&ap->type, ba);
+    int64_t const t2 = now_ns();
+    uint64_t const a2 = alloc_count();
+
+    assert(msg.type == RIC_INDICATION);
+    assert(msg.u_msgs.ric_ind.msg.len == len_msg);
+
+    bytes += ba.len;
+    enc_ns += t1 - t0;
+    dec_ns += t2 - t1;
+    enc_allocs += a1 - a0;
+    dec_allocs += a2 - a1;
+
+    e2ap_free_indication_msg(&msg);
+    free_byte_array(ba);
+  }
+
+  e2ap_free_indication(&ind);
+
+  printf("e2ap_ind,%s,%u,%u,%.1f,%.1f,%.1f,%.2f,%.2f\n", E2AP_ENC_NAME, ues, bearers,
+      (double)bytes / msgs, (double)enc_ns / msgs, (double)dec_ns / msgs,
+      (double)enc_allocs / msgs, (double)dec_allocs / msgs);
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t const msgs = argc > 1 ? strtoul(argv[1], NULL, 10) : 256;
+  assert(msgs > 0);
+
+  e2ap_ap_t ap = {0};
+  init_ap(&ap.type);
+
+  printf("sm,encoding,ues,bearers,bytes,enc_ns,dec_ns,enc_allocs,dec_allocs\n");
+
+  size_t const len_ues = sizeof(num_ues) / sizeof(num_ues[0]);
+  size_t const len_bearers = sizeof(num_bearers) / sizeof(num_bearers[0]);
+  for(size_t u = 0; u < len_ues; ++u)
+    for(size_t b = 0; b < len_bearers; ++b)
+      bench_point(&ap, num_ues[u], num_bearers[b], msgs);
+
+  return EXIT_SUCCESS;
+}
+
@@ -185,12 +185,15 @@ void test_indication()
 
   byte_array_t ba = e2ap_enc_indication_fb(&ind_begin);
   e2ap_msg_t msg = e2ap_msg_dec_fb(&fb_type, ba);
-  free(ba.buf);
 
   assert(msg.type == RIC_INDICATION);
   ric_indication_t* ind_end = &msg.u_msgs.ric_ind;
+  // The decoded header and message borrow the encoded buffer
+  assert(ind_end->borrowed == true);
+  assert(ind_end->msg.buf >= ba.buf && ind_end->msg.buf < ba.buf + ba.len);
   assert(eq_ric_indication(&ind_begin, ind_end));
   e2ap_free_indication(ind_end);
+  free(ba.buf);
 }
 
 void test_control_request()
@@ -0,0 +1,199 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+
+// Starts the redis-server given as argument on a free port and checks the
+// streams written by the Redis iApp exporter
+
+#include "../../src/ric/iApps/redis.h"
+#include "../../src/sm/mac_sm/ie/mac_data_ie.h"
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_UES 20
+#define MAXLEN 100
+
+static
+char const* server_path;
+
+static
+int port;
+
+static
+pid_t start_server(void)
+{
+  char port_str[16];
+  snprintf(port_str, sizeof(port_str), "%d", port);
+
+  pid_t const pid = fork();
+  assert(pid > -1);
+  if(pid == 0){
+    execl(server_path, server_path, "--port", port_str, "--save", "", "--appendonly", "no", (char*)NULL);
+    _exit(EXIT_FAILURE);
+  }
+  return pid;
+}
+
+static
+void stop_server(pid_t pid)
+{
+  kill(pid, SIGTERM);
+  waitpid(pid, NULL, 0);
+}
+
+// Blocking client used to verify what the exporter wrote
+static
+int connect_client(void)
+{
+  struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+  for(int i = 0; i < 200; ++i){
+    int const fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(fd > -1);
+    if(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0)
+      return fd;
+    close(fd);
+    usleep(10000);
+  }
+  assert(0 != 0 && "redis-server did not start");
+  return -1;
+}
+
+static
+size_t query(int fd, char const* cmd, char* out, size_t out_len)
+{
+  ssize_t rc = send(fd, cmd, strlen(cmd), 0);
+  assert(rc == (ssize_t)strlen(cmd));
+
+  // Every reply checked here fits in one read
+  usleep(20000);
+  rc = recv(fd, out, out_len - 1, 0);
+  assert(rc > 0);
+  out[rc] = '\0';
+  return rc;
+}
+
+static
+long xlen(int fd, char const* key)
+{
+  char cmd[256];
+  snprintf(cmd, sizeof(cmd), "*2\r\n$4\r\nXLEN\r\n$%zu\r\n%s\r\n", strlen(key), key);
+  char ans[64];
+  query(fd, cmd, ans, sizeof(ans));
+  assert(ans[0] == ':');
+  return strtol(ans + 1, NULL, 10);
+}
+
+static
+sm_ag_if_rd_t generate_mac(uint32_t seq)
+{
+  sm_ag_if_rd_t d = {.type = MAC_STATS_V0};
+  mac_ind_msg_t* msg = &d.mac_stats.msg;
+  msg->tstamp = seq;
+  msg->len_ue_stats = NUM_UES;
+  msg->ue_stats = calloc(NUM_UES, sizeof(mac_ue_stats_impl_t));
+  assert(msg->ue_stats != NULL);
+  for(uint32_t i = 0; i < NUM_UES; ++i){
+    msg->ue_stats[i].rnti = 100 + i;
+    msg->ue_stats[i].frame = seq;
+    msg->ue_stats[i].pusch_snr = 12.5;
+  }
+  return d;
+}
+
+static
+void notify(global_e2_node_id_t const* id, uint32_t seq)
+{
+  sm_ag_if_rd_t d = generate_mac(seq);
+  notify_redis_listener(id, &d);
+  free(d.mac_stats.msg.ue_stats);
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc < 2){
+    printf("Usage: %s <redis-server>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  server_path = argv[1];
+  port = 20000 + getpid() % 20000;
+
+  redis_conf_t conf = default_redis_conf();
+  conf.port = port;
+  conf.prefix = "test";
+  conf.maxlen = MAXLEN;
+  conf_redis_listener(&conf);
+
+  pid_t pid = start_server();
+  int fd = connect_client();
+
+  // One entry per UE in the stream of its E2 Node
+  global_e2_node_id_t node_0 = {.type = ngran_gNB, .plmn = {.mcc = 505, .mnc = 1, .mnc_digit_len = 2}, .nb_id = 1};
+  notify(&node_0, 0);
+  assert(flush_redis_listener(2000) == true);
+  assert(xlen(fd, "test:505:1:1:mac") == NUM_UES);
+
+  char ans[8192];
+  query(fd, "*6\r\n$6\r\nXRANGE\r\n$16\r\ntest:505:1:1:mac\r\n$1\r\n-\r\n$1\r\n+\r\n$5\r\nCOUNT\r\n$1\r\n1\r\n", ans, sizeof(ans));
+  assert(strstr(ans, "$4\r\nrnti\r\n$3\r\n100\r\n") != NULL);
+  assert(strstr(ans, "$9\r\npusch_snr\r\n$4\r\n12.5\r\n") != NULL);
+
+  // Pipelined commands are trimmed with MAXLEN ~
+  global_e2_node_id_t node_1 = node_0;
+  node_1.nb_id = 2;
+  for(uint32_t seq = 0; seq < 50; ++seq)
+    notify(&node_1, seq);
+  assert(flush_redis_listener(2000) == true);
+  long const len = xlen(fd, "test:505:1:2:mac");
+  assert(len >= MAXLEN && len < 50 * NUM_UES);
+
+  // Records are buffered while the server is down and sent after reconnecting
+  close(fd);
+  stop_server(pid);
+  for(uint32_t seq = 0; seq < 5; ++seq)
+    notify(&node_0, seq);
+  pid = start_server();
+  fd = connect_client();
+  assert(flush_redis_listener(5000) == true);
+  assert(xlen(fd, "test:505:1:1:mac") == 5 * NUM_UES);
+
+  redis_stats_t const s = stats_redis_listener();
+  assert(s.queued_records == 56 * NUM_UES);
+  assert(s.dropped_records == 0);
+  assert(s.replies_err == 0);
+  assert(s.connects >= 2);
+
+  close(fd);
+  stop_server(pid);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#include "../../src/ric/shard_ric.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_SHARDS 4
+#define NUM_NODES 32
+#define MSGS_PER_NODE 10000
+
+// Written by the shard owning the E2 Node only
+static
+uint32_t next_seq[NUM_NODES];
+
+static
+void check_order(void* ctx, sctp_msg_t* msg)
+{
+  assert(ctx != NULL);
+  assert(msg != NULL && msg->type == SCTP_MSG_PAYLOAD);
+
+  uint32_t const node = msg->info.addr.sin_port;
+  assert(node < NUM_NODES);
+
+  uint32_t seq = 0;
+  assert(msg->ba.len == sizeof(seq));
+  memcpy(&seq, msg->ba.buf, sizeof(seq));
+
+  // Messages of one E2 Node are processed in arrival order
+  assert(seq == next_seq[node]);
+  next_seq[node] += 1;
+}
+
+static
+atomic_size_t drained_calls;
+
+static
+void count_drained(void* ctx)
+{
+  assert(ctx != NULL);
+  drained_calls += 1;
+}
+
+static
+sctp_msg_t generate_msg(uint32_t node, uint32_t seq)
+{
+  sctp_msg_t msg = {.type = SCTP_MSG_PAYLOAD};
+  msg.info.addr.sin_port = node;
+  msg.ba.len = sizeof(seq);
+  msg.ba.buf = malloc(sizeof(seq));
+  assert(msg.ba.buf != NULL && "Memory exhausted");
+  memcpy(msg.ba.buf, &seq, sizeof(seq));
+  return msg;
+}
+
+int main()
+{
+  shard_ric_t shards[NUM_SHARDS];
+
+  // Small rings to exercise the backpressure
+  int ctx = 0;
+  for(size_t i = 0; i < NUM_SHARDS; ++i)
+    init_shard_ric(&shards[i], 8, -1, check_order, count_drained, &ctx);
+
+  for(uint32_t seq = 0; seq < MSGS_PER_NODE; ++seq){
+    for(uint32_t node = 0; node < NUM_NODES; ++node){
+      sctp_msg_t msg = generate_msg(node, seq);
+      push_shard_ric(&shards[node % NUM_SHARDS], &msg);
+    }
+  }
+
+  // Drains the rings
+  size_t processed = 0;
+  for(size_t i = 0; i < NUM_SHARDS; ++i){
+    free_shard_ric(&shards[i]);
+    processed += processed_shard_ric(&shards[i]);
+  }
+
+  assert(processed == NUM_NODES * MSGS_PER_NODE);
+  for(size_t i = 0; i < NUM_NODES; ++i)
+    assert(next_seq[i] == MSGS_PER_NODE);
+
+  // Every worker drains its ring at least once, before stopping
+  assert(drained_calls >= NUM_SHARDS);
+
+  printf("Shard RIC test succeeded\n");
+  return EXIT_SUCCESS;
+}
+
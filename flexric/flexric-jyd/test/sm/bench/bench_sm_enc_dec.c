@@ -0,0 +1,620 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*
+ * Encoding and decoding cost of the service model indication messages, swept
+ * over the number of UEs and bearers per UE. Per point, bytes on the wire,
+ * nanoseconds and heap allocations per message are printed as CSV.
+ * Consecutive messages of a point advance the counters of every record as a
+ * report period would, so that the delta coded encoding sees realistic
+ * changes and a keyframe every DELTA_KEYFRAME messages.
+ *
+ * Only the encodings that are implemented are benchmarked: plain (full,
+ * reusing the buffer, and delta coded) for MAC, RLC and PDCP, plain for SLICE
+ * and ASN.1 for KPM. The MAC, RLC, PDCP and SLICE ASN.1 and FlatBuffers
+ * encoders are not implemented.
+ *
+ * Link with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc to count allocations.
+ * Usage: bench_sm_enc_dec [messages per point]
+ */
+
+#include "../common/alloc_count.h"
+#include "../../../src/sm/mac_sm/enc/mac_enc_plain.h"
+#include "../../../src/sm/mac_sm/dec/mac_dec_plain.h"
+#include "../../../src/sm/rlc_sm/enc/rlc_enc_plain.h"
+#include "../../../src/sm/rlc_sm/dec/rlc_dec_plain.h"
+#include "../../../src/sm/pdcp_sm/enc/pdcp_enc_plain.h"
+#include "../../../src/sm/pdcp_sm/dec/pdcp_dec_plain.h"
+#include "../../../src/sm/slice_sm/enc/slice_enc_plain.h"
+#include "../../../src/sm/slice_sm/dec/slice_dec_plain.h"
+#include "../../../src/sm/kpm_sm_v2.02/enc/kpm_enc_asn.h"
+#include "../../../src/sm/kpm_sm_v2.02/dec/kpm_dec_asn.h"
+#include "../../../src/util/byte_array.h"
+#include "../../../src/util/delta_codec.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DELTA_KEYFRAME 16
+
+static
+uint32_t const num_ues[] = {1, 4, 16, 64, 256};
+
+static
+uint32_t const num_bearers[] = {1, 2, 4, 8};
+
+typedef struct{
+  byte_array_t ba;
+  size_t cap;
+  bool reuse; // ba is kept across messages
+  delta_enc_t enc;
+  delta_dec_t dec;
+} codec_t;
+
+typedef struct{
+  char const* sm;
+  char const* encoding;
+  // Records per UE. The bearers of the sweep are ignored otherwise
+  bool per_bearer;
+
+  void* (*gen)(uint32_t ues, uint32_t bearers);
+  // Advance the counters one report period
+  void (*step)(void* msg, uint32_t n);
+  void (*free_msg)(void* msg);
+
+  void (*init)(codec_t* c);
+  void (*free)(codec_t* c);
+  void (*enc)(codec_t* c, void const* msg);
+  // Decodes c->ba and checks the number of records against msg
+  void (*dec)(codec_t* c, void const* msg);
+} bench_case_t;
+
+static
+int64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Deterministic growth of a counter, different per record and period
+static
+uint32_t inc(uint32_t n, uint32_t i, uint32_t mod)
+{
+  return (n * 2654435761u + i * 40503u) % mod;
+}
+
+static
+void init_nop(codec_t* c)
+{
+  (void)c;
+}
+
+static
+void free_nop(codec_t* c)
+{
+  (void)c;
+}
+
+static
+void init_reuse(codec_t* c)
+{
+  c->reuse = true;
+}
+
+static
+void free_reuse(codec_t* c)
+{
+  free_byte_array(c->ba);
+}
+
+/////
+// MAC
+/////
+
+static
+void* gen_mac(uint32_t ues, uint32_t bearers)
+{
+  (void)bearers;
+  mac_ind_msg_t* msg = calloc(1, sizeof(mac_ind_msg_t));
+  assert(msg != NULL && "Memory exhausted");
+  msg->len_ue_stats = ues;
+  msg->ue_stats = calloc(ues, sizeof(mac_ue_stats_impl_t));
+  assert(msg->ue_stats != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < ues; ++i){
+    mac_ue_stats_impl_t* ue = &msg->ue_stats[i];
+    ue->rnti = 0x4601 + i;
+    ue->pusch_snr = 20.0 + i % 10;
+    ue->pucch_snr = 15.0 + i % 10;
+    ue->wb_cqi = 7 + i % 8;
+    ue->dl_mcs1 = 20 + i % 8;
+    ue->ul_mcs1 = 16 + i % 8;
+    ue->dl_num_harq = 4;
+    ue->ul_num_harq = 4;
+  }
+  return msg;
+}
+
+static
+void step_mac(void* m, uint32_t n)
+{
+  mac_ind_msg_t* msg = (mac_ind_msg_t*)m;
+  msg->tstamp += 1000;
+  for(uint32_t i = 0; i < msg->len_ue_stats; ++i){
+    mac_ue_stats_impl_t* ue = &msg->ue_stats[i];
+    ue->dl_curr_tbs = inc(n, i, 20000);
+    ue->ul_curr_tbs = inc(n, i, 8000);
+    ue->dl_aggr_tbs += ue->dl_curr_tbs;
+    ue->ul_aggr_tbs += ue->ul_curr_tbs;
+    ue->dl_aggr_bytes_sdus += ue->dl_curr_tbs - ue->dl_curr_tbs / 16;
+    ue->ul_aggr_bytes_sdus += ue->ul_curr_tbs - ue->ul_curr_tbs / 16;
+    ue->dl_aggr_prb += inc(n, i, 50);
+    ue->ul_aggr_prb += inc(n, i, 25);
+    ue->dl_aggr_sdus += inc(n, i, 20);
+    ue->ul_aggr_sdus += inc(n, i, 10);
+    ue->bsr = inc(n, i, 3000);
+    ue->frame = n % 1024;
+  }
+}
+
+static
+void free_mac(void* m)
+{
+  free_mac_ind_msg(m);
+  free(m);
+}
+
+static
+void enc_mac_plain(codec_t* c, void const* msg)
+{
+  c->ba = mac_enc_ind_msg_plain(msg);
+}
+
+static
+void enc_mac_reuse(codec_t* c, void const* msg)
+{
+  mac_enc_ind_msg_reuse_plain(msg, &c->ba, &c->cap);
+}
+
+static
+void dec_mac_plain(codec_t* c, void const* msg)
+{
+  mac_ind_msg_t out = mac_dec_ind_msg_plain(c->ba.len, c->ba.buf);
+  assert(out.len_ue_stats == ((mac_ind_msg_t const*)msg)->len_ue_stats);
+  free_mac_ind_msg(&out);
+}
+
+static
+void init_mac_delta(codec_t* c)
+{
+  init_delta_enc(&c->enc, sizeof(mac_ue_stats_impl_t), DELTA_KEYFRAME, mac_delta_key_plain);
+  init_delta_dec(&c->dec, sizeof(mac_ue_stats_impl_t));
+  c->reuse = true;
+}
+
+static
+void free_delta(codec_t* c)
+{
+  free_delta_enc(&c->enc);
+  free_delta_dec(&c->dec);
+  free_byte_array(c->ba);
+}
+
+static
+void enc_mac_delta(codec_t* c, void const* msg)
+{
+  mac_enc_ind_msg_delta_plain(&c->enc, msg, &c->ba, &c->cap);
+}
+
+static
+void dec_mac_delta(codec_t* c, void const* msg)
+{
+  mac_ind_msg_t out = {0};
+  delta_dec_e const rc = mac_dec_ind_msg_delta_plain(&c->dec, c->ba.len, c->ba.buf, &out);
+  assert(rc == DELTA_DEC_OK);
+  assert(out.len_ue_stats == ((mac_ind_msg_t const*)msg)->len_ue_stats);
+  free_mac_ind_msg(&out);
+}
+
+/////
+// RLC
+/////
+
+static
+void* gen_rlc(uint32_t ues, uint32_t bearers)
+{
+  rlc_ind_msg_t* msg = calloc(1, sizeof(rlc_ind_msg_t));
+  assert(msg != NULL && "Memory exhausted");
+  msg->len = ues * bearers;
+  msg->rb = calloc(msg->len, sizeof(rlc_radio_bearer_stats_t));
+  assert(msg->rb != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < msg->len; ++i){
+    msg->rb[i].rnti = 0x4601 + i / bearers;
+    msg->rb[i].rbid = 1 + i % bearers;
+    msg->rb[i].mode = 0;
+  }
+  return msg;
+}
+
+static
+void step_rlc(void* m, uint32_t n)
+{
+  rlc_ind_msg_t* msg = (rlc_ind_msg_t*)m;
+  msg->tstamp += 1000;
+  for(uint32_t i = 0; i < msg->len; ++i){
+    rlc_radio_bearer_stats_t* rb = &msg->rb[i];
+    uint32_t const tx = inc(n, i, 64);
+    uint32_t const rx = inc(n, i, 32);
+    rb->txpdu_pkts += tx;
+    rb->txpdu_bytes += tx * 1400;
+    rb->rxpdu_pkts += rx;
+    rb->rxpdu_bytes += rx * 1400;
+    rb->txbuf_occ_bytes = inc(n, i, 50000);
+    rb->txbuf_occ_pkts = rb->txbuf_occ_bytes / 1400;
+    rb->txpdu_wt_ms += tx / 8;
+  }
+}
+
+static
+void free_rlc(void* m)
+{
+  free_rlc_ind_msg(m);
+  free(m);
+}
+
+static
+void enc_rlc_plain(codec_t* c, void const* msg)
+{
+  c->ba = rlc_enc_ind_msg_plain(msg);
+}
+
+static
+void enc_rlc_reuse(codec_t* c, void const* msg)
+{
+  rlc_enc_ind_msg_reuse_plain(msg, &c->ba, &c->cap);
+}
+
+static
+void dec_rlc_plain(codec_t* c, void const* msg)
+{
+  rlc_ind_msg_t out = rlc_dec_ind_msg_plain(c->ba.len, c->ba.buf);
+  assert(out.len == ((rlc_ind_msg_t const*)msg)->len);
+  free_rlc_ind_msg(&out);
+}
+
+static
+void init_rlc_delta(codec_t* c)
+{
+  init_delta_enc(&c->enc, sizeof(rlc_radio_bearer_stats_t), DELTA_KEYFRAME, rlc_delta_key_plain);
+  init_delta_dec(&c->dec, sizeof(rlc_radio_bearer_stats_t));
+  c->reuse = true;
+}
+
+static
+void enc_rlc_delta(codec_t* c, void const* msg)
+{
+  rlc_enc_ind_msg_delta_plain(&c->enc, msg, &c->ba, &c->cap);
+}
+
+static
+void dec_rlc_delta(codec_t* c, void const* msg)
+{
+  rlc_ind_msg_t out = {0};
+  delta_dec_e const rc = rlc_dec_ind_msg_delta_plain(&c->dec, c->ba.len, c->ba.buf, &out);
+  assert(rc == DELTA_DEC_OK);
+  assert(out.len == ((rlc_ind_msg_t const*)msg)->len);
+  free_rlc_ind_msg(&out);
+}
+
+/////
+// PDCP
+/////
+
+static
+void* gen_pdcp(uint32_t ues, uint32_t bearers)
+{
+  pdcp_ind_msg_t* msg = calloc(1, sizeof(pdcp_ind_msg_t));
+  assert(msg != NULL && "Memory exhausted");
+  msg->len = ues * bearers;
+  msg->rb = calloc(msg->len, sizeof(pdcp_radio_bearer_stats_t));
+  assert(msg->rb != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < msg->len; ++i){
+    msg->rb[i].rnti = 0x4601 + i / bearers;
+    msg->rb[i].rbid = 1 + i % bearers;
+  }
+  return msg;
+}
+
+static
+void step_pdcp(void* m, uint32_t n)
+{
+  pdcp_ind_msg_t* msg = (pdcp_ind_msg_t*)m;
+  msg->tstamp += 1000;
+  for(uint32_t i = 0; i < msg->len; ++i){
+    pdcp_radio_bearer_stats_t* rb = &msg->rb[i];
+    uint32_t const tx = inc(n, i, 64);
+    uint32_t const rx = inc(n, i, 32);
+    rb->txpdu_pkts += tx;
+    rb->txpdu_bytes += tx * 1400;
+    rb->txpdu_sn = (rb->txpdu_sn + tx) % 4096;
+    rb->rxpdu_pkts += rx;
+    rb->rxpdu_bytes += rx * 1400;
+    rb->rxpdu_sn = (rb->rxpdu_sn + rx) % 4096;
+  }
+}
+
+static
+void free_pdcp(void* m)
+{
+  free_pdcp_ind_msg(m);
+  free(m);
+}
+
+static
+void enc_pdcp_plain(codec_t* c, void const* msg)
+{
+  c->ba = pdcp_enc_ind_msg_plain(msg);
+}
+
+static
+void enc_pdcp_reuse(codec_t* c, void const* msg)
+{
+  pdcp_enc_ind_msg_reuse_plain(msg, &c->ba, &c->cap);
+}
+
+static
+void dec_pdcp_plain(codec_t* c, void const* msg)
+{
+  pdcp_ind_msg_t out = pdcp_dec_ind_msg_plain(c->ba.len, c->ba.buf);
+  assert(out.len == ((pdcp_ind_msg_t const*)msg)->len);
+  free_pdcp_ind_msg(&out);
+}
+
+static
+void init_pdcp_delta(codec_t* c)
+{
+  init_delta_enc(&c->enc, sizeof(pdcp_radio_bearer_stats_t), DELTA_KEYFRAME, pdcp_delta_key_plain);
+  init_delta_dec(&c->dec, sizeof(pdcp_radio_bearer_stats_t));
+  c->reuse = true;
+}
+
+static
+void enc_pdcp_delta(codec_t* c, void const* msg)
+{
+  pdcp_enc_ind_msg_delta_plain(&c->enc, msg, &c->ba, &c->cap);
+}
+
+static
+void dec_pdcp_delta(codec_t* c, void const* msg)
+{
+  pdcp_ind_msg_t out = {0};
+  delta_dec_e const rc = pdcp_dec_ind_msg_delta_plain(&c->dec, c->ba.len, c->ba.buf, &out);
+  assert(rc == DELTA_DEC_OK);
+  assert(out.len == ((pdcp_ind_msg_t const*)msg)->len);
+  free_pdcp_ind_msg(&out);
+}
+
+/////
+// SLICE
+/////
+
+// One slice per bearer and the association of every UE to a slice
+static
+void* gen_slice(uint32_t ues, uint32_t bearers)
+{
+  slice_ind_msg_t* msg = calloc(1, sizeof(slice_ind_msg_t));
+  assert(msg != NULL && "Memory exhausted");
+
+  msg->ue_slice_conf.len_ue_slice = ues;
+  msg->ue_slice_conf.ues = calloc(ues, sizeof(ue_slice_assoc_t));
+  assert(msg->ue_slice_conf.ues != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < ues; ++i){
+    msg->ue_slice_conf.ues[i].rnti = 0x4601 + i;
+    msg->ue_slice_conf.ues[i].dl_id = i % bearers;
+    msg->ue_slice_conf.ues[i].ul_id = i % bearers;
+  }
+
+  msg->len_slice_stats = bearers;
+  msg->slice_stats = calloc(bearers, sizeof(fr_slice_stats_t));
+  assert(msg->slice_stats != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < bearers; ++i)
+    msg->slice_stats[i].id = i;
+
+  return msg;
+}
+
+static
+void step_slice(void* m, uint32_t n)
+{
+  slice_ind_msg_t* msg = (slice_ind_msg_t*)m;
+  msg->tstamp += 1000;
+  for(uint32_t i = 0; i < msg->len_slice_stats; ++i)
+    msg->slice_stats[i].ul_alloc_prbs += inc(n, i, 1000);
+}
+
+static
+void free_slice(void* m)
+{
+  free_slice_ind_msg(m);
+  free(m);
+}
+
+static
+void enc_slice_plain(codec_t* c, void const* msg)
+{
+  c->ba = slice_enc_ind_msg_plain(msg);
+}
+
+static
+void dec_slice_plain(codec_t* c, void const* msg)
+{
+  slice_ind_msg_t out = slice_dec_ind_msg_plain(c->ba.len, c->ba.buf);
+  assert(out.ue_slice_conf.len_ue_slice == ((slice_ind_msg_t const*)msg)->ue_slice_conf.len_ue_slice);
+  free_slice_ind_msg(&out);
+}
+
+/////
+// KPM
+/////
+
+// One measurement data item per UE with a record per bearer
+static
+void* gen_kpm(uint32_t ues, uint32_t bearers)
+{
+  kpm_ind_msg_t* msg = calloc(1, sizeof(kpm_ind_msg_t));
+  assert(msg != NULL && "Memory exhausted");
+  msg->MeasData_len = ues;
+  msg->MeasData = calloc(ues, sizeof(adapter_MeasDataItem_t));
+  assert(msg->MeasData != NULL && "Memory exhausted");
+  for(uint32_t i = 0; i < ues; ++i){
+    adapter_MeasDataItem_t* item = &msg->MeasData[i];
+    item->incompleteFlag = -1;
+    item->measRecord_len = bearers;
+    item->measRecord = calloc(bearers, sizeof(adapter_MeasRecord_t));
+    assert(item->measRecord != NULL && "Memory exhausted");
+    for(uint32_t j = 0; j < bearers; ++j)
+      item->measRecord[j].type = MeasRecord_int;
+  }
+  return msg;
+}
+
+static
+void step_kpm(void* m, uint32_t n)
+{
+  kpm_ind_msg_t* msg = (kpm_ind_msg_t*)m;
+  for(uint32_t i = 0; i < msg->MeasData_len; ++i){
+    adapter_MeasDataItem_t* item = &msg->MeasData[i];
+    for(uint32_t j = 0; j < item->measRecord_len; ++j)
+      item->measRecord[j].int_val += inc(n, i * 8 + j, 90000);
+  }
+}
+
+static
+void free_kpm(void* m)
+{
+  free_kpm_ind_msg(m);
+  free(m);
+}
+
+static
+void enc_kpm_asn(codec_t* c, void const* msg)
+{
+  c->ba = kpm_enc_ind_msg_asn(msg);
+}
+
+static
+void dec_kpm_asn(codec_t* c, void const* msg)
+{
+  kpm_ind_msg_t out = kpm_dec_ind_msg_asn(c->ba.len, c->ba.buf);
+  assert(out.MeasData_len == ((kpm_ind_msg_t const*)msg)->MeasData_len);
+  free_kpm_ind_msg(&out);
+}
+
+static
+bench_case_t const cases[] = {
+  {"mac", "plain", false, gen_mac, step_mac, free_mac, init_nop, free_nop, enc_mac_plain, dec_mac_plain},
+  {"mac", "plain_reuse", false, gen_mac, step_mac, free_mac, init_reuse, free_reuse, enc_mac_reuse, dec_mac_plain},
+  {"mac", "plain_delta", false, gen_mac, step_mac, free_mac, init_mac_delta, free_delta, enc_mac_delta, dec_mac_delta},
+
+  {"rlc", "plain", true, gen_rlc, step_rlc, free_rlc, init_nop, free_nop, enc_rlc_plain, dec_rlc_plain},
+  {"rlc", "plain_reuse", true, gen_rlc, step_rlc, free_rlc, init_reuse, free_reuse, enc_rlc_reuse, dec_rlc_plain},
+  {"rlc", "plain_delta", true, gen_rlc, step_rlc, free_rlc, init_rlc_delta, free_delta, enc_rlc_delta, dec_rlc_delta},
+
+  {"pdcp", "plain", true, gen_pdcp, step_pdcp, free_pdcp, init_nop, free_nop, enc_pdcp_plain, dec_pdcp_plain},
+  {"pdcp", "plain_reuse", true, gen_pdcp, step_pdcp, free_pdcp, init_reuse, free_reuse, enc_pdcp_reuse, dec_pdcp_plain},
+  {"pdcp", "plain_delta", true, gen_pdcp, step_pdcp, free_pdcp, init_pdcp_delta, free_delta, enc_pdcp_delta, dec_pdcp_delta},
+
+  {"slice", "plain", true, gen_slice, step_slice, free_slice, init_nop, free_nop, enc_slice_plain, dec_slice_plain},
+
+  {"kpm", "asn", true, gen_kpm, step_kpm, free_kpm, init_nop, free_nop, enc_kpm_asn, dec_kpm_asn},
+};
+
+static
+void bench_point(bench_case_t const* bc, uint32_t ues, uint32_t bearers, uint32_t msgs)
+{
+  void* msg = bc->gen(ues, bearers);
+  codec_t c = {0};
+  bc->init(&c);
+
+  uint64_t bytes = 0;
+  uint64_t enc_allocs = 0;
+  uint64_t dec_allocs = 0;
+  int64_t enc_ns = 0;
+  int64_t dec_ns = 0;
+
+  for(uint32_t n = 0; n < msgs; ++n){
+    bc->step(msg, n);
+
+    uint64_t const a0 = alloc_count();
+    int64_t const t0 = now_ns();
+    bc->enc(&c, msg);
+    int64_t const t1 = now_ns();
+    uint64_t const a1 = alloc_count();
+    bc->dec(&c, msg);
+    int64_t const t2 = now_ns();
+    uint64_t const a2 = alloc_count();
+
+    bytes += c.ba.len;
+    enc_ns += t1 - t0;
+    dec_ns += t2 - t1;
+    enc_allocs += a1 - a0;
+    dec_allocs += a2 - a1;
+
+    if(c.reuse == false)
+      free_byte_array(c.ba);
+  }
+
+  bc->free(&c);
+  bc->free_msg(msg);
+
+  printf("%s,%s,%u,%u,%.1f,%.1f,%.1f,%.2f,%.2f\n", bc->sm, bc->encoding, ues, bc->per_bearer ? bearers : 0,
+      (double)bytes / msgs, (double)enc_ns / msgs, (double)dec_ns / msgs,
+      (double)enc_allocs / msgs, (double)dec_allocs / msgs);
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t const msgs = argc > 1 ? strtoul(argv[1], NULL, 10) : 256;
+  assert(msgs > 0);
+
+  printf("sm,encoding,ues,bearers,bytes,enc_ns,dec_ns,enc_allocs,dec_allocs\n");
+
+  size_t const len_ues = sizeof(num_ues) / sizeof(num_ues[0]);
+  size_t const len_bearers = sizeof(num_bearers) / sizeof(num_bearers[0]);
+  for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i){
+    bench_case_t const* bc = &cases[i];
+    for(size_t u = 0; u < len_ues; ++u){
+      for(size_t b = 0; b < len_bearers; ++b){
+        bench_point(bc, num_ues[u], num_bearers[b], msgs);
+        if(bc->per_bearer == false)
+          break;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
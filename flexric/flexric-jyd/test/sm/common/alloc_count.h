@@ -0,0 +1,38 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#ifndef ALLOC_COUNT_BENCH_H
+#define ALLOC_COUNT_BENCH_H 
+
+/*
+ * Number of heap allocations (malloc, calloc and realloc calls) since the
+ * program started. Only calls from statically linked code are seen, as they
+ * are counted by wrapping the symbols at link time:
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+ * Not thread safe. Meant for single threaded benchmarks.
+ */
+
+#include <stdint.h>
+
+uint64_t alloc_count(void);
+
+#endif
+
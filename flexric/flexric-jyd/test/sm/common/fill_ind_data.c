@@ -479,6 +479,24 @@ void fill_ue_slice_conf(ue_slice_conf_t* conf)
 
 }
 
+static
+void fill_slice_stats(slice_ind_msg_t* msg)
+{
+  assert(msg != NULL);
+  msg->len_slice_stats = abs(rand()%8);
+  if(msg->len_slice_stats > 0){
+    msg->slice_stats = calloc(msg->len_slice_stats, sizeof(fr_slice_stats_t));
+    assert(msg->slice_stats != NULL && "memory exhausted");
+  }
+
+  for(uint32_t i = 0; i < msg->len_slice_stats; ++i){
+    msg->slice_stats[i].id = i;
+    msg->slice_stats[i].dl_deadline_miss = abs(rand()%1024);
+    msg->slice_stats[i].ul_deadline_miss = abs(rand()%1024);
+    msg->slice_stats[i].ul_alloc_prbs = abs(rand()%100000);
+  }
+}
+
 static
 void fill_slice_del(del_slice_conf_t* conf)
 {
@@ -512,6 +530,7 @@ void fill_slice_ind_data(slice_ind_data_t* ind_msg)
 
   fill_slice_conf(&ind_msg->msg.slice_conf);
   fill_ue_slice_conf(&ind_msg->msg.ue_slice_conf);
+  fill_slice_stats(&ind_msg->msg);
   ind_msg->msg.tstamp = time_now_us();
 }
 
@@ -20,6 +20,8 @@
 
 // 'cp' is buffer in  reception to compare the received indication message against the sent one
 static kpm_ind_data_t cp; 
+// Number of reads that found the state stored by the previous one
+static int cnt_ran_state;
 #define Logme printf
 
 
@@ -30,6 +32,14 @@ static void read_RAN(sm_ag_if_rd_t* read)
   assert(read != NULL);
   assert(read->type == KPM_STATS_V0);
 
+  // The RAN state of the subscription survives between reads
+  if(read->kpm_stats.ran_state == NULL){
+    read->kpm_stats.ran_state = malloc(sizeof(int));
+    assert(read->kpm_stats.ran_state != NULL);
+  } else {
+    ++cnt_ran_state;
+  }
+
   fill_kpm_ind_data(&read->kpm_stats); 
   cp.hdr = cp_kpm_ind_hdr(&read->kpm_stats.hdr);
   cp.msg = cp_kpm_ind_msg(&read->kpm_stats.msg);
@@ -73,7 +83,7 @@ void check_eq_ran_function(sm_agent_t * ag, sm_ric_t const* ric)
  * IE exchanged: RIC Event Trigger Definition + RIC Action Definition 
  */
 static
-void check_subscription(sm_agent_t* ag, sm_ric_t* ric)
+void* check_subscription(sm_agent_t* ag, sm_ric_t* ric)
 {
   assert(ag != NULL);
   assert(ric != NULL);
@@ -81,23 +91,26 @@ void check_subscription(sm_agent_t* ag, sm_ric_t* ric)
   sm_subs_data_t data = ric->proc.on_subscription(ric, "2_ms");
   Logme ("[IE RIC Event Trigger Definition] correctly encoded\n");
   Logme ("[IE RIC Action Definition] correctly encoded\n");
-  assert ((ag->proc.on_subscription(ag, &data)).ms == 2 && "error in decoding trigger");
+  subscribe_timer_t t = ag->proc.on_subscription(ag, &data);
+  assert (t.ms == 2 && "error in decoding trigger");
+  assert (t.data != NULL && "no state for the previous sample");
   Logme ("[IE RIC Event Trigger Definition] correctly decoded\n");
   
   free_sm_subs_data(&data);
+  return t.data;
 }
 
 /* Direction: E2 -> RIC
  * IE exchanged: RIC Indication Header, RIC Indication Message
  */
 static
-void check_indication(sm_agent_t* ag, sm_ric_t* ric)
+void check_indication(sm_agent_t* ag, sm_ric_t* ric, void* ev_data)
 {
   assert(ag != NULL);
   assert(ric != NULL);
 
   // sending IE indication. Behind the scenes it will call the read_RAN()
-  sm_ind_data_t sm_data = ag->proc.on_indication(ag);
+  sm_ind_data_t sm_data = ev_data == NULL ? ag->proc.on_indication(ag) : ag->proc.on_indication_ev(ag, ev_data);
   Logme ("[IE RIC Indication Header]: correctly encoded\n");
 
   // receiving IE indication  (decoding)
@@ -128,9 +141,15 @@ int main()
   Logme("-> STEP 1. Controlling RAN function ................\n");
   check_eq_ran_function(sm_ag, sm_ric);
   Logme("-> STEP 2. Controlling Subscription procedure.......\n");
-  check_subscription(sm_ag, sm_ric);
+  void* ev_data = check_subscription(sm_ag, sm_ric);
   Logme("-> STEP 3. Controlling Indication procedure.........\n");
-  check_indication(sm_ag, sm_ric);
+  check_indication(sm_ag, sm_ric, ev_data);
+  check_indication(sm_ag, sm_ric, ev_data);
+  assert(cnt_ran_state == 1);
+  // Without subscription, no state is kept
+  check_indication(sm_ag, sm_ric, NULL);
+  assert(cnt_ran_state == 1);
+  sm_ag->proc.free_ev_data(sm_ag, ev_data);
 
   Logme("-> STEP 4. Freeing memory...........................\n");
   sm_ag->free_sm(sm_ag);
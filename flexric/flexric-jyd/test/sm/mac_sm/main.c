@@ -23,16 +23,25 @@
 #include "../common/fill_ind_data.h"
 #include "../../../src/sm/mac_sm/mac_sm_agent.h"
 #include "../../../src/sm/mac_sm/mac_sm_ric.h"
+#include "../../../src/util/delta_codec.h"
 
 #include <assert.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 static
 mac_ind_data_t cp;
 
+// Deterministic RAN state for the event triggered subscription check
+static
+mac_ue_stats_impl_t* ev_ues = NULL;
+
+static
+uint32_t len_ev_ues = 0;
+
 /////
 // AGENT
 ////
@@ -44,6 +53,20 @@ void read_RAN(sm_ag_if_rd_t* read)
   assert(read != NULL);
   assert(read->type == MAC_STATS_V0);
 
+  if(ev_ues != NULL){
+    mac_ind_msg_t* msg = &read->mac_stats.msg;
+    if(msg->len_ue_stats < len_ev_ues){
+      msg->ue_stats = calloc(len_ev_ues, sizeof(mac_ue_stats_impl_t));
+      assert(msg->ue_stats != NULL && "Memory exhausted");
+    }
+    memcpy(msg->ue_stats, ev_ues, len_ev_ues*sizeof(mac_ue_stats_impl_t));
+    msg->len_ue_stats = len_ev_ues;
+    msg->tstamp = 0;
+    read->mac_stats.hdr.dummy = 0;
+    read->mac_stats.proc_id = NULL;
+    return;
+  }
+
   fill_mac_ind_data(&read->mac_stats);
   cp.hdr = cp_mac_ind_hdr(&read->mac_stats.hdr);
   cp.msg = cp_mac_ind_msg(&read->mac_stats.msg);
@@ -103,10 +126,154 @@ void check_indication(sm_agent_t* ag, sm_ric_t* ric)
 
   free_mac_ind_hdr(&data->hdr);
   free_mac_ind_msg(&data->msg);
+  free_mac_ind_hdr(&cp.hdr);
+  free_mac_ind_msg(&cp.msg);
 
   free_sm_ind_data(&sm_data); 
 }
 
+static
+uint32_t ev_indication(sm_agent_t* ag, sm_ric_t* ric, void* ev_data, uint32_t* rnti)
+{
+  sm_ind_data_t sm_data = ag->proc.on_indication_ev(ag, ev_data);
+  assert(sm_data.sm_owned == true);
+  if(sm_data.len_msg == 0)
+    return 0;
+
+  sm_ag_if_rd_t msg = ric->proc.on_indication(ric, &sm_data);
+  assert(msg.type == MAC_STATS_V0);
+  mac_ind_msg_t* ind = &msg.mac_stats.msg;
+  uint32_t const len = ind->len_ue_stats;
+  for(uint32_t i = 0; i < len; ++i)
+    rnti[i] = ind->ue_stats[i].rnti;
+
+  free_mac_ind_hdr(&msg.mac_stats.hdr);
+  free_mac_ind_msg(ind);
+  return len;
+}
+
+// Only the UEs that are new or fulfill a condition are encoded
+static
+void check_event_trigger(sm_agent_t* ag, sm_ric_t* ric)
+{
+  assert(ag != NULL);
+  assert(ric != NULL);
+
+  sm_subs_data_t data = ric->proc.on_subscription(ric, "60000_ms,wb_cqi<7,dl_bler~0.05");
+  subscribe_timer_t t = ag->proc.on_subscription(ag, &data);
+  free_sm_subs_data(&data);
+  assert(t.ms == 60000);
+  assert(t.data != NULL);
+
+  mac_ue_stats_impl_t ues[2] = { {.rnti = 1, .wb_cqi = 10, .dl_bler = 0.1},
+                                 {.rnti = 2, .wb_cqi = 10, .dl_bler = 0.1} };
+  ev_ues = ues;
+  len_ev_ues = 2;
+
+  uint32_t rnti[2] = {0};
+  // New UEs
+  assert(ev_indication(ag, ric, t.data, rnti) == 2);
+  // Unchanged
+  assert(ev_indication(ag, ric, t.data, rnti) == 0);
+  // Crosses below the threshold
+  ues[0].wb_cqi = 5;
+  assert(ev_indication(ag, ric, t.data, rnti) == 1 && rnti[0] == 1);
+  // Stays below and the delta is not exceeded yet
+  ues[0].wb_cqi = 4;
+  ues[1].dl_bler = 0.13;
+  assert(ev_indication(ag, ric, t.data, rnti) == 0);
+  // Delta measured against the last reported value
+  ues[1].dl_bler = 0.16;
+  assert(ev_indication(ag, ric, t.data, rnti) == 1 && rnti[0] == 2);
+  // UE 1 leaves and comes back, so it is new again
+  len_ev_ues = 1;
+  ues[0] = ues[1];
+  assert(ev_indication(ag, ric, t.data, rnti) == 0);
+  ues[1] = ues[0];
+  ues[0].rnti = 1;
+  len_ev_ues = 2;
+  assert(ev_indication(ag, ric, t.data, rnti) == 1 && rnti[0] == 1);
+
+  ev_ues = NULL;
+  len_ev_ues = 0;
+  ag->proc.free_ev_data(ag, t.data);
+}
+
+// Delta coded indications rebuild the same message at the RIC
+static
+void check_delta_indication(sm_agent_t* ag, sm_ric_t* ric)
+{
+  assert(ag != NULL);
+  assert(ric != NULL);
+
+  sm_subs_data_t subs = ric->proc.on_subscription(ric, "2_ms,delta=4");
+  subscribe_timer_t t = ag->proc.on_subscription(ag, &subs);
+  free_sm_subs_data(&subs);
+  assert(t.ms == 2 && t.data != NULL);
+
+  for(int i = 0; i < 16; ++i){
+    sm_ind_data_t sm_data = ag->proc.on_indication_ev(ag, t.data);
+    assert(is_delta_frame(sm_data.len_msg, sm_data.ind_msg) == true);
+    sm_ag_if_rd_t msg = ric->proc.on_indication(ric, &sm_data);
+    assert(msg.type == MAC_STATS_V0);
+    mac_ind_data_t* data = &msg.mac_stats;
+
+    assert(eq_mac_ind_msg(&data->msg, &cp.msg) == true);
+
+    free_mac_ind_hdr(&data->hdr);
+    free_mac_ind_msg(&data->msg);
+    free_mac_ind_hdr(&cp.hdr);
+    free_mac_ind_msg(&cp.msg);
+  }
+
+  ag->proc.free_ev_data(ag, t.data);
+}
+
+// The keyframe of the subscription is lost. The RIC drops the delta coded
+// indications that follow, asks for a keyframe and decodes again once served
+static
+void check_delta_keyframe_req(sm_agent_t* ag, sm_ric_t* ric)
+{
+  assert(ag != NULL);
+  assert(ric != NULL);
+
+  sm_subs_data_t subs = ric->proc.on_subscription(ric, "2_ms,delta=4");
+  subscribe_timer_t t = ag->proc.on_subscription(ag, &subs);
+  free_sm_subs_data(&subs);
+  assert(t.ms == 2 && t.data != NULL);
+
+  // Lost keyframe
+  ag->proc.on_indication_ev(ag, t.data);
+  free_mac_ind_hdr(&cp.hdr);
+  free_mac_ind_msg(&cp.msg);
+
+  sm_ind_data_t sm_data = ag->proc.on_indication_ev(ag, t.data);
+  sm_ag_if_rd_t msg = ric->proc.on_indication(ric, &sm_data);
+  assert(msg.type == MAC_STATS_V0);
+  assert(sm_data.dropped == true && sm_data.keyframe_req == true);
+  assert(msg.mac_stats.msg.len_ue_stats == 0);
+  free_mac_ind_hdr(&cp.hdr);
+  free_mac_ind_msg(&cp.msg);
+
+  sm_ag_if_wr_t wr = {.type = MAC_CTRL_REQ_V0};
+  wr.mac_ctrl.msg.action = MAC_CTRL_ACTION_KEYFRAME;
+  sm_ctrl_req_data_t ctrl = ric->proc.on_control_req(ric, &wr);
+  sm_ctrl_out_data_t out = ag->proc.on_control(ag, &ctrl);
+  free_sm_ctrl_req_data(&ctrl);
+  free_sm_ctrl_out_data(&out);
+
+  sm_data = ag->proc.on_indication_ev(ag, t.data);
+  msg = ric->proc.on_indication(ric, &sm_data);
+  assert(sm_data.dropped == false && sm_data.keyframe_req == false);
+  assert(eq_mac_ind_msg(&msg.mac_stats.msg, &cp.msg) == true);
+  free_mac_ind_hdr(&msg.mac_stats.hdr);
+  free_mac_ind_msg(&msg.mac_stats.msg);
+  free_mac_ind_hdr(&cp.hdr);
+  free_mac_ind_msg(&cp.msg);
+
+  ag->proc.free_ev_data(ag, t.data);
+}
+
 int main()
 {
   sm_io_ag_t io_ag = {.read = read_RAN, .write = write_RAN};  
@@ -115,7 +282,12 @@ int main()
 
   check_eq_ran_function(sm_ag, sm_ric);
   check_subscription(sm_ag, sm_ric);
-  check_indication(sm_ag, sm_ric);
+  // The agent reuses its buffers across indications
+  for(int i = 0; i < 16; ++i)
+    check_indication(sm_ag, sm_ric);
+  check_delta_indication(sm_ag, sm_ric);
+  check_delta_keyframe_req(sm_ag, sm_ric);
+  check_event_trigger(sm_ag, sm_ric);
 
   sm_ag->free_sm(sm_ag);
   sm_ric->free_sm(sm_ric);
@@ -23,6 +23,7 @@
 #include "../common/fill_ind_data.h"
 #include "../../../src/sm/rlc_sm/rlc_sm_agent.h"
 #include "../../../src/sm/rlc_sm/rlc_sm_ric.h"
+#include "../../../src/util/delta_codec.h"
 
 #include <assert.h>
 #include <stdbool.h>
@@ -121,10 +122,42 @@ void check_indication(sm_agent_t* ag, sm_ric_t* ric)
 
   free_rlc_ind_hdr(&data->hdr);
   free_rlc_ind_msg(&data->msg);
+  free_rlc_ind_hdr(&cp.hdr);
+  free_rlc_ind_msg(&cp.msg);
 
   free_sm_ind_data(&sm_data); 
 }
 
+// Delta coded indications rebuild the same message at the RIC
+static
+void check_delta_indication(sm_agent_t* ag, sm_ric_t* ric)
+{
+  assert(ag != NULL);
+  assert(ric != NULL);
+
+  sm_subs_data_t subs = ric->proc.on_subscription(ric, "2_ms,delta=4");
+  subscribe_timer_t t = ag->proc.on_subscription(ag, &subs);
+  free_sm_subs_data(&subs);
+  assert(t.ms == 2 && t.data != NULL);
+
+  for(int i = 0; i < 16; ++i){
+    sm_ind_data_t sm_data = ag->proc.on_indication_ev(ag, t.data);
+    assert(is_delta_frame(sm_data.len_msg, sm_data.ind_msg) == true);
+    sm_ag_if_rd_t msg = ric->proc.on_indication(ric, &sm_data);
+    assert(msg.type == RLC_STATS_V0);
+    rlc_ind_data_t* data = &msg.rlc_stats;
+
+    assert(eq_rlc_ind_msg(&data->msg, &cp.msg) == true);
+
+    free_rlc_ind_hdr(&data->hdr);
+    free_rlc_ind_msg(&data->msg);
+    free_rlc_ind_hdr(&cp.hdr);
+    free_rlc_ind_msg(&cp.msg);
+  }
+
+  ag->proc.free_ev_data(ag, t.data);
+}
+
 int main()
 {
   sm_io_ag_t io_ag = {.read = read_RAN, .write = write_RAN};  
@@ -134,7 +167,10 @@ int main()
 
   check_eq_ran_function(sm_ag, sm_ric);
   check_subscription(sm_ag, sm_ric);
-  check_indication(sm_ag, sm_ric);
+  // The agent reuses its buffers across indications
+  for(int i = 0; i < 16; ++i)
+    check_indication(sm_ag, sm_ric);
+  check_delta_indication(sm_ag, sm_ric);
 
   sm_ag->free_sm(sm_ag);
   sm_ric->free_sm(sm_ric);
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+#include "../../src/xApp/db/columnar/columnar_wrapper.h"
+#include "../../src/xApp/db/columnar/columnar_reader.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_UES 4
+#define NUM_IND 1000
+#define PART_US 1000000
+
+typedef struct{
+  size_t segs;
+  size_t rows;
+  uint64_t sum_dl_aggr_tbs;
+  double sum_pusch_snr;
+} mac_scan_t;
+
+static
+void scan_mac(col_seg_t const* seg, void* ctx)
+{
+  mac_scan_t* s = (mac_scan_t*)ctx;
+
+  int const tbs = find_col_seg(seg, "dl_aggr_tbs");
+  int const snr = find_col_seg(seg, "pusch_snr");
+  int const tstamp = find_col_seg(seg, "tstamp");
+  assert(tbs > -1 && snr > -1 && tstamp > -1);
+  assert(desc_col_seg(seg, tbs)->type == COL_TYPE_U64);
+  assert(find_col_seg(seg, "not_a_column") == -1);
+
+  size_t const rows = rows_col_seg(seg);
+  uint64_t const* col = data_col_seg(seg, tbs);
+  int64_t const* ts = data_col_seg(seg, tstamp);
+  for(size_t i = 0; i < rows; ++i){
+    s->sum_dl_aggr_tbs += col[i];
+    s->sum_pusch_snr += f64_col_seg(seg, snr, i);
+    // One partition per segment
+    assert(ts[i] / PART_US == ts[0] / PART_US);
+  }
+
+  s->segs += 1;
+  s->rows += rows;
+}
+
+static
+void count_rlc(col_seg_t const* seg, void* ctx)
+{
+  *(size_t*)ctx += rows_col_seg(seg);
+
+  int const cu_du = find_col_seg(seg, "cu_du_id");
+  assert(cu_du > -1);
+  uint64_t const* col = data_col_seg(seg, cu_du);
+  assert(col[0] == UINT64_MAX);
+}
+
+int main()
+{
+  char dir[] = "/tmp/test_columnar_db_XXXXXX";
+  assert(mkdtemp(dir) != NULL);
+
+  db_columnar_t db;
+  init_db_columnar(&db, dir);
+  // Small segments and partitions to exercise the rollover
+  db.seg_rows = 512;
+  db.part_us = PART_US;
+
+  uint64_t cu_du_id = 42;
+  global_e2_node_id_t id = {.type = ngran_gNB_DU, .plmn = {.mcc = 208, .mnc = 95, .mnc_digit_len = 2}, .nb_id = 1, .cu_du_id = &cu_du_id};
+
+  mac_ue_stats_impl_t ue[NUM_UES] = {0};
+  sm_ag_if_rd_t rd = {.type = MAC_STATS_V0};
+  rd.mac_stats.msg.ue_stats = ue;
+  rd.mac_stats.msg.len_ue_stats = NUM_UES;
+
+  uint64_t sum_tbs = 0;
+  double sum_snr = 0;
+  int64_t const t0 = 10 * PART_US;
+  for(size_t i = 0; i < NUM_IND; ++i){
+    rd.mac_stats.msg.tstamp = t0 + i * 5000; // 5 ms, i.e., 5 partitions
+    for(size_t j = 0; j < NUM_UES; ++j){
+      ue[j].rnti = j;
+      ue[j].dl_aggr_tbs = i*NUM_UES + j;
+      ue[j].pusch_snr = 0.5f * j;
+      sum_tbs += ue[j].dl_aggr_tbs;
+      sum_snr += ue[j].pusch_snr;
+    }
+    write_db_columnar(&db, &id, &rd);
+  }
+
+  rlc_radio_bearer_stats_t rb = {.rnti = 7};
+  sm_ag_if_rd_t rd_rlc = {.type = RLC_STATS_V0};
+  rd_rlc.rlc_stats.msg.rb = &rb;
+  rd_rlc.rlc_stats.msg.len = 1;
+  rd_rlc.rlc_stats.msg.tstamp = t0;
+  id.cu_du_id = NULL;
+  write_db_columnar(&db, &id, &rd_rlc);
+
+  // Concurrent reader while the writer is still open
+  flush_db_columnar(&db);
+  mac_scan_t s = {0};
+  scan_col_seg(dir, COL_SM_MAC_UE, INT64_MIN, INT64_MAX, scan_mac, &s);
+  assert(s.rows == NUM_IND * NUM_UES);
+
+  close_db_columnar(&db);
+
+  memset(&s, 0, sizeof(s));
+  size_t const segs = scan_col_seg(dir, COL_SM_MAC_UE, INT64_MIN, INT64_MAX, scan_mac, &s);
+  assert(segs == s.segs);
+  // 5 partitions of 800 rows in segments of 512 rows
+  assert(s.segs == 10);
+  assert(s.rows == NUM_IND * NUM_UES);
+  assert(s.sum_dl_aggr_tbs == sum_tbs);
+  assert(s.sum_pusch_snr == sum_snr);
+
+  // Time range restricted to the first partition
+  memset(&s, 0, sizeof(s));
+  scan_col_seg(dir, COL_SM_MAC_UE, t0, t0 + PART_US - 1, scan_mac, &s);
+  assert(s.segs == 2 && s.rows == 200 * NUM_UES);
+
+  size_t rlc_rows = 0;
+  assert(scan_col_seg(dir, COL_SM_RLC_BEARER, INT64_MIN, INT64_MAX, count_rlc, &rlc_rows) == 1);
+  assert(rlc_rows == 1);
+
+  // A restart, and a timestamp going back to an earlier partition, never overwrite the existing segments
+  init_db_columnar(&db, dir);
+  db.seg_rows = 512;
+  db.part_us = PART_US;
+  rd.mac_stats.msg.tstamp = t0 + 2 * PART_US;
+  write_db_columnar(&db, &id, &rd);
+  rd.mac_stats.msg.tstamp = t0;
+  write_db_columnar(&db, &id, &rd);
+  close_db_columnar(&db);
+
+  memset(&s, 0, sizeof(s));
+  scan_col_seg(dir, COL_SM_MAC_UE, INT64_MIN, INT64_MAX, scan_mac, &s);
+  assert(s.segs == 12 && s.rows == (NUM_IND + 2) * NUM_UES);
+
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+  int const rc = system(cmd);
+  assert(rc == 0);
+
+  printf("Columnar xApp DB test passed\n");
+  return 0;
+}
+
@@ -102,6 +102,7 @@ public:
   struct buffer_metadata_t {
     uint32_t            pdcp_sn = 0;
     buffer_latency_calc tp;
+    buffer_latency_calc rlc_tp; // Entry in the RLC Tx queue. tp keeps the stack ingress
   } md;
 
   byte_buffer_t() : msg(&buffer[SRSRAN_BUFFER_HEADER_OFFSET])
@@ -152,6 +153,10 @@ public:
 
   void set_timestamp(std::chrono::high_resolution_clock::time_point tp_) { md.tp.set_timestamp(tp_); }
 
+  std::chrono::microseconds get_rlc_latency_us() const { return md.rlc_tp.get_latency_us(); }
+
+  void set_rlc_timestamp() { md.rlc_tp.set_timestamp(); }
+
   void append_bytes(uint8_t* buf, uint32_t size)
   {
     memcpy(&msg[N_bytes], buf, size);
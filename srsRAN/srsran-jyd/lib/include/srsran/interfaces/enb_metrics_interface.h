@@ -63,6 +63,19 @@ struct enb_metrics_t {
   bool                       running;
 };
 
+/// Receives the metrics that the eNB layers push from their own threads, so that the receiver never queries them.
+class enb_metrics_sink_interface
+{
+public:
+  virtual ~enb_metrics_sink_interface() = default;
+
+  /// Called from the stack thread every configured number of TTIs. MAC, RLC and PDCP counters are cumulative.
+  virtual void push_stack_metrics(const stack_metrics_t& m) = 0;
+
+  /// Called by the PHY worker worker_idx after every subframe, with the running averages of that worker.
+  virtual void push_phy_metrics(uint32_t worker_idx, const std::vector<phy_metrics_t>& m) = 0;
+};
+
 // ENB interface
 class enb_metrics_interface : public srsran::metrics_interface<enb_metrics_t>
 {
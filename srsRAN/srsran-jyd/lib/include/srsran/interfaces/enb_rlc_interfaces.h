@@ -71,6 +71,14 @@ public:
   virtual void reestablish(uint16_t rnti)                                                = 0;
 };
 
+// RLC interface for the traffic control between GTP-U and PDCP
+class rlc_interface_tc
+{
+public:
+  /* Bytes pending for transmission in the DL RLC queue of a bearer, including retransmissions. */
+  virtual uint32_t get_buffer_state(uint16_t rnti, uint32_t lcid) = 0;
+};
+
 } // namespace srsenb
 
 #endif // SRSRAN_ENB_RLC_INTERFACES_H
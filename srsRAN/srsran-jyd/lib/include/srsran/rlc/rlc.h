@@ -56,7 +56,12 @@ public:
             bsr_callback_t             bsr_callback_);
   void stop();
 
+  // Accumulate the Tx SDU delay of the DRBs added from now on into an externally owned counter
+  void set_tx_delay_counter(rlc_tx_delay_counter_t* counter);
+
   void get_metrics(rlc_metrics_t& m, const uint32_t nof_tti);
+  // Counters since each bearer was added, plus its current buffer state. Does not reset the get_metrics() window
+  void get_cumulative_metrics(rlc_metrics_t& m);
 
   // PDCP interface
   void write_sdu(uint32_t lcid, unique_byte_buffer_t sdu);
@@ -113,10 +118,13 @@ private:
 
   uint32_t default_lcid = 0;
 
-  bsr_callback_t bsr_callback = nullptr;
+  bsr_callback_t          bsr_callback     = nullptr;
+  rlc_tx_delay_counter_t* tx_delay_counter = nullptr;
 
   // Timer needed for metrics calculation
   std::chrono::high_resolution_clock::time_point metrics_tp;
+  // Counters moved out of the bearers by reset_metrics()
+  rlc_metrics_t reset_counters = {};
 
   bool valid_lcid(uint32_t lcid);
   bool valid_lcid_mrb(uint32_t lcid);
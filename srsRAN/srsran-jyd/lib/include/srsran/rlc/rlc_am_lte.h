@@ -363,6 +363,7 @@ public:
   void                 reset_metrics();
 
   void set_bsr_callback(bsr_callback_t callback);
+  void set_tx_delay_counter(rlc_tx_delay_counter_t* counter) override;
 
 private:
   // Transmitter sub-class
@@ -394,9 +395,11 @@ private:
     void handle_control_pdu(uint8_t* payload, uint32_t nof_bytes);
 
     void set_bsr_callback(bsr_callback_t callback);
+    void set_tx_delay_counter(rlc_tx_delay_counter_t* counter);
 
   private:
     void stop_nolock();
+    void account_sdu_delay(const unique_byte_buffer_t& sdu);
 
     int  build_status_pdu(uint8_t* payload, uint32_t nof_bytes);
     int  build_retx_pdu(uint8_t* payload, uint32_t nof_bytes);
@@ -466,6 +469,9 @@ private:
     // Callback function for buffer status report
     bsr_callback_t bsr_callback;
 
+    // Optional DRB Tx SDU delay accounting, owned by the stack
+    rlc_tx_delay_counter_t* tx_delay_counter = nullptr;
+
     // Tx windows
     rlc_ringbuffer_t<rlc_amd_tx_pdu> tx_window;
     pdu_retx_queue                   retx_queue;
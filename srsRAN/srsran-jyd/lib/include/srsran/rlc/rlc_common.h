@@ -288,6 +288,9 @@ public:
 
   virtual void set_bsr_callback(bsr_callback_t callback) = 0;
 
+  // Optional Tx SDU delay accounting, only implemented by the UM/AM entities
+  virtual void set_tx_delay_counter(rlc_tx_delay_counter_t* counter) {}
+
   void* operator new(size_t sz) { return allocate_rlc_bearer(sz); }
   void  operator delete(void* p) { return deallocate_rlc_bearer(p); }
 
@@ -23,6 +23,7 @@
 #define SRSRAN_RLC_METRICS_H
 
 #include "srsran/common/common.h"
+#include <atomic>
 #include <iostream>
 
 namespace srsran {
@@ -48,10 +49,25 @@ typedef struct {
 } rlc_bearer_metrics_t;
 
 typedef struct {
+  uint16_t             rnti;        //< Owning UE, only filled by the eNB
+  uint32_t             bearer_mask; //< Bit lcid set for each established bearer, the other bearer[] entries are stale
   rlc_bearer_metrics_t bearer[SRSRAN_N_RADIO_BEARERS];
   rlc_bearer_metrics_t mrb_bearer[SRSRAN_N_MCH_LCIDS];
 } rlc_metrics_t;
 
+/// Cumulative Tx SDU delay (from write_sdu() to transmission of the last segment), shared by the DRBs of a node.
+/// Counters are never reset, readers compute deltas between two samples.
+struct rlc_tx_delay_counter_t {
+  std::atomic<uint64_t> sum_us{0};
+  std::atomic<uint64_t> nof_sdus{0};
+
+  void add(uint64_t delay_us)
+  {
+    sum_us.fetch_add(delay_us, std::memory_order_relaxed);
+    nof_sdus.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
 } // namespace srsran
 
 #endif // SRSRAN_RLC_METRICS_H
@@ -76,6 +76,7 @@ public:
   void                 reset_metrics();
 
   void set_bsr_callback(bsr_callback_t callback);
+  void set_tx_delay_counter(rlc_tx_delay_counter_t* counter) override;
 
   uint32_t get_lcid() const { return lcid; }
 
@@ -100,13 +101,15 @@ protected:
     virtual uint32_t get_buffer_state() = 0;
 
     void set_bsr_callback(bsr_callback_t callback);
+    void set_tx_delay_counter(rlc_tx_delay_counter_t* counter);
 
   protected:
-    byte_buffer_pool*     pool = nullptr;
-    srslog::basic_logger& logger;
-    std::string           rb_name;
-    rlc_um_base*          parent = nullptr;
-    bsr_callback_t        bsr_callback;
+    byte_buffer_pool*       pool = nullptr;
+    srslog::basic_logger&   logger;
+    std::string             rb_name;
+    rlc_um_base*            parent = nullptr;
+    bsr_callback_t          bsr_callback;
+    rlc_tx_delay_counter_t* tx_delay_counter = nullptr;
 
     rlc_config_t cfg = {};
 
@@ -77,6 +77,8 @@ public:
   // Metrics
   void get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti);
   void reset_metrics();
+  // Counters since each bearer was added, plus its current ACK state. Does not reset the get_metrics() window
+  void get_cumulative_metrics(pdcp_metrics_t& m);
 
 private:
   srsue::rlc_interface_pdcp* rlc    = nullptr;
@@ -97,6 +99,8 @@ private:
 
   // Timer needed for metrics calculation
   std::chrono::high_resolution_clock::time_point metrics_tp;
+  // Counters moved out of the bearers by reset_metrics()
+  pdcp_metrics_t reset_counters = {};
 };
 
 } // namespace srsran
@@ -42,6 +42,8 @@ typedef struct {
 } pdcp_bearer_metrics_t;
 
 typedef struct {
+  uint16_t              rnti;        //< Owning UE, only filled by the eNB
+  uint32_t              bearer_mask; //< Bit lcid set for each established bearer, the other bearer[] entries are stale
   pdcp_bearer_metrics_t bearer[SRSRAN_N_RADIO_BEARERS];
 } pdcp_metrics_t;
 
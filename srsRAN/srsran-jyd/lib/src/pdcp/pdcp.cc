@@ -70,6 +70,7 @@ void pdcp::reset()
   }
   // destroy all bearers
   pdcp_array.clear();
+  reset_counters = {};
 }
 
 void pdcp::set_enabled(uint32_t lcid, bool enabled)
@@ -177,6 +178,8 @@ void pdcp::del_bearer(uint32_t lcid)
   if (valid_lcid(lcid)) {
     logger.info("Deleted PDCP bearer %s", pdcp_array[lcid]->get_rb_name());
     pdcp_array.erase(lcid);
+    // A bearer added later with the same LCID starts its counters from zero
+    reset_counters.bearer[lcid] = {};
   } else {
     logger.warning("Can't delete bearer with LCID=%s. Cause: bearer doesn't exist.", lcid);
   }
@@ -360,6 +363,7 @@ void pdcp::get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti)
 {
   std::chrono::duration<double> secs = std::chrono::high_resolution_clock::now() - metrics_tp;
 
+  m.bearer_mask = 0;
   for (pdcp_map_t::iterator it = pdcp_array.begin(); it != pdcp_array.end(); ++it) {
     pdcp_bearer_metrics_t metrics = it->second->get_metrics();
 
@@ -378,18 +382,39 @@ void pdcp::get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti)
                 tx_rate_mbps,
                 tx_rate_mbps_real_time);
     m.bearer[it->first] = metrics;
+    m.bearer_mask |= 1u << it->first;
   }
 
   reset_metrics();
 }
 
+static void add_counters(pdcp_bearer_metrics_t& dst, const pdcp_bearer_metrics_t& src)
+{
+  dst.num_tx_pdus += src.num_tx_pdus;
+  dst.num_rx_pdus += src.num_rx_pdus;
+  dst.num_tx_pdu_bytes += src.num_tx_pdu_bytes;
+  dst.num_rx_pdu_bytes += src.num_rx_pdu_bytes;
+  dst.num_tx_acked_bytes += src.num_tx_acked_bytes;
+}
+
 void pdcp::reset_metrics()
 {
   for (pdcp_map_t::iterator it = pdcp_array.begin(); it != pdcp_array.end(); ++it) {
+    add_counters(reset_counters.bearer[it->first], it->second->get_metrics());
     it->second->reset_metrics();
   }
 
   metrics_tp = std::chrono::high_resolution_clock::now();
 }
 
+void pdcp::get_cumulative_metrics(pdcp_metrics_t& m)
+{
+  m.bearer_mask = 0;
+  for (pdcp_map_t::iterator it = pdcp_array.begin(); it != pdcp_array.end(); ++it) {
+    m.bearer[it->first] = it->second->get_metrics();
+    add_counters(m.bearer[it->first], reset_counters.bearer[it->first]);
+    m.bearer_mask |= 1u << it->first;
+  }
+}
+
 } // namespace srsran
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/rlc/rlc.h"
+#include "srsran/common/common_lte.h"
 #include "srsran/common/rwlock_guard.h"
 #include "srsran/rlc/rlc_am_lte.h"
 #include "srsran/rlc/rlc_tm.h"
@@ -70,9 +71,30 @@ void rlc::init(srsue::pdcp_interface_rlc* pdcp_,
   init(pdcp_, rrc_, timers_, lcid_);
 }
 
+void rlc::set_tx_delay_counter(rlc_tx_delay_counter_t* counter)
+{
+  rwlock_write_guard lock(rwlock);
+  tx_delay_counter = counter;
+}
+
+static void add_counters(rlc_bearer_metrics_t& dst, const rlc_bearer_metrics_t& src)
+{
+  dst.num_tx_sdus += src.num_tx_sdus;
+  dst.num_rx_sdus += src.num_rx_sdus;
+  dst.num_tx_sdu_bytes += src.num_tx_sdu_bytes;
+  dst.num_rx_sdu_bytes += src.num_rx_sdu_bytes;
+  dst.num_lost_sdus += src.num_lost_sdus;
+  dst.num_tx_pdus += src.num_tx_pdus;
+  dst.num_rx_pdus += src.num_rx_pdus;
+  dst.num_tx_pdu_bytes += src.num_tx_pdu_bytes;
+  dst.num_rx_pdu_bytes += src.num_rx_pdu_bytes;
+  dst.num_lost_pdus += src.num_lost_pdus;
+}
+
 void rlc::reset_metrics()
 {
   for (rlc_map_t::iterator it = rlc_array.begin(); it != rlc_array.end(); ++it) {
+    add_counters(reset_counters.bearer[it->first], it->second->get_metrics());
     it->second->reset_metrics();
   }
 
@@ -97,6 +119,7 @@ void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
 {
   std::chrono::duration<double> secs = std::chrono::high_resolution_clock::now() - metrics_tp;
 
+  m.bearer_mask = 0;
   for (rlc_map_t::iterator it = rlc_array.begin(); it != rlc_array.end(); ++it) {
     rlc_bearer_metrics_t metrics = it->second->get_metrics();
 
@@ -116,6 +139,7 @@ void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
                 tx_rate_mbps,
                 tx_rate_mbps_real_time);
     m.bearer[it->first] = metrics;
+    m.bearer_mask |= 1u << it->first;
   }
 
   // Add multicast metrics
@@ -132,6 +156,17 @@ void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
 
 }
 
+void rlc::get_cumulative_metrics(rlc_metrics_t& m)
+{
+  rwlock_read_guard lock(rwlock);
+  m.bearer_mask = 0;
+  for (rlc_map_t::iterator it = rlc_array.begin(); it != rlc_array.end(); ++it) {
+    m.bearer[it->first] = it->second->get_metrics();
+    add_counters(m.bearer[it->first], reset_counters.bearer[it->first]);
+    m.bearer_mask |= 1u << it->first;
+  }
+}
+
 // Reestablish all RLC bearer
 void rlc::reestablish()
 {
@@ -165,6 +200,7 @@ void rlc::reset()
   {
     rwlock_write_guard lock(rwlock);
     rlc_array.clear();
+    reset_counters = {};
     // the multicast bearer (MRB) is not removed here because eMBMS services continue to be streamed in idle mode (3GPP
     // TS 23.246 version 14.1.0 Release 14 section 8)
   }
@@ -449,6 +485,9 @@ int rlc::add_bearer(uint32_t lcid, const rlc_config_t& cnfg)
   }
 
   rlc_entity->set_bsr_callback(bsr_callback);
+  if (tx_delay_counter != nullptr and is_lte_drb(lcid)) {
+    rlc_entity->set_tx_delay_counter(tx_delay_counter);
+  }
 
   if (not rlc_array.insert(rlc_map_pair_t(lcid, std::move(rlc_entity))).second) {
     logger.error("Error inserting RLC entity in to array.");
@@ -493,6 +532,8 @@ void rlc::del_bearer(uint32_t lcid)
     rlc_map_t::iterator it = rlc_array.find(lcid);
     it->second->stop();
     rlc_array.erase(it);
+    // A bearer added later with the same LCID starts its counters from zero
+    reset_counters.bearer[lcid] = {};
     logger.info("Deleted RLC bearer with LCID %d", lcid);
   } else {
     logger.error("Can't delete bearer with LCID %d. Bearer doesn't exist.", lcid);
@@ -179,6 +179,11 @@ void rlc_am_lte::set_bsr_callback(bsr_callback_t callback)
   tx.set_bsr_callback(callback);
 }
 
+void rlc_am_lte::set_tx_delay_counter(rlc_tx_delay_counter_t* counter)
+{
+  tx.set_tx_delay_counter(counter);
+}
+
 void rlc_am_lte::empty_queue()
 {
   // Drop all messages in TX SDU queue
@@ -311,6 +316,21 @@ void rlc_am_lte::rlc_am_lte_tx::set_bsr_callback(bsr_callback_t callback)
   bsr_callback = callback;
 }
 
+void rlc_am_lte::rlc_am_lte_tx::set_tx_delay_counter(rlc_tx_delay_counter_t* counter)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  tx_delay_counter = counter;
+}
+
+void rlc_am_lte::rlc_am_lte_tx::account_sdu_delay(const unique_byte_buffer_t& sdu)
+{
+#ifdef ENABLE_TIMESTAMP
+  if (tx_delay_counter != nullptr) {
+    tx_delay_counter->add(sdu->get_rlc_latency_us().count());
+  }
+#endif
+}
+
 bool rlc_am_lte::rlc_am_lte_tx::configure(const rlc_config_t& cfg_)
 {
   std::lock_guard<std::mutex> lock(mutex);
@@ -548,6 +568,12 @@ int rlc_am_lte::rlc_am_lte_tx::write_sdu(unique_byte_buffer_t sdu)
   // Get SDU info
   uint32_t sdu_pdcp_sn = sdu->md.pdcp_sn;
 
+#ifdef ENABLE_TIMESTAMP
+  if (tx_delay_counter != nullptr) {
+    sdu->set_rlc_timestamp();
+  }
+#endif
+
   // Store SDU
   uint8_t*                                 msg_ptr   = sdu->msg;
   uint32_t                                 nof_bytes = sdu->N_bytes;
@@ -1084,6 +1110,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
 
     if (tx_sdu->N_bytes == 0) {
       logger.debug("%s Complete SDU scheduled for tx.", RB_NAME);
+      account_sdu_delay(tx_sdu);
       tx_sdu.reset();
     }
     if (pdu_space > to_move) {
@@ -1159,6 +1186,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
 
     if (tx_sdu->N_bytes == 0) {
       logger.debug("%s Complete SDU scheduled for tx. PDCP SN=%d", RB_NAME, tx_sdu->md.pdcp_sn);
+      account_sdu_delay(tx_sdu);
       tx_sdu.reset();
     }
     if (pdu_space > to_move) {
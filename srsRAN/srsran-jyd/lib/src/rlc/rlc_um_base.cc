@@ -197,6 +197,11 @@ void rlc_um_base::set_bsr_callback(bsr_callback_t callback)
   tx->set_bsr_callback(std::move(callback));
 }
 
+void rlc_um_base::set_tx_delay_counter(rlc_tx_delay_counter_t* counter)
+{
+  tx->set_tx_delay_counter(counter);
+}
+
 /****************************************************************************
  * Helper functions
  ***************************************************************************/
@@ -274,9 +279,20 @@ void rlc_um_base::rlc_um_base_tx::set_bsr_callback(bsr_callback_t callback)
   bsr_callback = callback;
 }
 
+void rlc_um_base::rlc_um_base_tx::set_tx_delay_counter(rlc_tx_delay_counter_t* counter)
+{
+  tx_delay_counter = counter;
+}
+
 void rlc_um_base::rlc_um_base_tx::write_sdu(unique_byte_buffer_t sdu)
 {
   if (sdu) {
+#ifdef ENABLE_TIMESTAMP
+    if (tx_delay_counter != nullptr) {
+      // measure the delay from RLC SDU reception, the stack ingress is kept for the stack latency
+      sdu->set_rlc_timestamp();
+    }
+#endif
     logger.info(sdu->msg,
                 sdu->N_bytes,
                 "%s Tx SDU (%d B, tx_sdu_queue_len=%d)",
@@ -292,6 +308,11 @@ void rlc_um_base::rlc_um_base_tx::write_sdu(unique_byte_buffer_t sdu)
 int rlc_um_base::rlc_um_base_tx::try_write_sdu(unique_byte_buffer_t sdu)
 {
   if (sdu) {
+#ifdef ENABLE_TIMESTAMP
+    if (tx_delay_counter != nullptr) {
+      sdu->set_rlc_timestamp();
+    }
+#endif
     uint8_t*                                 msg_ptr   = sdu->msg;
     uint32_t                                 nof_bytes = sdu->N_bytes;
     srsran::error_type<unique_byte_buffer_t> ret       = tx_sdu_queue.try_write(std::move(sdu));
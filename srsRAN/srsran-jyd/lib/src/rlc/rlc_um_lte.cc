@@ -162,6 +162,9 @@ uint32_t rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uin
 #ifdef ENABLE_TIMESTAMP
       auto latency_us = tx_sdu->get_latency_us().count();
       mean_pdu_latency_us.push(latency_us);
+      if (tx_delay_counter != nullptr) {
+        tx_delay_counter->add(tx_sdu->get_rlc_latency_us().count());
+      }
       logger.debug("%s Complete SDU scheduled for tx. Stack latency (last/average): %" PRIu64 "/%ld us",
                    rb_name.c_str(),
                    (uint64_t)latency_us,
@@ -201,6 +204,9 @@ uint32_t rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uin
 #ifdef ENABLE_TIMESTAMP
       auto latency_us = tx_sdu->get_latency_us().count();
       mean_pdu_latency_us.push(latency_us);
+      if (tx_delay_counter != nullptr) {
+        tx_delay_counter->add(tx_sdu->get_rlc_latency_us().count());
+      }
       logger.debug("%s Complete SDU scheduled for tx. Stack latency (last/average): %" PRIu64 "/%ld us",
                    rb_name.c_str(),
                    (uint64_t)latency_us,
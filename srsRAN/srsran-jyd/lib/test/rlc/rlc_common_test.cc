@@ -204,6 +204,47 @@ int meas_obj_test()
   return 0;
 }
 
+int cumulative_metrics_test()
+{
+  auto& logger_rlc = srslog::fetch_basic_logger("RLC_3", false);
+  logger_rlc.set_level(srslog::basic_levels::debug);
+
+  rlc_tester            tester;
+  srsran::timer_handler timers(1);
+
+  rlc rlc1(logger_rlc.id().c_str());
+  rlc1.init(&tester, &tester, &timers, 0);
+
+  uint32_t lcid = 3;
+  rlc1.add_bearer(lcid, rlc_config_t::default_rlc_um_config(10));
+
+  for (int i = 0; i < NBUFS; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    *sdu->msg                = i;
+    sdu->N_bytes             = 1;
+    rlc1.write_sdu(lcid, std::move(sdu));
+  }
+
+  // The counters moved out of the bearer by get_metrics() are kept in the cumulative ones
+  rlc_metrics_t m = {};
+  rlc1.get_metrics(m, 1);
+  TESTASSERT(m.bearer[lcid].num_tx_sdus == NBUFS);
+  rlc1.get_cumulative_metrics(m);
+  TESTASSERT(m.bearer[lcid].num_tx_sdus == NBUFS);
+
+  // A bearer re-added with the same LCID starts from zero
+  rlc1.del_bearer(lcid);
+  rlc1.get_cumulative_metrics(m);
+  TESTASSERT((m.bearer_mask & (1u << lcid)) == 0);
+  rlc1.add_bearer(lcid, rlc_config_t::default_rlc_um_config(10));
+  rlc1.get_cumulative_metrics(m);
+  TESTASSERT((m.bearer_mask & (1u << lcid)) != 0);
+  TESTASSERT(m.bearer[lcid].num_tx_sdus == 0);
+  TESTASSERT(m.bearer[lcid].num_tx_sdu_bytes == 0);
+
+  return 0;
+}
+
 int main(int argc, char** argv)
 {
   srslog::init();
@@ -211,4 +252,7 @@ int main(int argc, char** argv)
   if (meas_obj_test()) {
     return -1;
   }
+  if (cumulative_metrics_test()) {
+    return -1;
+  }
 }
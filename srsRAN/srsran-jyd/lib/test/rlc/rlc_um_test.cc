@@ -22,6 +22,7 @@
 #include "rlc_test_common.h"
 #include "srsran/rlc/rlc_um_lte.h"
 #include <iostream>
+#include <thread>
 
 #define TESTASSERT(cond)                                                                                               \
   {                                                                                                                    \
@@ -433,6 +434,38 @@ int pdu_pack_no_space_test()
   return SRSRAN_SUCCESS;
 }
 
+// SDU delay is accounted once per SDU, when its last segment is transmitted
+int tx_delay_counter_test()
+{
+  rlc_um_lte_test_context1 ctxt;
+  rlc_tx_delay_counter_t   counter;
+  ctxt.rlc1.set_tx_delay_counter(&counter);
+
+  // Push 2 SDUs of 4 bytes into RLC1. The delay is counted from the RLC, not from the stack ingress
+  for (int i = 0; i < 2; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    memset(sdu->msg, i, 4);
+    sdu->N_bytes = 4;
+    sdu->set_timestamp(std::chrono::high_resolution_clock::now() - std::chrono::seconds(1));
+    ctxt.rlc1.write_sdu(std::move(sdu));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+  // First SDU is split in two PDUs
+  byte_buffer_t pdu;
+  TESTASSERT(ctxt.rlc1.read_pdu(pdu.msg, 4) > 0);
+  TESTASSERT(counter.nof_sdus == 0);
+  TESTASSERT(ctxt.rlc1.read_pdu(pdu.msg, 5) > 0);
+  TESTASSERT(counter.nof_sdus == 1);
+  TESTASSERT(counter.sum_us >= 2000);
+
+  TESTASSERT(ctxt.rlc1.read_pdu(pdu.msg, 10) > 0);
+  TESTASSERT(counter.nof_sdus == 2);
+  TESTASSERT(counter.sum_us >= 4000 and counter.sum_us < 1000000);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   srslog::init();
@@ -458,4 +491,5 @@ int main(int argc, char** argv)
   }
 
   TESTASSERT(pdu_pack_no_space_test() == 0);
+  TESTASSERT(tx_delay_counter_test() == 0);
 }
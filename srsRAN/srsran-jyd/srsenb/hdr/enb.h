@@ -147,6 +147,8 @@ public:
 
   // eNodeB metrics interface
   bool get_metrics(enb_metrics_t* m) override;
+  // Has the PHY workers and the LTE stack push their metrics to sink every period_tti TTIs
+  void set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti);
 
   // eNodeB command interface
   void cmd_cell_gain(uint32_t cell_id, float gain) override;
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        metrics_e2.h
+ * Description: RNTI-keyed metrics snapshots pushed by the stack and PHY
+ *              threads and read lock-free by the E2 agent service models.
+ *****************************************************************************/
+
+#ifndef SRSENB_METRICS_E2_H
+#define SRSENB_METRICS_E2_H
+
+#include <array>
+#include <atomic>
+#include <stdint.h>
+
+#include "srsenb/hdr/common/common_enb.h"
+#include "srsran/adt/bounded_vector.h"
+#include "srsran/interfaces/enb_metrics_interface.h"
+
+namespace srsenb {
+
+/// Metrics of a single UE, joined across PHY, MAC, RLC and PDCP by RNTI. MAC, RLC and PDCP counters are cumulative.
+struct e2_ue_metrics_t {
+  uint16_t               rnti     = 0;
+  bool                   has_phy  = false;
+  bool                   has_mac  = false;
+  bool                   has_rlc  = false;
+  bool                   has_pdcp = false;
+  phy_metrics_t          phy      = {};
+  mac_ue_metrics_t       mac      = {};
+  srsran::rlc_metrics_t  rlc      = {};
+  srsran::pdcp_metrics_t pdcp     = {};
+};
+
+/// Set of per-UE records, as last pushed by the stack and the PHY workers.
+struct e2_metrics_snapshot_t {
+  /// Monotonically increasing count of stack pushes. Zero until the stack pushes its metrics for the first time.
+  uint64_t version = 0;
+  /// Wall-clock time of the stack push in microseconds.
+  int64_t tstamp_us = 0;
+  /// Per-UE records, sorted by RNTI. Fixed capacity, so that publishing never reallocates under a reader.
+  srsran::bounded_vector<e2_ue_metrics_t, SRSENB_MAX_UES> ues;
+
+  const e2_ue_metrics_t* find(uint16_t rnti) const;
+};
+
+/**
+ * Metrics sink of the E2 service models. The stack thread and every PHY worker push their metrics into a ring of
+ * snapshots of their own, each slot guarded by a sequence counter (seqlock), so every ring has a single writer and
+ * pushing never blocks. Readers copy the latest snapshot of each ring, retrying if the writer overwrote it meanwhile,
+ * and join them by RNTI. An E2 read therefore neither blocks nor reaches into the stack or PHY workers, whatever the
+ * subscription period.
+ */
+class metrics_e2 final : public enb_metrics_sink_interface
+{
+public:
+  /// Pushes of PHY workers with a higher index are ignored.
+  static const uint32_t max_phy_workers = 4;
+
+  void push_stack_metrics(const stack_metrics_t& m) override;
+  void push_phy_metrics(uint32_t worker_idx, const std::vector<phy_metrics_t>& m) override;
+
+  /// Copies the latest pushed metrics into dst. Lock-free, never waits for the writers.
+  void read(e2_metrics_snapshot_t& dst) const;
+
+private:
+  struct ring_hdr_t {
+    uint64_t version   = 0;
+    int64_t  tstamp_us = 0;
+  };
+
+  /// Ring of (header, list of T) snapshots. The slots hold them as words accessed with relaxed atomics, so a reader
+  /// racing with the writer copies a torn snapshot, discarded by the sequence check, instead of racing on the memory.
+  template <typename T>
+  class seqlock_ring
+  {
+  public:
+    using list_t = srsran::bounded_vector<T, SRSENB_MAX_UES>;
+
+    /// Rewrites the oldest slot and makes it the latest one. Single writer.
+    void publish(const ring_hdr_t& hdr, const list_t& items);
+    void read(ring_hdr_t& hdr, list_t& items) const;
+
+  private:
+    static const uint32_t nof_slots  = 4;
+    static const size_t   hdr_words  = (sizeof(ring_hdr_t) + 7) / 8;
+    static const size_t   item_words = (sizeof(T) + 7) / 8;
+
+    struct slot_t {
+      /// Odd while the writer rewrites the slot.
+      std::atomic<uint32_t>                                          seq{0};
+      std::atomic<uint32_t>                                          nof_items{0};
+      std::array<std::atomic<uint64_t>, hdr_words>                   hdr;
+      std::array<std::atomic<uint64_t>, SRSENB_MAX_UES * item_words> items;
+    };
+
+    std::array<slot_t, nof_slots> slots;
+    std::atomic<uint32_t>         latest{0};
+  };
+
+  using phy_list_t = seqlock_ring<phy_metrics_t>::list_t;
+
+  seqlock_ring<e2_ue_metrics_t>                            stack_ring;
+  std::array<seqlock_ring<phy_metrics_t>, max_phy_workers> phy_rings;
+
+  // Owned by the writers, which build their snapshot here before publishing it
+  seqlock_ring<e2_ue_metrics_t>::list_t   stack_scratch;
+  std::array<phy_list_t, max_phy_workers> phy_scratch;
+  uint64_t                                nof_stack_pushes = 0;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_METRICS_E2_H
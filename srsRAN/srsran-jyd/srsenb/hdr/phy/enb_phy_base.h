@@ -32,6 +32,8 @@
 
 namespace srsenb {
 
+class enb_metrics_sink_interface;
+
 class enb_phy_base
 {
 public:
@@ -46,6 +48,9 @@ public:
 
   virtual void get_metrics(std::vector<phy_metrics_t>& m) = 0;
 
+  // Has every worker push its metrics to sink every period_tti TTIs. nullptr stops pushing
+  virtual void set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti) {}
+
   virtual void cmd_cell_gain(uint32_t cell_idx, float gain_db) = 0;
 };
 
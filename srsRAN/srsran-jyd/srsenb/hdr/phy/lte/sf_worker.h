@@ -59,7 +59,8 @@ public:
   uint32_t get_metrics(std::vector<phy_metrics_t>& metrics);
 
 private:
-  void work_imp() final;
+  void     work_imp() final;
+  uint32_t merge_cc_metrics(std::vector<phy_metrics_t>& metrics, std::vector<phy_metrics_t>& cc_metrics);
 
   /* Common objects */
   srslog::basic_logger& logger;
@@ -73,6 +74,11 @@ private:
   srsran::phy_common_interface::worker_context_t context = {};
 
   srsran_softbuffer_tx_t temp_mbsfn_softbuffer = {};
+
+  // Scratch for the metrics pushed to the sink, and sink and TTI of the last push
+  std::vector<phy_metrics_t>  sink_metrics, sink_cc_metrics;
+  enb_metrics_sink_interface* sink_last     = nullptr;
+  uint32_t                    sink_last_tti = 0;
 };
 
 } // namespace lte
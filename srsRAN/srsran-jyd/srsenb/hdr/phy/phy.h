@@ -73,6 +73,7 @@ public:
   void complete_config(uint16_t rnti) override;
 
   void get_metrics(std::vector<phy_metrics_t>& metrics) override;
+  void set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti) override;
 
   void cmd_cell_gain(uint32_t cell_id, float gain_db) override;
 
@@ -35,6 +35,7 @@
 #include "srsran/phy/channel/channel.h"
 #include "srsran/radio/radio.h"
 
+#include <atomic>
 #include <map>
 #include <srsran/common/tti_sempahore.h>
 #include <string.h>
@@ -71,6 +72,10 @@ public:
   // Common objects
   phy_args_t params = {};
 
+  // Receives the metrics of each worker every metrics_sink_period TTIs. nullptr while nobody consumes them
+  std::atomic<enb_metrics_sink_interface*> metrics_sink{nullptr};
+  std::atomic<uint32_t>                    metrics_sink_period{1};
+
   uint32_t get_nof_carriers_lte() { return static_cast<uint32_t>(cell_list_lte.size()); }
   uint32_t get_nof_carriers_nr() { return static_cast<uint32_t>(cell_list_nr.size()); }
   uint32_t get_nof_carriers() { return static_cast<uint32_t>(cell_list_lte.size() + cell_list_nr.size()); }
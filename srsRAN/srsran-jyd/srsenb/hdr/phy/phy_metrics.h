@@ -22,6 +22,8 @@
 #ifndef SRSENB_PHY_METRICS_H
 #define SRSENB_PHY_METRICS_H
 
+#include <stdint.h>
+
 namespace srsenb {
 
 // PHY metrics per user
@@ -43,6 +45,7 @@ struct dl_metrics_t {
 };
 
 struct phy_metrics_t {
+  uint16_t     rnti;
   dl_metrics_t dl;
   ul_metrics_t ul;
 };
@@ -81,6 +81,7 @@ typedef struct {
 } stack_args_t;
 
 struct stack_metrics_t;
+class enb_metrics_sink_interface;
 
 class enb_stack_base
 {
@@ -94,6 +95,8 @@ public:
   virtual void toggle_padding() = 0;
   // eNB metrics interface
   virtual bool get_metrics(stack_metrics_t* metrics) = 0;
+  // Pushes the stack metrics to sink every period_tti TTIs. nullptr stops pushing
+  virtual void set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti) {}
 
   virtual void tti_clock() = 0;
 };
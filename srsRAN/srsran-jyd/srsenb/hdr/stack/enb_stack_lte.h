@@ -34,11 +34,13 @@
 #include "upper/gtpu.h"
 #include "upper/pdcp.h"
 #include "upper/rlc.h"
+#include "upper/tc.h"
 
 #include "enb_stack_base.h"
 #include "srsran/common/bearer_manager.h"
 #include "srsran/common/mac_pcap_net.h"
 #include "srsran/interfaces/enb_interfaces.h"
+#include "srsran/interfaces/enb_metrics_interface.h"
 #include "srsran/srslog/srslog.h"
 
 namespace srsenb {
@@ -59,6 +61,7 @@ public:
   void stop() final;
   std::string get_type() final;
   bool        get_metrics(stack_metrics_t* metrics) final;
+  void        set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti) final;
 
   /* PHY-MAC interface */
   int  sr_detected(uint32_t tti, uint16_t rnti) final { return mac.sr_detected(tti, rnti); }
@@ -150,6 +153,12 @@ public:
 
   // E2 Agent
   slice_ctrl_out_e slice(slice_ctrl_req_data_t const& s);
+  void             get_slice_conf(slice_conf_t* conf);
+  void             get_slice_stats(slice_ind_msg_t* ind);
+  void             get_ue_slice_conf(ue_slice_conf_t* conf);
+  void             get_kpm_counters(kpm_counters_t* c);
+  tc_ctrl_out_e    tc_control(const tc_ctrl_msg_t& msg);
+  void             get_tc_stats(tc_ind_msg_t* ind);
 
 private:
   static const int STACK_MAIN_THREAD_PRIO = 4;
@@ -157,6 +166,7 @@ private:
   void run_thread() override;
   void stop_impl();
   void tti_clock_impl();
+  void push_sink_metrics(enb_metrics_sink_interface* sink);
 
   // args
   stack_args_t args    = {};
@@ -188,6 +198,7 @@ private:
   srsenb::mac  mac;
   srsenb::rlc  rlc;
   srsenb::pdcp pdcp;
+  srsenb::tc   tc;
   srsenb::rrc  rrc;
   srsenb::gtpu gtpu;
   srsenb::s1ap s1ap;
@@ -199,6 +210,13 @@ private:
   std::atomic<bool> started{false};
 
   srsran::dyn_blocking_queue<stack_metrics_t> pending_stack_metrics;
+
+  // metrics pushed from the stack thread, reused to avoid reallocating every period
+  std::atomic<enb_metrics_sink_interface*> metrics_sink{nullptr};
+  std::atomic<uint32_t>                    metrics_sink_period{1};
+  enb_metrics_sink_interface*              metrics_sink_last = nullptr;
+  uint32_t                                 metrics_sink_tti  = 0;
+  stack_metrics_t                          sink_metrics;
 };
 
 } // namespace srsenb
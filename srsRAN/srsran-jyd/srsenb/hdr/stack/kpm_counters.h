@@ -0,0 +1,115 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        kpm_counters.h
+ * Description: Cumulative counters kept by MAC, RLC and RRC for the E2SM-KPM
+ *              report service. Layers only ever increment them; the E2 agent
+ *              samples them and reports the difference between two samples.
+ *****************************************************************************/
+
+#ifndef SRSENB_KPM_COUNTERS_H
+#define SRSENB_KPM_COUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+
+namespace srsenb {
+
+inline uint64_t kpm_now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Scheduler counters, updated once per carrier TTI by the worker that runs the scheduler.
+struct mac_kpm_counters_t {
+  std::atomic<uint64_t> nof_ttis{0};   ///< Carrier TTIs scheduled
+  std::atomic<uint64_t> dl_prbs{0};    ///< PRBs allocated to PDSCH (data, broadcast, RAR, paging)
+  std::atomic<uint64_t> ul_prbs{0};    ///< PRBs allocated to PUSCH
+  std::atomic<uint64_t> dl_bytes{0};   ///< TBS of new DL data transmissions
+  std::atomic<uint64_t> ul_bytes{0};   ///< TBS of new UL data transmissions
+  std::atomic<uint64_t> dl_ue_ttis{0}; ///< Sum over TTIs of UEs with DL data scheduled
+  std::atomic<uint64_t> ul_ue_ttis{0}; ///< Sum over TTIs of UEs with UL data scheduled
+};
+
+/// Time integral of the number of UE contexts held by RRC, needed for RRC.ConnMean.
+class rrc_kpm_counters_t
+{
+public:
+  void add_ue() { update(+1); }
+  void rem_ue() { update(-1); }
+
+  /// Integral in UE.us up to now
+  uint64_t conn_ue_us()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(kpm_now_us());
+    return ue_us;
+  }
+
+private:
+  void update(int32_t delta)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(kpm_now_us());
+    nof_ues += delta;
+  }
+  void advance(uint64_t now_us)
+  {
+    if (last_us != 0) {
+      ue_us += nof_ues * (now_us - last_us);
+    }
+    last_us = now_us;
+  }
+
+  std::mutex mutex;
+  uint64_t   nof_ues = 0;
+  uint64_t   ue_us   = 0;
+  uint64_t   last_us = 0;
+};
+
+/// Snapshot of all counters, taken by the E2 agent.
+struct kpm_counters_t {
+  uint64_t tstamp_us = 0;
+
+  // MAC
+  uint64_t nof_ttis   = 0;
+  uint64_t dl_prbs    = 0;
+  uint64_t ul_prbs    = 0;
+  uint64_t dl_bytes   = 0;
+  uint64_t ul_bytes   = 0;
+  uint64_t dl_ue_ttis = 0;
+  uint64_t ul_ue_ttis = 0;
+
+  // RLC, DRBs only
+  uint64_t rlc_dl_sdu_delay_us = 0;
+  uint64_t rlc_dl_sdus         = 0;
+
+  // RRC
+  uint64_t rrc_conn_ue_us = 0;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_KPM_COUNTERS_H
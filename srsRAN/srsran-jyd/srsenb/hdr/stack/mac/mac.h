@@ -109,7 +109,8 @@ public:
   /* Handover-related */
   uint16_t reserve_new_crnti(const sched_interface::ue_cfg_t& ue_cfg) override;
 
-  void get_metrics(mac_metrics_t& metrics);
+  // restart_averages=false leaves the PHR/CQI averaging windows running, for readers polling every few TTIs
+  void get_metrics(mac_metrics_t& metrics, bool restart_averages = true);
 
   void toggle_padding();
 
@@ -122,6 +123,10 @@ public:
                   const uint8_t              mcch_payload_length) override;
 
   slice_ctrl_out_e slice(slice_ctrl_req_data_t const& s);
+  void             get_slice_conf(slice_conf_t* conf);
+  void             get_slice_stats(slice_ind_msg_t* ind);
+  void             get_ue_slice_conf(ue_slice_conf_t* conf);
+  void             get_kpm_counters(kpm_counters_t* c);
 
 private:
   bool     check_ue_active(uint16_t rnti);
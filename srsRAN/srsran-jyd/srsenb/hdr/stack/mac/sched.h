@@ -24,8 +24,10 @@
 
 #include "sched_grid.h"
 #include "sched_interface.h"
+#include "sched_slice.h"
 #include "sched_ue.h"
 #include "srsenb/hdr/common/common_enb.h"
+#include "srsenb/hdr/stack/kpm_counters.h"
 #include <atomic>
 #include <map>
 #include <mutex>
@@ -95,6 +97,10 @@ public:
 
   // E2 Agent
   slice_ctrl_out_e slice(slice_ctrl_req_data_t const& s);
+  void             get_slice_conf(slice_conf_t* conf);
+  void             get_slice_stats(slice_ind_msg_t* ind);
+  void             get_ue_slice_conf(ue_slice_conf_t* conf);
+  void             get_kpm_counters(kpm_counters_t* c);
 
 protected:
   void new_tti(srsran::tti_point tti_rx);
@@ -110,6 +116,13 @@ protected:
 
   rnti_map_t<std::unique_ptr<sched_ue> > ue_db;
 
+  // Last DL allocation of every UE, indexed by RNTI and packed by sched_ue. Kept in sync with ue_db under sched_mutex
+  // and read without it, so that the metrics do not contend with dl_sched/ul_sched
+  std::unique_ptr<std::atomic<uint64_t>[]> ue_dl_alloc;
+
+  // Cumulative E2SM-KPM counters of all carriers, read lock-free by the E2 agent
+  mac_kpm_counters_t kpm_counters;
+
   // independent schedulers for each carrier
   std::vector<std::unique_ptr<carrier_sched> > carrier_schedulers;
 
@@ -120,27 +133,18 @@ protected:
   std::mutex        sched_mutex;
   bool              configured;
 
-  std::vector<sched_ue*> ues_in_slice(uint32_t slice_id);
   slice_ctrl_out_e slice_add_mod(slice_conf_t const& conf);
   slice_ctrl_out_e ue_slice_conf(ue_slice_conf_t const& ue_slice);
+  void             update_ue_slices();
 
-};
-
-class Slicing {
-public:
-  static Slicing& getInstance() {
-    static Slicing instance;
-    return instance;
-  }
-
-  Slicing(Slicing const&) = delete;
-  void operator=(Slicing const&) = delete;
-
-  slice_conf_t stats_slice_conf;
-  ue_slice_conf_t stats_ue_slice_conf;
+  // Slice configuration. Written by the E2 agent under slice_ctrl_mutex, read lock-free by the scheduler.
+  // When both mutexes are needed, sched_mutex is locked first
+  sched_slice_db        slice_db;
+  std::mutex            slice_ctrl_mutex;
+  std::vector<uint32_t> slice_cells_nof_prb; ///< Carriers bandwidth, used to derive the slice resources
+  bool           ue_slices_dirty = true;
+  uint32_t       slicer_epoch    = 0;
 
-private:
-  Slicing() {}
 };
 
 } // namespace srsenb
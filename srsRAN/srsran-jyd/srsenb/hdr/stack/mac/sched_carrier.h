@@ -24,6 +24,8 @@
 
 #include "sched.h"
 #include "schedulers/sched_base.h"
+#include "schedulers/sched_slice_edf.h"
+#include "schedulers/sched_slice_nvs.h"
 #include "srsran/adt/pool/cached_alloc.h"
 #include "srsran/srslog/srslog.h"
 
@@ -38,13 +40,17 @@ public:
   explicit carrier_sched(rrc_interface_mac*       rrc_,
                          sched_ue_list*           ue_db_,
                          uint32_t                 enb_cc_idx_,
-                         sched_result_ringbuffer* sched_results_);
+                         sched_result_ringbuffer* sched_results_,
+                         mac_kpm_counters_t*      kpm_counters_ = nullptr);
   ~carrier_sched();
   void                   reset();
   void                   carrier_cfg(const sched_cell_params_t& sched_params_);
   void                   set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
   const cc_sched_result& generate_tti_result(srsran::tti_point tti_rx);
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
+  void                   set_slices(const sched_slice_table& slices_);
+  //! Distribute the UEs among the schedulers of each slice. To be called when the UEs or their slices change
+  void update_ue_subsets();
 
   // getters
   const ra_sched* get_ra_sched() const { return ra_sched_ptr.get(); }
@@ -58,6 +64,20 @@ private:
   int alloc_ul_users(sf_sched* tti_sched);
   //! Get sf_sched for a given TTI
   sf_sched* get_sf_sched(srsran::tti_point tti_rx);
+  //! Compute DL scheduler result of the NVS slices for given TTI
+  void alloc_dl_nvs_slices(sf_sched* tti_sched);
+  //! Compute DL scheduler result of the EDF slices for given TTI
+  void alloc_dl_edf_slices(sf_sched* tti_sched);
+  //! Compute UL scheduler result of the NVS slices for given TTI
+  void alloc_ul_nvs_slices(sf_sched* tti_sched);
+  //! Compute UL scheduler result of the EDF slices for given TTI
+  void alloc_ul_edf_slices(sf_sched* tti_sched);
+  //! Run the UL scheduler of a slice, and account the PRBs allocated to it
+  uint32_t sched_ul_slice(uint32_t slice_idx, sf_sched* tti_sched);
+  //! Build the UL slice schedulers of the active slice table
+  void set_ul_slices();
+  //! Accumulate the KPM counters with the final result of a TTI
+  void update_kpm_counters(const sf_sched& tti_sched, const cc_sched_result& cc_result);
 
   // args
   const sched_cell_params_t* cc_cfg = nullptr;
@@ -71,12 +91,27 @@ private:
 
   // scheduling results
   sched_result_ringbuffer* prev_sched_results;
+  mac_kpm_counters_t*      kpm_counters = nullptr; ///< Shared by all carriers, owned by the sched
 
   std::vector<uint8_t> sf_dl_mask; ///< Some TTIs may be forbidden for DL sched due to MBMS
 
   std::unique_ptr<bc_sched>   bc_sched_ptr;
   std::unique_ptr<ra_sched>   ra_sched_ptr;
   std::unique_ptr<sched_base> sched_algo;
+  sched_ue_subset             sched_ues; ///< UEs handled by sched_algo
+
+  // Slicing
+  struct slice_sched_t {
+    sched_ue_subset             ues;
+    std::unique_ptr<sched_base> algo;
+  };
+  const sched_slice_table*         slices = nullptr;
+  std::vector<slice_sched_t>       slice_scheds; ///< One intra-slice scheduler per DL slice of the active table
+  std::unique_ptr<sched_slice_nvs> nvs_sched;
+  std::unique_ptr<sched_slice_edf> edf_sched;
+  std::vector<slice_sched_t>       ul_slice_scheds; ///< One per UL slice. Empty if UL follows the DL slices
+  std::unique_ptr<sched_slice_nvs> ul_nvs_sched;
+  std::unique_ptr<sched_slice_edf> ul_edf_sched;
 };
 
 //! Broadcast (SIB + paging) scheduler
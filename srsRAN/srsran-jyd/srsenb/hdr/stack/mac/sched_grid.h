@@ -206,6 +206,17 @@ public:
   const prbmask_t&                get_ul_mask() const { return tti_alloc.get_ul_mask(); }
   tti_point                       get_tti_tx_ul() const { return to_tx_ul(tti_rx); }
   srsran::const_span<rar_alloc_t> get_allocated_rars() const { return rar_allocs; }
+  srsran::const_span<dl_alloc_t>  get_allocated_dl_data() const { return data_allocs; }
+  srsran::const_span<ul_alloc_t>  get_allocated_ul_data() const { return ul_data_allocs; }
+
+  //! Make RBGs unavailable to the UE DL allocations that follow, e.g. to cap the resources of a slice
+  void             restrict_dl_users(const rbgmask_t& forbidden_rbgs) { dl_user_restriction = forbidden_rbgs; }
+  void             clear_dl_user_restriction() { dl_user_restriction.resize(0); }
+  const rbgmask_t& get_dl_user_restriction() const { return dl_user_restriction; }
+  //! Make PRBs unavailable to the UE UL allocations that follow
+  void             restrict_ul_users(const prbmask_t& forbidden_prbs) { ul_user_restriction = forbidden_prbs; }
+  void             clear_ul_user_restriction() { ul_user_restriction.resize(0); }
+  const prbmask_t& get_ul_user_restriction() const { return ul_user_restriction; }
 
   // getters
   tti_point                  get_tti_rx() const { return tti_rx; }
@@ -235,6 +246,8 @@ private:
   srsran::bounded_vector<dl_alloc_t, sched_interface::MAX_DATA_LIST> data_allocs;
   srsran::bounded_vector<ul_alloc_t, sched_interface::MAX_DATA_LIST> ul_data_allocs;
   uint32_t                                                           last_msg3_prb = 0, max_msg3_prb = 0;
+  rbgmask_t                                                          dl_user_restriction;
+  prbmask_t                                                          ul_user_restriction;
 
   // Next TTI state
   tti_point tti_rx;
@@ -24,9 +24,12 @@
 #include "srsran/common/common.h"
 #include "srsran/srsran.h"
 #include "srsran/common/standard_streams.h"
-#include <vector>
+#include <array>
+#include <atomic>
+#include <limits>
 #include <map>
 #include <mutex>
+#include <vector>
 // #include <string>
 // #include <stdint.h>
 #include <fstream>
@@ -43,6 +46,12 @@
 
 namespace srsenb {
 
+/**
+ * UE to slice association service.
+ * Tracks the IMSI/TMSI of each RNTI, as captured by RRC, and the DL and UL slices each IMSI is associated to. The
+ * associations of every RNTI are mirrored in flat RNTI-indexed tables, which the scheduler reads without locking.
+ * epoch() is bumped after every change, so that the scheduler only re-resolves the UE slices when needed.
+ */
 class slicer_interface
 {
 public:
@@ -52,15 +61,16 @@ static slicer_interface& getInstance() {
 }
 ~slicer_interface() {};
 
+/// Value of find_slice() for RNTIs without slice association
+static const uint32_t no_slice = std::numeric_limits<uint32_t>::max();
+
 int upd_member_crnti(uint64_t imsi, uint16_t crnti)
 {
   std::lock_guard<std::mutex> lock(slicer_mutex);
-  // auto it = imsi_to_crnti.find(imsi);
-  // if it != imsi_to_crnti.end(){
-  //   size_t removed = crnti_to_imsi.erase(it->second);
-  // }
   crnti_to_imsi[crnti] = imsi;
   imsi_to_crnti[imsi] = crnti;
+  bind_imsi_slice(imsi, crnti);
+  epoch_++;
   srsran::console("[slicer] updated IMSI: %015" PRIu64 " with RNTI: 0x%x\n", imsi, crnti);
   return 0;
 };
@@ -91,6 +101,8 @@ int upd_member_crnti(uint32_t tmsi, uint16_t crnti)
                     imsi_to_crnti[tmsi_to_imsi[tmsi]], crnti, tmsi, tmsi_to_imsi[tmsi]);
     imsi_to_crnti[tmsi_to_imsi[tmsi]] = crnti;
     crnti_to_imsi[crnti] = tmsi_to_imsi[tmsi];
+    bind_imsi_slice(tmsi_to_imsi[tmsi], crnti);
+    epoch_++;
 }
 return 0;
 };
@@ -109,11 +121,29 @@ int upd_member_crnti(uint16_t old_crnti, uint16_t new_crnti)
       break;
     }
   }
+  // The slices follow the UE, even if its IMSI is not known
+  for (slice_assoc_t* assoc : {&dl_assoc, &ul_assoc}) {
+    assoc->rnti_slice[new_crnti].store(assoc->rnti_slice[old_crnti].load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+    assoc->rnti_slice[old_crnti].store(no_slice, std::memory_order_relaxed);
+  }
+  epoch_++;
 
   return 0;
 };
 
+/// Forget the previous owner of a RNTI that is assigned to a new UE
+void rem_crnti(uint16_t crnti)
+{
+  std::lock_guard<std::mutex> lock(slicer_mutex);
+  crnti_to_imsi.erase(crnti);
+  dl_assoc.rnti_slice[crnti].store(no_slice, std::memory_order_relaxed);
+  ul_assoc.rnti_slice[crnti].store(no_slice, std::memory_order_relaxed);
+  epoch_++;
+}
+
 uint64_t find_imsi(uint16_t rnti){
+  std::lock_guard<std::mutex> lock(slicer_mutex);
   auto it = crnti_to_imsi.find(rnti);
   if(it != crnti_to_imsi.end())
       return it->second;
@@ -122,24 +152,97 @@ uint64_t find_imsi(uint16_t rnti){
     return (uint64_t) 0;
 };
 
-uint32_t find_sliceId(uint16_t rnti){
+/// Associate an IMSI to a slice, or remove its association with no_slice. Applied to the current RNTI of the IMSI
+void set_imsi_slice(uint64_t imsi, uint32_t slice_id) { set_imsi_slice(dl_assoc, imsi, slice_id); }
+void set_imsi_ul_slice(uint64_t imsi, uint32_t slice_id) { set_imsi_slice(ul_assoc, imsi, slice_id); }
+
+/// Associate a RNTI to a slice. If the IMSI of the RNTI is known, the association survives RNTI changes and re-attaches
+void set_rnti_slice(uint16_t rnti, uint32_t slice_id) { set_rnti_slice(dl_assoc, rnti, slice_id); }
+void set_rnti_ul_slice(uint16_t rnti, uint32_t slice_id) { set_rnti_slice(ul_assoc, rnti, slice_id); }
+
+/// Slice associated to the IMSI, or no_slice. Kept while the IMSI is detached
+uint32_t find_imsi_slice(uint64_t imsi) { return find_imsi_slice(dl_assoc, imsi); }
+uint32_t find_imsi_ul_slice(uint64_t imsi) { return find_imsi_slice(ul_assoc, imsi); }
+
+/// Slice associated to the RNTI, or no_slice. Lock-free, to be used by the scheduler
+uint32_t find_slice(uint16_t rnti) const { return dl_assoc.rnti_slice[rnti].load(std::memory_order_relaxed); }
+uint32_t find_ul_slice(uint16_t rnti) const { return ul_assoc.rnti_slice[rnti].load(std::memory_order_relaxed); }
+
+/// Incremented on every IMSI/RNTI/slice association change, so that users can cache lookups. The associations are
+/// visible to the readers that observed the new epoch
+uint32_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+private:
+/// Slice associations of one direction
+struct slice_assoc_t {
+  std::map<uint64_t, uint32_t> imsi_to_slice;
+  /// Slice of every RNTI, written under slicer_mutex and read lock-free
+  std::array<std::atomic<uint32_t>, std::numeric_limits<uint16_t>::max() + 1> rnti_slice;
+};
+
+slicer_interface()
+{
+  for (slice_assoc_t* assoc : {&dl_assoc, &ul_assoc}) {
+    for (std::atomic<uint32_t>& s : assoc->rnti_slice) {
+      s.store(no_slice, std::memory_order_relaxed);
+    }
+  }
+}
+
+void set_imsi_slice(slice_assoc_t& assoc, uint64_t imsi, uint32_t slice_id)
+{
+  std::lock_guard<std::mutex> lock(slicer_mutex);
+  if (slice_id == no_slice) {
+    assoc.imsi_to_slice.erase(imsi);
+  } else {
+    assoc.imsi_to_slice[imsi] = slice_id;
+  }
+  auto it = imsi_to_crnti.find(imsi);
+  if (it != imsi_to_crnti.end()) {
+    assoc.rnti_slice[it->second].store(slice_id, std::memory_order_relaxed);
+  }
+  epoch_++;
+}
+
+uint32_t find_imsi_slice(slice_assoc_t& assoc, uint64_t imsi)
+{
+  std::lock_guard<std::mutex> lock(slicer_mutex);
+  auto it = assoc.imsi_to_slice.find(imsi);
+  return it != assoc.imsi_to_slice.end() ? it->second : no_slice;
+}
+
+void set_rnti_slice(slice_assoc_t& assoc, uint16_t rnti, uint32_t slice_id)
+{
+  std::lock_guard<std::mutex> lock(slicer_mutex);
   auto it = crnti_to_imsi.find(rnti);
-  if(it != crnti_to_imsi.end())
-  {
-    uint32_t idx = (uint32_t) (it->second % 3);
-    
-    return idx;
+  if (it != crnti_to_imsi.end() and it->second != 0) {
+    assoc.imsi_to_slice[it->second] = slice_id;
   }
-  else
-    return (uint32_t) 99;
-};
+  assoc.rnti_slice[rnti].store(slice_id, std::memory_order_relaxed);
+  epoch_++;
+}
 
+/// Called when the RNTI of an IMSI becomes known. Must be called with slicer_mutex held
+void bind_imsi_slice(uint64_t imsi, uint16_t crnti)
+{
+  for (slice_assoc_t* assoc : {&dl_assoc, &ul_assoc}) {
+    auto it = assoc->imsi_to_slice.find(imsi);
+    if (it != assoc->imsi_to_slice.end()) {
+      assoc->rnti_slice[crnti].store(it->second, std::memory_order_relaxed);
+    } else if (assoc->rnti_slice[crnti].load(std::memory_order_relaxed) != no_slice) {
+      // The RNTI was associated before its IMSI was known
+      assoc->imsi_to_slice[imsi] = assoc->rnti_slice[crnti].load(std::memory_order_relaxed);
+    }
+  }
+}
 
-private:
+std::atomic<uint32_t> epoch_{0};
 std::mutex slicer_mutex;
 std::map<uint32_t, uint64_t> tmsi_to_imsi;
 std::map<uint64_t, uint16_t> imsi_to_crnti;
 std::map<uint16_t, uint64_t> crnti_to_imsi;
+slice_assoc_t dl_assoc;
+slice_assoc_t ul_assoc;
 
 };
 
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_SLICE_H
+#define SRSRAN_SCHED_SLICE_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../../sm/agent_if/ie/slice_data_ie.h"
+#include "sched_phy_ch/sched_phy_resource.h"
+
+namespace srsenb {
+
+/// Resources of a carrier that the UEs of a slice are not allowed to use
+struct sched_slice_cc_t {
+  rbgmask_t dl_mask; ///< RBGs not available for PDSCH
+  prbmask_t ul_mask; ///< PRBs not available for PUSCH
+};
+
+/// Runtime counters of a slice. Updated by the scheduler, read by the E2 agent. Shared by the DL and UL slices with the
+/// same id
+struct sched_slice_stats_t {
+  std::atomic<uint32_t> dl_deadline_miss{0}; ///< EDF windows that ended with backlog and unused guaranteed PRBs
+  std::atomic<uint32_t> ul_deadline_miss{0};
+  std::atomic<uint64_t> ul_alloc_prbs{0}; ///< PUSCH PRBs allocated to the UEs of the slice
+};
+
+/// Configuration of a single slice, as seen by the scheduler
+struct sched_slice_t {
+  uint32_t              id = 0;
+  std::string           label;
+  std::string           sched; ///< intra-slice scheduling policy (e.g. "time_rr", "time_pf")
+  slice_params_t        params = {};
+  std::vector<uint32_t> edf_over; ///< owns the EDF "over" list. params.u.edf.over is never set
+
+  /// Shared by all the tables that contain the slice, so that the counters survive reconfigurations
+  std::shared_ptr<sched_slice_stats_t> stats;
+
+  /// Derived from params and the carriers bandwidth, indexed by enb_cc_idx
+  std::vector<sched_slice_cc_t> cc;
+
+  /// Resources not available to the slice in the given carrier, or nullptr if the slice is not restricted in it
+  const sched_slice_cc_t* get_cc(uint32_t enb_cc_idx) const
+  {
+    return enb_cc_idx < cc.size() ? &cc[enb_cc_idx] : nullptr;
+  }
+};
+
+/**
+ * Set of slices configured at a given time. Once published, a table is never modified.
+ * DL and UL are sliced independently. Static windows are given in RBGs for DL slices and in PRBs for UL slices. When
+ * no UL slice is configured, the PUSCH of a UE is confined to the PRBs spanned by the RBG window of its DL slice.
+ */
+class sched_slice_table
+{
+public:
+  /// Return the position of the DL slice with the given id, or -1 if it does not exist
+  int find_slice(uint32_t slice_id) const { return find_slice(slices, slice_id); }
+  /// Return the position of the UL slice with the given id, or -1 if it does not exist
+  int find_ul_slice(uint32_t slice_id) const { return find_slice(ul_slices, slice_id); }
+
+  bool empty() const { return slices.empty() and ul_slices.empty(); }
+
+  /// Derive the RBG/PRB masks of every slice for the given carriers (nof PRBs, indexed by enb_cc_idx).
+  /// Returns false if a slice does not fit in one of the carriers
+  bool set_cells(const std::vector<uint32_t>& cells_nof_prb);
+
+  /// Reuse the counters of the slices with the same id in the previous table, and create new ones for the others
+  void set_stats(const sched_slice_table& prev);
+
+  uint32_t                   version = 0;
+  std::string                sched_name;    ///< UE scheduling policy reported to the E2 agent
+  std::vector<sched_slice_t> slices;        ///< DL slices, sorted by slice id
+  std::string                ul_sched_name; ///< empty if UL is not sliced
+  std::vector<sched_slice_t> ul_slices;     ///< UL slices, sorted by slice id
+
+private:
+  static int find_slice(const std::vector<sched_slice_t>& list, uint32_t slice_id);
+};
+
+/**
+ * RCU-like holder of the slice configuration.
+ * The control path (E2 agent) builds a new immutable table and publishes it, without ever blocking the scheduler.
+ * The scheduler picks up the last published table at the TTI boundary via new_tti(). Old tables are only released by
+ * the control path, once the scheduler has moved to a more recent version.
+ * Control path methods (publish, latest) must be serialized by the caller.
+ */
+class sched_slice_db
+{
+public:
+  sched_slice_db();
+  sched_slice_db(const sched_slice_db&) = delete;
+  sched_slice_db& operator=(const sched_slice_db&) = delete;
+
+  /// Control path. Make the table visible to the scheduler, starting from the next TTI
+  void publish(std::unique_ptr<sched_slice_table> table);
+  /// Control path. Last published table, which may not yet be active in the scheduler
+  const sched_slice_table& latest() const { return *tables.back(); }
+
+  /// Scheduler path. Switch to the last published table. Returns true if the active table changed
+  bool new_tti();
+  /// Scheduler path. Table used for the current TTI
+  const sched_slice_table& active() const { return *active_table; }
+
+private:
+  // Owned by the control path
+  std::deque<std::unique_ptr<sched_slice_table> > tables;
+  uint32_t                                        next_version = 0;
+
+  // Handover between control path and scheduler
+  std::atomic<sched_slice_table*> pending{nullptr};
+  std::atomic<uint32_t>           active_version{0};
+
+  // Owned by the scheduler
+  const sched_slice_table* active_table = nullptr;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_SLICE_H
@@ -29,12 +29,15 @@
 #include "srsenb/hdr/common/common_enb.h"
 #include "srsenb/hdr/stack/mac/common/mac_metrics.h"
 #include "srsran/srslog/srslog.h"
+#include <atomic>
 #include <bitset>
 #include <map>
 #include <vector>
 
 namespace srsenb {
 
+struct sched_slice_t;
+
 typedef enum { UCI_PUSCH_NONE = 0, UCI_PUSCH_CQI, UCI_PUSCH_ACK, UCI_PUSCH_ACK_CQI } uci_pusch_t;
 
 /** This class is designed to be thread-safe because it is called from workers through scheduler thread and from
@@ -83,7 +86,18 @@ public:
   const ue_cfg_t&           get_ue_cfg() const { return cfg; }
   uint32_t                  get_aggr_level(uint32_t enb_cc_idx, uint32_t nof_bits);
   void                      ul_buffer_add(uint8_t lcid, uint32_t bytes);
-  void                      metrics_read(mac_ue_metrics_t& metrics);
+
+  /// Word, owned by the sched, where the UE publishes its last DL allocation. See sched::metrics_read()
+  void set_dl_alloc_metric(std::atomic<uint64_t>* m) { dl_alloc_metric = m; }
+
+  /// Packing of the published DL allocation. Zero stands for a UE not in the sched
+  static uint64_t dl_alloc_pack(uint32_t nof_prbs, tti_point tti)
+  {
+    return dl_alloc_present | (uint64_t(nof_prbs & 0xffffu) << 32u) | tti.to_uint();
+  }
+  static uint32_t dl_alloc_prbs(uint64_t m) { return (m >> 32u) & 0xffffu; }
+  static uint32_t dl_alloc_tti(uint64_t m) { return m & 0xffffffffu; }
+  static const uint64_t dl_alloc_present = 1ull << 63u;
 
   /*******************************************************
    * Functions used by scheduler metric objects
@@ -152,11 +166,15 @@ public:
   bool phich_enabled(tti_point tti_rx, uint32_t enb_cc_idx) const;
 
   // E2 Agent
-  void set_slice_id(int slice_id);
+  void set_slice(const sched_slice_t* slice_) { slice = slice_; }
+  /// Slice the UE belongs to in the scheduler's active slice table, or nullptr
+  const sched_slice_t* get_slice() const { return slice; }
+  void                 set_ul_slice(const sched_slice_t* slice_) { ul_slice = slice_; }
+  /// UL slice the UE belongs to in the scheduler's active slice table, or nullptr
+  const sched_slice_t* get_ul_slice() const { return ul_slice; }
   void set_low_pos(size_t low_pos);
   void set_high_pos(size_t high_pos);
 
-  int slice_id(void);
   size_t low_pos(void);
   size_t high_pos(void);
 
@@ -224,27 +242,26 @@ private:
   uint32_t cqi_request_tti = 0;
   uint16_t rnti            = 0;
   uint32_t max_msg3retx    = 0;
-  uint32_t total_prbs      = 0;
 
   bool phy_config_dedicated_enabled = false;
 
   //Added for O-RAN testing
-  srsran::rolling_average<u_int32_t> allocatedRbs;
-  uint32_t alloc_rbs;
-  tti_point tti_track;
-  std::mutex rb_mutex;
+  std::atomic<uint64_t>* dl_alloc_metric = nullptr;
 
 
   tti_point                  current_tti;
   std::vector<sched_ue_cell> cells; ///< List of eNB cells that may be configured/activated/deactivated for the UE
 
   //E2 Agent
-  int slice_id_ = -1; // Not belonging to a slice 
+  const sched_slice_t* slice    = nullptr;
+  const sched_slice_t* ul_slice = nullptr;
   size_t low_pos_ = 0; 
   size_t high_pos_ = 0;
 };
 
 using sched_ue_list = rnti_map_t<std::unique_ptr<sched_ue> >;
+/// Set of UEs handled by a scheduling algorithm instance (e.g. the UEs of a slice)
+using sched_ue_subset = rnti_map_t<sched_ue*>;
 
 } // namespace srsenb
 
@@ -35,8 +35,8 @@ class sched_base
 public:
   virtual ~sched_base() = default;
 
-  virtual void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) = 0;
-  virtual void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) = 0;
+  virtual void sched_dl_users(sched_ue_subset& ue_db, sf_sched* tti_sched) = 0;
+  virtual void sched_ul_users(sched_ue_subset& ue_db, sf_sched* tti_sched) = 0;
 
 protected:
   srslog::basic_logger& logger = srslog::fetch_basic_logger("MAC");
@@ -49,6 +49,10 @@ const dl_harq_proc* get_dl_newtx_harq(sched_ue& user, sf_sched* tti_sched);
 const ul_harq_proc* get_ul_retx_harq(sched_ue& user, sf_sched* tti_sched);
 const ul_harq_proc* get_ul_newtx_harq(sched_ue& user, sf_sched* tti_sched);
 
+/// Resources occupied in the subframe, including the ones the UE may not use due to its slice or its slice budget
+rbgmask_t get_ue_dl_mask(const sf_sched& tti_sched, const sched_ue& ue);
+prbmask_t get_ue_ul_mask(const sf_sched& tti_sched, const sched_ue& ue);
+
 /// Helper methods to allocate resources in subframe
 alloc_result try_dl_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const dl_harq_proc& h);
 alloc_result
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_SLICE_EDF_H
+#define SRSRAN_SCHED_SLICE_EDF_H
+
+#include "srsenb/hdr/stack/mac/sched_slice.h"
+#include <vector>
+
+namespace srsenb {
+
+/**
+ * Earliest-deadline-first inter-slice scheduler. Every slice is guaranteed "guaranteed_prbs" PRBs within each
+ * window of "deadline" TTIs. Slices with guaranteed PRBs left in their window are served first, earliest window end
+ * first, and capped to their remaining budget. The resources left are then given to all the slices in the same order,
+ * so the scheduler is work-conserving. Unused budget is carried over to the next window, up to "max_replenish" PRBs.
+ * A deadline miss is counted when a window ends with budget left, while the slice had data it could not send.
+ * One instance schedules either the DL slices (PDSCH PRBs) or the UL slices (PUSCH PRBs).
+ */
+class sched_slice_edf
+{
+public:
+  explicit sched_slice_edf(bool is_ul_ = false) : is_ul(is_ul_) {}
+
+  /// Check the EDF parameters of all the slices, and that the guaranteed PRB rates fit in every carrier
+  static bool validate(const std::vector<sched_slice_t>& slices, const std::vector<uint32_t>& cells_nof_prb);
+
+  /// Start the first window of every slice of a new slice configuration
+  void set_slices(const std::vector<sched_slice_t>& slices_);
+
+  /// Advance the slice windows by one TTI. Must be called once per TTI, before the slices are served
+  void new_tti();
+
+  /// Order in which the slices (positions in the slice list) are served in the current TTI
+  const std::vector<uint32_t>& get_order();
+
+  /// Guaranteed PRBs the slice has left in its current window
+  uint32_t get_budget(uint32_t slice_idx) const { return slices[slice_idx].budget_prbs; }
+
+  /// Save PRBs allocated to a slice in the current TTI. May be called several times per TTI
+  void save_alloc(uint32_t slice_idx, uint32_t alloc_prbs);
+
+  /// Save whether some UEs of the slice were left with pending data at the end of the current TTI
+  void save_backlog(uint32_t slice_idx, bool backlogged);
+
+private:
+  struct slice_ctxt {
+    edf_slice_t            params        = {};
+    std::atomic<uint32_t>* deadline_miss = nullptr; ///< DL or UL counter of the slice
+    uint32_t               tti_left      = 0; ///< TTIs until the end of the current window
+    uint32_t               budget_prbs   = 0;
+    bool                   starved       = false; ///< the slice had pending data and budget left in the current window
+
+    void new_window();
+  };
+
+  const bool              is_ul;
+  std::vector<slice_ctxt> slices;
+  std::vector<uint32_t>   order;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_SLICE_EDF_H
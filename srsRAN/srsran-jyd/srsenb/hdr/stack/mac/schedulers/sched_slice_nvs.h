@@ -0,0 +1,84 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_SLICE_NVS_H
+#define SRSRAN_SCHED_SLICE_NVS_H
+
+#include "srsenb/hdr/stack/mac/sched_slice.h"
+#include <vector>
+
+namespace srsenb {
+
+/**
+ * NVS inter-slice scheduler (Kokku et al., "NVS: A Substrate for Virtualizing Wireless Resources in Cellular
+ * Networks"). Each slice reserves either a rate (Mbps) or a share of the carrier resources. The slices are ranked every
+ * TTI by the ratio between their reservation and their exponentially averaged throughput/share, so that the slices
+ * furthest below their reservation are served first. Resources left unused by a slice go to the next one in the
+ * ranking, which makes the scheduler work-conserving.
+ * SCN19 slices are mapped onto the same machinery: dynamic slices reserve a rate, on-demand slices a share of the
+ * carrier averaged over "tau" TTIs, and fixed slices, which are confined to their window, are always served first.
+ * One instance ranks either the DL slices, in RBGs, or the UL slices, in PRBs.
+ */
+class sched_slice_nvs
+{
+public:
+  /// \param nof_rbs_ number of RBGs of the carrier for DL slices, or number of PRBs for UL slices
+  explicit sched_slice_nvs(uint32_t nof_rbs_) : nof_rbs(nof_rbs_) {}
+
+  /// Check that the NVS/SCN19 parameters of all the slices are valid, and that their reservations fit in the carrier
+  static bool validate(const std::vector<sched_slice_t>& slices);
+
+  /// Reset the slice averages for a new slice configuration
+  void set_slices(const std::vector<sched_slice_t>& slices_);
+
+  /// Order in which the slices (positions in the slice list) are served in the current TTI, highest weight first
+  const std::vector<uint32_t>& get_order();
+
+  /// Save the resources (RBGs or PRBs) allocated to a slice in the current TTI. To be called for every slice, once per
+  /// TTI
+  void save_alloc(uint32_t slice_idx, uint32_t alloc_bytes, uint32_t alloc_rbs);
+
+  float get_weight(uint32_t slice_idx) const { return slices[slice_idx].weight(); }
+
+private:
+  struct slice_ctxt {
+    nvs_slice_t params         = {};
+    bool        fixed          = false; ///< SCN19 fixed slice
+    float       avg_coeff      = 0;
+    float       avg_mbps    = 0; ///< used by rate reservations
+    float       avg_share   = 0; ///< used by capacity reservations
+    uint32_t    nof_samples = 0;
+
+    float weight() const;
+    void  save_alloc(float mbps, float share);
+  };
+
+  /// Default exponential moving average coefficient. Corresponds to a ~100 TTIs window
+  const float avg_coeff = 0.01;
+
+  const uint32_t          nof_rbs;
+  std::vector<slice_ctxt> slices;
+  std::vector<uint32_t>   order;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_SLICE_NVS_H
@@ -177,7 +177,7 @@ public:
   void                         clear_old_buffers(uint32_t tti);
 
   std::mutex metrics_mutex = {};
-  void       metrics_read(mac_ue_metrics_t* metrics_);
+  void       metrics_read(mac_ue_metrics_t* metrics_, bool restart_averages = true);
   void       metrics_rx(bool crc, uint32_t tbs);
   void       metrics_tx(bool crc, uint32_t tbs);
   void       metrics_phr(float phr);
@@ -27,6 +27,7 @@
 #include "rrc_metrics.h"
 #include "srsenb/hdr/common/common_enb.h"
 #include "srsenb/hdr/common/rnti_pool.h"
+#include "srsenb/hdr/stack/kpm_counters.h"
 #include "srsran/adt/circular_buffer.h"
 #include "srsran/common/bearer_manager.h"
 #include "srsran/common/buffer_pool.h"
@@ -86,6 +87,7 @@ public:
 
   void stop();
   void get_metrics(rrc_metrics_t& m);
+  void get_kpm_counters(kpm_counters_t* c);
   void tti_clock();
 
   // rrc_interface_mac
@@ -194,6 +196,7 @@ private:
   std::unique_ptr<freq_res_common_list>    cell_res_list;
   std::map<uint16_t, unique_rnti_ptr<ue> > users; // NOTE: has to have fixed addr
   std::unique_ptr<paging_manager>          pending_paging;
+  rrc_kpm_counters_t                       kpm_counters; ///< UE contexts over time, for RRC.ConnMean
 
   void     process_release_complete(uint16_t rnti);
   void     rem_user(uint16_t rnti);
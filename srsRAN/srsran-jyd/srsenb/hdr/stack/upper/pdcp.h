@@ -74,6 +74,7 @@ public:
 
   // Metrics
   void get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti);
+  void get_cumulative_metrics(pdcp_metrics_t& m);
 
 private:
   class user_interface_rlc : public srsue::rlc_interface_pdcp
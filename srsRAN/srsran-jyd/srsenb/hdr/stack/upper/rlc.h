@@ -20,6 +20,7 @@
  */
 
 #include "srsenb/hdr/common/rnti_pool.h"
+#include "srsenb/hdr/stack/kpm_counters.h"
 #include "srsran/interfaces/enb_metrics_interface.h"
 #include "srsran/interfaces/enb_rlc_interfaces.h"
 #include "srsran/interfaces/ue_interfaces.h"
@@ -43,7 +44,7 @@ class rrc_interface_rlc;
 class pdcp_interface_rlc;
 class mac_interface_rlc;
 
-class rlc : public rlc_interface_mac, public rlc_interface_rrc, public rlc_interface_pdcp
+class rlc : public rlc_interface_mac, public rlc_interface_rrc, public rlc_interface_pdcp, public rlc_interface_tc
 {
 public:
   explicit rlc(srslog::basic_logger& logger) : logger(logger) {}
@@ -51,6 +52,8 @@ public:
   init(pdcp_interface_rlc* pdcp_, rrc_interface_rlc* rrc_, mac_interface_rlc* mac_, srsran::timer_handler* timers_);
   void stop();
   void get_metrics(rlc_metrics_t& m, const uint32_t nof_tti);
+  void get_cumulative_metrics(rlc_metrics_t& m);
+  void get_kpm_counters(kpm_counters_t* c);
 
   // rlc_interface_rrc
   void clear_buffer(uint16_t rnti);
@@ -76,6 +79,9 @@ public:
   int  read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
   void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes);
 
+  // rlc_interface_tc
+  uint32_t get_buffer_state(uint16_t rnti, uint32_t lcid) override;
+
 private:
   class user_interface : public srsue::pdcp_interface_rlc, public srsue::rrc_interface_rlc
   {
@@ -102,6 +108,9 @@ private:
 
   pthread_rwlock_t rwlock;
 
+  // DL SDU delay of the DRBs of all users, for DRB.RlcSduDelayDl. Outlives the user RLC entities
+  srsran::rlc_tx_delay_counter_t drb_tx_delay;
+
   std::map<uint32_t, user_interface> users;
   std::vector<mch_service_t>         mch_services;
 
@@ -0,0 +1,319 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        tc.h
+ * Description: Traffic control of the DL user plane, between GTP-U and PDCP.
+ *              Each UE DRB gets its own pipeline of classifier, policers,
+ *              queues (FIFO, CoDel, ECN-CoDel), shapers, scheduler and pacer,
+ *              instantiated from the configuration set by the E2 TC SM.
+ *****************************************************************************/
+
+#ifndef SRSENB_TC_H
+#define SRSENB_TC_H
+
+#include "srsran/common/bearer_manager.h"
+#include "srsran/common/byte_buffer.h"
+#include "srsran/interfaces/enb_pdcp_interfaces.h"
+#include "srsran/interfaces/enb_rlc_interfaces.h"
+#include "srsran/srslog/srslog.h"
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../../sm/agent_if/ie/tc_data_ie.h"
+
+namespace srsenb {
+
+int64_t tc_now_us();
+
+/// Rate of the bytes seen over a sliding time window
+class tc_meter
+{
+public:
+  void     set_window(uint32_t window_ms_);
+  uint32_t get_window() const { return window_ms; }
+  void     add(uint32_t bytes, int64_t now_us);
+  float    rate_kbps(int64_t now_us);
+
+private:
+  void advance(int64_t now_us);
+
+  uint32_t window_ms   = 100;
+  int64_t  start_us    = 0;
+  uint64_t cur_bytes   = 0;
+  uint64_t prev_bytes  = 0;
+};
+
+/// Counters of a queue. Sojourn sums are reset by every report, the rest are cumulative
+struct tc_queue_stats_t {
+  uint64_t bytes_fwd       = 0;
+  uint64_t pkts_fwd        = 0;
+  uint32_t dropped_pkts    = 0;
+  uint32_t marked_pkts     = 0;
+  uint64_t sojourn_sum_us  = 0;
+  uint64_t sojourn_pkts    = 0;
+  int64_t  last_sojourn_us = 0;
+  // policer
+  uint32_t plc_dropped_pkts  = 0;
+  uint32_t plc_deviated_pkts = 0;
+
+  void merge(const tc_queue_stats_t& other);
+};
+
+/// Egress rate limit of a queue
+struct tc_shaper_t {
+  bool     active        = false;
+  uint32_t max_rate_kbps = 0;
+  tc_meter mtr;
+};
+
+/// Ingress rate limit of a queue. Above dev_rate_kbps packets go to the dev_id queue, above drop_rate_kbps they are
+/// dropped
+struct tc_policer_t {
+  bool     active         = false;
+  uint32_t drop_rate_kbps = 0;
+  uint32_t dev_id         = 0;
+  uint32_t dev_rate_kbps  = 0;
+  tc_meter mtr;
+};
+
+/// Queue with optional CoDel AQM (RFC 8289). Sojourn times are in microseconds
+class tc_queue
+{
+public:
+  static const uint32_t max_pkts = 1024; ///< Tail drop above this occupancy
+
+  tc_queue(uint32_t id_, tc_queue_e type_, uint32_t target_ms, uint32_t interval_ms);
+
+  void       configure(tc_queue_e type_, uint32_t target_ms, uint32_t interval_ms);
+  uint32_t   get_id() const { return id; }
+  tc_queue_e get_type() const { return type; }
+  bool       empty() const { return pkts.empty(); }
+  uint32_t   size_bytes() const { return nof_bytes; }
+  uint32_t   size_pkts() const { return pkts.size(); }
+
+  uint32_t   get_target_ms() const { return target_us / 1000; }
+  uint32_t   get_interval_ms() const { return interval_us / 1000; }
+
+  /// Tail drop when full. enq_us is the arrival time of the packet
+  bool                         push(srsran::unique_byte_buffer_t sdu, int64_t enq_us);
+  srsran::unique_byte_buffer_t pop(int64_t now_us);
+  /// Remove all packets without AQM, e.g. to move them to another queue
+  std::deque<std::pair<int64_t, srsran::unique_byte_buffer_t> > take_all();
+
+  tc_queue_stats_t stats;
+
+  tc_shaper_t  shp;
+  tc_policer_t plc;
+
+private:
+  struct deq_result_t {
+    srsran::unique_byte_buffer_t sdu;
+    int64_t                      enq_us     = 0;
+    bool                         ok_to_drop = false;
+  };
+  deq_result_t do_dequeue(int64_t now_us);
+  /// Drop, or mark when ECN is enabled and the packet is ECN capable. Returns true if the packet was dropped
+  bool    drop_or_mark(srsran::unique_byte_buffer_t& sdu);
+  int64_t control_law(int64_t t) const;
+
+  uint32_t   id;
+  tc_queue_e type;
+  int64_t    target_us   = 5000;
+  int64_t    interval_us = 100000;
+
+  std::deque<std::pair<int64_t, srsran::unique_byte_buffer_t> > pkts;
+  uint32_t                                                      nof_bytes = 0;
+
+  // CoDel state
+  int64_t  first_above_time = 0;
+  int64_t  drop_next        = 0;
+  uint32_t count            = 0;
+  uint32_t lastcount        = 0;
+  bool     dropping         = false;
+};
+
+/// Set ECN CE in an ECN capable IPv4/IPv6 packet. Returns false if the packet is not ECN capable
+bool tc_mark_ecn_ce(srsran::byte_buffer_t* sdu);
+
+struct tc_osi_filter_t {
+  uint32_t id;
+  int64_t  src_addr; ///< IPv4 address in network byte order, -1 matches all
+  int64_t  dst_addr;
+  int32_t  src_port; ///< -1 matches all
+  int32_t  dst_port;
+  int32_t  protocol;
+  uint32_t dst_queue;
+};
+
+bool tc_osi_filter_match(const tc_osi_filter_t& flt, const srsran::byte_buffer_t* sdu);
+
+/// Configuration shared by the pipelines of all the DRBs
+struct tc_conf_t {
+  struct queue_cfg_t {
+    uint32_t   id;
+    tc_queue_e type;
+    uint32_t   target_ms;
+    uint32_t   interval_ms;
+    // shaper
+    bool     shp_active        = false;
+    uint32_t shp_window_ms     = 100;
+    uint32_t shp_max_rate_kbps = 0;
+    // policer
+    bool     plc_active         = false;
+    uint32_t plc_drop_rate_kbps = 0;
+    uint32_t plc_dev_id         = 0;
+    uint32_t plc_dev_rate_kbps  = 0;
+  };
+
+  tc_cls_e                     cls_type = TC_CLS_RR;
+  std::vector<tc_osi_filter_t> filters;
+  uint32_t                     next_filter_id = 0;
+  std::vector<queue_cfg_t>     queues; ///< Queue 0 always exists
+  uint32_t                     next_queue_id = 1;
+  tc_sch_e                     sch_type      = TC_SCHED_RR;
+  std::vector<uint32_t>        prio; ///< Queue ids in decreasing priority, for TC_SCHED_PRIO
+  tc_pcr_e                     pcr_type = TC_PCR_DUMMY;
+  uint32_t                     pcr_drb_sz = 0; ///< Target RLC occupancy of the 5G-BDP pacer, in bytes
+
+  tc_conf_t();
+  queue_cfg_t*       find_queue(uint32_t queue_id);
+  const queue_cfg_t* find_queue(uint32_t queue_id) const;
+};
+
+/// Queueing discipline of one UE DRB
+class tc_pipeline
+{
+public:
+  explicit tc_pipeline(const tc_conf_t& conf);
+
+  /// Reconcile queues and parameters with a new configuration. Packets of removed queues move to queue 0
+  void apply(const tc_conf_t& conf);
+
+  void     enqueue(srsran::unique_byte_buffer_t sdu, int64_t now_us);
+  /// Next packet according to the scheduler and shapers, or nullptr
+  srsran::unique_byte_buffer_t dequeue(int64_t now_us);
+  /// All the queued packets in queue order, bypassing AQM, shapers and scheduler
+  std::vector<srsran::unique_byte_buffer_t> take_all();
+  bool                                      empty() const;
+
+  std::vector<std::unique_ptr<tc_queue> >& get_queues() { return queues; }
+
+private:
+  tc_queue* find_queue(uint32_t queue_id);
+  tc_queue* classify(const srsran::byte_buffer_t* sdu);
+  bool      eligible(tc_queue& q, int64_t now_us);
+
+  const tc_conf_t*                        conf = nullptr;
+  std::vector<std::unique_ptr<tc_queue> > queues;
+  uint32_t                                cls_rr_idx = 0;
+  uint32_t                                sch_rr_idx = 0;
+};
+
+/// Traffic control stage inserted between the GTP-U/PDCP adapter and PDCP. Pass-through until the first control
+/// message is received
+class tc final : public pdcp_interface_gtpu
+{
+public:
+  explicit tc(srslog::basic_logger& logger);
+  void init(pdcp_interface_gtpu* pdcp_, rlc_interface_tc* rlc_, enb_bearer_manager* bearers_);
+  void stop();
+
+  // pdcp_interface_gtpu
+  void write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu, int pdcp_sn = -1) override;
+  std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) override;
+
+  /// Called every TTI from the stack thread, releases the packets allowed by the pacers and shapers
+  void tti_clock();
+
+  // E2 Agent
+  tc_ctrl_out_e control(const tc_ctrl_msg_t& msg);
+  void          get_stats(tc_ind_msg_t* msg);
+
+private:
+  using pipeline_key_t = std::pair<uint16_t, uint32_t>;
+
+  struct released_sdu_t {
+    uint16_t                     rnti;
+    uint32_t                     lcid;
+    srsran::unique_byte_buffer_t sdu;
+  };
+
+  struct paced_drb_t {
+    uint16_t rnti;
+    uint32_t lcid;
+    uint32_t drb_sz; ///< Target RLC occupancy when the DRB was queued for pacing
+  };
+
+  /// Counters of a queue id, aggregated over the DRBs
+  struct queue_report_t {
+    tc_conf_t::queue_cfg_t cfg;
+    tc_queue_stats_t       stats;
+    uint32_t               bytes    = 0;
+    uint32_t               pkts     = 0;
+    float                  shp_kbps = 0;
+    float                  plc_kbps = 0;
+  };
+
+  /// Moves the packets allowed by the shapers to the released SDUs. Called with the mutex locked
+  void          drain(uint16_t rnti, uint32_t lcid, tc_pipeline& p, int64_t now_us);
+  /// Hands the DRBs limited by the 5G-BDP pacer to PDCP. Called without the mutex
+  void          drain_paced();
+  /// Hands the released SDUs to PDCP. Called without the mutex
+  void          release();
+  void          retire(tc_pipeline& p);
+  tc_ctrl_out_e ctrl_cls(const tc_ctrl_cls_t& cls);
+  tc_ctrl_out_e ctrl_plc(const tc_ctrl_plc_t& plc);
+  tc_ctrl_out_e ctrl_queue(const tc_ctrl_queue_t& q);
+  tc_ctrl_out_e ctrl_sch(const tc_ctrl_sch_t& sch);
+  tc_ctrl_out_e ctrl_shp(const tc_ctrl_shp_t& shp);
+  tc_ctrl_out_e ctrl_pcr(const tc_ctrl_pcr_t& pcr);
+
+  srslog::basic_logger& logger;
+  pdcp_interface_gtpu*  pdcp    = nullptr;
+  rlc_interface_tc*     rlc     = nullptr;
+  enb_bearer_manager*   bearers = nullptr;
+
+  // Written by the E2 agent, read by the stack thread
+  std::mutex                                              mutex;
+  bool                                                    enabled = false;
+  tc_conf_t                                               conf;
+  std::map<pipeline_key_t, std::unique_ptr<tc_pipeline> > pipelines;
+  std::map<uint32_t, tc_queue_stats_t>                    retired_stats; ///< Queues of the removed pipelines
+  tc_meter                                                egress_mtr; ///< Rate released to PDCP by all the pacers
+
+  // Handed to PDCP and RLC once the mutex is released, so that the E2 agent never waits for them. Only used by the
+  // stack thread
+  std::vector<released_sdu_t> released;
+  std::vector<paced_drb_t>    paced;
+
+  // Only used by get_stats(), from the E2 agent
+  std::vector<queue_report_t>  report_queues;
+  std::vector<uint32_t>        report_prio;
+  std::vector<tc_osi_filter_t> report_filters;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_TC_H
@@ -279,6 +279,8 @@ typedef struct {
 typedef struct {
   kpm_ind_hdr_t hdr;
   kpm_ind_msg_t msg;
+  // Not an IE. Per subscription state of the RAN on the agent side, see sm_ag_if_rd.h
+  void* ran_state;
 } kpm_ind_data_t; 
 
 
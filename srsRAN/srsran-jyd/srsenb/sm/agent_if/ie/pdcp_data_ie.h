@@ -43,6 +43,9 @@ extern "C" {
 
 typedef struct {
   uint32_t ms;
+  // 0: every report carries all the bearers. Otherwise, reports are delta
+  // coded against the previous one, with a keyframe every delta_kf reports
+  uint32_t delta_kf;
 } pdcp_event_trigger_t;
 
 void free_pdcp_event_trigger(pdcp_event_trigger_t* src); 
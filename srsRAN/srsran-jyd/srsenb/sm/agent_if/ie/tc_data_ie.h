@@ -763,7 +763,7 @@ bool eq_tc_ctrl_msg(tc_ctrl_msg_t const* m0, tc_ctrl_msg_t const* m1);
 
 typedef enum{
   TC_CTRL_OUT_OK,
-
+  TC_CTRL_OUT_ERROR,
 
   TC_CTRL_OUT_END
 } tc_ctrl_out_e;
@@ -230,6 +230,16 @@ bool enb::get_metrics(enb_metrics_t* m)
   return true;
 }
 
+void enb::set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti)
+{
+  if (phy) {
+    phy->set_metrics_sink(sink, period_tti);
+  }
+  if (eutra_stack) {
+    eutra_stack->set_metrics_sink(sink, period_tti);
+  }
+}
+
 void enb::cmd_cell_gain(uint32_t cell_id, float gain)
 {
   phy->cmd_cell_gain(cell_id, gain);
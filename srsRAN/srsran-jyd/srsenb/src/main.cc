@@ -40,11 +40,14 @@
 #include <boost/program_options/parsers.hpp>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <srsran/common/string_helpers.h>
 #include <string>
 
 #include "srsenb/hdr/enb.h"
 #include "srsenb/hdr/metrics_csv.h"
+#include "srsenb/hdr/metrics_e2.h"
 #include "srsenb/hdr/metrics_json.h"
 #include "srsenb/hdr/metrics_stdout.h"
 #include "srsran/common/enb_events.h"
@@ -611,6 +614,68 @@ int64_t tstamp_now(void)
 static
 enb* enb_instance = nullptr;
 
+// RAN function IDs of the SMs served from the E2 metrics sink, as defined by the flexric MAC, RLC and PDCP SMs
+static const uint16_t e2_mac_ran_func_id  = 142;
+static const uint16_t e2_rlc_ran_func_id  = 143;
+static const uint16_t e2_pdcp_ran_func_id = 144;
+
+static
+std::unique_ptr<metrics_e2> e2_metrics;
+
+// Timer periods, in ms, of the active MAC, RLC and PDCP subscriptions. The layers push metrics to the sink only while
+// one is active, with the shortest period, so that nothing is collected for nobody
+static std::mutex              e2_metrics_mutex;
+static std::multiset<uint32_t> e2_metrics_periods;
+static bool                    e2_metrics_stopped = false;
+
+static
+void e2_subscription(uint16_t ran_func_id, uint32_t ms, bool active)
+{
+  if (ran_func_id != e2_mac_ran_func_id and ran_func_id != e2_rlc_ran_func_id and
+      ran_func_id != e2_pdcp_ran_func_id) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(e2_metrics_mutex);
+  if (active) {
+    e2_metrics_periods.insert(ms);
+  } else {
+    auto it = e2_metrics_periods.find(ms);
+    if (it != e2_metrics_periods.end()) {
+      e2_metrics_periods.erase(it);
+    }
+  }
+  if (e2_metrics_stopped) {
+    return;
+  }
+  // One TTI per ms
+  assert(enb_instance != NULL);
+  if (e2_metrics_periods.empty()) {
+    enb_instance->set_metrics_sink(nullptr, 0);
+  } else {
+    enb_instance->set_metrics_sink(e2_metrics.get(), *e2_metrics_periods.begin());
+  }
+}
+
+// The agent is not stopped with the eNB, so later subscriptions must not install the sink again
+static
+void stop_e2_metrics()
+{
+  std::lock_guard<std::mutex> lock(e2_metrics_mutex);
+  e2_metrics_stopped = true;
+  enb_instance->set_metrics_sink(nullptr, 0);
+}
+
+// Latest E2 metrics snapshot. All the SM reads run on the agent thread, so a single copy suffices
+static
+const e2_metrics_snapshot_t& read_e2_metrics()
+{
+  assert(e2_metrics != nullptr);
+  static e2_metrics_snapshot_t snapshot;
+  e2_metrics->read(snapshot);
+  return snapshot;
+}
+
 template<class T, class Compare>
 const T& std_clamp( const T& v, const T& lo, const T& hi, Compare comp )
 {
@@ -623,48 +688,45 @@ const T& std_clamp( const T& v, const T& lo, const T& hi )
     return std_clamp(v, lo, hi, std::less<T>());
 }
 
+// The SM lends the array of its previous indication as (buf, cap). It is reused, zeroed, when it holds n elements.
+// Otherwise, a new one is allocated and the SM releases the old one, so the steady state does not allocate
+template <class T>
+T* reuse_ind_array(T* buf, uint32_t cap, uint32_t n)
+{
+  if (n <= cap) {
+    if (n > 0) {
+      memset(buf, 0, n * sizeof(T));
+    }
+    return buf;
+  }
+  T* fresh = (T*)calloc(n, sizeof(T));
+  assert(fresh != NULL && "Memory exhausted");
+  return fresh;
+}
+
 static
 void fill_mac_stats(mac_ind_data_t* ind)
 {
   assert(ind != NULL);
-  assert(enb_instance != NULL);
-  // print enb_instance
-  printf("Main: Xapp Calling: ENB Instance: %p\n", enb_instance);
-  ind->msg.tstamp = tstamp_now();
-
-  enb_metrics_t m = {}; 
-  bool const rv = enb_instance->get_metrics(&m);
 
-  // print &m
-  //printf("Main: Xapp Calling: Metrics struct address: %p\n", (void*)&m);
+  const e2_metrics_snapshot_t& snapshot = read_e2_metrics();
+  ind->msg.tstamp = snapshot.tstamp_us;
 
-  //printf("Get metrics returned: %d\n", rv);
-  //printf("PHY metrics array size: %zu\n", m.phy.size());
-  if (!m.phy.empty()) {
-    printf("First PHY metric - DL samples: %d, UL samples: %d\n", 
-           m.phy[1].dl.n_samples, m.phy[1].ul.n_samples);
-           
-  }
-
-  size_t const sz = m.stack.mac.ues.size();
-  size_t const rlc_sz = m.stack.pdcp.ues.size();
-  if (sz != rlc_sz) {
-    fprintf(stderr, "MAC and RLC metrics size mismatch: MAC=%zu, RLC=%zu\n", sz, rlc_sz);
-    return;
+  uint32_t sz = 0;
+  for (const e2_ue_metrics_t& u : snapshot.ues) {
+    sz += u.has_mac ? 1 : 0;
   }
 
+  ind->msg.ue_stats = reuse_ind_array(ind->msg.ue_stats, ind->msg.len_ue_stats, sz);
   ind->msg.len_ue_stats = sz;
 
-  if(sz > 0){
-    ind->msg.ue_stats = (mac_ue_stats_impl_t*)calloc(sz, sizeof(mac_ue_stats_impl_t));
-    assert(ind->msg.ue_stats != NULL && "Memory exhausted");
-  }
-
-  for(size_t i = 0 ; i < sz ; ++i){
-    mac_ue_metrics_t const* src = &m.stack.mac.ues[i];
-    srsran::rlc_bearer_metrics_t const* rlc_src = &m.stack.rlc.ues[i].bearer[3];
-
-    mac_ue_stats_impl_t* dst = &ind->msg.ue_stats[i];
+  size_t i = 0;
+  for (const e2_ue_metrics_t& u : snapshot.ues) {
+    if (not u.has_mac) {
+      continue;
+    }
+    mac_ue_metrics_t const* src = &u.mac;
+    mac_ue_stats_impl_t* dst = &ind->msg.ue_stats[i++];
 
     //Fahad modifications
   
@@ -692,28 +754,22 @@ void fill_mac_stats(mac_ind_data_t* ind)
     dst->dl_aggr_prb = src->allocated_prbs;  // PRB allocation
 
     // Always use PHY metrics for MCS and SNR in 4G/LTE
-    if (i < m.phy.size()) {
-      // Read raw SNR values from PHY metrics
-      float pusch_sinr = m.phy[i].ul.pusch_sinr;
-      float pucch_sinr = m.phy[i].ul.pucch_sinr;
+    if (u.has_phy) {
+      phy_metrics_t const& phy = u.phy;
 
       // Normalize to a display/clamped value. Use -99.9 as sentinel for unavailable or non-finite values
-      float displayed_pusch = std::isfinite(pusch_sinr) ? std_clamp<float>(pusch_sinr, -99.9f, 99.9f)
-                                                         : -99.9f;
-      float displayed_pucch = std::isfinite(pucch_sinr) ? std_clamp<float>(pucch_sinr, -99.9f, 99.9f)
-                                                         : -99.9f;
+      float displayed_pusch = std::isfinite(phy.ul.pusch_sinr) ? std_clamp<float>(phy.ul.pusch_sinr, -99.9f, 99.9f)
+                                                                : -99.9f;
+      float displayed_pucch = std::isfinite(phy.ul.pucch_sinr) ? std_clamp<float>(phy.ul.pucch_sinr, -99.9f, 99.9f)
+                                                                : -99.9f;
 
-      // Print PHY MCS, SNR, and RSSI values so logs match what is sent to listeners/xApps
-      printf("PHY metrics available: UE %zu, DL MCS %f, UL MCS %f, PUSCH_SNR %f, PUCCH_SNR %f, RSSI %f\n",
-             i, m.phy[i].dl.mcs, m.phy[i].ul.mcs, displayed_pusch, displayed_pucch, m.phy[i].ul.rssi);
-
-      dst->dl_mcs1 = (uint8_t)std::max(0, (int)std::lround(m.phy[i].dl.mcs));
-      dst->ul_mcs1 = (uint8_t)std::max(0, (int)std::lround(m.phy[i].ul.mcs));
+      dst->dl_mcs1 = (uint8_t)std::max(0, (int)std::lround(phy.dl.mcs));
+      dst->ul_mcs1 = (uint8_t)std::max(0, (int)std::lround(phy.ul.mcs));
 
       // Store the clamped values in the dst structure (these are what listeners/xApps will see)
       dst->pusch_snr = displayed_pusch;
       dst->pucch_snr = displayed_pucch;
-      dst->ul_rssi = m.phy[i].ul.rssi;
+      dst->ul_rssi = phy.ul.rssi;
 
     } else {
       dst->dl_mcs1 = 0;
@@ -726,15 +782,23 @@ void fill_mac_stats(mac_ind_data_t* ind)
 }
 
 static inline
-uint32_t active_drbs(enb_metrics_t const& m, size_t num_ues)
+bool drb_established(uint32_t bearer_mask, uint32_t lcid)
+{
+  return srsran::is_lte_drb(lcid) and (bearer_mask & (1u << lcid)) != 0;
+}
+
+// Number of established DRBs over all the UEs that the layer reports
+template <class T>
+uint32_t active_drbs(e2_metrics_snapshot_t const& snapshot, bool e2_ue_metrics_t::*has_layer, T e2_ue_metrics_t::*layer)
 {
-  int nb = 0;
-  for(size_t i = 0 ; i <  num_ues ; ++i){
-//    for(size_t j =0; j < SRSRAN_N_RADIO_BEARERS; ++j){
-//      if( m.stack.rlc.ues[i].bearer[j].num_tx_pdus > 0){ // TODO: get number of active drbs
-        nb += 1;
-//      }
-//    }
+  uint32_t nb = 0;
+  for (const e2_ue_metrics_t& u : snapshot.ues) {
+    if (not (u.*has_layer)) {
+      continue;
+    }
+    for (uint32_t lcid = 0; lcid < SRSRAN_N_RADIO_BEARERS; ++lcid) {
+      nb += drb_established((u.*layer).bearer_mask, lcid) ? 1 : 0;
+    }
   }
   return nb;
 }
@@ -744,45 +808,40 @@ void fill_rlc_stats(rlc_ind_data_t* ind)
 {
 
   assert(ind != NULL);
-  assert(enb_instance != NULL);
-  ind->msg.tstamp = tstamp_now();
 
-  enb_metrics_t m;;
-  bool const rv = enb_instance->get_metrics(&m);
+  const e2_metrics_snapshot_t& snapshot = read_e2_metrics();
+  ind->msg.tstamp = snapshot.tstamp_us;
 
-  size_t const num_ues = m.stack.pdcp.ues.size();
-  
-  uint32_t nb = active_drbs(m, num_ues);
+  uint32_t nb = active_drbs(snapshot, &e2_ue_metrics_t::has_rlc, &e2_ue_metrics_t::rlc);
+  ind->msg.rb = reuse_ind_array(ind->msg.rb, ind->msg.len, nb);
   ind->msg.len = nb;
-  if(nb > 0){
-    ind->msg.rb = (rlc_radio_bearer_stats_t*)calloc(nb, sizeof(rlc_radio_bearer_stats_t));
-    assert(ind->msg.rb!= NULL && "Memory exhausted");
-  }
 
-  for(size_t i = 0 ; i <  num_ues ; ++i){
-     uint32_t const rnti = m.stack.mac.ues[i].rnti;
-    for(size_t j = 0; j < SRSRAN_N_RADIO_BEARERS; ++j){
-      //if( m.stack.rlc.ues[i].bearer[j].num_tx_pdus > 0 && nb > 0){ // TODO: check drb is actived
-      if (j == 3) { // temp: force to drb id = 3
-        srsran::rlc_bearer_metrics_t const* src = &m.stack.rlc.ues[i].bearer[j];
-        rlc_radio_bearer_stats_t* dst = &ind->msg.rb[nb - 1];
-
-        dst->txpdu_pkts=src->num_tx_pdus;
-        dst->txpdu_bytes=src->num_tx_pdu_bytes;
-        dst->rxpdu_pkts=src->num_rx_pdus;
-        dst->rxpdu_bytes=src->num_rx_pdu_bytes;
-
-        dst->txsdu_pkts=src->num_tx_sdus;
-        dst->txsdu_bytes=(uint32_t)src->num_tx_sdu_bytes;
-        dst->rxsdu_pkts=src->num_rx_sdus;
-        dst->rxsdu_bytes=(uint32_t)src->num_rx_sdu_bytes;
-        dst->rxpdu_dd_pkts=src->num_lost_pdus;
-        dst->rxsdu_dd_pkts=src->num_lost_sdus;
-
-        dst->rbid = j;
-        dst->rnti = rnti;
-        nb -= 1;
+  uint32_t i = 0;
+  for (const e2_ue_metrics_t& u : snapshot.ues) {
+    if (not u.has_rlc) {
+      continue;
+    }
+    for (uint32_t lcid = 0; lcid < SRSRAN_N_RADIO_BEARERS; ++lcid) {
+      if (not drb_established(u.rlc.bearer_mask, lcid)) {
+        continue;
       }
+      srsran::rlc_bearer_metrics_t const* src = &u.rlc.bearer[lcid];
+      rlc_radio_bearer_stats_t* dst = &ind->msg.rb[i++];
+
+      dst->txpdu_pkts=src->num_tx_pdus;
+      dst->txpdu_bytes=src->num_tx_pdu_bytes;
+      dst->rxpdu_pkts=src->num_rx_pdus;
+      dst->rxpdu_bytes=src->num_rx_pdu_bytes;
+
+      dst->txsdu_pkts=src->num_tx_sdus;
+      dst->txsdu_bytes=(uint32_t)src->num_tx_sdu_bytes;
+      dst->rxsdu_pkts=src->num_rx_sdus;
+      dst->rxsdu_bytes=(uint32_t)src->num_rx_sdu_bytes;
+      dst->rxpdu_dd_pkts=src->num_lost_pdus;
+      dst->rxsdu_dd_pkts=src->num_lost_sdus;
+
+      dst->rbid = lcid;
+      dst->rnti = u.rnti;
     }
   }
 
@@ -792,37 +851,33 @@ static
 void fill_pdcp_stats(pdcp_ind_data_t* ind)
 {
   assert(ind != NULL);
-  assert(enb_instance != NULL);
-  ind->msg.tstamp = tstamp_now();
 
-  enb_metrics_t m;
-  bool const rv = enb_instance->get_metrics(&m);
+  const e2_metrics_snapshot_t& snapshot = read_e2_metrics();
+  ind->msg.tstamp = snapshot.tstamp_us;
 
-  size_t const num_ues = m.stack.pdcp.ues.size();
-  uint32_t nb = active_drbs(m, num_ues);
+  uint32_t nb = active_drbs(snapshot, &e2_ue_metrics_t::has_pdcp, &e2_ue_metrics_t::pdcp);
 
+  ind->msg.rb = reuse_ind_array(ind->msg.rb, ind->msg.len, nb);
   ind->msg.len = nb;
-  if(nb > 0){ 
-    ind->msg.rb = (pdcp_radio_bearer_stats_t*)calloc(nb, sizeof(pdcp_radio_bearer_stats_t));
-    assert(ind->msg.rb!= NULL && "Memory exhausted");
-  }
 
-  for(size_t i = 0 ; i < num_ues ; ++i){
-    uint32_t const rnti = m.stack.mac.ues[i].rnti;
-    for(size_t j =0; j < SRSRAN_N_RADIO_BEARERS; ++j){
-      //if(m.stack.pdcp.ues[i].bearer[j].num_tx_pdus > 0 && nb > 0){ // TODO: check drb is actived
-      if (j == 3) { // temp: force to drb id = 3
-        srsran::pdcp_bearer_metrics_t const* src = &m.stack.pdcp.ues[i].bearer[j];
-        pdcp_radio_bearer_stats_t* dst = &ind->msg.rb[nb - 1];
-
-        dst->txpdu_pkts=src->num_tx_pdus; 
-        dst->txpdu_bytes=src->num_tx_pdu_bytes;
-        dst->rxpdu_pkts=src->num_rx_pdus; 
-        dst->rxpdu_bytes=src->num_rx_pdu_bytes;
-        dst->rbid = j;
-        dst->rnti = rnti;
-        nb -= 1;
+  uint32_t i = 0;
+  for (const e2_ue_metrics_t& u : snapshot.ues) {
+    if (not u.has_pdcp) {
+      continue;
+    }
+    for (uint32_t lcid = 0; lcid < SRSRAN_N_RADIO_BEARERS; ++lcid) {
+      if (not drb_established(u.pdcp.bearer_mask, lcid)) {
+        continue;
       }
+      srsran::pdcp_bearer_metrics_t const* src = &u.pdcp.bearer[lcid];
+      pdcp_radio_bearer_stats_t* dst = &ind->msg.rb[i++];
+
+      dst->txpdu_pkts=src->num_tx_pdus; 
+      dst->txpdu_bytes=src->num_tx_pdu_bytes;
+      dst->rxpdu_pkts=src->num_rx_pdus; 
+      dst->rxpdu_bytes=src->num_rx_pdu_bytes;
+      dst->rbid = lcid;
+      dst->rnti = u.rnti;
     }
   }
 
@@ -832,93 +887,47 @@ static
 void read_slice_conf(slice_conf_t* conf) {
   srsran_assert(conf != NULL, "conf == NULL");
 
-  /// read_slice_conf DL ///
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  ul_dl_slice_conf_t* rd_dl = &conf->dl;
-
-  // get sched algo
-  rd_dl->len_sched_name = stats_dl->len_sched_name;
-  rd_dl->sched_name = (char*)malloc(rd_dl->len_sched_name);
-  srsran_assert(rd_dl->sched_name != NULL, "memory exhausted");
-  memcpy(rd_dl->sched_name, stats_dl->sched_name, rd_dl->len_sched_name);
-
-
-  // get num of slice
-  rd_dl->len_slices = stats_dl->len_slices;
-
-  if (rd_dl->len_slices > 0) {
-    // get slice algo
-    slice_algorithm_e algo = stats_dl->slices[0].params.type;
-
-    // allocate memory to read multi slices
-    rd_dl->slices = (fr_slice_t*)calloc(rd_dl->len_slices, sizeof(fr_slice_t));
-    srsran_assert(rd_dl->slices != NULL, "memory exhausted");
-
-    // Get each slice config: id, label, sched algo, slice algo data
-    for (uint32_t i = 0; i < rd_dl->len_slices; ++i) {
-      fr_slice_t* rd_slice = &rd_dl->slices[i];
-      fr_slice_t* st_slice = &stats_dl->slices[i];
-
-      // get id
-      rd_dl->slices[i].id = st_slice->id;
-
-      // get label
-      rd_slice->len_label = st_slice->len_label;
-      rd_slice->label     = (char*)malloc(rd_slice->len_label);
-      srsran_assert(rd_slice->label != NULL, "memory exhausted");
-      memcpy(rd_slice->label, st_slice->label, rd_slice->len_label);
-
-      // get sched algo
-      rd_slice->len_sched = st_slice->len_sched;
-      rd_slice->sched     = (char*)malloc(rd_slice->len_sched);
-      srsran_assert(rd_slice->sched != NULL, "memory exhausted");
-      memcpy(rd_slice->sched, st_slice->sched, rd_slice->len_sched);
-
-      // get slice algo data
-      if (algo == SLICE_ALG_SM_V0_STATIC) {
-        rd_slice->params.type = st_slice->params.type;
-        static_slice_t* sta   = &rd_slice->params.u.sta;
-        sta->pos_high         = st_slice->params.u.sta.pos_high;
-        sta->pos_low          = st_slice->params.u.sta.pos_low;
-      } else {
-        srsran_assert(0 != 0, "Unknow type of DL algo\n");
-      }
-    }
+  /// read_slice_conf DL and UL. UL is left empty if it is not sliced ///
+  assert(enb_instance != NULL);
+  enb_stack_base& stack_base = enb_instance->get_eutra_stack();
+  try {
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    stack.get_slice_conf(conf);
+  } catch (std::bad_cast const& e) {
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
   }
-
-  /// TODO: read_slice_conf UL ///
-  ul_dl_slice_conf_t* rd_ul = &conf->ul;
-  char const* ul_algo_name = "round_round_ul";
-  rd_ul->len_sched_name = strlen(ul_algo_name);
-  rd_ul->sched_name = (char*)malloc(rd_ul->len_sched_name);
-  srsran_assert(rd_ul->sched_name != NULL, "memory exhausted");
-  memcpy(rd_ul->sched_name, ul_algo_name, rd_ul->len_sched_name);
-
 }
 
 static
 void read_ue_slice_conf(ue_slice_conf_t* rd_ue) {
   srsran_assert(rd_ue != NULL, "conf == NULL");
 
-  enb_metrics_t m;
-  bool const rv = enb_instance->get_metrics(&m);
-
-  /// read_ue_slice_conf DL ///
-  Slicing &slice_stats = Slicing::getInstance();
-  ue_slice_conf_t* stats_ue_s = &slice_stats.stats_ue_slice_conf;
-  rd_ue->len_ue_slice = stats_ue_s->len_ue_slice;
-
-  if(rd_ue->len_ue_slice > 0){
-    rd_ue->ues = (ue_slice_assoc_t*)calloc(stats_ue_s->len_ue_slice, sizeof(ue_slice_assoc_t));
-    srsran_assert(rd_ue->ues != NULL, "Memory exhausted");
+  /// read_ue_slice_conf DL and UL ///
+  assert(enb_instance != NULL);
+  enb_stack_base& stack_base = enb_instance->get_eutra_stack();
+  try {
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    stack.get_ue_slice_conf(rd_ue);
+  } catch (std::bad_cast const& e) {
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
   }
+}
 
-  for (uint32_t i = 0; i < rd_ue->len_ue_slice; i++) {
-    rd_ue->ues[i].rnti = stats_ue_s->ues[i].rnti;
-    rd_ue->ues[i].dl_id = stats_ue_s->ues[i].dl_id;
+static
+void read_slice_counters(slice_ind_msg_t* ind) {
+  srsran_assert(ind != NULL, "ind == NULL");
+
+  assert(enb_instance != NULL);
+  enb_stack_base& stack_base = enb_instance->get_eutra_stack();
+  try {
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    stack.get_slice_stats(ind);
+  } catch (std::bad_cast const& e) {
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
   }
-  /// TODO: read_ue_slice_conf UL ///
 }
 
 static
@@ -929,6 +938,137 @@ void fill_slice_stats(slice_ind_data_t* ind)
 
   read_slice_conf(&ind->msg.slice_conf);
   read_ue_slice_conf(&ind->msg.ue_slice_conf);
+  read_slice_counters(&ind->msg);
+}
+
+static
+void read_kpm_counters(srsenb::kpm_counters_t* c)
+{
+  assert(enb_instance != NULL);
+  enb_stack_base& stack_base = enb_instance->get_eutra_stack();
+  try {
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    stack.get_kpm_counters(c);
+  } catch (std::bad_cast const& e) {
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
+  }
+}
+
+static
+adapter_MeasRecord_t kpm_int_record(uint64_t num, uint64_t den)
+{
+  adapter_MeasRecord_t rec = {};
+  if (den == 0) {
+    rec.type = adapter_MeasRecord_t::MeasRecord_noval;
+  } else {
+    rec.type    = adapter_MeasRecord_t::MeasRecord_int;
+    rec.int_val = (num + den / 2) / den;
+  }
+  return rec;
+}
+
+static
+MeasInfo_t kpm_meas_info(const char* name)
+{
+  MeasInfo_t info = {};
+  info.meas_type  = KPM_V2_MEASUREMENT_TYPE_NAME;
+  info.measName.len = strlen(name);
+  info.measName.buf = (uint8_t*)malloc(info.measName.len);
+  srsran_assert(info.measName.buf != NULL, "memory exhausted");
+  memcpy(info.measName.buf, name, info.measName.len);
+
+  // The label list is mandatory, and the measurements are not split in subcounters
+  info.labelInfo_len = 1;
+  info.labelInfo     = (adapter_LabelInfoItem_t*)calloc(1, sizeof(adapter_LabelInfoItem_t));
+  srsran_assert(info.labelInfo != NULL, "memory exhausted");
+  info.labelInfo[0].noLabel = (long*)malloc(sizeof(long));
+  srsran_assert(info.labelInfo[0].noLabel != NULL, "memory exhausted");
+  *info.labelInfo[0].noLabel = 0; // true
+  return info;
+}
+
+// E2SM-KPM v2.02 format 1 report. All arrays are freed by the SM after encoding. The report covers the interval since
+// the previous read of the subscription, i.e. its timer period, as the read interface does not carry the granularity
+// period of the action
+static
+void fill_kpm_stats(kpm_ind_data_t* ind)
+{
+  srsran_assert(ind != NULL, "ind == NULL");
+
+  srsenb::kpm_counters_t cur = {};
+  read_kpm_counters(&cur);
+
+  // The previous sample is kept per subscription. The first read only takes the baseline, reported without values
+  // and flagged as incomplete
+  srsenb::kpm_counters_t* last = static_cast<srsenb::kpm_counters_t*>(ind->ran_state);
+  if (last == nullptr) {
+    void* buf = malloc(sizeof(srsenb::kpm_counters_t));
+    srsran_assert(buf != NULL, "memory exhausted");
+    last           = new (buf) srsenb::kpm_counters_t(cur);
+    ind->ran_state = last;
+  }
+  static_assert(std::is_trivially_destructible<srsenb::kpm_counters_t>::value, "freed by the SM");
+  const srsenb::kpm_counters_t prev = *last;
+  *last                             = cur;
+
+  const uint64_t window_us = cur.tstamp_us - prev.tstamp_us;
+  const uint64_t nof_ttis  = cur.nof_ttis - prev.nof_ttis;
+
+  ind->hdr                  = {};
+  ind->hdr.collectStartTime = (tstamp_now() - (int64_t)window_us) / 1000000;
+
+  // DRB.UEThpDl/Ul in kbps: bits per TTI with data scheduled for the UE. RRU.PrbUsedDl/Ul: mean PRBs per TTI.
+  // DRB.RlcSduDelayDl in units of 0.1 ms. RRC.ConnMean: time average of the RRC UE contexts
+  const char* names[] = {"DRB.UEThpDl", "DRB.UEThpUl", "RRU.PrbUsedDl", "RRU.PrbUsedUl", "DRB.RlcSduDelayDl",
+                         "RRC.ConnMean"};
+  const size_t nof_meas = sizeof(names) / sizeof(names[0]);
+
+  adapter_MeasDataItem_t* data = (adapter_MeasDataItem_t*)calloc(1, sizeof(adapter_MeasDataItem_t));
+  srsran_assert(data != NULL, "memory exhausted");
+  data->measRecord_len = nof_meas;
+  data->measRecord     = (adapter_MeasRecord_t*)calloc(nof_meas, sizeof(adapter_MeasRecord_t));
+  srsran_assert(data->measRecord != NULL, "memory exhausted");
+  data->measRecord[0] = kpm_int_record((cur.dl_bytes - prev.dl_bytes) * 8, cur.dl_ue_ttis - prev.dl_ue_ttis);
+  data->measRecord[1] = kpm_int_record((cur.ul_bytes - prev.ul_bytes) * 8, cur.ul_ue_ttis - prev.ul_ue_ttis);
+  data->measRecord[2] = kpm_int_record(cur.dl_prbs - prev.dl_prbs, nof_ttis);
+  data->measRecord[3] = kpm_int_record(cur.ul_prbs - prev.ul_prbs, nof_ttis);
+  data->measRecord[4] = kpm_int_record(cur.rlc_dl_sdu_delay_us - prev.rlc_dl_sdu_delay_us,
+                                       (cur.rlc_dl_sdus - prev.rlc_dl_sdus) * 100);
+  data->measRecord[5] = kpm_int_record(cur.rrc_conn_ue_us - prev.rrc_conn_ue_us, window_us);
+  // No TTI was scheduled in the window, e.g. the cell is not up yet or this is the baseline
+  data->incompleteFlag = nof_ttis == 0 ? 0 : -1;
+
+  ind->msg              = {};
+  ind->msg.MeasData_len = 1;
+  ind->msg.MeasData     = data;
+  ind->msg.MeasInfo_len = nof_meas;
+  ind->msg.MeasInfo     = (MeasInfo_t*)calloc(nof_meas, sizeof(MeasInfo_t));
+  srsran_assert(ind->msg.MeasInfo != NULL, "memory exhausted");
+  for (size_t i = 0; i < nof_meas; ++i) {
+    ind->msg.MeasInfo[i] = kpm_meas_info(names[i]);
+  }
+  ind->msg.granulPeriod = (unsigned long*)malloc(sizeof(unsigned long));
+  srsran_assert(ind->msg.granulPeriod != NULL, "memory exhausted");
+  *ind->msg.granulPeriod = (window_us + 500) / 1000;
+}
+
+static
+void fill_tc_stats(tc_ind_data_t* ind)
+{
+  srsran_assert(ind != NULL, "ind == NULL");
+
+  assert(enb_instance != NULL);
+  enb_stack_base& stack_base = enb_instance->get_eutra_stack();
+  ind->msg        = {};
+  ind->msg.tstamp = tstamp_now();
+  try {
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    stack.get_tc_stats(&ind->msg);
+  } catch (std::bad_cast const& e) {
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
+  }
 }
 
 static
@@ -944,6 +1084,10 @@ void read_RAN(sm_ag_if_rd_t* data)
     fill_pdcp_stats(&data->pdcp_stats);
   } else if(data->type == SLICE_STATS_V0){
     fill_slice_stats(&data->slice_stats);
+  } else if(data->type == KPM_STATS_V0){
+    fill_kpm_stats(&data->kpm_stats);
+  } else if(data->type == TC_STATS_V0){
+    fill_tc_stats(&data->tc_stats);
   } else {
     assert(0!=0 && "Unknown data type");
   }
@@ -974,6 +1118,30 @@ sm_ag_if_ans_t write_slice(slice_ctrl_req_data_t const& s)
   return ans;
 }
 
+static
+sm_ag_if_ans_t write_tc(tc_ctrl_req_data_t const& tc)
+{
+  assert(enb_instance != NULL);
+
+  enb_stack_base& stack_base =  enb_instance->get_eutra_stack();
+  sm_ag_if_ans_t ans = {};
+  ans.type = TC_AGENT_IF_CTRL_ANS_V0;
+  try{
+    enb_stack_lte& stack = dynamic_cast<enb_stack_lte&>(stack_base);
+    ans.tc.out = stack.tc_control(tc.msg);
+    if (ans.tc.out != TC_CTRL_OUT_OK)
+      printf("ans.tc.out == TC_CTRL_OUT_ERROR\n");
+  } catch(std::bad_cast const& e){
+    std::cout << "Exception thrown while casting\n";
+    exit(-1);
+  } catch (...){
+    std::cout << "Unknown exception thrown\n";
+    exit(-1);
+  }
+
+  return ans;
+}
+
 
 
 static
@@ -986,6 +1154,8 @@ sm_ag_if_ans_t write_RAN(sm_ag_if_wr_t const* data)
   ans.type = SM_AGENT_IF_ANS_V0_END;
   if(data->type == SLICE_CTRL_REQ_V0 ){
    ans = write_slice(data->slice_req_ctrl); 
+  } else if(data->type == TC_CTRL_REQ_V0){
+   ans = write_tc(data->tc_req_ctrl);
   } else {
     assert(0!=0 && "unknown data type");
   }
@@ -1101,6 +1271,7 @@ int main(int argc, char* argv[])
   // print enb_instance
   //printf("ENB Instance Address: %p\n", enb_instance);
   assert(enb_instance != NULL);
+  e2_metrics.reset(new metrics_e2());
 
   std::string mcc_str, mnc_str;
   srsran::mcc_to_string(args.stack.s1ap.mcc, &mcc_str);
@@ -1110,7 +1281,7 @@ int main(int argc, char* argv[])
   int const enb_id = args.enb.enb_id;
 
   const int mnc_digit_len = 2; 
-  sm_io_ag_t io = {.read = read_RAN, .write = write_RAN};
+  sm_io_ag_t io = {.read = read_RAN, .write = write_RAN, .subscription = e2_subscription};
 
   cout << "[E2 NODE]: mcc = " << mcc
        << " mnc = " << mnc
@@ -1165,6 +1336,7 @@ int main(int argc, char* argv[])
   }
   input.join();
   metricshub.stop();
+  stop_e2_metrics();
   enb->stop();
   cout << "---  exiting  ---" << endl;
 
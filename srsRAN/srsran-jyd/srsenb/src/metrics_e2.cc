@@ -0,0 +1,230 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/metrics_e2.h"
+#include "srsran/phy/utils/vector.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <type_traits>
+
+namespace srsenb {
+
+namespace {
+
+using e2_ue_list_t = srsran::bounded_vector<e2_ue_metrics_t, SRSENB_MAX_UES>;
+
+/// Returns nullptr if the RNTI is unknown and the list is full.
+e2_ue_metrics_t* find_or_add_ue(e2_ue_list_t& ues, uint16_t rnti)
+{
+  auto it = std::lower_bound(
+      ues.begin(), ues.end(), rnti, [](const e2_ue_metrics_t& u, uint16_t r) { return u.rnti < r; });
+  if (it != ues.end() and it->rnti == rnti) {
+    return &(*it);
+  }
+  if (ues.full()) {
+    return nullptr;
+  }
+  // bounded_vector has no insert. Append and rotate into the sorted position
+  size_t pos = it - ues.begin();
+  ues.push_back(e2_ue_metrics_t{});
+  ues.back().rnti = rnti;
+  std::rotate(ues.begin() + pos, ues.end() - 1, ues.end());
+  return &ues[pos];
+}
+
+/// Merges the running averages of two PHY workers, weighted by their number of samples like phy::get_metrics().
+void merge_phy_metrics(phy_metrics_t& dst, const phy_metrics_t& src)
+{
+  if (src.dl.n_samples > 0) {
+    dst.dl.mcs = SRSRAN_VEC_PMA(dst.dl.mcs, dst.dl.n_samples, src.dl.mcs, src.dl.n_samples);
+    dst.dl.n_samples += src.dl.n_samples;
+  }
+  if (src.ul.n_samples > 0) {
+    dst.ul.n           = SRSRAN_VEC_PMA(dst.ul.n, dst.ul.n_samples, src.ul.n, src.ul.n_samples);
+    dst.ul.pusch_sinr  = SRSRAN_VEC_PMA(dst.ul.pusch_sinr, dst.ul.n_samples, src.ul.pusch_sinr, src.ul.n_samples);
+    dst.ul.mcs         = SRSRAN_VEC_PMA(dst.ul.mcs, dst.ul.n_samples, src.ul.mcs, src.ul.n_samples);
+    dst.ul.rssi        = SRSRAN_VEC_PMA(dst.ul.rssi, dst.ul.n_samples, src.ul.rssi, src.ul.n_samples);
+    dst.ul.turbo_iters = SRSRAN_VEC_PMA(dst.ul.turbo_iters, dst.ul.n_samples, src.ul.turbo_iters, src.ul.n_samples);
+    dst.ul.n_samples += src.ul.n_samples;
+  }
+  if (src.ul.n_samples_pucch > 0) {
+    dst.ul.pucch_sinr =
+        SRSRAN_VEC_PMA(dst.ul.pucch_sinr, dst.ul.n_samples_pucch, src.ul.pucch_sinr, src.ul.n_samples_pucch);
+    dst.ul.n_samples_pucch += src.ul.n_samples_pucch;
+  }
+}
+
+/// Copies a trivially copyable object into consecutive words of a ring slot.
+template <typename T>
+void store_words(std::atomic<uint64_t>* dst, const T& src)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Copied as raw words");
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&src);
+  for (size_t i = 0; i * 8 < sizeof(T); ++i) {
+    uint64_t w = 0;
+    memcpy(&w, bytes + i * 8, std::min<size_t>(8, sizeof(T) - i * 8));
+    dst[i].store(w, std::memory_order_relaxed);
+  }
+}
+
+/// Inverse of store_words().
+template <typename T>
+void load_words(T& dst, const std::atomic<uint64_t>* src)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Copied as raw words");
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(&dst);
+  for (size_t i = 0; i * 8 < sizeof(T); ++i) {
+    uint64_t w = src[i].load(std::memory_order_relaxed);
+    memcpy(bytes + i * 8, &w, std::min<size_t>(8, sizeof(T) - i * 8));
+  }
+}
+
+} // namespace
+
+const e2_ue_metrics_t* e2_metrics_snapshot_t::find(uint16_t rnti) const
+{
+  auto it = std::lower_bound(
+      ues.begin(), ues.end(), rnti, [](const e2_ue_metrics_t& u, uint16_t r) { return u.rnti < r; });
+  return (it != ues.end() and it->rnti == rnti) ? &(*it) : nullptr;
+}
+
+template <typename T>
+void metrics_e2::seqlock_ring<T>::publish(const ring_hdr_t& hdr, const list_t& items)
+{
+  // Overwrite the oldest slot. Readers that copy it meanwhile see an odd or changed sequence number and retry
+  uint32_t next = (latest.load(std::memory_order_relaxed) + 1) % nof_slots;
+  slot_t&  slot = slots[next];
+  slot.seq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  store_words(slot.hdr.data(), hdr);
+  slot.nof_items.store(items.size(), std::memory_order_relaxed);
+  for (size_t i = 0; i < items.size(); ++i) {
+    store_words(&slot.items[i * item_words], items[i]);
+  }
+  slot.seq.fetch_add(1, std::memory_order_release);
+  latest.store(next, std::memory_order_release);
+}
+
+template <typename T>
+void metrics_e2::seqlock_ring<T>::read(ring_hdr_t& hdr, list_t& items) const
+{
+  T item;
+  while (true) {
+    const slot_t& slot = slots[latest.load(std::memory_order_acquire)];
+    uint32_t      seq  = slot.seq.load(std::memory_order_acquire);
+    if (seq % 2 != 0) {
+      // The writer lapped the ring and is rewriting the latest slot
+      continue;
+    }
+    load_words(hdr, slot.hdr.data());
+    uint32_t n = std::min<uint32_t>(slot.nof_items.load(std::memory_order_relaxed), SRSENB_MAX_UES);
+    items.clear();
+    for (uint32_t i = 0; i < n; ++i) {
+      load_words(item, &slot.items[i * item_words]);
+      items.push_back(item);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == seq) {
+      return;
+    }
+  }
+}
+
+void metrics_e2::push_stack_metrics(const stack_metrics_t& m)
+{
+  uint64_t version = ++nof_stack_pushes;
+  int64_t  now_us  = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+
+  e2_ue_list_t& ues = stack_scratch;
+  ues.clear();
+  for (const mac_ue_metrics_t& mac : m.mac.ues) {
+    e2_ue_metrics_t* u = find_or_add_ue(ues, mac.rnti);
+    if (u != nullptr) {
+      u->mac     = mac;
+      u->has_mac = true;
+    }
+  }
+  for (const srsran::rlc_metrics_t& rlc : m.rlc.ues) {
+    e2_ue_metrics_t* u = find_or_add_ue(ues, rlc.rnti);
+    if (u != nullptr) {
+      u->rlc     = rlc;
+      u->has_rlc = true;
+    }
+  }
+  for (const srsran::pdcp_metrics_t& pdcp : m.pdcp.ues) {
+    e2_ue_metrics_t* u = find_or_add_ue(ues, pdcp.rnti);
+    if (u != nullptr) {
+      u->pdcp     = pdcp;
+      u->has_pdcp = true;
+    }
+  }
+
+  ring_hdr_t hdr;
+  hdr.version   = version;
+  hdr.tstamp_us = now_us;
+  stack_ring.publish(hdr, ues);
+}
+
+void metrics_e2::push_phy_metrics(uint32_t worker_idx, const std::vector<phy_metrics_t>& m)
+{
+  if (worker_idx >= max_phy_workers) {
+    return;
+  }
+  phy_list_t& phy = phy_scratch[worker_idx];
+  phy.clear();
+  for (const phy_metrics_t& ue : m) {
+    if (phy.full()) {
+      break;
+    }
+    phy.push_back(ue);
+  }
+  phy_rings[worker_idx].publish(ring_hdr_t{}, phy);
+}
+
+void metrics_e2::read(e2_metrics_snapshot_t& dst) const
+{
+  ring_hdr_t hdr;
+  stack_ring.read(hdr, dst.ues);
+  dst.version   = hdr.version;
+  dst.tstamp_us = hdr.tstamp_us;
+
+  phy_list_t phy;
+  for (const seqlock_ring<phy_metrics_t>& ring : phy_rings) {
+    ring.read(hdr, phy);
+    for (const phy_metrics_t& m : phy) {
+      e2_ue_metrics_t* u = find_or_add_ue(dst.ues, m.rnti);
+      if (u == nullptr) {
+        continue;
+      }
+      if (not u->has_phy) {
+        u->phy     = m;
+        u->has_phy = true;
+      } else {
+        merge_phy_metrics(u->phy, m);
+      }
+    }
+  }
+}
+
+} // namespace srsenb
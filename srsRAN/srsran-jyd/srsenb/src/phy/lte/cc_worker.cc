@@ -651,7 +651,8 @@ void cc_worker::ue::metrics_read(phy_metrics_t* metrics_)
 {
   if (metrics_) {
     // Save the metrics to the output parameter
-    *metrics_ = metrics;
+    *metrics_      = metrics;
+    metrics_->rnti = rnti;
   }
   
   // Do NOT reset metrics anymore since we want to maintain the running averages
@@ -247,6 +247,19 @@ void sf_worker::work_imp()
   Debug("Sending to radio");
   phy->worker_end(context, true, tx_buffer);
 
+  // Every worker pushes period TTIs after its previous push, and right away to a newly set sink
+  enb_metrics_sink_interface* sink = phy->metrics_sink.load(std::memory_order_acquire);
+  if (sink == nullptr) {
+    sink_last = nullptr;
+  } else if (sink != sink_last or
+             TTI_SUB(tti_tx_dl, sink_last_tti) >= phy->metrics_sink_period.load(std::memory_order_relaxed)) {
+    sink_last     = sink;
+    sink_last_tti = tti_tx_dl;
+    sink_metrics.clear();
+    merge_cc_metrics(sink_metrics, sink_cc_metrics);
+    sink->push_phy_metrics(get_id(), sink_metrics);
+  }
+
 #ifdef DEBUG_WRITE_FILE
   fwrite(signal_buffer_tx, SRSRAN_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(cf_t), 1, f);
 #endif
@@ -269,14 +282,20 @@ void sf_worker::work_imp()
 /************ METRICS interface ********************/
 uint32_t sf_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
 {
-  uint32_t                   cnt = 0;
   std::vector<phy_metrics_t> metrics_;
+  return merge_cc_metrics(metrics, metrics_);
+}
+
+uint32_t sf_worker::merge_cc_metrics(std::vector<phy_metrics_t>& metrics, std::vector<phy_metrics_t>& metrics_)
+{
+  uint32_t cnt = 0;
   for (uint32_t cc = 0; cc < phy->get_nof_carriers_lte(); cc++) {
     cnt = cc_workers[cc]->get_metrics(metrics_);
     metrics.resize(std::max(metrics_.size(), metrics.size()));
     for (uint32_t r = 0; r < cnt; r++) {
       phy_metrics_t* m  = &metrics[r];
       phy_metrics_t* m_ = &metrics_[r];
+      m->rnti           = m_->rnti;
       m->dl.mcs         = SRSRAN_VEC_PMA(m->dl.mcs, m->dl.n_samples, m_->dl.mcs, m_->dl.n_samples);
       m->dl.n_samples += m_->dl.n_samples;
       m->ul.n          = SRSRAN_VEC_PMA(m->ul.n, m->ul.n_samples, m_->ul.n, m_->ul.n_samples);
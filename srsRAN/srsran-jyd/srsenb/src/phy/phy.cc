@@ -244,6 +244,12 @@ void phy::set_activation_deactivation_scell(uint16_t rnti, const std::array<bool
   }
 }
 
+void phy::set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti)
+{
+  workers_common.metrics_sink_period.store(std::max(period_tti, 1u), std::memory_order_relaxed);
+  workers_common.metrics_sink.store(sink, std::memory_order_release);
+}
+
 void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
 {
   //printf("phy::get_metrics called\n");  
@@ -258,6 +264,8 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       //       i, metrics_tmp[j].dl.n_samples, metrics_tmp[j].dl.mcs,
       //       metrics_tmp[j].ul.n_samples, metrics_tmp[j].ul.mcs);
 
+      metrics[j].rnti = metrics_tmp[j].rnti;
+
       uint32_t prev_dl_samples = metrics[j].dl.n_samples;
       uint32_t prev_ul_samples = metrics[j].ul.n_samples;
       uint32_t prev_ul_pucch_samples = metrics[j].ul.n_samples_pucch;
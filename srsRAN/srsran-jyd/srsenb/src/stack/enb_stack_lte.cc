@@ -35,7 +35,7 @@ class gtpu_pdcp_adapter final : public gtpu_interface_pdcp, public pdcp_interfac
 {
 public:
   gtpu_pdcp_adapter(srslog::basic_logger& logger_,
-                    pdcp*                 pdcp_lte,
+                    pdcp_interface_gtpu*  pdcp_lte,
                     pdcp_interface_gtpu*  pdcp_x2,
                     gtpu*                 gtpu_,
                     enb_bearer_manager&   bearers_) :
@@ -80,7 +80,7 @@ public:
 private:
   srslog::basic_logger& logger;
   gtpu*                 gtpu_obj    = nullptr;
-  pdcp*                 pdcp_obj    = nullptr;
+  pdcp_interface_gtpu*  pdcp_obj    = nullptr;
   pdcp_interface_gtpu*  pdcp_x2_obj = nullptr;
   enb_bearer_manager*   bearers     = nullptr;
 };
@@ -96,6 +96,7 @@ enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   stack_logger(srslog::fetch_basic_logger("STCK", log_sink, false)),
   task_sched(512, 128),
   pdcp(&task_sched, pdcp_logger),
+  tc(pdcp_logger),
   mac(&task_sched, mac_logger),
   rlc(rlc_logger),
   gtpu(&task_sched, gtpu_logger, &rx_sockets),
@@ -179,7 +180,8 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   }
 
   // setup bearer managers
-  gtpu_adapter.reset(new gtpu_pdcp_adapter(stack_logger, &pdcp, x2_, &gtpu, bearers));
+  // LTE user plane SDUs go through the traffic control stage before PDCP
+  gtpu_adapter.reset(new gtpu_pdcp_adapter(stack_logger, &tc, x2_, &gtpu, bearers));
 
   // Init all LTE layers
   if (!mac.init(args.mac, rrc_cfg.cell_list, phy, &rlc, &rrc)) {
@@ -188,6 +190,7 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   }
   rlc.init(&pdcp, &rrc, &mac, task_sched.get_timer_handler());
   pdcp.init(&rlc, &rrc, gtpu_adapter.get());
+  tc.init(&pdcp, &rlc, &bearers);
   if (rrc.init(rrc_cfg, phy, &mac, &rlc, &pdcp, &s1ap, &gtpu, x2_) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize RRC");
     return SRSRAN_ERROR;
@@ -226,6 +229,35 @@ void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
   rrc.tti_clock();
+  tc.tti_clock();
+
+  // Nothing is collected without a sink. A newly set sink gets the metrics right away
+  enb_metrics_sink_interface* sink = metrics_sink.load(std::memory_order_acquire);
+  if (sink == nullptr) {
+    metrics_sink_last = nullptr;
+  } else if (sink != metrics_sink_last or
+             ++metrics_sink_tti >= metrics_sink_period.load(std::memory_order_relaxed)) {
+    metrics_sink_last = sink;
+    metrics_sink_tti  = 0;
+    push_sink_metrics(sink);
+  }
+}
+
+void enb_stack_lte::push_sink_metrics(enb_metrics_sink_interface* sink)
+{
+  // Already on the stack thread, so the layers are read in place. None of the reads restarts the averaging or counter
+  // windows that get_metrics() serves to the other metrics consumers
+  sink_metrics.mac.ues.clear();
+  mac.get_metrics(sink_metrics.mac, false);
+  rlc.get_cumulative_metrics(sink_metrics.rlc);
+  pdcp.get_cumulative_metrics(sink_metrics.pdcp);
+  sink->push_stack_metrics(sink_metrics);
+}
+
+void enb_stack_lte::set_metrics_sink(enb_metrics_sink_interface* sink, uint32_t period_tti)
+{
+  metrics_sink_period.store(std::max(period_tti, 1u), std::memory_order_relaxed);
+  metrics_sink.store(sink, std::memory_order_release);
 }
 
 void enb_stack_lte::stop()
@@ -244,6 +276,7 @@ void enb_stack_lte::stop_impl()
   gtpu.stop();
   mac.stop();
   rlc.stop();
+  tc.stop();
   pdcp.stop();
   rrc.stop();
 
@@ -315,4 +348,38 @@ slice_ctrl_out_e enb_stack_lte::slice(slice_ctrl_req_data_t const& s)
   return mac.slice(s);
 }
 
+void enb_stack_lte::get_slice_conf(slice_conf_t* conf)
+{
+  mac.get_slice_conf(conf);
+}
+
+void enb_stack_lte::get_slice_stats(slice_ind_msg_t* ind)
+{
+  mac.get_slice_stats(ind);
+}
+
+void enb_stack_lte::get_ue_slice_conf(ue_slice_conf_t* conf)
+{
+  mac.get_ue_slice_conf(conf);
+}
+
+/// Sample the cumulative KPM counters of all layers. Lock-free for MAC and RLC, RRC takes its own counter lock
+void enb_stack_lte::get_kpm_counters(kpm_counters_t* c)
+{
+  c->tstamp_us = kpm_now_us();
+  mac.get_kpm_counters(c);
+  rlc.get_kpm_counters(c);
+  rrc.get_kpm_counters(c);
+}
+
+tc_ctrl_out_e enb_stack_lte::tc_control(const tc_ctrl_msg_t& msg)
+{
+  return tc.control(msg);
+}
+
+void enb_stack_lte::get_tc_stats(tc_ind_msg_t* ind)
+{
+  tc.get_stats(ind);
+}
+
 } // namespace srsenb
@@ -241,7 +241,7 @@ int mac::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg_)
   return scheduler.cell_cfg(cell_config);
 }
 
-void mac::get_metrics(mac_metrics_t& metrics)
+void mac::get_metrics(mac_metrics_t& metrics, bool restart_averages)
 {
   srsran::rwlock_read_guard lock(rwlock);
   metrics.ues.reserve(ue_db.size());
@@ -253,7 +253,7 @@ void mac::get_metrics(mac_metrics_t& metrics)
 
     // added in from srsRAN 4G updated repository
     auto& ue_metrics = metrics.ues.back();
-    u.second->metrics_read(&ue_metrics);
+    u.second->metrics_read(&ue_metrics, restart_averages);
     // u.second->metrics_read(&metrics.ues.back()); // previously used
     scheduler.metrics_read(u.first, ue_metrics);
     // ue_metrics.pci = (ue_metrics.cc_idx < cell_config.size()) ? cell_config[ue_metrics.cc_idx].cell.id : 0;
@@ -523,25 +523,6 @@ uint16_t mac::allocate_ue(uint32_t enb_cc_idx)
     }
   } while (inserted_ue == nullptr);
 
-  // Initialize ue slice stats
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  ue_slice_conf_t* stats_ue_s = &slice_stats.stats_ue_slice_conf;
-  stats_ue_s->len_ue_slice = ue_db.size();
-  // TODO: have to append ues, do not initialize ues when new ue connected
-  stats_ue_s->ues = (ue_slice_assoc_t*)calloc(ue_db.size(), sizeof(ue_slice_assoc_t));
-  srsran_assert(stats_ue_s->ues, "memory exhausted");
-  auto it = ue_db.begin();
-  for (size_t i = 0; i < ue_db.size(); ++i, ++it) {
-    int dl_slice_id = -1; //-1, JYD modification to force the ue attached to a slice 
-    if (stats_dl->len_slices > 0)
-      dl_slice_id = stats_dl->slices[0].id;
-    stats_ue_s->ues[i].dl_id = dl_slice_id;
-    stats_ue_s->ues[i].ul_id = -1;
-    stats_ue_s->ues[i].rnti = it->second->get_rnti();
-    srsran::console("initail ue slice stats: rnti %x, dl_id %d\n", stats_ue_s->ues[i].rnti, stats_ue_s->ues[i].dl_id);
-  }
-
   // Set PCAP if available
   if (pcap != nullptr) {
     inserted_ue->start_pcap(pcap);
@@ -1054,5 +1035,25 @@ slice_ctrl_out_e mac::slice(slice_ctrl_req_data_t const& s)
   return scheduler.slice(s);
 }
 
+void mac::get_slice_conf(slice_conf_t* conf)
+{
+  scheduler.get_slice_conf(conf);
+}
+
+void mac::get_slice_stats(slice_ind_msg_t* ind)
+{
+  scheduler.get_slice_stats(ind);
+}
+
+void mac::get_ue_slice_conf(ue_slice_conf_t* conf)
+{
+  scheduler.get_ue_slice_conf(conf);
+}
+
+void mac::get_kpm_counters(kpm_counters_t* c)
+{
+  scheduler.get_kpm_counters(c);
+}
+
 } // namespace srsenb
 
@@ -20,29 +20,51 @@
  */
 
 #include <srsenb/hdr/stack/mac/sched_ue.h>
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <string.h>
 
 #include "srsenb/hdr/stack/mac/sched.h"
 #include "srsenb/hdr/stack/mac/sched_carrier.h"
 #include "srsenb/hdr/stack/mac/sched_helpers.h"
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_edf.h"
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_nvs.h"
+#include "srsran/adt/bounded_vector.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/support/srsran_assert.h"
 #include "srsran/common/standard_streams.h"
 
 #define Console(fmt, ...) srsran::console(fmt, ##__VA_ARGS__)
 #define Error(fmt, ...) srslog::fetch_basic_logger("MAC").error(fmt, ##__VA_ARGS__)
+#define Info(fmt, ...) srslog::fetch_basic_logger("MAC").info(fmt, ##__VA_ARGS__)
 
 using srsran::tti_point;
 
 namespace srsenb {
 
+/// Derive the slice resources for the given carriers, and check that the slice guarantees hold in all of them
+static bool set_slice_cells(sched_slice_table& table, const std::vector<uint32_t>& cells_nof_prb)
+{
+  if (not table.set_cells(cells_nof_prb)) {
+    return false;
+  }
+  for (const std::vector<sched_slice_t>* slices : {&table.slices, &table.ul_slices}) {
+    if (not slices->empty() and (*slices)[0].params.type == SLICE_ALG_SM_V0_EDF and
+        not sched_slice_edf::validate(*slices, cells_nof_prb)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*******************************************************
  *
  * Initialization and sched configuration functions
  *
  *******************************************************/
 
-sched::sched() {}
+sched::sched() : ue_dl_alloc(new std::atomic<uint64_t>[std::numeric_limits<uint16_t>::max() + 1]()) {}
 
 sched::~sched() {}
 
@@ -52,7 +74,15 @@ void sched::init(rrc_interface_mac* rrc_, const sched_args_t& sched_cfg_)
   sched_cfg = sched_cfg_;
 
   // Initialize first carrier scheduler
-  carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &sched_results});
+  carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &sched_results, &kpm_counters});
+
+  // No slices configured. UEs are scheduled with the configured policy
+  {
+    std::unique_ptr<sched_slice_table> slices{new sched_slice_table{}};
+    slices->sched_name = sched_cfg.sched_policy;
+    std::lock_guard<std::mutex> lock(slice_ctrl_mutex);
+    slice_db.publish(std::move(slices));
+  }
 
   reset();
 }
@@ -64,6 +94,10 @@ int sched::reset()
     c->reset();
   }
   ue_db.clear();
+  for (uint32_t rnti = 0; rnti <= std::numeric_limits<uint16_t>::max(); ++rnti) {
+    ue_dl_alloc[rnti].store(0, std::memory_order_relaxed);
+  }
+  ue_slices_dirty = true;
   return 0;
 }
 
@@ -85,7 +119,7 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
   uint32_t prev_size = carrier_schedulers.size();
   carrier_schedulers.resize(sched_cell_params.size());
   for (uint32_t i = prev_size; i < sched_cell_params.size(); ++i) {
-    carrier_schedulers[i].reset(new carrier_sched{rrc, &ue_db, i, &sched_results});
+    carrier_schedulers[i].reset(new carrier_sched{rrc, &ue_db, i, &sched_results, &kpm_counters});
   }
 
   // setup all carriers cfg params
@@ -93,6 +127,21 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
     carrier_schedulers[i]->carrier_cfg(sched_cell_params[i]);
   }
 
+  // Derive the slice resources for the new carriers bandwidth
+  {
+    std::lock_guard<std::mutex> slice_lock(slice_ctrl_mutex);
+    slice_cells_nof_prb.resize(sched_cell_params.size());
+    for (uint32_t i = 0; i < sched_cell_params.size(); ++i) {
+      slice_cells_nof_prb[i] = sched_cell_params[i].nof_prb();
+    }
+    std::unique_ptr<sched_slice_table> slices{new sched_slice_table(slice_db.latest())};
+    if (not set_slice_cells(*slices, slice_cells_nof_prb)) {
+      Error("SCHED: Configured slices do not fit in the new cell bandwidth. Removing slices");
+      slices.reset(new sched_slice_table{});
+    }
+    slice_db.publish(std::move(slices));
+  }
+
   configured = true;
   return 0;
 }
@@ -115,10 +164,14 @@ int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
     }
   }
 
-  // Add new user case
+  // Add new user case. The RNTI may have been used by a UE with a different slice
+  imsiTracker.rem_crnti(rnti);
   std::unique_ptr<sched_ue>   ue{new sched_ue(rnti, sched_cell_params, ue_cfg)};
+  ue->set_dl_alloc_metric(&ue_dl_alloc[rnti]);
   std::lock_guard<std::mutex> lock(sched_mutex);
+  ue_dl_alloc[rnti].store(sched_ue::dl_alloc_present, std::memory_order_relaxed);
   ue_db.insert(rnti, std::move(ue));
+  ue_slices_dirty = true;
   return SRSRAN_SUCCESS;
 }
 
@@ -127,6 +180,8 @@ int sched::ue_rem(uint16_t rnti)
   std::lock_guard<std::mutex> lock(sched_mutex);
   if (ue_db.contains(rnti)) {
     ue_db.erase(rnti);
+    ue_dl_alloc[rnti].store(0, std::memory_order_relaxed);
+    ue_slices_dirty = true;
     // TODO: remove ue from ue slice stats
   } else {
     Error("User rnti=0x%x not found", rnti);
@@ -137,8 +192,7 @@ int sched::ue_rem(uint16_t rnti)
 
 bool sched::ue_exists(uint16_t rnti)
 {
-  return ue_db_access_locked(
-             rnti, [](sched_ue& ue) {}, nullptr, false) >= 0;
+  return ue_dl_alloc[rnti].load(std::memory_order_relaxed) != 0;
 }
 
 void sched::phy_config_enabled(uint16_t rnti, bool enabled)
@@ -358,6 +412,11 @@ void sched::new_tti(tti_point tti_rx)
 {
   last_tti = std::max(last_tti, tti_rx);
 
+  // Slice reconfigurations are only applied at the TTI boundary, before any carrier is scheduled
+  if (not sched_results.has_sf(tti_rx) or not sched_results.get_sf(tti_rx)->is_generated(0)) {
+    update_ue_slices();
+  }
+
   // Generate sched results for all CCs, if not yet generated
   for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
     if (not is_generated(tti_rx, cc_idx)) {
@@ -375,10 +434,17 @@ bool sched::is_generated(srsran::tti_point tti_rx, uint32_t enb_cc_idx) const
 
 
 // added in from srsRAN 4G updated repository
+// Lock-free. Called by the metrics consumers, which must not stall the scheduler
 int sched::metrics_read(uint16_t rnti, mac_ue_metrics_t& metrics)
 {
-  return ue_db_access_locked(
-      rnti, [&metrics](sched_ue& ue) { ue.metrics_read(metrics); }, "metrics_read");
+  uint64_t alloc = ue_dl_alloc[rnti].load(std::memory_order_relaxed);
+  if (alloc == 0) {
+    Error("SCHED: User rnti=0x%x not found. Failed to call metrics_read.", rnti);
+    return SRSRAN_ERROR;
+  }
+  metrics.allocated_prbs = sched_ue::dl_alloc_prbs(alloc);
+  metrics.tti            = sched_ue::dl_alloc_tti(alloc);
+  return SRSRAN_SUCCESS;
 }
 
 
@@ -409,200 +475,423 @@ int sched::ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name, b
 ////////////////////////////////////
 
 
-std::vector<sched_ue*> sched::ues_in_slice(uint32_t slice_id)
+/// Map the scheduler names used by the slice SM to the MAC scheduling policies
+static const char* to_sched_policy(const char* sm_sched_name)
 {
-  std::vector<sched_ue*> ues; 
-  for(auto it = ue_db.begin(); it != ue_db.end(); ++it){
-    sched_ue& ue = *it->second;  
-
-    if(ue.slice_id() == (int64_t)slice_id){
-      ues.push_back(&ue);
-    }
+  if (sm_sched_name == nullptr) {
+    return nullptr;
   }
-  return ues;
+  if (!strcmp(sm_sched_name, "RR")) {
+    return "time_rr";
+  }
+  if (!strcmp(sm_sched_name, "PF")) {
+    return "time_pf";
+  }
+  return nullptr;
 }
 
-int cmpfunc_s(const void* a, const void* b)
+static std::string to_std_string(const char* str, uint32_t len)
 {
-  const fr_slice_t* slice_x = (fr_slice_t*) a;
-  const fr_slice_t* slice_y = (fr_slice_t*) b;
-  const int* x = (int*) &slice_x->id;
-  const int* y = (int*) &slice_y->id;
-  return (*x - *y);
+  return str != nullptr ? std::string(str, len) : std::string();
 }
 
-slice_ctrl_out_e sched::slice_add_mod(slice_conf_t const& conf)
+/// Build the slices of one direction ("DL" or "UL") from the slice SM configuration. Returns false if invalid
+static bool parse_slices(ul_dl_slice_conf_t const&   conf,
+                         const char*                 dir,
+                         std::string&                sched_name_out,
+                         std::vector<sched_slice_t>& slices)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
-  Console("SLICE CTRL MSG: ADD SLICE\n");
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t conf_dl = conf.dl;
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  ue_slice_conf_t* stats_ue_s = &slice_stats.stats_ue_slice_conf;
-
   // Save new sched algo
-  // if len_slices = 0 (reset slice), we have to setup the default user scheduling algo
-  std::string ssched_name = "";
-  if (!strcmp(conf.dl.sched_name, "RR"))
-    ssched_name = "time_rr";
-  else if (!strcmp(conf.dl.sched_name, "PF"))
-    ssched_name = "time_pf";
-  else {
-    Console("Unknown sched algo received, ssched_name %s\n", ssched_name.c_str());
-    return SLICE_CTRL_OUT_ERROR;
+  const char* sched_name = to_sched_policy(conf.sched_name);
+  if (sched_name == nullptr) {
+    Console("Unknown %s sched algo received, sched_name %s\n", dir, conf.sched_name != nullptr ? conf.sched_name : "");
+    return false;
+  }
+  sched_name_out = sched_name;
+
+  if (conf.len_slices >= 5) {
+    Console("Not support %s len_slices = %u\n", dir, conf.len_slices);
+    return false;
   }
-  char const* csched_name = ssched_name.c_str();
-  stats_dl->len_sched_name = std::strlen(csched_name);
-  stats_dl->sched_name = (char*)malloc(stats_dl->len_sched_name);
-  srsran_assert(stats_dl->sched_name != NULL, "memory exhausted");
-  memcpy(stats_dl->sched_name, csched_name, stats_dl->len_sched_name);
 
-  // Check len_slices
-  stats_dl->len_slices = conf_dl.len_slices;
+  slices.reserve(conf.len_slices);
+  for (size_t i = 0; i < conf.len_slices; ++i) {
+    fr_slice_t const& conf_s = conf.slices[i];
 
-  // TODO: len_slices = 0, reset slice as None
+    // Check slice algo. All the slices of a direction must use the same algo
+    slice_algorithm_e algo = conf_s.params.type;
+    if (algo != SLICE_ALG_SM_V0_STATIC and algo != SLICE_ALG_SM_V0_NVS and algo != SLICE_ALG_SM_V0_SCN19 and
+        algo != SLICE_ALG_SM_V0_EDF) {
+      Console("Not support algo = %d\n", algo);
+      return false;
+    }
+    if (algo != conf.slices[0].params.type) {
+      Console("Mixing slice algos %d and %d is not supported\n", conf.slices[0].params.type, algo);
+      return false;
+    }
 
-  if (stats_dl->len_slices > 0 && stats_dl->len_slices < 5) {
-    stats_dl->slices = (fr_slice_t*)calloc(stats_dl->len_slices, sizeof(fr_slice_t));
-    srsran_assert(stats_dl->slices != NULL, "memory exhausted");
+    // Check slice algo data. The static window and the EDF guarantees are checked against the carriers bandwidth,
+    // and the NVS/SCN19 reservations against each other, once all slices are parsed
+    static_slice_t const& conf_sta = conf_s.params.u.sta;
+    if (algo == SLICE_ALG_SM_V0_STATIC and conf_sta.pos_low > conf_sta.pos_high) {
+      Console("FAILED: SET %s SLICE ALGO %d, id %u, pos_low %u, pos_high %u\n",
+              dir, algo, conf_s.id, conf_sta.pos_low, conf_sta.pos_high);
+      return false;
+    }
 
-    for (size_t i = 0; i < stats_dl->len_slices; ++i) {
-      fr_slice_t const& conf_dl_s = conf_dl.slices[i];
-      fr_slice_t* st_slice = &stats_dl->slices[i];
+    // Check slice sched algo
+    const char* slice_sched = to_sched_policy(conf_s.sched);
+    if (slice_sched == nullptr) {
+      Console("Unknown sched algo received for %s slice id %u\n", dir, conf_s.id);
+      return false;
+    }
 
-      // Check slice algo
-      if (conf_dl_s.params.type != SLICE_ALG_SM_V0_STATIC) {
-        Console("Not support algo = %d\n", conf_dl_s.params.type);
-        return SLICE_CTRL_OUT_ERROR;
+    slices.emplace_back();
+    sched_slice_t& slice = slices.back();
+    slice.id             = conf_s.id;
+    slice.label          = to_std_string(conf_s.label, conf_s.len_label);
+    slice.sched          = slice_sched;
+    slice.params         = conf_s.params;
+    if (algo == SLICE_ALG_SM_V0_STATIC) {
+      Console("SUCCESS: SET %s SLICE ALGO %d, id %u, pos_low %u, pos_high %u\n",
+              dir, algo, conf_s.id, conf_sta.pos_low, conf_sta.pos_high);
+    } else if (algo == SLICE_ALG_SM_V0_NVS) {
+      Console("SUCCESS: SET %s SLICE ALGO %d, id %u, nvs conf %d\n", dir, algo, conf_s.id, conf_s.params.u.nvs.conf);
+    } else if (algo == SLICE_ALG_SM_V0_SCN19) {
+      Console(
+          "SUCCESS: SET %s SLICE ALGO %d, id %u, scn19 conf %d\n", dir, algo, conf_s.id, conf_s.params.u.scn19.conf);
+    } else {
+      // The "over" list is owned by the slice, as the control message is released after this call
+      edf_slice_t const& conf_edf = conf_s.params.u.edf;
+      if (conf_edf.len_over > 0) {
+        slice.edf_over.assign(conf_edf.over, conf_edf.over + conf_edf.len_over);
       }
+      slice.params.u.edf.over = nullptr;
+      Console("SUCCESS: SET %s SLICE ALGO %d, id %u, deadline %u, guaranteed_prbs %u, max_replenish %u\n",
+              dir, algo, conf_s.id, conf_edf.deadline, conf_edf.guaranteed_prbs, conf_edf.max_replenish);
+    }
+  }
 
-      // Save slice algo data
-      st_slice->params.type = conf_dl_s.params.type;
-      static_slice_t conf_sta = conf_dl_s.params.u.sta;
-      if (conf_sta.pos_low > 14 || conf_sta.pos_high > 14 || (conf_sta.pos_low > conf_sta.pos_high)) {
-        Console("FAILED: SET DL SLICE ALGO %d, id %u, pos_low %u, pos_high %u\n",
-                conf_dl_s.params.type, conf_dl_s.id, conf_sta.pos_low, conf_sta.pos_high);
-        return SLICE_CTRL_OUT_ERROR;
-      }
-      static_slice_t* sta = &st_slice->params.u.sta;
-      sta->pos_high = conf_sta.pos_high;
-      sta->pos_low = conf_sta.pos_low;
-      Console("SUCCESS: SET DL SLICE ALGO %d, id %u, pos_low %u, pos_high %u\n",
-             conf_dl_s.params.type, conf_dl_s.id, sta->pos_low, sta->pos_high);
-
-      // Save new id
-      st_slice->id = conf_dl_s.id;
-      // Associate all the ue to the first slice id
-      if (i == 0)
-        for (size_t j = 0; j < stats_ue_s->len_ue_slice; j++)
-          stats_ue_s->ues[j].dl_id = st_slice->id;
-
-      // Save new label
-      st_slice->len_label = strlen(conf_dl_s.label);
-      st_slice->label = (char*)malloc(st_slice->len_label);
-      srsran_assert(st_slice->label != NULL, "memory exhausted");
-      memcpy(st_slice->label, conf_dl_s.label, st_slice->len_label);
-
-      // Save new sched algo
-      std::string ssched = "";
-      if (!strcmp(conf_dl_s.sched, "RR"))
-        ssched = "time_rr";
-      else if (!strcmp(conf_dl_s.sched, "PF"))
-        ssched = "time_pf";
-      else {
-        Console("Unknown sched algo received, ssched %s\n", ssched.c_str());
-        return SLICE_CTRL_OUT_ERROR;
-      }
-      char const* csched = ssched_name.c_str();
-      st_slice->len_sched = std::strlen(csched);
-      st_slice->sched = (char*)malloc(st_slice->len_sched);
-      srsran_assert(st_slice->sched != NULL, "memory exhausted");
-      memcpy(st_slice->sched, csched, st_slice->len_sched);
+  // Slices are looked up by id
+  std::sort(slices.begin(), slices.end(), [](const sched_slice_t& a, const sched_slice_t& b) { return a.id < b.id; });
+  for (size_t i = 1; i < slices.size(); ++i) {
+    if (slices[i].id == slices[i - 1].id) {
+      Console("Duplicated %s slice id %u\n", dir, slices[i].id);
+      return false;
     }
-    return SLICE_CTRL_OUT_OK;
-  } else {
-    Console("Not support len_slices = %u\n", stats_dl->len_slices);
-    return SLICE_CTRL_OUT_ERROR;
   }
+  slice_algorithm_e algo = slices.empty() ? SLICE_ALG_SM_V0_NONE : slices[0].params.type;
+  if ((algo == SLICE_ALG_SM_V0_NVS or algo == SLICE_ALG_SM_V0_SCN19) and not sched_slice_nvs::validate(slices)) {
+    Console("FAILED: invalid %s NVS/SCN19 slice reservations\n", dir);
+    return false;
+  }
+  return true;
 }
 
-slice_ctrl_out_e sched::ue_slice_conf(ue_slice_conf_t const& ue_slice)
+slice_ctrl_out_e sched::slice_add_mod(slice_conf_t const& conf)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
-  Console("SLICE CTRL MSG: ASSOCIATE UE SLICE\n");
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  ue_slice_conf_t* stats_ue_s = &slice_stats.stats_ue_slice_conf;
+  Console("SLICE CTRL MSG: ADD SLICE\n");
 
-  if (stats_dl->len_slices == 0) {
-    Console("No slice be added, UE can not be associated\n");
+  // The new configuration is built aside and only made visible to the scheduler once fully validated
+  std::unique_ptr<sched_slice_table> table{new sched_slice_table{}};
+
+  // Without DL slices, the empty table is published and slicing is disabled in both directions
+  if (conf.dl.len_slices == 0 and conf.ul.len_slices > 0) {
+    Console("Not support UL slices without DL slices\n");
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  if (conf.dl.len_slices > 0 and not parse_slices(conf.dl, "DL", table->sched_name, table->slices)) {
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  // UL is only sliced if UL slices are given. Otherwise, the PUSCH of the UEs follows their DL slice
+  if (conf.ul.len_slices > 0 and not parse_slices(conf.ul, "UL", table->ul_sched_name, table->ul_slices)) {
     return SLICE_CTRL_OUT_ERROR;
   }
 
-  if (ue_db.size() <= 0) {
-    Console("No UE connected\n");
+  std::lock_guard<std::mutex> lock(slice_ctrl_mutex);
+  if (not set_slice_cells(*table, slice_cells_nof_prb)) {
+    Console("FAILED: slice resources exceed the cell bandwidth\n");
     return SLICE_CTRL_OUT_ERROR;
   }
+  table->set_stats(slice_db.latest());
+  slice_db.publish(std::move(table));
+  return SLICE_CTRL_OUT_OK;
+}
+
+/// Report the slices of one direction to the E2 agent. Nothing is written for a direction without slices
+static void fill_slice_conf(const std::string&                sched_name,
+                            const std::vector<sched_slice_t>& slices,
+                            ul_dl_slice_conf_t*               rd_conf)
+{
+  if (slices.empty()) {
+    return;
+  }
+
+  // get sched algo
+  rd_conf->len_sched_name = sched_name.size();
+  rd_conf->sched_name     = (char*)malloc(rd_conf->len_sched_name);
+  srsran_assert(rd_conf->sched_name != NULL, "memory exhausted");
+  memcpy(rd_conf->sched_name, sched_name.data(), rd_conf->len_sched_name);
+
+  // allocate memory to read multi slices
+  rd_conf->len_slices = slices.size();
+  rd_conf->slices     = (fr_slice_t*)calloc(rd_conf->len_slices, sizeof(fr_slice_t));
+  srsran_assert(rd_conf->slices != NULL, "memory exhausted");
+
+  // Get each slice config: id, label, sched algo, slice algo data
+  for (uint32_t i = 0; i < rd_conf->len_slices; ++i) {
+    const sched_slice_t& st_slice = slices[i];
+    fr_slice_t*          rd_slice = &rd_conf->slices[i];
+
+    // get id
+    rd_slice->id = st_slice.id;
+
+    // get label
+    rd_slice->len_label = st_slice.label.size();
+    rd_slice->label     = (char*)malloc(rd_slice->len_label);
+    srsran_assert(rd_slice->label != NULL, "memory exhausted");
+    memcpy(rd_slice->label, st_slice.label.data(), rd_slice->len_label);
+
+    // get sched algo
+    rd_slice->len_sched = st_slice.sched.size();
+    rd_slice->sched     = (char*)malloc(rd_slice->len_sched);
+    srsran_assert(rd_slice->sched != NULL, "memory exhausted");
+    memcpy(rd_slice->sched, st_slice.sched.data(), rd_slice->len_sched);
+
+    // get slice algo data
+    rd_slice->params = st_slice.params;
+    if (st_slice.params.type == SLICE_ALG_SM_V0_EDF and not st_slice.edf_over.empty()) {
+      rd_slice->params.u.edf.over = (uint32_t*)malloc(st_slice.edf_over.size() * sizeof(uint32_t));
+      srsran_assert(rd_slice->params.u.edf.over != NULL, "memory exhausted");
+      memcpy(rd_slice->params.u.edf.over, st_slice.edf_over.data(), st_slice.edf_over.size() * sizeof(uint32_t));
+    }
+  }
+}
 
-  // Get new ue slice config
-  ue_slice_assoc_t* new_ues = ue_slice.ues;
-  size_t n_new_ues = ue_slice.len_ue_slice;
-  srsran_assert(n_new_ues != 0, "len_ue_slice == %u", n_new_ues);
+void sched::get_kpm_counters(kpm_counters_t* c)
+{
+  c->nof_ttis   = kpm_counters.nof_ttis.load(std::memory_order_relaxed);
+  c->dl_prbs    = kpm_counters.dl_prbs.load(std::memory_order_relaxed);
+  c->ul_prbs    = kpm_counters.ul_prbs.load(std::memory_order_relaxed);
+  c->dl_bytes   = kpm_counters.dl_bytes.load(std::memory_order_relaxed);
+  c->ul_bytes   = kpm_counters.ul_bytes.load(std::memory_order_relaxed);
+  c->dl_ue_ttis = kpm_counters.dl_ue_ttis.load(std::memory_order_relaxed);
+  c->ul_ue_ttis = kpm_counters.ul_ue_ttis.load(std::memory_order_relaxed);
+}
+
+void sched::get_slice_conf(slice_conf_t* conf)
+{
+  std::lock_guard<std::mutex> lock(slice_ctrl_mutex);
+  const sched_slice_table&    table = slice_db.latest();
 
-  // Save new ue slice config
-  for (size_t i = 0; i < n_new_ues; ++i) {
-    uint16_t rnti = new_ues[i].rnti;
+  fill_slice_conf(table.sched_name, table.slices, &conf->dl);
+  fill_slice_conf(table.ul_sched_name, table.ul_slices, &conf->ul);
+}
 
-    // TODO: enable UL slicing
-    if (new_ues[i].ul_id)
-      Console("ignoring UL slice association for RNTI %04x\n", rnti);
+void sched::get_slice_stats(slice_ind_msg_t* ind)
+{
+  std::lock_guard<std::mutex> lock(slice_ctrl_mutex);
+  const sched_slice_table&    table = slice_db.latest();
 
-    // Check rnti exists in ue_db
-    auto new_it = ue_db.find(rnti);
-    if (not ue_db.contains(rnti)) {
-      Console("RNTI %04x doesn't exist in enb\n", rnti);
-      return SLICE_CTRL_OUT_ERROR;
+  // DL and UL slices with the same id share their counters, and are reported once
+  std::map<uint32_t, const sched_slice_stats_t*> stats;
+  for (const std::vector<sched_slice_t>* slices : {&table.slices, &table.ul_slices}) {
+    for (const sched_slice_t& st_slice : *slices) {
+      stats.emplace(st_slice.id, st_slice.stats.get());
     }
+  }
 
-    // Check new associated slice id exists in enb
-    int new_idx = new_ues[i].dl_id;
-    sched_ue& cur_ue = *new_it->second.get();
-    int cur_idx = cur_ue.slice_id();
-    if (new_idx == cur_idx) {
-      Console("expected DL slice association for UE RNTI %04x\n", rnti);
-      return SLICE_CTRL_OUT_ERROR;
+  ind->len_slice_stats = stats.size();
+  if (ind->len_slice_stats == 0) {
+    return;
+  }
+  ind->slice_stats = (fr_slice_stats_t*)calloc(ind->len_slice_stats, sizeof(fr_slice_stats_t));
+  srsran_assert(ind->slice_stats != NULL, "memory exhausted");
+
+  uint32_t i = 0;
+  for (const auto& s : stats) {
+    fr_slice_stats_t* rd_stats = &ind->slice_stats[i++];
+    rd_stats->id               = s.first;
+    if (s.second != nullptr) {
+      rd_stats->dl_deadline_miss = s.second->dl_deadline_miss.load(std::memory_order_relaxed);
+      rd_stats->ul_deadline_miss = s.second->ul_deadline_miss.load(std::memory_order_relaxed);
+      rd_stats->ul_alloc_prbs    = s.second->ul_alloc_prbs.load(std::memory_order_relaxed);
     }
-    // Get new associated slice pointer by binary search
-    fr_slice_t* pslice = (fr_slice_t*) std::bsearch(&new_idx, stats_dl->slices, stats_dl->len_slices, sizeof(stats_dl->slices[0]), cmpfunc_s);
-    if (pslice == NULL) {
-      Console("dl_id %u doesn't exist\n", new_idx);
-      return SLICE_CTRL_OUT_ERROR;
+  }
+}
+
+/// Resolve the slice of each UE in the active slice table, and distribute the UEs among the slice schedulers of each
+/// carrier. Called by the scheduler at the TTI boundary, so that the allocation helpers can access the UE slice in O(1),
+/// and the UE subsets are only rebuilt when the UEs or their slices change.
+void sched::update_ue_slices()
+{
+  bool     table_changed = slice_db.new_tti();
+  uint32_t epoch         = imsiTracker.epoch();
+  if (not table_changed and not ue_slices_dirty and epoch == slicer_epoch) {
+    return;
+  }
+  ue_slices_dirty = false;
+  slicer_epoch    = epoch;
+
+  const sched_slice_table& table = slice_db.active();
+  if (table_changed) {
+    for (auto& carrier : carrier_schedulers) {
+      carrier->set_slices(table);
+    }
+  }
+  for (auto& u : ue_db) {
+    uint32_t slice_id = imsiTracker.find_slice(u.first);
+    int      idx      = slice_id != slicer_interface::no_slice ? table.find_slice(slice_id) : -1;
+    // UEs without association, or associated to a slice that no longer exists, belong to the default slice
+    if (idx < 0 and not table.slices.empty()) {
+      idx = 0;
+    }
+    const sched_slice_t* slice = idx >= 0 ? &table.slices[idx] : nullptr;
+    u.second->set_slice(slice);
+
+    // Without UL slices, the UL of the UE follows its DL slice
+    if (table.ul_slices.empty()) {
+      u.second->set_ul_slice(slice);
+      continue;
     }
+    uint32_t ul_slice_id = imsiTracker.find_ul_slice(u.first);
+    int      ul_idx      = ul_slice_id != slicer_interface::no_slice ? table.find_ul_slice(ul_slice_id) : -1;
+    u.second->set_ul_slice(&table.ul_slices[ul_idx >= 0 ? ul_idx : 0]);
+  }
+  for (auto& carrier : carrier_schedulers) {
+    carrier->update_ue_subsets();
+  }
+}
 
-    // TODO: Get ue pointer by binary search
-    // ue_slice_assoc_t* pue = (ue_slice_assoc_t*) std::bsearch(&rnti, stats_ue_s->ues, stats_ue_s->len_ue_slice, sizeof(stats_ue_s->ues[0]), cmpfunc_u);
+slice_ctrl_out_e sched::ue_slice_conf(ue_slice_conf_t const& ue_slice)
+{
+  Console("SLICE CTRL MSG: ASSOCIATE UE SLICE\n");
+  if (ue_slice.len_ue_slice == 0) {
+    Console("No UE slice association received\n");
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  // The RNTIs are checked lock-free, so that the scheduler is not stalled by the control path
+  for (size_t i = 0; i < ue_slice.len_ue_slice; ++i) {
+    if (not ue_exists(ue_slice.ues[i].rnti)) {
+      Console("RNTI %04x doesn't exist in enb\n", ue_slice.ues[i].rnti);
+      return SLICE_CTRL_OUT_ERROR;
+    }
+  }
 
-    // Get index of rnti in ue slice stats
-    int idx_u = -1;
-    for (size_t j = 0; j < stats_ue_s->len_ue_slice; j++) {
-      if (stats_ue_s->ues[j].rnti == rnti) {
-        idx_u = j;
+  // Only the slice table is protected. The associations are logged once the lock is released
+  bool   no_slices = false, ul_sliced = false;
+  size_t bad_dl = ue_slice.len_ue_slice, bad_ul = ue_slice.len_ue_slice;
+  {
+    std::lock_guard<std::mutex> slice_lock(slice_ctrl_mutex);
+    const sched_slice_table&    slices = slice_db.latest();
+    no_slices                          = slices.slices.empty();
+    ul_sliced                          = not slices.ul_slices.empty();
+
+    // The associations are only applied if all of them are valid
+    for (size_t i = 0; i < ue_slice.len_ue_slice and not no_slices; ++i) {
+      const ue_slice_assoc_t& assoc = ue_slice.ues[i];
+      if (slices.find_slice(assoc.dl_id) < 0) {
+        bad_dl = i;
+        break;
+      }
+      if (ul_sliced and slices.find_ul_slice(assoc.ul_id) < 0) {
+        bad_ul = i;
         break;
       }
     }
-    if (idx_u < 0) {
-      Console("RNTI %04x doesn't exist in ue slice stats\n", rnti);
-      return SLICE_CTRL_OUT_ERROR;
+
+    // The scheduler picks up the new associations at the next TTI. They are kept by IMSI, so that they survive RNTI
+    // changes and re-attaches, and only by RNTI while RRC has not captured the IMSI of the UE yet
+    bool valid = not no_slices and bad_dl == ue_slice.len_ue_slice and bad_ul == ue_slice.len_ue_slice;
+    for (size_t i = 0; i < ue_slice.len_ue_slice and valid; ++i) {
+      const ue_slice_assoc_t& assoc = ue_slice.ues[i];
+      uint64_t                imsi  = imsiTracker.find_imsi(assoc.rnti);
+      if (imsi != 0) {
+        imsiTracker.set_imsi_slice(imsi, assoc.dl_id);
+      } else {
+        imsiTracker.set_rnti_slice(assoc.rnti, assoc.dl_id);
+      }
+      // The UL association is only used when UL is sliced
+      if (not ul_sliced) {
+        continue;
+      }
+      if (imsi != 0) {
+        imsiTracker.set_imsi_ul_slice(imsi, assoc.ul_id);
+      } else {
+        imsiTracker.set_rnti_ul_slice(assoc.rnti, assoc.ul_id);
+      }
     }
+  }
 
-    // Assoc ue to dl slice
-    cur_ue.set_slice_id(new_idx);
-    stats_ue_s->ues[idx_u].dl_id = new_idx;
-    Console("SET UE rnti %x ASSOC DL ID %u\n", rnti, new_idx);
+  if (no_slices) {
+    Console("No slice be added, UE can not be associated\n");
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  if (bad_dl < ue_slice.len_ue_slice) {
+    Console("dl_id %u doesn't exist\n", ue_slice.ues[bad_dl].dl_id);
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  if (bad_ul < ue_slice.len_ue_slice) {
+    Console("ul_id %u doesn't exist\n", ue_slice.ues[bad_ul].ul_id);
+    return SLICE_CTRL_OUT_ERROR;
+  }
+  for (size_t i = 0; i < ue_slice.len_ue_slice; ++i) {
+    const ue_slice_assoc_t& assoc = ue_slice.ues[i];
+    if (ul_sliced) {
+      Info("SLICE CTRL: rnti=0x%x associated to DL slice %u, UL slice %u", assoc.rnti, assoc.dl_id, assoc.ul_id);
+    } else {
+      Info("SLICE CTRL: rnti=0x%x associated to DL slice %u", assoc.rnti, assoc.dl_id);
+    }
   }
+  Console("Associated %zu UEs to slices\n", ue_slice.len_ue_slice);
   return SLICE_CTRL_OUT_OK;
 }
 
+void sched::get_ue_slice_conf(ue_slice_conf_t* conf)
+{
+  // Snapshot of the slices the scheduler is using, taken under a short lock. Allocation and IMSI lookups happen after
+  srsran::bounded_vector<ue_slice_assoc_t, SRSENB_MAX_UES> ues;
+  bool                                                     ul_sliced;
+  {
+    std::lock_guard<std::mutex> lock(sched_mutex);
+    ul_sliced = not slice_db.active().ul_slices.empty();
+    for (auto& u : ue_db) {
+      const sched_slice_t* slice    = u.second->get_slice();
+      const sched_slice_t* ul_slice = u.second->get_ul_slice();
+      ue_slice_assoc_t     assoc    = {};
+      assoc.rnti                    = u.first;
+      assoc.dl_id                   = slice != nullptr ? slice->id : slicer_interface::no_slice;
+      assoc.ul_id                   = ul_slice != nullptr ? ul_slice->id : slicer_interface::no_slice;
+      ues.push_back(assoc);
+    }
+  }
+
+  conf->len_ue_slice = ues.size();
+  if (conf->len_ue_slice == 0) {
+    return;
+  }
+  conf->ues = (ue_slice_assoc_t*)calloc(conf->len_ue_slice, sizeof(ue_slice_assoc_t));
+  srsran_assert(conf->ues != NULL, "memory exhausted");
+
+  // Report the IMSI association of each UE, or the slice the scheduler is actually using when the IMSI is unknown or
+  // has no association, e.g. UEs in the default slice
+  for (size_t i = 0; i < ues.size(); ++i) {
+    conf->ues[i] = ues[i];
+
+    uint64_t imsi = imsiTracker.find_imsi(ues[i].rnti);
+    if (imsi != 0) {
+      uint32_t dl_id = imsiTracker.find_imsi_slice(imsi);
+      uint32_t ul_id = imsiTracker.find_imsi_ul_slice(imsi);
+      if (dl_id != slicer_interface::no_slice) {
+        conf->ues[i].dl_id = dl_id;
+      }
+      if (ul_id != slicer_interface::no_slice and ul_sliced) {
+        conf->ues[i].ul_id = ul_id;
+      }
+    }
+  }
+}
+
 slice_ctrl_out_e sched::slice(slice_ctrl_req_data_t const& s)
 {
 
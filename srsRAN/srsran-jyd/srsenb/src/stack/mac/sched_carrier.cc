@@ -330,15 +330,25 @@ void ra_sched::reset()
  *                 Carrier scheduling
  *******************************************************/
 
+static std::unique_ptr<sched_base> make_sched_algo(const std::string& policy, const sched_cell_params_t& cell_params)
+{
+  if (policy == "time_rr") {
+    return std::unique_ptr<sched_base>{new sched_time_rr{cell_params, *cell_params.sched_cfg}};
+  }
+  return std::unique_ptr<sched_base>{new sched_time_pf{cell_params, *cell_params.sched_cfg}};
+}
+
 sched::carrier_sched::carrier_sched(rrc_interface_mac*       rrc_,
                                     sched_ue_list*           ue_db_,
                                     uint32_t                 enb_cc_idx_,
-                                    sched_result_ringbuffer* sched_results_) :
+                                    sched_result_ringbuffer* sched_results_,
+                                    mac_kpm_counters_t*      kpm_counters_) :
   rrc(rrc_),
   ue_db(ue_db_),
   logger(srslog::fetch_basic_logger("MAC")),
   enb_cc_idx(enb_cc_idx_),
-  prev_sched_results(sched_results_)
+  prev_sched_results(sched_results_),
+  kpm_counters(kpm_counters_)
 {
   sf_dl_mask.resize(1, 0);
 }
@@ -361,22 +371,10 @@ void sched::carrier_sched::carrier_cfg(const sched_cell_params_t& cell_params_)
   ra_sched_ptr.reset(new ra_sched{*cc_cfg, *ue_db});
 
   // Setup data scheduling algorithms
-  if (cell_params_.sched_cfg->sched_policy == "time_rr") {
-    sched_algo.reset(new sched_time_rr{*cc_cfg, *cell_params_.sched_cfg});
-    logger.info("Using time-domain RR scheduling policy for cc=%d", cc_cfg->enb_cc_idx);
-  } else {
-    sched_algo.reset(new sched_time_pf{*cc_cfg, *cell_params_.sched_cfg});
-    logger.info("Using time-domain PF scheduling policy for cc=%d", cc_cfg->enb_cc_idx);
-  }
-
-  // Initialize slice stats
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  char const* sched_policy = cell_params_.sched_cfg->sched_policy.c_str();
-  stats_dl->len_sched_name = strlen(sched_policy);
-  stats_dl->sched_name = (char*)malloc(stats_dl->len_sched_name);
-  srsran_assert(stats_dl->sched_name != NULL, "memory exhausted");
-  memcpy(stats_dl->sched_name, sched_policy, stats_dl->len_sched_name);
+  sched_algo = make_sched_algo(cell_params_.sched_cfg->sched_policy, *cc_cfg);
+  logger.info("Using time-domain %s scheduling policy for cc=%d",
+              cell_params_.sched_cfg->sched_policy == "time_rr" ? "RR" : "PF",
+              cc_cfg->enb_cc_idx);
 
   // Initiate the tti_scheduler for each TTI
   for (sf_sched& tti_sched : sf_scheds) {
@@ -445,11 +443,52 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
   log_dl_cc_results(logger, enb_cc_idx, cc_result->dl_sched_result);
   log_phich_cc_results(logger, enb_cc_idx, cc_result->ul_sched_result);
 
+  if (kpm_counters != nullptr) {
+    update_kpm_counters(*tti_sched, *cc_result);
+  }
+
   return *cc_result;
 }
 
+void sched::carrier_sched::update_kpm_counters(const sf_sched& tti_sched, const cc_sched_result& cc_result)
+{
+  uint32_t dl_prbs = cc_result.dl_mask.size() > 0 ? count_prb_per_tb(cc_result.dl_mask) : 0;
+  uint32_t ul_prbs = 0;
+  for (const sf_sched::ul_alloc_t& alloc : tti_sched.get_allocated_ul_data()) {
+    ul_prbs += alloc.alloc.length();
+  }
+
+  // Throughput only accounts new transmissions, so that HARQ retransmissions are not counted twice
+  uint64_t dl_bytes = 0, ul_bytes = 0;
+  for (const sched_interface::dl_sched_data_t& data : cc_result.dl_sched_result.data) {
+    for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; ++tb) {
+      if (data.tbs[tb] > 0 and data.dci.tb[tb].rv == 0) {
+        dl_bytes += data.tbs[tb];
+      }
+    }
+  }
+  for (const sched_interface::ul_sched_data_t& pusch : cc_result.ul_sched_result.pusch) {
+    if (pusch.current_tx_nb == 0) {
+      ul_bytes += pusch.tbs;
+    }
+  }
+
+  kpm_counters->nof_ttis.fetch_add(1, std::memory_order_relaxed);
+  kpm_counters->dl_prbs.fetch_add(dl_prbs, std::memory_order_relaxed);
+  kpm_counters->ul_prbs.fetch_add(ul_prbs, std::memory_order_relaxed);
+  kpm_counters->dl_bytes.fetch_add(dl_bytes, std::memory_order_relaxed);
+  kpm_counters->ul_bytes.fetch_add(ul_bytes, std::memory_order_relaxed);
+  kpm_counters->dl_ue_ttis.fetch_add(cc_result.dl_sched_result.data.size(), std::memory_order_relaxed);
+  kpm_counters->ul_ue_ttis.fetch_add(cc_result.ul_sched_result.pusch.size(), std::memory_order_relaxed);
+}
+
 void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
 {
+  // EDF windows are measured in TTIs, whether or not DL data can be scheduled in this one
+  if (edf_sched != nullptr) {
+    edf_sched->new_tti();
+  }
+
   if (sf_dl_mask[tti_result->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] != 0) {
     return;
   }
@@ -462,18 +501,319 @@ void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
     }
   }
 
+  // Slices are served first. UEs not associated to any slice get the remaining RBGs
+  if (nvs_sched != nullptr) {
+    alloc_dl_nvs_slices(tti_result);
+  } else if (edf_sched != nullptr) {
+    alloc_dl_edf_slices(tti_result);
+  } else {
+    // Static slices cannot use RBGs outside their window, so the order in which they are served does not matter
+    for (slice_sched_t& slice : slice_scheds) {
+      slice.algo->sched_dl_users(slice.ues, tti_result);
+    }
+  }
+
   // call DL scheduler metric to fill RB grid
-  sched_algo->sched_dl_users(*ue_db, tti_result);
+  sched_algo->sched_dl_users(sched_ues, tti_result);
+}
+
+void sched::carrier_sched::alloc_dl_nvs_slices(sf_sched* tti_sched)
+{
+  for (uint32_t slice_idx : nvs_sched->get_order()) {
+    slice_sched_t& slice    = slice_scheds[slice_idx];
+    size_t         prev_len = tti_sched->get_allocated_dl_data().size();
+    slice.algo->sched_dl_users(slice.ues, tti_sched);
+
+    // Account the resources given to the slice in this TTI
+    uint32_t                                 alloc_bytes = 0, alloc_rbgs = 0;
+    srsran::const_span<sf_sched::dl_alloc_t> allocs = tti_sched->get_allocated_dl_data();
+    for (size_t i = prev_len; i < allocs.size(); ++i) {
+      uint32_t nof_rbgs = allocs[i].user_mask.count();
+      alloc_rbgs += nof_rbgs;
+      alloc_bytes += slice.ues[allocs[i].rnti]->get_expected_dl_bitrate(enb_cc_idx, nof_rbgs) * tti_duration_ms / 8;
+    }
+    nvs_sched->save_alloc(slice_idx, alloc_bytes, alloc_rbgs);
+  }
+}
+
+/// Free RBGs beyond the first ones that add up to nof_prbs. Used to cap the allocations of a slice to its budget
+static rbgmask_t get_dl_budget_restriction(const sf_sched& tti_sched, uint32_t nof_prbs)
+{
+  rbgmask_t restriction = ~tti_sched.get_dl_mask();
+  uint32_t  nof_rbgs    = tti_sched.get_cc_cfg()->nof_prbs_to_rbgs(nof_prbs);
+  int       rbg         = restriction.find_lowest(0, restriction.size());
+  while (rbg >= 0 and nof_rbgs > 0) {
+    restriction.set(rbg, false);
+    nof_rbgs--;
+    rbg = restriction.find_lowest(rbg + 1, restriction.size());
+  }
+  return restriction;
+}
+
+/// Whether some UEs of the subset were left without DL allocation, while having data to send
+static bool has_dl_backlog(sched_ue_subset& ues, const sf_sched& tti_sched)
+{
+  uint32_t enb_cc_idx = tti_sched.get_enb_cc_idx();
+  for (auto& u : ues) {
+    sched_ue& user = *u.second;
+    if (user.enb_to_ue_cc_idx(enb_cc_idx) < 0 or tti_sched.is_dl_alloc(user.get_rnti())) {
+      continue;
+    }
+    if (user.get_requested_dl_bytes(enb_cc_idx).stop() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Number of PRBs allocated since the given position of the DL data allocations
+static uint32_t count_dl_prbs_since(const sf_sched& tti_sched, size_t prev_len)
+{
+  uint32_t                                 nof_prbs = 0;
+  srsran::const_span<sf_sched::dl_alloc_t> allocs   = tti_sched.get_allocated_dl_data();
+  for (size_t i = prev_len; i < allocs.size(); ++i) {
+    nof_prbs += count_prb_per_tb(allocs[i].user_mask);
+  }
+  return nof_prbs;
+}
+
+void sched::carrier_sched::alloc_dl_edf_slices(sf_sched* tti_sched)
+{
+  const std::vector<uint32_t>& order = edf_sched->get_order();
+
+  // Slices with guaranteed PRBs left, capped to their budget, earliest deadline first
+  for (uint32_t slice_idx : order) {
+    uint32_t budget = edf_sched->get_budget(slice_idx);
+    if (budget == 0) {
+      break;
+    }
+    slice_sched_t& slice    = slice_scheds[slice_idx];
+    size_t         prev_len = tti_sched->get_allocated_dl_data().size();
+    tti_sched->restrict_dl_users(get_dl_budget_restriction(*tti_sched, budget));
+    slice.algo->sched_dl_users(slice.ues, tti_sched);
+    tti_sched->clear_dl_user_restriction();
+    edf_sched->save_alloc(slice_idx, count_dl_prbs_since(*tti_sched, prev_len));
+  }
+
+  // Resources left are shared by all the slices in the same order
+  for (uint32_t slice_idx : order) {
+    slice_sched_t& slice    = slice_scheds[slice_idx];
+    size_t         prev_len = tti_sched->get_allocated_dl_data().size();
+    slice.algo->sched_dl_users(slice.ues, tti_sched);
+    edf_sched->save_alloc(slice_idx, count_dl_prbs_since(*tti_sched, prev_len));
+    edf_sched->save_backlog(slice_idx, has_dl_backlog(slice.ues, *tti_sched));
+  }
 }
 
 int sched::carrier_sched::alloc_ul_users(sf_sched* tti_sched)
 {
-  /* Call scheduler for UL data */
-  sched_algo->sched_ul_users(*ue_db, tti_sched);
+  // EDF windows are measured in TTIs, whether or not UL data can be scheduled in this one
+  if (ul_edf_sched != nullptr) {
+    ul_edf_sched->new_tti();
+  }
+
+  if (ul_slice_scheds.empty()) {
+    // UL is not sliced. The DL slice schedulers handle the UL of their own UEs, within the PRBs of their DL window
+    for (uint32_t slice_idx = 0; slice_idx < slice_scheds.size(); ++slice_idx) {
+      sched_ul_slice(slice_idx, tti_sched);
+    }
+  } else if (ul_nvs_sched != nullptr) {
+    alloc_ul_nvs_slices(tti_sched);
+  } else if (ul_edf_sched != nullptr) {
+    alloc_ul_edf_slices(tti_sched);
+  } else {
+    // Static slices cannot use PRBs outside their window, so the order in which they are served does not matter
+    for (uint32_t slice_idx = 0; slice_idx < ul_slice_scheds.size(); ++slice_idx) {
+      sched_ul_slice(slice_idx, tti_sched);
+    }
+  }
+
+  /* Call scheduler for UL data. UEs are only left out of the slices when DL, and therefore UL, is not sliced */
+  sched_algo->sched_ul_users(sched_ues, tti_sched);
 
   return SRSRAN_SUCCESS;
 }
 
+uint32_t sched::carrier_sched::sched_ul_slice(uint32_t slice_idx, sf_sched* tti_sched)
+{
+  bool                 ul_sliced = not ul_slice_scheds.empty();
+  slice_sched_t&       slice     = ul_sliced ? ul_slice_scheds[slice_idx] : slice_scheds[slice_idx];
+  const sched_slice_t& params    = ul_sliced ? slices->ul_slices[slice_idx] : slices->slices[slice_idx];
+  size_t               prev_len  = tti_sched->get_allocated_ul_data().size();
+  slice.algo->sched_ul_users(slice.ues, tti_sched);
+
+  uint32_t                                 nof_prbs = 0;
+  srsran::const_span<sf_sched::ul_alloc_t> allocs   = tti_sched->get_allocated_ul_data();
+  for (size_t i = prev_len; i < allocs.size(); ++i) {
+    nof_prbs += allocs[i].alloc.length();
+  }
+  if (nof_prbs > 0 and params.stats != nullptr) {
+    params.stats->ul_alloc_prbs.fetch_add(nof_prbs, std::memory_order_relaxed);
+  }
+  return nof_prbs;
+}
+
+void sched::carrier_sched::alloc_ul_nvs_slices(sf_sched* tti_sched)
+{
+  for (uint32_t slice_idx : ul_nvs_sched->get_order()) {
+    size_t   prev_len = tti_sched->get_allocated_ul_data().size();
+    uint32_t nof_prbs = sched_ul_slice(slice_idx, tti_sched);
+
+    // Account the resources given to the slice in this TTI
+    uint32_t                                 alloc_bytes = 0;
+    srsran::const_span<sf_sched::ul_alloc_t> allocs      = tti_sched->get_allocated_ul_data();
+    for (size_t i = prev_len; i < allocs.size(); ++i) {
+      sched_ue* user = ul_slice_scheds[slice_idx].ues[allocs[i].rnti];
+      alloc_bytes += user->get_expected_ul_bitrate(enb_cc_idx, allocs[i].alloc.length()) * tti_duration_ms / 8;
+    }
+    ul_nvs_sched->save_alloc(slice_idx, alloc_bytes, nof_prbs);
+  }
+}
+
+/// Free PRBs beyond the first nof_prbs ones. Used to cap the allocations of a slice to its budget
+static prbmask_t get_ul_budget_restriction(const sf_sched& tti_sched, uint32_t nof_prbs)
+{
+  prbmask_t restriction = ~tti_sched.get_ul_mask();
+  int       prb         = restriction.find_lowest(0, restriction.size());
+  while (prb >= 0 and nof_prbs > 0) {
+    restriction.set(prb, false);
+    nof_prbs--;
+    prb = restriction.find_lowest(prb + 1, restriction.size());
+  }
+  return restriction;
+}
+
+/// Whether some UEs of the subset were left without UL allocation, while having data to send
+static bool has_ul_backlog(sched_ue_subset& ues, const sf_sched& tti_sched)
+{
+  uint32_t enb_cc_idx = tti_sched.get_enb_cc_idx();
+  for (auto& u : ues) {
+    sched_ue& user = *u.second;
+    if (user.enb_to_ue_cc_idx(enb_cc_idx) < 0 or tti_sched.is_ul_alloc(user.get_rnti())) {
+      continue;
+    }
+    if (user.get_pending_ul_new_data(tti_sched.get_tti_tx_ul(), enb_cc_idx) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void sched::carrier_sched::alloc_ul_edf_slices(sf_sched* tti_sched)
+{
+  const std::vector<uint32_t>& order = ul_edf_sched->get_order();
+
+  // Slices with guaranteed PRBs left, capped to their budget, earliest deadline first
+  for (uint32_t slice_idx : order) {
+    uint32_t budget = ul_edf_sched->get_budget(slice_idx);
+    if (budget == 0) {
+      break;
+    }
+    tti_sched->restrict_ul_users(get_ul_budget_restriction(*tti_sched, budget));
+    uint32_t nof_prbs = sched_ul_slice(slice_idx, tti_sched);
+    tti_sched->clear_ul_user_restriction();
+    ul_edf_sched->save_alloc(slice_idx, nof_prbs);
+  }
+
+  // Resources left are shared by all the slices in the same order
+  for (uint32_t slice_idx : order) {
+    ul_edf_sched->save_alloc(slice_idx, sched_ul_slice(slice_idx, tti_sched));
+    ul_edf_sched->save_backlog(slice_idx, has_ul_backlog(ul_slice_scheds[slice_idx].ues, *tti_sched));
+  }
+}
+
+void sched::carrier_sched::set_slices(const sched_slice_table& slices_)
+{
+  slices = &slices_;
+  slice_scheds.clear();
+  nvs_sched.reset();
+  edf_sched.reset();
+  ul_slice_scheds.clear();
+  ul_nvs_sched.reset();
+  ul_edf_sched.reset();
+  if (cc_cfg == nullptr or slices->empty()) {
+    return;
+  }
+
+  // Every slice runs its own UE scheduling policy over its own UEs
+  slice_scheds.resize(slices->slices.size());
+  for (uint32_t i = 0; i < slices->slices.size(); ++i) {
+    slice_scheds[i].algo = make_sched_algo(slices->slices[i].sched, *cc_cfg);
+  }
+  slice_algorithm_e type = slices->slices[0].params.type;
+  if (type == SLICE_ALG_SM_V0_STATIC) {
+    logger.info("SCHED: Using static slicing with %zd slices for cc=%d", slice_scheds.size(), enb_cc_idx);
+  } else if (type == SLICE_ALG_SM_V0_EDF) {
+    edf_sched.reset(new sched_slice_edf{});
+    edf_sched->set_slices(slices->slices);
+    logger.info("SCHED: Using EDF slicing with %zd slices for cc=%d", slice_scheds.size(), enb_cc_idx);
+  } else {
+    nvs_sched.reset(new sched_slice_nvs{cc_cfg->nof_rbgs});
+    nvs_sched->set_slices(slices->slices);
+    logger.info("SCHED: Using %s slicing with %zd slices for cc=%d",
+                type == SLICE_ALG_SM_V0_NVS ? "NVS" : "SCN19",
+                slice_scheds.size(),
+                enb_cc_idx);
+  }
+  set_ul_slices();
+}
+
+void sched::carrier_sched::set_ul_slices()
+{
+  if (slices->ul_slices.empty()) {
+    return;
+  }
+  ul_slice_scheds.resize(slices->ul_slices.size());
+  for (uint32_t i = 0; i < slices->ul_slices.size(); ++i) {
+    ul_slice_scheds[i].algo = make_sched_algo(slices->ul_slices[i].sched, *cc_cfg);
+  }
+  slice_algorithm_e type = slices->ul_slices[0].params.type;
+  if (type == SLICE_ALG_SM_V0_STATIC) {
+    logger.info("SCHED: Using static UL slicing with %zd slices for cc=%d", ul_slice_scheds.size(), enb_cc_idx);
+  } else if (type == SLICE_ALG_SM_V0_EDF) {
+    ul_edf_sched.reset(new sched_slice_edf{true});
+    ul_edf_sched->set_slices(slices->ul_slices);
+    logger.info("SCHED: Using EDF UL slicing with %zd slices for cc=%d", ul_slice_scheds.size(), enb_cc_idx);
+  } else {
+    ul_nvs_sched.reset(new sched_slice_nvs{cc_cfg->nof_prb()});
+    ul_nvs_sched->set_slices(slices->ul_slices);
+    logger.info("SCHED: Using %s UL slicing with %zd slices for cc=%d",
+                type == SLICE_ALG_SM_V0_NVS ? "NVS" : "SCN19",
+                ul_slice_scheds.size(),
+                enb_cc_idx);
+  }
+}
+
+void sched::carrier_sched::update_ue_subsets()
+{
+  sched_ues.clear();
+  for (slice_sched_t& slice : slice_scheds) {
+    slice.ues.clear();
+  }
+  for (slice_sched_t& slice : ul_slice_scheds) {
+    slice.ues.clear();
+  }
+  for (auto& u : *ue_db) {
+    sched_ue*            user     = u.second.get();
+    const sched_slice_t* ul_slice = user->get_ul_slice();
+    if (ul_slice != nullptr and not ul_slice_scheds.empty()) {
+      int slice_idx = slices->find_ul_slice(ul_slice->id);
+      if (slice_idx >= 0) {
+        ul_slice_scheds[slice_idx].ues.insert(u.first, user);
+      }
+    }
+    const sched_slice_t* slice = user->get_slice();
+    if (slice != nullptr and not slice_scheds.empty()) {
+      int slice_idx = slices->find_slice(slice->id);
+      if (slice_idx >= 0) {
+        slice_scheds[slice_idx].ues.insert(u.first, user);
+        continue;
+      }
+    }
+    sched_ues.insert(u.first, user);
+  }
+}
+
 sf_sched* sched::carrier_sched::get_sf_sched(tti_point tti_rx)
 {
   sf_sched* ret = &sf_scheds[tti_rx.to_uint()];
@@ -327,6 +327,8 @@ void sf_sched::new_tti(tti_point tti_rx_, sf_sched_result* cc_results_)
   rar_allocs.clear();
   data_allocs.clear();
   ul_data_allocs.clear();
+  clear_dl_user_restriction();
+  clear_ul_user_restriction();
 
   tti_rx = tti_rx_;
   tti_alloc.new_tti(tti_rx_);
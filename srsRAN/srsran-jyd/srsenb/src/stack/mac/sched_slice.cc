@@ -0,0 +1,175 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched_slice.h"
+#include <algorithm>
+
+namespace srsenb {
+
+int sched_slice_table::find_slice(const std::vector<sched_slice_t>& list, uint32_t slice_id)
+{
+  auto it = std::lower_bound(list.begin(), list.end(), slice_id, [](const sched_slice_t& s, uint32_t id) {
+    return s.id < id;
+  });
+  if (it == list.end() or it->id != slice_id) {
+    return -1;
+  }
+  return static_cast<int>(it - list.begin());
+}
+
+/// Static slices own the RBGs [pos_low, pos_high) in DL and the PRBs spanned by the same RBGs in UL
+static bool set_static_slice_cc(const static_slice_t& sta, uint32_t nof_prb, sched_slice_cc_t& cc)
+{
+  uint32_t nof_rbgs = cell_nof_prb_to_rbg(nof_prb);
+  if (sta.pos_low > sta.pos_high or sta.pos_high > nof_rbgs) {
+    return false;
+  }
+  rbg_interval rbgs{sta.pos_low, sta.pos_high};
+  prb_interval prbs = prb_interval::rbgs_to_prbs(rbgs, nof_prb);
+
+  cc.dl_mask.resize(nof_rbgs);
+  cc.dl_mask.fill(0, nof_rbgs);
+  cc.dl_mask.fill(rbgs.start(), rbgs.stop(), false);
+  cc.ul_mask.resize(nof_prb);
+  cc.ul_mask.fill(0, nof_prb);
+  cc.ul_mask.fill(prbs.start(), prbs.stop(), false);
+  return true;
+}
+
+/// Static UL slices own the PRBs [pos_low, pos_high)
+static bool set_static_ul_slice_cc(const static_slice_t& sta, uint32_t nof_prb, sched_slice_cc_t& cc)
+{
+  if (sta.pos_low > sta.pos_high or sta.pos_high > nof_prb) {
+    return false;
+  }
+  cc.ul_mask.resize(nof_prb);
+  cc.ul_mask.fill(0, nof_prb);
+  cc.ul_mask.fill(sta.pos_low, sta.pos_high, false);
+  return true;
+}
+
+/// RBG window of the slice, or nullptr if the slice can use the whole carrier
+static const static_slice_t* get_static_window(const slice_params_t& params)
+{
+  if (params.type == SLICE_ALG_SM_V0_STATIC) {
+    return &params.u.sta;
+  }
+  if (params.type == SLICE_ALG_SM_V0_SCN19 and params.u.scn19.conf == SLICE_SCN19_SM_V0_FIXED) {
+    return &params.u.scn19.u.fixed;
+  }
+  return nullptr;
+}
+
+bool sched_slice_table::set_cells(const std::vector<uint32_t>& cells_nof_prb)
+{
+  for (sched_slice_t& slice : slices) {
+    slice.cc.clear();
+    const static_slice_t* sta = get_static_window(slice.params);
+    if (sta == nullptr) {
+      continue;
+    }
+    slice.cc.resize(cells_nof_prb.size());
+    for (uint32_t cc = 0; cc < cells_nof_prb.size(); ++cc) {
+      if (not set_static_slice_cc(*sta, cells_nof_prb[cc], slice.cc[cc])) {
+        return false;
+      }
+    }
+  }
+  for (sched_slice_t& slice : ul_slices) {
+    slice.cc.clear();
+    const static_slice_t* sta = get_static_window(slice.params);
+    if (sta == nullptr) {
+      continue;
+    }
+    slice.cc.resize(cells_nof_prb.size());
+    for (uint32_t cc = 0; cc < cells_nof_prb.size(); ++cc) {
+      if (not set_static_ul_slice_cc(*sta, cells_nof_prb[cc], slice.cc[cc])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Counters of the slice with the given id in the DL or UL slices of the table, or nullptr
+static std::shared_ptr<sched_slice_stats_t> find_stats(const sched_slice_table& table, uint32_t slice_id)
+{
+  int idx = table.find_slice(slice_id);
+  if (idx >= 0 and table.slices[idx].stats != nullptr) {
+    return table.slices[idx].stats;
+  }
+  idx = table.find_ul_slice(slice_id);
+  if (idx >= 0 and table.ul_slices[idx].stats != nullptr) {
+    return table.ul_slices[idx].stats;
+  }
+  return nullptr;
+}
+
+void sched_slice_table::set_stats(const sched_slice_table& prev)
+{
+  for (sched_slice_t& slice : slices) {
+    slice.stats = find_stats(prev, slice.id);
+    if (slice.stats == nullptr) {
+      slice.stats = std::make_shared<sched_slice_stats_t>();
+    }
+  }
+  // UL slices share the counters of the DL slice with the same id
+  for (sched_slice_t& slice : ul_slices) {
+    int dl_idx  = find_slice(slice.id);
+    slice.stats = dl_idx >= 0 ? slices[dl_idx].stats : find_stats(prev, slice.id);
+    if (slice.stats == nullptr) {
+      slice.stats = std::make_shared<sched_slice_stats_t>();
+    }
+  }
+}
+
+sched_slice_db::sched_slice_db()
+{
+  // Start with an empty table, so that the scheduler always has a valid active table
+  tables.emplace_back(new sched_slice_table{});
+  active_table = tables.back().get();
+}
+
+void sched_slice_db::publish(std::unique_ptr<sched_slice_table> table)
+{
+  table->version = ++next_version;
+  tables.push_back(std::move(table));
+  pending.store(tables.back().get(), std::memory_order_release);
+
+  // Release the tables that the scheduler can no longer reference. Always keep the last published table.
+  uint32_t cur_version = active_version.load(std::memory_order_acquire);
+  while (tables.size() > 1 and tables.front()->version < cur_version) {
+    tables.pop_front();
+  }
+}
+
+bool sched_slice_db::new_tti()
+{
+  sched_slice_table* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+  if (next == nullptr) {
+    return false;
+  }
+  active_table = next;
+  active_version.store(next->version, std::memory_order_release);
+  return true;
+}
+
+} // namespace srsenb
@@ -416,22 +416,6 @@ int sched_ue::generate_format1a(uint32_t                          pid,
   return generate_format1_common(pid, data, tti_tx_dl, enb_cc_idx, cfi, user_mask);
 }
 
-void sched_ue::metrics_read(mac_ue_metrics_t& metrics)
-{
-  sched_ue_cell& pcell  = cells[cfg.supported_cc_list[0].enb_cc_idx];
-  // metrics.ul_snr_offset = pcell.get_ul_snr_offset();
-  // metrics.dl_cqi_offset = pcell.get_dl_cqi_offset();
-  // metrics.allocated_rb = allocatedRbs.value();
-  if(alloc_rbs > total_prbs)
-    metrics.allocated_prbs = 0;
-  else
-    metrics.allocated_prbs = alloc_rbs;
-    
-  metrics.tti = tti_track.to_uint();
-  std::lock_guard<std::mutex> lock(rb_mutex);
-  allocatedRbs.reset();
-}
-
 int sched_ue::generate_format1_common(uint32_t                          pid,
                                       sched_interface::dl_sched_data_t* data,
                                       tti_point                         tti_tx_dl,
@@ -575,18 +559,11 @@ int sched_ue::generate_format2a(uint32_t                          pid,
 
   int ret = data->tbs[0] + data->tbs[1];
 
-  alloc_rbs = count_prb_per_tb(user_mask);
-  total_prbs =  cell_nof_rbg_to_prb(user_mask.size());
-
-  // std::cout << "Number of Allocated Prbs: " << alloc_rbs << std::endl;
-  std::lock_guard<std::mutex> lock(rb_mutex);
-  // if(allocatedRbs.count() >= 20)
-  // {
-  //   allocatedRbs.reset();
-  // }
-  allocatedRbs.push(alloc_rbs);
-  tti_track = tti_tx_dl;
-
+  if (dl_alloc_metric != nullptr) {
+    uint32_t alloc_rbs  = count_prb_per_tb(user_mask);
+    uint32_t total_prbs = cell_nof_rbg_to_prb(user_mask.size());
+    dl_alloc_metric->store(dl_alloc_pack(alloc_rbs > total_prbs ? 0 : alloc_rbs, tti_tx_dl), std::memory_order_relaxed);
+  }
 
   return ret;
 }
@@ -1096,10 +1073,6 @@ int sched_ue::enb_to_ue_cc_idx(uint32_t enb_cc_idx) const
   return enb_cc_idx < cells.size() ? cells[enb_cc_idx].get_ue_cc_idx() : -1;
 }
 
-void sched_ue::set_slice_id(int slice_id)
-{
-  slice_id_ = slice_id;
-}
 void sched_ue::set_low_pos(size_t low_pos)
 {
   assert(low_pos < 14 && "Only true for 5 MHz");
@@ -1112,11 +1085,6 @@ void sched_ue::set_high_pos(size_t high_pos)
   high_pos_ = high_pos;
 }
 
-int sched_ue::slice_id(void)
-{
-  return slice_id_;
-}
-
 size_t sched_ue::low_pos(void)
 {
   return low_pos_;
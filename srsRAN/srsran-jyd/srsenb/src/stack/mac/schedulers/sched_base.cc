@@ -59,86 +59,59 @@ const dl_harq_proc* get_dl_newtx_harq(sched_ue& user, sf_sched* tti_sched)
   return user.get_empty_dl_harq(tti_sched->get_tti_tx_dl(), tti_sched->get_enb_cc_idx());
 }
 
+rbgmask_t get_ue_dl_mask(const sf_sched& tti_sched, const sched_ue& ue)
+{
+  rbgmask_t            mask  = tti_sched.get_dl_mask();
+  const sched_slice_t* slice = ue.get_slice();
+  if (slice != nullptr) {
+    const sched_slice_cc_t* slice_cc = slice->get_cc(tti_sched.get_enb_cc_idx());
+    if (slice_cc != nullptr and slice_cc->dl_mask.size() == mask.size()) {
+      mask |= slice_cc->dl_mask;
+    }
+  }
+  const rbgmask_t& restriction = tti_sched.get_dl_user_restriction();
+  if (restriction.size() == mask.size()) {
+    mask |= restriction;
+  }
+  return mask;
+}
+
 alloc_result try_dl_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const dl_harq_proc& h)
 {
-  // Try to reuse the same mask
-  rbgmask_t    retx_mask = h.get_rbgmask();
-  alloc_result code      = tti_sched.alloc_dl_user(&ue, retx_mask, h.get_id());
-  if (code != alloc_result::sch_collision) {
-    return code;
+  // Try to reuse the same mask, if it is still inside the RBGs of the UE slice and of the user restriction
+  rbgmask_t ue_mask   = get_ue_dl_mask(tti_sched, ue);
+  rbgmask_t retx_mask = h.get_rbgmask();
+  if ((retx_mask & ue_mask).none()) {
+    alloc_result code = tti_sched.alloc_dl_user(&ue, retx_mask, h.get_id());
+    if (code != alloc_result::sch_collision) {
+      return code;
+    }
   }
 
   // If previous mask does not fit, find another with exact same number of rbgs
   size_t nof_rbg             = retx_mask.count();
   bool   is_contiguous_alloc = ue.get_dci_format() == SRSRAN_DCI_FORMAT1A;
-  retx_mask                  = find_available_rbgmask(nof_rbg, is_contiguous_alloc, tti_sched.get_dl_mask());
+  retx_mask                  = find_available_rbgmask(nof_rbg, is_contiguous_alloc, ue_mask);
   if (retx_mask.count() == nof_rbg) {
     return tti_sched.alloc_dl_user(&ue, retx_mask, h.get_id());
   }
   return alloc_result::sch_collision;
 }
 
-int cmpfunc(const void* a, const void* b)
-{
-  const fr_slice_t* slice_x = (fr_slice_t*) a;
-  const fr_slice_t* slice_y = (fr_slice_t*) b;
-  const int* x = (int*) &slice_x->id;
-  const int* y = (int*) &slice_y->id;
-  return (*x - *y);
-}
-
 alloc_result try_dl_newtx_alloc_greedy(sf_sched& tti_sched, sched_ue& ue, const dl_harq_proc& h, rbgmask_t* result_mask)
 {
   if (result_mask != nullptr) {
     *result_mask = {};
   }
 
-  // Get slice stats
-  Slicing &slice_stats = Slicing::getInstance();
-  ul_dl_slice_conf_t* stats_dl = &slice_stats.stats_slice_conf.dl;
-  ue_slice_conf_t* stats_ue_s = &slice_stats.stats_ue_slice_conf;
-
-  // If no slice in enb, schedule UE by orginal RBG mask
-  rbgmask_t slice_mask = tti_sched.get_dl_mask();
-
-  // If slice is enabled in enb, check UE associated slice id exists
-  int idx = ue.slice_id();
-  #ifdef ENABLE_SLICER
-    uint64_t ue_imsi = imsiTracker.find_imsi(ue.get_rnti());
-    if(ue_imsi > 0)
-    {
-      idx = (int) (ue_imsi % 3);
-      //int idx2 = (int) (ue_imsi % 3);
-      // printf("[slicer] UE: %015" PRIu64 " associated to slice id: %d\n", ue_imsi, idx);
-    }
-    else
-      idx = -1;
-  #endif
-  // int idx = 2;
-  if (stats_dl->len_slices > 0 && idx >= 0) {
-    // Get currently slice pointer by binary search
-    fr_slice_t* pslice = (fr_slice_t*) std::bsearch(&idx, stats_dl->slices, stats_dl->len_slices, sizeof(stats_dl->slices[0]), cmpfunc);
-    // if slice exists, get algo data
-    if (pslice) {
-      static_slice_t* sta = &pslice->params.u.sta;
-      // if current ue associated to slice, schedule UE by the RBG mask with static slice algo
-      if (idx != -1) {
-        size_t l1 = sta->pos_low;
-        size_t l2 = sta->pos_high;
-        // mark already used RB
-        slice_mask.fill(0, l1, true);
-        slice_mask.fill(l2, 13, true); // TODO: Get DL PRB (n_prb) from config
-      }
-    }
-  }
+  // If UE is associated to a slice, the RBGs outside the slice are seen as occupied
+  rbgmask_t current_mask = get_ue_dl_mask(tti_sched, ue);
 
   // If all RBGs are occupied, the next steps can be shortcut
-  if (slice_mask.all()) {
+  if (current_mask.all()) {
     return alloc_result::no_sch_space;
   }
 
-  const rbgmask_t& current_mask = slice_mask;
-
   // If there is no data to transmit, no need to allocate
   srsran::interval<uint32_t> req_bytes = ue.get_requested_dl_bytes(tti_sched.get_enb_cc_idx());
   if (req_bytes.stop() == 0) {
@@ -202,6 +175,23 @@ const ul_harq_proc* get_ul_newtx_harq(sched_ue& user, sf_sched* tti_sched)
   return h->is_empty() ? h : nullptr;
 }
 
+prbmask_t get_ue_ul_mask(const sf_sched& tti_sched, const sched_ue& ue)
+{
+  prbmask_t            mask  = tti_sched.get_ul_mask();
+  const sched_slice_t* slice = ue.get_ul_slice();
+  if (slice != nullptr) {
+    const sched_slice_cc_t* slice_cc = slice->get_cc(tti_sched.get_enb_cc_idx());
+    if (slice_cc != nullptr and slice_cc->ul_mask.size() == mask.size()) {
+      mask |= slice_cc->ul_mask;
+    }
+  }
+  const prbmask_t& restriction = tti_sched.get_ul_user_restriction();
+  if (restriction.size() == mask.size()) {
+    mask |= restriction;
+  }
+  return mask;
+}
+
 alloc_result try_ul_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const ul_harq_proc& h)
 {
   prb_interval alloc = h.get_alloc();
@@ -211,7 +201,8 @@ alloc_result try_ul_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const ul_harq_
   }
 
   // If can schedule the same mask as in earlier tx, do it
-  if (not tti_sched.get_ul_mask().any(alloc.start(), alloc.stop())) {
+  prbmask_t ul_mask = get_ue_ul_mask(tti_sched, ue);
+  if (not ul_mask.any(alloc.start(), alloc.stop())) {
     alloc_result ret = tti_sched.alloc_ul_user(&ue, alloc);
     if (ret != alloc_result::sch_collision) {
       return ret;
@@ -223,7 +214,7 @@ alloc_result try_ul_retx_alloc(sf_sched& tti_sched, sched_ue& ue, const ul_harq_
     return alloc_result::no_rnti_opportunity;
   }
   uint32_t nof_prbs = alloc.length();
-  alloc             = find_contiguous_ul_prbs(nof_prbs, tti_sched.get_ul_mask());
+  alloc             = find_contiguous_ul_prbs(nof_prbs, ul_mask);
   if (alloc.length() != nof_prbs) {
     return alloc_result::no_sch_space;
   }
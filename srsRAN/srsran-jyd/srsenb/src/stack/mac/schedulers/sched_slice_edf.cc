@@ -0,0 +1,117 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_edf.h"
+#include <algorithm>
+
+namespace srsenb {
+
+bool sched_slice_edf::validate(const std::vector<sched_slice_t>& slices, const std::vector<uint32_t>& cells_nof_prb)
+{
+  float prbs_per_tti = 0;
+  for (const sched_slice_t& slice : slices) {
+    if (slice.params.type != SLICE_ALG_SM_V0_EDF) {
+      return false;
+    }
+    const edf_slice_t& edf = slice.params.u.edf;
+    if (edf.deadline == 0 or edf.guaranteed_prbs == 0) {
+      return false;
+    }
+    prbs_per_tti += static_cast<float>(edf.guaranteed_prbs) / edf.deadline;
+  }
+  // Admission control. The guarantees must hold in every carrier, as the UEs of a slice may be served by any of them
+  for (uint32_t nof_prb : cells_nof_prb) {
+    if (prbs_per_tti > nof_prb) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void sched_slice_edf::set_slices(const std::vector<sched_slice_t>& slices_)
+{
+  slices.clear();
+  slices.resize(slices_.size());
+  for (uint32_t i = 0; i < slices_.size(); ++i) {
+    sched_slice_stats_t* stats = slices_[i].stats.get();
+    slices[i].params           = slices_[i].params.u.edf;
+    if (stats != nullptr) {
+      slices[i].deadline_miss = is_ul ? &stats->ul_deadline_miss : &stats->dl_deadline_miss;
+    }
+    slices[i].tti_left    = slices[i].params.deadline;
+    slices[i].budget_prbs = slices[i].params.guaranteed_prbs;
+  }
+  order.resize(slices.size());
+}
+
+void sched_slice_edf::new_tti()
+{
+  for (slice_ctxt& slice : slices) {
+    if (slice.tti_left == 0) {
+      slice.new_window();
+    }
+    slice.tti_left--;
+  }
+}
+
+const std::vector<uint32_t>& sched_slice_edf::get_order()
+{
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // Slices with budget left go first. Ties are broken in favour of the lowest slice id
+  std::stable_sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+    bool lhs_exhausted = slices[lhs].budget_prbs == 0, rhs_exhausted = slices[rhs].budget_prbs == 0;
+    if (lhs_exhausted != rhs_exhausted) {
+      return rhs_exhausted;
+    }
+    return slices[lhs].tti_left < slices[rhs].tti_left;
+  });
+  return order;
+}
+
+void sched_slice_edf::save_alloc(uint32_t slice_idx, uint32_t alloc_prbs)
+{
+  slice_ctxt& slice = slices[slice_idx];
+  slice.budget_prbs -= std::min(alloc_prbs, slice.budget_prbs);
+}
+
+void sched_slice_edf::save_backlog(uint32_t slice_idx, bool backlogged)
+{
+  slice_ctxt& slice = slices[slice_idx];
+  if (backlogged and slice.budget_prbs > 0) {
+    slice.starved = true;
+  }
+}
+
+void sched_slice_edf::slice_ctxt::new_window()
+{
+  if (starved and budget_prbs > 0 and deadline_miss != nullptr) {
+    deadline_miss->fetch_add(1, std::memory_order_relaxed);
+  }
+  // The budget left can be used in the next window, but the slice cannot accumulate more than max_replenish PRBs
+  uint32_t max_budget = std::max(params.max_replenish, params.guaranteed_prbs);
+  budget_prbs         = std::min(budget_prbs + params.guaranteed_prbs, max_budget);
+  tti_left            = params.deadline;
+  starved             = false;
+}
+
+} // namespace srsenb
@@ -0,0 +1,157 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_nvs.h"
+#include "srsenb/hdr/stack/mac/sched_lte_common.h"
+#include <algorithm>
+#include <limits>
+
+namespace srsenb {
+
+/// Reservation of a slice, as a fraction of the carrier
+static float nvs_reserved_share(const nvs_slice_t& nvs)
+{
+  if (nvs.conf == SLICE_SM_NVS_V0_RATE) {
+    return nvs.u.rate.u1.mbps_required / nvs.u.rate.u2.mbps_reference;
+  }
+  return nvs.u.capacity.u.pct_reserved;
+}
+
+/// Express the reservation of a NVS or SCN19 slice as a NVS reservation. Returns false for SCN19 fixed slices
+static bool to_nvs_slice(const slice_params_t& params, nvs_slice_t& nvs)
+{
+  if (params.type == SLICE_ALG_SM_V0_NVS) {
+    nvs = params.u.nvs;
+    return true;
+  }
+  const scn19_slice_t& scn19 = params.u.scn19;
+  if (scn19.conf == SLICE_SCN19_SM_V0_DYNAMIC) {
+    nvs.conf   = SLICE_SM_NVS_V0_RATE;
+    nvs.u.rate = scn19.u.dynamic;
+    return true;
+  }
+  if (scn19.conf == SLICE_SCN19_SM_V0_ON_DEMAND) {
+    nvs.conf                      = SLICE_SM_NVS_V0_CAPACITY;
+    nvs.u.capacity.u.pct_reserved = scn19.u.on_demand.pct_reserved;
+    return true;
+  }
+  return false;
+}
+
+bool sched_slice_nvs::validate(const std::vector<sched_slice_t>& slices)
+{
+  float total_share = 0;
+  for (const sched_slice_t& slice : slices) {
+    slice_algorithm_e type = slice.params.type;
+    if (type != SLICE_ALG_SM_V0_NVS and type != SLICE_ALG_SM_V0_SCN19) {
+      return false;
+    }
+    nvs_slice_t nvs = {};
+    if (not to_nvs_slice(slice.params, nvs)) {
+      // SCN19 fixed slices are checked against the carriers bandwidth
+      if (slice.params.u.scn19.conf != SLICE_SCN19_SM_V0_FIXED) {
+        return false;
+      }
+      continue;
+    }
+    if (nvs.conf == SLICE_SM_NVS_V0_RATE) {
+      const nvs_rate_t& rate = nvs.u.rate;
+      if (not(rate.u1.mbps_required > 0) or not(rate.u2.mbps_reference >= rate.u1.mbps_required)) {
+        return false;
+      }
+    } else if (nvs.conf == SLICE_SM_NVS_V0_CAPACITY) {
+      float pct = nvs.u.capacity.u.pct_reserved;
+      if (not(pct > 0) or pct > 1) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    total_share += nvs_reserved_share(nvs);
+  }
+  // Admission control. Allow some margin for the float rounding of the reservations
+  return total_share <= 1.001f;
+}
+
+void sched_slice_nvs::set_slices(const std::vector<sched_slice_t>& slices_)
+{
+  slices.clear();
+  slices.resize(slices_.size());
+  for (uint32_t i = 0; i < slices_.size(); ++i) {
+    const slice_params_t& params = slices_[i].params;
+    slices[i].fixed              = not to_nvs_slice(params, slices[i].params);
+    slices[i].avg_coeff          = avg_coeff;
+    if (params.type == SLICE_ALG_SM_V0_SCN19 and params.u.scn19.conf == SLICE_SCN19_SM_V0_ON_DEMAND and
+        params.u.scn19.u.on_demand.tau > 0) {
+      slices[i].avg_coeff = 1.0f / params.u.scn19.u.on_demand.tau;
+    }
+  }
+  order.resize(slices.size());
+}
+
+const std::vector<uint32_t>& sched_slice_nvs::get_order()
+{
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // Ties are broken in favour of the lowest slice id
+  std::stable_sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+    return slices[lhs].weight() > slices[rhs].weight();
+  });
+  return order;
+}
+
+void sched_slice_nvs::save_alloc(uint32_t slice_idx, uint32_t alloc_bytes, uint32_t alloc_rbs)
+{
+  float mbps  = alloc_bytes * 8 / (tti_duration_ms * 1000);
+  float share = nof_rbs > 0 ? static_cast<float>(alloc_rbs) / nof_rbs : 0;
+  slices[slice_idx].save_alloc(mbps, share);
+}
+
+float sched_slice_nvs::slice_ctxt::weight() const
+{
+  // Fixed slices cannot use more than their RBG window, so they are not ranked. Slices that were never served get the
+  // highest priority
+  if (fixed) {
+    return std::numeric_limits<float>::max();
+  }
+  const float min_avg = 1e-6;
+  if (params.conf == SLICE_SM_NVS_V0_RATE) {
+    return params.u.rate.u1.mbps_required / std::max(avg_mbps, min_avg);
+  }
+  return params.u.capacity.u.pct_reserved / std::max(avg_share, min_avg);
+}
+
+void sched_slice_nvs::slice_ctxt::save_alloc(float mbps, float share)
+{
+  const float exp_avg_alpha = avg_coeff;
+  if (nof_samples < 1 / exp_avg_alpha) {
+    // fast start
+    avg_mbps  = avg_mbps + (mbps - avg_mbps) / (nof_samples + 1);
+    avg_share = avg_share + (share - avg_share) / (nof_samples + 1);
+  } else {
+    avg_mbps  = (1 - exp_avg_alpha) * avg_mbps + exp_avg_alpha * mbps;
+    avg_share = (1 - exp_avg_alpha) * avg_share + exp_avg_alpha * share;
+  }
+  nof_samples++;
+}
+
+} // namespace srsenb
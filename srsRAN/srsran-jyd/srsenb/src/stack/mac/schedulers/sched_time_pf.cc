@@ -42,7 +42,7 @@ sched_time_pf::sched_time_pf(const sched_cell_params_t& cell_params_, const sche
   ul_queue = ue_ul_queue_t(ue_ul_prio_compare{}, std::move(ul_storage));
 }
 
-void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::new_tti(sched_ue_subset& ue_db, sf_sched* tti_sched)
 {
   while (not dl_queue.empty()) {
     dl_queue.pop();
@@ -79,7 +79,7 @@ void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
  *                         Dowlink
  *****************************************************************/
 
-void sched_time_pf::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::sched_dl_users(sched_ue_subset& ue_db, sf_sched* tti_sched)
 {
   srsran::tti_point tti_rx{tti_sched->get_tti_rx()};
   if (current_tti_rx != tti_rx) {
@@ -118,7 +118,7 @@ uint32_t sched_time_pf::try_dl_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* t
  *                         Uplink
  *****************************************************************/
 
-void sched_time_pf::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::sched_ul_users(sched_ue_subset& ue_db, sf_sched* tti_sched)
 {
   srsran::tti_point tti_rx{tti_sched->get_tti_rx()};
   if (current_tti_rx != tti_rx) {
@@ -156,7 +156,7 @@ uint32_t sched_time_pf::try_ul_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* t
       return 0;
     }
     uint32_t     pending_rb = ue.get_required_prb_ul(cc_cfg->enb_cc_idx, pending_data);
-    prb_interval alloc      = find_contiguous_ul_prbs(pending_rb, tti_sched->get_ul_mask());
+    prb_interval alloc      = find_contiguous_ul_prbs(pending_rb, get_ue_ul_mask(*tti_sched, ue));
     if (alloc.empty()) {
       return 0;
     }
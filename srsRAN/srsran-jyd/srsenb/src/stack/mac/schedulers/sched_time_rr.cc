@@ -32,7 +32,7 @@ sched_time_rr::sched_time_rr(const sched_cell_params_t& cell_params_, const sche
  *                         Dowlink
  *****************************************************************/
 
-void sched_time_rr::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_rr::sched_dl_users(sched_ue_subset& ue_db, sf_sched* tti_sched)
 {
   if (ue_db.empty()) {
     return;
@@ -44,7 +44,7 @@ void sched_time_rr::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
   sched_dl_newtxs(ue_db, tti_sched, priority_idx);
 }
 
-void sched_time_rr::sched_dl_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_dl_retxs(sched_ue_subset& ue_db, sf_sched* tti_sched, size_t prio_idx)
 {
   auto iter = ue_db.begin();
   std::advance(iter, prio_idx);
@@ -62,7 +62,7 @@ void sched_time_rr::sched_dl_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, si
   }
 }
 
-void sched_time_rr::sched_dl_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_dl_newtxs(sched_ue_subset& ue_db, sf_sched* tti_sched, size_t prio_idx)
 {
   auto iter = ue_db.begin();
   std::advance(iter, prio_idx);
@@ -89,7 +89,7 @@ void sched_time_rr::sched_dl_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, s
  *                         Uplink
  *****************************************************************/
 
-void sched_time_rr::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_rr::sched_ul_users(sched_ue_subset& ue_db, sf_sched* tti_sched)
 {
   if (ue_db.empty()) {
     return;
@@ -100,7 +100,7 @@ void sched_time_rr::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
   sched_ul_newtxs(ue_db, tti_sched, priority_idx);
 }
 
-void sched_time_rr::sched_ul_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_ul_retxs(sched_ue_subset& ue_db, sf_sched* tti_sched, size_t prio_idx)
 {
   auto iter = ue_db.begin();
   std::advance(iter, prio_idx);
@@ -121,7 +121,7 @@ void sched_time_rr::sched_ul_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, si
   }
 }
 
-void sched_time_rr::sched_ul_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_ul_newtxs(sched_ue_subset& ue_db, sf_sched* tti_sched, size_t prio_idx)
 {
   auto iter = ue_db.begin();
   std::advance(iter, prio_idx);
@@ -141,7 +141,7 @@ void sched_time_rr::sched_ul_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, s
       continue;
     }
     uint32_t     pending_rb = user.get_required_prb_ul(cc_cfg->enb_cc_idx, pending_data);
-    prb_interval alloc      = find_contiguous_ul_prbs(pending_rb, tti_sched->get_ul_mask());
+    prb_interval alloc      = find_contiguous_ul_prbs(pending_rb, get_ue_ul_mask(*tti_sched, user));
     if (alloc.empty()) {
       continue;
     }
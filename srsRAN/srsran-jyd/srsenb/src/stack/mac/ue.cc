@@ -606,7 +606,7 @@ uint8_t* ue::generate_mch_pdu(uint32_t                             harq_pid,
 }
 
 /******* METRICS interface ***************/
-void ue::metrics_read(mac_ue_metrics_t* metrics_)
+void ue::metrics_read(mac_ue_metrics_t* metrics_, bool restart_averages)
 {
   // std::cout << "dl_ri: " << metrics_->dl_ri << std::endl;
 
@@ -628,8 +628,10 @@ void ue::metrics_read(mac_ue_metrics_t* metrics_)
   // std::cout << "ue metrics: " << ue_metrics.dl_ri << std::endl;
   // std::cout << "dl_ri2: " << metrics_->dl_ri << std::endl;
 
-  phr_counter    = 0;
-  dl_cqi_counter = 0;
+  if (restart_averages) {
+    phr_counter    = 0;
+    dl_cqi_counter = 0;
+  }
   // ue_metrics     = {};
 
 }
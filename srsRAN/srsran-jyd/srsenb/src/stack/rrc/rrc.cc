@@ -146,6 +146,11 @@ void rrc::stop()
   Public functions
 *******************************************************************************/
 
+void rrc::get_kpm_counters(kpm_counters_t* c)
+{
+  c->rrc_conn_ue_us = kpm_counters.conn_ue_us();
+}
+
 void rrc::get_metrics(rrc_metrics_t& m)
 {
   if (running) {
@@ -243,6 +248,7 @@ int rrc::add_user(uint16_t rnti, const sched_interface::ue_cfg_t& sched_ue_cfg)
         return SRSRAN_ERROR;
       }
       users.insert(std::make_pair(rnti, std::move(u)));
+      kpm_counters.add_ue();
     }
     rlc->add_user(rnti);
     pdcp->add_user(rnti);
@@ -716,6 +722,7 @@ void rrc::rem_user(uint16_t rnti)
     pdcp->rem_user(rnti);
 
     users.erase(rnti);
+    kpm_counters.rem_ue();
 
     srsran::console("Disconnecting rnti=0x%x.\n", rnti);
     logger.info("Removed user rnti=0x%x", rnti);
@@ -272,6 +272,18 @@ void pdcp::get_metrics(pdcp_metrics_t& m, const uint32_t nof_tti)
   size_t count = 0;
   for (auto& user : users) {
     user.second.pdcp->get_metrics(m.ues[count], nof_tti);
+    m.ues[count].rnti = user.first;
+    count++;
+  }
+}
+
+void pdcp::get_cumulative_metrics(pdcp_metrics_t& m)
+{
+  m.ues.resize(users.size());
+  size_t count = 0;
+  for (auto& user : users) {
+    user.second.pdcp->get_cumulative_metrics(m.ues[count]);
+    m.ues[count].rnti = user.first;
     count++;
   }
 }
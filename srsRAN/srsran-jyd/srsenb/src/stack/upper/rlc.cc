@@ -57,11 +57,29 @@ void rlc::get_metrics(rlc_metrics_t& m, const uint32_t nof_tti)
   size_t count = 0;
   for (auto& user : users) {
     user.second.rlc->get_metrics(m.ues[count], nof_tti);
+    m.ues[count].rnti = user.first;
     // printf("RLC metrics for RNTI 0x%x, num_tx_sdu_bytes: %ld\n", user.first, m.ues[count].bearer[3].num_tx_sdu_bytes);
     count++;
   }
 }
 
+void rlc::get_cumulative_metrics(rlc_metrics_t& m)
+{
+  m.ues.resize(users.size());
+  size_t count = 0;
+  for (auto& user : users) {
+    user.second.rlc->get_cumulative_metrics(m.ues[count]);
+    m.ues[count].rnti = user.first;
+    count++;
+  }
+}
+
+void rlc::get_kpm_counters(kpm_counters_t* c)
+{
+  c->rlc_dl_sdu_delay_us = drb_tx_delay.sum_us.load(std::memory_order_relaxed);
+  c->rlc_dl_sdus         = drb_tx_delay.nof_sdus.load(std::memory_order_relaxed);
+}
+
 void rlc::add_user(uint16_t rnti)
 {
   pthread_rwlock_wrlock(&rwlock);
@@ -74,6 +92,7 @@ void rlc::add_user(uint16_t rnti)
               [rnti, this](uint32_t lcid, uint32_t tx_queue, uint32_t retx_queue) {
                 update_bsr(rnti, lcid, tx_queue, retx_queue);
               });
+    obj->set_tx_delay_counter(&drb_tx_delay);
     users[rnti].rnti   = rnti;
     users[rnti].pdcp   = pdcp;
     users[rnti].rrc    = rrc;
@@ -271,6 +290,17 @@ bool rlc::sdu_queue_is_full(uint16_t rnti, uint32_t lcid)
   return ret;
 }
 
+uint32_t rlc::get_buffer_state(uint16_t rnti, uint32_t lcid)
+{
+  uint32_t ret = 0;
+  pthread_rwlock_rdlock(&rwlock);
+  if (users.count(rnti)) {
+    ret = users[rnti].rlc->get_buffer_state(lcid);
+  }
+  pthread_rwlock_unlock(&rwlock);
+  return ret;
+}
+
 void rlc::user_interface::max_retx_attempted()
 {
   rrc->max_retx_attempted(rnti);
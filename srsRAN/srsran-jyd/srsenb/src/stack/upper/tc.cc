@@ -0,0 +1,1029 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/upper/tc.h"
+#include "srsran/common/common_lte.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+namespace srsenb {
+
+int64_t tc_now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*******************************************************************************
+ *  Meter
+ *******************************************************************************/
+
+void tc_meter::set_window(uint32_t window_ms_)
+{
+  window_ms  = std::max(window_ms_, 1u);
+  start_us   = 0;
+  cur_bytes  = 0;
+  prev_bytes = 0;
+}
+
+void tc_meter::advance(int64_t now_us)
+{
+  if (start_us == 0) {
+    start_us = now_us;
+    return;
+  }
+  int64_t window_us = window_ms * 1000;
+  int64_t elapsed   = now_us - start_us;
+  if (elapsed < window_us) {
+    return;
+  }
+  prev_bytes = elapsed < 2 * window_us ? cur_bytes : 0;
+  cur_bytes  = 0;
+  start_us += (elapsed / window_us) * window_us;
+}
+
+void tc_meter::add(uint32_t bytes, int64_t now_us)
+{
+  advance(now_us);
+  cur_bytes += bytes;
+}
+
+float tc_meter::rate_kbps(int64_t now_us)
+{
+  advance(now_us);
+  // Sliding window: the part of the previous window still covered, plus the current one
+  double frac  = (double)(now_us - start_us) / (window_ms * 1000);
+  double bytes = prev_bytes * (1.0 - frac) + cur_bytes;
+  return bytes * 8 / window_ms;
+}
+
+/*******************************************************************************
+ *  Queue
+ *******************************************************************************/
+
+void tc_queue_stats_t::merge(const tc_queue_stats_t& other)
+{
+  bytes_fwd += other.bytes_fwd;
+  pkts_fwd += other.pkts_fwd;
+  dropped_pkts += other.dropped_pkts;
+  marked_pkts += other.marked_pkts;
+  sojourn_sum_us += other.sojourn_sum_us;
+  sojourn_pkts += other.sojourn_pkts;
+  last_sojourn_us = std::max(last_sojourn_us, other.last_sojourn_us);
+  plc_dropped_pkts += other.plc_dropped_pkts;
+  plc_deviated_pkts += other.plc_deviated_pkts;
+}
+
+tc_queue::tc_queue(uint32_t id_, tc_queue_e type_, uint32_t target_ms, uint32_t interval_ms) : id(id_)
+{
+  configure(type_, target_ms, interval_ms);
+}
+
+void tc_queue::configure(tc_queue_e type_, uint32_t target_ms, uint32_t interval_ms)
+{
+  type        = type_;
+  target_us   = target_ms > 0 ? target_ms * 1000 : 5000;
+  interval_us = interval_ms > 0 ? interval_ms * 1000 : 100000;
+
+  first_above_time = 0;
+  drop_next        = 0;
+  count            = 0;
+  lastcount        = 0;
+  dropping         = false;
+}
+
+bool tc_queue::push(srsran::unique_byte_buffer_t sdu, int64_t enq_us)
+{
+  if (pkts.size() >= max_pkts) {
+    stats.dropped_pkts++;
+    return false;
+  }
+  nof_bytes += sdu->N_bytes;
+  pkts.emplace_back(enq_us, std::move(sdu));
+  return true;
+}
+
+std::deque<std::pair<int64_t, srsran::unique_byte_buffer_t> > tc_queue::take_all()
+{
+  std::deque<std::pair<int64_t, srsran::unique_byte_buffer_t> > ret;
+  ret.swap(pkts);
+  nof_bytes = 0;
+  return ret;
+}
+
+tc_queue::deq_result_t tc_queue::do_dequeue(int64_t now_us)
+{
+  static const uint32_t mtu = 1500;
+
+  deq_result_t r;
+  if (pkts.empty()) {
+    first_above_time = 0;
+    return r;
+  }
+  r.enq_us = pkts.front().first;
+  r.sdu    = std::move(pkts.front().second);
+  pkts.pop_front();
+  nof_bytes -= r.sdu->N_bytes;
+
+  if (type == TC_QUEUE_FIFO) {
+    return r;
+  }
+  int64_t sojourn = now_us - r.enq_us;
+  if (sojourn < target_us or nof_bytes <= mtu) {
+    first_above_time = 0;
+  } else if (first_above_time == 0) {
+    first_above_time = now_us + interval_us;
+  } else if (now_us >= first_above_time) {
+    r.ok_to_drop = true;
+  }
+  return r;
+}
+
+bool tc_queue::drop_or_mark(srsran::unique_byte_buffer_t& sdu)
+{
+  if (type == TC_QUEUE_ECN_CODEL and tc_mark_ecn_ce(sdu.get())) {
+    stats.marked_pkts++;
+    return false;
+  }
+  stats.dropped_pkts++;
+  sdu.reset();
+  return true;
+}
+
+int64_t tc_queue::control_law(int64_t t) const
+{
+  return t + (int64_t)(interval_us / std::sqrt((double)count));
+}
+
+srsran::unique_byte_buffer_t tc_queue::pop(int64_t now_us)
+{
+  deq_result_t r = do_dequeue(now_us);
+  if (r.sdu == nullptr) {
+    dropping = false;
+    return nullptr;
+  }
+
+  if (type != TC_QUEUE_FIFO) {
+    if (dropping) {
+      if (not r.ok_to_drop) {
+        // sojourn time below target, leave the drop state
+        dropping = false;
+      }
+      while (dropping and now_us >= drop_next) {
+        count++;
+        if (not drop_or_mark(r.sdu)) {
+          drop_next = control_law(drop_next);
+          break;
+        }
+        r = do_dequeue(now_us);
+        if (r.sdu == nullptr) {
+          dropping = false;
+          return nullptr;
+        }
+        if (not r.ok_to_drop) {
+          dropping = false;
+        } else {
+          drop_next = control_law(drop_next);
+        }
+      }
+    } else if (r.ok_to_drop) {
+      if (drop_or_mark(r.sdu)) {
+        r = do_dequeue(now_us);
+      }
+      dropping = true;
+      // Start close to the previous drop rate if the drop state was left recently
+      uint32_t delta = count - lastcount;
+      count          = (delta > 1 and now_us - drop_next < 16 * interval_us) ? delta : 1;
+      drop_next      = control_law(now_us);
+      lastcount      = count;
+      if (r.sdu == nullptr) {
+        return nullptr;
+      }
+    }
+  }
+
+  int64_t sojourn = now_us - r.enq_us;
+  stats.pkts_fwd++;
+  stats.bytes_fwd += r.sdu->N_bytes;
+  stats.sojourn_sum_us += sojourn;
+  stats.sojourn_pkts++;
+  stats.last_sojourn_us = sojourn;
+  return std::move(r.sdu);
+}
+
+bool tc_mark_ecn_ce(srsran::byte_buffer_t* sdu)
+{
+  uint8_t* ip = sdu->msg;
+  if (sdu->N_bytes < 1) {
+    return false;
+  }
+  switch (ip[0] >> 4) {
+    case 4: {
+      uint32_t ihl = (ip[0] & 0x0f) * 4;
+      if (ihl < 20 or sdu->N_bytes < ihl or (ip[1] & 0x03) == 0) {
+        return false;
+      }
+      ip[1] |= 0x03;
+      // Recompute the header checksum
+      ip[10]       = 0;
+      ip[11]       = 0;
+      uint32_t sum = 0;
+      for (uint32_t i = 0; i < ihl; i += 2) {
+        sum += (ip[i] << 8) | ip[i + 1];
+      }
+      while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+      }
+      sum    = ~sum & 0xffff;
+      ip[10] = sum >> 8;
+      ip[11] = sum & 0xff;
+      return true;
+    }
+    case 6:
+      if (sdu->N_bytes < 40 or (ip[1] & 0x30) == 0) {
+        return false;
+      }
+      ip[1] |= 0x30;
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*******************************************************************************
+ *  Classifier
+ *******************************************************************************/
+
+bool tc_osi_filter_match(const tc_osi_filter_t& flt, const srsran::byte_buffer_t* sdu)
+{
+  const uint8_t* ip      = sdu->msg;
+  bool           is_ipv4 = false;
+  uint32_t       saddr = 0, daddr = 0;
+  uint8_t        proto     = 0;
+  uint32_t       l4_offset = 0;
+  bool           has_ports = false;
+
+  if (sdu->N_bytes >= 20 and (ip[0] >> 4) == 4) {
+    is_ipv4   = true;
+    l4_offset = (ip[0] & 0x0f) * 4;
+    proto     = ip[9];
+    memcpy(&saddr, &ip[12], sizeof(saddr));
+    memcpy(&daddr, &ip[16], sizeof(daddr));
+    // only the first fragment carries the L4 header
+    has_ports = ((ip[6] & 0x1f) | ip[7]) == 0;
+  } else if (sdu->N_bytes >= 40 and (ip[0] >> 4) == 6) {
+    l4_offset = 40;
+    proto     = ip[6];
+    has_ports = true;
+  } else {
+    return false;
+  }
+
+  // IPv6 packets only match L3 wildcards, as the filter addresses are IPv4
+  if (flt.src_addr != -1 and (not is_ipv4 or saddr != (uint32_t)flt.src_addr)) {
+    return false;
+  }
+  if (flt.dst_addr != -1 and (not is_ipv4 or daddr != (uint32_t)flt.dst_addr)) {
+    return false;
+  }
+  if (flt.protocol != -1 and proto != flt.protocol) {
+    return false;
+  }
+  if (flt.src_port == -1 and flt.dst_port == -1) {
+    return true;
+  }
+  has_ports = has_ports and (proto == IPPROTO_TCP or proto == IPPROTO_UDP or proto == IPPROTO_SCTP) and
+              sdu->N_bytes >= l4_offset + 4;
+  if (not has_ports) {
+    return false;
+  }
+  int32_t sport = (ip[l4_offset] << 8) | ip[l4_offset + 1];
+  int32_t dport = (ip[l4_offset + 2] << 8) | ip[l4_offset + 3];
+  return (flt.src_port == -1 or sport == flt.src_port) and (flt.dst_port == -1 or dport == flt.dst_port);
+}
+
+/*******************************************************************************
+ *  Pipeline
+ *******************************************************************************/
+
+tc_conf_t::tc_conf_t()
+{
+  queue_cfg_t q0 = {};
+  q0.id          = 0;
+  q0.type        = TC_QUEUE_FIFO;
+  queues.push_back(q0);
+}
+
+tc_conf_t::queue_cfg_t* tc_conf_t::find_queue(uint32_t queue_id)
+{
+  auto it = std::find_if(queues.begin(), queues.end(), [queue_id](const queue_cfg_t& q) { return q.id == queue_id; });
+  return it != queues.end() ? &(*it) : nullptr;
+}
+
+const tc_conf_t::queue_cfg_t* tc_conf_t::find_queue(uint32_t queue_id) const
+{
+  return const_cast<tc_conf_t*>(this)->find_queue(queue_id);
+}
+
+tc_pipeline::tc_pipeline(const tc_conf_t& conf_)
+{
+  apply(conf_);
+}
+
+tc_queue* tc_pipeline::find_queue(uint32_t queue_id)
+{
+  for (std::unique_ptr<tc_queue>& q : queues) {
+    if (q->get_id() == queue_id) {
+      return q.get();
+    }
+  }
+  return nullptr;
+}
+
+void tc_pipeline::apply(const tc_conf_t& conf_)
+{
+  conf = &conf_;
+
+  // Queues that do not exist anymore hand their packets over to the default queue
+  std::deque<std::pair<int64_t, srsran::unique_byte_buffer_t> > orphans;
+  for (auto it = queues.begin(); it != queues.end();) {
+    if (conf->find_queue((*it)->get_id()) == nullptr) {
+      for (auto& pkt : (*it)->take_all()) {
+        orphans.push_back(std::move(pkt));
+      }
+      it = queues.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (const tc_conf_t::queue_cfg_t& qc : conf->queues) {
+    tc_queue* q = find_queue(qc.id);
+    if (q == nullptr) {
+      queues.emplace_back(new tc_queue(qc.id, qc.type, qc.target_ms, qc.interval_ms));
+      q = queues.back().get();
+    } else if (q->get_type() != qc.type or q->get_target_ms() != (qc.target_ms > 0 ? qc.target_ms : 5) or
+               q->get_interval_ms() != (qc.interval_ms > 0 ? qc.interval_ms : 100)) {
+      q->configure(qc.type, qc.target_ms, qc.interval_ms);
+    }
+
+    q->shp.active        = qc.shp_active;
+    q->shp.max_rate_kbps = qc.shp_max_rate_kbps;
+    if (q->shp.mtr.get_window() != qc.shp_window_ms) {
+      q->shp.mtr.set_window(qc.shp_window_ms);
+    }
+    q->plc.active         = qc.plc_active;
+    q->plc.drop_rate_kbps = qc.plc_drop_rate_kbps;
+    q->plc.dev_id         = qc.plc_dev_id;
+    q->plc.dev_rate_kbps  = qc.plc_dev_rate_kbps;
+  }
+  std::sort(queues.begin(), queues.end(), [](const std::unique_ptr<tc_queue>& a, const std::unique_ptr<tc_queue>& b) {
+    return a->get_id() < b->get_id();
+  });
+
+  tc_queue* q0 = find_queue(0);
+  for (auto& pkt : orphans) {
+    q0->push(std::move(pkt.second), pkt.first);
+  }
+}
+
+tc_queue* tc_pipeline::classify(const srsran::byte_buffer_t* sdu)
+{
+  if (queues.size() == 1) {
+    return queues[0].get();
+  }
+  switch (conf->cls_type) {
+    case TC_CLS_RR:
+      return queues[cls_rr_idx++ % queues.size()].get();
+    case TC_CLS_OSI:
+      for (const tc_osi_filter_t& flt : conf->filters) {
+        if (tc_osi_filter_match(flt, sdu)) {
+          tc_queue* q = find_queue(flt.dst_queue);
+          if (q != nullptr) {
+            return q;
+          }
+        }
+      }
+      break;
+    default:
+      break;
+  }
+  return find_queue(0);
+}
+
+void tc_pipeline::enqueue(srsran::unique_byte_buffer_t sdu, int64_t now_us)
+{
+  tc_queue* q = classify(sdu.get());
+
+  if (q->plc.active) {
+    float rate = q->plc.mtr.rate_kbps(now_us);
+    if (q->plc.drop_rate_kbps > 0 and rate >= q->plc.drop_rate_kbps) {
+      q->stats.plc_dropped_pkts++;
+      return;
+    }
+    if (q->plc.dev_rate_kbps > 0 and rate >= q->plc.dev_rate_kbps) {
+      tc_queue* dev = find_queue(q->plc.dev_id);
+      if (dev != nullptr and dev != q) {
+        q->stats.plc_deviated_pkts++;
+        dev->push(std::move(sdu), now_us);
+        return;
+      }
+    }
+    q->plc.mtr.add(sdu->N_bytes, now_us);
+  }
+  q->push(std::move(sdu), now_us);
+}
+
+bool tc_pipeline::eligible(tc_queue& q, int64_t now_us)
+{
+  return not q.empty() and (not q.shp.active or q.shp.mtr.rate_kbps(now_us) < q.shp.max_rate_kbps);
+}
+
+srsran::unique_byte_buffer_t tc_pipeline::dequeue(int64_t now_us)
+{
+  auto pop = [now_us](tc_queue& q) {
+    srsran::unique_byte_buffer_t sdu = q.pop(now_us);
+    if (sdu != nullptr and q.shp.active) {
+      q.shp.mtr.add(sdu->N_bytes, now_us);
+    }
+    return sdu;
+  };
+
+  if (conf->sch_type == TC_SCHED_PRIO) {
+    // Listed queues first, then the rest in id order
+    for (uint32_t queue_id : conf->prio) {
+      tc_queue* q = find_queue(queue_id);
+      if (q != nullptr and eligible(*q, now_us)) {
+        srsran::unique_byte_buffer_t sdu = pop(*q);
+        if (sdu != nullptr) {
+          return sdu;
+        }
+      }
+    }
+    for (std::unique_ptr<tc_queue>& q : queues) {
+      if (eligible(*q, now_us)) {
+        srsran::unique_byte_buffer_t sdu = pop(*q);
+        if (sdu != nullptr) {
+          return sdu;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < queues.size(); ++i) {
+    size_t idx = (sch_rr_idx + i) % queues.size();
+    if (eligible(*queues[idx], now_us)) {
+      srsran::unique_byte_buffer_t sdu = pop(*queues[idx]);
+      if (sdu != nullptr) {
+        sch_rr_idx = idx + 1;
+        return sdu;
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::vector<srsran::unique_byte_buffer_t> tc_pipeline::take_all()
+{
+  std::vector<srsran::unique_byte_buffer_t> ret;
+  for (std::unique_ptr<tc_queue>& q : queues) {
+    for (auto& pkt : q->take_all()) {
+      ret.push_back(std::move(pkt.second));
+    }
+  }
+  return ret;
+}
+
+bool tc_pipeline::empty() const
+{
+  for (const std::unique_ptr<tc_queue>& q : queues) {
+    if (not q->empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *  Traffic control stage
+ *******************************************************************************/
+
+tc::tc(srslog::basic_logger& logger_) : logger(logger_) {}
+
+void tc::init(pdcp_interface_gtpu* pdcp_, rlc_interface_tc* rlc_, enb_bearer_manager* bearers_)
+{
+  pdcp    = pdcp_;
+  rlc     = rlc_;
+  bearers = bearers_;
+}
+
+void tc::stop()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  pipelines.clear();
+}
+
+void tc::write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu, int pdcp_sn)
+{
+  // SDUs forwarded during handover keep their SN, and bypass the queues
+  if (pdcp_sn < 0 and rnti != SRSRAN_MRNTI and srsran::is_lte_drb(lcid)) {
+    bool queued = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (enabled) {
+        std::unique_ptr<tc_pipeline>& p = pipelines[std::make_pair(rnti, lcid)];
+        if (p == nullptr) {
+          p.reset(new tc_pipeline(conf));
+          logger.info("Created TC pipeline for rnti=0x%x, lcid=%d", rnti, lcid);
+        }
+        int64_t now_us = tc_now_us();
+        p->enqueue(std::move(sdu), now_us);
+        if (conf.pcr_type == TC_PCR_5G_BDP) {
+          paced.push_back({rnti, lcid, conf.pcr_drb_sz});
+        } else {
+          drain(rnti, lcid, *p, now_us);
+        }
+        queued = true;
+      }
+    }
+    if (queued) {
+      drain_paced();
+      release();
+      return;
+    }
+  }
+  pdcp->write_sdu(rnti, lcid, std::move(sdu), pdcp_sn);
+}
+
+std::map<uint32_t, srsran::unique_byte_buffer_t> tc::get_buffered_pdus(uint16_t rnti, uint32_t lcid)
+{
+  // Hand the queued SDUs over to PDCP, so that they get an SN and are forwarded too
+  std::vector<srsran::unique_byte_buffer_t> sdus;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        it = pipelines.find(std::make_pair(rnti, lcid));
+    if (it != pipelines.end()) {
+      sdus = it->second->take_all();
+    }
+  }
+  for (srsran::unique_byte_buffer_t& sdu : sdus) {
+    pdcp->write_sdu(rnti, lcid, std::move(sdu), -1);
+  }
+  return pdcp->get_buffered_pdus(rnti, lcid);
+}
+
+void tc::drain(uint16_t rnti, uint32_t lcid, tc_pipeline& p, int64_t now_us)
+{
+  while (not p.empty()) {
+    srsran::unique_byte_buffer_t sdu = p.dequeue(now_us);
+    if (sdu == nullptr) {
+      break;
+    }
+    egress_mtr.add(sdu->N_bytes, now_us);
+    released.push_back({rnti, lcid, std::move(sdu)});
+  }
+}
+
+void tc::drain_paced()
+{
+  // The pacer keeps the RLC occupancy of the DRB below pcr_drb_sz. The occupancy is read again after every SDU handed
+  // to PDCP, so the mutex is only held to dequeue
+  for (const paced_drb_t& d : paced) {
+    while (rlc->get_buffer_state(d.rnti, d.lcid) < d.drb_sz) {
+      srsran::unique_byte_buffer_t sdu;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = pipelines.find(std::make_pair(d.rnti, d.lcid));
+        if (it == pipelines.end()) {
+          break;
+        }
+        int64_t now_us = tc_now_us();
+        sdu            = it->second->dequeue(now_us);
+        if (sdu == nullptr) {
+          break;
+        }
+        egress_mtr.add(sdu->N_bytes, now_us);
+      }
+      pdcp->write_sdu(d.rnti, d.lcid, std::move(sdu), -1);
+    }
+  }
+  paced.clear();
+}
+
+void tc::release()
+{
+  for (released_sdu_t& r : released) {
+    pdcp->write_sdu(r.rnti, r.lcid, std::move(r.sdu), -1);
+  }
+  released.clear();
+}
+
+void tc::retire(tc_pipeline& p)
+{
+  for (std::unique_ptr<tc_queue>& q : p.get_queues()) {
+    retired_stats[q->get_id()].merge(q->stats);
+  }
+}
+
+void tc::tti_clock()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (not enabled) {
+      return;
+    }
+    int64_t now_us = tc_now_us();
+    for (auto it = pipelines.begin(); it != pipelines.end();) {
+      uint16_t rnti = it->first.first;
+      uint32_t lcid = it->first.second;
+      if (not bearers->get_lcid_bearer(rnti, lcid).is_valid()) {
+        logger.info("Removing TC pipeline of rnti=0x%x, lcid=%d", rnti, lcid);
+        retire(*it->second);
+        it = pipelines.erase(it);
+        continue;
+      }
+      if (conf.pcr_type == TC_PCR_5G_BDP) {
+        if (not it->second->empty()) {
+          paced.push_back({rnti, lcid, conf.pcr_drb_sz});
+        }
+      } else {
+        drain(rnti, lcid, *it->second, now_us);
+      }
+      ++it;
+    }
+  }
+  drain_paced();
+  release();
+}
+
+/*******************************************************************************
+ *  E2 Agent
+ *******************************************************************************/
+
+tc_ctrl_out_e tc::ctrl_cls(const tc_ctrl_cls_t& cls)
+{
+  if (cls.act == TC_CTRL_ACTION_SM_V0_ADD) {
+    if (cls.add.type == TC_CLS_RR) {
+      conf.cls_type = TC_CLS_RR;
+      return TC_CTRL_OUT_OK;
+    }
+    if (cls.add.type == TC_CLS_OSI and cls.add.osi.dst_queue >= 0) {
+      tc_osi_filter_t flt = {};
+      flt.id              = conf.next_filter_id++;
+      flt.src_addr        = cls.add.osi.l3.src_addr;
+      flt.dst_addr        = cls.add.osi.l3.dst_addr;
+      flt.src_port        = cls.add.osi.l4.src_port;
+      flt.dst_port        = cls.add.osi.l4.dst_port;
+      flt.protocol        = cls.add.osi.l4.protocol;
+      flt.dst_queue       = cls.add.osi.dst_queue;
+      conf.cls_type       = TC_CLS_OSI;
+      conf.filters.push_back(flt);
+      logger.info("TC: added OSI filter id=%d to queue %d", flt.id, flt.dst_queue);
+      return TC_CTRL_OUT_OK;
+    }
+  } else if (cls.act == TC_CTRL_ACTION_SM_V0_MOD) {
+    if (cls.mod.type == TC_CLS_RR) {
+      conf.cls_type = TC_CLS_RR;
+      return TC_CTRL_OUT_OK;
+    }
+    if (cls.mod.type == TC_CLS_OSI) {
+      const tc_cls_osi_filter_t& src = cls.mod.osi.filter;
+      for (tc_osi_filter_t& flt : conf.filters) {
+        if (flt.id == src.id and src.dst_queue >= 0) {
+          flt.src_addr  = src.l3.src_addr;
+          flt.dst_addr  = src.l3.dst_addr;
+          flt.src_port  = src.l4.src_port;
+          flt.dst_port  = src.l4.dst_port;
+          flt.protocol  = src.l4.protocol;
+          flt.dst_queue = src.dst_queue;
+          conf.cls_type = TC_CLS_OSI;
+          return TC_CTRL_OUT_OK;
+        }
+      }
+    }
+  } else if (cls.act == TC_CTRL_ACTION_SM_V0_DEL) {
+    if (cls.del.type == TC_CLS_OSI) {
+      uint32_t filter_id = cls.del.osi.filter_id;
+      auto     it        = std::find_if(conf.filters.begin(), conf.filters.end(), [filter_id](const tc_osi_filter_t& f) {
+        return f.id == filter_id;
+      });
+      if (it != conf.filters.end()) {
+        conf.filters.erase(it);
+        return TC_CTRL_OUT_OK;
+      }
+    }
+  }
+  logger.warning("TC: unsupported classifier control, action=%d", cls.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::ctrl_plc(const tc_ctrl_plc_t& plc)
+{
+  // Every queue has a policer, inactive by default
+  if (plc.act == TC_CTRL_ACTION_SM_V0_MOD) {
+    tc_conf_t::queue_cfg_t* q = conf.find_queue(plc.mod.id);
+    if (q != nullptr) {
+      q->plc_active         = plc.mod.active != 0;
+      q->plc_drop_rate_kbps = plc.mod.drop_rate_kbps;
+      q->plc_dev_id         = plc.mod.dev_id;
+      q->plc_dev_rate_kbps  = plc.mod.dev_rate_kbps;
+      return TC_CTRL_OUT_OK;
+    }
+  } else if (plc.act == TC_CTRL_ACTION_SM_V0_DEL) {
+    tc_conf_t::queue_cfg_t* q = conf.find_queue(plc.del.id);
+    if (q != nullptr) {
+      q->plc_active = false;
+      return TC_CTRL_OUT_OK;
+    }
+  }
+  logger.warning("TC: unsupported policer control, action=%d", plc.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::ctrl_queue(const tc_ctrl_queue_t& q)
+{
+  // CoDel and ECN-CoDel share the layout of their parameters
+  if (q.act == TC_CTRL_ACTION_SM_V0_ADD and q.add.type < TC_QUEUE_END) {
+    tc_conf_t::queue_cfg_t qc = {};
+    qc.id                     = conf.next_queue_id++;
+    qc.type                   = q.add.type;
+    if (qc.type != TC_QUEUE_FIFO) {
+      qc.target_ms   = q.add.codel.target_ms;
+      qc.interval_ms = q.add.codel.interval_ms;
+    }
+    conf.queues.push_back(qc);
+    logger.info("TC: added queue id=%d, type=%d", qc.id, qc.type);
+    return TC_CTRL_OUT_OK;
+  }
+  if (q.act == TC_CTRL_ACTION_SM_V0_MOD and q.mod.type < TC_QUEUE_END) {
+    tc_conf_t::queue_cfg_t* qc = conf.find_queue(q.mod.id);
+    if (qc != nullptr) {
+      qc->type        = q.mod.type;
+      qc->target_ms   = qc->type != TC_QUEUE_FIFO ? q.mod.codel.target_ms : 0;
+      qc->interval_ms = qc->type != TC_QUEUE_FIFO ? q.mod.codel.interval_ms : 0;
+      return TC_CTRL_OUT_OK;
+    }
+  }
+  if (q.act == TC_CTRL_ACTION_SM_V0_DEL and q.del.id != 0 and conf.find_queue(q.del.id) != nullptr) {
+    uint32_t id = q.del.id;
+    conf.queues.erase(std::find_if(
+        conf.queues.begin(), conf.queues.end(), [id](const tc_conf_t::queue_cfg_t& qc) { return qc.id == id; }));
+    conf.prio.erase(std::remove(conf.prio.begin(), conf.prio.end(), id), conf.prio.end());
+    return TC_CTRL_OUT_OK;
+  }
+  logger.warning("TC: unsupported queue control, action=%d", q.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::ctrl_sch(const tc_ctrl_sch_t& sch)
+{
+  if (sch.act == TC_CTRL_ACTION_SM_V0_MOD) {
+    if (sch.mod.type == TC_SCHED_RR) {
+      conf.sch_type = TC_SCHED_RR;
+      conf.prio.clear();
+      return TC_CTRL_OUT_OK;
+    }
+    if (sch.mod.type == TC_SCHED_PRIO) {
+      conf.sch_type = TC_SCHED_PRIO;
+      conf.prio.assign(sch.mod.prio.q_prio, sch.mod.prio.q_prio + sch.mod.prio.len_q_prio);
+      return TC_CTRL_OUT_OK;
+    }
+  }
+  logger.warning("TC: unsupported scheduler control, action=%d", sch.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::ctrl_shp(const tc_ctrl_shp_t& shp)
+{
+  // Every queue has a shaper, inactive by default
+  if (shp.act == TC_CTRL_ACTION_SM_V0_MOD) {
+    tc_conf_t::queue_cfg_t* q = conf.find_queue(shp.mod.id);
+    if (q != nullptr) {
+      q->shp_active        = shp.mod.active != 0;
+      q->shp_window_ms     = std::max(shp.mod.time_window_ms, 1u);
+      q->shp_max_rate_kbps = shp.mod.max_rate_kbps;
+      return TC_CTRL_OUT_OK;
+    }
+  } else if (shp.act == TC_CTRL_ACTION_SM_V0_DEL) {
+    tc_conf_t::queue_cfg_t* q = conf.find_queue(shp.del.id);
+    if (q != nullptr) {
+      q->shp_active = false;
+      return TC_CTRL_OUT_OK;
+    }
+  }
+  logger.warning("TC: unsupported shaper control, action=%d", shp.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::ctrl_pcr(const tc_ctrl_pcr_t& pcr)
+{
+  if (pcr.act == TC_CTRL_ACTION_SM_V0_MOD) {
+    if (pcr.mod.type == TC_PCR_DUMMY) {
+      conf.pcr_type = TC_PCR_DUMMY;
+      return TC_CTRL_OUT_OK;
+    }
+    if (pcr.mod.type == TC_PCR_5G_BDP) {
+      conf.pcr_type   = TC_PCR_5G_BDP;
+      conf.pcr_drb_sz = pcr.mod.bdp.drb_sz;
+      return TC_CTRL_OUT_OK;
+    }
+  }
+  logger.warning("TC: unsupported pacer control, action=%d", pcr.act);
+  return TC_CTRL_OUT_ERROR;
+}
+
+tc_ctrl_out_e tc::control(const tc_ctrl_msg_t& msg)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  tc_ctrl_out_e ret = TC_CTRL_OUT_ERROR;
+  switch (msg.type) {
+    case TC_CTRL_SM_V0_CLS:
+      ret = ctrl_cls(msg.cls);
+      break;
+    case TC_CTRL_SM_V0_PLC:
+      ret = ctrl_plc(msg.plc);
+      break;
+    case TC_CTRL_SM_V0_QUEUE:
+      ret = ctrl_queue(msg.q);
+      break;
+    case TC_CTRL_SM_V0_SCH:
+      ret = ctrl_sch(msg.sch);
+      break;
+    case TC_CTRL_SM_V0_SHP:
+      ret = ctrl_shp(msg.shp);
+      break;
+    case TC_CTRL_SM_V0_PCR:
+      ret = ctrl_pcr(msg.pcr);
+      break;
+    default:
+      logger.warning("TC: unknown control message type=%d", msg.type);
+      break;
+  }
+  if (ret != TC_CTRL_OUT_OK) {
+    return ret;
+  }
+
+  enabled = true;
+  for (auto& p : pipelines) {
+    p.second->apply(conf);
+  }
+  return ret;
+}
+
+void tc::get_stats(tc_ind_msg_t* msg)
+{
+  // The counters are copied under the mutex. The indication is allocated and filled once it is released
+  tc_sch_e sch_type;
+  tc_pcr_e pcr_type;
+  tc_cls_e cls_type;
+  uint32_t pcr_window_ms;
+  float    pcr_kbps;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    int64_t                     now_us = tc_now_us();
+
+    // The queues of all the DRBs are reported aggregated by queue id
+    report_queues.resize(conf.queues.size());
+    for (size_t i = 0; i < conf.queues.size(); ++i) {
+      queue_report_t& rep = report_queues[i];
+      rep                 = {};
+      rep.cfg             = conf.queues[i];
+      auto ret_it         = retired_stats.find(rep.cfg.id);
+      if (ret_it != retired_stats.end()) {
+        rep.stats.merge(ret_it->second);
+        ret_it->second.sojourn_sum_us = 0;
+        ret_it->second.sojourn_pkts   = 0;
+      }
+      for (auto& p : pipelines) {
+        for (std::unique_ptr<tc_queue>& q : p.second->get_queues()) {
+          if (q->get_id() != rep.cfg.id) {
+            continue;
+          }
+          rep.stats.merge(q->stats);
+          q->stats.sojourn_sum_us = 0;
+          q->stats.sojourn_pkts   = 0;
+          rep.bytes += q->size_bytes();
+          rep.pkts += q->size_pkts();
+          rep.shp_kbps += q->shp.mtr.rate_kbps(now_us);
+          rep.plc_kbps += q->plc.mtr.rate_kbps(now_us);
+        }
+      }
+    }
+
+    sch_type = conf.sch_type;
+    report_prio.assign(conf.prio.begin(), conf.prio.end());
+    pcr_type      = conf.pcr_type;
+    pcr_window_ms = egress_mtr.get_window();
+    pcr_kbps      = egress_mtr.rate_kbps(now_us);
+    cls_type      = conf.cls_type;
+    report_filters.assign(conf.filters.begin(), conf.filters.end());
+  }
+
+  size_t len_q = report_queues.size();
+  msg->len_q   = len_q;
+  msg->q       = (tc_queue_t*)calloc(len_q, sizeof(tc_queue_t));
+  msg->shp     = (tc_shp_t*)calloc(len_q, sizeof(tc_shp_t));
+  msg->plc     = (tc_plc_t*)calloc(len_q, sizeof(tc_plc_t));
+  srsran_assert(msg->q != NULL and msg->shp != NULL and msg->plc != NULL, "memory exhausted");
+
+  for (size_t i = 0; i < len_q; ++i) {
+    const tc_conf_t::queue_cfg_t& qc    = report_queues[i].cfg;
+    const tc_queue_stats_t&       stats = report_queues[i].stats;
+
+    // FIFO, CoDel and ECN-CoDel statistics share the same layout, except for the dropper/marker
+    tc_queue_t* rd = &msg->q[i];
+    rd->id         = qc.id;
+    rd->type       = qc.type;
+    if (qc.type == TC_QUEUE_ECN_CODEL) {
+      rd->ecn.bytes             = report_queues[i].bytes;
+      rd->ecn.pkts              = report_queues[i].pkts;
+      rd->ecn.bytes_fwd         = stats.bytes_fwd;
+      rd->ecn.pkts_fwd          = stats.pkts_fwd;
+      rd->ecn.mrk.marked_pkts   = stats.marked_pkts;
+      rd->ecn.avg_sojourn_time  = stats.sojourn_pkts > 0 ? (float)stats.sojourn_sum_us / stats.sojourn_pkts : 0;
+      rd->ecn.last_sojourn_time = stats.last_sojourn_us;
+    } else {
+      tc_queue_fifo_t* fifo   = qc.type == TC_QUEUE_FIFO ? &rd->fifo : (tc_queue_fifo_t*)&rd->codel;
+      fifo->bytes             = report_queues[i].bytes;
+      fifo->pkts              = report_queues[i].pkts;
+      fifo->bytes_fwd         = stats.bytes_fwd;
+      fifo->pkts_fwd          = stats.pkts_fwd;
+      fifo->drp.dropped_pkts  = stats.dropped_pkts;
+      fifo->avg_sojourn_time  = stats.sojourn_pkts > 0 ? (float)stats.sojourn_sum_us / stats.sojourn_pkts : 0;
+      fifo->last_sojourn_time = stats.last_sojourn_us;
+    }
+
+    tc_shp_t* shp           = &msg->shp[i];
+    shp->id                 = qc.id;
+    shp->active             = qc.shp_active;
+    shp->max_rate_kbps      = qc.shp_max_rate_kbps;
+    shp->mtr.time_window_ms = qc.shp_window_ms;
+    shp->mtr.bnd_flt        = report_queues[i].shp_kbps;
+
+    tc_plc_t* plc           = &msg->plc[i];
+    plc->id                 = qc.id;
+    plc->active             = qc.plc_active;
+    plc->max_rate_kbps      = qc.plc_drop_rate_kbps;
+    plc->dst_id             = qc.id;
+    plc->dev_id             = qc.plc_dev_id;
+    plc->drp.dropped_pkts   = stats.plc_dropped_pkts;
+    plc->mrk.marked_pkts    = stats.plc_deviated_pkts;
+    plc->mtr.time_window_ms = 100;
+    plc->mtr.bnd_flt        = report_queues[i].plc_kbps;
+  }
+
+  msg->sch.type = sch_type;
+  if (sch_type == TC_SCHED_PRIO and not report_prio.empty()) {
+    msg->sch.prio.len_q_prio = report_prio.size();
+    msg->sch.prio.q_prio     = (uint32_t*)calloc(report_prio.size(), sizeof(uint32_t));
+    srsran_assert(msg->sch.prio.q_prio != NULL, "memory exhausted");
+    std::copy(report_prio.begin(), report_prio.end(), msg->sch.prio.q_prio);
+  }
+
+  msg->pcr.type               = pcr_type;
+  msg->pcr.id                 = 0;
+  msg->pcr.mtr.time_window_ms = pcr_window_ms;
+  msg->pcr.mtr.bnd_flt        = pcr_kbps;
+
+  msg->cls.type = cls_type;
+  if (cls_type == TC_CLS_OSI and not report_filters.empty()) {
+    msg->cls.osi.len = report_filters.size();
+    msg->cls.osi.flt = (tc_cls_osi_filter_t*)calloc(report_filters.size(), sizeof(tc_cls_osi_filter_t));
+    srsran_assert(msg->cls.osi.flt != NULL, "memory exhausted");
+    for (size_t i = 0; i < report_filters.size(); ++i) {
+      const tc_osi_filter_t& flt = report_filters[i];
+      tc_cls_osi_filter_t*   rd  = &msg->cls.osi.flt[i];
+      rd->id                     = flt.id;
+      rd->l3.src_addr            = flt.src_addr;
+      rd->l3.dst_addr            = flt.dst_addr;
+      rd->l4.src_port            = flt.src_port;
+      rd->l4.dst_port            = flt.dst_port;
+      rd->l4.protocol            = flt.protocol;
+      rd->dst_queue              = flt.dst_queue;
+    }
+  }
+}
+
+} // namespace srsenb
@@ -0,0 +1,227 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/metrics_e2.h"
+#include "srsran/common/test_common.h"
+#include <thread>
+
+using namespace srsenb;
+
+namespace {
+
+void fill_stack_metrics(stack_metrics_t& m)
+{
+  // MAC and RLC/PDCP report the UEs in a different order, and the RLC misses one of them
+  m.mac.ues.resize(3);
+  m.mac.ues[0].rnti     = 0x4a;
+  m.mac.ues[0].tx_brate = 1;
+  m.mac.ues[1].rnti     = 0x46;
+  m.mac.ues[1].tx_brate = 2;
+  m.mac.ues[2].rnti     = 0x48;
+  m.mac.ues[2].tx_brate = 3;
+
+  m.rlc.ues.resize(2);
+  m.rlc.ues[0].rnti                  = 0x46;
+  m.rlc.ues[0].bearer[3].num_tx_sdus = 100;
+  m.rlc.ues[1].rnti                  = 0x4a;
+  m.rlc.ues[1].bearer[3].num_tx_sdus = 300;
+
+  m.pdcp.ues.resize(3);
+  m.pdcp.ues[0].rnti = 0x46;
+  m.pdcp.ues[1].rnti = 0x48;
+  m.pdcp.ues[2].rnti = 0x4a;
+}
+
+int test_snapshot_join_by_rnti()
+{
+  std::unique_ptr<metrics_e2> e2(new metrics_e2());
+
+  stack_metrics_t m = {};
+  fill_stack_metrics(m);
+  e2->push_stack_metrics(m);
+
+  std::vector<phy_metrics_t> phy(2);
+  phy[0].rnti   = 0x46;
+  phy[0].dl.mcs = 28;
+  phy[1].rnti   = 0x48;
+  phy[1].dl.mcs = 10;
+  e2->push_phy_metrics(0, phy);
+
+  e2_metrics_snapshot_t s;
+  e2->read(s);
+  TESTASSERT(s.version == 1);
+  TESTASSERT(s.ues.size() == 3);
+  TESTASSERT(s.ues[0].rnti == 0x46 and s.ues[1].rnti == 0x48 and s.ues[2].rnti == 0x4a);
+
+  const e2_ue_metrics_t* u = s.find(0x46);
+  TESTASSERT(u != nullptr);
+  TESTASSERT(u->has_mac and u->has_phy and u->has_rlc and u->has_pdcp);
+  TESTASSERT(u->mac.tx_brate == 2);
+  TESTASSERT(u->phy.dl.mcs == 28);
+  TESTASSERT(u->rlc.bearer[3].num_tx_sdus == 100);
+
+  u = s.find(0x48);
+  TESTASSERT(u != nullptr);
+  TESTASSERT(u->has_mac and u->has_phy and not u->has_rlc and u->has_pdcp);
+  TESTASSERT(u->mac.tx_brate == 3);
+
+  u = s.find(0x4a);
+  TESTASSERT(u != nullptr);
+  TESTASSERT(u->has_mac and not u->has_phy and u->has_rlc);
+  TESTASSERT(u->rlc.bearer[3].num_tx_sdus == 300);
+
+  TESTASSERT(s.find(0x47) == nullptr);
+  return SRSRAN_SUCCESS;
+}
+
+int test_read_latest_publication()
+{
+  std::unique_ptr<metrics_e2> e2(new metrics_e2());
+
+  // Nothing pushed yet
+  e2_metrics_snapshot_t s;
+  e2->read(s);
+  TESTASSERT(s.version == 0 and s.ues.empty());
+
+  // Lap the snapshot ring several times
+  stack_metrics_t m = {};
+  for (uint32_t i = 0; i < 10; ++i) {
+    m.mac.ues.resize(i % 3);
+    for (uint32_t j = 0; j < m.mac.ues.size(); ++j) {
+      m.mac.ues[j].rnti = 0x46 + j;
+    }
+    e2->push_stack_metrics(m);
+  }
+  e2->read(s);
+  TESTASSERT(s.version == 10);
+  TESTASSERT(s.ues.size() == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int test_phy_workers_merge()
+{
+  std::unique_ptr<metrics_e2> e2(new metrics_e2());
+
+  // Two workers served the UE, the third one has no samples for it yet
+  std::vector<phy_metrics_t> phy(1);
+  phy[0].rnti         = 0x46;
+  phy[0].dl.mcs       = 10;
+  phy[0].dl.n_samples = 1;
+  phy[0].ul.mcs       = 4;
+  phy[0].ul.n_samples = 3;
+  e2->push_phy_metrics(0, phy);
+  phy[0].dl.mcs       = 20;
+  phy[0].dl.n_samples = 3;
+  phy[0].ul.mcs       = 8;
+  phy[0].ul.n_samples = 1;
+  e2->push_phy_metrics(1, phy);
+  phy[0]              = {};
+  phy[0].rnti         = 0x46;
+  e2->push_phy_metrics(2, phy);
+
+  // Out of range workers are ignored
+  phy[0].dl.mcs       = 28;
+  phy[0].dl.n_samples = 100;
+  e2->push_phy_metrics(metrics_e2::max_phy_workers, phy);
+
+  e2_metrics_snapshot_t s;
+  e2->read(s);
+  TESTASSERT(s.version == 0);
+  const e2_ue_metrics_t* u = s.find(0x46);
+  TESTASSERT(u != nullptr and u->has_phy and not u->has_mac);
+  TESTASSERT(u->phy.dl.n_samples == 4 and u->phy.ul.n_samples == 4);
+  TESTASSERT(u->phy.dl.mcs == 17.5f);
+  TESTASSERT(u->phy.ul.mcs == 5.0f);
+
+  // A new push of a worker replaces its previous one
+  phy[0]              = {};
+  phy[0].rnti         = 0x48;
+  phy[0].dl.n_samples = 1;
+  e2->push_phy_metrics(1, phy);
+  e2->read(s);
+  u = s.find(0x46);
+  TESTASSERT(u != nullptr and u->phy.dl.n_samples == 1 and u->phy.dl.mcs == 10);
+  TESTASSERT(s.find(0x48) != nullptr);
+  return SRSRAN_SUCCESS;
+}
+
+int test_concurrent_publish_read()
+{
+  std::unique_ptr<metrics_e2> e2(new metrics_e2());
+  const uint64_t              nof_publications = 5000;
+
+  // The stack and a PHY worker push snapshots whose content is derived from their version
+  std::thread stack([&e2]() {
+    stack_metrics_t m = {};
+    for (uint64_t v = 1; v <= nof_publications; ++v) {
+      m.mac.ues.resize(v % 5);
+      for (uint32_t j = 0; j < m.mac.ues.size(); ++j) {
+        m.mac.ues[j].rnti     = 0x46 + j;
+        m.mac.ues[j].tx_brate = v;
+      }
+      e2->push_stack_metrics(m);
+    }
+  });
+  std::thread worker([&e2]() {
+    std::vector<phy_metrics_t> phy(1);
+    phy[0].rnti = 0x100;
+    for (uint64_t v = 1; v <= nof_publications; ++v) {
+      phy[0].dl.n_samples = v;
+      phy[0].ul.n_samples = v;
+      e2->push_phy_metrics(0, phy);
+    }
+  });
+
+  // A reader never observes a snapshot mixing two pushes of the same writer
+  e2_metrics_snapshot_t s;
+  uint64_t              last_version = 0;
+  while (last_version < nof_publications) {
+    e2->read(s);
+    TESTASSERT(s.version >= last_version);
+    uint32_t nof_mac = 0;
+    for (const e2_ue_metrics_t& u : s.ues) {
+      if (u.rnti == 0x100) {
+        TESTASSERT(u.has_phy and not u.has_mac and u.phy.dl.n_samples == u.phy.ul.n_samples);
+        continue;
+      }
+      TESTASSERT(u.has_mac and u.mac.tx_brate == s.version);
+      nof_mac++;
+    }
+    TESTASSERT(s.version == 0 or nof_mac == s.version % 5);
+    last_version = s.version;
+  }
+  stack.join();
+  worker.join();
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+int main()
+{
+  TESTASSERT(test_snapshot_join_by_rnti() == SRSRAN_SUCCESS);
+  TESTASSERT(test_read_latest_publication() == SRSRAN_SUCCESS);
+  TESTASSERT(test_phy_workers_merge() == SRSRAN_SUCCESS);
+  TESTASSERT(test_concurrent_publish_read() == SRSRAN_SUCCESS);
+
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
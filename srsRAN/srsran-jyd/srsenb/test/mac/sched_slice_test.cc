@@ -0,0 +1,474 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched_interface.h"
+#include "srsenb/hdr/stack/mac/sched_slice.h"
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_edf.h"
+#include "srsenb/hdr/stack/mac/schedulers/sched_slice_nvs.h"
+#include "srsran/common/test_common.h"
+#include <cmath>
+
+using namespace srsenb;
+
+std::unique_ptr<sched_slice_table> make_table(std::vector<uint32_t> ids)
+{
+  std::unique_ptr<sched_slice_table> table{new sched_slice_table{}};
+  table->sched_name = "time_rr";
+  for (uint32_t id : ids) {
+    table->slices.emplace_back();
+    table->slices.back().id = id;
+  }
+  return table;
+}
+
+void set_static_slice(sched_slice_t& slice, uint32_t pos_low, uint32_t pos_high)
+{
+  slice.params.type           = SLICE_ALG_SM_V0_STATIC;
+  slice.params.u.sta.pos_low  = pos_low;
+  slice.params.u.sta.pos_high = pos_high;
+}
+
+int test_find_slice()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0, 2, 5});
+  TESTASSERT(table->find_slice(0) == 0);
+  TESTASSERT(table->find_slice(2) == 1);
+  TESTASSERT(table->find_slice(5) == 2);
+  TESTASSERT(table->find_slice(1) == -1);
+  TESTASSERT(table->find_slice(6) == -1);
+  TESTASSERT(make_table({})->find_slice(0) == -1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_slice_db_publish()
+{
+  sched_slice_db db;
+
+  // Initially, an empty table is active
+  TESTASSERT(db.active().empty());
+  TESTASSERT(not db.new_tti());
+
+  // Published tables only become active at the next TTI
+  db.publish(make_table({1}));
+  TESTASSERT(db.latest().version == 1);
+  TESTASSERT(db.active().empty());
+  TESTASSERT(db.new_tti());
+  TESTASSERT(db.active().version == 1);
+  TESTASSERT(db.active().find_slice(1) == 0);
+  TESTASSERT(not db.new_tti());
+
+  // Only the last of several publications in the same TTI is picked up
+  db.publish(make_table({1, 2}));
+  db.publish(make_table({1, 2, 3}));
+  TESTASSERT(db.latest().version == 3);
+  TESTASSERT(db.active().version == 1);
+  TESTASSERT(db.new_tti());
+  TESTASSERT(db.active().version == 3);
+  TESTASSERT(db.active().slices.size() == 3);
+
+  // The active table remains valid until the scheduler moves on
+  const sched_slice_table* active = &db.active();
+  for (uint32_t i = 0; i < 10; ++i) {
+    db.publish(make_table({i}));
+  }
+  TESTASSERT(&db.active() == active);
+  TESTASSERT(db.active().find_slice(3) == 2);
+  TESTASSERT(db.new_tti());
+  TESTASSERT(db.active().version == db.latest().version);
+  TESTASSERT(db.active().find_slice(9) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int test_static_slice_resources()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1});
+  set_static_slice(table->slices[0], 0, 5);
+  set_static_slice(table->slices[1], 5, 13);
+
+  // 5 MHz and 20 MHz carriers
+  TESTASSERT(table->set_cells({25, 100}));
+  for (const sched_slice_t& slice : table->slices) {
+    TESTASSERT(slice.cc.size() == 2);
+    TESTASSERT(slice.get_cc(2) == nullptr);
+  }
+
+  // 25 PRBs -> 13 RBGs of 2 PRBs
+  const sched_slice_cc_t* cc = table->slices[1].get_cc(0);
+  TESTASSERT(cc->dl_mask.size() == 13);
+  TESTASSERT(cc->dl_mask.count() == 5 and not cc->dl_mask.any(5, 13));
+  TESTASSERT(cc->ul_mask.size() == 25);
+  TESTASSERT(cc->ul_mask.count() == 10 and not cc->ul_mask.any(10, 25));
+
+  // 100 PRBs -> 25 RBGs of 4 PRBs
+  cc = table->slices[0].get_cc(1);
+  TESTASSERT(cc->dl_mask.size() == 25);
+  TESTASSERT(cc->dl_mask.count() == 20 and not cc->dl_mask.any(0, 5));
+  TESTASSERT(cc->ul_mask.size() == 100);
+  TESTASSERT(cc->ul_mask.count() == 80 and not cc->ul_mask.any(0, 20));
+
+  // The whole 20 MHz carrier can be given to a slice
+  set_static_slice(table->slices[1], 5, 25);
+  TESTASSERT(table->set_cells({100}));
+  TESTASSERT(table->slices[1].get_cc(0)->dl_mask.count() == 5);
+  TESTASSERT(table->slices[1].get_cc(0)->ul_mask.count() == 20);
+
+  // But not a 5 MHz one
+  TESTASSERT(not table->set_cells({100, 25}));
+  return SRSRAN_SUCCESS;
+}
+
+int test_ul_slice_resources()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0});
+  set_static_slice(table->slices[0], 0, 5);
+  table->ul_slices.resize(2);
+  table->ul_slices[0].id = 0;
+  table->ul_slices[1].id = 3;
+  TESTASSERT(table->find_ul_slice(3) == 1 and table->find_ul_slice(1) == -1);
+
+  // UL windows are given in PRBs, and do not depend on the DL window of the slice
+  set_static_slice(table->ul_slices[0], 0, 10);
+  set_static_slice(table->ul_slices[1], 10, 25);
+  TESTASSERT(table->set_cells({25}));
+  const sched_slice_cc_t* cc = table->ul_slices[1].get_cc(0);
+  TESTASSERT(cc->dl_mask.size() == 0);
+  TESTASSERT(cc->ul_mask.size() == 25);
+  TESTASSERT(cc->ul_mask.count() == 10 and not cc->ul_mask.any(10, 25));
+  TESTASSERT(table->ul_slices[0].get_cc(0)->ul_mask.count() == 15);
+
+  // A 5 MHz carrier only has 25 PRBs
+  set_static_slice(table->ul_slices[1], 10, 26);
+  TESTASSERT(not table->set_cells({25}));
+  TESTASSERT(table->set_cells({100}));
+  return SRSRAN_SUCCESS;
+}
+
+void set_nvs_rate_slice(sched_slice_t& slice, float mbps_required, float mbps_reference)
+{
+  slice.params.type                           = SLICE_ALG_SM_V0_NVS;
+  slice.params.u.nvs.conf                     = SLICE_SM_NVS_V0_RATE;
+  slice.params.u.nvs.u.rate.u1.mbps_required  = mbps_required;
+  slice.params.u.nvs.u.rate.u2.mbps_reference = mbps_reference;
+}
+
+void set_nvs_capacity_slice(sched_slice_t& slice, float pct_reserved)
+{
+  slice.params.type                            = SLICE_ALG_SM_V0_NVS;
+  slice.params.u.nvs.conf                      = SLICE_SM_NVS_V0_CAPACITY;
+  slice.params.u.nvs.u.capacity.u.pct_reserved = pct_reserved;
+}
+
+int test_nvs_validate()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1});
+  set_nvs_rate_slice(table->slices[0], 5, 20);
+  set_nvs_capacity_slice(table->slices[1], 0.75);
+  TESTASSERT(sched_slice_nvs::validate(table->slices));
+
+  // Reservations exceed the carrier
+  set_nvs_capacity_slice(table->slices[1], 0.8);
+  TESTASSERT(not sched_slice_nvs::validate(table->slices));
+
+  // Invalid parameters
+  set_nvs_capacity_slice(table->slices[1], 0);
+  TESTASSERT(not sched_slice_nvs::validate(table->slices));
+  set_nvs_capacity_slice(table->slices[1], 0.5);
+  set_nvs_rate_slice(table->slices[0], 10, 5);
+  TESTASSERT(not sched_slice_nvs::validate(table->slices));
+
+  // All slices must be NVS
+  set_nvs_rate_slice(table->slices[0], 5, 20);
+  set_static_slice(table->slices[1], 0, 5);
+  TESTASSERT(not sched_slice_nvs::validate(table->slices));
+  return SRSRAN_SUCCESS;
+}
+
+int test_nvs_slice_order()
+{
+  const uint32_t nof_rbgs = 25;
+
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1});
+  set_nvs_capacity_slice(table->slices[0], 0.25);
+  set_nvs_capacity_slice(table->slices[1], 0.75);
+
+  sched_slice_nvs nvs{nof_rbgs};
+  nvs.set_slices(table->slices);
+
+  // Slices that were never served are ranked by their reservation
+  TESTASSERT(nvs.get_order() == std::vector<uint32_t>({1, 0}));
+
+  // Both slices always backlogged. The slice served first takes the whole carrier
+  uint32_t nof_tti = 2000, slice_ttis[2] = {};
+  for (uint32_t tti = 0; tti < nof_tti; ++tti) {
+    std::vector<uint32_t> order = nvs.get_order();
+    slice_ttis[order[0]]++;
+    nvs.save_alloc(order[0], 1000, nof_rbgs);
+    nvs.save_alloc(order[1], 0, 0);
+  }
+  // The carrier is shared according to the reservations
+  TESTASSERT(std::abs((float)slice_ttis[0] / nof_tti - 0.25) < 0.02);
+  TESTASSERT(std::abs((float)slice_ttis[1] / nof_tti - 0.75) < 0.02);
+
+  // Work-conserving. An idle slice does not prevent the other from using the whole carrier, and gets the highest
+  // priority once it becomes active again
+  for (uint32_t tti = 0; tti < nof_tti; ++tti) {
+    nvs.save_alloc(0, 0, 0);
+    nvs.save_alloc(1, 1000, nof_rbgs);
+  }
+  TESTASSERT(nvs.get_weight(0) > nvs.get_weight(1));
+  TESTASSERT(nvs.get_order()[0] == 0);
+
+  // Rate reservations are compared against the served throughput
+  set_nvs_rate_slice(table->slices[0], 2, 20);
+  set_nvs_rate_slice(table->slices[1], 10, 20);
+  nvs.set_slices(table->slices);
+  for (uint32_t tti = 0; tti < nof_tti; ++tti) {
+    // 1000 bytes per TTI -> 8 Mbps, which satisfies slice 0 but not slice 1
+    nvs.save_alloc(0, 1000, 10);
+    nvs.save_alloc(1, 1000, 10);
+  }
+  TESTASSERT(nvs.get_order()[0] == 1);
+  TESTASSERT(nvs.get_weight(0) < 1 and nvs.get_weight(1) > 1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_scn19_slices()
+{
+  const uint32_t nof_rbgs = 25;
+
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1, 2});
+  for (sched_slice_t& slice : table->slices) {
+    slice.params.type = SLICE_ALG_SM_V0_SCN19;
+  }
+  table->slices[0].params.u.scn19.conf                        = SLICE_SCN19_SM_V0_DYNAMIC;
+  table->slices[0].params.u.scn19.u.dynamic.u1.mbps_required  = 5;
+  table->slices[0].params.u.scn19.u.dynamic.u2.mbps_reference = 20;
+  table->slices[1].params.u.scn19.conf                        = SLICE_SCN19_SM_V0_FIXED;
+  table->slices[1].params.u.scn19.u.fixed.pos_low             = 20;
+  table->slices[1].params.u.scn19.u.fixed.pos_high            = 25;
+  table->slices[2].params.u.scn19.conf                        = SLICE_SCN19_SM_V0_ON_DEMAND;
+  table->slices[2].params.u.scn19.u.on_demand.pct_reserved    = 0.5;
+  table->slices[2].params.u.scn19.u.on_demand.tau             = 50;
+  TESTASSERT(sched_slice_nvs::validate(table->slices));
+
+  // Fixed slices are confined to their RBG window
+  TESTASSERT(table->set_cells({100}));
+  TESTASSERT(table->slices[0].get_cc(0) == nullptr);
+  TESTASSERT(table->slices[1].get_cc(0) != nullptr);
+  TESTASSERT(table->slices[1].get_cc(0)->dl_mask.count() == 20);
+  TESTASSERT(not table->slices[1].get_cc(0)->dl_mask.test(20));
+
+  // ... and served first
+  sched_slice_nvs nvs{nof_rbgs};
+  nvs.set_slices(table->slices);
+  for (uint32_t tti = 0; tti < 100; ++tti) {
+    TESTASSERT(nvs.get_order()[0] == 1);
+    nvs.save_alloc(0, 100, 5);
+    nvs.save_alloc(1, 1000, 5);
+    nvs.save_alloc(2, 100, 5);
+  }
+
+  // On-demand share above the carrier
+  table->slices[2].params.u.scn19.u.on_demand.pct_reserved = 0.8;
+  TESTASSERT(not sched_slice_nvs::validate(table->slices));
+  return SRSRAN_SUCCESS;
+}
+
+void set_edf_slice(sched_slice_t& slice, uint32_t deadline, uint32_t guaranteed_prbs, uint32_t max_replenish)
+{
+  slice.params.type                  = SLICE_ALG_SM_V0_EDF;
+  slice.params.u.edf.deadline        = deadline;
+  slice.params.u.edf.guaranteed_prbs = guaranteed_prbs;
+  slice.params.u.edf.max_replenish   = max_replenish;
+}
+
+int test_edf_validate()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1});
+  set_edf_slice(table->slices[0], 2, 50, 0);
+  set_edf_slice(table->slices[1], 10, 250, 0);
+  TESTASSERT(sched_slice_edf::validate(table->slices, {50, 100}));
+
+  // 25 + 25 PRBs per TTI do not fit in a 25 PRB carrier
+  TESTASSERT(not sched_slice_edf::validate(table->slices, {25, 100}));
+
+  // Invalid parameters
+  set_edf_slice(table->slices[1], 0, 250, 0);
+  TESTASSERT(not sched_slice_edf::validate(table->slices, {100}));
+  set_edf_slice(table->slices[1], 10, 0, 0);
+  TESTASSERT(not sched_slice_edf::validate(table->slices, {100}));
+
+  // All slices must be EDF
+  set_static_slice(table->slices[1], 0, 5);
+  TESTASSERT(not sched_slice_edf::validate(table->slices, {100}));
+  return SRSRAN_SUCCESS;
+}
+
+int test_edf_deadlines()
+{
+  std::unique_ptr<sched_slice_table> table = make_table({0, 1});
+  set_edf_slice(table->slices[0], 5, 10, 0);
+  set_edf_slice(table->slices[1], 2, 4, 8);
+  table->set_stats(sched_slice_table{});
+
+  sched_slice_edf edf;
+  edf.set_slices(table->slices);
+
+  // Earliest deadline first
+  edf.new_tti();
+  TESTASSERT(edf.get_order() == std::vector<uint32_t>({1, 0}));
+
+  // Slices that used their guaranteed PRBs go last
+  edf.save_alloc(1, 6);
+  TESTASSERT(edf.get_budget(1) == 0);
+  TESTASSERT(edf.get_order() == std::vector<uint32_t>({0, 1}));
+  edf.save_backlog(1, true);
+  edf.save_alloc(0, 0);
+  edf.save_backlog(0, false);
+
+  // Slice 1 window ends without misses. Slice 0 is left with data and budget for the rest of its window
+  edf.new_tti();
+  edf.save_alloc(0, 2);
+  edf.save_backlog(0, true);
+  for (uint32_t tti = 2; tti < 5; ++tti) {
+    edf.new_tti();
+  }
+  TESTASSERT(table->slices[0].stats->dl_deadline_miss == 0);
+  TESTASSERT(edf.get_budget(1) == 8);
+  edf.new_tti();
+  TESTASSERT(table->slices[0].stats->dl_deadline_miss == 1);
+  TESTASSERT(table->slices[1].stats->dl_deadline_miss == 0);
+
+  // Without replenishment, unused budget is lost. Slice 1 accumulates up to max_replenish PRBs
+  TESTASSERT(edf.get_budget(0) == 10);
+  for (uint32_t tti = 0; tti < 10; ++tti) {
+    edf.new_tti();
+  }
+  TESTASSERT(edf.get_budget(0) == 10);
+  TESTASSERT(edf.get_budget(1) == 8);
+
+  // UL instances count their misses apart
+  sched_slice_edf ul_edf{true};
+  ul_edf.set_slices(table->slices);
+  ul_edf.new_tti();
+  ul_edf.save_backlog(0, true);
+  for (uint32_t tti = 1; tti <= 5; ++tti) {
+    ul_edf.new_tti();
+  }
+  TESTASSERT(table->slices[0].stats->ul_deadline_miss == 1);
+  TESTASSERT(table->slices[0].stats->dl_deadline_miss == 1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_slice_stats()
+{
+  std::unique_ptr<sched_slice_table> prev = make_table({0, 1});
+  prev->set_stats(sched_slice_table{});
+  TESTASSERT(prev->slices[0].stats != nullptr and prev->slices[1].stats != nullptr);
+  prev->slices[1].stats->dl_deadline_miss = 3;
+
+  // Counters are kept for the slices that remain across reconfigurations
+  std::unique_ptr<sched_slice_table> next = make_table({1, 2});
+  next->set_stats(*prev);
+  TESTASSERT(next->slices[0].stats == prev->slices[1].stats);
+  TESTASSERT(next->slices[0].stats->dl_deadline_miss == 3);
+  TESTASSERT(next->slices[1].stats != nullptr and next->slices[1].stats->dl_deadline_miss == 0);
+
+  // DL and UL slices with the same id share their counters, also with slices that only existed in the other direction
+  std::unique_ptr<sched_slice_table> ul = make_table({1});
+  ul->ul_slices.resize(2);
+  ul->ul_slices[0].id = 1;
+  ul->ul_slices[1].id = 2;
+  ul->set_stats(*next);
+  TESTASSERT(ul->slices[0].stats == prev->slices[1].stats);
+  TESTASSERT(ul->ul_slices[0].stats == ul->slices[0].stats);
+  TESTASSERT(ul->ul_slices[1].stats == next->slices[1].stats);
+  return SRSRAN_SUCCESS;
+}
+
+int test_ue_slice_association()
+{
+  slicer_interface& slicer = slicer_interface::getInstance();
+  uint64_t          imsi   = 901700000000001;
+  uint16_t          rnti = 0x46, new_rnti = 0x47;
+
+  TESTASSERT(slicer.find_slice(rnti) == slicer_interface::no_slice);
+
+  // A RNTI associated before its IMSI is known keeps its slice once the IMSI is captured
+  uint32_t epoch = slicer.epoch();
+  slicer.set_rnti_slice(rnti, 2);
+  TESTASSERT(slicer.epoch() != epoch);
+  TESTASSERT(slicer.find_slice(rnti) == 2);
+  slicer.upd_member_crnti(imsi, rnti);
+  TESTASSERT(slicer.find_slice(rnti) == 2);
+  TESTASSERT(slicer.find_imsi_slice(imsi) == 2);
+
+  // The slice follows the UE when its RNTI changes
+  slicer.upd_member_crnti(rnti, new_rnti);
+  TESTASSERT(slicer.find_slice(new_rnti) == 2);
+  TESTASSERT(slicer.find_slice(rnti) == slicer_interface::no_slice);
+
+  // IMSI associations are applied to the current RNTI of the IMSI
+  slicer.set_imsi_slice(imsi, 5);
+  TESTASSERT(slicer.find_slice(new_rnti) == 5);
+
+  // A re-attach with a new RNTI recovers the IMSI slice
+  slicer.rem_crnti(new_rnti);
+  TESTASSERT(slicer.find_slice(new_rnti) == slicer_interface::no_slice);
+  TESTASSERT(slicer.find_imsi_slice(imsi) == 5);
+  slicer.upd_member_crnti(imsi, rnti);
+  TESTASSERT(slicer.find_slice(rnti) == 5);
+
+  // UL associations are kept apart from the DL ones, and follow the UE in the same way
+  slicer.set_rnti_ul_slice(rnti, 1);
+  TESTASSERT(slicer.find_ul_slice(rnti) == 1 and slicer.find_slice(rnti) == 5);
+  slicer.upd_member_crnti(rnti, new_rnti);
+  TESTASSERT(slicer.find_ul_slice(new_rnti) == 1 and slicer.find_ul_slice(rnti) == slicer_interface::no_slice);
+  slicer.rem_crnti(new_rnti);
+  slicer.upd_member_crnti(imsi, rnti);
+  TESTASSERT(slicer.find_ul_slice(rnti) == 1);
+  slicer.set_imsi_ul_slice(imsi, slicer_interface::no_slice);
+  TESTASSERT(slicer.find_ul_slice(rnti) == slicer_interface::no_slice and slicer.find_slice(rnti) == 5);
+
+  slicer.set_imsi_slice(imsi, slicer_interface::no_slice);
+  TESTASSERT(slicer.find_slice(rnti) == slicer_interface::no_slice);
+  TESTASSERT(slicer.find_imsi_slice(imsi) == slicer_interface::no_slice);
+  TESTASSERT(slicer.find_imsi_ul_slice(imsi) == slicer_interface::no_slice);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_find_slice() == SRSRAN_SUCCESS);
+  TESTASSERT(test_static_slice_resources() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ul_slice_resources() == SRSRAN_SUCCESS);
+  TESTASSERT(test_nvs_validate() == SRSRAN_SUCCESS);
+  TESTASSERT(test_nvs_slice_order() == SRSRAN_SUCCESS);
+  TESTASSERT(test_scn19_slices() == SRSRAN_SUCCESS);
+  TESTASSERT(test_edf_validate() == SRSRAN_SUCCESS);
+  TESTASSERT(test_edf_deadlines() == SRSRAN_SUCCESS);
+  TESTASSERT(test_slice_stats() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ue_slice_association() == SRSRAN_SUCCESS);
+  TESTASSERT(test_slice_db_publish() == SRSRAN_SUCCESS);
+
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -150,7 +150,11 @@ int common_sched_tester::add_user(uint16_t rnti, const ue_ctxt_test_cfg& ue_cfg_
 {
   logger.info("Adding user rnti=0x%x", rnti);
   sched_sim->ue_sim_cfg_map[rnti] = ue_cfg_;
-  return sched_sim->add_user(rnti, ue_cfg_.ue_cfg, tti_info.nof_prachs++);
+  TESTASSERT(sched_sim->add_user(rnti, ue_cfg_.ue_cfg, tti_info.nof_prachs++) == SRSRAN_SUCCESS);
+  // The UE table read lock-free by the metrics follows the scheduler UEs
+  mac_ue_metrics_t metrics = {};
+  TESTASSERT(ue_exists(rnti) and metrics_read(rnti, metrics) == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
 }
 
 int common_sched_tester::reconf_user(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg_)
@@ -162,7 +166,9 @@ int common_sched_tester::rem_user(uint16_t rnti)
 {
   logger.info("Removing user rnti=0x%x", rnti);
   sched_sim->ue_sim_cfg_map.erase(rnti);
-  return sched_sim->rem_user(rnti);
+  TESTASSERT(sched_sim->rem_user(rnti) == SRSRAN_SUCCESS);
+  TESTASSERT(not ue_exists(rnti));
+  return SRSRAN_SUCCESS;
 }
 
 void common_sched_tester::new_test_tti()
@@ -0,0 +1,316 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/upper/tc.h"
+#include "srsran/common/test_common.h"
+#include <arpa/inet.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+
+namespace srsenb {
+
+class pdcp_tester : public pdcp_interface_gtpu
+{
+public:
+  void write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu, int pdcp_sn) override
+  {
+    nof_sdus++;
+    last_sdu = std::move(sdu);
+  }
+  std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) override
+  {
+    return {};
+  }
+
+  uint32_t                     nof_sdus = 0;
+  srsran::unique_byte_buffer_t last_sdu;
+};
+
+class rlc_tester : public rlc_interface_tc
+{
+public:
+  uint32_t get_buffer_state(uint16_t rnti, uint32_t lcid) override { return buffer_state; }
+
+  uint32_t buffer_state = 0;
+};
+
+static srsran::unique_byte_buffer_t make_udp_packet(uint16_t dst_port, uint8_t tos, uint32_t payload_len = 1000)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  struct iphdr                 ip  = {};
+  ip.version                       = 4;
+  ip.ihl                           = 5;
+  ip.tos                           = tos;
+  ip.tot_len                       = htons(sizeof(struct iphdr) + sizeof(struct udphdr) + payload_len);
+  ip.ttl                           = 64;
+  ip.protocol                      = IPPROTO_UDP;
+  ip.saddr                         = inet_addr("10.0.0.1");
+  ip.daddr                         = inet_addr("172.16.0.2");
+  struct udphdr udp                = {};
+  udp.source                       = htons(4000);
+  udp.dest                         = htons(dst_port);
+  udp.len                          = htons(sizeof(struct udphdr) + payload_len);
+  pdu->append_bytes((uint8_t*)&ip, sizeof(ip));
+  pdu->append_bytes((uint8_t*)&udp, sizeof(udp));
+  pdu->N_bytes += payload_len;
+  return pdu;
+}
+
+static uint16_t ipv4_checksum(const uint8_t* hdr)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < 20; i += 2) {
+    sum += (hdr[i] << 8) | hdr[i + 1];
+  }
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return ~sum & 0xffff;
+}
+
+int test_codel_drop()
+{
+  const int64_t ms = 1000;
+  tc_queue      q(0, TC_QUEUE_CODEL, 5, 100);
+  for (uint32_t i = 0; i < 100; ++i) {
+    TESTASSERT(q.push(make_udp_packet(5000, 0), 0));
+  }
+
+  // Above target for less than an interval, nothing is dropped
+  TESTASSERT(q.pop(10 * ms) != nullptr);
+  TESTASSERT(q.pop(50 * ms) != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 0);
+
+  // Above target for a whole interval, enter the dropping state
+  TESTASSERT(q.pop(200 * ms) != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 1);
+  TESTASSERT(q.pop(250 * ms) != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 1);
+
+  // Next drop scheduled one interval later
+  TESTASSERT(q.pop(300 * ms) != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 2);
+  TESTASSERT(q.stats.pkts_fwd == 5);
+  TESTASSERT(q.size_pkts() == 93);
+
+  // The queue drained below target, leave the dropping state
+  q.take_all();
+  TESTASSERT(q.push(make_udp_packet(5000, 0), 400 * ms));
+  TESTASSERT(q.pop(401 * ms) != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 2);
+  TESTASSERT(q.stats.last_sojourn_us == 1 * ms);
+  return SRSRAN_SUCCESS;
+}
+
+int test_ecn_codel_mark()
+{
+  const int64_t ms = 1000;
+  tc_queue      q(0, TC_QUEUE_ECN_CODEL, 5, 100);
+  for (uint32_t i = 0; i < 10; ++i) {
+    // ECT(0)
+    TESTASSERT(q.push(make_udp_packet(5000, 0x02), 0));
+  }
+  TESTASSERT(q.pop(10 * ms) != nullptr);
+
+  // ECN capable packets are marked instead of dropped
+  srsran::unique_byte_buffer_t sdu = q.pop(200 * ms);
+  TESTASSERT(sdu != nullptr);
+  TESTASSERT(q.stats.dropped_pkts == 0);
+  TESTASSERT(q.stats.marked_pkts == 1);
+  TESTASSERT((sdu->msg[1] & 0x03) == 0x03);
+  TESTASSERT(ipv4_checksum(sdu->msg) == 0);
+
+  // Not-ECT packets are still dropped
+  q.take_all();
+  q.configure(TC_QUEUE_ECN_CODEL, 5, 100);
+  for (uint32_t i = 0; i < 10; ++i) {
+    TESTASSERT(q.push(make_udp_packet(5000, 0), 0));
+  }
+  TESTASSERT(q.pop(10 * ms) != nullptr);
+  sdu = q.pop(200 * ms);
+  TESTASSERT(sdu != nullptr);
+  TESTASSERT((sdu->msg[1] & 0x03) == 0);
+  TESTASSERT(q.stats.dropped_pkts == 1);
+  return SRSRAN_SUCCESS;
+}
+
+int test_osi_classifier()
+{
+  tc_conf_t              conf;
+  tc_conf_t::queue_cfg_t qc = {};
+  qc.id                     = conf.next_queue_id++;
+  qc.type                   = TC_QUEUE_FIFO;
+  conf.queues.push_back(qc);
+
+  tc_osi_filter_t flt = {};
+  flt.id              = conf.next_filter_id++;
+  flt.src_addr        = -1;
+  flt.dst_addr        = inet_addr("172.16.0.2");
+  flt.src_port        = -1;
+  flt.dst_port        = 5001;
+  flt.protocol        = IPPROTO_UDP;
+  flt.dst_queue       = qc.id;
+  conf.filters.push_back(flt);
+  conf.cls_type = TC_CLS_OSI;
+
+  tc_pipeline p(conf);
+  p.enqueue(make_udp_packet(5000, 0), 0);
+  p.enqueue(make_udp_packet(5001, 0), 0);
+  p.enqueue(make_udp_packet(5001, 0), 0);
+  TESTASSERT(p.get_queues().size() == 2);
+  TESTASSERT(p.get_queues()[0]->size_pkts() == 1);
+  TESTASSERT(p.get_queues()[1]->size_pkts() == 2);
+
+  // Deleting the queue moves its packets to the default queue
+  conf.queues.pop_back();
+  p.apply(conf);
+  TESTASSERT(p.get_queues().size() == 1);
+  TESTASSERT(p.get_queues()[0]->size_pkts() == 3);
+  return SRSRAN_SUCCESS;
+}
+
+int test_prio_scheduler()
+{
+  tc_conf_t              conf;
+  tc_conf_t::queue_cfg_t qc = {};
+  qc.id                     = conf.next_queue_id++;
+  qc.type                   = TC_QUEUE_FIFO;
+  conf.queues.push_back(qc);
+
+  tc_osi_filter_t flt = {};
+  flt.src_addr        = -1;
+  flt.dst_addr        = -1;
+  flt.src_port        = -1;
+  flt.dst_port        = 5001;
+  flt.protocol        = -1;
+  flt.dst_queue       = qc.id;
+  conf.filters.push_back(flt);
+  conf.cls_type = TC_CLS_OSI;
+  conf.sch_type = TC_SCHED_PRIO;
+  conf.prio     = {qc.id};
+
+  tc_pipeline p(conf);
+  p.enqueue(make_udp_packet(5000, 0), 0);
+  p.enqueue(make_udp_packet(5000, 0), 0);
+  p.enqueue(make_udp_packet(5001, 0), 0);
+
+  // The prioritized queue is served first, although its packet arrived last
+  srsran::unique_byte_buffer_t sdu = p.dequeue(0);
+  TESTASSERT(sdu != nullptr);
+  TESTASSERT(sdu->msg[22] == (5001 >> 8) and sdu->msg[23] == (5001 & 0xff));
+  TESTASSERT(p.dequeue(0) != nullptr);
+  TESTASSERT(p.dequeue(0) != nullptr);
+  TESTASSERT(p.dequeue(0) == nullptr);
+  TESTASSERT(p.empty());
+
+  // The shaper holds back a queue above its rate
+  conf.queues[0].shp_active        = true;
+  conf.queues[0].shp_max_rate_kbps = 1;
+  conf.prio.clear();
+  p.apply(conf);
+  p.enqueue(make_udp_packet(5000, 0), 1000);
+  p.enqueue(make_udp_packet(5000, 0), 1000);
+  TESTASSERT(p.dequeue(1000) != nullptr);
+  TESTASSERT(p.dequeue(1000) == nullptr);
+  TESTASSERT(not p.empty());
+  return SRSRAN_SUCCESS;
+}
+
+int test_tc_control()
+{
+  auto&       logger = srslog::fetch_basic_logger("PDCP", false);
+  pdcp_tester pdcp;
+  rlc_tester  rlc;
+  tc          tc_stage(logger);
+  tc_stage.init(&pdcp, &rlc, nullptr);
+
+  // Pass-through until the first control message
+  tc_stage.write_sdu(0x46, 3, make_udp_packet(5000, 0));
+  TESTASSERT(pdcp.nof_sdus == 1);
+
+  tc_ctrl_msg_t ctrl         = {};
+  ctrl.type                  = TC_CTRL_SM_V0_QUEUE;
+  ctrl.q.act                 = TC_CTRL_ACTION_SM_V0_ADD;
+  ctrl.q.add.type            = TC_QUEUE_CODEL;
+  ctrl.q.add.codel.target_ms = 5;
+  ctrl.q.add.codel.interval_ms = 100;
+  TESTASSERT(tc_stage.control(ctrl) == TC_CTRL_OUT_OK);
+
+  // The default queue can not be deleted
+  ctrl.q.act    = TC_CTRL_ACTION_SM_V0_DEL;
+  ctrl.q.del.id = 0;
+  TESTASSERT(tc_stage.control(ctrl) == TC_CTRL_OUT_ERROR);
+
+  // The pacer holds the SDUs while the RLC buffer is above the DRB size
+  ctrl                     = {};
+  ctrl.type                = TC_CTRL_SM_V0_PCR;
+  ctrl.pcr.act             = TC_CTRL_ACTION_SM_V0_MOD;
+  ctrl.pcr.mod.type        = TC_PCR_5G_BDP;
+  ctrl.pcr.mod.bdp.drb_sz  = 10000;
+  TESTASSERT(tc_stage.control(ctrl) == TC_CTRL_OUT_OK);
+  rlc.buffer_state = 20000;
+  tc_stage.write_sdu(0x46, 3, make_udp_packet(5000, 0));
+  tc_stage.write_sdu(0x46, 3, make_udp_packet(5000, 0));
+  TESTASSERT(pdcp.nof_sdus == 1);
+  rlc.buffer_state = 0;
+  tc_stage.write_sdu(0x46, 3, make_udp_packet(5000, 0));
+  TESTASSERT(pdcp.nof_sdus == 4);
+
+  // SRBs and forwarded SDUs bypass the queues
+  rlc.buffer_state = 20000;
+  tc_stage.write_sdu(0x46, 1, make_udp_packet(5000, 0));
+  tc_stage.write_sdu(0x46, 3, make_udp_packet(5000, 0), 10);
+  TESTASSERT(pdcp.nof_sdus == 6);
+
+  tc_ind_msg_t ind = {};
+  tc_stage.get_stats(&ind);
+  TESTASSERT(ind.len_q == 2);
+  TESTASSERT(ind.q[0].id == 0 and ind.q[0].type == TC_QUEUE_FIFO);
+  TESTASSERT(ind.q[1].id == 1 and ind.q[1].type == TC_QUEUE_CODEL);
+  TESTASSERT(ind.q[0].fifo.pkts_fwd + ind.q[1].codel.pkts_fwd == 3);
+  TESTASSERT(ind.pcr.type == TC_PCR_5G_BDP);
+  free(ind.q);
+  free(ind.shp);
+  free(ind.plc);
+
+  tc_stage.stop();
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char** argv)
+{
+  auto& logger = srslog::fetch_basic_logger("PDCP", false);
+  logger.set_level(srslog::basic_levels::debug);
+
+  srsran::test_init(argc, argv);
+
+  TESTASSERT(srsenb::test_codel_drop() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_ecn_codel_mark() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_osi_classifier() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_prio_scheduler() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_tc_control() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+
+  srsran::console("Success");
+}